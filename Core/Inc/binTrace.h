@@ -0,0 +1,87 @@
+/***************************************************************************************************
+* @file
+* @brief     Deferred binary trace logging.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            BTRACE_Log() takes a printf style format but does not format anything: it records the
+*            address of the format string (its ID, the string itself stays in flash), a timestamp and
+*            the raw argument values in a ring buffer. The ring is drained later, as binary, to an RTT
+*            up buffer or any other output, and the text is rebuilt on the host from the firmware ELF
+*            file by Tools/btrace_decode.py.
+*            Producers are lock-free and may run in interrupts: a record is reserved with an atomic
+*            update of the write index, filled, then published by writing its header word last.
+*            The whole module is compiled out unless BTRACE_EN is defined.
+* @date      10/2026
+**************************************************************************************************/
+#ifndef _BIN_TRACE_H_
+#define _BIN_TRACE_H_
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdint.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+/* Ring buffer size in 32-bit words (power of 2). */
+#ifndef BTRACE_RING_WORDS
+#define BTRACE_RING_WORDS				1024
+#endif
+
+/* Largest record in 32-bit words, header included. Longer argument lists are truncated. */
+#ifndef BTRACE_RECORD_WORDS
+#define BTRACE_RECORD_WORDS				16
+#endif
+
+/* Longest %s argument copied in a record, longer strings are truncated. */
+#ifndef BTRACE_STR_MAX
+#define BTRACE_STR_MAX					24
+#endif
+
+/* RTT up buffer the records are drained to, and its size. */
+#ifndef BTRACE_RTT_BUFFER
+#define BTRACE_RTT_BUFFER				1
+#endif
+#ifndef BTRACE_RTT_SIZE
+#define BTRACE_RTT_SIZE					2048
+#endif
+
+/* Free running timestamp. Default to the DWT cycle counter. */
+#ifndef BTRACE_TIMESTAMP
+#define BTRACE_TIMESTAMP()				(DWT->CYCCNT)
+#endif
+
+/* Record header word: marker, record size and flags. The header of a free slot is 0. */
+#define BTRACE_MARKER					0xB7u
+#define BTRACE_HDR(WORDS, FLAGS)		((BTRACE_MARKER << 24) | ((uint32_t)(WORDS) << 16) | (uint32_t)(FLAGS))
+#define BTRACE_HDR_WORDS(HDR)			(((HDR) >> 16) & 0xFFu)
+#define BTRACE_HDR_FLAGS(HDR)			((HDR) & 0xFFFFu)
+
+/* Record flags. */
+#define BTRACE_FLAG_TRUNCATED			0x0001u	/* Some arguments did not fit in the record */
+
+/* Format ID of the record inserted by the drain when records were dropped (one argument: count). */
+#define BTRACE_ID_LOST					0u
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+/* Output function used by BTRACE_Drain(). Returns the number of octets accepted (0 to size). */
+typedef uint32_t (*BTRACE_WRITER)(const void *data, uint32_t size, void *arg);
+
+/***************************************************************************************************
+* Prototypes
+***************************************************************************************************/
+#ifdef BTRACE_EN
+void BTRACE_Init(void);
+void BTRACE_Enable(void);
+void BTRACE_Disable(void);
+
+void BTRACE_Log(const char *fmt, ...);
+
+uint32_t BTRACE_Drain(BTRACE_WRITER writer, void *arg);
+uint32_t BTRACE_DrainRTT(void);
+uint32_t BTRACE_Lost(void);
+#endif
+
+#endif
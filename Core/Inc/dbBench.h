@@ -0,0 +1,74 @@
+/***************************************************************************************************
+* @file
+* @brief     Storage stack benchmark (UnQLite -> VFS -> uC/FS -> NOR).
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            Runs standard workloads against a database and reports, for each of them, the
+*            throughput and the flash cost (simulated flash time, octets programmed, erases).
+*            On target the flash cost comes from the NOR driver statistic counters; in a host build
+*            linked with the W25Q simulator (FS_DEV_NOR_BSP_SIM_EN, see bsp_fs_dev_nor_sim.h) it comes
+*            from the simulator, which also models the program and erase timings.
+* @date      10/2026
+**************************************************************************************************/
+#ifndef _DB_BENCH_H_
+#define _DB_BENCH_H_
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdint.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+/* Size of the values stored by the KV workloads. */
+#ifndef DBBENCH_VALUE_SIZE
+#define DBBENCH_VALUE_SIZE				64
+#endif
+
+/* Number of write operations per transaction. */
+#ifndef DBBENCH_BATCH
+#define DBBENCH_BATCH					32
+#endif
+
+/* Number of single-record transactions of the commit workloads. */
+#ifndef DBBENCH_COMMITS
+#define DBBENCH_COMMITS					256
+#endif
+
+/* Largest group of the group_commit workloads (see UNQLITE_CONFIG_GROUP_COMMIT), which run with
+ * 1, 2, 4... up to this number of commits flushed together. */
+#ifndef DBBENCH_GROUP_COMMIT
+#define DBBENCH_GROUP_COMMIT			16
+#endif
+
+/* Read-ahead window of the second scan workload (see UNQLITE_CONFIG_READ_AHEAD), the first one
+ * runs without read-ahead. */
+#ifndef DBBENCH_READ_AHEAD
+#define DBBENCH_READ_AHEAD				8
+#endif
+
+/* Size and maximum number of the records of the zip workloads, stored on overflow pages. */
+#ifndef DBBENCH_ZIP_VALUE_SIZE
+#define DBBENCH_ZIP_VALUE_SIZE			4096
+#endif
+#ifndef DBBENCH_ZIP_RECORDS
+#define DBBENCH_ZIP_RECORDS				64
+#endif
+
+/* NOR device whose statistic counters are reported on target. */
+#ifndef DBBENCH_NOR_DEV
+#define DBBENCH_NOR_DEV					"nor:0:"
+#endif
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+/* Output function, receives one report line at a time. */
+typedef void (*DBBENCH_WRITER)(const char *str, void *arg);
+
+/***************************************************************************************************
+* Prototypes
+***************************************************************************************************/
+int DBBENCH_Run(const char *dbPath, uint32_t nRecords, DBBENCH_WRITER writer, void *arg);
+
+#endif
@@ -135,7 +135,9 @@
 
 
                                                                 /* Configure file lock support (see Note #6) :          */
+#ifndef  FS_CFG_FILE_LOCK_EN                                    /* Host builds enable it (concurrent rd's).             */
 #define  FS_CFG_FILE_LOCK_EN                     DEF_DISABLED
+#endif
                                                                 /*   DEF_DISABLED   Files only locked during single op. */
                                                                 /*   DEF_ENABLED    A file may be locked across op's.   */
 
@@ -355,6 +357,22 @@
 *               (a) When ENABLED,  volume integrity can     be checked.  If enabled, FS_FAT_CFG_VOL_CHK_MAX_LEVELS
 *                   is the maximum number of directory levels that will be checked.
 *               (b) When DISABLED, volume integrity can NOT be checked.
+*
+*           (7) Configure FS_FAT_CFG_FAT12_MIRROR_EN to enable/disable the RAM mirror of FAT12 tables :
+*               (a) When ENABLED,  the first FAT of each opened FAT12 volume is kept in RAM.  Cluster values
+*                   are read from the mirror & FAT sectors are updated without first being read from the
+*                   device.  FS_FAT_CFG_FAT12_MIRROR_SIZE is the size, in octets, of the mirror allocated
+*                   for each volume; volumes whose FAT does not fit are accessed as usual.
+*               (b) When DISABLED, every cluster value is read through the volume buffer.
+*
+*           (8) Configure FS_FAT_CFG_CLUS_BITMAP_EN to enable/disable the free cluster bitmap :
+*               (a) When ENABLED,  a bitmap of the free clusters of each opened volume is built from the FAT
+*                   when the volume is opened.  Free clusters are found from the bitmap & multi-cluster
+*                   allocations are placed in a contiguous run of free clusters whenever one exists.
+*                   FS_FAT_CFG_CLUS_BITMAP_SIZE is the size, in octets, of the bitmap allocated for each
+*                   volume (1 bit per cluster, plus 1 bit per 32 clusters); volumes with more clusters are
+*                   accessed as usual.
+*               (b) When DISABLED, free clusters are found by reading the FAT one entry at a time.
 *********************************************************************************************************
 */
                                                                 /* Configure Long File Name support   (see Note #1) :   */
@@ -396,6 +414,26 @@
                                                                 /* Configure max levels chk'd (see Note #6).            */
 #define  FS_FAT_CFG_VOL_CHK_MAX_LEVELS                    20u
 
+
+                                                                /* Configure FAT12 table mirror (see Note #7) :         */
+#define  FS_FAT_CFG_FAT12_MIRROR_EN              DEF_ENABLED
+                                                                /*   DEF_DISABLED   FAT12 mirror NOT used.              */
+                                                                /*   DEF_ENABLED    FAT12 mirror     used.              */
+
+
+                                                                /* Configure FAT12 mirror size (see Note #7).           */
+#define  FS_FAT_CFG_FAT12_MIRROR_SIZE                   6144u
+
+
+                                                                /* Configure free cluster bitmap (see Note #8) :        */
+#define  FS_FAT_CFG_CLUS_BITMAP_EN               DEF_ENABLED
+                                                                /*   DEF_DISABLED   Cluster bitmap NOT used.            */
+                                                                /*   DEF_ENABLED    Cluster bitmap     used.            */
+
+
+                                                                /* Configure cluster bitmap size (see Note #8).         */
+#define  FS_FAT_CFG_CLUS_BITMAP_SIZE                    1024u
+
 /*
 *********************************************************************************************************
 *                           FILE SYSTEM SD/MMC DEVICE DRIVER CONFIGURATION
@@ -429,6 +467,9 @@
 *           (2) Configure FS_TRACE to the 'printf' style function that will be used to output all the
 *               tracing messages. If FS_TRACE_LEVEL is configured to TRACE_LEVEL_OFF, there is no need
 *               to configure FS_TRACE.
+*
+*           (3) When BTRACE_EN is defined, the messages are recorded unformatted by the deferred binary
+*               trace (see 'binTrace.h') & decoded on the host.
 *********************************************************************************************************
 */
 
@@ -441,7 +482,28 @@
 
 
                                                                 /* Configure file system trace function (see Note #2) : */
+#ifdef   BTRACE_EN                                              /* See Note #3.                                         */
+#include "binTrace.h"
+#define  FS_TRACE                           BTRACE_Log
+#else
 #define  FS_TRACE                           DEBUG_printfNoLF
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        FILE SYSTEM I/O TRACING
+*
+* Note(s) : (1) When IOTRACE_EN is defined, journal, device & NOR I/O operations are timed & recorded by
+*               the I/O trace module (see 'ioTrace.h' & 'fs.h  I/O TRACING').
+*********************************************************************************************************
+*/
+
+#ifdef   IOTRACE_EN
+#include "ioTrace.h"
+#define  FS_TRACE_IO_START()                                IOTRACE_Begin()
+#define  FS_TRACE_IO_END(layer, op, addr, size, start)      IOTRACE_End((layer), (op), (addr), (size), (start))
+#endif
 
 /*
 *********************************************************************************************************
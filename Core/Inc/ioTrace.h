@@ -0,0 +1,122 @@
+/***************************************************************************************************
+* @file
+* @brief     I/O tracing across the storage stack (UnQLite pager, VFS, uC/FS, NOR).
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            Every traced operation is timed with the DWT cycle counter and recorded in a ring
+*            buffer of events and in a log2 latency histogram of its layer. The whole module is
+*            compiled out unless IOTRACE_EN is defined.
+* @date      10/2026
+**************************************************************************************************/
+#ifndef _IO_TRACE_H_
+#define _IO_TRACE_H_
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdint.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+/* Layers, from the top of the stack to the medium.
+ * The uC/FS layers MUST match FS_TRACE_IO_LAYER_xxx in fs.h. */
+#define IOTRACE_LAYER_PAGER				0	/* UnQLite pager (commit, dirty pages write) */
+#define IOTRACE_LAYER_VFS				1	/* UnQLite VFS (rawRead/rawWrite/rawSync) */
+#define IOTRACE_LAYER_FS_JOURNAL		2	/* uC/FS FAT journal */
+#define IOTRACE_LAYER_FS_DEV			3	/* uC/FS device sectors */
+#define IOTRACE_LAYER_NOR				4	/* NOR physical read/program/erase */
+#define IOTRACE_LAYER_CNT				5
+
+/* Operations. MUST match FS_TRACE_IO_OP_xxx in fs.h. */
+#define IOTRACE_OP_RD					0
+#define IOTRACE_OP_WR					1
+#define IOTRACE_OP_SYNC					2
+#define IOTRACE_OP_ERASE				3
+#define IOTRACE_OP_COMMIT				4
+#define IOTRACE_OP_CNT					5
+
+/* Number of events kept in the ring buffer (power of 2). */
+#ifndef IOTRACE_RING_SIZE
+#define IOTRACE_RING_SIZE				256
+#endif
+
+/* Number of log2 histogram buckets: bucket n counts durations in [2^(n-1), 2^n) us. */
+#define IOTRACE_HIST_BUCKETS			24
+
+/* Free running timestamp and its frequency. Default to the DWT cycle counter. */
+#ifndef IOTRACE_TIMESTAMP
+#define IOTRACE_TIMESTAMP()				(DWT->CYCCNT)
+#endif
+#ifndef IOTRACE_TICKS_PER_US
+#define IOTRACE_TICKS_PER_US			(SystemCoreClock / 1000000u)
+#endif
+
+#ifdef IOTRACE_EN
+	#define IOTRACE_START()								IOTRACE_Begin()
+	#define IOTRACE_END(LAYER, OP, ADDR, SIZE, START)	IOTRACE_End((LAYER), (OP), (ADDR), (SIZE), (START))
+#else
+	#define IOTRACE_START()								0u
+	/* Arguments still referenced, so that variables only kept for the trace are not unused */
+	#define IOTRACE_END(LAYER, OP, ADDR, SIZE, START)	((void)(ADDR), (void)(SIZE), (void)(START))
+#endif
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+/* A traced operation. */
+typedef struct
+{
+	uint32_t ts;		/* Start timestamp (IOTRACE_TIMESTAMP() ticks) */
+	uint32_t durUs;		/* Duration in microseconds */
+	uint32_t addr;		/* Page, sector or octet address, depending on the layer */
+	uint32_t size;		/* Octets transferred */
+	uint8_t layer;		/* IOTRACE_LAYER_xxx */
+	uint8_t op;			/* IOTRACE_OP_xxx */
+} IOTRACE_EVENT;
+
+/* Per layer totals and latency histogram. */
+typedef struct
+{
+	uint32_t cnt[IOTRACE_OP_CNT];		/* Number of operations */
+	uint64_t octets[IOTRACE_OP_CNT];	/* Octets transferred */
+	uint64_t totalUs;					/* Time spent in the layer */
+	uint32_t maxUs;						/* Slowest operation */
+	uint32_t hist[IOTRACE_HIST_BUCKETS];
+} IOTRACE_LAYER_STAT;
+
+/* Point in time copy of the trace counters, including the uC/FS statistic counters. */
+typedef struct
+{
+	IOTRACE_LAYER_STAT layer[IOTRACE_LAYER_CNT];
+	uint32_t eventCnt;			/* Events recorded since the last reset */
+	uint32_t eventLost;			/* Events overwritten in the ring buffer */
+	uint8_t norStatValid;		/* The NOR counters below are valid */
+	uint32_t norRdSec;			/* FS_CTR_STAT counters of the NOR device */
+	uint32_t norWrSec;
+	uint32_t norCopySec;
+	uint32_t norReleaseSec;
+	uint32_t norRdOctets;
+	uint32_t norWrOctets;
+	uint32_t norEraseBlk;
+	uint32_t norInvalidBlk;
+} IOTRACE_SNAPSHOT;
+
+/* Output function used by the exporter. */
+typedef void (*IOTRACE_WRITER)(const char *str, void *arg);
+
+/***************************************************************************************************
+* Prototypes
+***************************************************************************************************/
+void IOTRACE_Init(void);
+void IOTRACE_Enable(void);
+void IOTRACE_Disable(void);
+void IOTRACE_Reset(void);
+
+uint32_t IOTRACE_Begin(void);
+void IOTRACE_End(uint8_t layer, uint8_t op, uint32_t addr, uint32_t size, uint32_t start);
+
+void IOTRACE_Snapshot(IOTRACE_SNAPSHOT *snap, char *norDevName);
+void IOTRACE_Export(IOTRACE_WRITER writer, void *arg, char *norDevName);
+void IOTRACE_ExportRTT(unsigned bufferIndex, char *norDevName);
+
+#endif
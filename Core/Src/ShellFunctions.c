@@ -13,6 +13,11 @@
 #include "main.h"
 #include "shell.h"
 #include "cpu.h"
+#include "ioTrace.h"
+#include "binTrace.h"
+#include "dbBench.h"
+#include <string.h>
+#include <stdlib.h>
 /***************************************************************************************************
 * Externs
 ***************************************************************************************************/
@@ -32,10 +37,110 @@ CPU_INT16S force_reflash(CPU_INT16U argc, CPU_CHAR *argv[], SHELL_OUT_FNCT out_f
     return 0;
 }
 
+/***************************************************************************************************
+* @brief     Sends a benchmark report line to the debug output.
+***************************************************************************************************/
+static void dbbench_writer(const char *str, void *arg)
+{
+    DEBUG_printfNoPreNoLF("%s", str);
+}
+
+/***************************************************************************************************
+* @brief     Runs the storage benchmark on "bench.db": shell_dbbench [records] [device]
+* @details   If a device name is given ("nor:1:"), the benchmark runs again on that device without
+*            file system (raw device VFS). The device must not hold a volume.
+***************************************************************************************************/
+CPU_INT16S dbbench(CPU_INT16U argc, CPU_CHAR *argv[], SHELL_OUT_FNCT out_fnct, SHELL_CMD_PARAM *pcmd_param)
+{
+    uint32_t records = (argc < 2) ? 500 : (uint32_t)strtoul(argv[1], 0, 10);
+
+    DEBUG_Log(STD_SEPARATOR);
+    DBBENCH_Run("bench.db", records, dbbench_writer, 0);
+    if (argc > 2)
+    {
+        DEBUG_Log(STD_SEPARATOR);
+        DBBENCH_Run(argv[2], records, dbbench_writer, 0);
+    }
+    DEBUG_Log(STD_SEPARATOR);
+    return 0;
+}
+
+#ifdef IOTRACE_EN
+/***************************************************************************************************
+* @brief     Controls the storage I/O trace: shell_iotrace [on|off|reset|dump]
+* @details   "dump" (default) writes the layer counters, histograms, NOR statistics and the
+*            recorded events to the RTT terminal.
+***************************************************************************************************/
+CPU_INT16S iotrace(CPU_INT16U argc, CPU_CHAR *argv[], SHELL_OUT_FNCT out_fnct, SHELL_CMD_PARAM *pcmd_param)
+{
+    if (argc < 2 || strcmp(argv[1], "dump") == 0)
+    {
+        DEBUG_Log(STD_SEPARATOR);
+        IOTRACE_ExportRTT(0, "nor:0:");
+        DEBUG_Log(STD_SEPARATOR);
+    }
+    else if (strcmp(argv[1], "on") == 0)
+    {
+        IOTRACE_Enable();
+    }
+    else if (strcmp(argv[1], "off") == 0)
+    {
+        IOTRACE_Disable();
+    }
+    else if (strcmp(argv[1], "reset") == 0)
+    {
+        IOTRACE_Reset();
+    }
+    else
+    {
+        DEBUG_Log("usage: shell_iotrace [on|off|reset|dump]");
+    }
+    return 0;
+}
+#endif
+
+#ifdef BTRACE_EN
+/***************************************************************************************************
+* @brief     Controls the deferred binary trace: shell_btrace [on|off|drain]
+* @details   "drain" (default) sends the pending records to the RTT up buffer and reports the number
+*            of dropped records. Shell commands run from the timer interrupt, so the main loop does
+*            not drain while they execute.
+***************************************************************************************************/
+CPU_INT16S btrace(CPU_INT16U argc, CPU_CHAR *argv[], SHELL_OUT_FNCT out_fnct, SHELL_CMD_PARAM *pcmd_param)
+{
+    if (argc < 2 || strcmp(argv[1], "drain") == 0)
+    {
+        uint32_t records = BTRACE_DrainRTT();
+
+        DEBUG_printf("btrace: %lu records drained, %lu lost", (unsigned long)records, (unsigned long)BTRACE_Lost());
+    }
+    else if (strcmp(argv[1], "on") == 0)
+    {
+        BTRACE_Enable();
+    }
+    else if (strcmp(argv[1], "off") == 0)
+    {
+        BTRACE_Disable();
+    }
+    else
+    {
+        DEBUG_Log("usage: shell_btrace [on|off|drain]");
+    }
+    return 0;
+}
+#endif
+
 /***************************************************************************************************
 * @brief     Command table for the Main module.
 ***************************************************************************************************/
 SHELL_CMD MainShellCmdTbl[] =
     {
         {"shell_force_reflash", force_reflash},
+        {"shell_dbbench", dbbench},
+#ifdef IOTRACE_EN
+        {"shell_iotrace", iotrace},
+#endif
+#ifdef BTRACE_EN
+        {"shell_btrace", btrace},
+#endif
         {0, 0}};
@@ -0,0 +1,381 @@
+/***************************************************************************************************
+* @file
+* @brief     Deferred binary trace logging.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            Record layout, in 32-bit little endian words:
+*              0    header: BTRACE_MARKER, number of words of the record and BTRACE_FLAG_xxx
+*              1    format string address (BTRACE_ID_LOST for the lost records notification)
+*              2    timestamp (BTRACE_TIMESTAMP())
+*              3..  arguments, packed in the order of the format conversions and padded to a word:
+*                   %c %d %i %u %x %X %o %p and '*' widths/precisions take 4 octets ('l' and 'z'
+*                   included), %lld/%llu/%llx and 'j' take 8 octets, floating point conversions take
+*                   the 8 octets of the double and %s takes a length octet followed by the characters
+*                   (at most BTRACE_STR_MAX, no terminator). %% and %n take nothing.
+*            Tools/btrace_decode.py applies the same rules to rebuild the text.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "binTrace.h"
+#include "stdarg.h"	// variadic arguments
+#include "stddef.h"	// size_t, ptrdiff_t
+#include "string.h"	// memset, memcpy
+#include "main.h"
+#include "SEGGER_RTT.h"
+
+#ifdef BTRACE_EN
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define BTRACE_MASK						(BTRACE_RING_WORDS - 1u)
+#define BTRACE_HDR_SIZE					3u	/* Header, format ID and timestamp words */
+#define BTRACE_ARGS_SIZE				((BTRACE_RECORD_WORDS - BTRACE_HDR_SIZE) * 4u)
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static volatile uint8_t enabled = 0;
+static volatile uint32_t ring[BTRACE_RING_WORDS];	/* Free words are 0 */
+static volatile uint32_t ringHead;	/* Words reserved by the producers */
+static volatile uint32_t ringTail;	/* Words released by the drain */
+static volatile uint32_t lost;		/* Records dropped because the ring was full */
+static uint32_t lostReported;		/* Value of 'lost' last sent by the drain */
+static volatile uint8_t draining;
+static uint8_t rttBuffer[BTRACE_RTT_SIZE];
+
+/***************************************************************************************************
+* @brief Start the cycle counter, clear the ring and set up the RTT up buffer.
+***************************************************************************************************/
+void BTRACE_Init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	memset((void *)ring, 0, sizeof(ring));
+	ringHead = 0;
+	ringTail = 0;
+	lost = 0;
+	lostReported = 0;
+	SEGGER_RTT_ConfigUpBuffer(BTRACE_RTT_BUFFER, "BTrace", rttBuffer, sizeof(rttBuffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	enabled = 1;
+}
+/***************************************************************************************************
+* @brief Resume recording.
+***************************************************************************************************/
+void BTRACE_Enable(void)
+{
+	enabled = 1;
+}
+/***************************************************************************************************
+* @brief Pause recording, the records not yet drained are kept.
+***************************************************************************************************/
+void BTRACE_Disable(void)
+{
+	enabled = 0;
+}
+/***************************************************************************************************
+* @brief Return the number of records dropped because the ring was full.
+***************************************************************************************************/
+uint32_t BTRACE_Lost(void)
+{
+	return lost;
+}
+/***************************************************************************************************
+* @brief Append 'size' octets to the arguments of a record.
+* @return 0 if they do not fit.
+***************************************************************************************************/
+static int BTRACE_Put(uint8_t *args, uint32_t *pos, const void *data, uint32_t size)
+{
+	if (*pos + size > BTRACE_ARGS_SIZE)
+		return 0;
+	memcpy(&args[*pos], data, size);
+	*pos += size;
+	return 1;
+}
+/***************************************************************************************************
+* @brief Reserve 'words' words in the ring.
+* @return Index of the first word, or -1 if the ring is full.
+* @note  Lock-free: the write index is updated with LDREX/STREX, an interrupted reservation is
+*        simply retried.
+***************************************************************************************************/
+static int32_t BTRACE_Reserve(uint32_t words)
+{
+	uint32_t head;
+
+	do
+	{
+		head = __LDREXW((volatile uint32_t *)&ringHead);
+		if (head - ringTail + words > BTRACE_RING_WORDS)
+		{
+			__CLREX();
+			return -1;
+		}
+	} while (__STREXW(head + words, (volatile uint32_t *)&ringHead) != 0);
+	return (int32_t)(head & BTRACE_MASK);
+}
+/***************************************************************************************************
+* @brief Count a dropped record.
+***************************************************************************************************/
+static void BTRACE_CountLost(void)
+{
+	uint32_t n;
+
+	do
+	{
+		n = __LDREXW((volatile uint32_t *)&lost);
+	} while (__STREXW(n + 1, (volatile uint32_t *)&lost) != 0);
+}
+/***************************************************************************************************
+* @brief Record a trace message: the format ID, a timestamp and the raw arguments.
+* @details Nothing is formatted, the format is only scanned to know the type of the arguments
+*          (see the record layout at the top of this file). Safe to call from interrupts.
+***************************************************************************************************/
+void BTRACE_Log(const char *fmt, ...)
+{
+	uint32_t rec[BTRACE_RECORD_WORDS];
+	uint8_t *args = (uint8_t *)&rec[BTRACE_HDR_SIZE];
+	const char *p;
+	uint32_t flags = 0;
+	uint32_t pos = 0;
+	uint32_t words;
+	uint32_t i;
+	int32_t start;
+	va_list ap;
+
+	if (!enabled)
+		return;
+
+	rec[1] = (uint32_t)(uintptr_t)fmt;
+	rec[2] = BTRACE_TIMESTAMP();
+
+	va_start(ap, fmt);
+	for (p = fmt; *p && !(flags & BTRACE_FLAG_TRUNCATED); p++)
+	{
+		uint32_t v32;
+		uint64_t v64;
+		int wide = 0;	/* ll or j: 8 octets */
+		int isLong = 0;	/* l: long, z/t: size_t/ptrdiff_t, stored on 4 octets */
+
+		if (*p != '%')
+			continue;
+		p++;
+		if (*p == '%')
+			continue;
+		while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+			p++;
+		if (*p == '*')
+		{
+			v32 = (uint32_t)va_arg(ap, int);
+			if (!BTRACE_Put(args, &pos, &v32, 4))
+				flags |= BTRACE_FLAG_TRUNCATED;
+			p++;
+		}
+		while (*p >= '0' && *p <= '9')
+			p++;
+		if (*p == '.')
+		{
+			p++;
+			if (*p == '*')
+			{
+				v32 = (uint32_t)va_arg(ap, int);
+				if (!BTRACE_Put(args, &pos, &v32, 4))
+					flags |= BTRACE_FLAG_TRUNCATED;
+				p++;
+			}
+			while (*p >= '0' && *p <= '9')
+				p++;
+		}
+		switch (*p)
+		{
+		case 'h':
+			p++;
+			if (*p == 'h')
+				p++;
+			break;
+		case 'l':
+			p++;
+			if (*p == 'l')
+			{
+				wide = 1;
+				p++;
+			}
+			else
+				isLong = 1;
+			break;
+		case 'j':
+			wide = 1;
+			p++;
+			break;
+		case 'z':
+		case 't':
+			isLong = 2;
+			p++;
+			break;
+		case 'L':
+			p++;
+			break;
+		}
+
+		switch (*p)
+		{
+		case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+			if (wide)
+			{
+				v64 = (uint64_t)va_arg(ap, long long);
+				if (!BTRACE_Put(args, &pos, &v64, 8))
+					flags |= BTRACE_FLAG_TRUNCATED;
+				break;
+			}
+			if (isLong == 1)
+				v32 = (uint32_t)va_arg(ap, long);
+			else if (isLong == 2)
+				v32 = (uint32_t)va_arg(ap, size_t);
+			else
+				v32 = (uint32_t)va_arg(ap, int);
+			if (!BTRACE_Put(args, &pos, &v32, 4))
+				flags |= BTRACE_FLAG_TRUNCATED;
+			break;
+		case 'p':
+			v32 = (uint32_t)(uintptr_t)va_arg(ap, void *);
+			if (!BTRACE_Put(args, &pos, &v32, 4))
+				flags |= BTRACE_FLAG_TRUNCATED;
+			break;
+		case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+		{
+			double d = va_arg(ap, double);
+
+			if (!BTRACE_Put(args, &pos, &d, 8))
+				flags |= BTRACE_FLAG_TRUNCATED;
+			break;
+		}
+		case 's':
+		{
+			const char *s = va_arg(ap, const char *);
+			uint8_t len = 0;
+
+			if (s == 0)
+				s = "(null)";
+			while (len < BTRACE_STR_MAX && s[len])
+				len++;
+			if (!BTRACE_Put(args, &pos, &len, 1) || !BTRACE_Put(args, &pos, s, len))
+				flags |= BTRACE_FLAG_TRUNCATED;
+			break;
+		}
+		case 'n':
+			(void)va_arg(ap, void *);
+			break;
+		case 0:
+			p--;	/* Dangling '%' at the end of the format */
+			break;
+		}
+	}
+	va_end(ap);
+
+	/* Pad the arguments to a word */
+	while (pos & 3u)
+		args[pos++] = 0;
+	words = BTRACE_HDR_SIZE + pos / 4u;
+
+	start = BTRACE_Reserve(words);
+	if (start < 0)
+	{
+		BTRACE_CountLost();
+		return;
+	}
+	for (i = 1; i < words; i++)
+		ring[((uint32_t)start + i) & BTRACE_MASK] = rec[i];
+	/* Publish: the drain stops at the first header still 0 */
+	__DMB();
+	ring[start] = BTRACE_HDR(words, flags);
+}
+/***************************************************************************************************
+* @brief Send the published records, oldest first, to 'writer'.
+* @details The writer must take a record as a whole or not at all (return 0); the drain stops at the
+*          first record it does not take and resumes from there on the next call. When records
+*          were dropped, a BTRACE_ID_LOST record carrying the count is sent first.
+*          Only one drain runs at a time: a call made while another one is in progress (e.g. from an
+*          interrupt) returns 0 immediately.
+* @return Number of records sent.
+***************************************************************************************************/
+uint32_t BTRACE_Drain(BTRACE_WRITER writer, void *arg)
+{
+	uint32_t rec[BTRACE_RECORD_WORDS];
+	uint32_t primask;
+	uint32_t count = 0;
+	uint32_t tail;
+	uint32_t hdr;
+	uint32_t words;
+	uint32_t i;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if (draining)
+	{
+		__set_PRIMASK(primask);
+		return 0;
+	}
+	draining = 1;
+	__set_PRIMASK(primask);
+
+	if (lost != lostReported)
+	{
+		uint32_t nLost = lost;
+
+		rec[0] = BTRACE_HDR(BTRACE_HDR_SIZE + 1, 0);
+		rec[1] = BTRACE_ID_LOST;
+		rec[2] = BTRACE_TIMESTAMP();
+		rec[3] = nLost - lostReported;
+		if (writer(rec, (BTRACE_HDR_SIZE + 1) * 4u, arg) == (BTRACE_HDR_SIZE + 1) * 4u)
+			lostReported = nLost;
+	}
+
+	tail = ringTail;
+	while (tail != ringHead)
+	{
+		hdr = ring[tail & BTRACE_MASK];
+		if (hdr == 0)
+			break;	/* Reserved but not yet published */
+		__DMB();
+		words = BTRACE_HDR_WORDS(hdr);
+		if (words < BTRACE_HDR_SIZE || words > BTRACE_RECORD_WORDS)
+			break;	/* Can't happen */
+		for (i = 0; i < words; i++)
+			rec[i] = ring[(tail + i) & BTRACE_MASK];
+		if (writer(rec, words * 4u, arg) != words * 4u)
+			break;
+		/* Release the words, free words must read 0 */
+		for (i = 0; i < words; i++)
+			ring[(tail + i) & BTRACE_MASK] = 0;
+		__DMB();
+		tail += words;
+		ringTail = tail;
+		count++;
+	}
+
+	draining = 0;
+	return count;
+}
+/***************************************************************************************************
+* @brief Writer sending the records to the BTRACE_RTT_BUFFER up buffer, if there is room for them.
+***************************************************************************************************/
+static uint32_t BTRACE_RTTWriter(const void *data, uint32_t size, void *arg)
+{
+	(void)arg;
+	if (SEGGER_RTT_GetAvailWriteSpace(BTRACE_RTT_BUFFER) < size)
+		return 0;
+	return SEGGER_RTT_Write(BTRACE_RTT_BUFFER, data, size);
+}
+/***************************************************************************************************
+* @brief Drain the records to the BTRACE_RTT_BUFFER up buffer, as much as it can take.
+* @note  Capture the buffer on the host (e.g. JLinkRTTLogger -RTTChannel 1) and decode the file with
+*        Tools/btrace_decode.py.
+***************************************************************************************************/
+uint32_t BTRACE_DrainRTT(void)
+{
+	return BTRACE_Drain(BTRACE_RTTWriter, 0);
+}
+
+#endif /* BTRACE_EN */
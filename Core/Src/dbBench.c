@@ -0,0 +1,478 @@
+/***************************************************************************************************
+* @file
+* @brief     Storage stack benchmark (UnQLite -> VFS -> uC/FS -> NOR).
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            Every workload prints one line:
+*            "B,<workload>,ops=<n>,ms=<elapsed>,ops/s=<n>,flashUs=<n>,pgm=<octets>,erase=<n>"
+*            flashUs is only known with the simulator (bus transfers plus program/erase time) and
+*            reads 0 on target. The update workload also prints "B,update,pgm/op=<octets>", the flash
+*            cost of one KV update, to compare file system and raw device databases.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "dbBench.h"
+#include "stdio.h"	// snprintf
+#include "string.h"	// memset
+#include "unqlite.h"
+#include "vfs.h"
+#include "fs_api.h"
+#include "fs_dev_nor.h"
+#ifdef FS_DEV_NOR_BSP_SIM_EN
+#include "Dev/NOR/BSP/bsp_fs_dev_nor_sim.h"
+#endif
+
+/* Millisecond clock. Host builds provide their own. */
+#ifndef DBBENCH_TIME_MS
+#include "main.h"
+#define DBBENCH_TIME_MS()				HAL_GetTick()
+#endif
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+/* Clock and flash counters at a point in time. */
+typedef struct
+{
+	uint32_t ms;
+	uint64_t flashUs;
+	uint64_t pgmOctets;
+	uint32_t erases;
+} DBBENCH_SAMPLE;
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+/* Collection workload: $n documents are stored, then the whole collection is filtered. */
+static const char jx9Store[] =
+	"if( !db_exists('bench') ){ db_create('bench'); }"
+	"for($i = 0; $i < $n; $i++){ db_store('bench', {id: $i, grp: $i % 16, name: 'record'}); }";
+static const char jx9Query[] =
+	"$res = db_fetch_all('bench', function($rec){ return $rec.grp == 3; });";
+/* Same query with a declarative filter, evaluated without the VM. */
+static const char jx9QueryNative[] =
+	"$res = db_fetch_all('bench', {grp: 3});";
+/* One-line script, compiled and run once per operation: measures the VM creation cost. */
+static const char jx9OneLine[] =
+	"$res = [strlen('bench'), db_version()];";
+
+/***************************************************************************************************
+* @brief Read the clock and the flash counters.
+***************************************************************************************************/
+static void DBBENCH_Sample(DBBENCH_SAMPLE *sample)
+{
+	memset(sample, 0, sizeof(*sample));
+	sample->ms = DBBENCH_TIME_MS();
+
+#if defined(FS_DEV_NOR_BSP_SIM_EN)
+	{
+		FS_DEV_NOR_SIM_STAT stat;
+
+		FSDev_NOR_SimStatGet(&stat);
+		sample->flashUs = stat.BusTime_us + stat.BusyTime_us;
+		sample->pgmOctets = stat.PgmOctetCtr;
+		sample->erases = stat.EraseSecCtr + stat.EraseBlk32KCtr + stat.EraseBlk64KCtr + stat.EraseChipCtr;
+	}
+#elif (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
+	{
+		FS_DEV_NOR_STAT stat;
+		FS_ERR err;
+
+		FSDev_NOR_StatGet(DBBENCH_NOR_DEV, &stat, &err);
+		if (err == FS_ERR_NONE)
+		{
+			sample->pgmOctets = stat.WrOctetCtr;
+			sample->erases = stat.EraseBlkCtr;
+		}
+	}
+#endif
+}
+/***************************************************************************************************
+* @brief Print the result of a workload started at 'begin'.
+* @return Octets programmed during the workload.
+***************************************************************************************************/
+static uint64_t DBBENCH_Report(DBBENCH_WRITER writer, void *arg, const char *name, uint32_t ops, const DBBENCH_SAMPLE *begin)
+{
+	DBBENCH_SAMPLE end;
+	char line[160];
+	uint32_t ms;
+
+	DBBENCH_Sample(&end);
+	ms = end.ms - begin->ms;
+	snprintf(line, sizeof(line), "B,%s,ops=%lu,ms=%lu,ops/s=%lu,flashUs=%llu,pgm=%llu,erase=%lu\n", name,
+			 (unsigned long)ops, (unsigned long)ms, (unsigned long)(((uint64_t)ops * 1000u) / (ms ? ms : 1)),
+			 (unsigned long long)(end.flashUs - begin->flashUs),
+			 (unsigned long long)(end.pgmOctets - begin->pgmOctets),
+			 (unsigned long)(end.erases - begin->erases));
+	writer(line, arg);
+	return end.pgmOctets - begin->pgmOctets;
+}
+/***************************************************************************************************
+* @brief Deterministic pseudo random generator (xorshift32), so that runs can be compared.
+***************************************************************************************************/
+static uint32_t DBBENCH_Rand(uint32_t *state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+/***************************************************************************************************
+* @brief Store record 'i' with a value derived from 'seed'.
+***************************************************************************************************/
+static int DBBENCH_Put(unqlite *pDb, uint32_t i, uint32_t seed)
+{
+	char key[16];
+	char value[DBBENCH_VALUE_SIZE];
+	int keyLen;
+
+	keyLen = snprintf(key, sizeof(key), "k%08lu", (unsigned long)i);
+	memset(value, 'a' + (int)(seed % 26), sizeof(value));
+	snprintf(value, sizeof(value), "%08lx", (unsigned long)seed);
+	return unqlite_kv_store(pDb, key, keyLen, value, sizeof(value));
+}
+/***************************************************************************************************
+* @brief Store record 'i' with a DBBENCH_ZIP_VALUE_SIZE sensor log (compressible) derived from
+*        'seed' (not 0).
+***************************************************************************************************/
+static int DBBENCH_PutLog(unqlite *pDb, uint32_t i, uint32_t seed)
+{
+	static char value[DBBENCH_ZIP_VALUE_SIZE];
+	char key[16];
+	int keyLen;
+	int len;
+	int n;
+
+	keyLen = snprintf(key, sizeof(key), "z%08lu", (unsigned long)i);
+	for (len = 0; len < (int)sizeof(value); len += n)
+	{
+		n = snprintf(&value[len], sizeof(value) - len, "{\"sensor\":%lu,\"t\":%lu,\"temp\":%lu.%lu,\"status\":\"ok\"}\n",
+					 (unsigned long)(i % 16), (unsigned long)(seed + len), (unsigned long)(20 + DBBENCH_Rand(&seed) % 5),
+					 (unsigned long)(seed % 10));
+		if (n >= (int)sizeof(value) - len)
+			break;
+	}
+	return unqlite_kv_store(pDb, key, keyLen, value, sizeof(value));
+}
+/***************************************************************************************************
+* @brief Fetch consumer that only counts the octets of the record (unqlite_int64 *pUserData).
+***************************************************************************************************/
+static int DBBENCH_Discard(const void *pData, unsigned int iDataLen, void *pUserData)
+{
+	(void)pData;
+	*(unqlite_int64 *)pUserData += iDataLen;
+	return UNQLITE_OK;
+}
+/***************************************************************************************************
+* @brief Run a Jx9 script with the variable $n set to 'n'.
+* @param pCount If not NULL, receives the number of entries of the $res array.
+***************************************************************************************************/
+static int DBBENCH_Jx9(unqlite *pDb, const char *script, uint32_t n, uint32_t *pCount)
+{
+	unqlite_value *pValue;
+	unqlite_vm *pVm;
+	int rc;
+
+	rc = unqlite_compile(pDb, script, -1, &pVm);
+	if (rc != UNQLITE_OK)
+		return rc;
+
+	pValue = unqlite_vm_new_scalar(pVm);
+	if (pValue == 0)
+	{
+		unqlite_vm_release(pVm);
+		return UNQLITE_NOMEM;
+	}
+	unqlite_value_int64(pValue, (unqlite_int64)n);
+	unqlite_vm_config(pVm, UNQLITE_VM_CONFIG_CREATE_VAR, "n", pValue);
+	unqlite_vm_release_value(pVm, pValue);
+
+	rc = unqlite_vm_exec(pVm);
+	if (rc == UNQLITE_OK && pCount)
+	{
+		pValue = unqlite_vm_extract_variable(pVm, "res");
+		*pCount = (pValue && unqlite_value_is_json_array(pValue)) ? (uint32_t)unqlite_array_count(pValue) : 0;
+	}
+	unqlite_vm_release(pVm);
+	return rc;
+}
+/***************************************************************************************************
+* @brief Run the workloads on a fresh database.
+* @details The workloads run in this order, each one on the data left by the previous ones:
+*          seq_insert  store nRecords records with increasing keys, DBBENCH_BATCH per transaction.
+*          rand_get    fetch nRecords random records.
+*          update      overwrite nRecords random records, DBBENCH_BATCH per transaction.
+*          commit      overwrite DBBENCH_COMMITS random records, one per transaction.
+*          group_commit_<n> same with group commit, n transactions flushed together, for n = 1, 2,
+*                      4... up to DBBENCH_GROUP_COMMIT (group_commit_1 adds the group overhead alone).
+*          scan_ra<n>  walk all the records with a cursor, reading every value, from a cold cache
+*                      (reopened database) with a read-ahead window of n pages: 0 then
+*                      DBBENCH_READ_AHEAD. Followed by the read-ahead I/Os, prefetched pages used
+*                      and prefetched pages discarded.
+*          zip_off     store min(nRecords, DBBENCH_ZIP_RECORDS) DBBENCH_ZIP_VALUE_SIZE sensor logs
+*                      (overflow pages) without compression, followed by the compression statistics
+*                      and the octets programmed per record.
+*          zip_off_read fetch them back from a cold cache (reopened database).
+*          zip_on      zip_on_read: same with UNQLITE_KV_CONFIG_COMPRESS enabled.
+*          jx9_store   store nRecords JSON documents in a collection with a Jx9 script.
+*          jx9_query   filter the whole collection with db_fetch_all() and a callback.
+*          jx9_native  same filter as a declarative filter object ({grp: 3}).
+*          jx9_compile compile and run a one-line script nRecords times.
+* @param dbPath   Database file, deleted (with its journal) before the run. A raw device name
+*                 ("nor:1:") runs the workloads on the device without file system (see vfsDev.h).
+* @param nRecords Number of records of the workloads.
+* @param writer   Receives the report lines.
+* @return UNQLITE_OK or the error code of the failing workload (also reported as "B,error,...").
+***************************************************************************************************/
+int DBBENCH_Run(const char *dbPath, uint32_t nRecords, DBBENCH_WRITER writer, void *arg)
+{
+	char value[DBBENCH_VALUE_SIZE];
+	char name[64];
+	char label[24];
+	unqlite_vfs *pVfs;
+	const char *step;
+	unqlite_kv_cursor *pCursor;
+	unqlite_int64 nBytes;
+	DBBENCH_SAMPLE begin;
+	unqlite *pDb;
+	uint32_t rand;
+	uint32_t group;
+	uint32_t raPage;
+	uint32_t zipRecords;
+	unqlite_int64 zipIn;
+	unqlite_int64 zipOut;
+	unsigned int raRead;
+	unsigned int raHit;
+	unsigned int raWaste;
+	uint32_t ops;
+	uint32_t i;
+	int rc;
+
+	if (nRecords == 0)
+		nRecords = 1;
+
+	/* Through the VFS, so that raw device databases are deleted as well */
+	pVfs = (unqlite_vfs *)unqliteExportBuiltinVfs();
+	pVfs->xDelete(pVfs, dbPath, 0);
+	snprintf(name, sizeof(name), "%s%s", dbPath, UNQLITE_JOURNAL_FILE_SUFFIX);
+	pVfs->xDelete(pVfs, name, 0);
+
+	step = "open";
+	rc = unqlite_open(&pDb, dbPath, UNQLITE_OPEN_CREATE);
+	if (rc != UNQLITE_OK)
+		goto fail;
+
+	step = "seq_insert";
+	DBBENCH_Sample(&begin);
+	for (i = 0; i < nRecords && rc == UNQLITE_OK; i++)
+	{
+		rc = DBBENCH_Put(pDb, i, i);
+		if (rc == UNQLITE_OK && (i + 1) % DBBENCH_BATCH == 0)
+			rc = unqlite_commit(pDb);
+	}
+	if (rc == UNQLITE_OK)
+		rc = unqlite_commit(pDb);
+	if (rc != UNQLITE_OK)
+		goto close;
+	DBBENCH_Report(writer, arg, step, nRecords, &begin);
+
+	step = "rand_get";
+	rand = 0x2545F491;
+	DBBENCH_Sample(&begin);
+	for (i = 0; i < nRecords && rc == UNQLITE_OK; i++)
+	{
+		int keyLen = snprintf(name, sizeof(name), "k%08lu", (unsigned long)(DBBENCH_Rand(&rand) % nRecords));
+
+		nBytes = sizeof(value);
+		rc = unqlite_kv_fetch(pDb, name, keyLen, value, &nBytes);
+	}
+	if (rc != UNQLITE_OK)
+		goto close;
+	DBBENCH_Report(writer, arg, step, nRecords, &begin);
+
+	step = "update";
+	DBBENCH_Sample(&begin);
+	for (i = 0; i < nRecords && rc == UNQLITE_OK; i++)
+	{
+		rc = DBBENCH_Put(pDb, DBBENCH_Rand(&rand) % nRecords, rand);
+		if (rc == UNQLITE_OK && (i + 1) % DBBENCH_BATCH == 0)
+			rc = unqlite_commit(pDb);
+	}
+	if (rc == UNQLITE_OK)
+		rc = unqlite_commit(pDb);
+	if (rc != UNQLITE_OK)
+		goto close;
+	nBytes = (unqlite_int64)DBBENCH_Report(writer, arg, step, nRecords, &begin);
+	snprintf(name, sizeof(name), "B,update,pgm/op=%lu\n", (unsigned long)(nBytes / nRecords));
+	writer(name, arg);
+
+	step = "commit";
+	DBBENCH_Sample(&begin);
+	for (i = 0; i < DBBENCH_COMMITS && rc == UNQLITE_OK; i++)
+	{
+		rc = DBBENCH_Put(pDb, DBBENCH_Rand(&rand) % nRecords, rand);
+		if (rc == UNQLITE_OK)
+			rc = unqlite_commit(pDb);
+	}
+	if (rc != UNQLITE_OK)
+		goto close;
+	DBBENCH_Report(writer, arg, step, DBBENCH_COMMITS, &begin);
+
+	/* No time window: groups are only flushed when full, so that runs can be compared */
+	for (group = 1; group <= DBBENCH_GROUP_COMMIT; group *= 2)
+	{
+		snprintf(label, sizeof(label), "group_commit_%lu", (unsigned long)group);
+		step = label;
+		DBBENCH_Sample(&begin);
+		rc = unqlite_config(pDb, UNQLITE_CONFIG_GROUP_COMMIT, (int)group, 0, (unsigned int (*)(void))0);
+		for (i = 0; i < DBBENCH_COMMITS && rc == UNQLITE_OK; i++)
+		{
+			rc = DBBENCH_Put(pDb, DBBENCH_Rand(&rand) % nRecords, rand);
+			if (rc == UNQLITE_OK)
+				rc = unqlite_commit(pDb);
+		}
+		/* Flush the last group */
+		if (rc == UNQLITE_OK)
+			rc = unqlite_config(pDb, UNQLITE_CONFIG_GROUP_COMMIT_FLUSH, 0);
+		if (rc != UNQLITE_OK)
+			goto close;
+		DBBENCH_Report(writer, arg, step, DBBENCH_COMMITS, &begin);
+	}
+	rc = unqlite_config(pDb, UNQLITE_CONFIG_GROUP_COMMIT, 0, 0, (unsigned int (*)(void))0);
+	if (rc != UNQLITE_OK)
+		goto close;
+
+	/* Cold cache scans, without then with read-ahead (see UNQLITE_CONFIG_READ_AHEAD) */
+	for (i = 0; i < 2; i++)
+	{
+		raPage = i ? DBBENCH_READ_AHEAD : 0;
+		snprintf(label, sizeof(label), "scan_ra%lu", (unsigned long)raPage);
+		step = label;
+		unqlite_close(pDb);
+		rc = unqlite_open(&pDb, dbPath, UNQLITE_OPEN_CREATE);
+		if (rc != UNQLITE_OK)
+			goto fail;
+		rc = unqlite_config(pDb, UNQLITE_CONFIG_READ_AHEAD, (int)raPage);
+		if (rc != UNQLITE_OK)
+			goto close;
+		DBBENCH_Sample(&begin);
+		rc = unqlite_kv_cursor_init(pDb, &pCursor);
+		if (rc != UNQLITE_OK)
+			goto close;
+		ops = 0;
+		for (unqlite_kv_cursor_first_entry(pCursor); unqlite_kv_cursor_valid_entry(pCursor); unqlite_kv_cursor_next_entry(pCursor))
+		{
+			nBytes = sizeof(value);
+			unqlite_kv_cursor_data(pCursor, value, &nBytes);
+			ops++;
+		}
+		unqlite_kv_cursor_release(pDb, pCursor);
+		DBBENCH_Report(writer, arg, step, ops, &begin);
+		unqlite_config(pDb, UNQLITE_CONFIG_READ_AHEAD_STATS, &raRead, &raHit, &raWaste);
+		snprintf(name, sizeof(name), "B,%s,raRead=%u,raHit=%u,raWaste=%u\n", step, raRead, raHit, raWaste);
+		writer(name, arg);
+	}
+	rc = unqlite_config(pDb, UNQLITE_CONFIG_READ_AHEAD, 0);
+	if (rc != UNQLITE_OK)
+		goto close;
+
+	/* Overflow payloads without then with compression (see UNQLITE_KV_CONFIG_COMPRESS) */
+	zipRecords = (nRecords < DBBENCH_ZIP_RECORDS) ? nRecords : DBBENCH_ZIP_RECORDS;
+	for (i = 0; i < 2; i++)
+	{
+		snprintf(label, sizeof(label), "zip_%s", i ? "on" : "off");
+		step = label;
+		unqlite_close(pDb);
+		rc = unqlite_open(&pDb, dbPath, UNQLITE_OPEN_CREATE);
+		if (rc != UNQLITE_OK)
+			goto fail;
+		rc = unqlite_kv_config(pDb, UNQLITE_KV_CONFIG_COMPRESS, (int)i);
+		DBBENCH_Sample(&begin);
+		for (ops = 0; ops < zipRecords && rc == UNQLITE_OK; ops++)
+		{
+			/* Fresh records in both passes */
+			rc = DBBENCH_PutLog(pDb, i * DBBENCH_ZIP_RECORDS + ops, ops + 1);
+			if (rc == UNQLITE_OK && (ops + 1) % DBBENCH_BATCH == 0)
+				rc = unqlite_commit(pDb);
+		}
+		if (rc == UNQLITE_OK)
+			rc = unqlite_commit(pDb);
+		if (rc != UNQLITE_OK)
+			goto close;
+		nBytes = (unqlite_int64)DBBENCH_Report(writer, arg, step, zipRecords, &begin);
+		unqlite_kv_config(pDb, UNQLITE_KV_CONFIG_COMPRESS_STATS, &zipIn, &zipOut);
+		snprintf(name, sizeof(name), "B,%s,in=%llu,out=%llu,pgm/op=%lu\n", step, (unsigned long long)zipIn,
+				 (unsigned long long)zipOut, (unsigned long)(nBytes / zipRecords));
+		writer(name, arg);
+
+		/* Read back from a cold cache */
+		snprintf(label, sizeof(label), "zip_%s_read", i ? "on" : "off");
+		unqlite_close(pDb);
+		rc = unqlite_open(&pDb, dbPath, UNQLITE_OPEN_CREATE);
+		if (rc != UNQLITE_OK)
+			goto fail;
+		DBBENCH_Sample(&begin);
+		for (ops = 0; ops < zipRecords && rc == UNQLITE_OK; ops++)
+		{
+			int keyLen = snprintf(name, sizeof(name), "z%08lu", (unsigned long)(i * DBBENCH_ZIP_RECORDS + ops));
+
+			nBytes = 0;
+			rc = unqlite_kv_fetch_callback(pDb, name, keyLen, DBBENCH_Discard, &nBytes);
+			if (rc == UNQLITE_OK && nBytes != DBBENCH_ZIP_VALUE_SIZE)
+				rc = UNQLITE_CORRUPT;
+		}
+		if (rc != UNQLITE_OK)
+			goto close;
+		DBBENCH_Report(writer, arg, step, zipRecords, &begin);
+	}
+
+	step = "jx9_store";
+	DBBENCH_Sample(&begin);
+	rc = DBBENCH_Jx9(pDb, jx9Store, nRecords, 0);
+	if (rc == UNQLITE_OK)
+		rc = unqlite_commit(pDb);
+	if (rc != UNQLITE_OK)
+		goto close;
+	DBBENCH_Report(writer, arg, step, nRecords, &begin);
+
+	step = "jx9_query";
+	DBBENCH_Sample(&begin);
+	rc = DBBENCH_Jx9(pDb, jx9Query, nRecords, &ops);
+	if (rc != UNQLITE_OK)
+		goto close;
+	DBBENCH_Report(writer, arg, step, nRecords, &begin);
+	snprintf(name, sizeof(name), "B,jx9_query,matched=%lu\n", (unsigned long)ops);
+	writer(name, arg);
+
+	step = "jx9_native";
+	DBBENCH_Sample(&begin);
+	rc = DBBENCH_Jx9(pDb, jx9QueryNative, nRecords, &ops);
+	if (rc != UNQLITE_OK)
+		goto close;
+	DBBENCH_Report(writer, arg, step, nRecords, &begin);
+	snprintf(name, sizeof(name), "B,jx9_native,matched=%lu\n", (unsigned long)ops);
+	writer(name, arg);
+
+	step = "jx9_compile";
+	DBBENCH_Sample(&begin);
+	for (i = 0; i < nRecords && rc == UNQLITE_OK; i++)
+		rc = DBBENCH_Jx9(pDb, jx9OneLine, 0, 0);
+	if (rc != UNQLITE_OK)
+		goto close;
+	DBBENCH_Report(writer, arg, step, nRecords, &begin);
+
+close:
+	unqlite_close(pDb);
+fail:
+	if (rc != UNQLITE_OK)
+	{
+		snprintf(name, sizeof(name), "B,error,step=%s,rc=%d\n", step, rc);
+		writer(name, arg);
+	}
+	return rc;
+}
@@ -0,0 +1,241 @@
+/***************************************************************************************************
+* @file
+* @brief     I/O tracing across the storage stack (UnQLite pager, VFS, uC/FS, NOR).
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            Layers nest (a pager commit contains VFS writes which contain device writes...), so
+*            the time reported for a layer includes the time spent in the layers below it.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "ioTrace.h"
+#include "stdio.h"	// snprintf
+#include "string.h"	// memset, memcpy
+#include "main.h"
+#include "SEGGER_RTT.h"
+#include "fs_dev_nor.h"
+
+#ifdef IOTRACE_EN
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static volatile uint8_t enabled = 0;
+static IOTRACE_EVENT ring[IOTRACE_RING_SIZE];
+static uint32_t ringHead;	/* Total number of events written */
+static IOTRACE_LAYER_STAT stats[IOTRACE_LAYER_CNT];
+
+static const char * const layerName[IOTRACE_LAYER_CNT] = {"pager", "vfs", "journal", "dev", "nor"};
+static const char * const opName[IOTRACE_OP_CNT] = {"rd", "wr", "sync", "erase", "commit"};
+
+/***************************************************************************************************
+* @brief Start the cycle counter and clear the trace.
+***************************************************************************************************/
+void IOTRACE_Init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	IOTRACE_Reset();
+	enabled = 1;
+}
+/***************************************************************************************************
+* @brief Resume recording.
+***************************************************************************************************/
+void IOTRACE_Enable(void)
+{
+	enabled = 1;
+}
+/***************************************************************************************************
+* @brief Pause recording, the collected data is kept.
+***************************************************************************************************/
+void IOTRACE_Disable(void)
+{
+	enabled = 0;
+}
+/***************************************************************************************************
+* @brief Clear the ring buffer and the histograms.
+***************************************************************************************************/
+void IOTRACE_Reset(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(ring, 0, sizeof(ring));
+	memset(stats, 0, sizeof(stats));
+	ringHead = 0;
+	__set_PRIMASK(primask);
+}
+/***************************************************************************************************
+* @brief Return the timestamp to pass to IOTRACE_End() once the operation completes.
+***************************************************************************************************/
+uint32_t IOTRACE_Begin(void)
+{
+	return IOTRACE_TIMESTAMP();
+}
+/***************************************************************************************************
+* @brief Record an operation started at 'start' (returned by IOTRACE_Begin()).
+* @note  Safe to call from interrupts, the update of the shared state is done with interrupts masked.
+***************************************************************************************************/
+void IOTRACE_End(uint8_t layer, uint8_t op, uint32_t addr, uint32_t size, uint32_t start)
+{
+	IOTRACE_LAYER_STAT *stat;
+	IOTRACE_EVENT *event;
+	uint32_t durUs;
+	uint32_t bucket;
+	uint32_t primask;
+
+	if (!enabled || layer >= IOTRACE_LAYER_CNT || op >= IOTRACE_OP_CNT)
+		return;
+
+	durUs = (IOTRACE_TIMESTAMP() - start) / IOTRACE_TICKS_PER_US;
+	bucket = 0;
+	while (bucket < IOTRACE_HIST_BUCKETS - 1 && (durUs >> bucket) != 0)
+		bucket++;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	event = &ring[ringHead & (IOTRACE_RING_SIZE - 1)];
+	event->ts = start;
+	event->durUs = durUs;
+	event->addr = addr;
+	event->size = size;
+	event->layer = layer;
+	event->op = op;
+	ringHead++;
+
+	stat = &stats[layer];
+	stat->cnt[op]++;
+	stat->octets[op] += size;
+	stat->totalUs += durUs;
+	if (durUs > stat->maxUs)
+		stat->maxUs = durUs;
+	stat->hist[bucket]++;
+
+	__set_PRIMASK(primask);
+}
+/***************************************************************************************************
+* @brief Take a consistent copy of the counters.
+* @param norDevName Name of the NOR device (e.g. "nor:0:") whose uC/FS statistic counters are
+*                   folded in the snapshot, NULL to skip them.
+***************************************************************************************************/
+void IOTRACE_Snapshot(IOTRACE_SNAPSHOT *snap, char *norDevName)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	memset(snap, 0, sizeof(*snap));
+	__disable_irq();
+	memcpy(snap->layer, stats, sizeof(stats));
+	snap->eventCnt = ringHead;
+	__set_PRIMASK(primask);
+	snap->eventLost = snap->eventCnt > IOTRACE_RING_SIZE ? snap->eventCnt - IOTRACE_RING_SIZE : 0;
+
+#if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
+	if (norDevName)
+	{
+		FS_DEV_NOR_STAT norStat;
+		FS_ERR err;
+
+		FSDev_NOR_StatGet(norDevName, &norStat, &err);
+		if (err == FS_ERR_NONE)
+		{
+			snap->norStatValid = 1;
+			snap->norRdSec = norStat.RdCtr;
+			snap->norWrSec = norStat.WrCtr;
+			snap->norCopySec = norStat.CopyCtr;
+			snap->norReleaseSec = norStat.ReleaseCtr;
+			snap->norRdOctets = norStat.RdOctetCtr;
+			snap->norWrOctets = norStat.WrOctetCtr;
+			snap->norEraseBlk = norStat.EraseBlkCtr;
+			snap->norInvalidBlk = norStat.InvalidBlkCtr;
+		}
+	}
+#else
+	(void)norDevName;
+#endif
+}
+/***************************************************************************************************
+* @brief Write the snapshot and the ring buffer content as text lines.
+* @note  The output is made of three sections that are easy to split on the host side:
+*        "L,<layer>,<op>,<count>,<octets>" and "H,<layer>,<total us>,<max us>,<bucket 0>,..."
+*        for every layer, "N,<counters...>" for the NOR statistics and "E,<ts>,<layer>,<op>,
+*        <addr>,<size>,<us>" for every event still in the ring buffer, oldest first.
+*        The writer can target RTT (see IOTRACE_ExportRTT()) or a host file through semihosting.
+***************************************************************************************************/
+void IOTRACE_Export(IOTRACE_WRITER writer, void *arg, char *norDevName)
+{
+	static IOTRACE_SNAPSHOT snap;
+	char line[160];
+	uint32_t first;
+	uint32_t i;
+	uint32_t n;
+	int len;
+	uint8_t wasEnabled = enabled;
+
+	enabled = 0;	/* Don't trace the export itself */
+	IOTRACE_Snapshot(&snap, norDevName);
+
+	for (i = 0; i < IOTRACE_LAYER_CNT; i++)
+	{
+		IOTRACE_LAYER_STAT *stat = &snap.layer[i];
+
+		for (n = 0; n < IOTRACE_OP_CNT; n++)
+		{
+			if (stat->cnt[n] == 0)
+				continue;
+			snprintf(line, sizeof(line), "L,%s,%s,%lu,%llu\n", layerName[i], opName[n],
+					 (unsigned long)stat->cnt[n], (unsigned long long)stat->octets[n]);
+			writer(line, arg);
+		}
+		len = snprintf(line, sizeof(line), "H,%s,%llu,%lu", layerName[i],
+					   (unsigned long long)stat->totalUs, (unsigned long)stat->maxUs);
+		for (n = 0; n < IOTRACE_HIST_BUCKETS && len > 0 && len < (int)sizeof(line) - 12; n++)
+			len += snprintf(&line[len], sizeof(line) - len, ",%lu", (unsigned long)stat->hist[n]);
+		writer(line, arg);
+		writer("\n", arg);
+	}
+
+	if (snap.norStatValid)
+	{
+		snprintf(line, sizeof(line), "N,rd=%lu,wr=%lu,copy=%lu,release=%lu,rdOctets=%lu,wrOctets=%lu,erase=%lu,invalid=%lu\n",
+				 (unsigned long)snap.norRdSec, (unsigned long)snap.norWrSec, (unsigned long)snap.norCopySec,
+				 (unsigned long)snap.norReleaseSec, (unsigned long)snap.norRdOctets, (unsigned long)snap.norWrOctets,
+				 (unsigned long)snap.norEraseBlk, (unsigned long)snap.norInvalidBlk);
+		writer(line, arg);
+	}
+
+	n = snap.eventCnt > IOTRACE_RING_SIZE ? IOTRACE_RING_SIZE : snap.eventCnt;
+	first = snap.eventCnt - n;
+	for (i = 0; i < n; i++)
+	{
+		IOTRACE_EVENT *event = &ring[(first + i) & (IOTRACE_RING_SIZE - 1)];
+
+		snprintf(line, sizeof(line), "E,%lu,%s,%s,%lu,%lu,%lu\n", (unsigned long)event->ts,
+				 layerName[event->layer], opName[event->op], (unsigned long)event->addr,
+				 (unsigned long)event->size, (unsigned long)event->durUs);
+		writer(line, arg);
+	}
+	snprintf(line, sizeof(line), "S,events=%lu,lost=%lu\n", (unsigned long)snap.eventCnt, (unsigned long)snap.eventLost);
+	writer(line, arg);
+
+	enabled = wasEnabled;
+}
+/***************************************************************************************************
+* @brief Writer sending the export to an RTT up buffer.
+***************************************************************************************************/
+static void IOTRACE_RTTWriter(const char *str, void *arg)
+{
+	SEGGER_RTT_WriteString((unsigned)(uintptr_t)arg, str);
+}
+/***************************************************************************************************
+* @brief Export the trace to the given RTT up buffer (0 is the debug terminal).
+***************************************************************************************************/
+void IOTRACE_ExportRTT(unsigned bufferIndex, char *norDevName)
+{
+	IOTRACE_Export(IOTRACE_RTTWriter, (void *)(uintptr_t)bufferIndex, norDevName);
+}
+
+#endif /* IOTRACE_EN */
@@ -24,6 +24,8 @@
 #include "lib_mem.h"
 #include "fs_app.h"
 #include "unqlite.h"
+#include "ioTrace.h"
+#include "binTrace.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -226,6 +228,12 @@ int main(void)
   HAL_TIM_Base_Start_IT(&htim1);  //Timer for RTT shell
   Mem_Init();		// Micrium memory module init. Required for the uc-FS.
   App_FS_Init();	// Micrium FS init. Loads device drivers and open the default volume. Will format the FS if not found.
+#ifdef IOTRACE_EN
+  IOTRACE_Init();	// Storage I/O tracing, dumped with the "shell_iotrace" command.
+#endif
+#ifdef BTRACE_EN
+  BTRACE_Init();	// Deferred binary trace (FS_TRACE, VFS_DEBUG_MSG), drained to RTT up buffer 1.
+#endif
   unqlite *pDb;
   int rc;
   const char *zBuf;
@@ -295,6 +303,9 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+#ifdef BTRACE_EN
+    BTRACE_DrainRTT();
+#endif
   }
   /* USER CODE END 3 */
 }
@@ -361,6 +361,8 @@ struct SyMutexMethods
 	void  (*xEnter)(SyMutex *);	    /* [Required:] Enter mutex */
 	int (*xTryEnter)(SyMutex *);    /* [Optional:] Try to enter a mutex */
 	void  (*xLeave)(SyMutex *);	    /* [Required:] Leave a locked mutex */
+	int (*xEnterShared)(SyMutex *); /* [Optional:] Enter a SXMUTEX_TYPE_RW mutex in shared mode */
+	void  (*xLeaveShared)(SyMutex *); /* [Optional:] Leave a mutex entered in shared mode */
 };
 #if defined (_MSC_VER) || defined (__MINGW32__) ||  defined (__GNUC__) && defined (__declspec)
 #define SX_APIIMPORT	__declspec(dllimport)
@@ -467,6 +469,54 @@ typedef sxi64 unqlite_int64;
 #define UNQLITE_CONFIG_KV_ENGINE           4  /* ONE ARGUMENT: const char *zKvName */
 #define UNQLITE_CONFIG_DISABLE_AUTO_COMMIT 5  /* NO ARGUMENTS */
 #define UNQLITE_CONFIG_GET_KV_NAME         6  /* ONE ARGUMENT: const char **pzPtr */
+#define UNQLITE_CONFIG_GROUP_COMMIT        7  /* THREE ARGUMENTS: int nMaxCommit, int nWindowMs, unsigned int (*xTick)(void) */
+#define UNQLITE_CONFIG_READ_AHEAD          8  /* ONE ARGUMENT: int nMaxPage */
+#define UNQLITE_CONFIG_READ_AHEAD_STATS    9  /* THREE ARGUMENTS: unsigned int *pnRead, unsigned int *pnHit, unsigned int *pnWaste */
+#define UNQLITE_CONFIG_GROUP_COMMIT_FLUSH  10 /* ONE ARGUMENT: int bExpired */
+/*
+ * Group commit (UNQLITE_CONFIG_GROUP_COMMIT).
+ *
+ * When nMaxCommit is greater than one, unqlite_commit() acknowledges a transaction
+ * without touching the disk and keeps its changes in the page cache. The queued
+ * commits are flushed together through a single journal/sync cycle once nMaxCommit
+ * of them have been queued or, if xTick (a millisecond tick source) is not NULL and
+ * nWindowMs is greater than zero, once the first queued commit is at least nWindowMs
+ * old. Configuring the verb again flushes any queued commit; pass nMaxCommit = 0 to
+ * flush and disable group commit.
+ *
+ * The window is only checked by unqlite_commit(): on a quiet system, call
+ *
+ *     unqlite_config(pDb,UNQLITE_CONFIG_GROUP_COMMIT_FLUSH,1);
+ *
+ * from a periodic timer (or the idle loop) to flush the group once its window is over,
+ * or with 0 to flush it right away. The flush returns UNQLITE_BUSY without writing
+ * anything while a transaction has uncommitted changes: its commit flushes the group.
+ *
+ * Durability trade-off: up to nMaxCommit-1 acknowledged commits are lost on power
+ * failure (the database reverts to the last flushed group). Acknowledged commits are
+ * not lost on rollback: pages changed after an acknowledged commit are copied first,
+ * so a rollback (explicit, or by unqlite_close() with auto-commit disabled) only
+ * reverts the current transaction and then flushes the group. This costs one page
+ * of memory per page changed in the current transaction. If that flush fails (I/O
+ * error), the whole group is rolled back and the rollback returns the error.
+ */
+/*
+ * Read-ahead (UNQLITE_CONFIG_READ_AHEAD).
+ *
+ * When the pager detect that pages are read from disk in ascending order (cursor walks
+ * over buckets allocated one after the other for example), it reads the following pages
+ * in a single larger read and serves them from memory. The window starts at two pages,
+ * doubles each time it is fully used and is halved when most of it is wasted, up to
+ * nMaxPage pages (32 at most). A buffer of nMaxPage pages is allocated on first use.
+ * Read-ahead is disabled by default: enable it per database handle with
+ *
+ *     unqlite_config(pDb,UNQLITE_CONFIG_READ_AHEAD,8);
+ *
+ * or for every handle by building with -DUNQLITE_DEFAULT_READ_AHEAD=8. Pass 0 to
+ * disable it again.
+ * UNQLITE_CONFIG_READ_AHEAD_STATS reports the number of read-ahead I/Os issued, the
+ * number of prefetched pages that were used and the number discarded unused.
+ */
 /*
  * UnQLite/Jx9 Virtual Machine Configuration Commands.
  *
@@ -512,6 +562,27 @@ typedef sxi64 unqlite_int64;
  */
 #define UNQLITE_KV_CONFIG_HASH_FUNC  1 /* ONE ARGUMENT: unsigned int (*xHash)(const void *,unsigned int) */
 #define UNQLITE_KV_CONFIG_CMP_FUNC   2 /* ONE ARGUMENT: int (*xCmp)(const void *,const void *,unsigned int) */
+#define UNQLITE_KV_CONFIG_COMPRESS   3 /* ONE ARGUMENT: int bEnable */
+#define UNQLITE_KV_CONFIG_COMPRESS_STATS 4 /* TWO ARGUMENTS: unqlite_int64 *pnIn, unqlite_int64 *pnOut */
+#define UNQLITE_KV_CONFIG_BUCKET_STATS   5 /* TWO ARGUMENTS: unsigned int *aCount, int nCount */
+/*
+ * Overflow payload compression (UNQLITE_KV_CONFIG_COMPRESS).
+ *
+ * When enabled, record data that does not fit in its bucket page is compressed using
+ * a compact LZ codec before being written to the overflow pages. Data that does not
+ * shrink by at least one eighth is stored as is. Compressed records are flagged in
+ * their cell header so they can be read back whatever the setting of the reading handle.
+ * UNQLITE_KV_CONFIG_COMPRESS_STATS report the total amount of overflow data submitted
+ * for compression and the amount actually written to disk since the database was opened.
+ */
+/*
+ * Bucket occupancy (UNQLITE_KV_CONFIG_BUCKET_STATS).
+ *
+ * Fill aCount[i] with the number of buckets holding i records, the last entry counting
+ * the buckets holding nCount-1 records or more. The records of a bucket share its page
+ * (and slave pages once it is full), so this histogram shows how well the hash function
+ * (UNQLITE_KV_CONFIG_HASH_FUNC) spreads the keys of the database.
+ */
 /*
  * Global Library Configuration Commands.
  *
@@ -637,9 +708,18 @@ struct unqlite_file {
  * the file. The sector size is the minimum write that can be performed without
  * disturbing other bytes in the file.
  *
+ * The xFetch() and xUnfetch() methods are only present when iVersion is 2 or greater.
+ * xFetch() asks the VFS for a direct pointer to iAmt bytes of file content starting
+ * at offset iOfst. If the backing store is addressable (RAM disk, memory mapped file,
+ * execute-in-place flash...) the method set *pp to that memory and return UNQLITE_OK.
+ * Otherwise it must set *pp to NULL and still return UNQLITE_OK so that the caller
+ * fall back to xRead(). The memory is treated as read-only by the caller and must stay
+ * valid until the matching xUnfetch() call. References still outstanding when the
+ * file is closed are implicitly released by xClose().
+ *
  */
 struct unqlite_io_methods {
-  int iVersion;                 /* Structure version number (currently 1) */
+  int iVersion;                 /* Structure version number (currently 2) */
   int (*xClose)(unqlite_file*);
   int (*xRead)(unqlite_file*, void*, unqlite_int64 iAmt, unqlite_int64 iOfst);
   int (*xWrite)(unqlite_file*, const void*, unqlite_int64 iAmt, unqlite_int64 iOfst);
@@ -650,6 +730,10 @@ struct unqlite_io_methods {
   int (*xUnlock)(unqlite_file*, int);
   int (*xCheckReservedLock)(unqlite_file*, int *pResOut);
   int (*xSectorSize)(unqlite_file*);
+  /* Methods above are valid for version 1 */
+  int (*xFetch)(unqlite_file*, unqlite_int64 iOfst, int iAmt, void **pp);
+  int (*xUnfetch)(unqlite_file*, unqlite_int64 iOfst, void *p);
+  /* Methods above are valid for version 2 */
 };
 /*
  * CAPIREF: OS Interface Object
@@ -771,6 +855,7 @@ struct unqlite_kv_io
 	void (*xSetUnpin)(unqlite_kv_handle,void (*xPageUnpin)(void *)); 
 	void (*xSetReload)(unqlite_kv_handle,void (*xPageReload)(void *));
 	void (*xErr)(unqlite_kv_handle,const char *);
+	int (*xCacheOnly)(unqlite_kv_handle);
 };
 /*
  * Key/Value Storage Engine Cursor Object
@@ -1408,9 +1493,9 @@ JX9_PRIVATE int jx9_vm_config(jx9_vm *pVm, int iConfigOp, ...);
 JX9_PRIVATE int jx9_vm_release(jx9_vm *pVm);
 /*JX9_PRIVATE int jx9_vm_dump_v2(jx9_vm *pVm, int (*xConsumer)(const void *, unsigned int, void *), void *pUserData);*/
 /* In-process Extending Interfaces */
-JX9_PRIVATE int jx9_create_function(jx9_vm *pVm, const char *zName, int (*xFunc)(jx9_context *, int, jx9_value **), void *pUserData);
+/*JX9_PRIVATE int jx9_create_function(jx9_vm *pVm, const char *zName, int (*xFunc)(jx9_context *, int, jx9_value **), void *pUserData);*/
 /*JX9_PRIVATE int jx9_delete_function(jx9_vm *pVm, const char *zName);*/
-JX9_PRIVATE int jx9_create_constant(jx9_vm *pVm, const char *zName, void (*xExpand)(jx9_value *, void *), void *pUserData);
+/*JX9_PRIVATE int jx9_create_constant(jx9_vm *pVm, const char *zName, void (*xExpand)(jx9_value *, void *), void *pUserData);*/
 /*JX9_PRIVATE int jx9_delete_constant(jx9_vm *pVm, const char *zName);*/
 /* Foreign Function Parameter Values */
 JX9_PRIVATE int jx9_value_to_int(jx9_value *pValue);
@@ -1773,6 +1858,7 @@ struct SyMemBackend
 #define SXMUTEX_TYPE_STATIC_4	6
 #define SXMUTEX_TYPE_STATIC_5	7
 #define SXMUTEX_TYPE_STATIC_6	8
+#define SXMUTEX_TYPE_RW	9 /* Reader/writer lock (See xEnterShared()) */
 
 #define SyMutexGlobalInit(METHOD){\
 	if( (METHOD)->xGlobalInit ){\
@@ -2349,6 +2435,7 @@ struct jx9_context
 };
 /* Hashmap control flags */
 #define HASHMAP_JSON_OBJECT 0x001 /* Hashmap represent JSON Object*/
+#define HASHMAP_PACKED      0x002 /* Packed list: keys 0..nEntry-1, no nodes [see HashmapUnpack()] */
 /*
  * Each hashmap entry [i.e: array(4, 5, 6)] is recorded in an instance
  * of the following structure.
@@ -2385,6 +2472,10 @@ struct jx9_hashmap
 	sxi32 iFlags;                 /* Hashmap control flags */
 	sxi64 iNextIdx;               /* Next available automatically assigned index */
 	sxi32 iRef;                   /* Reference count */
+	sxu32 *aSlot;                 /* Packed list: value index of each entry, in key order */
+	sxu32 nSlot;                  /* Packed list: allocated slots */
+	sxu32 iSlotCur;               /* Packed list: loop cursor [SXU32_HIGH when exhausted] */
+	jx9_hashmap_node *pView;      /* Packed list: node handed out for the entry being accessed */
 };
 /* An instance of the following structure is the context
  * for the FOREACH_STEP/FOREACH_INIT VM instructions.
@@ -2613,6 +2704,27 @@ struct jx9_builtin_constant
 	const char *zName;     /* Constant name */
 	ProcConstant xExpand;  /* C routine responsible of expanding constant value*/
 };
+/*
+ * Built-in functions and constants are not installed in each VM. They stay in
+ * static tables shared by all the VMs and are looked up by name through an index
+ * sorted once at library initialization [i.e: jx9BuiltinTableSort()].
+ * A VM hashtable only holds the functions and constants installed at run-time
+ * plus the built-in functions the VM already called.
+ */
+typedef struct jx9_builtin_table jx9_builtin_table;
+struct jx9_builtin_table
+{
+	const void *aEntry; /* Static table [i.e: jx9_builtin_func or jx9_builtin_constant instances] */
+	sxu32 nEntry;       /* Total number of entries */
+	sxu32 nSize;        /* Size of a single entry */
+	sxi32 iData;        /* Private data of the entries [i.e: JX9_BUILTIN_DATA_VM] */
+	sxu16 *aSorted;     /* Entries index sorted by name */
+};
+/* Private data passed to the entries of a built-in table */
+#define JX9_BUILTIN_DATA_NONE 0 /* NULL */
+#define JX9_BUILTIN_DATA_VM   1 /* Calling VM */
+#define JX9_BUILTIN_DATA_VFS  2 /* Underlying VFS */
+#define JX9_BUILTIN_DATA_HOST 3 /* Host-application data [i.e: jx9_vm.pHostData] */
 /*
  * A single instruction of the virtual machine has an opcode
  * and as many as three operands.
@@ -2677,6 +2789,8 @@ struct jx9_vm
 	SySet aFreeObj;             /* Stack of free memory objects */
 	SyHash hConstant;           /* Host-application and user defined constants container */
 	SyHash hHostFunction;       /* Host-application installable functions */
+	const jx9_builtin_table *pHostTable; /* Host-application built-in functions [i.e: db_* functions] */
+	void *pHostData;            /* Private data of the pHostTable functions */
 	SyHash hFunction;           /* Compiled functions */
 	SyHash hSuper;              /* Global variable */
 	SyBlob sConsumer;           /* Default VM consumer [i.e Redirect all VM output to this blob] */
@@ -2936,6 +3050,7 @@ JX9_PRIVATE int jx9DeleteFunction(jx9_vm *pVm,const char *zName);
 JX9_PRIVATE int Jx9DeleteConstant(jx9_vm *pVm,const char *zName);
 /* json.c function prototypes */
 JX9_PRIVATE int jx9JsonSerialize(jx9_value *pValue,SyBlob *pOut);
+JX9_PRIVATE sxi32 jx9JsonStream(jx9_vm *pVm,jx9_value *pValue);
 JX9_PRIVATE int jx9JsonDecode(jx9_context *pCtx,const char *zJSON,int nByte);
 /* memobj.c function prototypes */
 JX9_PRIVATE sxi32 jx9MemObjDump(SyBlob *pOut, jx9_value *pObj);
@@ -2980,6 +3095,10 @@ JX9_PRIVATE sxi32 jx9VmInitFuncState(jx9_vm *pVm, jx9_vm_func *pFunc, const char
 JX9_PRIVATE sxi32 jx9VmInstallUserFunction(jx9_vm *pVm, jx9_vm_func *pFunc, SyString *pName);
 JX9_PRIVATE sxi32 jx9VmRegisterConstant(jx9_vm *pVm, const SyString *pName, ProcConstant xExpand, void *pUserData);
 JX9_PRIVATE sxi32 jx9VmInstallForeignFunction(jx9_vm *pVm, const SyString *pName, ProcHostFunction xFunc, void *pUserData);
+JX9_PRIVATE void jx9VmInstallBuiltinTable(jx9_vm *pVm, const jx9_builtin_table *pTable, void *pUserData);
+JX9_PRIVATE void jx9VmInitBuiltin(void);
+JX9_PRIVATE void jx9BuiltinTableSort(const jx9_builtin_table *pTable);
+JX9_PRIVATE const void * jx9BuiltinTableLookup(const jx9_builtin_table *pTable, const char *zName, sxu32 nLen);
 JX9_PRIVATE sxi32 jx9VmBlobConsumer(const void *pSrc, unsigned int nLen, void *pUserData);
 JX9_PRIVATE jx9_value * jx9VmReserveMemObj(jx9_vm *pVm,sxu32 *pIndex);
 JX9_PRIVATE jx9_value * jx9VmReserveConstObj(jx9_vm *pVm, sxu32 *pIndex);
@@ -3040,9 +3159,9 @@ JX9_PRIVATE sxi32 jx9ResetCodeGenerator(jx9_vm *pVm, ProcConsumer xErr, void *pE
 JX9_PRIVATE sxi32 jx9GenCompileError(jx9_gen_state *pGen, sxi32 nErrType, sxu32 nLine, const char *zFormat, ...);
 JX9_PRIVATE sxi32 jx9CompileScript(jx9_vm *pVm, SyString *pScript, sxi32 iFlags);
 /* constant.c function prototypes */
-JX9_PRIVATE void jx9RegisterBuiltInConstant(jx9_vm *pVm);
+JX9_PRIVATE const jx9_builtin_table * jx9ExportBuiltinConstant(void);
 /* builtin.c function prototypes */
-JX9_PRIVATE void jx9RegisterBuiltInFunction(jx9_vm *pVm);
+JX9_PRIVATE const jx9_builtin_table * jx9ExportBuiltinFunction(void);
 /* hashmap.c function prototypes */
 JX9_PRIVATE jx9_hashmap * jx9NewHashmap(jx9_vm *pVm, sxu32 (*xIntHash)(sxi64), sxu32 (*xBlobHash)(const void *, sxu32));
 JX9_PRIVATE sxi32 jx9HashmapLoadBuiltin(jx9_vm *pVm);
@@ -3055,10 +3174,11 @@ JX9_PRIVATE sxi32 jx9HashmapDup(jx9_hashmap *pSrc, jx9_hashmap *pDest);
 JX9_PRIVATE sxi32 jx9HashmapCmp(jx9_hashmap *pLeft, jx9_hashmap *pRight, int bStrict);
 JX9_PRIVATE void jx9HashmapResetLoopCursor(jx9_hashmap *pMap);
 JX9_PRIVATE jx9_hashmap_node * jx9HashmapGetNextEntry(jx9_hashmap *pMap);
+JX9_PRIVATE jx9_hashmap_node * jx9HashmapGetLastEntry(jx9_hashmap *pMap);
 JX9_PRIVATE jx9_value * jx9HashmapGetNodeValue(jx9_hashmap_node *pNode);
 JX9_PRIVATE void jx9HashmapExtractNodeValue(jx9_hashmap_node *pNode, jx9_value *pValue, int bStore);
 JX9_PRIVATE void jx9HashmapExtractNodeKey(jx9_hashmap_node *pNode, jx9_value *pKey);
-JX9_PRIVATE void jx9RegisterHashmapFunctions(jx9_vm *pVm);
+JX9_PRIVATE const jx9_builtin_table * jx9ExportHashmapFunction(void);
 JX9_PRIVATE sxi32 jx9HashmapWalk(jx9_hashmap *pMap, int (*xWalk)(jx9_value *, jx9_value *, void *), void *pUserData);
 #ifndef JX9_DISABLE_BUILTIN_FUNC
 JX9_PRIVATE int jx9HashmapValuesToSet(jx9_hashmap *pMap, SySet *pOut);
@@ -3080,6 +3200,8 @@ JX9_PRIVATE void jx9StreamCloseHandle(const jx9_io_stream *pStream, void *pHandl
 #endif /* JX9_DISABLE_BUILTIN_FUNC */
 JX9_PRIVATE const char * jx9ExtractDirName(const char *zPath, int nByte, int *pLen);
 JX9_PRIVATE sxi32 jx9RegisterIORoutine(jx9_vm *pVm);
+JX9_PRIVATE const jx9_builtin_table * jx9ExportVfsFunction(void);
+JX9_PRIVATE const jx9_builtin_table * jx9ExportIOFunction(void);
 JX9_PRIVATE const jx9_vfs * jx9ExportBuiltinVfs(void);
 JX9_PRIVATE void * jx9ExportStdin(jx9_vm *pVm);
 JX9_PRIVATE void * jx9ExportStdout(jx9_vm *pVm);
@@ -3324,6 +3446,16 @@ struct unqlite_db
 	jx9 *pJx9;                  /* Jx9 Engine handle */
 	unqlite_kv_cursor *pCursor; /* Database cursor for common usage */
 };
+/*
+ * Shared (read-only) access to the database handle.
+ * When the mutex methods support it, the per-handle mutex is a reader/writer lock:
+ * lookups and cursor reads enter it in shared mode and are served from the page cache
+ * only. Anything else (cache miss, overflow page, write, commit) enter it exclusively.
+ * Concurrent readers rely on atomic builtins for the page reference counts.
+ */
+#if defined(UNQLITE_ENABLE_THREADS) && (defined(__GNUC__) || defined(__clang__))
+#define UNQLITE_SHARED_READ
+#endif
 /*
  * Each database connection is an instance of the following structure.
  */
@@ -3335,6 +3467,7 @@ struct unqlite
 #if defined(UNQLITE_ENABLE_THREADS)
 	const SyMutexMethods *pMethods;  /* Mutex methods */
 	SyMutex *pMutex;                 /* Per-handle mutex */
+	int nReader;                     /* Threads holding pMutex in shared mode */
 #endif
 	unqlite_vm *pVms;                /* List of active VM */
 	sxi32 iVm;                       /* Total number of active VM */
@@ -3351,7 +3484,10 @@ struct unqlite
 #define UNQLITE_VM_AUTO_LOAD             0x004 /* Auto load a collection from the vfs */
 /* Forward declaration */
 typedef struct unqlite_col_record unqlite_col_record;
+typedef struct unqlite_col_live unqlite_col_live;
 typedef struct unqlite_col unqlite_col;
+typedef struct unqlite_filter_term unqlite_filter_term;
+typedef struct unqlite_col_filter unqlite_col_filter;
 /*
  * Each an in-memory collection record is stored in an instance
  * of the following structure.
@@ -3364,6 +3500,24 @@ struct unqlite_col_record
 	unqlite_col_record *pNextCol,*pPrevCol; /* Collision chain */
 	unqlite_col_record *pNext,*pPrev;       /* Linked list of records */
 };
+/*
+ * The IDs of the live records of a collection are tracked by a bitmap split in
+ * chunks of UNQLITE_COL_LIVE_BITS IDs. Each chunk with at least one live record
+ * is stored in the KV store under the collection name followed by a 0x01 byte
+ * and the chunk number. Chunks without live records are not stored.
+ */
+#define UNQLITE_COL_LIVE_BITS  4096
+#define UNQLITE_COL_LIVE_BYTES (UNQLITE_COL_LIVE_BITS / 8)
+struct unqlite_col_live
+{
+	sxu32 nLive;                                /* Total number of bits set */
+	unsigned char zBits[UNQLITE_COL_LIVE_BYTES]; /* Bit n is set if record (chunk * UNQLITE_COL_LIVE_BITS + n) is live */
+};
+/*
+ * State of a bitmap chunk (unqlite_col.aLiveState[]).
+ */
+#define UNQLITE_COL_LIVE_LOADED  0x01 /* Chunk read from the KV store (apLive[] is NULL if it has no live records) */
+#define UNQLITE_COL_LIVE_DIRTY   0x02 /* Chunk must be written back (See CollectionFlushLive()) */
 /* 
  * Magic number to identify a valid collection on disk.
  */
@@ -3389,10 +3543,49 @@ struct unqlite_col
 	sxu32 nRec;        /* Total number of records in apRecord[] */     
 	sxu32 nRecSize;    /* apRecord[] size */
 	Sytm sCreation;    /* Colleation creation time */
+	unqlite_col_live **apLive;  /* Live records bitmap chunks */
+	unsigned char *aLiveState;  /* State of each chunk (UNQLITE_COL_LIVE_* flags) */
+	sxu32 nLiveSize;            /* apLive[] and aLiveState[] size */
 	unqlite_kv_cursor *pCursor; /* Cursor pointing to the raw binary data */
 	unqlite_col *pNext,*pPrev;  /* Next and previous collection in the chain */
 	unqlite_col *pNextCol,*pPrevCol; /* Collision chain */
 };
+/*
+ * Collection control flags.
+ */
+#define UNQLITE_COL_HEADER_DIRTY   0x001 /* Record ID and count not yet written to the header (See CollectionStore()) */
+#define UNQLITE_COL_LIVE_CHANGED   0x002 /* Some live records bitmap chunks are dirty */
+#define UNQLITE_COL_LIVE_NEW       0x004 /* Live records bitmap marker not yet written */
+/*
+ * A declarative db_fetch_all() filter (e.g. {temp: {'>': 30}}) is compiled
+ * to a list of terms in prefix order and evaluated directly against the
+ * binary JSON of each record (See unqliteFilterMatch()).
+ */
+#define UNQLITE_FILTER_EQ   1 /* == */
+#define UNQLITE_FILTER_NE   2 /* != */
+#define UNQLITE_FILTER_LT   3 /* < */
+#define UNQLITE_FILTER_LE   4 /* <= */
+#define UNQLITE_FILTER_GT   5 /* > */
+#define UNQLITE_FILTER_GE   6 /* >= */
+#define UNQLITE_FILTER_AND  7 /* All the sub-terms match */
+#define UNQLITE_FILTER_OR   8 /* One of the sub-terms match */
+struct unqlite_filter_term
+{
+	int iOp;        /* UNQLITE_FILTER_* operator */
+	sxu32 nTerm;    /* Terms in this subtree, this one included */
+	sxu32 iField;   /* Compared field (Index in unqlite_col_filter.aField) */
+	int iType;      /* Operand type: FJSON_INT64, FJSON_REAL, FJSON_STRING, FJSON_TRUE, FJSON_FALSE or FJSON_NULL */
+	jx9_int64 iVal; /* FJSON_INT64 operand */
+	double rVal;    /* FJSON_REAL operand */
+	SyString sVal;  /* FJSON_STRING operand */
+};
+struct unqlite_col_filter
+{
+	SySet aTerm;    /* unqlite_filter_term, in prefix order */
+	SySet aField;   /* Compared top level fields (SyString) */
+	const unsigned char **azValue; /* Binary JSON value of each field in the current record or NULL */
+	SyMemBackend *pAlloc;          /* Memory backend */
+};
 /*
  * Each unQLite Virtual Machine resulting from successful compilation of
  * a Jx9 script is represented by an instance of the following structure.
@@ -3441,6 +3634,18 @@ struct unqlite_vm
 # undef UNQLITE_DEFAULT_PAGE_SIZE
 #endif
 # define UNQLITE_DEFAULT_PAGE_SIZE 4096 /* 4K */
+/*
+ * Default maximum read-ahead window (in pages) used by the pager when it
+ * detect sequential page reads. 0 (the default) disable read-ahead: it only
+ * pays off on storage where a large read is cheaper than several small ones
+ * and wastes memory and bandwidth on random access workloads.
+ * Build with -DUNQLITE_DEFAULT_READ_AHEAD=8 (for example) to enable it for every
+ * database handle or turn it on at run-time via UNQLITE_CONFIG_READ_AHEAD.
+ */
+#ifndef UNQLITE_DEFAULT_READ_AHEAD
+# define UNQLITE_DEFAULT_READ_AHEAD 0
+#endif
+#define UNQLITE_MAX_READ_AHEAD 32 /* Must fit in a sxu32 bitmap */
 /* Forward declaration */
 typedef struct Bitvec Bitvec;
 /* Private library functions */
@@ -3467,15 +3672,21 @@ UNQLITE_PRIVATE jx9_int64 unqliteCollectionCurrentRecordId(unqlite_col *pCol);
 UNQLITE_PRIVATE int unqliteCollectionCacheRemoveRecord(unqlite_col *pCol,jx9_int64 nId);
 UNQLITE_PRIVATE jx9_int64 unqliteCollectionTotalRecords(unqlite_col *pCol);
 UNQLITE_PRIVATE void unqliteCollectionResetRecordCursor(unqlite_col *pCol);
-UNQLITE_PRIVATE int unqliteCollectionFetchNextRecord(unqlite_col *pCol,jx9_value *pValue);
+UNQLITE_PRIVATE int unqliteCollectionFetchNextRecord(unqlite_col *pCol,jx9_value *pValue,SySet *pFields,unqlite_col_filter *pFilter);
 UNQLITE_PRIVATE int unqliteCollectionFetchRecordById(unqlite_col *pCol,jx9_int64 nId,jx9_value *pValue);
 UNQLITE_PRIVATE unqlite_col * unqliteCollectionFetch(unqlite_vm *pVm,SyString *pCol,int iFlag);
 UNQLITE_PRIVATE int unqliteCollectionSetSchema(unqlite_col *pCol,jx9_value *pValue);
 UNQLITE_PRIVATE int unqliteCollectionPut(unqlite_col *pCol,jx9_value *pValue,int iFlag);
 UNQLITE_PRIVATE int unqliteCollectionDropRecord(unqlite_col *pCol,jx9_int64 nId,int wr_header,int log_err);
 UNQLITE_PRIVATE int unqliteDropCollection(unqlite_col *pCol);
+UNQLITE_PRIVATE int unqliteVmFlushCollections(unqlite_vm *pVm);
+UNQLITE_PRIVATE void unqliteVmDiscardCollections(unqlite_vm *pVm,int bReload);
+UNQLITE_PRIVATE jx9_int64 unqliteCollectionFirstLiveId(unqlite_col *pCol);
+UNQLITE_PRIVATE jx9_int64 unqliteCollectionLastLiveId(unqlite_col *pCol);
 /* unql_jx9.c */
 UNQLITE_PRIVATE int unqliteRegisterJx9Functions(unqlite_vm *pVm);
+UNQLITE_PRIVATE void unqliteInitJx9Functions(void);
+UNQLITE_PRIVATE int unqliteFilterMatch(unqlite_col_filter *pFilter,const unsigned char *zIn,sxu32 nByte);
 /* fastjson.c */
 UNQLITE_PRIVATE sxi32 FastJsonEncode(
 	jx9_value *pValue, /* Value to encode */
@@ -3489,8 +3700,25 @@ UNQLITE_PRIVATE sxi32 FastJsonDecode(
 	const unsigned char **pzPtr,
 	int iNest /* Nesting limit */
 	);
+UNQLITE_PRIVATE sxi32 FastJsonDecodeFields(
+	const void *pIn, /* Binary JSON  */
+	sxu32 nByte,     /* Chunk delimiter */
+	jx9_value *pOut, /* Decoded value */
+	SySet *pFields   /* Fields to extract (SyString) */
+	);
+UNQLITE_PRIVATE int FastJsonFieldLookup(SySet *pFields,const char *zKey,sxu32 nByte);
+UNQLITE_PRIVATE sxi32 FastJsonSkip(
+	const unsigned char *zIn,    /* Binary JSON */
+	const unsigned char *zEnd,   /* End of input */
+	const unsigned char **pzPtr, /* OUT: Past the value */
+	int iNest /* Nesting limit */
+	);
 /* vfs.c [io_win.c, io_unix.c ] */
+#if defined(OS_OTHER)
 const unqlite_vfs * unqliteExportBuiltinVfs(void);
+#else
+UNQLITE_PRIVATE const unqlite_vfs * unqliteExportBuiltinVfs(void);
+#endif
 /* mem_kv.c */
 UNQLITE_PRIVATE const unqlite_kv_methods * unqliteExportMemKvStorage(void);
 /* lhash_kv.c */
@@ -3505,6 +3733,8 @@ UNQLITE_PRIVATE int unqliteOsLock(unqlite_file *id, int lockType);
 UNQLITE_PRIVATE int unqliteOsUnlock(unqlite_file *id, int lockType);
 UNQLITE_PRIVATE int unqliteOsCheckReservedLock(unqlite_file *id, int *pResOut);
 UNQLITE_PRIVATE int unqliteOsSectorSize(unqlite_file *id);
+UNQLITE_PRIVATE int unqliteOsFetch(unqlite_file *id, unqlite_int64 iOfst, int iAmt, void **pp);
+UNQLITE_PRIVATE int unqliteOsUnfetch(unqlite_file *id, unqlite_int64 iOfst, void *p);
 UNQLITE_PRIVATE int unqliteOsOpen(
   unqlite_vfs *pVfs,
   SyMemBackend *pAlloc,
@@ -3523,7 +3753,11 @@ UNQLITE_PRIVATE void unqliteBitvecDestroy(Bitvec *p);
 /* pager.c */
 UNQLITE_PRIVATE int unqliteInitCursor(unqlite *pDb,unqlite_kv_cursor **ppOut);
 UNQLITE_PRIVATE int unqliteReleaseCursor(unqlite *pDb,unqlite_kv_cursor *pCur);
+typedef unsigned int (*ProcGroupTick)(void);
 UNQLITE_PRIVATE int unqlitePagerSetCachesize(Pager *pPager,int mxPage);
+UNQLITE_PRIVATE int unqlitePagerSetGroupCommit(Pager *pPager,int nMaxCommit,int nWindowMs,ProcGroupTick xTick);
+UNQLITE_PRIVATE int unqlitePagerSetReadAhead(Pager *pPager,int nMaxPage);
+UNQLITE_PRIVATE void unqlitePagerReadAheadStats(Pager *pPager,unsigned int *pnRead,unsigned int *pnHit,unsigned int *pnWaste);
 UNQLITE_PRIVATE int unqlitePagerClose(Pager *pPager);
 UNQLITE_PRIVATE int unqlitePagerOpen(
   unqlite_vfs *pVfs,       /* The virtual file system to use */
@@ -3533,8 +3767,13 @@ UNQLITE_PRIVATE int unqlitePagerOpen(
   );
 UNQLITE_PRIVATE int unqlitePagerRegisterKvEngine(Pager *pPager,unqlite_kv_methods *pMethods);
 UNQLITE_PRIVATE unqlite_kv_engine * unqlitePagerGetKvEngine(unqlite *pDb);
+#if defined(UNQLITE_ENABLE_THREADS)
+UNQLITE_PRIVATE unqlite * unqlitePagerGetDb(unqlite_kv_engine *pEngine);
+#endif
 UNQLITE_PRIVATE int unqlitePagerBegin(Pager *pPager);
 UNQLITE_PRIVATE int unqlitePagerCommit(Pager *pPager);
+UNQLITE_PRIVATE int unqlitePagerGroupCommit(Pager *pPager);
+UNQLITE_PRIVATE int unqlitePagerGroupFlush(Pager *pPager,int bExpired);
 UNQLITE_PRIVATE int unqlitePagerRollback(Pager *pPager,int bResetKvEngine);
 UNQLITE_PRIVATE void unqlitePagerRandomString(Pager *pPager,char *zBuf,sxu32 nLen);
 UNQLITE_PRIVATE sxu32 unqlitePagerRandomNum(Pager *pPager);
@@ -3614,6 +3853,87 @@ static struct unqlGlobal_Data
 };
 #define UNQLITE_LIB_MAGIC  0xEA1495BA
 #define UNQLITE_LIB_MISUSE (sUnqlMPGlobal.nMagic != UNQLITE_LIB_MAGIC)
+#if defined(UNQLITE_ENABLE_THREADS)
+/*
+ * Mode the database handle mutex was entered in (See unqliteDbMutexEnter()).
+ */
+#define UNQLITE_DB_MUTEX_EXCLUSIVE 1
+#define UNQLITE_DB_MUTEX_SHARED    2
+/*
+ * Enter the database handle mutex.
+ * Shared mode is granted only when requested and supported by the mutex methods.
+ * An operation running in shared mode may not touch anything but the page cache: it
+ * fail with UNQLITE_LOCKED otherwise and the caller must retry it in exclusive mode.
+ * Return the mode the mutex was actually entered in.
+ */
+static int unqliteDbMutexEnter(unqlite *pDb,int bShared)
+{
+	if( pDb->pMutex == 0 ){
+		/* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
+		return UNQLITE_DB_MUTEX_EXCLUSIVE;
+	}
+#if defined(UNQLITE_SHARED_READ)
+	if( bShared && sUnqlMPGlobal.pMutexMethods->xEnterShared ){
+		if( sUnqlMPGlobal.pMutexMethods->xEnterShared(pDb->pMutex) ){
+			__atomic_add_fetch(&pDb->nReader,1,__ATOMIC_RELAXED);
+			return UNQLITE_DB_MUTEX_SHARED;
+		}
+		/* Nested call, the mutex is already held exclusively by this thread */
+		return UNQLITE_DB_MUTEX_EXCLUSIVE;
+	}
+#else
+	SXUNUSED(bShared);
+#endif
+	sUnqlMPGlobal.pMutexMethods->xEnter(pDb->pMutex);
+	return UNQLITE_DB_MUTEX_EXCLUSIVE;
+}
+/*
+ * Leave the database handle mutex entered by unqliteDbMutexEnter().
+ */
+static void unqliteDbMutexLeave(unqlite *pDb,int iMode)
+{
+	if( pDb->pMutex == 0 ){
+		return;
+	}
+#if defined(UNQLITE_SHARED_READ)
+	if( iMode == UNQLITE_DB_MUTEX_SHARED ){
+		__atomic_sub_fetch(&pDb->nReader,1,__ATOMIC_RELAXED);
+		sUnqlMPGlobal.pMutexMethods->xLeaveShared(pDb->pMutex);
+		return;
+	}
+#else
+	SXUNUSED(iMode);
+#endif
+	sUnqlMPGlobal.pMutexMethods->xLeave(pDb->pMutex);
+}
+/*
+ * Perform a read-only cursor operation with the handle mutex held in shared mode,
+ * then in exclusive mode if it could not be served from the page cache.
+ */
+#define UNQLITE_CURSOR_READ(CURSOR,RC,CALL){\
+	unqlite *pDb_ = unqlitePagerGetDb((CURSOR)->pStore);\
+	int iMode_ = unqliteDbMutexEnter(pDb_,1);\
+	RC = CALL;\
+	if( RC == UNQLITE_LOCKED && iMode_ == UNQLITE_DB_MUTEX_SHARED ){\
+		unqliteDbMutexLeave(pDb_,iMode_);\
+		iMode_ = unqliteDbMutexEnter(pDb_,0);\
+		RC = CALL;\
+	}\
+	unqliteDbMutexLeave(pDb_,iMode_);\
+}
+/*
+ * Perform a cursor operation with the handle mutex held in exclusive mode.
+ */
+#define UNQLITE_CURSOR_WRITE(CURSOR,CALL){\
+	unqlite *pDb_ = unqlitePagerGetDb((CURSOR)->pStore);\
+	int iMode_ = unqliteDbMutexEnter(pDb_,0);\
+	CALL;\
+	unqliteDbMutexLeave(pDb_,iMode_);\
+}
+#else
+#define UNQLITE_CURSOR_READ(CURSOR,RC,CALL) { RC = CALL; }
+#define UNQLITE_CURSOR_WRITE(CURSOR,CALL) { CALL; }
+#endif /* UNQLITE_ENABLE_THREADS */
 /*
  * Supported threading level.
  * These options have meaning only when the library is compiled with multi-threading
@@ -3898,6 +4218,8 @@ static sxi32 unqliteCoreInitialize(void)
 		if( sUnqlMPGlobal.iPageSize < UNQLITE_MIN_PAGE_SIZE ){
 			unqlite_lib_config(UNQLITE_LIB_CONFIG_PAGE_SIZE,UNQLITE_DEFAULT_PAGE_SIZE);
 		}
+		/* Sort the Jx9 foreign functions table shared by all the VMs */
+		unqliteInitJx9Functions();
 		/* Our library is initialized, set the magic number */
 		sUnqlMPGlobal.nMagic = UNQLITE_LIB_MAGIC;
 		rc = UNQLITE_OK;
@@ -3932,6 +4254,10 @@ static int unqliteDbRelease(unqlite *pDb)
 		/* Rollback any outstanding transaction */
 		rc = unqlitePagerRollback(pStore->pPager,FALSE);
 	}
+	/* The deferred collection headers of the active VM's were either written by
+	 * the commit or dropped by the rollback: the VM's are released below without
+	 * touching the pager.
+	 */
 	/* Close the pager */
 	unqlitePagerClose(pStore->pPager);
 	/* Release any active VM's */
@@ -4289,6 +4615,34 @@ static int unqliteConfigure(unqlite *pDb,int nOp,va_list ap)
 		pDb->iFlags |= UNQLITE_FL_DISABLE_AUTO_COMMIT;
 		break;
 											}
+	case UNQLITE_CONFIG_GROUP_COMMIT: {
+		/* Group commit window */
+		int nMaxCommit = va_arg(ap,int);
+		int nWindowMs = va_arg(ap,int);
+		ProcGroupTick xTick = va_arg(ap,ProcGroupTick);
+		rc = unqlitePagerSetGroupCommit(pDb->sDB.pPager,nMaxCommit,nWindowMs,xTick);
+		break;
+									  }
+	case UNQLITE_CONFIG_READ_AHEAD: {
+		/* Maximum read-ahead window */
+		int nMaxPage = va_arg(ap,int);
+		rc = unqlitePagerSetReadAhead(pDb->sDB.pPager,nMaxPage);
+		break;
+									}
+	case UNQLITE_CONFIG_READ_AHEAD_STATS: {
+		/* Read-ahead statistics */
+		unsigned int *pnRead = va_arg(ap,unsigned int *);
+		unsigned int *pnHit = va_arg(ap,unsigned int *);
+		unsigned int *pnWaste = va_arg(ap,unsigned int *);
+		unqlitePagerReadAheadStats(pDb->sDB.pPager,pnRead,pnHit,pnWaste);
+		break;
+										  }
+	case UNQLITE_CONFIG_GROUP_COMMIT_FLUSH: {
+		/* Flush the acknowledged group commits */
+		int bExpired = va_arg(ap,int);
+		rc = unqlitePagerGroupFlush(pDb->sDB.pPager,bExpired);
+		break;
+											}
 	case UNQLITE_CONFIG_GET_KV_NAME: {
 		/* Name of the underlying KV storage engine */
 		const char **pzPtr = va_arg(ap,const char **);
@@ -4351,8 +4705,9 @@ int unqlite_open(unqlite **ppDB,const char *zFilename,unsigned int iMode)
 	}
 #if defined(UNQLITE_ENABLE_THREADS)
 	if( !(iMode & UNQLITE_OPEN_NOMUTEX) && (sUnqlMPGlobal.nThreadingLevel > UNQLITE_THREAD_LEVEL_SINGLE) ){
-		 /* Associate a recursive mutex with this instance */
-		 pHandle->pMutex = SyMutexNew(sUnqlMPGlobal.pMutexMethods, SXMUTEX_TYPE_RECURSIVE);
+		 /* Associate a recursive mutex with this instance, a reader/writer one if supported */
+		 pHandle->pMutex = SyMutexNew(sUnqlMPGlobal.pMutexMethods,
+			 sUnqlMPGlobal.pMutexMethods->xEnterShared ? SXMUTEX_TYPE_RW : SXMUTEX_TYPE_RECURSIVE);
 		 if( pHandle->pMutex == 0 ){
 			 rc = UNQLITE_NOMEM;
 			 goto Release;
@@ -4573,11 +4928,15 @@ int unqlite_vm_exec(unqlite_vm *pVm)
 		 UNQLITE_THRD_VM_RELEASE(pVm) ){
 			 return UNQLITE_ABORT; /* Another thread have released this instance */
 	 }
+	 /* Collections are read and written directly, acquire the DB mutex in exclusive mode */
+	 SyMutexEnter(sUnqlMPGlobal.pMutexMethods, pVm->pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
 #endif
 	/* Execute the Jx9 bytecode program */
 	 rc = jx9VmByteCodeExec(pVm->pJx9Vm);
 #if defined(UNQLITE_ENABLE_THREADS)
 	 /* Leave DB mutex */
+	 SyMutexLeave(sUnqlMPGlobal.pMutexMethods, pVm->pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
+	 /* Leave VM mutex */
 	 SyMutexLeave(sUnqlMPGlobal.pMutexMethods,pVm->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
 #endif
 	return rc;
@@ -4599,6 +4958,14 @@ int unqlite_vm_release(unqlite_vm *pVm)
 		 UNQLITE_THRD_VM_RELEASE(pVm) ){
 			 return UNQLITE_ABORT; /* Another thread have released this instance */
 	 }
+	 /* Acquire DB mutex in exclusive mode */
+	 SyMutexEnter(sUnqlMPGlobal.pMutexMethods, pVm->pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
+#endif
+	/* Write the deferred collection headers */
+	 unqliteVmFlushCollections(pVm);
+#if defined(UNQLITE_ENABLE_THREADS)
+	 /* Leave DB mutex */
+	 SyMutexLeave(sUnqlMPGlobal.pMutexMethods, pVm->pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
 #endif
 	/* Release the VM */
 	 rc = unqliteVmRelease(pVm);
@@ -5627,62 +5994,169 @@ int unqlite_kv_append_fmt(unqlite *pDb,const void *pKey,int nKeyLen,const char *
 #endif
 	return rc;
 }
+#if defined(UNQLITE_SHARED_READ)
 /*
- * [CAPIREF: unqlite_kv_fetch()]
- * Please refer to the official documentation for function purpose and expected parameters.
+ * Lookup a record with the database handle mutex held in shared mode.
+ * A private cursor on the stack is used instead of the handle cursor so that
+ * concurrent readers do not step on each other.
+ * Return UNQLITE_LOCKED if the record cannot be served from the page cache, the
+ * lookup must then be retried with the mutex held exclusively.
  */
-int unqlite_kv_fetch(unqlite *pDb,const void *pKey,int nKeyLen,void *pBuf,unqlite_int64 *pBufLen)
+static int unqliteKvFetchShared(
+	unqlite_kv_engine *pEngine, /* Underlying storage engine */
+	const void *pKey,int nKeyLen, /* Lookup key */
+	int (*xConsumer)(const void *,unsigned int,void *),void *pUserData, /* Data consumer if any */
+	unqlite_int64 *pDataLen /* OUT: Data length if not NULL */
+	)
+{
+	unqlite_kv_methods *pMethods = pEngine->pIo->pMethods;
+	union{
+		unqlite_kv_cursor sCur;
+		void *apSpace[16];
+	}uCur;
+	int rc;
+	if( pMethods->szCursor < 1 || pMethods->szCursor > (int)sizeof(uCur) ){
+		/* Use the handle cursor instead */
+		return UNQLITE_LOCKED;
+	}
+	/* Zero the structure */
+	SyZero(&uCur,sizeof(uCur));
+	uCur.sCur.pStore = pEngine;
+	if( pMethods->xCursorInit ){
+		pMethods->xCursorInit(&uCur.sCur);
+	}
+	/* Seek to the record position */
+	rc = pMethods->xSeek(&uCur.sCur,pKey,nKeyLen,UNQLITE_CURSOR_MATCH_EXACT);
+	if( rc == UNQLITE_OK ){
+		if( pDataLen ){
+			/* Data length only */
+			rc = pMethods->xDataLength(&uCur.sCur,pDataLen);
+		}else if( xConsumer ){
+			/* Consume the data directly */
+			rc = pMethods->xData(&uCur.sCur,xConsumer,pUserData);
+		}
+	}
+	if( pMethods->xCursorRelease ){
+		pMethods->xCursorRelease(&uCur.sCur);
+	}
+	return rc;
+}
+#endif /* UNQLITE_SHARED_READ */
+/*
+ * Lookup a record with the database handle mutex held in exclusive mode.
+ */
+static int unqliteKvFetch(
+	unqlite *pDb, /* Database handle */
+	const void *pKey,int nKeyLen, /* Lookup key */
+	int (*xConsumer)(const void *,unsigned int,void *),void *pUserData, /* Data consumer if any */
+	unqlite_int64 *pDataLen /* OUT: Data length if not NULL */
+	)
 {
 	unqlite_kv_methods *pMethods;
 	unqlite_kv_engine *pEngine;
 	unqlite_kv_cursor *pCur;
 	int rc;
-	if( UNQLITE_DB_MISUSE(pDb) ){
-		return UNQLITE_CORRUPT;
+	/* Point to the underlying storage engine */
+	pEngine = unqlitePagerGetKvEngine(pDb);
+	pMethods = pEngine->pIo->pMethods;
+	pCur = pDb->sDB.pCursor;
+	if( !nKeyLen ){
+		unqliteGenError(pDb,"Empty key");
+		return UNQLITE_EMPTY;
 	}
+	/* Seek to the record position */
+	rc = pMethods->xSeek(pCur,pKey,nKeyLen,UNQLITE_CURSOR_MATCH_EXACT);
+	if( rc == UNQLITE_OK ){
+		if( pDataLen ){
+			/* Data length only */
+			rc = pMethods->xDataLength(pCur,pDataLen);
+		}else if( xConsumer ){
+			/* Consume the data directly */
+			rc = pMethods->xData(pCur,xConsumer,pUserData);
+		}
+	}
+	return rc;
+}
+/*
+ * Lookup a record, in shared mode first when the handle mutex support it.
+ */
+static int unqliteKvFetchLocked(
+	unqlite *pDb, /* Database handle */
+	const void *pKey,int nKeyLen, /* Lookup key */
+	int (*xConsumer)(const void *,unsigned int,void *),void *pUserData, /* Data consumer if any */
+	unqlite_int64 *pDataLen /* OUT: Data length if not NULL */
+	)
+{
+	int rc;
 #if defined(UNQLITE_ENABLE_THREADS)
-	 /* Acquire DB mutex */
-	 SyMutexEnter(sUnqlMPGlobal.pMutexMethods, pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
+	int iMode;
+	 /* Acquire DB mutex, in shared mode if supported */
+	 iMode = unqliteDbMutexEnter(pDb,1);
 	 if( sUnqlMPGlobal.nThreadingLevel > UNQLITE_THREAD_LEVEL_SINGLE && 
 		 UNQLITE_THRD_DB_RELEASE(pDb) ){
+			 unqliteDbMutexLeave(pDb,iMode);
 			 return UNQLITE_ABORT; /* Another thread have released this instance */
 	 }
-#endif
-	 /* Point to the underlying storage engine */
-	 pEngine = unqlitePagerGetKvEngine(pDb);
-	 pMethods = pEngine->pIo->pMethods;
-	 pCur = pDb->sDB.pCursor;
-	 if( nKeyLen < 0 ){
-		 /* Assume a null terminated string and compute it's length */
-		 nKeyLen = SyStrlen((const char *)pKey);
-	 }
-	 if( !nKeyLen ){
-		  unqliteGenError(pDb,"Empty key");
-		  rc = UNQLITE_EMPTY;
-	 }else{
-		  /* Seek to the record position */
-		  rc = pMethods->xSeek(pCur,pKey,nKeyLen,UNQLITE_CURSOR_MATCH_EXACT);
-	 }
-	 if( rc == UNQLITE_OK ){
-		 if( pBuf == 0 ){
-			 /* Data length only */
-			 rc = pMethods->xDataLength(pCur,pBufLen);
-		 }else{
-			 SyBlob sBlob;
-			 /* Initialize the data consumer */
-			 SyBlobInitFromBuf(&sBlob,pBuf,(sxu32)*pBufLen);
-			 /* Consume the data */
-			 rc = pMethods->xData(pCur,unqliteDataConsumer,&sBlob);
-			 /* Data length */
-			 *pBufLen = (unqlite_int64)SyBlobLength(&sBlob);
-			 /* Cleanup */
-			 SyBlobRelease(&sBlob);
+#if defined(UNQLITE_SHARED_READ)
+	 if( iMode == UNQLITE_DB_MUTEX_SHARED ){
+		 rc = UNQLITE_LOCKED;
+		 if( nKeyLen > 0 ){
+			 /* Serve the record from the page cache without blocking the other readers.
+			  * The data consumer run with the mutex held in shared mode and must not
+			  * modify the database.
+			  */
+			 rc = unqliteKvFetchShared(unqlitePagerGetKvEngine(pDb),pKey,nKeyLen,xConsumer,pUserData,pDataLen);
+		 }
+		 unqliteDbMutexLeave(pDb,iMode);
+		 if( rc != UNQLITE_LOCKED ){
+			 return rc;
+		 }
+		 /* Empty key or page cache miss, retry with the mutex held exclusively */
+		 iMode = unqliteDbMutexEnter(pDb,0);
+		 if( UNQLITE_THRD_DB_RELEASE(pDb) ){
+			 unqliteDbMutexLeave(pDb,iMode);
+			 return UNQLITE_ABORT; /* Another thread have released this instance */
 		 }
 	 }
+#endif /* UNQLITE_SHARED_READ */
+#endif /* UNQLITE_ENABLE_THREADS */
+	 rc = unqliteKvFetch(pDb,pKey,nKeyLen,xConsumer,pUserData,pDataLen);
 #if defined(UNQLITE_ENABLE_THREADS)
 	 /* Leave DB mutex */
-	 SyMutexLeave(sUnqlMPGlobal.pMutexMethods,pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
+	 unqliteDbMutexLeave(pDb,iMode);
 #endif
+	 return rc;
+}
+/*
+ * [CAPIREF: unqlite_kv_fetch()]
+ * Please refer to the official documentation for function purpose and expected parameters.
+ */
+int unqlite_kv_fetch(unqlite *pDb,const void *pKey,int nKeyLen,void *pBuf,unqlite_int64 *pBufLen)
+{
+	int rc;
+	if( UNQLITE_DB_MISUSE(pDb) ){
+		return UNQLITE_CORRUPT;
+	}
+	if( nKeyLen < 0 ){
+		/* Assume a null terminated string and compute it's length */
+		nKeyLen = SyStrlen((const char *)pKey);
+	}
+	if( pBuf == 0 ){
+		/* Data length only */
+		rc = unqliteKvFetchLocked(pDb,pKey,nKeyLen,0,0,pBufLen);
+	}else{
+		SyBlob sBlob;
+		/* Initialize the data consumer */
+		SyBlobInitFromBuf(&sBlob,pBuf,(sxu32)*pBufLen);
+		/* Consume the data */
+		rc = unqliteKvFetchLocked(pDb,pKey,nKeyLen,unqliteDataConsumer,&sBlob,0);
+		if( rc == UNQLITE_OK || SyBlobLength(&sBlob) > 0 ){
+			/* Data length */
+			*pBufLen = (unqlite_int64)SyBlobLength(&sBlob);
+		}
+		/* Cleanup */
+		SyBlobRelease(&sBlob);
+	}
 	return rc;
 }
 /*
@@ -5691,44 +6165,15 @@ int unqlite_kv_fetch(unqlite *pDb,const void *pKey,int nKeyLen,void *pBuf,unqlit
  */
 int unqlite_kv_fetch_callback(unqlite *pDb,const void *pKey,int nKeyLen,int (*xConsumer)(const void *,unsigned int,void *),void *pUserData)
 {
-	unqlite_kv_methods *pMethods;
-	unqlite_kv_engine *pEngine;
-	unqlite_kv_cursor *pCur;
 	int rc;
 	if( UNQLITE_DB_MISUSE(pDb) ){
 		return UNQLITE_CORRUPT;
 	}
-#if defined(UNQLITE_ENABLE_THREADS)
-	 /* Acquire DB mutex */
-	 SyMutexEnter(sUnqlMPGlobal.pMutexMethods, pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
-	 if( sUnqlMPGlobal.nThreadingLevel > UNQLITE_THREAD_LEVEL_SINGLE && 
-		 UNQLITE_THRD_DB_RELEASE(pDb) ){
-			 return UNQLITE_ABORT; /* Another thread have released this instance */
-	 }
-#endif
-	 /* Point to the underlying storage engine */
-	 pEngine = unqlitePagerGetKvEngine(pDb);
-	 pMethods = pEngine->pIo->pMethods;
-	 pCur = pDb->sDB.pCursor;
-	 if( nKeyLen < 0 ){
-		 /* Assume a null terminated string and compute it's length */
-		 nKeyLen = SyStrlen((const char *)pKey);
-	 }
-	 if( !nKeyLen ){
-		 unqliteGenError(pDb,"Empty key");
-		 rc = UNQLITE_EMPTY;
-	 }else{
-		 /* Seek to the record position */
-		 rc = pMethods->xSeek(pCur,pKey,nKeyLen,UNQLITE_CURSOR_MATCH_EXACT);
-	 }
-	 if( rc == UNQLITE_OK && xConsumer ){
-		 /* Consume the data directly */
-		 rc = pMethods->xData(pCur,xConsumer,pUserData);	 
-	 }
-#if defined(UNQLITE_ENABLE_THREADS)
-	 /* Leave DB mutex */
-	 SyMutexLeave(sUnqlMPGlobal.pMutexMethods,pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
-#endif
+	if( nKeyLen < 0 ){
+		/* Assume a null terminated string and compute it's length */
+		nKeyLen = SyStrlen((const char *)pKey);
+	}
+	rc = unqliteKvFetchLocked(pDb,pKey,nKeyLen,xConsumer,pUserData,0);
 	return rc;
 }
 /*
@@ -5890,7 +6335,7 @@ int unqlite_kv_cursor_first_entry(unqlite_kv_cursor *pCursor)
 		rc = UNQLITE_NOTIMPLEMENTED;
 	}else{
 		/* Seek to the first entry */
-		rc = pCursor->pStore->pIo->pMethods->xFirst(pCursor);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xFirst(pCursor));
 	}
 	return rc;
 }
@@ -5911,7 +6356,7 @@ int unqlite_kv_cursor_last_entry(unqlite_kv_cursor *pCursor)
 		rc = UNQLITE_NOTIMPLEMENTED;
 	}else{
 		/* Seek to the last entry */
-		rc = pCursor->pStore->pIo->pMethods->xLast(pCursor);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xLast(pCursor));
 	}
 	return rc;
 }
@@ -5952,7 +6397,7 @@ int unqlite_kv_cursor_next_entry(unqlite_kv_cursor *pCursor)
 		rc = UNQLITE_NOTIMPLEMENTED;
 	}else{
 		/* Seek to the next entry */
-		rc = pCursor->pStore->pIo->pMethods->xNext(pCursor);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xNext(pCursor));
 	}
 	return rc;
 }
@@ -5973,7 +6418,7 @@ int unqlite_kv_cursor_prev_entry(unqlite_kv_cursor *pCursor)
 		rc = UNQLITE_NOTIMPLEMENTED;
 	}else{
 		/* Seek to the previous entry */
-		rc = pCursor->pStore->pIo->pMethods->xPrev(pCursor);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xPrev(pCursor));
 	}
 	return rc;
 }
@@ -5994,7 +6439,7 @@ int unqlite_kv_cursor_delete_entry(unqlite_kv_cursor *pCursor)
 		rc = UNQLITE_NOTIMPLEMENTED;
 	}else{
 		/* Delete the entry */
-		rc = pCursor->pStore->pIo->pMethods->xDelete(pCursor);
+		UNQLITE_CURSOR_WRITE(pCursor,rc = pCursor->pStore->pIo->pMethods->xDelete(pCursor));
 	}
 	return rc;
 }
@@ -6015,7 +6460,7 @@ int unqlite_kv_cursor_reset(unqlite_kv_cursor *pCursor)
 		rc = UNQLITE_NOTIMPLEMENTED;
 	}else{
 		/* Reset */
-		pCursor->pStore->pIo->pMethods->xReset(pCursor);
+		UNQLITE_CURSOR_WRITE(pCursor,pCursor->pStore->pIo->pMethods->xReset(pCursor));
 	}
 	return rc;
 }
@@ -6039,7 +6484,7 @@ int unqlite_kv_cursor_seek(unqlite_kv_cursor *pCursor,const void *pKey,int nKeyL
 		rc = UNQLITE_EMPTY;
 	}else{
 		/* Seek to the desired location */
-		rc = pCursor->pStore->pIo->pMethods->xSeek(pCursor,pKey,nKeyLen,iPos);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xSeek(pCursor,pKey,nKeyLen,iPos));
 	}
 	return rc;
 }
@@ -6071,7 +6516,7 @@ int unqlite_kv_cursor_key_callback(unqlite_kv_cursor *pCursor,int (*xConsumer)(c
 	}
 #endif
 	/* Consume the key directly */
-	rc = pCursor->pStore->pIo->pMethods->xKey(pCursor,xConsumer,pUserData);
+	UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xKey(pCursor,xConsumer,pUserData));
 	return rc;
 }
 /*
@@ -6088,7 +6533,7 @@ int unqlite_kv_cursor_key(unqlite_kv_cursor *pCursor,void *pBuf,int *pnByte)
 #endif
 	if( pBuf == 0 ){
 		/* Key length only */
-		rc = pCursor->pStore->pIo->pMethods->xKeyLength(pCursor,pnByte);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xKeyLength(pCursor,pnByte));
 	}else{
 		SyBlob sBlob;
 		if( (*pnByte) < 0 ){
@@ -6097,7 +6542,7 @@ int unqlite_kv_cursor_key(unqlite_kv_cursor *pCursor,void *pBuf,int *pnByte)
 		/* Initialize the data consumer */
 		SyBlobInitFromBuf(&sBlob,pBuf,(sxu32)(*pnByte));
 		/* Consume the key */
-		rc = pCursor->pStore->pIo->pMethods->xKey(pCursor,unqliteDataConsumer,&sBlob);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xKey(pCursor,unqliteDataConsumer,&sBlob));
 		 /* Key length */
 		*pnByte = SyBlobLength(&sBlob);
 		/* Cleanup */
@@ -6118,7 +6563,7 @@ int unqlite_kv_cursor_data_callback(unqlite_kv_cursor *pCursor,int (*xConsumer)(
 	}
 #endif
 	/* Consume the data directly */
-	rc = pCursor->pStore->pIo->pMethods->xData(pCursor,xConsumer,pUserData);
+	UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xData(pCursor,xConsumer,pUserData));
 	return rc;
 }
 /*
@@ -6135,7 +6580,7 @@ int unqlite_kv_cursor_data(unqlite_kv_cursor *pCursor,void *pBuf,unqlite_int64 *
 #endif
 	if( pBuf == 0 ){
 		/* Data length only */
-		rc = pCursor->pStore->pIo->pMethods->xDataLength(pCursor,pnByte);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xDataLength(pCursor,pnByte));
 	}else{
 		SyBlob sBlob;
 		if( (*pnByte) < 0 ){
@@ -6144,7 +6589,7 @@ int unqlite_kv_cursor_data(unqlite_kv_cursor *pCursor,void *pBuf,unqlite_int64 *
 		/* Initialize the data consumer */
 		SyBlobInitFromBuf(&sBlob,pBuf,(sxu32)(*pnByte));
 		/* Consume the data */
-		rc = pCursor->pStore->pIo->pMethods->xData(pCursor,unqliteDataConsumer,&sBlob);
+		UNQLITE_CURSOR_READ(pCursor,rc,pCursor->pStore->pIo->pMethods->xData(pCursor,unqliteDataConsumer,&sBlob));
 		/* Data length */
 		*pnByte = SyBlobLength(&sBlob);
 		/* Cleanup */
@@ -6197,7 +6642,7 @@ int unqlite_commit(unqlite *pDb)
 	 }
 #endif
 	 /* Commit the transaction */
-	 rc = unqlitePagerCommit(pDb->sDB.pPager);
+	 rc = unqlitePagerGroupCommit(pDb->sDB.pPager);
 #if defined(UNQLITE_ENABLE_THREADS)
 	 /* Leave DB mutex */
 	 SyMutexLeave(sUnqlMPGlobal.pMutexMethods,pDb->pMutex); /* NO-OP if sUnqlMPGlobal.nThreadingLevel != UNQLITE_THREAD_LEVEL_MULTI */
@@ -6959,6 +7404,204 @@ UNQLITE_PRIVATE sxi32 FastJsonDecode(
 	}
 	return rc;
 }
+/*
+ * Jump over a FastJSON value without decoding it.
+ * Strings and reals are skipped using their length prefix, arrays and
+ * documents token by token. Nothing is allocated.
+ */
+UNQLITE_PRIVATE sxi32 FastJsonSkip(
+	const unsigned char *zIn,    /* Binary JSON */
+	const unsigned char *zEnd,   /* End of input */
+	const unsigned char **pzPtr, /* OUT: Past the value */
+	int iNest /* Nesting limit */
+	)
+{
+	sxi32 rc = SXRET_OK;
+	sxu32 iLength;
+	sxu16 iLen;
+	int c;
+	if( iNest >= UNQLITE_FAST_JSON_NEST_LIMIT ){
+		/* Nesting limit reached */
+		return SXERR_LIMIT;
+	}
+	if( zIn >= zEnd ){
+		return SXERR_CORRUPT;
+	}
+	c = zIn[0];
+	/* Advance the stream cursor */
+	zIn++;
+	switch(c){
+	case FJSON_NULL:
+	case FJSON_FALSE:
+	case FJSON_TRUE:
+		break;
+	case FJSON_INT64:
+		if( &zIn[8] > zEnd ){
+			/* Corrupt chunk */
+			rc = SXERR_CORRUPT;
+			break;
+		}
+		zIn += 8;
+		break;
+	case FJSON_REAL:
+		if( &zIn[2] > zEnd ){
+			/* Corrupt chunk */
+			rc = SXERR_CORRUPT;
+			break;
+		}
+		SyBigEndianUnpack16(zIn,&iLen);
+		zIn += 2;
+		if( (sxu32)iLen > (sxu32)(zEnd - zIn) ){
+			/* Corrupt chunk */
+			rc = SXERR_CORRUPT;
+			break;
+		}
+		zIn += iLen;
+		break;
+	case FJSON_STRING:
+		if( &zIn[4] > zEnd ){
+			/* Corrupt chunk */
+			rc = SXERR_CORRUPT;
+			break;
+		}
+		SyBigEndianUnpack32(zIn,&iLength);
+		zIn += 4;
+		if( iLength > (sxu32)(zEnd - zIn) ){
+			/* Corrupt chunk */
+			rc = SXERR_CORRUPT;
+			break;
+		}
+		zIn += iLength;
+		break;
+	case FJSON_ARRAY_START:
+	case FJSON_DOC_START: {
+		int iClose = (c == FJSON_DOC_START) ? FJSON_DOC_END : FJSON_ARRAY_END;
+		for(;;){
+			/* Jump the binary commas and colons */
+			while( zIn < zEnd && (zIn[0] == FJSON_COMMA || zIn[0] == FJSON_COLON) ){
+				zIn++;
+			}
+			if( zIn >= zEnd || zIn[0] == iClose ){
+				if( zIn < zEnd ){
+					zIn++; /* Jump the trailing binary ] or } */
+				}
+				break;
+			}
+			/* Skip the key or the value */
+			rc = FastJsonSkip(zIn,zEnd,&zIn,iNest+1);
+			if( rc != SXRET_OK ){
+				break;
+			}
+		}
+		break;
+						  }
+	default:
+		/* Corrupt data */
+		rc = SXERR_CORRUPT;
+		break;
+	}
+	*pzPtr = zIn;
+	return rc;
+}
+/*
+ * Check whether a key is part of a list of fields (SyString entries).
+ */
+UNQLITE_PRIVATE int FastJsonFieldLookup(SySet *pFields,const char *zKey,sxu32 nByte)
+{
+	SyString *aField = (SyString *)SySetBasePtr(pFields);
+	sxu32 n;
+	for( n = 0 ; n < SySetUsed(pFields) ; ++n ){
+		if( aField[n].nByte == nByte && SyMemcmp(aField[n].zString,zKey,nByte) == 0 ){
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+/*
+ * Decode only the given top level fields of a FastJSON document.
+ * The other fields are jumped over without being decoded (See FastJsonSkip()) and
+ * the scan stops as soon as all the requested fields are found.
+ * Anything but a document is decoded as a whole.
+ */
+UNQLITE_PRIVATE sxi32 FastJsonDecodeFields(
+	const void *pIn, /* Binary JSON  */
+	sxu32 nByte,     /* Chunk delimiter */
+	jx9_value *pOut, /* Decoded value */
+	SySet *pFields   /* Fields to extract (SyString) */
+	)
+{
+	const unsigned char *zIn = (const unsigned char *)pIn;
+	const unsigned char *zEnd = &zIn[nByte];
+	jx9_value sVal,sKey;
+	jx9_hashmap *pMap;
+	const char *zKey;
+	sxu32 nFound;
+	int nKey;
+	sxi32 rc;
+	if( nByte < 1 || zIn[0] != FJSON_DOC_START ){
+		return FastJsonDecode(pIn,nByte,pOut,0,0);
+	}
+	/* Jump the binary { */
+	zIn++;
+	/* Allocate a new hashmap */
+	pMap = (jx9_hashmap *)jx9NewHashmap(pOut->pVm,0,0);
+	if( pMap == 0 ){
+		return SXERR_MEM;
+	}
+	pMap->iFlags |= HASHMAP_JSON_OBJECT;
+	jx9MemObjInit(pOut->pVm,&sVal);
+	jx9MemObjInit(pOut->pVm,&sKey);
+	jx9MemObjRelease(pOut);
+	MemObjSetType(pOut,MEMOBJ_HASHMAP);
+	pOut->x.pOther = pMap;
+	rc = SXRET_OK;
+	nFound = 0;
+	while( nFound < SySetUsed(pFields) ){
+		/* Jump leading binary commas */
+		while (zIn < zEnd && zIn[0] == FJSON_COMMA ){
+			zIn++;
+		}
+		if( zIn >= zEnd || zIn[0] == FJSON_DOC_END ){
+			break;
+		}
+		/* Extract the key */
+		rc = FastJsonDecode((const void *)zIn,(sxu32)(zEnd-zIn),&sKey,&zIn,1);
+		if( rc != UNQLITE_OK ){
+			break;
+		}
+		if( zIn >= zEnd || zIn[0] != FJSON_COLON ){
+			rc = UNQLITE_CORRUPT;
+			break;
+		}
+		zIn++; /* Jump the binary colon ':' */
+		zKey = jx9_value_to_string(&sKey,&nKey);
+		if( !FastJsonFieldLookup(pFields,zKey,(sxu32)nKey) ){
+			/* Not requested, jump over the value */
+			rc = FastJsonSkip(zIn,zEnd,&zIn,1);
+			if( rc != SXRET_OK ){
+				break;
+			}
+			continue;
+		}
+		/* Decode the value */
+		rc = FastJsonDecode((const void *)zIn,(sxu32)(zEnd-zIn),&sVal,&zIn,1);
+		if( rc != SXRET_OK ){
+			break;
+		}
+		/* Insert the key and its associated value */
+		rc = jx9HashmapInsert(pMap,&sKey,&sVal);
+		if( rc != UNQLITE_OK ){
+			break;
+		}
+		nFound++;
+	}
+	if( rc != SXRET_OK ){
+		jx9MemObjRelease(pOut);
+	}
+	jx9MemObjRelease(&sVal);
+	jx9MemObjRelease(&sKey);
+	return rc;
+}
 /*
  * ----------------------------------------------------------
  * File: jx9_api.c
@@ -7289,6 +7932,8 @@ static sxi32 Jx9CoreInitialize(void)
 			}
 		}
 #endif
+		/* Build the built-in function and constant tables shared by all the VMs */
+		jx9VmInitBuiltin();
 		/* Our library is initialized, set the magic number */
 		sJx9MPGlobal.nMagic = JX9_LIB_MAGIC;
 		rc = JX9_OK;
@@ -7763,40 +8408,9 @@ JX9_PRIVATE int jx9_vm_release(jx9_vm *pVm)
 	return rc;
 }
 /*
- * [CAPIREF: jx9_create_function()]
- * Please refer to the official documentation for function purpose and expected parameters.
+ * Note that built-in functions live in the shared built-in tables and
+ * cannot be deleted, only overridden by a function with the same name.
  */
-JX9_PRIVATE int jx9_create_function(jx9_vm *pVm, const char *zName, int (*xFunc)(jx9_context *, int, jx9_value **), void *pUserData)
-{
-	SyString sName;
-	int rc;
-	/* Ticket 1433-002: NULL VM is harmless operation */
-	if ( JX9_VM_MISUSE(pVm) ){
-		return JX9_CORRUPT;
-	}
-	SyStringInitFromBuf(&sName, zName, SyStrlen(zName));
-	/* Remove leading and trailing white spaces */
-	SyStringFullTrim(&sName);
-	/* Ticket 1433-003: NULL values are not allowed */
-	if( sName.nByte < 1 || xFunc == 0 ){
-		return JX9_CORRUPT;
-	}
-#if defined(JX9_ENABLE_THREADS)
-	 /* Acquire VM mutex */
-	 SyMutexEnter(sJx9MPGlobal.pMutexMethods, pVm->pMutex); /* NO-OP if sJx9MPGlobal.nThreadingLevel != JX9_THREAD_LEVEL_MULTI */
-	 if( sJx9MPGlobal.nThreadingLevel > JX9_THREAD_LEVEL_SINGLE && 
-		 JX9_THRD_VM_RELEASE(pVm) ){
-			 return JX9_ABORT; /* Another thread have released this instance */
-	 }
-#endif
-	/* Install the foreign function */
-	rc = jx9VmInstallForeignFunction(&(*pVm), &sName, xFunc, pUserData); 
-#if defined(JX9_ENABLE_THREADS)
-	 /* Leave VM mutex */
-	 SyMutexLeave(sJx9MPGlobal.pMutexMethods, pVm->pMutex); /* NO-OP if sJx9MPGlobal.nThreadingLevel != JX9_THREAD_LEVEL_MULTI */
-#endif
-	return rc;
-}
 JX9_PRIVATE int jx9DeleteFunction(jx9_vm *pVm,const char *zName)
 {
 	jx9_user_func *pFunc = 0; /* cc warning */
@@ -7811,45 +8425,6 @@ JX9_PRIVATE int jx9DeleteFunction(jx9_vm *pVm,const char *zName)
 	}
 	return rc;
 }
-/*
- * [CAPIREF: jx9_create_constant()]
- * Please refer to the official documentation for function purpose and expected parameters.
- */
-JX9_PRIVATE int jx9_create_constant(jx9_vm *pVm, const char *zName, void (*xExpand)(jx9_value *, void *), void *pUserData)
-{
-	SyString sName;
-	int rc;
-	/* Ticket 1433-002: NULL VM is harmless operation */
-	if ( JX9_VM_MISUSE(pVm) ){
-		return JX9_CORRUPT;
-	}
-	SyStringInitFromBuf(&sName, zName, SyStrlen(zName));
-	/* Remove leading and trailing white spaces */
-	SyStringFullTrim(&sName);
-	if( sName.nByte < 1 ){
-		/* Empty constant name */
-		return JX9_CORRUPT;
-	}
-	/* TICKET 1433-003: NULL pointer is harmless operation */
-	if( xExpand == 0 ){
-		return JX9_CORRUPT;
-	}
-#if defined(JX9_ENABLE_THREADS)
-	 /* Acquire VM mutex */
-	 SyMutexEnter(sJx9MPGlobal.pMutexMethods, pVm->pMutex); /* NO-OP if sJx9MPGlobal.nThreadingLevel != JX9_THREAD_LEVEL_MULTI */
-	 if( sJx9MPGlobal.nThreadingLevel > JX9_THREAD_LEVEL_SINGLE && 
-		 JX9_THRD_VM_RELEASE(pVm) ){
-			 return JX9_ABORT; /* Another thread have released this instance */
-	 }
-#endif
-	/* Perform the registration */
-	rc = jx9VmRegisterConstant(&(*pVm), &sName, xExpand, pUserData);
-#if defined(JX9_ENABLE_THREADS)
-	 /* Leave VM mutex */
-	 SyMutexLeave(sJx9MPGlobal.pMutexMethods, pVm->pMutex); /* NO-OP if sJx9MPGlobal.nThreadingLevel != JX9_THREAD_LEVEL_MULTI */
-#endif
-	 return rc;
-}
 JX9_PRIVATE int Jx9DeleteConstant(jx9_vm *pVm,const char *zName)
 {
 	jx9_constant *pCons;
@@ -16999,20 +17574,17 @@ static const jx9_builtin_func aBuiltInFunc[] = {
 	{ "rawurldecode", jx9Builtin_urldecode }, 
 #endif /* JX9_DISABLE_BUILTIN_FUNC */
 };
+static sxu16 aBuiltInFuncIdx[SX_ARRAYSIZE(aBuiltInFunc)];
+static const jx9_builtin_table sBuiltInFuncTable = {
+	aBuiltInFunc, SX_ARRAYSIZE(aBuiltInFunc), sizeof(jx9_builtin_func), JX9_BUILTIN_DATA_NONE, aBuiltInFuncIdx
+};
 /*
- * Register the built-in functions defined above, the array functions 
- * defined in hashmap.c and the IO functions defined in vfs.c.
+ * Export the built-in functions defined above.
+ * The array functions are defined in hashmap.c and the IO functions in vfs.c.
  */
-JX9_PRIVATE void jx9RegisterBuiltInFunction(jx9_vm *pVm)
+JX9_PRIVATE const jx9_builtin_table * jx9ExportBuiltinFunction(void)
 {
-	sxu32 n;
-	for( n = 0 ; n < SX_ARRAYSIZE(aBuiltInFunc) ; ++n ){
-		jx9_create_function(&(*pVm), aBuiltInFunc[n].zName, aBuiltInFunc[n].xFunc, 0);
-	}
-	/* Register hashmap functions [i.e: sort(), count(), array_diff(), ...] */
-	jx9RegisterHashmapFunctions(&(*pVm));
-	/* Register IO functions [i.e: fread(), fwrite(), chdir(), mkdir(), file(), ...] */
-	jx9RegisterIORoutine(&(*pVm));
+	return &sBuiltInFuncTable;
 }
 
 /*
@@ -22129,19 +22701,20 @@ static const jx9_builtin_constant aBuiltIn[] = {
 	{"EXTR_IF_EXISTS",       JX9_EXTR_IF_EXISTS_Const   }, 
 	{"EXTR_PREFIX_IF_EXISTS", JX9_EXTR_PREFIX_IF_EXISTS_Const}
 };
+/* 
+ * Note that all built-in constants have access to the jx9 virtual machine
+ * that trigger the constant invocation as their private data.
+ */
+static sxu16 aBuiltInIdx[SX_ARRAYSIZE(aBuiltIn)];
+static const jx9_builtin_table sBuiltInTable = {
+	aBuiltIn, SX_ARRAYSIZE(aBuiltIn), sizeof(jx9_builtin_constant), JX9_BUILTIN_DATA_VM, aBuiltInIdx
+};
 /*
- * Register the built-in constants defined above.
+ * Export the built-in constants defined above.
  */
-JX9_PRIVATE void jx9RegisterBuiltInConstant(jx9_vm *pVm)
+JX9_PRIVATE const jx9_builtin_table * jx9ExportBuiltinConstant(void)
 {
-	sxu32 n;
-	/* 
-	 * Note that all built-in constants have access to the jx9 virtual machine
-	 * that trigger the constant invocation as their private data.
-	 */
-	for( n = 0 ; n < SX_ARRAYSIZE(aBuiltIn) ; ++n ){
-		jx9_create_constant(&(*pVm), aBuiltIn[n].zName, aBuiltIn[n].xExpand, &(*pVm));
-	}
+	return &sBuiltInTable;
 }
 /*
  * ----------------------------------------------------------
@@ -22169,6 +22742,18 @@ JX9_PRIVATE void jx9RegisterBuiltInConstant(jx9_vm *pVm)
 /* Allowed node types */
 #define HASHMAP_INT_NODE   1  /* Node with an int [i.e: 64-bit integer] key */
 #define HASHMAP_BLOB_NODE  2  /* Node with a string/BLOB key */
+/*
+ * A freshly created hashmap is a packed list: as long as the keys are 0..n-1 in insertion
+ * order [i.e: JSON arrays, db_fetch_all() results], the entries are stored as a plain array
+ * of value indexes rather than one node each, with no hash bucket.
+ * The node based interfaces are served by a view node filled with the entry being accessed.
+ * Point lookups share a single node per hashmap [i.e: pMap->pView] which is only valid until
+ * the next access to the same hashmap. Linear traversals [see HashmapFirstNode()] bring their
+ * own view node so that the callbacks or recursion they run may access the same hashmap.
+ * The first non sequential key turns the list into a regular hashmap [see HashmapUnpack()].
+ */
+static sxi32 HashmapUnpack(jx9_hashmap *pMap);
+static sxi32 HashmapLookupIntKey(jx9_hashmap *pMap, sxi64 iKey, jx9_hashmap_node **ppNode);
 /*
  * Default hash function for int [i.e; 64-bit integer] keys.
  */
@@ -22193,6 +22778,54 @@ static sxu32 BinHash(const void *pSrc, sxu32 nLen)
 	}	
 	return nH;
 }
+/*
+ * Point the given view node to the packed list entry with the given key.
+ * NULL is returned if there is no such entry.
+ */
+static jx9_hashmap_node * HashmapPackedNode(jx9_hashmap *pMap, sxi64 iKey, jx9_hashmap_node *pView)
+{
+	if( iKey < 0 || iKey >= (sxi64)pMap->nEntry ){
+		return 0;
+	}
+	pView->pMap = pMap;
+	pView->iType = HASHMAP_INT_NODE;
+	pView->xKey.iKey = iKey;
+	pView->nValIdx = pMap->aSlot[iKey];
+	return pView;
+}
+/*
+ * Return the first inserted entry of a given hashmap, NULL if empty.
+ * pView is the caller's view node, it holds the traversal position in a packed list.
+ */
+static jx9_hashmap_node * HashmapFirstNode(jx9_hashmap *pMap, jx9_hashmap_node *pView)
+{
+	if( pMap->iFlags & HASHMAP_PACKED ){
+		return HashmapPackedNode(&(*pMap), 0, pView);
+	}
+	return pMap->pFirst;
+}
+/*
+ * Return the entry inserted after the given one [i.e: linear traversal], NULL if none.
+ * pView is the view node given to HashmapFirstNode().
+ */
+static jx9_hashmap_node * HashmapNextNode(jx9_hashmap_node *pEntry, jx9_hashmap_node *pView)
+{
+	jx9_hashmap *pMap = pEntry->pMap;
+	if( pEntry == pView ){
+		jx9_hashmap_node *pNode;
+		if( pMap->iFlags & HASHMAP_PACKED ){
+			return HashmapPackedNode(&(*pMap), pEntry->xKey.iKey + 1, pView);
+		}
+		/* Turned into a regular hashmap since the last step [i.e: by a callback],
+		 * continue after the real node.
+		 */
+		if( SXRET_OK != HashmapLookupIntKey(&(*pMap), pEntry->xKey.iKey, &pNode) ){
+			return 0;
+		}
+		return pNode->pPrev; /* Reverse link */
+	}
+	return pEntry->pPrev; /* Reverse link */
+}
 /*
  * Return the total number of entries in a given hashmap.
  * If bRecurisve is set to TRUE then recurse on hashmap entries.
@@ -22205,7 +22838,8 @@ static sxi64 HashmapCount(jx9_hashmap *pMap, int bRecursive, int iRecCount)
 		iCount = pMap->nEntry;
 	}else{
 		/* Recursive hashmap walk */
-		jx9_hashmap_node *pEntry = pMap->pLast;
+		jx9_hashmap_node sView;
+		jx9_hashmap_node *pEntry = HashmapFirstNode(&(*pMap), &sView);
 		jx9_value *pElem;
 		sxu32 n = 0;
 		for(;;){
@@ -22227,7 +22861,7 @@ static sxi64 HashmapCount(jx9_hashmap *pMap, int bRecursive, int iRecCount)
 				}
 			}
 			/* Point to the next entry */
-			pEntry = pEntry->pNext;
+			pEntry = HashmapNextNode(pEntry, &sView);
 			++n;
 		}
 		/* Update count */
@@ -22311,6 +22945,13 @@ static void jx9HashmapUnlinkNode(jx9_hashmap_node *pNode)
 {
 	jx9_hashmap *pMap = pNode->pMap;
 	jx9_vm *pVm = pMap->pVm;
+	if( pNode == pMap->pView ){
+		/* Packed list entry, switch to the real node */
+		sxi64 iKey = pNode->xKey.iKey;
+		if( HashmapUnpack(&(*pMap)) != SXRET_OK || HashmapLookupIntKey(&(*pMap), iKey, &pNode) != SXRET_OK ){
+			return;
+		}
+	}
 	/* Unlink from the corresponding bucket */
 	if( pNode->pPrevCollide == 0 ){
 		pMap->apBucket[pNode->nHash & (pMap->nSize - 1)] = pNode->pNextCollide;
@@ -22402,6 +23043,83 @@ static sxi32 HashmapGrowBucket(jx9_hashmap *pMap)
 	}
 	return SXRET_OK;
 }
+/*
+ * Append a value [i.e: the jx9_value at index nValIdx] to a packed list.
+ */
+static sxi32 HashmapPackedAppend(jx9_hashmap *pMap, sxu32 nValIdx)
+{
+	if( pMap->pView == 0 ){
+		/* Allocate the view node */
+		pMap->pView = HashmapNewIntNode(&(*pMap), 0, 0, 0);
+		if( pMap->pView == 0 ){
+			return SXERR_MEM;
+		}
+	}
+	if( pMap->nEntry >= pMap->nSlot ){
+		sxu32 nNew = pMap->nSlot << 1;
+		sxu32 *aNew;
+		if( nNew < 1 ){
+			nNew = 8;
+		}
+		aNew = (sxu32 *)SyMemBackendRealloc(&pMap->pVm->sAllocator, pMap->aSlot, nNew * sizeof(sxu32));
+		if( aNew == 0 ){
+			return SXERR_MEM;
+		}
+		pMap->aSlot = aNew;
+		pMap->nSlot = nNew;
+	}
+	if( pMap->nEntry < 1 ){
+		/* Point to the first inserted entry */
+		pMap->iSlotCur = 0;
+	}
+	pMap->aSlot[pMap->nEntry++] = nValIdx;
+	return SXRET_OK;
+}
+/*
+ * Turn a packed list into a regular hashmap: a node is allocated and linked for
+ * each entry and the loop cursor is preserved.
+ * The view node is kept until the hashmap is released since a caller may still
+ * hold it [i.e: a walk interrupted by a callback].
+ */
+static sxi32 HashmapUnpack(jx9_hashmap *pMap)
+{
+	jx9_hashmap_node *pNode, *pCur = 0;
+	sxu32 *aSlot = pMap->aSlot;
+	sxu32 nEntry = pMap->nEntry;
+	sxi32 rc = SXRET_OK;
+	sxu32 n;
+	if( (pMap->iFlags & HASHMAP_PACKED) == 0 ){
+		/* Already a regular hashmap */
+		return SXRET_OK;
+	}
+	pMap->iFlags &= ~HASHMAP_PACKED;
+	pMap->aSlot = 0;
+	pMap->nSlot = pMap->nEntry = 0;
+	for( n = 0 ; n < nEntry ; ++n ){
+		pNode = HashmapNewIntNode(&(*pMap), (sxi64)n, pMap->xIntHash((sxi64)n), aSlot[n]);
+		if( pNode == 0 || HashmapGrowBucket(&(*pMap)) != SXRET_OK ){
+			if( pNode ){
+				SyMemBackendPoolFree(&pMap->pVm->sAllocator, pNode);
+			}
+			/* Release the entries that could not be converted */
+			while( n < nEntry ){
+				jx9VmUnsetMemObj(pMap->pVm, aSlot[n++]);
+			}
+			rc = SXERR_MEM;
+			break;
+		}
+		HashmapNodeLink(&(*pMap), pNode, pNode->nHash & (pMap->nSize - 1));
+		if( n == pMap->iSlotCur ){
+			pCur = pNode;
+		}
+	}
+	/* Restore the loop cursor */
+	pMap->pCur = pCur;
+	if( aSlot ){
+		SyMemBackendFree(&pMap->pVm->sAllocator, (void *)aSlot);
+	}
+	return rc;
+}
 /*
  * Insert a 64-bit integer key and it's associated value (if any) in the given
  * hashmap.
@@ -22413,6 +23131,13 @@ static sxi32 HashmapInsertIntKey(jx9_hashmap *pMap,sxi64 iKey,jx9_value *pValue)
 	sxu32 nIdx;
 	sxu32 nHash;
 	sxi32 rc;
+	if( (pMap->iFlags & HASHMAP_PACKED) && iKey != (sxi64)pMap->nEntry ){
+		/* Non sequential key, switch to a regular hashmap */
+		rc = HashmapUnpack(&(*pMap));
+		if( rc != SXRET_OK ){
+			return rc;
+		}
+	}
 	/* Reserve a jx9_value for the value */
 	pObj = jx9VmReserveMemObj(pMap->pVm,&nIdx);
 	if( pObj == 0 ){
@@ -22422,6 +23147,14 @@ static sxi32 HashmapInsertIntKey(jx9_hashmap *pMap,sxi64 iKey,jx9_value *pValue)
 		/* Duplicate the value */
 		jx9MemObjStore(pValue, pObj);
 	}	
+	if( pMap->iFlags & HASHMAP_PACKED ){
+		/* Append to the packed list */
+		rc = HashmapPackedAppend(&(*pMap), nIdx);
+		if( rc != SXRET_OK ){
+			jx9VmUnsetMemObj(pMap->pVm, nIdx);
+		}
+		return rc;
+	}
 	/* Hash the key */
 	nHash = pMap->xIntHash(iKey);
 	/* Allocate a new int node */
@@ -22451,6 +23184,11 @@ static sxi32 HashmapInsertBlobKey(jx9_hashmap *pMap,const void *pKey,sxu32 nKeyL
 	sxu32 nHash;
 	sxu32 nIdx;
 	sxi32 rc;
+	/* Packed lists hold int keys only */
+	rc = HashmapUnpack(&(*pMap));
+	if( rc != SXRET_OK ){
+		return rc;
+	}
 	/* Reserve a jx9_value for the value */
 	pObj = jx9VmReserveMemObj(pMap->pVm,&nIdx);
 	if( pObj == 0 ){
@@ -22495,6 +23233,17 @@ static sxi32 HashmapLookupIntKey(
 		/* Don't bother hashing, there is no entry anyway */
 		return SXERR_NOTFOUND;
 	}
+	if( pMap->iFlags & HASHMAP_PACKED ){
+		/* Packed list, the key is the entry index */
+		pNode = HashmapPackedNode(&(*pMap), iKey, pMap->pView);
+		if( pNode == 0 ){
+			return SXERR_NOTFOUND;
+		}
+		if( ppNode ){
+			*ppNode = pNode;
+		}
+		return SXRET_OK;
+	}
 	/* Hash the key first */
 	nHash = pMap->xIntHash(iKey);
 	/* Point to the appropriate bucket */
@@ -22533,8 +23282,8 @@ static sxi32 HashmapLookupBlobKey(
 {
 	jx9_hashmap_node *pNode;
 	sxu32 nHash;
-	if( pMap->nEntry < 1 ){
-		/* Don't bother hashing, there is no entry anyway */
+	if( pMap->nEntry < 1 || (pMap->iFlags & HASHMAP_PACKED) ){
+		/* Don't bother hashing, there is no entry anyway [packed lists hold int keys only] */
 		return SXERR_NOTFOUND;
 	}
 	/* Hash the key first */
@@ -22837,12 +23586,13 @@ static int HashmapFindValue(
 	)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value sVal, *pVal;
 	jx9_value sNeedle;
 	sxi32 rc;
 	sxu32 n;
 	/* Perform a linear search since we cannot sort the hashmap based on values */
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	n = pMap->nEntry;
 	jx9MemObjInit(pMap->pVm, &sVal);
 	jx9MemObjInit(pMap->pVm, &sNeedle);
@@ -22880,7 +23630,7 @@ static int HashmapFindValue(
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 		n--;
 	}
 	/* No such entry */
@@ -22940,6 +23690,7 @@ JX9_PRIVATE sxi32 jx9HashmapCmp(
 	)
 {
 	jx9_hashmap_node *pLe, *pRe;
+	jx9_hashmap_node sView;
 	sxi32 rc;
 	sxu32 n;
 	if( pLeft == pRight ){
@@ -22953,7 +23704,7 @@ JX9_PRIVATE sxi32 jx9HashmapCmp(
 		return pLeft->nEntry > pRight->nEntry ? 1 : -1;
 	}
 	/* Point to the first inserted entry of the left hashmap */
-	pLe = pLeft->pFirst;
+	pLe = HashmapFirstNode(&(*pLeft), &sView);
 	pRe = 0; /* cc warning */
 	/* Perform the comparison */
 	n = pLeft->nEntry;
@@ -22989,7 +23740,7 @@ JX9_PRIVATE sxi32 jx9HashmapCmp(
 			return rc;
 		}
 		/* Point to the next entry */
-		pLe = pLe->pPrev; /* Reverse link */
+		pLe = HashmapNextNode(pLe, &sView);
 		n--;
 	}
 	return 0; /* Hashmaps are equals */
@@ -23009,6 +23760,7 @@ JX9_PRIVATE sxi32 jx9HashmapCmp(
 static sxi32 HashmapMerge(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value sKey, *pVal;
 	sxi32 rc;
 	sxu32 n;
@@ -23019,7 +23771,7 @@ static sxi32 HashmapMerge(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 		return SXRET_OK;
 	}
 	/* Point to the first inserted entry in the source */
-	pEntry = pSrc->pFirst;
+	pEntry = HashmapFirstNode(&(*pSrc), &sView);
 	/* Perform the merge */
 	for( n = 0 ; n < pSrc->nEntry ; ++n ){
 		/* Extract the node value */
@@ -23037,7 +23789,7 @@ static sxi32 HashmapMerge(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 			return rc;
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	return SXRET_OK;
 }
@@ -23048,6 +23800,7 @@ static sxi32 HashmapMerge(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 JX9_PRIVATE sxi32 jx9HashmapDup(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value sKey, *pVal;
 	sxi32 rc;
 	sxu32 n;
@@ -23058,7 +23811,7 @@ JX9_PRIVATE sxi32 jx9HashmapDup(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 		return SXRET_OK;
 	}
 	/* Point to the first inserted entry in the source */
-	pEntry = pSrc->pFirst;
+	pEntry = HashmapFirstNode(&(*pSrc), &sView);
 	/* Perform the duplication */
 	for( n = 0 ; n < pSrc->nEntry ; ++n ){
 		/* Extract the node value */
@@ -23077,7 +23830,7 @@ JX9_PRIVATE sxi32 jx9HashmapDup(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 			return rc;
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	return SXRET_OK;
 }
@@ -23121,6 +23874,7 @@ JX9_PRIVATE sxi32 jx9HashmapDup(jx9_hashmap *pSrc, jx9_hashmap *pDest)
 JX9_PRIVATE sxi32 jx9HashmapUnion(jx9_hashmap *pLeft, jx9_hashmap *pRight)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	sxi32 rc = SXRET_OK;
 	jx9_value *pObj;
 	sxu32 n;
@@ -23131,7 +23885,7 @@ JX9_PRIVATE sxi32 jx9HashmapUnion(jx9_hashmap *pLeft, jx9_hashmap *pRight)
 		return SXRET_OK;
 	}
 	/* Perform the union */
-	pEntry = pRight->pFirst;
+	pEntry = HashmapFirstNode(&(*pRight), &sView);
 	for(n = 0 ; n < pRight->nEntry ; ++n ){
 		/* Make sure the given key does not exists in the left array */
 		if( pEntry->iType == HASHMAP_BLOB_NODE ){
@@ -23162,7 +23916,7 @@ JX9_PRIVATE sxi32 jx9HashmapUnion(jx9_hashmap *pLeft, jx9_hashmap *pRight)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	return SXRET_OK;
 }
@@ -23187,7 +23941,8 @@ JX9_PRIVATE jx9_hashmap * jx9NewHashmap(
 	/* Fill in the structure */
 	pMap->pVm = &(*pVm);
 	pMap->iRef = 1;
-	/* pMap->iFlags = 0; */
+	/* Start as a packed list */
+	pMap->iFlags = HASHMAP_PACKED;
 	/* Default hash functions */
 	pMap->xIntHash  = xIntHash ? xIntHash : IntHash;
 	pMap->xBlobHash = xBlobHash ? xBlobHash : BinHash;
@@ -23263,6 +24018,21 @@ JX9_PRIVATE sxi32 jx9HashmapRelease(jx9_hashmap *pMap, int FreeDS)
 	jx9_hashmap_node *pEntry, *pNext;
 	jx9_vm *pVm = pMap->pVm;
 	sxu32 n;
+	if( pMap->iFlags & HASHMAP_PACKED ){
+		/* Packed list, restore the jx9_values to the free list */
+		for( n = 0 ; n < pMap->nEntry ; ++n ){
+			jx9VmUnsetMemObj(pVm, pMap->aSlot[n]);
+		}
+		if( pMap->aSlot ){
+			SyMemBackendFree(&pVm->sAllocator, (void *)pMap->aSlot);
+		}
+		/* No hash bucket */
+		pMap->nEntry = 0;
+	}
+	if( pMap->pView ){
+		/* Release the view node */
+		SyMemBackendPoolFree(&pVm->sAllocator, pMap->pView);
+	}
 	/* Start the release process */
 	n = 0;
 	pEntry = pMap->pFirst;
@@ -23295,6 +24065,11 @@ JX9_PRIVATE sxi32 jx9HashmapRelease(jx9_hashmap *pMap, int FreeDS)
 		pMap->iNextIdx = 0;
 		pMap->nEntry = pMap->nSize = 0;
 		pMap->pFirst = pMap->pLast = pMap->pCur = 0;
+		/* Start over as a packed list */
+		pMap->iFlags |= HASHMAP_PACKED;
+		pMap->aSlot = 0;
+		pMap->nSlot = pMap->iSlotCur = 0;
+		pMap->pView = 0;
 	}
 	return SXRET_OK;
 }
@@ -23353,6 +24128,7 @@ JX9_PRIVATE void jx9HashmapResetLoopCursor(jx9_hashmap *pMap)
 {
 	/* Reset the loop cursor */
 	pMap->pCur = pMap->pFirst;
+	pMap->iSlotCur = 0;
 }
 /*
  * Return a pointer to the node currently pointed by the node cursor.
@@ -23363,6 +24139,20 @@ JX9_PRIVATE void jx9HashmapResetLoopCursor(jx9_hashmap *pMap)
 JX9_PRIVATE jx9_hashmap_node * jx9HashmapGetNextEntry(jx9_hashmap *pMap)
 {
 	jx9_hashmap_node *pCur = pMap->pCur;
+	if( pMap->iFlags & HASHMAP_PACKED ){
+		/* Packed list */
+		pCur = HashmapPackedNode(&(*pMap), (sxi64)pMap->iSlotCur, pMap->pView);
+		if( pCur == 0 ){
+			/* End of the list, return null */
+			return 0;
+		}
+		/* Advance the slot cursor */
+		pMap->iSlotCur++;
+		if( pMap->iSlotCur >= pMap->nEntry ){
+			pMap->iSlotCur = SXU32_HIGH;
+		}
+		return pCur;
+	}
 	if( pCur == 0 ){
 		/* End of the list, return null */
 		return 0;
@@ -23371,6 +24161,16 @@ JX9_PRIVATE jx9_hashmap_node * jx9HashmapGetNextEntry(jx9_hashmap *pMap)
 	pMap->pCur = pCur->pPrev; /* Reverse link */
 	return pCur;
 }
+/*
+ * Return a pointer to the last inserted node, NULL if the hashmap is empty.
+ */
+JX9_PRIVATE jx9_hashmap_node * jx9HashmapGetLastEntry(jx9_hashmap *pMap)
+{
+	if( pMap->iFlags & HASHMAP_PACKED ){
+		return HashmapPackedNode(&(*pMap), (sxi64)pMap->nEntry - 1, pMap->pView);
+	}
+	return pMap->pLast;
+}
 /*
  * Extract a node value.
  */
@@ -23422,7 +24222,8 @@ JX9_PRIVATE void jx9HashmapExtractNodeKey(jx9_hashmap_node *pNode,jx9_value *pKe
  */
 JX9_PRIVATE int jx9HashmapValuesToSet(jx9_hashmap *pMap, SySet *pOut)
 {
-	jx9_hashmap_node *pEntry = pMap->pFirst;
+	jx9_hashmap_node sView;
+	jx9_hashmap_node *pEntry = HashmapFirstNode(&(*pMap), &sView);
 	jx9_value *pValue;
 	sxu32 n;
 	/* Initialize the container */
@@ -23434,7 +24235,7 @@ JX9_PRIVATE int jx9HashmapValuesToSet(jx9_hashmap *pMap, SySet *pOut)
 			SySetPut(pOut, (const void *)&pValue);
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	/* Total inserted entries */
 	return (int)SySetUsed(pOut);
@@ -23507,6 +24308,10 @@ static sxi32 HashmapMergeSort(jx9_hashmap *pMap, ProcNodeCmp xCmp, void *pCmpDat
 {
 	jx9_hashmap_node *a[N_SORT_BUCKET], *p, *pIn;
 	sxu32 i;
+	/* Nodes are relinked in place */
+	if( HashmapUnpack(&(*pMap)) != SXRET_OK ){
+		return SXERR_MEM;
+	}
 	SyZero(a, sizeof(a));
 	/* Point to the first inserted entry */
 	pIn = pMap->pFirst;
@@ -23923,8 +24728,10 @@ static int jx9_hashmap_pop(jx9_context *pCtx, int nArg, jx9_value **apArg)
 		/* Noting to pop, return NULL */
 		jx9_result_null(pCtx);
 	}else{
-		jx9_hashmap_node *pLast = pMap->pLast;
+		jx9_hashmap_node *pLast;
 		jx9_value *pObj;
+		HashmapUnpack(&(*pMap));
+		pLast = pMap->pLast;
 		pObj = HashmapExtractNodeValue(pLast);
 		if( pObj ){
 			/* Node value */
@@ -24007,9 +24814,12 @@ static int jx9_hashmap_shift(jx9_context *pCtx, int nArg, jx9_value **apArg)
 		/* Empty hashmap, return NULL */
 		jx9_result_null(pCtx);
 	}else{
-		jx9_hashmap_node *pEntry = pMap->pFirst;
+		jx9_hashmap_node *pEntry;
 		jx9_value *pObj;
 		sxu32 n;
+		/* Int keys are renumbered in place */
+		HashmapUnpack(&(*pMap));
+		pEntry = pMap->pFirst;
 		pObj = HashmapExtractNodeValue(pEntry);
 		if( pObj ){
 			/* Node value */
@@ -24044,8 +24854,11 @@ static int jx9_hashmap_shift(jx9_context *pCtx, int nArg, jx9_value **apArg)
  */
 static sxi32 HashmapCurrentValue(jx9_context *pCtx, jx9_hashmap *pMap, int iDirection)
 {
-	jx9_hashmap_node *pCur = pMap->pCur;
+	jx9_hashmap_node *pCur;
 	jx9_value *pVal;
+	/* The node cursor is moved both ways */
+	HashmapUnpack(&(*pMap));
+	pCur = pMap->pCur;
 	if( pCur == 0 ){
 		/* Cursor does not point to anything, return FALSE */
 		jx9_result_bool(pCtx, 0);
@@ -24179,6 +24992,7 @@ static int jx9_hashmap_end(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	}
 	/* Point to the internal representation of the input hashmap */
 	pMap = (jx9_hashmap *)apArg[0]->x.pOther;
+	HashmapUnpack(&(*pMap));
 	/* Point to the last node */
 	pMap->pCur = pMap->pLast;
 	/* Return the last node value */
@@ -24209,6 +25023,7 @@ static int jx9_hashmap_reset(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	}
 	/* Point to the internal representation of the input hashmap */
 	pMap = (jx9_hashmap *)apArg[0]->x.pOther;
+	HashmapUnpack(&(*pMap));
 	/* Point to the first node */
 	pMap->pCur = pMap->pFirst;
 	/* Return the last node value if available */
@@ -24243,6 +25058,7 @@ static int jx9_hashmap_simple_key(jx9_context *pCtx, int nArg, jx9_value **apArg
 		return JX9_OK;
 	}
 	pMap = (jx9_hashmap *)apArg[0]->x.pOther;
+	HashmapUnpack(&(*pMap));
 	pCur = pMap->pCur;
 	if( pCur == 0 ){
 		/* Cursor does not point to anything, return NULL */
@@ -24292,6 +25108,7 @@ static int jx9_hashmap_each(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	}
 	/* Point to the internal representation that describe the input hashmap */
 	pMap = (jx9_hashmap *)apArg[0]->x.pOther;
+	HashmapUnpack(&(*pMap));
 	if( pMap->pCur == 0 ){
 		/* Cursor does not point to anything, return FALSE */
 		jx9_result_bool(pCtx, 0);
@@ -24336,6 +25153,7 @@ static int jx9_hashmap_each(jx9_context *pCtx, int nArg, jx9_value **apArg)
 static int jx9_hashmap_values(jx9_context *pCtx, int nArg, jx9_value **apArg)
 {
 	jx9_hashmap_node *pNode;
+	jx9_hashmap_node sView;
 	jx9_hashmap *pMap;
 	jx9_value *pArray;
 	jx9_value *pObj;
@@ -24360,7 +25178,7 @@ static int jx9_hashmap_values(jx9_context *pCtx, int nArg, jx9_value **apArg)
 		return JX9_OK;
 	}
 	/* Perform the requested operation */
-	pNode = pMap->pFirst;
+	pNode = HashmapFirstNode(&(*pMap), &sView);
 	for( n = 0 ; n < pMap->nEntry ; ++n ){
 		pObj = HashmapExtractNodeValue(pNode);
 		if( pObj ){
@@ -24368,7 +25186,7 @@ static int jx9_hashmap_values(jx9_context *pCtx, int nArg, jx9_value **apArg)
 			jx9_array_add_elem(pArray, 0/* Automatic index assign */, pObj);
 		}
 		/* Point to the next entry */
-		pNode = pNode->pPrev; /* Reverse link */
+		pNode = HashmapNextNode(pNode, &sView);
 	}
 	/* return the new array */
 	jx9_result_value(pCtx, pArray);
@@ -24576,6 +25394,7 @@ static int jx9_hashmap_erase(jx9_context *pCtx, int nArg, jx9_value **apArg)
 static int jx9_hashmap_diff(jx9_context *pCtx, int nArg, jx9_value **apArg)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_hashmap *pSrc, *pMap;
 	jx9_value *pArray;
 	jx9_value *pVal;
@@ -24601,7 +25420,7 @@ static int jx9_hashmap_diff(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	/* Point to the internal representation of the source hashmap */
 	pSrc = (jx9_hashmap *)apArg[0]->x.pOther;
 	/* Perform the diff */
-	pEntry = pSrc->pFirst;
+	pEntry = HashmapFirstNode(&(*pSrc), &sView);
 	n = pSrc->nEntry;
 	for(;;){
 		if( n < 1 ){
@@ -24630,7 +25449,7 @@ static int jx9_hashmap_diff(jx9_context *pCtx, int nArg, jx9_value **apArg)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 		n--;
 	}
 	/* Return the freshly created array */
@@ -24655,6 +25474,7 @@ static int jx9_hashmap_diff(jx9_context *pCtx, int nArg, jx9_value **apArg)
 static int jx9_hashmap_intersect(jx9_context *pCtx, int nArg, jx9_value **apArg)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_hashmap *pSrc, *pMap;
 	jx9_value *pArray;
 	jx9_value *pVal;
@@ -24680,7 +25500,7 @@ static int jx9_hashmap_intersect(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	/* Point to the internal representation of the source hashmap */
 	pSrc = (jx9_hashmap *)apArg[0]->x.pOther;
 	/* Perform the intersection */
-	pEntry = pSrc->pFirst;
+	pEntry = HashmapFirstNode(&(*pSrc), &sView);
 	n = pSrc->nEntry;
 	for(;;){
 		if( n < 1 ){
@@ -24709,7 +25529,7 @@ static int jx9_hashmap_intersect(jx9_context *pCtx, int nArg, jx9_value **apArg)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 		n--;
 	}
 	/* Return the freshly created array */
@@ -24727,10 +25547,11 @@ static int jx9_hashmap_intersect(jx9_context *pCtx, int nArg, jx9_value **apArg)
 static void DoubleSum(jx9_context *pCtx, jx9_hashmap *pMap)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value *pObj;
 	double dSum = 0;
 	sxu32 n;
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	for( n = 0 ; n < pMap->nEntry ; n++ ){
 		pObj = HashmapExtractNodeValue(pEntry);
 		if( pObj && (pObj->iFlags & (MEMOBJ_NULL|MEMOBJ_HASHMAP|MEMOBJ_RES)) == 0){
@@ -24747,7 +25568,7 @@ static void DoubleSum(jx9_context *pCtx, jx9_hashmap *pMap)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	/* Return sum */
 	jx9_result_double(pCtx, dSum);
@@ -24755,10 +25576,11 @@ static void DoubleSum(jx9_context *pCtx, jx9_hashmap *pMap)
 static void Int64Sum(jx9_context *pCtx, jx9_hashmap *pMap)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value *pObj;
 	sxi64 nSum = 0;
 	sxu32 n;
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	for( n = 0 ; n < pMap->nEntry ; n++ ){
 		pObj = HashmapExtractNodeValue(pEntry);
 		if( pObj && (pObj->iFlags & (MEMOBJ_NULL|MEMOBJ_HASHMAP|MEMOBJ_RES)) == 0){
@@ -24775,7 +25597,7 @@ static void Int64Sum(jx9_context *pCtx, jx9_hashmap *pMap)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	/* Return sum */
 	jx9_result_int64(pCtx, nSum);
@@ -24807,7 +25629,7 @@ static int jx9_hashmap_sum(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	/* If the first element is of type float, then perform floating
 	 * point computaion.Otherwise switch to int64 computaion.
 	 */
-	pObj = HashmapExtractNodeValue(pMap->pFirst);
+	pObj = HashmapExtractNodeValue(HashmapFirstNode(&(*pMap), pMap->pView));
 	if( pObj == 0 ){
 		jx9_result_int(pCtx, 0);
 		return JX9_OK;
@@ -24830,10 +25652,11 @@ static int jx9_hashmap_sum(jx9_context *pCtx, int nArg, jx9_value **apArg)
 static void DoubleProd(jx9_context *pCtx, jx9_hashmap *pMap)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value *pObj;
 	double dProd;
 	sxu32 n;
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	dProd = 1;
 	for( n = 0 ; n < pMap->nEntry ; n++ ){
 		pObj = HashmapExtractNodeValue(pEntry);
@@ -24851,7 +25674,7 @@ static void DoubleProd(jx9_context *pCtx, jx9_hashmap *pMap)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	/* Return product */
 	jx9_result_double(pCtx, dProd);
@@ -24859,10 +25682,11 @@ static void DoubleProd(jx9_context *pCtx, jx9_hashmap *pMap)
 static void Int64Prod(jx9_context *pCtx, jx9_hashmap *pMap)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value *pObj;
 	sxi64 nProd;
 	sxu32 n;
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	nProd = 1;
 	for( n = 0 ; n < pMap->nEntry ; n++ ){
 		pObj = HashmapExtractNodeValue(pEntry);
@@ -24880,7 +25704,7 @@ static void Int64Prod(jx9_context *pCtx, jx9_hashmap *pMap)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	/* Return product */
 	jx9_result_int64(pCtx, nProd);
@@ -24912,7 +25736,7 @@ static int jx9_hashmap_product(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	/* If the first element is of type float, then perform floating
 	 * point computaion.Otherwise switch to int64 computaion.
 	 */
-	pObj = HashmapExtractNodeValue(pMap->pFirst);
+	pObj = HashmapExtractNodeValue(HashmapFirstNode(&(*pMap), pMap->pView));
 	if( pObj == 0 ){
 		jx9_result_int(pCtx, 0);
 		return JX9_OK;
@@ -24942,6 +25766,7 @@ static int jx9_hashmap_map(jx9_context *pCtx, int nArg, jx9_value **apArg)
 {
 	jx9_value *pArray, *pValue, sKey, sResult;
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_hashmap *pMap;
 	sxu32 n;
 	if( nArg < 2 || !jx9_value_is_json_array(apArg[1]) ){
@@ -24960,7 +25785,7 @@ static int jx9_hashmap_map(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	jx9MemObjInit(pMap->pVm, &sResult);
 	jx9MemObjInit(pMap->pVm, &sKey);
 	/* Perform the requested operation */
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	for( n = 0 ; n < pMap->nEntry ; n++ ){
 		/* Extrcat the node value */
 		pValue = HashmapExtractNodeValue(pEntry);
@@ -24981,7 +25806,7 @@ static int jx9_hashmap_map(jx9_context *pCtx, int nArg, jx9_value **apArg)
 			jx9MemObjRelease(&sResult);
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	jx9_result_value(pCtx, pArray);
 	return JX9_OK;
@@ -25009,6 +25834,7 @@ static int jx9_hashmap_walk(jx9_context *pCtx, int nArg, jx9_value **apArg)
 {
 	jx9_value *pValue, *pUserData, sKey;
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_hashmap *pMap;
 	sxi32 rc;
 	sxu32 n;
@@ -25022,7 +25848,7 @@ static int jx9_hashmap_walk(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	pMap = (jx9_hashmap *)apArg[0]->x.pOther;
 	jx9MemObjInit(pMap->pVm, &sKey);
 	/* Perform the desired operation */
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	for( n = 0 ; n < pMap->nEntry ; n++ ){
 		/* Extract the node value */
 		pValue = HashmapExtractNodeValue(pEntry);
@@ -25039,7 +25865,7 @@ static int jx9_hashmap_walk(jx9_context *pCtx, int nArg, jx9_value **apArg)
 			}
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 	}
 	/* All done, return TRUE */
 	jx9_result_bool(pCtx, 1);
@@ -25079,15 +25905,16 @@ static const jx9_builtin_func aHashmapFunc[] = {
 	{"reset",             jx9_hashmap_reset   }, 
 	{"key",               jx9_hashmap_simple_key }
 };
+static sxu16 aHashmapFuncIdx[SX_ARRAYSIZE(aHashmapFunc)];
+static const jx9_builtin_table sHashmapFuncTable = {
+	aHashmapFunc, SX_ARRAYSIZE(aHashmapFunc), sizeof(jx9_builtin_func), JX9_BUILTIN_DATA_NONE, aHashmapFuncIdx
+};
 /*
- * Register the built-in hashmap functions defined above.
+ * Export the built-in hashmap functions defined above.
  */
-JX9_PRIVATE void jx9RegisterHashmapFunctions(jx9_vm *pVm)
+JX9_PRIVATE const jx9_builtin_table * jx9ExportHashmapFunction(void)
 {
-	sxu32 n;
-	for( n = 0 ; n < SX_ARRAYSIZE(aHashmapFunc) ; n++ ){
-		jx9_create_function(&(*pVm), aHashmapFunc[n].zName, aHashmapFunc[n].xFunc, 0);
-	}
+	return &sHashmapFuncTable;
 }
 /*
  * Iterate throw hashmap entries and invoke the given callback [i.e: xWalk()] for each 
@@ -25105,6 +25932,7 @@ JX9_PRIVATE sxi32 jx9HashmapWalk(
 	)
 {
 	jx9_hashmap_node *pEntry;
+	jx9_hashmap_node sView;
 	jx9_value sKey, sValue;
 	sxi32 rc;
 	sxu32 n;
@@ -25113,7 +25941,7 @@ JX9_PRIVATE sxi32 jx9HashmapWalk(
 	jx9MemObjInit(pMap->pVm, &sKey);
 	jx9MemObjInit(pMap->pVm, &sValue);
 	n = pMap->nEntry;
-	pEntry = pMap->pFirst;
+	pEntry = HashmapFirstNode(&(*pMap), &sView);
 	/* Start the iteration process */
 	for(;;){
 		if( n < 1 ){
@@ -25132,7 +25960,7 @@ JX9_PRIVATE sxi32 jx9HashmapWalk(
 			return SXERR_ABORT;
 		}
 		/* Point to the next entry */
-		pEntry = pEntry->pPrev; /* Reverse link */
+		pEntry = HashmapNextNode(pEntry, &sView);
 		n--;
 	}
 	/* All done */
@@ -25184,7 +26012,46 @@ struct json_private_data
 	int isFirst;       /* True if first encoded entry */
 	int iFlags;        /* JSON encoding flags */
 	int nRecCount;     /* Recursion count */
+	jx9_vm *pVm;       /* Streaming VM (See jx9JsonStream()) or NULL */
+	sxi32 rc;          /* SXERR_ABORT if the output consumer requested an abort */
 };
+/*
+ * When streaming (See jx9JsonStream()), the encoded text is handed to the VM
+ * output consumer each time the buffer holds at least JX9_JSON_STREAM_CHUNK bytes.
+ */
+#ifndef JX9_JSON_STREAM_CHUNK
+#define JX9_JSON_STREAM_CHUNK 512
+#endif
+/*
+ * Hand the buffered JSON text to the VM output consumer.
+ * Nothing is done when not streaming or when fewer than nMin bytes are buffered.
+ * Once the consumer has requested an abort, the output is discarded.
+ */
+static sxi32 VmJsonFlush(json_private_data *pData,sxu32 nMin)
+{
+	jx9_output_consumer *pCons;
+	sxu32 nLen;
+	if( pData->pVm == 0 ){
+		/* Not streaming */
+		return SXRET_OK;
+	}
+	nLen = SyBlobLength(pData->pOut);
+	if( nLen < 1 || nLen < nMin ){
+		return pData->rc;
+	}
+	if( pData->rc == SXRET_OK ){
+		pCons = &pData->pVm->sVmConsumer;
+		/* The consumer may block as long as it needs to (e.g. RTT in blocking mode) */
+		if( pCons->xConsumer(SyBlobData(pData->pOut),nLen,pCons->pUserData) == SXERR_ABORT ){
+			/* Output consumer callback request an operation abort */
+			pData->rc = SXERR_ABORT;
+		}
+		/* Increment output length */
+		pData->pVm->nOutputLen += nLen;
+	}
+	SyBlobReset(pData->pOut);
+	return pData->rc;
+}
 /*
  * Returns the JSON representation of a value.In other word perform a JSON encoding operation.
  * According to wikipedia
@@ -25243,6 +26110,10 @@ static sxi32 VmJsonEncode(
 					}
 					/* Append character verbatim */
 					SyBlobAppend(pOut,(const char *)&c,sizeof(char));
+					if( VmJsonFlush(&(*pData),JX9_JSON_STREAM_CHUNK) != SXRET_OK ){
+						/* Output aborted */
+						return JX9_ABORT;
+					}
 				}
 				/* Append the double quote */
 				SyBlobAppend(pOut,"\"",sizeof(char));
@@ -25294,6 +26165,10 @@ static int VmJsonArrayEncode(jx9_value *pKey, jx9_value *pValue, void *pUserData
 	VmJsonEncode(pValue, pJson);
 	pJson->nRecCount--;
 	pJson->isFirst = 0;
+	if( VmJsonFlush(&(*pJson),JX9_JSON_STREAM_CHUNK) != SXRET_OK ){
+		/* Output aborted, stop the walk */
+		return JX9_ABORT;
+	}
 	return JX9_OK;
 }
 /*
@@ -25330,6 +26205,10 @@ static int VmJsonObjectEncode(jx9_value *pKey,jx9_value *pValue,void *pUserData)
 	VmJsonEncode(pValue, pJson);
 	pJson->nRecCount--;
 	pJson->isFirst = 0;
+	if( VmJsonFlush(&(*pJson),JX9_JSON_STREAM_CHUNK) != SXRET_OK ){
+		/* Output aborted, stop the walk */
+		return JX9_ABORT;
+	}
 	return JX9_OK;
 }
 /*
@@ -25344,11 +26223,42 @@ JX9_PRIVATE int jx9JsonSerialize(jx9_value *pValue,SyBlob *pOut)
 	sJson.pOut = pOut;
 	sJson.isFirst = 1;
 	sJson.iFlags = 0;
+	sJson.pVm = 0;
+	sJson.rc = SXRET_OK;
 	/* Perform the encoding operation */
 	VmJsonEncode(pValue, &sJson);
 	/* All done */
 	return JX9_OK;
 }
+/*
+ * Output the JSON representation of the given value through the VM output consumer.
+ * Unlike jx9JsonSerialize(), the whole text is never built in memory: entries
+ * are encoded one at a time and handed to the consumer in chunks of about
+ * JX9_JSON_STREAM_CHUNK bytes, so the working buffer stays bounded whatever the
+ * size of the array. The consumer regulates the pace of the encoder (it is
+ * called synchronously) and may stop it by returning SXERR_ABORT.
+ * Return SXRET_OK or SXERR_ABORT if the output consumer requested an abort.
+ */
+JX9_PRIVATE sxi32 jx9JsonStream(jx9_vm *pVm,jx9_value *pValue)
+{
+	json_private_data sJson;
+	SyBlob sChunk;
+	sxi32 rc;
+	SyBlobInit(&sChunk,&pVm->sAllocator);
+	/* Prepare the JSON data */
+	sJson.nRecCount = 0;
+	sJson.pOut = &sChunk;
+	sJson.isFirst = 1;
+	sJson.iFlags = 0;
+	sJson.pVm = pVm;
+	sJson.rc = SXRET_OK;
+	/* Perform the encoding operation */
+	VmJsonEncode(pValue, &sJson);
+	/* Flush what's left */
+	rc = VmJsonFlush(&sJson,0);
+	SyBlobRelease(&sChunk);
+	return rc;
+}
 /* Possible tokens from the JSON tokenization process */
 #define JSON_TK_TRUE    0x001 /* Boolean true */
 #define JSON_TK_FALSE   0x002 /* Boolean false */
@@ -26798,6 +27708,10 @@ struct SyMutex
 {
 	pthread_mutex_t sMutex;
 	sxu32 nType;
+	/* SXMUTEX_TYPE_RW only, the owner fields are protected by sMutex */
+	pthread_rwlock_t sRwLock; /* Reader/writer lock */
+	pthread_t sOwner;         /* Thread holding the lock exclusively */
+	sxu32 nOwnerDepth;        /* Nesting level of the exclusive owner (0: not held exclusively) */
 };
 static SyMutex * UnixMutexNew(int nType)
 {
@@ -26811,13 +27725,17 @@ static SyMutex * UnixMutexNew(int nType)
 	};
 	SyMutex *pMutex;
 	
-	if( nType == SXMUTEX_TYPE_FAST || nType == SXMUTEX_TYPE_RECURSIVE ){
+	if( nType == SXMUTEX_TYPE_FAST || nType == SXMUTEX_TYPE_RECURSIVE || nType == SXMUTEX_TYPE_RW ){
 		pthread_mutexattr_t sRecursiveAttr;
   		/* Allocate a new mutex */
   		pMutex = (SyMutex *)malloc(sizeof(SyMutex));
   		if( pMutex == 0 ){
   			return 0;
   		}
+		if( nType == SXMUTEX_TYPE_RW ){
+			pthread_rwlock_init(&pMutex->sRwLock, 0);
+			pMutex->nOwnerDepth = 0;
+		}
   		if( nType == SXMUTEX_TYPE_RECURSIVE ){
   			pthread_mutexattr_init(&sRecursiveAttr);
   			pthread_mutexattr_settype(&sRecursiveAttr, PTHREAD_MUTEX_RECURSIVE);
@@ -26839,18 +27757,75 @@ static SyMutex * UnixMutexNew(int nType)
 }
 static void UnixMutexRelease(SyMutex *pMutex)
 {
-	if( pMutex->nType == SXMUTEX_TYPE_FAST || pMutex->nType == SXMUTEX_TYPE_RECURSIVE ){
+	if( pMutex->nType == SXMUTEX_TYPE_FAST || pMutex->nType == SXMUTEX_TYPE_RECURSIVE || pMutex->nType == SXMUTEX_TYPE_RW ){
+		if( pMutex->nType == SXMUTEX_TYPE_RW ){
+			pthread_rwlock_destroy(&pMutex->sRwLock);
+		}
 		pthread_mutex_destroy(&pMutex->sMutex);
 		free(pMutex);
 	}
 }
+/*
+ * Re-enter a reader/writer lock if the calling thread already hold it exclusively.
+ * Return TRUE in that case, FALSE otherwise.
+ */
+static int UnixRwLockNest(SyMutex *pMutex)
+{
+	int bNested = FALSE;
+	pthread_mutex_lock(&pMutex->sMutex);
+	if( pMutex->nOwnerDepth > 0 && pthread_equal(pMutex->sOwner, pthread_self()) ){
+		pMutex->nOwnerDepth++;
+		bNested = TRUE;
+	}
+	pthread_mutex_unlock(&pMutex->sMutex);
+	return bNested;
+}
 static void UnixMutexEnter(SyMutex *pMutex)
 {
+	if( pMutex->nType != SXMUTEX_TYPE_RW ){
+		pthread_mutex_lock(&pMutex->sMutex);
+		return;
+	}
+	/* Exclusive mode, recursive like the handle mutex it replaces */
+	if( UnixRwLockNest(pMutex) ){
+		return;
+	}
+	pthread_rwlock_wrlock(&pMutex->sRwLock);
 	pthread_mutex_lock(&pMutex->sMutex);
+	pMutex->sOwner = pthread_self();
+	pMutex->nOwnerDepth = 1;
+	pthread_mutex_unlock(&pMutex->sMutex);
 }
 static void UnixMutexLeave(SyMutex *pMutex)
 {
+	sxu32 nDepth;
+	if( pMutex->nType != SXMUTEX_TYPE_RW ){
+		pthread_mutex_unlock(&pMutex->sMutex);
+		return;
+	}
+	pthread_mutex_lock(&pMutex->sMutex);
+	nDepth = --pMutex->nOwnerDepth;
 	pthread_mutex_unlock(&pMutex->sMutex);
+	if( nDepth < 1 ){
+		pthread_rwlock_unlock(&pMutex->sRwLock);
+	}
+}
+static int UnixMutexEnterShared(SyMutex *pMutex)
+{
+	if( pMutex->nType != SXMUTEX_TYPE_RW ){
+		pthread_mutex_lock(&pMutex->sMutex);
+		return FALSE;
+	}
+	if( UnixRwLockNest(pMutex) ){
+		/* Already held exclusively by this thread */
+		return FALSE;
+	}
+	pthread_rwlock_rdlock(&pMutex->sRwLock);
+	return TRUE;
+}
+static void UnixMutexLeaveShared(SyMutex *pMutex)
+{
+	pthread_rwlock_unlock(&pMutex->sRwLock);
 }
 /* Export pthread mutex interfaces */
 static const SyMutexMethods sPthreadMutexMethods = {
@@ -26860,7 +27835,9 @@ static const SyMutexMethods sPthreadMutexMethods = {
 	UnixMutexRelease,  /* xRelease() */
 	UnixMutexEnter,    /* xEnter() */
 	0,                 /* xTryEnter() */
-	UnixMutexLeave     /* xLeave() */
+	UnixMutexLeave,    /* xLeave() */
+	UnixMutexEnterShared, /* xEnterShared() */
+	UnixMutexLeaveShared  /* xLeaveShared() */
 };
 JX9_PRIVATE const SyMutexMethods * SyMutexExportMethods(void)
 {
@@ -41306,10 +42283,145 @@ static int is_jx9_stream(const jx9_io_stream *pStream)
 #endif /* JX9_DISABLE_DISK_IO */
 }
 
+/* Table of built-in VFS functions */
+static const jx9_builtin_func aVfsFunc[] = {
+	{"chdir",   jx9Vfs_chdir   }, 
+	{"chroot",  jx9Vfs_chroot  }, 
+	{"getcwd",  jx9Vfs_getcwd  }, 
+	{"rmdir",   jx9Vfs_rmdir   }, 
+	{"is_dir",  jx9Vfs_is_dir  }, 
+	{"mkdir",   jx9Vfs_mkdir   }, 
+	{"rename",  jx9Vfs_rename  }, 
+	{"realpath", jx9Vfs_realpath}, 
+	{"sleep",   jx9Vfs_sleep   }, 
+	{"usleep",  jx9Vfs_usleep  }, 
+	{"unlink",  jx9Vfs_unlink  }, 
+	{"delete",  jx9Vfs_unlink  }, 
+	{"chmod",   jx9Vfs_chmod   }, 
+	{"chown",   jx9Vfs_chown   }, 
+	{"chgrp",   jx9Vfs_chgrp   }, 
+	{"disk_free_space", jx9Vfs_disk_free_space  }, 
+	{"disk_total_space", jx9Vfs_disk_total_space}, 
+	{"file_exists", jx9Vfs_file_exists }, 
+	{"filesize",    jx9Vfs_file_size   }, 
+	{"fileatime",   jx9Vfs_file_atime  }, 
+	{"filemtime",   jx9Vfs_file_mtime  }, 
+	{"filectime",   jx9Vfs_file_ctime  }, 
+	{"is_file",     jx9Vfs_is_file  }, 
+	{"is_link",     jx9Vfs_is_link  }, 
+	{"is_readable", jx9Vfs_is_readable   }, 
+	{"is_writable", jx9Vfs_is_writable   }, 
+	{"is_executable", jx9Vfs_is_executable}, 
+	{"filetype",    jx9Vfs_filetype }, 
+	{"stat",        jx9Vfs_stat     }, 
+	{"lstat",       jx9Vfs_lstat    }, 
+	{"getenv",      jx9Vfs_getenv   }, 
+	{"setenv",      jx9Vfs_putenv   }, 
+	{"putenv",      jx9Vfs_putenv   }, 
+	{"touch",       jx9Vfs_touch    }, 
+	{"link",        jx9Vfs_link     }, 
+	{"symlink",     jx9Vfs_symlink  }, 
+	{"umask",       jx9Vfs_umask    }, 
+	{"sys_get_temp_dir", jx9Vfs_sys_get_temp_dir }, 
+	{"get_current_user", jx9Vfs_get_current_user }, 
+	{"getpid",      jx9Vfs_getmypid }, 
+	{"getuid",      jx9Vfs_getmyuid }, 
+	{"getgid",      jx9Vfs_getmygid }, 
+	{"uname",       jx9Vfs_uname}, 
+	     /* Path processing */ 
+	{"dirname",     jx9Builtin_dirname  }, 
+	{"basename",    jx9Builtin_basename }, 
+	{"pathinfo",    jx9Builtin_pathinfo }, 
+	{"strglob",     jx9Builtin_strglob  }, 
+	{"fnmatch",     jx9Builtin_fnmatch  }, 
+	     /* ZIP processing */
+	{"zip_open",    jx9Builtin_zip_open }, 
+	{"zip_close",   jx9Builtin_zip_close}, 
+	{"zip_read",    jx9Builtin_zip_read }, 
+	{"zip_entry_open", jx9Builtin_zip_entry_open }, 
+	{"zip_entry_close", jx9Builtin_zip_entry_close}, 
+	{"zip_entry_name", jx9Builtin_zip_entry_name }, 
+	{"zip_entry_filesize",      jx9Builtin_zip_entry_filesize       }, 
+	{"zip_entry_compressedsize", jx9Builtin_zip_entry_compressedsize }, 
+	{"zip_entry_read", jx9Builtin_zip_entry_read }, 
+	{"zip_entry_reset_cursor", jx9Builtin_zip_entry_reset_cursor}, 
+	{"zip_entry_compressionmethod", jx9Builtin_zip_entry_compressionmethod}
+};
+static sxu16 aVfsFuncIdx[SX_ARRAYSIZE(aVfsFunc)];
+static const jx9_builtin_table sVfsFuncTable = {
+	aVfsFunc, SX_ARRAYSIZE(aVfsFunc), sizeof(jx9_builtin_func), JX9_BUILTIN_DATA_VFS, aVfsFuncIdx
+};
+/* Table of built-in IO stream functions */
+static const jx9_builtin_func aIOFunc[] = {
+	{"ftruncate", jx9Builtin_ftruncate }, 
+	{"fseek",     jx9Builtin_fseek  }, 
+	{"ftell",     jx9Builtin_ftell  }, 
+	{"rewind",    jx9Builtin_rewind }, 
+	{"fflush",    jx9Builtin_fflush }, 
+	{"feof",      jx9Builtin_feof   }, 
+	{"fgetc",     jx9Builtin_fgetc  }, 
+	{"fgets",     jx9Builtin_fgets  }, 
+	{"fread",     jx9Builtin_fread  }, 
+	{"fgetcsv",   jx9Builtin_fgetcsv}, 
+	{"fgetss",    jx9Builtin_fgetss }, 
+	{"readdir",   jx9Builtin_readdir}, 
+	{"rewinddir", jx9Builtin_rewinddir }, 
+	{"closedir",  jx9Builtin_closedir}, 
+	{"opendir",   jx9Builtin_opendir }, 
+	{"readfile",  jx9Builtin_readfile}, 
+	{"file_get_contents", jx9Builtin_file_get_contents}, 
+	{"file_put_contents", jx9Builtin_file_put_contents}, 
+	{"file",      jx9Builtin_file   }, 
+	{"copy",      jx9Builtin_copy   }, 
+	{"fstat",     jx9Builtin_fstat  }, 
+	{"fwrite",    jx9Builtin_fwrite }, 
+	{"fputs",     jx9Builtin_fwrite }, 
+	{"flock",     jx9Builtin_flock  }, 
+	{"fclose",    jx9Builtin_fclose }, 
+	{"fopen",     jx9Builtin_fopen  }, 
+	{"fpassthru", jx9Builtin_fpassthru }, 
+	{"fputcsv",   jx9Builtin_fputcsv }, 
+	{"fprintf",   jx9Builtin_fprintf }, 
+#if !defined(JX9_DISABLE_HASH_FUNC)
+	{"md5_file",  jx9Builtin_md5_file}, 
+	{"sha1_file", jx9Builtin_sha1_file}, 
+#endif /* JX9_DISABLE_HASH_FUNC */
+	{"parse_ini_file", jx9Builtin_parse_ini_file}, 
+	{"vfprintf",  jx9Builtin_vfprintf}
+};
+static sxu16 aIOFuncIdx[SX_ARRAYSIZE(aIOFunc)];
+static const jx9_builtin_table sIOFuncTable = {
+	aIOFunc, SX_ARRAYSIZE(aIOFunc), sizeof(jx9_builtin_func), JX9_BUILTIN_DATA_VM, aIOFuncIdx
+};
+#endif /* JX9_DISABLE_BUILTIN_FUNC */
+/*
+ * Export the built-in VFS functions [i.e: chdir(), mkdir(), ...] which have
+ * access to the underlying VFS as their private data.
+ * NULL is returned when the engine is compiled with JX9_DISABLE_BUILTIN_FUNC.
+ */
+JX9_PRIVATE const jx9_builtin_table * jx9ExportVfsFunction(void)
+{
+#ifndef JX9_DISABLE_BUILTIN_FUNC
+	return &sVfsFuncTable;
+#else
+	return 0;
 #endif /* JX9_DISABLE_BUILTIN_FUNC */
+}
 /*
- * Export the IO routines defined above and the built-in IO streams
- * [i.e: file://, jx9://].
+ * Export the built-in IO stream functions [i.e: fopen(), fread(), file(), ...]
+ * which have access to the calling VM as their private data.
+ * NULL is returned when the engine is compiled with JX9_DISABLE_BUILTIN_FUNC.
+ */
+JX9_PRIVATE const jx9_builtin_table * jx9ExportIOFunction(void)
+{
+#ifndef JX9_DISABLE_BUILTIN_FUNC
+	return &sIOFuncTable;
+#else
+	return 0;
+#endif /* JX9_DISABLE_BUILTIN_FUNC */
+}
+/*
+ * Register the built-in IO streams [i.e: file://, jx9://].
  * Note:
  *  If the engine is compiled with the JX9_DISABLE_BUILTIN_FUNC directive
  *  defined then this function is a no-op.
@@ -41317,117 +42429,7 @@ static int is_jx9_stream(const jx9_io_stream *pStream)
 JX9_PRIVATE sxi32 jx9RegisterIORoutine(jx9_vm *pVm)
 {
 #ifndef JX9_DISABLE_BUILTIN_FUNC
-	      /* VFS functions */
-	static const jx9_builtin_func aVfsFunc[] = {
-		{"chdir",   jx9Vfs_chdir   }, 
-		{"chroot",  jx9Vfs_chroot  }, 
-		{"getcwd",  jx9Vfs_getcwd  }, 
-		{"rmdir",   jx9Vfs_rmdir   }, 
-		{"is_dir",  jx9Vfs_is_dir  }, 
-		{"mkdir",   jx9Vfs_mkdir   }, 
-		{"rename",  jx9Vfs_rename  }, 
-		{"realpath", jx9Vfs_realpath}, 
-		{"sleep",   jx9Vfs_sleep   }, 
-		{"usleep",  jx9Vfs_usleep  }, 
-		{"unlink",  jx9Vfs_unlink  }, 
-		{"delete",  jx9Vfs_unlink  }, 
-		{"chmod",   jx9Vfs_chmod   }, 
-		{"chown",   jx9Vfs_chown   }, 
-		{"chgrp",   jx9Vfs_chgrp   }, 
-		{"disk_free_space", jx9Vfs_disk_free_space  }, 
-		{"disk_total_space", jx9Vfs_disk_total_space}, 
-		{"file_exists", jx9Vfs_file_exists }, 
-		{"filesize",    jx9Vfs_file_size   }, 
-		{"fileatime",   jx9Vfs_file_atime  }, 
-		{"filemtime",   jx9Vfs_file_mtime  }, 
-		{"filectime",   jx9Vfs_file_ctime  }, 
-		{"is_file",     jx9Vfs_is_file  }, 
-		{"is_link",     jx9Vfs_is_link  }, 
-		{"is_readable", jx9Vfs_is_readable   }, 
-		{"is_writable", jx9Vfs_is_writable   }, 
-		{"is_executable", jx9Vfs_is_executable}, 
-		{"filetype",    jx9Vfs_filetype }, 
-		{"stat",        jx9Vfs_stat     }, 
-		{"lstat",       jx9Vfs_lstat    }, 
-		{"getenv",      jx9Vfs_getenv   }, 
-		{"setenv",      jx9Vfs_putenv   }, 
-		{"putenv",      jx9Vfs_putenv   }, 
-		{"touch",       jx9Vfs_touch    }, 
-		{"link",        jx9Vfs_link     }, 
-		{"symlink",     jx9Vfs_symlink  }, 
-		{"umask",       jx9Vfs_umask    }, 
-		{"sys_get_temp_dir", jx9Vfs_sys_get_temp_dir }, 
-		{"get_current_user", jx9Vfs_get_current_user }, 
-		{"getpid",      jx9Vfs_getmypid }, 
-		{"getuid",      jx9Vfs_getmyuid }, 
-		{"getgid",      jx9Vfs_getmygid }, 
-		{"uname",       jx9Vfs_uname}, 
-		     /* Path processing */ 
-		{"dirname",     jx9Builtin_dirname  }, 
-		{"basename",    jx9Builtin_basename }, 
-		{"pathinfo",    jx9Builtin_pathinfo }, 
-		{"strglob",     jx9Builtin_strglob  }, 
-		{"fnmatch",     jx9Builtin_fnmatch  }, 
-		     /* ZIP processing */
-		{"zip_open",    jx9Builtin_zip_open }, 
-		{"zip_close",   jx9Builtin_zip_close}, 
-		{"zip_read",    jx9Builtin_zip_read }, 
-		{"zip_entry_open", jx9Builtin_zip_entry_open }, 
-		{"zip_entry_close", jx9Builtin_zip_entry_close}, 
-		{"zip_entry_name", jx9Builtin_zip_entry_name }, 
-		{"zip_entry_filesize",      jx9Builtin_zip_entry_filesize       }, 
-		{"zip_entry_compressedsize", jx9Builtin_zip_entry_compressedsize }, 
-		{"zip_entry_read", jx9Builtin_zip_entry_read }, 
-		{"zip_entry_reset_cursor", jx9Builtin_zip_entry_reset_cursor}, 
-		{"zip_entry_compressionmethod", jx9Builtin_zip_entry_compressionmethod}
-	};
-	    /* IO stream functions */
-	static const jx9_builtin_func aIOFunc[] = {
-		{"ftruncate", jx9Builtin_ftruncate }, 
-		{"fseek",     jx9Builtin_fseek  }, 
-		{"ftell",     jx9Builtin_ftell  }, 
-		{"rewind",    jx9Builtin_rewind }, 
-		{"fflush",    jx9Builtin_fflush }, 
-		{"feof",      jx9Builtin_feof   }, 
-		{"fgetc",     jx9Builtin_fgetc  }, 
-		{"fgets",     jx9Builtin_fgets  }, 
-		{"fread",     jx9Builtin_fread  }, 
-		{"fgetcsv",   jx9Builtin_fgetcsv}, 
-		{"fgetss",    jx9Builtin_fgetss }, 
-		{"readdir",   jx9Builtin_readdir}, 
-		{"rewinddir", jx9Builtin_rewinddir }, 
-		{"closedir",  jx9Builtin_closedir}, 
-		{"opendir",   jx9Builtin_opendir }, 
-		{"readfile",  jx9Builtin_readfile}, 
-		{"file_get_contents", jx9Builtin_file_get_contents}, 
-		{"file_put_contents", jx9Builtin_file_put_contents}, 
-		{"file",      jx9Builtin_file   }, 
-		{"copy",      jx9Builtin_copy   }, 
-		{"fstat",     jx9Builtin_fstat  }, 
-		{"fwrite",    jx9Builtin_fwrite }, 
-		{"fputs",     jx9Builtin_fwrite }, 
-		{"flock",     jx9Builtin_flock  }, 
-		{"fclose",    jx9Builtin_fclose }, 
-		{"fopen",     jx9Builtin_fopen  }, 
-		{"fpassthru", jx9Builtin_fpassthru }, 
-		{"fputcsv",   jx9Builtin_fputcsv }, 
-		{"fprintf",   jx9Builtin_fprintf }, 
-#if !defined(JX9_DISABLE_HASH_FUNC)
-		{"md5_file",  jx9Builtin_md5_file}, 
-		{"sha1_file", jx9Builtin_sha1_file}, 
-#endif /* JX9_DISABLE_HASH_FUNC */
-		{"parse_ini_file", jx9Builtin_parse_ini_file}, 
-		{"vfprintf",  jx9Builtin_vfprintf}
-	};
 	const jx9_io_stream *pFileStream = 0;
-	sxu32 n = 0;
-	/* Register the functions defined above */
-	for( n = 0 ; n < SX_ARRAYSIZE(aVfsFunc) ; ++n ){
-		jx9_create_function(&(*pVm), aVfsFunc[n].zName, aVfsFunc[n].xFunc, (void *)pVm->pEngine->pVfs);
-	}
-	for( n = 0 ; n < SX_ARRAYSIZE(aIOFunc) ; ++n ){
-		jx9_create_function(&(*pVm), aIOFunc[n].zName, aIOFunc[n].xFunc, pVm);
-	}
 #ifndef JX9_DISABLE_DISK_IO
 	/* Register the file stream if available */
 #ifdef __WINNT__
@@ -41799,6 +42801,191 @@ JX9_PRIVATE sxi32 jx9VmInstallForeignFunction(
 	/* User function successfully installed */
 	return SXRET_OK;
 }
+/* Name of the entry N of a built-in table [zName is the first field of both jx9_builtin_func and jx9_builtin_constant] */
+#define BUILTIN_ENTRY(TABLE, N) ((const void *)&((const char *)(TABLE)->aEntry)[(N) * (TABLE)->nSize])
+#define BUILTIN_NAME(TABLE, N)  (*(const char * const *)BUILTIN_ENTRY(TABLE, N))
+/*
+ * Compare a null terminated built-in name with a lookup key of nLen bytes.
+ */
+static sxi32 VmBuiltinNameCmp(const char *zName, const char *zKey, sxu32 nLen)
+{
+	const unsigned char *zA = (const unsigned char *)zName;
+	const unsigned char *zB = (const unsigned char *)zKey;
+	for(;;){
+		if( nLen < 1 ){
+			return zA[0] == 0 ? 0 : 1;
+		}
+		if( zA[0] != zB[0] ){
+			return (sxi32)zA[0] - (sxi32)zB[0];
+		}
+		zA++;
+		zB++;
+		nLen--;
+	}
+}
+/*
+ * Sort the index of a built-in table by name so that entries can be
+ * looked up with a binary search.
+ * This routine is called only once at library initialization, the
+ * index is then shared read-only by all the virtual machines.
+ */
+JX9_PRIVATE void jx9BuiltinTableSort(const jx9_builtin_table *pTable)
+{
+	const char *zName;
+	sxu32 n, i;
+	if( pTable == 0 ){
+		return;
+	}
+	/* Insertion sort, the tables hold at most a few hundred entries */
+	for( n = 0 ; n < pTable->nEntry ; ++n ){
+		zName = BUILTIN_NAME(pTable, n);
+		i = n;
+		while( i > 0 && 
+			VmBuiltinNameCmp(BUILTIN_NAME(pTable, pTable->aSorted[i - 1]), zName, SyStrlen(zName)) > 0 ){
+			pTable->aSorted[i] = pTable->aSorted[i - 1];
+			i--;
+		}
+		pTable->aSorted[i] = (sxu16)n;
+	}
+}
+/*
+ * Lookup a built-in function or constant by name.
+ * Return a pointer to the table entry [i.e: jx9_builtin_func or jx9_builtin_constant]
+ * on success. NULL otherwise.
+ */
+JX9_PRIVATE const void * jx9BuiltinTableLookup(const jx9_builtin_table *pTable, const char *zName, sxu32 nLen)
+{
+	sxu32 iLow, iHigh, iMid;
+	sxi32 rc;
+	if( pTable == 0 ){
+		return 0;
+	}
+	iLow = 0;
+	iHigh = pTable->nEntry;
+	while( iLow < iHigh ){
+		iMid = (iLow + iHigh) >> 1;
+		rc = VmBuiltinNameCmp(BUILTIN_NAME(pTable, pTable->aSorted[iMid]), zName, nLen);
+		if( rc == 0 ){
+			return BUILTIN_ENTRY(pTable, pTable->aSorted[iMid]);
+		}
+		if( rc < 0 ){
+			iLow = iMid + 1;
+		}else{
+			iHigh = iMid;
+		}
+	}
+	/* No such entry */
+	return 0;
+}
+/*
+ * Built-in function tables shared by all the virtual machines
+ * [i.e: strlen(), count(), fopen(), print, ...] and built-in constants
+ * [i.e: JX9_EOL, JX9_OS, ...].
+ * Filled by jx9VmInitBuiltin() at library initialization.
+ */
+static const jx9_builtin_table *apBuiltinFunc[5];
+static const jx9_builtin_table *pBuiltinConst = 0;
+/*
+ * Install a table of built-in functions specific to the host-application
+ * [i.e: the UnQLite db_* functions] in a given VM.
+ * The table index must be sorted [i.e: jx9BuiltinTableSort()] and the table
+ * must outlive the VM. pUserData is the private data of the table functions.
+ */
+JX9_PRIVATE void jx9VmInstallBuiltinTable(jx9_vm *pVm, const jx9_builtin_table *pTable, void *pUserData)
+{
+	pVm->pHostTable = pTable;
+	pVm->pHostData = pUserData;
+}
+/*
+ * Lookup a built-in function in the host-application table and the
+ * shared tables. On success, the private data the function expects
+ * is stored in *ppUserData when not NULL.
+ */
+static const jx9_builtin_func * VmBuiltinFuncLookup(jx9_vm *pVm, const char *zName, sxu32 nLen, void **ppUserData)
+{
+	const jx9_builtin_table *pTable;
+	const jx9_builtin_func *pFunc;
+	sxu32 n;
+	pTable = pVm->pHostTable;
+	pFunc = (const jx9_builtin_func *)jx9BuiltinTableLookup(pTable, zName, nLen);
+	for( n = 0 ; pFunc == 0 && n < SX_ARRAYSIZE(apBuiltinFunc) ; ++n ){
+		pTable = apBuiltinFunc[n];
+		pFunc = (const jx9_builtin_func *)jx9BuiltinTableLookup(pTable, zName, nLen);
+	}
+	if( pFunc && ppUserData ){
+		switch(pTable->iData){
+		case JX9_BUILTIN_DATA_VM:   *ppUserData = &(*pVm); break;
+		case JX9_BUILTIN_DATA_VFS:  *ppUserData = (void *)pVm->pEngine->pVfs; break;
+		case JX9_BUILTIN_DATA_HOST: *ppUserData = pVm->pHostData; break;
+		default:                    *ppUserData = 0; break;
+		}
+	}
+	return pFunc;
+}
+/*
+ * Lookup a built-in constant.
+ * Note that all built-in constants have access to the calling VM as their private data.
+ */
+static const jx9_builtin_constant * VmBuiltinConstLookup(const char *zName, sxu32 nLen)
+{
+	return (const jx9_builtin_constant *)jx9BuiltinTableLookup(pBuiltinConst, zName, nLen);
+}
+/*
+ * Extract the foreign function with the given name.
+ * Functions installed by the host-application are looked up first, then the built-in
+ * tables. A built-in function is installed in the VM the first time it is called
+ * so that it gets its own call state [i.e: aAux stack].
+ * Return NULL if no such function.
+ */
+static jx9_user_func * VmExtractForeignFunction(jx9_vm *pVm, const SyString *pName)
+{
+	const jx9_builtin_func *pBuiltin;
+	SyHashEntry *pEntry;
+	void *pUserData;
+	pEntry = SyHashGet(&pVm->hHostFunction, (const void *)pName->zString, pName->nByte);
+	if( pEntry == 0 ){
+		pBuiltin = VmBuiltinFuncLookup(&(*pVm), pName->zString, pName->nByte, &pUserData);
+		if( pBuiltin == 0 || 
+			jx9VmInstallForeignFunction(&(*pVm), pName, pBuiltin->xFunc, pUserData) != SXRET_OK ){
+			return 0;
+		}
+		pEntry = SyHashGet(&pVm->hHostFunction, (const void *)pName->zString, pName->nByte);
+		if( pEntry == 0 ){
+			return 0;
+		}
+	}
+	return (jx9_user_func *)pEntry->pUserData;
+}
+/*
+ * Append the names of the entries of a built-in table which are not
+ * shadowed by an entry of the given VM hashtable to the given array.
+ */
+static sxi32 VmBuiltinTableNames(const jx9_builtin_table *pTable, SyHash *pShadow, jx9_value *pArray)
+{
+	const char *zName;
+	jx9_value sName;
+	sxu32 n, nLen;
+	sxi32 rc;
+	if( pTable == 0 ){
+		return SXRET_OK;
+	}
+	for( n = 0 ; n < pTable->nEntry ; ++n ){
+		zName = BUILTIN_NAME(pTable, pTable->aSorted[n]);
+		nLen = SyStrlen(zName);
+		if( SyHashGet(pShadow, (const void *)zName, nLen) != 0 ){
+			/* Already reported */
+			continue;
+		}
+		jx9MemObjInitFromString(pArray->pVm, &sName, 0);
+		jx9MemObjStringAppend(&sName, zName, nLen);
+		rc = jx9_array_add_elem(pArray, 0/* Automatic index assign */, &sName); /* Will make it's own copy */
+		jx9MemObjRelease(&sName);
+		if( rc != SXRET_OK ){
+			return rc;
+		}
+	}
+	return SXRET_OK;
+}
 /*
  * Initialize a VM function.
  */
@@ -42497,8 +43684,6 @@ static jx9_value * VmNewOperandStack(
 	/* Ready for bytecode execution */
 	return pStack;
 }
-/* Forward declaration */
-static sxi32 VmRegisterSpecialFunction(jx9_vm *pVm);
 /*
  * Prepare the Virtual Machine for bytecode execution.
  * This routine gets called by the JX9 engine after
@@ -42533,22 +43718,18 @@ JX9_PRIVATE sxi32 jx9VmMakeReady(
 	 * private data. */
 	pVm->sVmConsumer.xConsumer = jx9VmBlobConsumer;
 	pVm->sVmConsumer.pUserData = &pVm->sConsumer;
-	/* Register special functions first [i.e: print, func_get_args(), die, etc.] */
-	rc = VmRegisterSpecialFunction(&(*pVm));
-	if( rc != SXRET_OK ){
-		/* Don't worry about freeing memory, everything will be released shortly */
-		return rc;
-	}
 	/* Create superglobals [i.e: $GLOBALS, $_GET, $_POST...] */
 	rc = jx9HashmapLoadBuiltin(&(*pVm));
 	if( rc != SXRET_OK ){
 		/* Don't worry about freeing memory, everything will be released shortly */
 		return rc;
 	}
-	/* Register built-in constants [i.e: JX9_EOL, JX9_OS...] */
-	jx9RegisterBuiltInConstant(&(*pVm));
-	/* Register built-in functions [i.e: is_null(), array_diff(), strlen(), etc.] */
-	jx9RegisterBuiltInFunction(&(*pVm));
+	/* Register the built-in IO streams [i.e: file://, jx9://].
+	 * Note that built-in constants [i.e: JX9_EOL, JX9_OS...] and functions
+	 * [i.e: is_null(), array_diff(), strlen(), etc.] are not registered here, they
+	 * are looked up in the shared built-in tables [i.e: jx9VmInitBuiltin()].
+	 */
+	jx9RegisterIORoutine(&(*pVm));
 	/* VM is ready for bytecode execution */
 	return SXRET_OK;
 }
@@ -43603,16 +44784,30 @@ case JX9_OP_LOADC: {
 	pTos++;
 	if( (pObj = (jx9_value *)SySetAt(&pVm->aLitObj, pInstr->iP2)) != 0 ){
 		if( pInstr->iP1 == 1 && SyBlobLength(&pObj->sBlob) <= 64 ){
+			const jx9_builtin_constant *pBuiltin;
+			ProcConstant xExpand = 0;
+			void *pUserData = 0;
 			SyHashEntry *pEntry;
 			/* Candidate for expansion via user defined callbacks */
 			pEntry = SyHashGet(&pVm->hConstant, SyBlobData(&pObj->sBlob), SyBlobLength(&pObj->sBlob));
 			if( pEntry ){
 				jx9_constant *pCons = (jx9_constant *)pEntry->pUserData;
+				xExpand = pCons->xExpand;
+				pUserData = pCons->pUserData;
+			}else{
+				/* Built-in constant [i.e: JX9_EOL, JX9_OS, ...] */
+				pBuiltin = VmBuiltinConstLookup((const char *)SyBlobData(&pObj->sBlob), SyBlobLength(&pObj->sBlob));
+				if( pBuiltin ){
+					xExpand = pBuiltin->xExpand;
+					pUserData = &(*pVm);
+				}
+			}
+			if( xExpand ){
 				/* Set a NULL default value */
 				MemObjSetType(pTos, MEMOBJ_NULL);
 				SyBlobReset(&pTos->sBlob);
 				/* Invoke the callback and deal with the expanded value */
-				pCons->xExpand(pTos, pCons->pUserData);
+				xExpand(pTos, pUserData);
 				/* Mark as constant */
 				pTos->nIdx = SXU32_HIGH;
 				break;
@@ -43804,7 +44999,7 @@ case JX9_OP_LOAD_IDX: {
 			rc = jx9HashmapInsert(pMap, pIdx, 0);
 			if( rc == SXRET_OK ){
 				/* Point to the last inserted entry */
-				pNode = pMap->pLast;
+				pNode = jx9HashmapGetLastEntry(pMap);
 			}
 		}
 	}
@@ -45508,9 +46703,9 @@ case JX9_OP_CALL: {
 		jx9_user_func *pFunc; 
 		jx9_context sCtx;
 		jx9_value sRet;
-		/* Look for an installed foreign function */
-		pEntry = SyHashGet(&pVm->hHostFunction, (const void *)sName.zString, sName.nByte);
-		if( pEntry == 0 ){
+		/* Look for an installed or a built-in foreign function */
+		pFunc = VmExtractForeignFunction(&(*pVm), &sName);
+		if( pFunc == 0 ){
 			/* Call to undefined function */
 			VmErrorFormat(&(*pVm), JX9_CTX_WARNING, "Call to undefined function '%z', JX9 is returning NULL.", &sName);
 			/* Pop given arguments */
@@ -45521,7 +46716,6 @@ case JX9_OP_CALL: {
 			jx9MemObjRelease(pTos);
 			break;
 		}
-		pFunc = (jx9_user_func *)pEntry->pUserData;
 		/* Start collecting function arguments */
 		SySetReset(&aArg);
 		while( pArg < pTos ){
@@ -45561,6 +46755,17 @@ case JX9_OP_CONSUME: {
 	pCur = pOut;
 	/* Start the consume process  */
 	while( pOut <= pTos ){
+		if( pOut->iFlags & MEMOBJ_HASHMAP ){
+			/* Stream the JSON representation instead of building it in memory */
+			rc = jx9JsonStream(&(*pVm),pOut);
+			jx9MemObjRelease(pOut);
+			if( rc == SXERR_ABORT ){
+				/* Output consumer callback request an operation abort. */
+				goto Abort;
+			}
+			pOut++;
+			continue;
+		}
 		/* Force a string cast */
 		if( (pOut->iFlags & MEMOBJ_STRING) == 0 ){
 			jx9MemObjToString(pOut);
@@ -45974,7 +47179,8 @@ static int vm_builtin_func_exists(jx9_context *pCtx, int nArg, jx9_value **apArg
 	res = 0;
 	/* Perform the lookup */
 	if( SyHashGet(&pVm->hFunction, (const void *)zName, (sxu32)nLen) != 0 ||
-		SyHashGet(&pVm->hHostFunction, (const void *)zName, (sxu32)nLen) != 0 ){
+		SyHashGet(&pVm->hHostFunction, (const void *)zName, (sxu32)nLen) != 0 ||
+		VmBuiltinFuncLookup(&(*pVm), zName, (sxu32)nLen, 0) != 0 ){
 			/* Function is defined */
 			res = 1;
 	}
@@ -45996,7 +47202,8 @@ JX9_PRIVATE int jx9VmIsCallable(jx9_vm *pVm, jx9_value *pValue)
 		zName = jx9_value_to_string(pValue, &nLen);
 		/* Perform the lookup */
 		if( SyHashGet(&pVm->hFunction, (const void *)zName, (sxu32)nLen) != 0 ||
-			SyHashGet(&pVm->hHostFunction, (const void *)zName, (sxu32)nLen) != 0 ){
+			SyHashGet(&pVm->hHostFunction, (const void *)zName, (sxu32)nLen) != 0 ||
+			VmBuiltinFuncLookup(&(*pVm), zName, (sxu32)nLen, 0) != 0 ){
 				/* Function is callable */
 				res = 1;
 		}
@@ -46067,6 +47274,7 @@ static int VmHashFuncStep(SyHashEntry *pEntry, void *pUserData)
 static int vm_builtin_get_defined_func(jx9_context *pCtx, int nArg, jx9_value **apArg)
 {
 	jx9_value *pArray;
+	sxu32 n;
 	/* NOTE:
 	 * Don't worry about freeing memory here, every allocated resource will be released
 	 * automatically by the engine as soon we return from this foreign function.
@@ -46081,6 +47289,11 @@ static int vm_builtin_get_defined_func(jx9_context *pCtx, int nArg, jx9_value **
 	}
 	/* Fill with the appropriate information */
 	SyHashForEach(&pCtx->pVm->hHostFunction,VmHashFuncStep,pArray);
+	/* Built-in functions not yet called by this VM */
+	VmBuiltinTableNames(pCtx->pVm->pHostTable, &pCtx->pVm->hHostFunction, pArray);
+	for( n = 0 ; n < SX_ARRAYSIZE(apBuiltinFunc) ; ++n ){
+		VmBuiltinTableNames(apBuiltinFunc[n], &pCtx->pVm->hHostFunction, pArray);
+	}
 	/* Fill with the appropriate information */
 	SyHashForEach(&pCtx->pVm->hFunction, VmHashFuncStep,pArray);
 	/* Return a copy of the array array */
@@ -46204,7 +47417,8 @@ static int vm_builtin_defined(jx9_context *pCtx, int nArg, jx9_value **apArg)
 	/* Extract constant name */
 	zName = jx9_value_to_string(apArg[0], &nLen);
 	/* Perform the lookup */
-	if( nLen > 0 && SyHashGet(&pCtx->pVm->hConstant, (const void *)zName, (sxu32)nLen) != 0 ){
+	if( nLen > 0 && (SyHashGet(&pCtx->pVm->hConstant, (const void *)zName, (sxu32)nLen) != 0 ||
+		VmBuiltinConstLookup(zName, (sxu32)nLen) != 0) ){
 		/* Already defined */
 		res = 1;
 	}
@@ -46251,6 +47465,7 @@ static int vm_builtin_get_defined_constants(jx9_context *pCtx, int nArg, jx9_val
 	}
 	/* Fill the array with the defined constants */
 	SyHashForEach(&pCtx->pVm->hConstant, VmHashConstStep, pArray);
+	VmBuiltinTableNames(pBuiltinConst, &pCtx->pVm->hConstant, pArray);
 	/* Return the created array */
 	jx9_result_value(pCtx, pArray);
 	return SXRET_OK;
@@ -46404,6 +47619,14 @@ static int vm_builtin_print(jx9_context *pCtx, int nArg,jx9_value **apArg)
 	pVm = pCtx->pVm;
 	/* Output */
 	for( i = 0 ; i < nArg ; ++i ){
+		if( jx9_value_is_json_array(apArg[i]) ){
+			/* Stream the JSON representation instead of building it in memory */
+			if( jx9JsonStream(pVm,apArg[i]) == SXERR_ABORT ){
+				/* Output consumer callback request an operation abort */
+				return JX9_ABORT;
+			}
+			continue;
+		}
 		zData = jx9_value_to_string(apArg[i], &nDataLen);
 		if( nDataLen > 0 ){
 			rc = pVm->sVmConsumer.xConsumer((const void *)zData, (unsigned int)nDataLen, pVm->sVmConsumer.pUserData);
@@ -47854,24 +49077,38 @@ static const jx9_builtin_func aVmFunc[] = {
 	{ "include",      vm_builtin_include          }, 
 	{ "import", vm_builtin_import     }
 };
+/* Note that these special functions have access
+ * to the underlying virtual machine as their
+ * private data.
+ */
+static sxu16 aVmFuncIdx[SX_ARRAYSIZE(aVmFunc)];
+static const jx9_builtin_table sVmFuncTable = {
+	aVmFunc, SX_ARRAYSIZE(aVmFunc), sizeof(jx9_builtin_func), JX9_BUILTIN_DATA_VM, aVmFuncIdx
+};
 /*
- * Register the built-in VM functions defined above.
+ * Build the shared built-in function and constant tables.
+ * This routine is called only once by the library initialization
+ * routine [i.e: Jx9CoreInitialize()]. The tables are then shared
+ * read-only by all the virtual machines.
  */
-static sxi32 VmRegisterSpecialFunction(jx9_vm *pVm)
+JX9_PRIVATE void jx9VmInitBuiltin(void)
 {
-	sxi32 rc;
 	sxu32 n;
-	for( n = 0 ; n < SX_ARRAYSIZE(aVmFunc) ; ++n ){
-		/* Note that these special functions have access
-		 * to the underlying virtual machine as their
-		 * private data.
-		 */
-		rc = jx9_create_function(&(*pVm), aVmFunc[n].zName, aVmFunc[n].xFunc, &(*pVm));
-		if( rc != SXRET_OK ){
-			return rc;
-		}
-	}
-	return SXRET_OK;
+	/* Special functions [i.e: print, func_get_args(), die, etc.] */
+	apBuiltinFunc[0] = &sVmFuncTable;
+	/* Built-in functions [i.e: is_null(), strlen(), etc.] */
+	apBuiltinFunc[1] = jx9ExportBuiltinFunction();
+	/* Hashmap functions [i.e: sort(), count(), array_diff(), ...] */
+	apBuiltinFunc[2] = jx9ExportHashmapFunction();
+	/* IO functions [i.e: fread(), fwrite(), chdir(), mkdir(), file(), ...] */
+	apBuiltinFunc[3] = jx9ExportVfsFunction();
+	apBuiltinFunc[4] = jx9ExportIOFunction();
+	for( n = 0 ; n < SX_ARRAYSIZE(apBuiltinFunc) ; ++n ){
+		jx9BuiltinTableSort(apBuiltinFunc[n]);
+	}
+	/* Built-in constants [i.e: JX9_EOL, JX9_OS...] */
+	pBuiltinConst = jx9ExportBuiltinConstant();
+	jx9BuiltinTableSort(pBuiltinConst);
 }
 #ifndef JX9_DISABLE_BUILTIN_FUNC
 /*
@@ -48748,9 +49985,25 @@ static sxi32 VmGetNextLine(SyString *pCursor, SyString *pCurrent)
 ** The maximum number of bytes of payload allowed on a single overflow page.
 */
 #define L_HASH_OVERFLOW_SIZE(PageSize) (PageSize-8)
+/*
+ * Compressed overflow payload.
+ * When the most significant bit of the 8 byte data length is set, the overflow data is
+ * compressed. The next 31 bits hold the compressed length and the low 32 bits the
+ * uncompressed length of the record data.
+ */
+#define L_HASH_CELL_ZIP        ((sxu64)1 << 63)
+#define L_HASH_ZIP_MIN_DATA    64        /* Don't bother compressing smaller payloads */
+#define L_HASH_ZIP_MAX_DATA    SXI32_HIGH
+#define L_HASH_ZIP_HASH_BITS   10        /* 1024 entries match finder */
+#define L_HASH_ZIP_MAX_LIT     32        /* Longest literal run */
+#define L_HASH_ZIP_MAX_OFF     8192      /* Farthest back-reference */
+#define L_HASH_ZIP_MAX_REF     264       /* Longest back-reference */
+#define L_HASH_ZIP_HASH(Z) (((((sxu32)(Z)[0] << 16) | ((sxu32)(Z)[1] << 8) | (Z)[2]) * 2654435761U) >> (32 - L_HASH_ZIP_HASH_BITS))
 /* Forward declaration */
 typedef struct lhash_kv_engine lhash_kv_engine;
 typedef struct lhpage lhpage;
+static sxu32 lhash_bin_hash(const void *pSrc,sxu32 nLen);
+static sxu32 lhash_xx_hash(const void *pSrc,sxu32 nLen);
 /*
  * Each record in the database is identified either in-memory or in
  * disk by an instance of the following structure.
@@ -48769,6 +50022,7 @@ struct lhcell
 	sxu16 iStart;      /* Offset of this cell */
 	pgno iDataPage;    /* Data page number when overflow */
 	sxu16 iDataOfft;   /* Offset of the data in iDataPage */
+	sxu32 nZip;        /* Compressed overflow data length if any (See L_HASH_CELL_ZIP) */
 	SyBlob sKey;       /* Record key for fast lookup (Kept in-memory if < 256KB ) */
 	lhcell *pNext,*pPrev;         /* Linked list of the loaded memory cells */
 	lhcell *pNextCol,*pPrevCol;   /* Collison chain  */
@@ -48847,6 +50101,10 @@ struct lhash_kv_engine
 	pgno max_split_bucket;        /* Maximum split bucket: MUST BE A POWER OF TWO */
 	pgno nmax_split_nucket;       /* Next maximum split bucket (1 << nMsb): In-memory only */
 	sxu32 nMagic;                 /* Magic number to identify a valid linear hash disk database */
+	int bZip;                     /* True to compress overflow payloads (UNQLITE_KV_CONFIG_COMPRESS) */
+	sxu32 *aZipHash;              /* Compressor match finder: In-memory only */
+	sxu64 nZipIn;                 /* Total overflow data submitted for compression */
+	sxu64 nZipOut;                /* Total overflow data written to disk after compression */
 };
 /*
  * Given a logical bucket number, return the record associated with it.
@@ -49175,6 +50433,182 @@ static lhcell * lhFindCell(
 	/* No such entry */
 	return 0;
 }
+/*
+ * Compress a record payload using a compact LZ77 codec (LZF stream format).
+ * Each control byte either introduce a run of up to 32 literals (values 0..31)
+ * or a back-reference whose length is stored in the 3 high bits (plus an
+ * extra byte when they are all set) and the distance in the 5 low bits plus
+ * the next byte.
+ * Return the compressed length or zero if the output would exceed nOut bytes.
+ */
+static sxu32 lhZipCompress(sxu32 *aHash,const unsigned char *zIn,sxu32 nIn,unsigned char *zOut,sxu32 nOut)
+{
+	const unsigned char *zPtr = zIn;
+	const unsigned char *zEnd = &zIn[nIn];
+	unsigned char *zOp = zOut;
+	unsigned char *zOpEnd = &zOut[nOut];
+	sxu32 nLit = 0;
+	if( nOut < 1 ){
+		return 0;
+	}
+	SyZero(aHash,(sxu32)(sizeof(sxu32) << L_HASH_ZIP_HASH_BITS));
+	zOp++; /* Control byte of the first literal run */
+	while( zPtr < zEnd ){
+		if( zPtr + 2 < zEnd ){
+			sxu32 iHash = L_HASH_ZIP_HASH(zPtr);
+			sxu32 iRef = aHash[iHash];
+			aHash[iHash] = (sxu32)(zPtr - zIn) + 1; /* Zero means empty slot */
+			if( iRef > 0 ){
+				const unsigned char *zRef = &zIn[iRef - 1];
+				sxu32 iOff = (sxu32)(zPtr - zRef) - 1;
+				if( iOff < L_HASH_ZIP_MAX_OFF && zRef[0] == zPtr[0] && zRef[1] == zPtr[1] && zRef[2] == zPtr[2] ){
+					sxu32 nMax = (sxu32)(zEnd - zPtr);
+					sxu32 nLen = 3;
+					if( nMax > L_HASH_ZIP_MAX_REF ){
+						nMax = L_HASH_ZIP_MAX_REF;
+					}
+					while( nLen < nMax && zRef[nLen] == zPtr[nLen] ){
+						nLen++;
+					}
+					if( zOp + 4 > zOpEnd ){
+						/* Won't fit */
+						return 0;
+					}
+					/* Terminate the pending literal run */
+					if( nLit > 0 ){
+						zOp[-(int)nLit - 1] = (unsigned char)(nLit - 1);
+						nLit = 0;
+					}else{
+						zOp--;
+					}
+					zPtr += nLen;
+					nLen -= 2;
+					if( nLen < 7 ){
+						*zOp++ = (unsigned char)((iOff >> 8) + (nLen << 5));
+					}else{
+						*zOp++ = (unsigned char)((iOff >> 8) + (7 << 5));
+						*zOp++ = (unsigned char)(nLen - 7);
+					}
+					*zOp++ = (unsigned char)iOff;
+					zOp++; /* Control byte of the next literal run */
+					continue;
+				}
+			}
+		}
+		/* Literal */
+		if( zOp >= zOpEnd ){
+			return 0;
+		}
+		*zOp++ = *zPtr++;
+		nLit++;
+		if( nLit >= L_HASH_ZIP_MAX_LIT ){
+			zOp[-(int)nLit - 1] = (unsigned char)(nLit - 1);
+			nLit = 0;
+			if( zOp >= zOpEnd ){
+				return 0;
+			}
+			zOp++;
+		}
+	}
+	if( nLit > 0 ){
+		zOp[-(int)nLit - 1] = (unsigned char)(nLit - 1);
+	}else{
+		zOp--; /* Unused control byte */
+	}
+	return (sxu32)(zOp - zOut);
+}
+/*
+ * Decompress a payload previously compressed by lhZipCompress().
+ * The output must be exactly nOut bytes long, anything else is reported as corruption.
+ */
+static int lhZipDecompress(const unsigned char *zIn,sxu32 nIn,unsigned char *zOut,sxu32 nOut)
+{
+	const unsigned char *zEnd = &zIn[nIn];
+	unsigned char *zOp = zOut;
+	unsigned char *zOpEnd = &zOut[nOut];
+	while( zIn < zEnd ){
+		sxu32 c = *zIn++;
+		if( c < L_HASH_ZIP_MAX_LIT ){
+			/* Literal run */
+			c++;
+			if( (sxu32)(zEnd - zIn) < c || (sxu32)(zOpEnd - zOp) < c ){
+				return UNQLITE_CORRUPT;
+			}
+			SyMemcpy((const void *)zIn,(void *)zOp,c);
+			zIn += c;
+			zOp += c;
+		}else{
+			const unsigned char *zRef;
+			sxu32 nLen = c >> 5;
+			sxu32 iOff;
+			if( nLen == 7 ){
+				if( zIn >= zEnd ){
+					return UNQLITE_CORRUPT;
+				}
+				nLen += *zIn++;
+			}
+			nLen += 2;
+			if( zIn >= zEnd ){
+				return UNQLITE_CORRUPT;
+			}
+			iOff = ((c & 0x1f) << 8) + *zIn++ + 1;
+			if( (sxu32)(zOp - zOut) < iOff || (sxu32)(zOpEnd - zOp) < nLen ){
+				return UNQLITE_CORRUPT;
+			}
+			/* Overlapping copy */
+			zRef = zOp - iOff;
+			while( nLen-- > 0 ){
+				*zOp++ = *zRef++;
+			}
+		}
+	}
+	return zOp == zOpEnd ? UNQLITE_OK : UNQLITE_CORRUPT;
+}
+/*
+ * Try to compress the data of a record stored on overflow pages.
+ * On success, the compressed payload is stored in pOut and UNQLITE_OK is returned.
+ * Any other return value means the data should be stored as is.
+ */
+static int lhCellZipData(lhash_kv_engine *pEngine,const void *pData,sxu64 nData,SyBlob *pOut)
+{
+	sxu32 nMax,nZip;
+	if( !pEngine->bZip || nData < L_HASH_ZIP_MIN_DATA || nData > L_HASH_ZIP_MAX_DATA ){
+		/* Don't bother */
+		return UNQLITE_DONE;
+	}
+	if( pEngine->aZipHash == 0 ){
+		pEngine->aZipHash = (sxu32 *)SyMemBackendAlloc(&pEngine->sAllocator,(sxu32)(sizeof(sxu32) << L_HASH_ZIP_HASH_BITS));
+		if( pEngine->aZipHash == 0 ){
+			/* Not so fatal, store uncompressed */
+			return UNQLITE_NOMEM;
+		}
+	}
+	/* Must save at least one eighth to be worth it */
+	nMax = (sxu32)(nData - (nData >> 3));
+	SyBlobReset(pOut);
+	if( SXRET_OK != SyBlobAppend(pOut,(const void *)0,nMax) ){ /* Reserve space only */
+		return UNQLITE_NOMEM;
+	}
+	nZip = lhZipCompress(pEngine->aZipHash,(const unsigned char *)pData,(sxu32)nData,(unsigned char *)SyBlobData(pOut),nMax);
+	pEngine->nZipIn += nData;
+	if( nZip < 1 ){
+		pEngine->nZipOut += nData;
+		return UNQLITE_DONE;
+	}
+	SyBlobLength(pOut) = nZip;
+	pEngine->nZipOut += nZip;
+	return UNQLITE_OK;
+}
+/*
+ * Return the 8 byte data length of a cell as stored on disk.
+ */
+static sxu64 lhCellDataField(lhcell *pCell)
+{
+	if( pCell->nZip > 0 ){
+		return L_HASH_CELL_ZIP | ((sxu64)pCell->nZip << 32) | (pCell->nData & SXU32_HIGH);
+	}
+	return pCell->nData;
+}
 /*
  * Parse a raw cell fetched from disk.
  */
@@ -49211,6 +50645,11 @@ static int lhParseOneCell(lhpage *pPage,const unsigned char *zRaw,const unsigned
 	pCell->iNext = iNext;
 	pCell->nKey  = nKey;
 	pCell->nData = nData;
+	if( nData & L_HASH_CELL_ZIP ){
+		/* Compressed overflow payload */
+		pCell->nZip  = (sxu32)((nData >> 32) & SXI32_HIGH);
+		pCell->nData = nData & SXU32_HIGH;
+	}
 	pCell->nHash = iHash;
 	/* Overflow page if any */
 	SyBigEndianUnpack64(zRaw,&pCell->iOvfl);
@@ -49379,6 +50818,10 @@ static int lhLoadPage(lhash_kv_engine *pEngine,pgno pnum,lhpage *pMaster,lhpage
 	if( pRaw->pUserData ){
 		/* The page is already parsed and loaded in memory. Point to it */
 		pPage = (lhpage *)pRaw->pUserData;
+	}else if( pEngine->pIo->xCacheOnly(pEngine->pIo->pHandle) ){
+		/* Shared reader, parsing the page is left to an exclusive one */
+		pEngine->pIo->xPageUnref(pRaw);
+		return UNQLITE_LOCKED;
 	}else{
 		/* Allocate a new page */
 		pPage = lhNewPage(pEngine,pRaw,pMaster);
@@ -49437,6 +50880,10 @@ static int lhConsumeCellkey(
 		unqlite_page *pOvfl;
 		int data_offset = 0;
 		pgno iOvfl;
+		if( pEngine->pIo->xCacheOnly(pEngine->pIo->pHandle) ){
+			/* Overflow pages are not kept in the cache */
+			return UNQLITE_LOCKED;
+		}
 		/* Overflow page */
 		iOvfl = pCell->iOvfl;
 		/* Total usable bytes in an overflow page */
@@ -49491,6 +50938,72 @@ static int lhConsumeCellkey(
 	}
 	return rc;
 }
+/*
+ * Consume nData bytes of overflow data starting at the data page of the given cell.
+ */
+static int lhConsumeOvflData(
+	lhcell *pCell, /* Target cell */
+	sxu64 nData,   /* Amount of data to consume */
+	int (*xConsumer)(const void *,unsigned int,void *), /* Data consumer callback */
+	void *pUserData /* Last argument to xConsumer() */
+	)
+{
+	lhash_kv_engine *pEngine = pCell->pPage->pHash;
+	const unsigned char *zPayload;
+	unqlite_page *pOvfl;
+	int fix_offset = 0;
+	sxu32 nByte;
+	pgno iOvfl;
+	int rc;
+	/* Overflow page where data is stored */
+	iOvfl = pCell->iDataPage;
+	for(;;){
+		if( iOvfl == 0 || nData < 1 ){
+			/* no more overflow page */
+			break;
+		}
+		/* Point to the overflow page */
+		rc = pEngine->pIo->xGet(pEngine->pIo->pHandle,iOvfl,&pOvfl);
+		if( rc != UNQLITE_OK ){
+			return rc;
+		}
+		/* Point to the raw content */
+		zPayload = pOvfl->zData;
+		if( !fix_offset ){
+			/* Point to the data */
+			zPayload += pCell->iDataOfft;
+			nByte = pEngine->iPageSize - pCell->iDataOfft;
+			fix_offset = 1;
+		}else{
+			zPayload += 8;
+			/* Total usable bytes in an overflow page */
+			nByte = L_HASH_OVERFLOW_SIZE(pEngine->iPageSize);
+		}
+		/* Consume the data */
+		if( nData <= (sxu64)nByte ){
+			rc = xConsumer((const void *)zPayload,(unsigned int)nData,pUserData);
+			if( rc != UNQLITE_OK ){
+				pEngine->pIo->xPageUnref(pOvfl);
+				return UNQLITE_ABORT;
+			}
+			nData = 0;
+		}else{
+			if( nByte > 0 ){
+				rc = xConsumer((const void *)zPayload,nByte,pUserData);
+				if( rc != UNQLITE_OK ){
+					pEngine->pIo->xPageUnref(pOvfl);
+					return UNQLITE_ABORT;
+				}
+				nData -= nByte;
+			}
+		}
+		/* Next overflow page in the chain */
+		SyBigEndianUnpack64(pOvfl->zData,&iOvfl);
+		/* Unref the page */
+		pEngine->pIo->xPageUnref(pOvfl);
+	}
+	return UNQLITE_OK;
+}
 /*
  * Given a cell, Consume its data by invoking the given callback for each extracted chunk.
  */
@@ -49506,6 +51019,10 @@ static int lhConsumeCellData(
 	int rc;
 	/* Point to the payload area */
 	zPayload = &zRaw[pCell->iStart];
+	if( pCell->iOvfl != 0 && pPage->pHash->pIo->xCacheOnly(pPage->pHash->pIo->pHandle) ){
+		/* Overflow pages are not kept in the cache */
+		return UNQLITE_LOCKED;
+	}
 	if( pCell->iOvfl == 0 ){
 		/* Best scenario, consume the data directly without any overflow page */
 		zPayload += L_HASH_CELL_SZ + pCell->nKey;
@@ -49513,61 +51030,38 @@ static int lhConsumeCellData(
 		if( rc != UNQLITE_OK ){
 			rc = UNQLITE_ABORT;
 		}
-	}else{
-		lhash_kv_engine *pEngine = pPage->pHash;
-		sxu64 nData = pCell->nData;
-		unqlite_page *pOvfl;
-		int fix_offset = 0;
-		sxu32 nByte;
-		pgno iOvfl;
-		/* Overflow page where data is stored */
-		iOvfl = pCell->iDataPage;
-		for(;;){
-			if( iOvfl == 0 || nData < 1 ){
-				/* no more overflow page */
-				break;
+	}else if( pCell->nZip > 0 ){
+		SyBlob sZip,sData;
+		/* Compressed payload, collect and inflate it first */
+		SyBlobInit(&sZip,&pPage->pHash->sAllocator);
+		SyBlobInit(&sData,&pPage->pHash->sAllocator);
+		rc = lhConsumeOvflData(pCell,pCell->nZip,unqliteDataConsumer,&sZip);
+		if( rc == UNQLITE_OK && SyBlobLength(&sZip) != pCell->nZip ){
+			rc = UNQLITE_CORRUPT;
+		}
+		if( rc == UNQLITE_OK ){
+			rc = SyBlobAppend(&sData,(const void *)0,(sxu32)pCell->nData); /* Reserve space only */
+			if( rc != SXRET_OK ){
+				rc = UNQLITE_NOMEM;
 			}
-			/* Point to the overflow page */
-			rc = pEngine->pIo->xGet(pEngine->pIo->pHandle,iOvfl,&pOvfl);
+		}
+		if( rc == UNQLITE_OK ){
+			rc = lhZipDecompress((const unsigned char *)SyBlobData(&sZip),pCell->nZip,
+				(unsigned char *)SyBlobData(&sData),(sxu32)pCell->nData);
 			if( rc != UNQLITE_OK ){
-				return rc;
-			}
-			/* Point to the raw content */
-			zPayload = pOvfl->zData;
-			if( !fix_offset ){
-				/* Point to the data */
-				zPayload += pCell->iDataOfft;
-				nByte = pEngine->iPageSize - pCell->iDataOfft;
-				fix_offset = 1;
-			}else{
-				zPayload += 8;
-				/* Total usable bytes in an overflow page */
-				nByte = L_HASH_OVERFLOW_SIZE(pEngine->iPageSize);
+				pPage->pHash->pIo->xErr(pPage->pHash->pIo->pHandle,"Corrupt compressed payload");
 			}
-			/* Consume the data */
-			if( nData <= (sxu64)nByte ){
-				rc = xConsumer((const void *)zPayload,(unsigned int)nData,pUserData);
-				if( rc != UNQLITE_OK ){
-					pEngine->pIo->xPageUnref(pOvfl);
-					return UNQLITE_ABORT;
-				}
-				nData = 0;
-			}else{
-				if( nByte > 0 ){
-					rc = xConsumer((const void *)zPayload,nByte,pUserData);
-					if( rc != UNQLITE_OK ){
-						pEngine->pIo->xPageUnref(pOvfl);
-						return UNQLITE_ABORT;
-					}
-					nData -= nByte;
-				}
+		}
+		if( rc == UNQLITE_OK ){
+			rc = xConsumer(SyBlobData(&sData),(sxu32)pCell->nData,pUserData);
+			if( rc != UNQLITE_OK ){
+				rc = UNQLITE_ABORT;
 			}
-			/* Next overflow page in the chain */
-			SyBigEndianUnpack64(pOvfl->zData,&iOvfl);
-			/* Unref the page */
-			pEngine->pIo->xPageUnref(pOvfl);
 		}
-		rc = UNQLITE_OK;
+		SyBlobRelease(&sData);
+		SyBlobRelease(&sZip);
+	}else{
+		rc = lhConsumeOvflData(pCell,pCell->nData,xConsumer,pUserData);
 	}
 	return rc;
 }
@@ -49593,9 +51087,13 @@ static int lhash_read_header(lhash_kv_engine *pEngine,unqlite_page *pHeader)
 	zRaw += 4;
 	/* Sanity check */
 	if( pEngine->xHash(L_HASH_WORD,sizeof(L_HASH_WORD)-1) != nHash ){
-		/* Different hash function */
-		pEngine->pIo->xErr(pEngine->pIo->pHandle,"Invalid hash function");
-		return UNQLITE_INVALID;
+		if( pEngine->xHash != lhash_xx_hash || lhash_bin_hash(L_HASH_WORD,sizeof(L_HASH_WORD)-1) != nHash ){
+			/* Different hash function */
+			pEngine->pIo->xErr(pEngine->pIo->pHandle,"Invalid hash function");
+			return UNQLITE_INVALID;
+		}
+		/* Database image created with the legacy DJB hash, keep using it */
+		pEngine->xHash = lhash_bin_hash;
 	}
 	/* List of free pages */
 	SyBigEndianUnpack64(zRaw,&pEngine->nFreeList);
@@ -49649,6 +51147,20 @@ static int lhash_read_header(lhash_kv_engine *pEngine,unqlite_page *pHeader)
 	/* All done */
 	return UNQLITE_OK;
 }
+/*
+ * Acquire the first page (hash Header) so that everything gets loaded autmatically.
+ * The header pointer is left untouched if it did not change (concurrent readers).
+ */
+static int lhReadHeaderPage(lhash_kv_engine *pEngine)
+{
+	unqlite_page *pHeader;
+	int rc;
+	rc = pEngine->pIo->xGet(pEngine->pIo->pHandle,1,&pHeader);
+	if( rc == UNQLITE_OK && pEngine->pHeader != pHeader ){
+		pEngine->pHeader = pHeader;
+	}
+	return rc;
+}
 /*
  * Perform a record lookup.
  */
@@ -49665,8 +51177,12 @@ static int lhRecordLookup(
 	pgno iBucket;
 	sxu32 nHash;
 	int rc;
+	if( nByte > 262144 /* 256 KB */ && pEngine->pIo->xCacheOnly(pEngine->pIo->pHandle) ){
+		/* Large keys are compared against their overflow pages */
+		return UNQLITE_LOCKED;
+	}
 	/* Acquire the first page (hash Header) so that everything gets loaded autmatically */
-	rc = pEngine->pIo->xGet(pEngine->pIo->pHandle,1,&pEngine->pHeader);
+	rc = lhReadHeaderPage(pEngine);
 	if( rc != UNQLITE_OK ){
 		return rc;
 	}
@@ -49830,6 +51346,12 @@ static int lhPageDefragment(lhpage *pPage)
 	lhash_kv_engine *pEngine = pPage->pHash;
 	unsigned char *zTmp,*zPtr,*zEnd,*zPayload;
 	lhcell *pCell;
+	int rc;
+	/* Acquire a writer lock on this page */
+	rc = pEngine->pIo->xWrite(pPage->pRaw);
+	if( rc != UNQLITE_OK ){
+		return rc;
+	}
 	/* Get a temporary page from the pager. This opertaion never fail */
 	zTmp = pEngine->pIo->xTmpPage(pEngine->pIo->pHandle);
 	/* Move the target cells to the beginning */
@@ -49862,7 +51384,7 @@ static int lhPageDefragment(lhpage *pPage)
 			SyBigEndianPack32(zPtr,pCell->nKey);
 			zPtr += 4;
 			/* 8 byte data length */
-			SyBigEndianPack64(zPtr,pCell->nData);
+			SyBigEndianPack64(zPtr,lhCellDataField(pCell));
 			zPtr += 8;
 			/* 2 byte offset of the next cell */
 			SyBigEndianPack16(zPtr,pCell->iNext);
@@ -49917,7 +51439,7 @@ static int lhPageDefragment(lhpage *pPage)
 static int lhAllocateSpace(lhpage *pPage,sxu64 nAmount,sxu16 *pOfft)
 {
 	const unsigned char *zEnd,*zPtr;
-	sxu16 iNext,iBlksz,nByte;
+	sxu16 iNext,iBlksz,nByte,iPrev;
 	unsigned char *zPrev;
 	int rc;
 	if( (sxu64)pPage->nFree < nAmount ){
@@ -49964,13 +51486,18 @@ static int lhAllocateSpace(lhpage *pPage,sxu64 nAmount,sxu16 *pOfft)
 		/* Point to the next free block */
 		zPtr = &pPage->pRaw->zData[iNext];
 	}
+	/* Save block offsets */
+	*pOfft = (sxu16)(zPtr - pPage->pRaw->zData);
+	iPrev = zPrev ? (sxu16)(zPrev - pPage->pRaw->zData) : 0;
 	/* Acquire writer lock on this page */
 	rc = pPage->pHash->pIo->xWrite(pPage->pRaw);
 	if( rc != UNQLITE_OK ){
 		return rc;
 	}
-	/* Save block offset */
-	*pOfft = (sxu16)(zPtr - pPage->pRaw->zData);
+	/* The page buffer may have been replaced by xWrite() */
+	if( zPrev ){
+		zPrev = &pPage->pRaw->zData[iPrev];
+	}
 	/* Fix pointers */
 	if( iBlksz >= nByte && (iBlksz - nByte) > 3 ){
 		unsigned char *zBlock = &pPage->pRaw->zData[(*pOfft) + nByte];
@@ -50011,7 +51538,7 @@ static int lhCellWriteHeader(lhcell *pCell)
 	SyBigEndianPack32(zRaw,pCell->nKey);
 	zRaw += 4;
 	/* 8 byte data length */
-	SyBigEndianPack64(zRaw,pCell->nData);
+	SyBigEndianPack64(zRaw,lhCellDataField(pCell));
 	zRaw += 8;
 	/* 2 byte offset of the next cell */
 	pCell->iNext = pPage->sHdr.iOfft;
@@ -50357,7 +51884,8 @@ static int lhRecordOverwrite(
 	const unsigned char *zPtr,*zEnd;
 	unqlite_page *pOvfl,*pOld,*pNew;
 	lhpage *pPage = pCell->pPage;
-	sxu32 nAvail;
+	sxu32 nAvail,nZip;
+	SyBlob sZip;
 	pgno iOvfl;
 	int rc;
 	/* Acquire a writer lock on this page */
@@ -50385,17 +51913,28 @@ static int lhRecordOverwrite(
 			/* Check if another chunk is available for this cell */
 			rc = lhAllocateSpace(pPage,L_HASH_CELL_SZ + pCell->nKey + nByte,&iOfft);
 			if( rc != UNQLITE_OK ){
-				/* Transfer the payload to an overflow page */
-				rc = lhCellWriteOvflPayload(pCell,&pPage->pRaw->zData[pCell->iStart + L_HASH_CELL_SZ],pCell->nKey,pData,nByte,(const void *)0);
+				SyBlob sZip;
+				sxu32 nZip = 0;
+				/* Transfer the payload (compressed if enabled) to an overflow page */
+				SyBlobInit(&sZip,&pEngine->sAllocator);
+				if( UNQLITE_OK == lhCellZipData(pEngine,pData,(sxu64)nByte,&sZip) ){
+					nZip = SyBlobLength(&sZip);
+					rc = lhCellWriteOvflPayload(pCell,&pPage->pRaw->zData[pCell->iStart + L_HASH_CELL_SZ],pCell->nKey,
+						SyBlobData(&sZip),(sxu64)nZip,(const void *)0);
+				}else{
+					rc = lhCellWriteOvflPayload(pCell,&pPage->pRaw->zData[pCell->iStart + L_HASH_CELL_SZ],pCell->nKey,pData,nByte,(const void *)0);
+				}
+				SyBlobRelease(&sZip);
 				if( rc != UNQLITE_OK ){
 					return rc;
 				}
-				/* Update the cell header */
-				SyBigEndianPack64(&pPage->pRaw->zData[pCell->iStart + 4 /* Hash */ + 4 /* Key */],(sxu64)nByte);
 				/* Restore freespace */
 				lhRestoreSpace(pPage,(sxu16)(pCell->iStart + L_HASH_CELL_SZ),(sxu16)(pCell->nKey + pCell->nData));
 				/* New data size */
 				pCell->nData = (sxu64)nByte;
+				pCell->nZip = nZip;
+				/* Update the cell header */
+				SyBigEndianPack64(&pPage->pRaw->zData[pCell->iStart + 4 /* Hash */ + 4 /* Key */],lhCellDataField(pCell));
 			}else{
 				sxu16 iOldOfft = pCell->iStart;
 				sxu32 iOld = (sxu32)pCell->nData;
@@ -50438,12 +51977,21 @@ static int lhRecordOverwrite(
 	zRaw = &pOvfl->zData[pCell->iDataOfft];
 	zRawEnd = &pOvfl->zData[pEngine->iPageSize];
 	/* The data to be stored */
-	zPtr = (const unsigned char *)pData;
-	zEnd = &zPtr[nByte];
+	SyBlobInit(&sZip,&pEngine->sAllocator);
+	nZip = 0;
+	if( UNQLITE_OK == lhCellZipData(pEngine,pData,(sxu64)nByte,&sZip) ){
+		nZip = SyBlobLength(&sZip);
+		zPtr = (const unsigned char *)SyBlobData(&sZip);
+		zEnd = &zPtr[nZip];
+	}else{
+		zPtr = (const unsigned char *)pData;
+		zEnd = &zPtr[nByte];
+	}
 	/* Start the overwrite process */
 	/* Acquire a writer lock */
 	rc = pEngine->pIo->xWrite(pOvfl);
 	if( rc != UNQLITE_OK ){
+		SyBlobRelease(&sZip);
 		return rc;
 	}
 	SyBigEndianPack64(pOvfl->zData,0);
@@ -50456,10 +52004,12 @@ static int lhRecordOverwrite(
 			/* Acquire a new page */
 			rc = lhAcquirePage(pEngine,&pNew);
 			if( rc != UNQLITE_OK ){
+				SyBlobRelease(&sZip);
 				return rc;
 			}
 			rc = pEngine->pIo->xWrite(pNew);
 			if( rc != UNQLITE_OK ){
+				SyBlobRelease(&sZip);
 				return rc;
 			}
 			/* Link */
@@ -50480,11 +52030,13 @@ static int lhRecordOverwrite(
 		zPtr += nLen;
 		zRaw += nLen;
 	}
+	SyBlobRelease(&sZip);
 	/* Unref the last overflow page */
 	pEngine->pIo->xPageUnref(pOvfl);
 	/* Finally, update the cell header */
 	pCell->nData = (sxu64)nByte;
-	SyBigEndianPack64(&pPage->pRaw->zData[pCell->iStart + 4 /* Hash */ + 4 /* Key */],pCell->nData);
+	pCell->nZip = nZip;
+	SyBigEndianPack64(&pPage->pRaw->zData[pCell->iStart + 4 /* Hash */ + 4 /* Key */],lhCellDataField(pCell));
 	/* All done */
 	return UNQLITE_OK;
 }
@@ -50510,6 +52062,20 @@ static int lhRecordAppend(
 		pEngine->pIo->xErr(pEngine->pIo->pHandle,"Append operation will cause data overflow");
 		return UNQLITE_LIMIT;
 	}
+	if( pCell->nZip > 0 ){
+		SyBlob sWorker;
+		/* Compressed payload, inflate, append and overwrite the whole record */
+		SyBlobInit(&sWorker,&pEngine->sAllocator);
+		rc = lhConsumeCellData(pCell,unqliteDataConsumer,&sWorker);
+		if( rc == UNQLITE_OK ){
+			rc = SyBlobAppend(&sWorker,pData,(sxu32)nByte);
+		}
+		if( rc == UNQLITE_OK ){
+			rc = lhRecordOverwrite(pCell,SyBlobData(&sWorker),(unqlite_int64)SyBlobLength(&sWorker));
+		}
+		SyBlobRelease(&sWorker);
+		return rc;
+	}
 	/* Acquire a writer lock on this page */
 	rc = pEngine->pIo->xWrite(pPage->pRaw);
 	if( rc != UNQLITE_OK ){
@@ -50655,8 +52221,8 @@ static int lhRecordAppend(
  */
 static int lhSetEmptyPage(lhpage *pPage)
 {
-	unsigned char *zRaw = pPage->pRaw->zData;
 	lhphdr *pHeader = &pPage->sHdr;
+	unsigned char *zRaw;
 	sxu16 nByte;
 	int rc;
 	/* Acquire a writer lock */
@@ -50664,6 +52230,8 @@ static int lhSetEmptyPage(lhpage *pPage)
 	if( rc != UNQLITE_OK ){
 		return rc;
 	}
+	/* The page buffer may have been replaced by xWrite() */
+	zRaw = pPage->pRaw->zData;
 	/* Offset of the first cell */
 	SyBigEndianPack16(zRaw,0);
 	zRaw += 2;
@@ -50751,7 +52319,16 @@ static int lhStoreCell(
 	}
 	/* Write the payload */
 	if( iNeedOvfl ){
-		rc = lhCellWriteOvflPayload(pCell,pKey,nKeyLen,pData,nDataLen,(const void *)0);
+		SyBlob sZip;
+		SyBlobInit(&sZip,&pEngine->sAllocator);
+		if( UNQLITE_OK == lhCellZipData(pEngine,pData,(sxu64)nDataLen,&sZip) ){
+			/* Compressed payload */
+			pCell->nZip = SyBlobLength(&sZip);
+			rc = lhCellWriteOvflPayload(pCell,pKey,nKeyLen,SyBlobData(&sZip),(sxu64)pCell->nZip,(const void *)0);
+		}else{
+			rc = lhCellWriteOvflPayload(pCell,pKey,nKeyLen,pData,nDataLen,(const void *)0);
+		}
+		SyBlobRelease(&sZip);
 		if( rc != UNQLITE_OK ){
 			lhCellDiscard(pCell);
 			return rc;
@@ -50891,6 +52468,7 @@ static int lhTransferCell(lhcell *pTarget,lhpage *pPage)
 	/* Fill-in the structure */
 	pCell->iStart = nOfft;
 	pCell->nData  = pTarget->nData;
+	pCell->nZip   = pTarget->nZip;
 	pCell->nKey   = pTarget->nKey;
 	pCell->iOvfl  = pTarget->iOvfl;
 	pCell->iDataOfft = pTarget->iDataOfft;
@@ -51308,7 +52886,10 @@ static void lhash_page_release(void *pUserData)
 	pRaw->pUserData = 0;
 }
 /*
- * Default hash function (DJB).
+ * Legacy hash function (DJB).
+ * Databases created before the word-at-a-time hash was introduced were
+ * built using this function. It is automatically selected when such
+ * image is opened (See lhash_read_header()).
  */
 static sxu32 lhash_bin_hash(const void *pSrc,sxu32 nLen)
 {
@@ -51327,6 +52908,73 @@ static sxu32 lhash_bin_hash(const void *pSrc,sxu32 nLen)
 	}	
 	return nH;
 }
+/*
+ * Seed of the default hash function. Any value can be used but a database
+ * image is bound to the seed it was created with (The hash of L_HASH_WORD
+ * stored in the header will not match otherwise).
+ */
+#ifndef UNQLITE_LHASH_SEED
+#define UNQLITE_LHASH_SEED 0x9747B28C
+#endif
+/* xxHash32 primes */
+#define L_HASH_PRIME1 0x9E3779B1U
+#define L_HASH_PRIME2 0x85EBCA77U
+#define L_HASH_PRIME3 0xC2B2AE3DU
+#define L_HASH_PRIME4 0x27D4EB2FU
+#define L_HASH_PRIME5 0x165667B1U
+#define L_HASH_ROTL(X,R) (((X) << (R)) | ((X) >> (32 - (R))))
+/* Little-endian 32-bit load that is safe on unaligned addresses */
+#define L_HASH_READ32(Z) ((sxu32)(Z)[0] | ((sxu32)(Z)[1] << 8) | ((sxu32)(Z)[2] << 16) | ((sxu32)(Z)[3] << 24))
+#define L_HASH_ROUND(ACC,Z) ACC += L_HASH_READ32(Z) * L_HASH_PRIME2; ACC = L_HASH_ROTL(ACC,13); ACC *= L_HASH_PRIME1
+/*
+ * Default hash function (xxHash32).
+ * Consume the key a word at a time with no length cap and finish with a full
+ * avalanche so that the low order bits (Used for bucket selection) depends
+ * on every byte of structured keys such as "sensor_00001234".
+ */
+static sxu32 lhash_xx_hash(const void *pSrc,sxu32 nLen)
+{
+	const unsigned char *zIn = (const unsigned char *)pSrc;
+	const unsigned char *zEnd = &zIn[nLen];
+	sxu32 nH;
+	if( nLen >= 16 ){
+		const unsigned char *zLimit = zEnd - 16;
+		sxu32 v1 = UNQLITE_LHASH_SEED + L_HASH_PRIME1 + L_HASH_PRIME2;
+		sxu32 v2 = UNQLITE_LHASH_SEED + L_HASH_PRIME2;
+		sxu32 v3 = UNQLITE_LHASH_SEED;
+		sxu32 v4 = UNQLITE_LHASH_SEED - L_HASH_PRIME1;
+		do{
+			L_HASH_ROUND(v1,zIn);
+			L_HASH_ROUND(v2,&zIn[4]);
+			L_HASH_ROUND(v3,&zIn[8]);
+			L_HASH_ROUND(v4,&zIn[12]);
+			zIn += 16;
+		}while( zIn <= zLimit );
+		nH = L_HASH_ROTL(v1,1) + L_HASH_ROTL(v2,7) + L_HASH_ROTL(v3,12) + L_HASH_ROTL(v4,18);
+	}else{
+		nH = UNQLITE_LHASH_SEED + L_HASH_PRIME5;
+	}
+	nH += nLen;
+	/* Remaining words */
+	while( &zIn[4] <= zEnd ){
+		nH += L_HASH_READ32(zIn) * L_HASH_PRIME3;
+		nH = L_HASH_ROTL(nH,17) * L_HASH_PRIME4;
+		zIn += 4;
+	}
+	/* Remaining bytes */
+	while( zIn < zEnd ){
+		nH += zIn[0] * L_HASH_PRIME5;
+		nH = L_HASH_ROTL(nH,11) * L_HASH_PRIME1;
+		zIn++;
+	}
+	/* Final avalanche */
+	nH ^= nH >> 15;
+	nH *= L_HASH_PRIME2;
+	nH ^= nH >> 13;
+	nH *= L_HASH_PRIME3;
+	nH ^= nH >> 16;
+	return nH;
+}
 /*
  * Exported: xInit() method.
  * Initialize the Key value storage engine.
@@ -51340,7 +52988,7 @@ static int lhash_kv_init(unqlite_kv_engine *pEngine,int iPageSize)
 	SyMemBackendInitFromParent(&pHash->sAllocator,unqliteExportMemBackend());
 	pHash->iPageSize = iPageSize;
 	/* Default hash function */
-	pHash->xHash = lhash_bin_hash;
+	pHash->xHash = lhash_xx_hash;
 	/* Default comparison function */
 	pHash->xCmp = SyMemcmp;
 	/* Allocate a new record map */
@@ -51405,6 +53053,51 @@ static int lhash_kv_config(unqlite_kv_engine *pEngine,int op,va_list ap)
 		}
 		break;
 									 }
+	case UNQLITE_KV_CONFIG_COMPRESS: {
+		/* Overflow payload compression */
+		pHash->bZip = va_arg(ap,int) ? 1 : 0;
+		break;
+									 }
+	case UNQLITE_KV_CONFIG_COMPRESS_STATS: {
+		/* Compression ratio */
+		unqlite_int64 *pnIn  = va_arg(ap,unqlite_int64 *);
+		unqlite_int64 *pnOut = va_arg(ap,unqlite_int64 *);
+		if( pnIn ){
+			*pnIn = (unqlite_int64)pHash->nZipIn;
+		}
+		if( pnOut ){
+			*pnOut = (unqlite_int64)pHash->nZipOut;
+		}
+		break;
+										   }
+	case UNQLITE_KV_CONFIG_BUCKET_STATS: {
+		/* Bucket occupancy histogram */
+		unsigned int *aCount = va_arg(ap,unsigned int *);
+		int nCount = va_arg(ap,int);
+		lhash_bmap_rec *pRec;
+		lhpage *pPage;
+		sxu32 n;
+		if( aCount == 0 || nCount < 1 ){
+			rc = UNQLITE_INVALID;
+			break;
+		}
+		SyZero(aCount,nCount * sizeof(unsigned int));
+		/* Make sure the bucket map is loaded */
+		rc = lhReadHeaderPage(pHash);
+		if( rc != UNQLITE_OK ){
+			break;
+		}
+		for( pRec = pHash->pFirst, n = 0 ; n < pHash->nBuckRec ; pRec = pRec->pPrev, n++ ){
+			rc = lhLoadPage(pHash,pRec->iReal,0,&pPage,0);
+			if( rc != UNQLITE_OK ){
+				break;
+			}
+			/* Cells of the slave pages are installed in their master */
+			aCount[pPage->nCell < (sxu32)nCount ? pPage->nCell : (sxu32)(nCount - 1)]++;
+			pHash->pIo->xPageUnref(pPage->pRaw);
+		}
+		break;
+										 }
 	default:
 		/* Unknown OP */
 		rc = UNQLITE_UNKNOWN;
@@ -51471,6 +53164,8 @@ static int lhCursorNextPage(lhash_kv_cursor *pPtr)
 		/* Load the next page on the list */
 		rc = lhLoadPage((lhash_kv_engine *)pCur->pStore,pRec->iReal,0,&pPage,0);
 		if( rc != UNQLITE_OK ){
+			/* Stay on this page so that the move can be retried */
+			pCur->pRec = pRec;
 			return rc;
 		}
 		if( pPage->pList ){
@@ -51510,6 +53205,8 @@ static int lhCursorPrevPage(lhash_kv_cursor *pPtr)
 		/* Load the previous page on the list */
 		rc = lhLoadPage((lhash_kv_engine *)pCur->pStore,pRec->iReal,0,&pPage,0);
 		if( rc != UNQLITE_OK ){
+			/* Stay on this page so that the move can be retried */
+			pCur->pRec = pRec;
 			return rc;
 		}
 		if( pPage->pFirst ){
@@ -51542,7 +53239,7 @@ static int lhCursorFirst(unqlite_kv_cursor *pCursor)
 	int rc;
 	if( pCur->is_first ){
 		/* Read the database header first */
-		rc = pEngine->pIo->xGet(pEngine->pIo->pHandle,1,&pEngine->pHeader);
+		rc = lhReadHeaderPage(pEngine);
 		if( rc != UNQLITE_OK ){
 			return rc;
 		}
@@ -51564,7 +53261,7 @@ static int lhCursorLast(unqlite_kv_cursor *pCursor)
 	int rc;
 	if( pCur->is_first ){
 		/* Read the database header first */
-		rc = pEngine->pIo->xGet(pEngine->pIo->pHandle,1,&pEngine->pHeader);
+		rc = lhReadHeaderPage(pEngine);
 		if( rc != UNQLITE_OK ){
 			return rc;
 		}
@@ -52527,6 +54224,22 @@ UNQLITE_PRIVATE int unqliteOsSectorSize(unqlite_file *id)
   }
   return  UNQLITE_DEFAULT_SECTOR_SIZE;
 }
+UNQLITE_PRIVATE int unqliteOsFetch(unqlite_file *id, unqlite_int64 iOfst, int iAmt, void **pp)
+{
+  if( id->pMethods->iVersion < 2 || id->pMethods->xFetch == 0 ){
+	  /* Not supported by the underlying VFS, caller must fallback to xRead() */
+	  *pp = 0;
+	  return UNQLITE_OK;
+  }
+  return id->pMethods->xFetch(id, iOfst, iAmt, pp);
+}
+UNQLITE_PRIVATE int unqliteOsUnfetch(unqlite_file *id, unqlite_int64 iOfst, void *p)
+{
+  if( id->pMethods->iVersion < 2 || id->pMethods->xUnfetch == 0 ){
+	  return UNQLITE_OK;
+  }
+  return id->pMethods->xUnfetch(id, iOfst, p);
+}
 /*
 ** The next group of routines are convenience wrappers around the
 ** VFS methods.
@@ -52631,6 +54344,7 @@ UNQLITE_PRIVATE int unqliteOsAccess(
 #include <sys/stat.h>
 #include <sys/uio.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <time.h>
@@ -52696,6 +54410,9 @@ struct unixFile {
   int fileFlags;                      /* Miscellanous flags */
   const char *zPath;                  /* Name of the file */
   unsigned fsFlags;                   /* cached details from statfs() */
+  void *pMapRegion;                   /* Read-only mapping of the file used by xFetch() */
+  unqlite_int64 mmapSize;             /* Size of the mapping at pMapRegion */
+  int nFetchOut;                      /* Number of outstanding xFetch() references */
 };
 /*
 ** The following macros define bits in unixFile.fileFlags
@@ -53495,6 +55212,11 @@ static int unixUnlock(unqlite_file *id, int eFileLock){
 static int closeUnixFile(unqlite_file *id){
   unixFile *pFile = (unixFile*)id;
   if( pFile ){
+    if( pFile->pMapRegion ){
+      /* Outstanding xFetch() references are released with the file */
+      munmap(pFile->pMapRegion, (size_t)pFile->mmapSize);
+      pFile->pMapRegion = 0;
+    }
     if( pFile->dirfd>=0 ){
       int err = close(pFile->dirfd);
       if( err ){
@@ -53872,11 +55594,66 @@ static int unixSectorSize(unqlite_file *NotUsed){
   return UNQLITE_DEFAULT_SECTOR_SIZE;
 }
 /*
+** Return a pointer to iAmt bytes of the file content starting at offset iOfst.
+**
+** The whole file is mapped read-only the first time this routine is called
+** and remapped if the file has grown past the end of the current mapping
+** and no references are outstanding. If the requested range cannot be
+** served from the mapping, *pp is set to NULL so that the caller fallback
+** to unixRead().
+*/
+static int unixFetch(unqlite_file *id, unqlite_int64 iOfst, int iAmt, void **pp){
+  unixFile *pFile = (unixFile *)id;
+  *pp = 0;
+  if( pFile->pMapRegion==0 || iOfst+iAmt>pFile->mmapSize ){
+    struct stat st;
+    void *pNew;
+    if( pFile->nFetchOut>0 ){
+      /* Cannot remap while references into the current mapping are live */
+      return UNQLITE_OK;
+    }
+    if( fstat(pFile->h, &st) ){
+      pFile->lastErrno = errno;
+      return UNQLITE_OK;
+    }
+    if( iOfst+iAmt>(unqlite_int64)st.st_size ){
+      /* Past the end of file */
+      return UNQLITE_OK;
+    }
+    if( pFile->pMapRegion ){
+      munmap(pFile->pMapRegion, (size_t)pFile->mmapSize);
+      pFile->pMapRegion = 0;
+      pFile->mmapSize = 0;
+    }
+    pNew = mmap(0, (size_t)st.st_size, PROT_READ, MAP_SHARED, pFile->h, 0);
+    if( pNew==MAP_FAILED ){
+      pFile->lastErrno = errno;
+      return UNQLITE_OK;
+    }
+    pFile->pMapRegion = pNew;
+    pFile->mmapSize = (unqlite_int64)st.st_size;
+  }
+  *pp = &((unsigned char *)pFile->pMapRegion)[iOfst];
+  pFile->nFetchOut++;
+  return UNQLITE_OK;
+}
+/*
+** Release a reference obtained by unixFetch(). The mapping itself is kept
+** until the file is closed.
+*/
+static int unixUnfetch(unqlite_file *id, unqlite_int64 iOfst, void *p){
+  unixFile *pFile = (unixFile *)id;
+  if( p && pFile->nFetchOut>0 && p==&((unsigned char *)pFile->pMapRegion)[iOfst] ){
+    pFile->nFetchOut--;
+  }
+  return UNQLITE_OK;
+}
+/*
 ** This vector defines all the methods that can operate on an
 ** unqlite_file for Windows systems.
 */
 static const unqlite_io_methods unixIoMethod = {
-  1,                              /* iVersion */
+  2,                              /* iVersion */
   unixClose,                       /* xClose */
   unixRead,                        /* xRead */
   unixWrite,                       /* xWrite */
@@ -53887,6 +55664,8 @@ static const unqlite_io_methods unixIoMethod = {
   unixUnlock,                      /* xUnlock */
   unixCheckReservedLock,           /* xCheckReservedLock */
   unixSectorSize,                  /* xSectorSize */
+  unixFetch,                       /* xFetch */
+  unixUnfetch,                     /* xUnfetch */
 };
 /****************************************************************************
 **************************** unqlite_vfs methods ****************************
@@ -55341,6 +57120,16 @@ void unqlite_free(void *p)
 #include "unqliteInt.h"
 #endif
 /*
+** When IOTRACE_EN is defined, commits and dirty page flushes are timed and
+** recorded by the storage stack I/O tracer (See ioTrace.h).
+*/
+#ifdef IOTRACE_EN
+#include "ioTrace.h"
+#else
+#define IOTRACE_START() 0
+#define IOTRACE_END(LAYER,OP,ADDR,SIZE,START) ((void)(ADDR),(void)(SIZE),(void)(START))
+#endif
+/*
 ** This file implements the pager and the transaction manager for UnQLite (Mostly inspired from the SQLite3 Source tree).
 **
 ** The Pager.eState variable stores the current 'state' of a pager. A
@@ -55514,6 +57303,19 @@ struct Page {
 #define PAGE_DONT_MAKE_HOT     0x080  /* Dont make this page Hot. In other words,
 									   * do not link it to the hot dirty list.
 									   */
+#define PAGE_FETCHED           0x100  /* Page content is a direct reference obtained via xFetch() */
+#define PAGE_OWN_DATA          0x200  /* Fetched page copied to a private buffer before being written */
+/*
+ * Content of a page at the last acknowledged group commit, saved before the
+ * page is changed again (See unqlitePagerGroupCommit()). The raw page content
+ * follows this header.
+ */
+typedef struct PageImage PageImage;
+struct PageImage
+{
+  pgno pgno;                     /* Page number */
+  PageImage *pNext;              /* Next saved page */
+};
 /*
  * Each active database pager is represented by an instance of
  * the following structure.
@@ -55563,10 +57365,30 @@ struct Pager
   sxu32 nSize;                   /* apHash[] size: Must be a power of two  */
   sxu32 nPage;                   /* Total number of page loaded in memory */
   sxu32 nCacheMax;               /* Maximum page to cache*/
+  sxu32 nGroupMax;               /* Maximum number of commits per group (0 or 1: group commit disabled) */
+  sxu32 nGroupMs;                /* Maximum age in ms of the first commit of a group (0: no limit) */
+  ProcGroupTick xGroupTick;      /* Millisecond tick source for nGroupMs */
+  sxu32 nGroupPending;           /* Acknowledged commits not yet flushed to disk */
+  unsigned int iGroupStart;      /* Tick of the first commit in the current group */
+  pgno nGroupDbSize;             /* dbSize at the last acknowledged commit */
+  Bitvec *pGroupVec;             /* Pages saved since the last acknowledged commit */
+  PageImage *pGroupImg;          /* Their content at that time */
+  unsigned char *zRa;            /* Read-ahead buffer (nRaMax pages, allocated on first use) */
+  sxu32 nRaMax;                  /* Maximum read-ahead window in pages (0 or 1: read-ahead disabled) */
+  sxu32 nRaWindow;               /* Current (adaptive) read-ahead window in pages */
+  pgno iRaFirst;                 /* First page held in the read-ahead buffer */
+  sxu32 nRaPage;                 /* Total number of pages held in the read-ahead buffer */
+  sxu32 iRaUsed;                 /* Bitmap of buffered pages handed to the page cache */
+  pgno iRaLast;                  /* Head of the current sequential stream */
+  pgno iRaCand;                  /* Last page read outside the stream (candidate for a new stream) */
+  sxu32 nRaRead;                 /* Statistics: Total number of read-ahead I/Os */
+  sxu32 nRaHit;                  /* Statistics: Prefetched pages served from the read-ahead buffer */
+  sxu32 nRaWaste;                /* Statistics: Prefetched pages discarded without being used */
 };
 /* Control flags */
 #define PAGER_CTRL_COMMIT_ERR   0x001 /* Commit error */
 #define PAGER_CTRL_DIRTY_COMMIT 0x002 /* Dirty commit has been applied */ 
+#define PAGER_CTRL_GROUP_DIRTY  0x004 /* Pages changed since the last acknowledged group commit */
 /*
 ** Read a 32-bit integer from the given file descriptor. 
 ** All values are stored on disk as big-endian.
@@ -55695,11 +57517,121 @@ static Page * pager_alloc_page(Pager *pPager,pgno num_page)
 	pNew->pgno = num_page;
 	return pNew;
 }
+/*
+ * Try to serve a page by reference rather than copying it into a freshly allocated buffer.
+ * This is done when the underlying VFS expose a direct pointer to the file contents via
+ * xFetch() (RAM disk, memory mapped file, execute-in-place flash, etc.) and no write
+ * transaction is in progress: the page is then clean and its content is the committed one.
+ * Page content is never written in place, unqlitePageWrite() copy the page to a private
+ * buffer first (See pager_own_page_data()).
+ * On success, *ppOut is set to a page object without a trailing data buffer whose
+ * zData field point to the fetched memory. Otherwise *ppOut is set to NULL and the
+ * caller must fallback to the regular allocate and read path.
+ */
+static int pager_fetch_page_ref(Pager *pPager,pgno num_page,Page **ppOut)
+{
+	void *pMem = 0;
+	Page *pNew;
+	int rc;
+	*ppOut = 0;
+	if( pPager->iState > PAGER_WRITER_LOCKED || pPager->is_mem || num_page >= pPager->dbSize
+		|| ((pPager->iOpenFlags & UNQLITE_OPEN_MMAP) && pPager->pMmap) ){
+		/* Not applicable */
+		return UNQLITE_OK;
+	}
+	rc = unqliteOsFetch(pPager->pfd,num_page * pPager->iPageSize,pPager->iPageSize,&pMem);
+	if( rc != UNQLITE_OK || pMem == 0 ){
+		/* Not supported by the VFS or range not addressable, fallback to xRead() */
+		return UNQLITE_OK;
+	}
+	pNew = (Page *)SyMemBackendPoolAlloc(pPager->pAllocator,sizeof(Page));
+	if( pNew == 0 ){
+		unqliteOsUnfetch(pPager->pfd,num_page * pPager->iPageSize,pMem);
+		return UNQLITE_NOMEM;
+	}
+	/* Zero the structure */
+	SyZero(pNew,sizeof(Page));
+	/* Page data by reference */
+	pNew->zData = (unsigned char *)pMem;
+	/* Fill in the structure */
+	pNew->pPager = pPager;
+	pNew->nRef = 1;
+	pNew->pgno = num_page;
+	pNew->flags = PAGE_FETCHED;
+	*ppOut = pNew;
+	return UNQLITE_OK;
+}
+/*
+ * A page obtained by pager_fetch_page_ref() is about to be modified.
+ * Copy its content to a private buffer and release the VFS reference.
+ */
+static int pager_own_page_data(Pager *pPager,Page *pPage)
+{
+	unsigned char *zData;
+	if( (pPage->flags & PAGE_FETCHED) == 0 ){
+		/* Already private */
+		return UNQLITE_OK;
+	}
+	zData = (unsigned char *)SyMemBackendPoolAlloc(pPager->pAllocator,(sxu32)pPager->iPageSize);
+	if( zData == 0 ){
+		return UNQLITE_NOMEM;
+	}
+	SyMemcpy((const void *)pPage->zData,zData,(sxu32)pPager->iPageSize);
+	unqliteOsUnfetch(pPager->pfd,pPage->pgno * pPager->iPageSize,pPage->zData);
+	pPage->zData = zData;
+	pPage->flags &= ~PAGE_FETCHED;
+	pPage->flags |= PAGE_OWN_DATA;
+	return UNQLITE_OK;
+}
+/*
+ * Free a page object allocated either by pager_alloc_page() or pager_fetch_page_ref().
+ */
+static void pager_free_page(Pager *pPager,Page *pPage)
+{
+	if( pPage->flags & PAGE_FETCHED ){
+		/* Hand the referenced memory back to the VFS */
+		unqliteOsUnfetch(pPager->pfd,pPage->pgno * pPager->iPageSize,pPage->zData);
+	}else if( pPage->flags & PAGE_OWN_DATA ){
+		SyMemBackendPoolFree(pPager->pAllocator,pPage->zData);
+	}
+	SyMemBackendPoolFree(pPager->pAllocator,pPage);
+}
+/*
+ * Page reference counting.
+ * When threading is enabled and the compiler provides atomic builtins, the
+ * reference count is updated lock-free instead of taking the allocator mutex
+ * on every reference change. Pages are pinned and released on every lookup
+ * so this keeps the allocator mutex (shared by every allocation made on
+ * behalf of the database handle) off the read path.
+ */
+#if defined(UNQLITE_SHARED_READ)
+#define PAGE_ATOMIC_REF
+#define PAGE_REF_INC(PAGE) __atomic_add_fetch(&(PAGE)->nRef,1,__ATOMIC_RELAXED)
+#define PAGE_REF_DEC(PAGE) __atomic_sub_fetch(&(PAGE)->nRef,1,__ATOMIC_ACQ_REL)
+#endif
+/*
+ * Return TRUE if the database handle mutex is held in shared mode by the calling thread.
+ * Readers are then restricted to the page cache: they may not read from disk, parse a
+ * new page or alter the page lists. The operation fail with UNQLITE_LOCKED instead and
+ * is retried by the upper layer with the mutex held exclusively.
+ */
+#if defined(UNQLITE_SHARED_READ)
+static int pager_cache_only(Pager *pPager)
+{
+	/* Writers exclude readers, a non zero count is therefore seen by readers only */
+	return __atomic_load_n(&pPager->pDb->nReader,__ATOMIC_RELAXED) > 0;
+}
+#else
+#define pager_cache_only(PAGER) FALSE
+#endif
 /*
  * Increment the reference count of a given page.
  */
 static void page_ref(Page *pPage)
 {
+#ifdef PAGE_ATOMIC_REF
+	PAGE_REF_INC(pPage);
+#else
 	if( pPage->pPager->pAllocator->pMutexMethods ){
 		SyMutexEnter(pPage->pPager->pAllocator->pMutexMethods, pPage->pPager->pAllocator->pMutex);
 	}
@@ -55707,6 +57639,7 @@ static void page_ref(Page *pPage)
 	if( pPage->pPager->pAllocator->pMutexMethods ){
 		SyMutexLeave(pPage->pPager->pAllocator->pMutexMethods, pPage->pPager->pAllocator->pMutex);
 	}
+#endif
 }
 /*
  * Release an in-memory page after its reference count reach zero.
@@ -55720,7 +57653,7 @@ static int pager_release_page(Pager *pPager,Page *pPage)
 			pPager->xPageUnpin(pPage->pUserData);
 		}
 		pPage->pUserData = 0;
-		SyMemBackendPoolFree(pPager->pAllocator,pPage);
+		pager_free_page(pPager,pPage);
 	}else{
 		/* Dirty page, it will be released later when a dirty commit
 		 * or the final commit have been applied.
@@ -55737,6 +57670,9 @@ static int pager_unlink_page(Pager *pPager,Page *pPage);
 static void page_unref(Page *pPage)
 {
 	int nRef;
+#ifdef PAGE_ATOMIC_REF
+	nRef = PAGE_REF_DEC(pPage);
+#else
 	if( pPage->pPager->pAllocator->pMutexMethods ){
 		SyMutexEnter(pPage->pPager->pAllocator->pMutexMethods, pPage->pPager->pAllocator->pMutex);
 	}
@@ -55744,8 +57680,15 @@ static void page_unref(Page *pPage)
 	if( pPage->pPager->pAllocator->pMutexMethods ){
 		SyMutexLeave(pPage->pPager->pAllocator->pMutexMethods, pPage->pPager->pAllocator->pMutex);
 	}
+#endif
 	if( nRef == 0){
 		Pager *pPager = pPage->pPager;
+		if( pager_cache_only(pPager) ){
+			/* Shared reader, keep the page linked. It is released by the next
+			 * exclusive unref or when the cache is discarded.
+			 */
+			return;
+		}
 		if( !(pPage->flags & PAGE_DIRTY)  ){
 			pager_unlink_page(pPager,pPage);
 			/* Release the page */
@@ -55861,6 +57804,115 @@ static int pager_fill_page(Pager *pPager,pgno iNum,void *pContents)
 
 	return UNQLITE_OK;
 }
+/*
+ * Discard the content of the read-ahead buffer.
+ * Prefetched pages that were never handed to the page cache are accounted as wasted
+ * and the read-ahead window is adapted: It is doubled when the whole previous window
+ * have been used and halved when most of it was wasted.
+ * This routine must also be called each time the database file is written so
+ * that stale content is never served from the buffer.
+ */
+static void pager_ra_discard(Pager *pPager)
+{
+	sxu32 nUsed = 0;
+	sxu32 i;
+	if( pPager->nRaPage < 1 ){
+		return;
+	}
+	for( i = 0 ; i < pPager->nRaPage ; ++i ){
+		if( pPager->iRaUsed & (1U << i) ){
+			nUsed++;
+		}
+	}
+	pPager->nRaWaste += pPager->nRaPage - nUsed;
+	if( nUsed >= pPager->nRaPage ){
+		pPager->nRaWindow <<= 1;
+		if( pPager->nRaWindow > pPager->nRaMax ){
+			pPager->nRaWindow = pPager->nRaMax;
+		}
+	}else if( nUsed <= (pPager->nRaPage >> 1) ){
+		pPager->nRaWindow >>= 1;
+		if( pPager->nRaWindow < 2 ){
+			pPager->nRaWindow = 2;
+		}
+	}
+	pPager->nRaPage = 0;
+	pPager->iRaUsed = 0;
+}
+/*
+ * Read the content of a page from disk, prefetching the next pages if sequential
+ * access is detected.
+ * Cursor walks visit bucket pages in ascending order but interleave reads of
+ * overflow pages located elsewhere in the file. A read is thus considered sequential
+ * when it lands at most two pages after the head of the current stream, reads far
+ * from the stream leave it untouched and a new stream is started when a page
+ * immediately follow the last page read outside the stream.
+ * On sequential access, the next nRaWindow pages are read in a single xRead() call
+ * into the read-ahead buffer and the subsequent requests for those pages are then
+ * served from memory.
+ */
+static int pager_read_page(Pager *pPager,Page *pPage)
+{
+	pgno iPg = pPage->pgno;
+	sxu32 nPage,i;
+	int rc;
+	if( pPager->nRaPage > 0 && iPg >= pPager->iRaFirst && iPg < pPager->iRaFirst + pPager->nRaPage ){
+		/* Served from the read-ahead buffer */
+		i = (sxu32)(iPg - pPager->iRaFirst);
+		SyMemcpy(&pPager->zRa[i * pPager->iPageSize],pPage->zData,(sxu32)pPager->iPageSize);
+		if( !(pPager->iRaUsed & (1U << i)) ){
+			pPager->iRaUsed |= 1U << i;
+			pPager->nRaHit++;
+		}
+		if( iPg > pPager->iRaLast ){
+			pPager->iRaLast = iPg;
+		}
+		return UNQLITE_OK;
+	}
+	nPage = 0;
+	if( iPg > pPager->iRaLast && iPg <= pPager->iRaLast + 2 ){
+		/* Stream continues */
+		pPager->iRaLast = iPg;
+	}else if( iPg > 0 && iPg == pPager->iRaCand + 1 ){
+		/* New stream */
+		pPager->iRaLast = iPg;
+	}else{
+		/* Random access */
+		pPager->iRaCand = iPg;
+	}
+	if( pPager->nRaMax > 1 && pPager->iRaLast == iPg ){
+		/* Sequential access, retire the previous window first */
+		pager_ra_discard(pPager);
+		if( pPager->nRaWindow < 2 ){
+			pPager->nRaWindow = 2;
+		}
+		nPage = pPager->nRaWindow;
+		if( iPg + nPage > pPager->dbSize ){
+			nPage = (sxu32)(pPager->dbSize - iPg);
+		}
+		if( nPage > 1 && pPager->zRa == 0 ){
+			pPager->zRa = (unsigned char *)SyMemBackendAlloc(pPager->pAllocator,pPager->nRaMax * (sxu32)pPager->iPageSize);
+			if( pPager->zRa == 0 ){
+				/* Not so fatal, fallback to a single page read */
+				nPage = 0;
+			}
+		}
+	}
+	if( nPage > 1 ){
+		rc = unqliteOsRead(pPager->pfd,pPager->zRa,(unqlite_int64)nPage * pPager->iPageSize,(unqlite_int64)iPg * pPager->iPageSize);
+		if( rc == UNQLITE_OK ){
+			SyMemcpy(pPager->zRa,pPage->zData,(sxu32)pPager->iPageSize);
+			pPager->iRaFirst = iPg;
+			pPager->nRaPage = nPage;
+			pPager->iRaUsed = 1; /* The requested page */
+			pPager->nRaRead++;
+			return UNQLITE_OK;
+		}
+		/* Fallback to a single page read */
+	}
+	rc = unqliteOsRead(pPager->pfd,pPage->zData,pPager->iPageSize,pPage->pgno * pPager->iPageSize);
+	return rc;
+}
 /*
  * Read the content of a page from disk.
  */
@@ -55877,7 +57929,7 @@ static int pager_get_page_contents(Pager *pPager,Page *pPage,int noContent)
 		pPage->zData = &zMap[pPage->pgno * pPager->iPageSize];
 	}else{
 		/* Read content */
-		rc = unqliteOsRead(pPager->pfd,pPage->zData,pPager->iPageSize,pPage->pgno * pPager->iPageSize);
+		rc = pager_read_page(pPager,pPage);
 	}
 	return rc;
 }
@@ -56347,6 +58399,8 @@ static int pager_playback(Pager *pPager)
 	sxu32 n,nRec;
 	sxi64 iOfft;
 	int rc;
+	/* Prefetched content is about to become stale */
+	pager_ra_discard(pPager);
 	/* Read the journal header*/
 	rc = pager_read_journal_header(pPager,&nRec,&pPager->dbSize);
 	if( rc != UNQLITE_OK ){
@@ -56407,6 +58461,8 @@ end_playback:
 static int pager_unlock_db(Pager *pPager, int eLock)
 {
   int rc = UNQLITE_OK;
+  /* Another process may write the database once the lock is released */
+  pager_ra_discard(pPager);
   if( pPager->iLock != NO_LOCK ){
     rc = unqliteOsUnlock(pPager->pfd,eLock);
     pPager->iLock = eLock;
@@ -57085,7 +59141,12 @@ static int page_write(Pager *pPager,Page *pPage)
 static int pager_write_dirty_pages(Pager *pPager,Page *pDirty)
 {
 	int rc = UNQLITE_OK;
+	sxu32 nWritten = 0;
+	sxu32 iTrace;
 	Page *pNext;
+	/* Prefetched content is about to become stale */
+	pager_ra_discard(pPager);
+	iTrace = IOTRACE_START();
 	for(;;){
 		if( pDirty == 0 ){
 			break;
@@ -57098,6 +59159,7 @@ static int pager_write_dirty_pages(Pager *pPager,Page *pDirty)
 				/* A rollback should be done */
 				break;
 			}
+			nWritten++;
 		}
 		/* Remove stale flags */
 		pDirty->flags &= ~(PAGE_DIRTY|PAGE_DONT_WRITE|PAGE_NEED_SYNC|PAGE_IN_JOURNAL|PAGE_HOT_DIRTY);
@@ -57113,6 +59175,7 @@ static int pager_write_dirty_pages(Pager *pPager,Page *pDirty)
 	pPager->pDirty = pPager->pFirstDirty = 0;
 	pPager->pHotDirty = pPager->pFirstHot = 0;
 	pPager->nHot = 0;
+	IOTRACE_END(IOTRACE_LAYER_PAGER,IOTRACE_OP_WR,0,nWritten * (sxu32)pPager->iPageSize,iTrace);
 	return rc;
 }
 /*
@@ -57131,6 +59194,8 @@ static int pager_write_hot_dirty_pages(Pager *pPager,Page *pDirty)
 {
 	int rc = UNQLITE_OK;
 	Page *pNext;
+	/* Prefetched content is about to become stale */
+	pager_ra_discard(pPager);
 	for(;;){
 		if( pDirty == 0 ){
 			break;
@@ -57310,6 +59375,79 @@ static int pager_dirty_commit(Pager *pPager)
 	 */
 	return UNQLITE_OK;
 }
+/*
+ * Write the deferred collection headers of the active VM's.
+ */
+static int pager_flush_collections(Pager *pPager)
+{
+	unqlite_vm *pVm;
+	sxi32 n;
+	int rc;
+	if( pPager->pDb == 0 ){
+		return UNQLITE_OK;
+	}
+	pVm = pPager->pDb->pVms;
+	for( n = 0 ; n < pPager->pDb->iVm ; ++n ){
+		rc = unqliteVmFlushCollections(pVm);
+		if( rc != UNQLITE_OK ){
+			return rc;
+		}
+		pVm = pVm->pNext;
+	}
+	return UNQLITE_OK;
+}
+/*
+ * Release the page images saved since the last acknowledged group commit.
+ */
+static void pager_group_reset(Pager *pPager)
+{
+	PageImage *pImg,*pNext;
+	for( pImg = pPager->pGroupImg ; pImg ; pImg = pNext ){
+		pNext = pImg->pNext;
+		SyMemBackendFree(pPager->pAllocator,pImg);
+	}
+	pPager->pGroupImg = 0;
+	if( pPager->pGroupVec ){
+		unqliteBitvecDestroy(pPager->pGroupVec);
+		pPager->pGroupVec = 0;
+	}
+	pPager->iFlags &= ~PAGER_CTRL_GROUP_DIRTY;
+}
+/*
+ * A group commit was acknowledged: the page cache as it is now is the state
+ * a rollback of the following transaction reverts to.
+ */
+static int pager_group_savepoint(Pager *pPager)
+{
+	pager_group_reset(pPager);
+	pPager->pGroupVec = unqliteBitvecCreate(pPager->pAllocator,pPager->dbSize);
+	if( pPager->pGroupVec == 0 ){
+		return UNQLITE_NOMEM;
+	}
+	pPager->nGroupDbSize = pPager->dbSize;
+	return UNQLITE_OK;
+}
+/*
+ * A page is about to be changed after an acknowledged group commit. Save its
+ * content first unless it was already saved or did not exist at that time.
+ */
+static int pager_group_save(Pager *pPager,Page *pPage)
+{
+	PageImage *pImg;
+	pPager->iFlags |= PAGER_CTRL_GROUP_DIRTY;
+	if( pPage->pgno >= pPager->nGroupDbSize || unqliteBitvecTest(pPager->pGroupVec,pPage->pgno) ){
+		return UNQLITE_OK;
+	}
+	pImg = (PageImage *)SyMemBackendAlloc(pPager->pAllocator,sizeof(PageImage) + (sxu32)pPager->iPageSize);
+	if( pImg == 0 ){
+		return UNQLITE_NOMEM;
+	}
+	pImg->pgno = pPage->pgno;
+	SyMemcpy((const void *)pPage->zData,(void *)&pImg[1],(sxu32)pPager->iPageSize);
+	pImg->pNext = pPager->pGroupImg;
+	pPager->pGroupImg = pImg;
+	return unqliteBitvecSet(pPager->pGroupVec,pPage->pgno);
+}
 /*
 ** Commit a transaction and sync the database file for the pager pPager.
 **
@@ -57323,7 +59461,14 @@ static int pager_dirty_commit(Pager *pPager)
 */
 UNQLITE_PRIVATE int unqlitePagerCommit(Pager *pPager)
 {
+	sxu32 iTrace;
 	int rc;
+	iTrace = IOTRACE_START();
+	/* Write the deferred collection headers so that they are part of this transaction */
+	rc = pager_flush_collections(pPager);
+	if( rc != UNQLITE_OK ){
+		goto fail;
+	}
 	/* Commit: Phase One */
 	rc = pager_commit_phase1(pPager);
 	if( rc != UNQLITE_OK ){
@@ -57336,13 +59481,91 @@ UNQLITE_PRIVATE int unqlitePagerCommit(Pager *pPager)
 	}
 	/* Remove stale flags */
 	pPager->iFlags &= ~PAGER_CTRL_COMMIT_ERR;
+	/* Queued group commits (if any) are now on disk */
+	pPager->nGroupPending = 0;
+	pager_group_reset(pPager);
+	IOTRACE_END(IOTRACE_LAYER_PAGER,IOTRACE_OP_COMMIT,0,0,iTrace);
 	/* All done */
 	return UNQLITE_OK;
 fail:
 	/* Disable the auto-commit flag */
 	pPager->pDb->iFlags |= UNQLITE_FL_DISABLE_AUTO_COMMIT;
+	IOTRACE_END(IOTRACE_LAYER_PAGER,IOTRACE_OP_COMMIT,0,0,iTrace);
 	return rc;
 }
+/*
+** Commit a transaction on behalf of the host application.
+**
+** If group commit is enabled (See UNQLITE_CONFIG_GROUP_COMMIT), the transaction
+** is acknowledged without touching the disk: its changes stay in the page cache
+** and the write transaction is left open so that the following transactions are
+** merged into it. The whole group is then committed through a single
+** unqlitePagerCommit() once nGroupMax commits have been queued or once the first
+** of them is older than nGroupMs milliseconds.
+** Pages changed after an acknowledged commit are saved first (See pager_group_save())
+** so that a rollback only reverts the transaction it was issued for.
+*/
+UNQLITE_PRIVATE int unqlitePagerGroupCommit(Pager *pPager)
+{
+	unsigned int iNow;
+	int rc;
+	if( pPager->nGroupMax < 2 || pPager->iState < PAGER_WRITER_CACHEMOD || pPager->is_mem
+		|| (pPager->iFlags & PAGER_CTRL_COMMIT_ERR) ){
+		/* Nothing to queue */
+		return unqlitePagerCommit(pPager);
+	}
+	pPager->nGroupPending++;
+	if( pPager->nGroupPending >= pPager->nGroupMax ){
+		/* Group is full */
+		return unqlitePagerCommit(pPager);
+	}
+	if( pPager->xGroupTick && pPager->nGroupMs > 0 ){
+		iNow = pPager->xGroupTick();
+		if( pPager->nGroupPending == 1 ){
+			/* First commit of a new group */
+			pPager->iGroupStart = iNow;
+		}else if( (sxu32)(iNow - pPager->iGroupStart) >= pPager->nGroupMs ){
+			/* Window expired */
+			return unqlitePagerCommit(pPager);
+		}
+	}
+	/* The deferred collection headers are part of the acknowledged transaction */
+	rc = pager_flush_collections(pPager);
+	if( rc == UNQLITE_OK ){
+		rc = pager_group_savepoint(pPager);
+	}
+	if( rc != UNQLITE_OK ){
+		/* Cannot keep it apart from the next transaction, flush it now */
+		return unqlitePagerCommit(pPager);
+	}
+	/* Acknowledged, will be flushed with the rest of the group */
+	return UNQLITE_OK;
+}
+/*
+** Flush the acknowledged group commits on behalf of the host application
+** (See UNQLITE_CONFIG_GROUP_COMMIT_FLUSH). If bExpired is true, the group is
+** only flushed once its window is over.
+** The flush is refused with UNQLITE_BUSY while the current transaction has
+** uncommitted changes: they would be written along with the group. The
+** commit of that transaction flushes the group instead.
+*/
+UNQLITE_PRIVATE int unqlitePagerGroupFlush(Pager *pPager,int bExpired)
+{
+	if( pPager->nGroupPending < 1 ){
+		/* Nothing queued */
+		return UNQLITE_OK;
+	}
+	if( bExpired && (pPager->xGroupTick == 0 || pPager->nGroupMs < 1 ||
+		(sxu32)(pPager->xGroupTick() - pPager->iGroupStart) < pPager->nGroupMs) ){
+		/* Window still open */
+		return UNQLITE_OK;
+	}
+	if( pPager->iFlags & PAGER_CTRL_GROUP_DIRTY ){
+		unqliteGenError(pPager->pDb,"A transaction is in progress, its commit will flush the group");
+		return UNQLITE_BUSY;
+	}
+	return unqlitePagerCommit(pPager);
+}
 /*
  * Reset the pager to its initial state. This is caused by
  * a rollback operation.
@@ -57357,6 +59580,9 @@ static int pager_reset_state(Pager *pPager,int bResetKvEngine)
 	pPager->iFlags &= ~(PAGER_CTRL_COMMIT_ERR|PAGER_CTRL_DIRTY_COMMIT);
 	pPager->iJournalOfft = 0;
 	pPager->nRec = 0;
+	/* Queued group commits are discarded with the transaction */
+	pPager->nGroupPending = 0;
+	pager_group_reset(pPager);
 	/* Database original size */
 	pPager->dbSize = pPager->dbOrigSize;
 	/* Discard all in-memory pages */
@@ -57417,6 +59643,67 @@ static int pager_reset_state(Pager *pPager,int bResetKvEngine)
 	/* All done */
 	return UNQLITE_OK;
 }
+/* Forward declaration */
+static int unqlitePageWrite(unqlite_page *pMyPage);
+static int unqlitePagerAcquire(Pager *pPager,pgno pgno,unqlite_page **ppPage,int fetchOnly,int noContent);
+/*
+ * Revert the pages changed since the last acknowledged group commit to their
+ * saved content, then flush the group.
+ */
+static int pager_group_flush_savepoint(Pager *pPager)
+{
+	PageImage *pImg,*pNext;
+	unqlite_page *pRaw;
+	Page *pPage;
+	int rc = UNQLITE_OK;
+	/* Restored pages are not saved again */
+	pImg = pPager->pGroupImg;
+	pPager->pGroupImg = 0;
+	if( pPager->pGroupVec ){
+		unqliteBitvecDestroy(pPager->pGroupVec);
+		pPager->pGroupVec = 0;
+	}
+	/* Pages allocated since then are dropped */
+	for( pPage = pPager->pAll ; pPage ; pPage = pPage->pNext ){
+		if( pPage->pgno >= pPager->nGroupDbSize ){
+			pPage->flags |= PAGE_DONT_WRITE;
+		}
+	}
+	if( pPager->dbSize > pPager->nGroupDbSize && (pPager->iFlags & PAGER_CTRL_DIRTY_COMMIT) ){
+		/* Some of them may have been written by a dirty commit */
+		unqliteOsTruncate(pPager->pfd,(sxi64)pPager->iPageSize * pPager->nGroupDbSize);
+	}
+	pPager->dbSize = pPager->nGroupDbSize;
+	for( ; pImg ; pImg = pNext ){
+		pNext = pImg->pNext;
+		if( rc == UNQLITE_OK ){
+			/* The page may have been written by a dirty commit and released since */
+			rc = unqlitePagerAcquire(pPager,pImg->pgno,&pRaw,0,0);
+			if( rc == UNQLITE_OK ){
+				rc = unqlitePageWrite(pRaw);
+				if( rc == UNQLITE_OK ){
+					SyMemcpy((const void *)&pImg[1],(void *)pRaw->zData,(sxu32)pPager->iPageSize);
+				}
+				page_unref((Page *)pRaw);
+			}
+		}
+		SyMemBackendFree(pPager->pAllocator,pImg);
+	}
+	pPager->iFlags &= ~PAGER_CTRL_GROUP_DIRTY;
+	if( rc != UNQLITE_OK ){
+		return rc;
+	}
+	if( pPager->pDb ){
+		unqlite_vm *pVm = pPager->pDb->pVms;
+		sxi32 n;
+		/* The collection headers of the acknowledged commits are already written */
+		for( n = 0 ; n < pPager->pDb->iVm ; ++n ){
+			unqliteVmDiscardCollections(pVm,FALSE);
+			pVm = pVm->pNext;
+		}
+	}
+	return unqlitePagerCommit(pPager);
+}
 /*
 ** If a write transaction is open, then all changes made within the 
 ** transaction are reverted and the current write-transaction is closed.
@@ -57434,9 +59721,13 @@ static int pager_reset_state(Pager *pPager,int bResetKvEngine)
 ** Finalization of the journal file (task 2) is only performed if the 
 ** rollback is successful.
 **
+** If group commits were acknowledged (See unqlitePagerGroupCommit()), only the
+** changes made since the last of them are reverted and the group is flushed.
+** The whole group is lost only if that flush fails.
 */
 UNQLITE_PRIVATE int unqlitePagerRollback(Pager *pPager,int bResetKvEngine)
 {
+	int rcGroup = UNQLITE_OK;
 	int rc = UNQLITE_OK;
 	if( pPager->iState < PAGER_WRITER_LOCKED ){
 		/* A write transaction must be opened */
@@ -57452,7 +59743,15 @@ UNQLITE_PRIVATE int unqlitePagerRollback(Pager *pPager,int bResetKvEngine)
 		return UNQLITE_READ_ONLY;
 	}
 	if( pPager->iState >= PAGER_WRITER_CACHEMOD ){
-		if( !pPager->no_jrnl ){
+		if( pPager->nGroupPending > 0 && (pPager->iFlags & PAGER_CTRL_COMMIT_ERR) == 0 ){
+			rcGroup = pager_group_flush_savepoint(pPager);
+		}
+		if( rcGroup == UNQLITE_OK && pPager->iState == PAGER_READER ){
+			/* The acknowledged commits are on disk, the pager is back in the
+			 * PAGER_READER state with a cold cache.
+			 */
+			pPager->dbOrigSize = pPager->dbSize;
+		}else if( !pPager->no_jrnl ){
 			/* Close any outstanding joural file */
 			if( pPager->pjfd ){
 				/* Sync the journal file */
@@ -57470,8 +59769,10 @@ UNQLITE_PRIVATE int unqlitePagerRollback(Pager *pPager,int bResetKvEngine)
 				}
 			}
 		}
-		/* Unlink the journal file */
-		unqliteOsDelete(pPager->pVfs,pPager->zJournal,1);
+		if( pPager->iState != PAGER_READER ){
+			/* Unlink the journal file */
+			unqliteOsDelete(pPager->pVfs,pPager->zJournal,1);
+		}
 		/* Reset the pager state */
 		rc = pager_reset_state(pPager,bResetKvEngine);
 		if( rc != UNQLITE_OK ){
@@ -57480,12 +59781,22 @@ UNQLITE_PRIVATE int unqlitePagerRollback(Pager *pPager,int bResetKvEngine)
 			unqliteGenError(pPager->pDb,"Error while reseting pager to its initial state");
 			return rc;
 		}
+		if( pPager->pDb ){
+			unqlite_vm *pVm = pPager->pDb->pVms;
+			sxi32 n;
+			/* The deferred collection headers of this transaction are lost */
+			for( n = 0 ; n < pPager->pDb->iVm ; ++n ){
+				unqliteVmDiscardCollections(pVm,bResetKvEngine);
+				pVm = pVm->pNext;
+			}
+		}
 	}else{
 		/* Downgrade to shared lock */
 		pager_unlock_db(pPager,SHARED_LOCK);
 		pPager->iState = PAGER_READER;
 	}
-	return UNQLITE_OK;
+	/* An error here means the acknowledged group commits were lost */
+	return rcGroup;
 }
 /*
  *  Mark a data page as non writeable.
@@ -57533,6 +59844,20 @@ static int unqlitePageWrite(unqlite_page *pMyPage)
 			return rc;
 		}
 	}
+	/* Never write through a fetched reference */
+	rc = pager_own_page_data(pPager,pPage);
+	if( rc != UNQLITE_OK ){
+		unqliteGenOutofMem(pPager->pDb);
+		return rc;
+	}
+	if( pPager->pGroupVec ){
+		/* Keep the acknowledged group commits apart from this transaction */
+		rc = pager_group_save(pPager,pPage);
+		if( rc != UNQLITE_OK ){
+			unqliteGenOutofMem(pPager->pDb);
+			return rc;
+		}
+	}
 	/* Write the page to the journal file */
 	rc = page_write(pPager,pPage);
 	return rc;
@@ -57556,6 +59881,20 @@ static int unqlitePagerAcquire(
 {
 	Page *pPage;
 	int rc;
+	if( pager_cache_only(pPager) ){
+		/* Shared reader: serve the page from the cache or fail */
+		pPage = pPager->iState == PAGER_OPEN ? 0 : pager_fetch_page(pPager,pgno);
+		if( pPage == 0 ){
+			return fetchOnly ? UNQLITE_NOTFOUND : UNQLITE_LOCKED;
+		}
+		if( ppPage ){
+			if( !fetchOnly ){
+				page_ref(pPage);
+			}
+			*ppPage = (unqlite_page *)pPage;
+		}
+		return UNQLITE_OK;
+	}
 	/* Acquire a shared lock (if not yet done) on the database and rollback any hot-journal if present */
 	rc = pager_shared_lock(pPager);
 	if( rc != UNQLITE_OK ){
@@ -57570,18 +59909,26 @@ static int unqlitePagerAcquire(
 		return pPage ? UNQLITE_OK : UNQLITE_NOTFOUND;
 	}
 	if( pPage == 0 ){
-		/* Allocate a new page */
-		pPage = pager_alloc_page(pPager,pgno);
-		if( pPage == 0 ){
-			unqliteGenOutofMem(pPager->pDb);
-			return UNQLITE_NOMEM;
-		}
-		/* Read page contents */
-		rc = pager_get_page_contents(pPager,pPage,noContent);
+		/* Serve the page by reference if the VFS allow it */
+		rc = noContent ? UNQLITE_OK : pager_fetch_page_ref(pPager,pgno,&pPage);
 		if( rc != UNQLITE_OK ){
-			SyMemBackendPoolFree(pPager->pAllocator,pPage);
+			unqliteGenOutofMem(pPager->pDb);
 			return rc;
 		}
+		if( pPage == 0 ){
+			/* Allocate a new page */
+			pPage = pager_alloc_page(pPager,pgno);
+			if( pPage == 0 ){
+				unqliteGenOutofMem(pPager->pDb);
+				return UNQLITE_NOMEM;
+			}
+			/* Read page contents */
+			rc = pager_get_page_contents(pPager,pPage,noContent);
+			if( rc != UNQLITE_OK ){
+				SyMemBackendPoolFree(pPager->pAllocator,pPage);
+				return rc;
+			}
+		}
 		/* Link the page */
 		pager_link_page(pPager,pPage);
 	}else{
@@ -57759,6 +60106,16 @@ UNQLITE_PRIVATE unqlite_kv_engine * unqlitePagerGetKvEngine(unqlite *pDb)
 {
 	return pDb->sDB.pPager->pEngine;
 }
+#if defined(UNQLITE_ENABLE_THREADS)
+/*
+ * Return the database handle a KV storage engine belong to.
+ */
+UNQLITE_PRIVATE unqlite * unqlitePagerGetDb(unqlite_kv_engine *pEngine)
+{
+	Pager *pPager = (Pager *)pEngine->pIo->pHandle;
+	return pPager->pDb;
+}
+#endif
 /*
 * Allocate and initialize a new Pager object. The pager should
 * eventually be freed by passing it to unqlitePagerClose().
@@ -57844,6 +60201,8 @@ UNQLITE_PRIVATE int unqlitePagerOpen(
 	SyRandomness(&pPager->sPrng,(void *)&pPager->cksumInit,sizeof(sxu32));
 	/* Unlimited cache size */
 	pPager->nCacheMax = SXU32_HIGH;
+	/* Read-ahead window */
+	pPager->nRaMax = UNQLITE_DEFAULT_READ_AHEAD > UNQLITE_MAX_READ_AHEAD ? UNQLITE_MAX_READ_AHEAD : UNQLITE_DEFAULT_READ_AHEAD;
 	/* Copy filename and journal name */
 	if( !is_mem ){
 		pPager->zFilename = (char *)&pPager[1];
@@ -57902,6 +60261,62 @@ UNQLITE_PRIVATE int unqlitePagerSetCachesize(Pager *pPager,int mxPage)
 	pPager->nCacheMax = mxPage;
 	return UNQLITE_OK;
 }
+/*
+ * Configure group commit. Any queued commit is flushed first.
+ */
+UNQLITE_PRIVATE int unqlitePagerSetGroupCommit(Pager *pPager,int nMaxCommit,int nWindowMs,ProcGroupTick xTick)
+{
+	int rc;
+	if( nMaxCommit < 0 || nWindowMs < 0 ){
+		return UNQLITE_INVALID;
+	}
+	/* Flush the queued commits */
+	rc = unqlitePagerGroupFlush(pPager,FALSE);
+	if( rc != UNQLITE_OK ){
+		return rc;
+	}
+	pPager->nGroupMax = (sxu32)nMaxCommit;
+	pPager->nGroupMs = (sxu32)nWindowMs;
+	pPager->xGroupTick = xTick;
+	return UNQLITE_OK;
+}
+/*
+ * Set the maximum read-ahead window in pages. 0 or 1 disable read-ahead.
+ */
+UNQLITE_PRIVATE int unqlitePagerSetReadAhead(Pager *pPager,int nMaxPage)
+{
+	if( nMaxPage < 0 || nMaxPage > UNQLITE_MAX_READ_AHEAD ){
+		return UNQLITE_INVALID;
+	}
+	pager_ra_discard(pPager);
+	if( pPager->zRa && (sxu32)nMaxPage != pPager->nRaMax ){
+		/* Reallocated on next use with the new size */
+		SyMemBackendFree(pPager->pAllocator,pPager->zRa);
+		pPager->zRa = 0;
+	}
+	pPager->nRaMax = (sxu32)nMaxPage;
+	if( pPager->nRaWindow > pPager->nRaMax ){
+		pPager->nRaWindow = pPager->nRaMax;
+	}
+	return UNQLITE_OK;
+}
+/*
+ * Report read-ahead statistics: Total number of read-ahead I/Os, prefetched pages
+ * served from the read-ahead buffer and prefetched pages discarded unused.
+ */
+UNQLITE_PRIVATE void unqlitePagerReadAheadStats(Pager *pPager,unsigned int *pnRead,unsigned int *pnHit,unsigned int *pnWaste)
+{
+	if( pnRead ){
+		*pnRead = pPager->nRaRead;
+	}
+	if( pnHit ){
+		*pnHit = pPager->nRaHit;
+	}
+	if( pnWaste ){
+		/* Pages still buffered are not (yet) wasted */
+		*pnWaste = pPager->nRaWaste;
+	}
+}
 /*
  * Shutdown the page cache. Free all memory and close the database file.
  */
@@ -57927,6 +60342,10 @@ UNQLITE_PRIVATE int unqlitePagerClose(Pager *pPager)
 		unqliteBitvecDestroy(pPager->pVec);
 		pPager->pVec = 0;
 	}
+	if( pPager->zRa ){
+		SyMemBackendFree(pPager->pAllocator,pPager->zRa);
+		pPager->zRa = 0;
+	}
 	return UNQLITE_OK;
 }
 /*
@@ -58134,6 +60553,14 @@ static void unqliteKvIoErr(unqlite_kv_handle pHandle,const char *zErr)
 	Pager *pPager = (Pager *)pHandle;
 	unqliteGenError(pPager->pDb,zErr);
 }
+/*
+ * Return TRUE if only cached pages may be accessed.
+ * Refer to [pager_cache_only()]
+ */
+static int unqliteKvIoCacheOnly(unqlite_kv_handle pHandle)
+{
+	return pager_cache_only((Pager *)pHandle);
+}
 /*
  * Init an instance of the [unqlite_kv_io] structure.
  */
@@ -58163,6 +60590,7 @@ static int pager_kv_io_init(Pager *pPager,unqlite_kv_methods *pMethods,unqlite_k
 	pIo->xSetReload = unqliteKvIoPageReload;
 
 	pIo->xErr = unqliteKvIoErr;
+	pIo->xCacheOnly = unqliteKvIoCacheOnly;
 
 	return UNQLITE_OK;
 }
@@ -58351,6 +60779,340 @@ static int CollectionCacheRelease(unqlite_col *pCol)
 	pCol->pList = 0;
 	return UNQLITE_OK;
 }
+/*
+ * Release the in-memory live records bitmap.
+ */
+static void CollectionLiveRelease(unqlite_col *pCol)
+{
+	SyMemBackend *pAlloc = &pCol->pVm->sAlloc;
+	sxu32 n;
+	for( n = 0 ; n < pCol->nLiveSize ; ++n ){
+		if( pCol->apLive[n] ){
+			SyMemBackendFree(pAlloc,(void *)pCol->apLive[n]);
+		}
+	}
+	if( pCol->apLive ){
+		SyMemBackendFree(pAlloc,(void *)pCol->apLive);
+	}
+	if( pCol->aLiveState ){
+		SyMemBackendFree(pAlloc,(void *)pCol->aLiveState);
+	}
+	pCol->apLive = 0;
+	pCol->aLiveState = 0;
+	pCol->nLiveSize = 0;
+}
+/*
+ * Build the KV key of a live records bitmap chunk in the collection working
+ * buffer, or the key of the bitmap marker if iChunk is negative.
+ */
+static void CollectionLiveKey(unqlite_col *pCol,jx9_int64 iChunk)
+{
+	SyBlob *pWorker = &pCol->sWorker;
+	SyBlobReset(pWorker);
+	SyBlobAppend(pWorker,SyStringData(&pCol->sName),SyStringLength(&pCol->sName));
+	SyBlobAppend(pWorker,"\x01",sizeof(char));
+	if( iChunk >= 0 ){
+		SyBlobFormat(pWorker,"%qd",iChunk);
+	}
+}
+/*
+ * Make room for chunk iChunk in the live records bitmap directory.
+ */
+static int CollectionLiveGrow(unqlite_col *pCol,sxu32 iChunk)
+{
+	SyMemBackend *pAlloc = &pCol->pVm->sAlloc;
+	unqlite_col_live **apNew;
+	unsigned char *aNew;
+	sxu32 nNewSize;
+	if( iChunk < pCol->nLiveSize ){
+		return UNQLITE_OK;
+	}
+	nNewSize = pCol->nLiveSize < 8 ? 8 : pCol->nLiveSize << 1;
+	while( nNewSize <= iChunk ){
+		nNewSize <<= 1;
+	}
+	apNew = (unqlite_col_live **)SyMemBackendRealloc(pAlloc,(void *)pCol->apLive,nNewSize * sizeof(unqlite_col_live *));
+	if( apNew == 0 ){
+		return UNQLITE_NOMEM;
+	}
+	pCol->apLive = apNew;
+	aNew = (unsigned char *)SyMemBackendRealloc(pAlloc,(void *)pCol->aLiveState,nNewSize);
+	if( aNew == 0 ){
+		return UNQLITE_NOMEM;
+	}
+	pCol->aLiveState = aNew;
+	/* Zero the new entries */
+	SyZero((void *)&apNew[pCol->nLiveSize],(nNewSize - pCol->nLiveSize) * sizeof(unqlite_col_live *));
+	SyZero((void *)&aNew[pCol->nLiveSize],nNewSize - pCol->nLiveSize);
+	pCol->nLiveSize = nNewSize;
+	return UNQLITE_OK;
+}
+/*
+ * Return chunk iChunk of the live records bitmap, reading it from the KV
+ * store on first access. NULL is returned for a chunk without live records
+ * unless bCreate is true, in which case an empty chunk is allocated.
+ */
+static unqlite_col_live * CollectionLiveChunk(unqlite_col *pCol,sxu32 iChunk,int bCreate)
+{
+	SyBlob *pWorker = &pCol->sWorker;
+	unqlite_col_live *pChunk;
+	if( CollectionLiveGrow(pCol,iChunk) != UNQLITE_OK ){
+		return 0;
+	}
+	if( (pCol->aLiveState[iChunk] & UNQLITE_COL_LIVE_LOADED) == 0 ){
+		pCol->aLiveState[iChunk] |= UNQLITE_COL_LIVE_LOADED;
+		CollectionLiveKey(pCol,(jx9_int64)iChunk);
+		unqlite_kv_cursor_reset(pCol->pCursor);
+		if( UNQLITE_OK == unqlite_kv_cursor_seek(pCol->pCursor,
+			SyBlobData(pWorker),SyBlobLength(pWorker),UNQLITE_CURSOR_MATCH_EXACT) ){
+			/* Read the stored chunk */
+			SyBlobReset(pWorker);
+			unqlite_kv_cursor_data_callback(pCol->pCursor,unqliteDataConsumer,pWorker);
+			pChunk = (unqlite_col_live *)SyMemBackendAlloc(&pCol->pVm->sAlloc,sizeof(unqlite_col_live));
+			if( pChunk ){
+				const unsigned char *zBits = (const unsigned char *)SyBlobData(pWorker);
+				sxu32 nByte = SyBlobLength(pWorker);
+				sxu32 n;
+				SyZero((void *)pChunk,sizeof(unqlite_col_live));
+				if( nByte > UNQLITE_COL_LIVE_BYTES ){
+					nByte = UNQLITE_COL_LIVE_BYTES;
+				}
+				for( n = 0 ; n < nByte ; ++n ){
+					unsigned char c = zBits[n];
+					pChunk->zBits[n] = c;
+					while( c ){
+						c &= (unsigned char)(c - 1);
+						pChunk->nLive++;
+					}
+				}
+				pCol->apLive[iChunk] = pChunk;
+			}
+		}
+	}
+	pChunk = pCol->apLive[iChunk];
+	if( pChunk == 0 && bCreate ){
+		pChunk = (unqlite_col_live *)SyMemBackendAlloc(&pCol->pVm->sAlloc,sizeof(unqlite_col_live));
+		if( pChunk ){
+			SyZero((void *)pChunk,sizeof(unqlite_col_live));
+			pCol->apLive[iChunk] = pChunk;
+		}
+	}
+	return pChunk;
+}
+/*
+ * Mark a record ID as live or dropped in the live records bitmap.
+ */
+static int CollectionLiveSet(unqlite_col *pCol,jx9_int64 nId,int bLive)
+{
+	unqlite_col_live *pChunk;
+	sxu32 iChunk = (sxu32)(nId / UNQLITE_COL_LIVE_BITS);
+	sxu32 iBit = (sxu32)(nId % UNQLITE_COL_LIVE_BITS);
+	unsigned char iMask = (unsigned char)(1 << (iBit & 7));
+	pChunk = CollectionLiveChunk(pCol,iChunk,bLive);
+	if( pChunk == 0 ){
+		return bLive ? UNQLITE_NOMEM : UNQLITE_OK;
+	}
+	if( bLive ){
+		if( pChunk->zBits[iBit >> 3] & iMask ){
+			return UNQLITE_OK;
+		}
+		pChunk->zBits[iBit >> 3] |= iMask;
+		pChunk->nLive++;
+	}else{
+		if( (pChunk->zBits[iBit >> 3] & iMask) == 0 ){
+			return UNQLITE_OK;
+		}
+		pChunk->zBits[iBit >> 3] &= (unsigned char)~iMask;
+		pChunk->nLive--;
+	}
+	pCol->aLiveState[iChunk] |= UNQLITE_COL_LIVE_DIRTY;
+	pCol->iFlags |= UNQLITE_COL_LIVE_CHANGED;
+	return UNQLITE_OK;
+}
+/*
+ * Return the first live record ID greater than or equal to nFrom, -1 if there is none.
+ * Chunks without live records are skipped as a whole.
+ */
+static jx9_int64 CollectionLiveNext(unqlite_col *pCol,jx9_int64 nFrom)
+{
+	unqlite_col_live *pChunk;
+	sxu32 iChunk,iBit,iByte,n;
+	if( nFrom < 0 ){
+		nFrom = 0;
+	}
+	while( nFrom < pCol->nLastid ){
+		iChunk = (sxu32)(nFrom / UNQLITE_COL_LIVE_BITS);
+		pChunk = CollectionLiveChunk(pCol,iChunk,0);
+		if( pChunk && pChunk->nLive > 0 ){
+			iBit = (sxu32)(nFrom % UNQLITE_COL_LIVE_BITS);
+			for( iByte = iBit >> 3 ; iByte < UNQLITE_COL_LIVE_BYTES ; ++iByte ){
+				unsigned char c = pChunk->zBits[iByte];
+				if( iByte == (iBit >> 3) ){
+					/* Ignore the IDs before nFrom */
+					c &= (unsigned char)(0xFF << (iBit & 7));
+				}
+				if( c ){
+					jx9_int64 nId;
+					for( n = 0 ; (c & 1) == 0 ; ++n ){
+						c >>= 1;
+					}
+					nId = (jx9_int64)iChunk * UNQLITE_COL_LIVE_BITS + iByte * 8 + n;
+					return nId < pCol->nLastid ? nId : -1;
+				}
+			}
+		}
+		/* Next chunk */
+		nFrom = (jx9_int64)(iChunk + 1) * UNQLITE_COL_LIVE_BITS;
+	}
+	return -1;
+}
+/*
+ * Return the last live record ID lower than or equal to nFrom, -1 if there is none.
+ * Chunks without live records are skipped as a whole.
+ */
+static jx9_int64 CollectionLivePrev(unqlite_col *pCol,jx9_int64 nFrom)
+{
+	unqlite_col_live *pChunk;
+	sxu32 iChunk,iBit,iByte,n;
+	if( nFrom >= pCol->nLastid ){
+		nFrom = pCol->nLastid - 1;
+	}
+	while( nFrom >= 0 ){
+		iChunk = (sxu32)(nFrom / UNQLITE_COL_LIVE_BITS);
+		pChunk = CollectionLiveChunk(pCol,iChunk,0);
+		if( pChunk && pChunk->nLive > 0 ){
+			iBit = (sxu32)(nFrom % UNQLITE_COL_LIVE_BITS);
+			for( iByte = iBit >> 3 ; ; --iByte ){
+				unsigned char c = pChunk->zBits[iByte];
+				if( iByte == (iBit >> 3) ){
+					/* Ignore the IDs after nFrom */
+					c &= (unsigned char)(0xFF >> (7 - (iBit & 7)));
+				}
+				if( c ){
+					for( n = 7 ; (c & 0x80) == 0 ; --n ){
+						c <<= 1;
+					}
+					return (jx9_int64)iChunk * UNQLITE_COL_LIVE_BITS + iByte * 8 + n;
+				}
+				if( iByte == 0 ){
+					break;
+				}
+			}
+		}
+		/* Previous chunk */
+		nFrom = (jx9_int64)iChunk * UNQLITE_COL_LIVE_BITS - 1;
+	}
+	return -1;
+}
+/*
+ * Prepare the live records bitmap of a freshly loaded or created collection.
+ * Chunks are read on demand. A collection created before live bitmaps were
+ * introduced has no bitmap marker: its bitmap is built once by probing every
+ * record ID and is written with the next collection header flush.
+ */
+static int CollectionLoadLive(unqlite_col *pCol,int bCreate)
+{
+	SyBlob *pWorker = &pCol->sWorker;
+	jx9_int64 nId;
+	int rc;
+	if( bCreate ){
+		pCol->iFlags |= UNQLITE_COL_LIVE_NEW;
+		return UNQLITE_OK;
+	}
+	/* Look for the bitmap marker */
+	CollectionLiveKey(pCol,-1);
+	unqlite_kv_cursor_reset(pCol->pCursor);
+	rc = unqlite_kv_cursor_seek(pCol->pCursor,SyBlobData(pWorker),SyBlobLength(pWorker),UNQLITE_CURSOR_MATCH_EXACT);
+	if( rc == UNQLITE_OK ){
+		return UNQLITE_OK;
+	}
+	/* Build the bitmap */
+	for( nId = 0 ; nId < pCol->nLastid ; ++nId ){
+		SyBlobReset(pWorker);
+		SyBlobFormat(pWorker,"%z_%qd",&pCol->sName,nId);
+		unqlite_kv_cursor_reset(pCol->pCursor);
+		rc = unqlite_kv_cursor_seek(pCol->pCursor,SyBlobData(pWorker),SyBlobLength(pWorker),UNQLITE_CURSOR_MATCH_EXACT);
+		if( rc == UNQLITE_OK ){
+			rc = CollectionLiveSet(pCol,nId,1);
+			if( rc != UNQLITE_OK ){
+				return rc;
+			}
+		}
+	}
+	pCol->iFlags |= UNQLITE_COL_LIVE_NEW;
+	return UNQLITE_OK;
+}
+/*
+ * Write the dirty chunks of the live records bitmap (and its marker if needed).
+ * Chunks left without live records are removed from the KV store.
+ */
+static int CollectionFlushLive(unqlite_col *pCol)
+{
+	static const unsigned char zMarker[] = { 1 /* Bitmap format */ };
+	SyBlob *pWorker = &pCol->sWorker;
+	unqlite_kv_methods *pMethods;
+	unqlite_kv_engine *pEngine;
+	unqlite_col_live *pChunk;
+	sxu32 n;
+	int rc;
+	pEngine = unqlitePagerGetKvEngine(pCol->pVm->pDb);
+	pMethods = pEngine->pIo->pMethods;
+	if( pMethods->xReplace == 0 || pEngine->pIo->xReadOnly(pEngine->pIo->pHandle) ){
+		/* Nothing can be written, keep the bitmap in memory */
+		pCol->iFlags &= ~(UNQLITE_COL_LIVE_CHANGED|UNQLITE_COL_LIVE_NEW);
+		return UNQLITE_OK;
+	}
+	if( pCol->iFlags & UNQLITE_COL_LIVE_NEW ){
+		CollectionLiveKey(pCol,-1);
+		rc = pMethods->xReplace(pEngine,SyBlobData(pWorker),SyBlobLength(pWorker),zMarker,sizeof(zMarker));
+		if( rc != UNQLITE_OK ){
+			return rc;
+		}
+		pCol->iFlags &= ~UNQLITE_COL_LIVE_NEW;
+	}
+	if( (pCol->iFlags & UNQLITE_COL_LIVE_CHANGED) == 0 ){
+		return UNQLITE_OK;
+	}
+	for( n = 0 ; n < pCol->nLiveSize ; ++n ){
+		if( (pCol->aLiveState[n] & UNQLITE_COL_LIVE_DIRTY) == 0 ){
+			continue;
+		}
+		pChunk = pCol->apLive[n];
+		CollectionLiveKey(pCol,(jx9_int64)n);
+		if( pChunk && pChunk->nLive > 0 ){
+			rc = pMethods->xReplace(pEngine,SyBlobData(pWorker),SyBlobLength(pWorker),pChunk->zBits,UNQLITE_COL_LIVE_BYTES);
+		}else{
+			/* No more live records in this chunk */
+			unqlite_kv_cursor_reset(pCol->pCursor);
+			rc = unqlite_kv_cursor_seek(pCol->pCursor,SyBlobData(pWorker),SyBlobLength(pWorker),UNQLITE_CURSOR_MATCH_EXACT);
+			rc = (rc == UNQLITE_OK) ? unqlite_kv_cursor_delete_entry(pCol->pCursor) : UNQLITE_OK;
+			if( pChunk ){
+				SyMemBackendFree(&pCol->pVm->sAlloc,(void *)pChunk);
+				pCol->apLive[n] = 0;
+			}
+		}
+		if( rc != UNQLITE_OK ){
+			return rc;
+		}
+		pCol->aLiveState[n] &= ~UNQLITE_COL_LIVE_DIRTY;
+	}
+	pCol->iFlags &= ~UNQLITE_COL_LIVE_CHANGED;
+	return UNQLITE_OK;
+}
+/*
+ * Return the ID of the first live record of a collection, -1 if it is empty.
+ */
+UNQLITE_PRIVATE jx9_int64 unqliteCollectionFirstLiveId(unqlite_col *pCol)
+{
+	return CollectionLiveNext(pCol,0);
+}
+/*
+ * Return the ID of the last live record of a collection, -1 if it is empty.
+ */
+UNQLITE_PRIVATE jx9_int64 unqliteCollectionLastLiveId(unqlite_col *pCol)
+{
+	return CollectionLivePrev(pCol,pCol->nLastid - 1);
+}
 /*
  * Install a freshly created collection in the unqlite VM.
  */
@@ -58502,6 +61264,15 @@ static int CollectionSetHeader(
 		iWrite = 1;
 	}else{
 		unsigned char *zBinary = (unsigned char *)SyBlobData(pHeader);
+		if( pCol->iFlags & UNQLITE_COL_HEADER_DIRTY ){
+			/* Pick up the deferred record ID and count */
+			if( iRec < 0 ){
+				iRec = pCol->nLastid;
+			}
+			if( iTotal < 0 ){
+				iTotal = pCol->nTotRec;
+			}
+		}
 		/* Header update */
 		if( iRec >= 0 ){
 			/* Update record ID */
@@ -58540,9 +61311,73 @@ static int CollectionSetHeader(
 				);
 			return rc;
 		}
+		pCol->iFlags &= ~UNQLITE_COL_HEADER_DIRTY;
 	}
 	return UNQLITE_OK;
 }
+/*
+ * Write the collection header if record ID and count updates were deferred,
+ * together with the changes of the live records bitmap.
+ */
+static int CollectionFlushHeader(unqlite_col *pCol)
+{
+	if( pCol->iFlags & (UNQLITE_COL_LIVE_CHANGED|UNQLITE_COL_LIVE_NEW) ){
+		int rc;
+		/* Live records bitmap first */
+		rc = CollectionFlushLive(pCol);
+		if( rc != UNQLITE_OK ){
+			return rc;
+		}
+	}
+	if( (pCol->iFlags & UNQLITE_COL_HEADER_DIRTY) == 0 ){
+		return UNQLITE_OK;
+	}
+	return CollectionSetHeader(0,pCol,pCol->nLastid,pCol->nTotRec,0);
+}
+/*
+ * Write the deferred headers of the collections loaded by a VM.
+ * This is done before each commit and when the VM is released.
+ */
+UNQLITE_PRIVATE int unqliteVmFlushCollections(unqlite_vm *pVm)
+{
+	unqlite_col *pCol = pVm->pCol;
+	int rc = UNQLITE_OK;
+	sxu32 n;
+	for( n = 0 ; n < pVm->iCol ; ++n ){
+		int rc2 = CollectionFlushHeader(pCol);
+		if( rc2 != UNQLITE_OK && rc == UNQLITE_OK ){
+			rc = rc2;
+		}
+		pCol = pCol->pNext;
+	}
+	return rc;
+}
+/*
+ * Records stored after the last header update are not accounted in the
+ * header if that update was lost (e.g. the header of another VM was written
+ * last). Probe the record IDs past the header's one and bring the in-memory
+ * counters up to date. This costs a single lookup in the common case.
+ */
+static void CollectionRecoverLastId(unqlite_col *pCol)
+{
+	SyBlob *pWorker = &pCol->sWorker;
+	int rc;
+	for(;;){
+		SyBlobReset(pWorker);
+		SyBlobFormat(pWorker,"%z_%qd",&pCol->sName,pCol->nLastid);
+		unqlite_kv_cursor_reset(pCol->pCursor);
+		rc = unqlite_kv_cursor_seek(pCol->pCursor,
+			SyBlobData(pWorker),SyBlobLength(pWorker),
+			UNQLITE_CURSOR_MATCH_EXACT
+			);
+		if( rc != UNQLITE_OK ){
+			break;
+		}
+		CollectionLiveSet(pCol,pCol->nLastid,1);
+		pCol->nLastid++;
+		pCol->nTotRec++;
+	}
+}
 /*
  * Load a binary collection from disk.
  */
@@ -58589,6 +61424,43 @@ static int CollectionLoadHeader(unqlite_col *pCol)
 	}
 	return UNQLITE_OK;
 }
+/*
+ * Forget the deferred header and live records bitmap changes of the collections
+ * loaded by a VM once the transaction they belong to was rolled back.
+ * If bReload is true, the counters are read again from the stored header and the
+ * dropped bitmap chunks are read again on demand. Otherwise the VM is about to be
+ * released together with its database handle and nothing is read.
+ */
+UNQLITE_PRIVATE void unqliteVmDiscardCollections(unqlite_vm *pVm,int bReload)
+{
+	unqlite_col *pCol = pVm->pCol;
+	sxu32 n,i;
+	for( n = 0 ; n < pVm->iCol ; ++n ){
+		pCol->iFlags &= ~UNQLITE_COL_HEADER_DIRTY;
+		if( (pCol->iFlags & UNQLITE_COL_LIVE_NEW) == 0 ){
+			/* A bitmap that was never stored (See CollectionLoadLive()) is kept as is */
+			for( i = 0 ; i < pCol->nLiveSize ; ++i ){
+				if( pCol->aLiveState[i] & UNQLITE_COL_LIVE_DIRTY ){
+					if( pCol->apLive[i] ){
+						SyMemBackendFree(&pVm->sAlloc,pCol->apLive[i]);
+						pCol->apLive[i] = 0;
+					}
+					pCol->aLiveState[i] = 0;
+				}
+			}
+			pCol->iFlags &= ~UNQLITE_COL_LIVE_CHANGED;
+		}
+		if( bReload ){
+			unqlite_kv_cursor_reset(pCol->pCursor);
+			if( UNQLITE_OK == unqlite_kv_cursor_seek(pCol->pCursor,
+				SyStringData(&pCol->sName),SyStringLength(&pCol->sName),UNQLITE_CURSOR_MATCH_EXACT) ){
+				jx9MemObjRelease(&pCol->sSchema);
+				CollectionLoadHeader(pCol);
+			}
+		}
+		pCol = pCol->pNext;
+	}
+}
 /*
  * Load or create a binary collection.
  */
@@ -58677,6 +61549,7 @@ static int unqliteVmLoadCollection(
 			rc = UNQLITE_ABORT; /* Abort VM execution */
 			goto fail;
 		}
+		CollectionLoadLive(pCol,1);
 	}else{
 		/* Read the collection header */
 		rc = CollectionLoadHeader(pCol);
@@ -58684,6 +61557,12 @@ static int unqliteVmLoadCollection(
 			unqliteGenErrorFormat(pDb,"Corrupt collection '%z' header",&pCol->sName);
 			goto fail;
 		}
+		rc = CollectionLoadLive(pCol,0);
+		if( rc != UNQLITE_OK ){
+			unqliteGenOutofMem(pDb);
+			goto fail;
+		}
+		CollectionRecoverLastId(pCol);
 	}
 	/* Finally install the collection */
 	unqliteVmInstallCollection(pVm,pCol);
@@ -58701,6 +61580,7 @@ fail:
 		if( pCol->apRecord ){
 			SyMemBackendFree(&pVm->sAlloc,(void *)pCol->apRecord);
 		}
+		CollectionLiveRelease(pCol);
 		SyBlobRelease(&pCol->sHeader);
 		SyBlobRelease(&pCol->sWorker);
 		jx9MemObjRelease(&pCol->sSchema);
@@ -58756,18 +61636,73 @@ UNQLITE_PRIVATE jx9_int64 unqliteCollectionTotalRecords(unqlite_col *pCol)
 }
 /*
  * Reset the record cursor.
+ * The cursor is positioned on the first live record so that db_current_record_id()
+ * reports the ID the next db_fetch() returns.
  */
 UNQLITE_PRIVATE void unqliteCollectionResetRecordCursor(unqlite_col *pCol)
 {
-	pCol->nCurid = 0;
+	jx9_int64 nId;
+	nId = unqliteCollectionFirstLiveId(pCol);
+	pCol->nCurid = nId < 0 ? 0 : nId;
 }
 /*
- * Fetch a record by its unique ID.
+ * Copy the given fields of a cached record.
  */
-UNQLITE_PRIVATE int unqliteCollectionFetchRecordById(
+static int CollectionProjectRecord(
+	jx9_value *pRecord, /* Cached record */
+	jx9_value *pValue,  /* OUT: Projected record */
+	SySet *pFields      /* Fields to copy (SyString) */
+	)
+{
+	jx9_hashmap_node *pNode;
+	jx9_hashmap *pSrc,*pMap;
+	const char *zKey;
+	jx9_value sKey;
+	int nKey;
+	int rc;
+	if( !jx9_value_is_json_object(pRecord) ){
+		/* Nothing to project */
+		jx9MemObjStore(pRecord,pValue);
+		return UNQLITE_OK;
+	}
+	pSrc = (jx9_hashmap *)pRecord->x.pOther;
+	pMap = (jx9_hashmap *)jx9NewHashmap(pValue->pVm,0,0);
+	if( pMap == 0 ){
+		return UNQLITE_NOMEM;
+	}
+	pMap->iFlags |= HASHMAP_JSON_OBJECT;
+	jx9MemObjRelease(pValue);
+	MemObjSetType(pValue,MEMOBJ_HASHMAP);
+	pValue->x.pOther = pMap;
+	jx9MemObjInit(pValue->pVm,&sKey);
+	rc = UNQLITE_OK;
+	jx9HashmapResetLoopCursor(pSrc);
+	while( (pNode = jx9HashmapGetNextEntry(pSrc)) != 0 ){
+		jx9HashmapExtractNodeKey(pNode,&sKey);
+		zKey = jx9_value_to_string(&sKey,&nKey);
+		if( FastJsonFieldLookup(pFields,zKey,(sxu32)nKey) ){
+			rc = jx9HashmapInsert(pMap,&sKey,jx9HashmapGetNodeValue(pNode));
+			if( rc != UNQLITE_OK ){
+				break;
+			}
+		}
+	}
+	jx9MemObjRelease(&sKey);
+	return rc;
+}
+/*
+ * Fetch a record by its unique ID, or only some of its fields if pFields is not NULL.
+ * Projected records are decoded straight from the binary JSON (See FastJsonDecodeFields())
+ * and are not cached.
+ * If pFilter is not NULL, it is evaluated against the binary JSON before anything is
+ * decoded and UNQLITE_NOTFOUND is returned for a record that does not match.
+ */
+static int CollectionFetchRecord(
 	unqlite_col *pCol, /* Target collection */
 	jx9_int64 nId,     /* Unique record ID */
-	jx9_value *pValue  /* OUT: record value */
+	jx9_value *pValue, /* OUT: record value */
+	SySet *pFields,    /* Fields to extract (SyString) or NULL for the whole record */
+	unqlite_col_filter *pFilter /* Declarative filter or NULL */
 	)
 {
 	SyBlob *pWorker = &pCol->sWorker;
@@ -58777,6 +61712,17 @@ UNQLITE_PRIVATE int unqliteCollectionFetchRecordById(
 	/* Perform a cache lookup first */
 	pRec = CollectionCacheFetchRecord(pCol,nId);
 	if( pRec ){
+		if( pFilter ){
+			/* The filter works on the binary form */
+			SyBlobReset(pWorker);
+			FastJsonEncode(&pRec->sValue,pWorker,0);
+			if( !unqliteFilterMatch(pFilter,(const unsigned char *)SyBlobData(pWorker),SyBlobLength(pWorker)) ){
+				return UNQLITE_NOTFOUND;
+			}
+		}
+		if( pFields ){
+			return CollectionProjectRecord(&pRec->sValue,pValue,pFields);
+		}
 		/* Copy record value */
 		jx9MemObjStore(&pRec->sValue,pValue);
 		return UNQLITE_OK;
@@ -58803,6 +61749,12 @@ UNQLITE_PRIVATE int unqliteCollectionFetchRecordById(
 			"Empty record '%qd'",nId
 			);
 		jx9_value_null(pValue);
+	}else if( pFilter && !unqliteFilterMatch(pFilter,(const unsigned char *)SyBlobData(pWorker),SyBlobLength(pWorker)) ){
+		/* Filtered out, nothing to decode */
+		rc = UNQLITE_NOTFOUND;
+	}else if( pFields ){
+		/* Decode the requested fields only */
+		rc = FastJsonDecodeFields(SyBlobData(pWorker),SyBlobLength(pWorker),pValue,pFields);
 	}else{
 		/* Decode the binary JSON */
 		rc = FastJsonDecode(SyBlobData(pWorker),SyBlobLength(pWorker),pValue,0,0);
@@ -58813,22 +61765,38 @@ UNQLITE_PRIVATE int unqliteCollectionFetchRecordById(
 	}
 	return rc;
 }
+/*
+ * Fetch a record by its unique ID.
+ */
+UNQLITE_PRIVATE int unqliteCollectionFetchRecordById(
+	unqlite_col *pCol, /* Target collection */
+	jx9_int64 nId,     /* Unique record ID */
+	jx9_value *pValue  /* OUT: record value */
+	)
+{
+	return CollectionFetchRecord(&(*pCol),nId,pValue,0,0);
+}
 /*
  * Fetch the next record from a given collection.
+ * If pFields is not NULL, only the given fields are extracted.
+ * If pFilter is not NULL, records that do not match are skipped.
  */ 
-UNQLITE_PRIVATE int unqliteCollectionFetchNextRecord(unqlite_col *pCol,jx9_value *pValue)
+UNQLITE_PRIVATE int unqliteCollectionFetchNextRecord(unqlite_col *pCol,jx9_value *pValue,SySet *pFields,unqlite_col_filter *pFilter)
 {
+	jx9_int64 nId;
 	int rc;
 	for(;;){
-		if( pCol->nCurid >= pCol->nLastid ){
+		/* Jump to the next live record */
+		nId = CollectionLiveNext(pCol,pCol->nCurid);
+		if( nId < 0 ){
 			/* No more records, reset the record cursor ID */
 			pCol->nCurid = 0;
 			/* Return to the caller */
 			return SXERR_EOF;
 		}
-		rc = unqliteCollectionFetchRecordById(pCol,pCol->nCurid,pValue);
-		/* Increment the record ID */
-		pCol->nCurid++;
+		rc = CollectionFetchRecord(pCol,nId,pValue,pFields,pFilter);
+		/* Point past the record */
+		pCol->nCurid = nId + 1;
 		/* Lookup result */
 		if( rc == UNQLITE_OK || rc != UNQLITE_NOTFOUND ){
 			break;
@@ -58888,35 +61856,47 @@ UNQLITE_PRIVATE int unqliteCollectionSetSchema(unqlite_col *pCol,jx9_value *pVal
 	return rc;
 }
 /*
- * Perform a store operation on a given collection.
+ * Return the storage engine a record can be stored into or NULL
+ * (with an error message) if it is read-only.
  */
-static int CollectionStore(
-	unqlite_col *pCol, /* Target collection */
-	jx9_value *pValue  /* JSON value to be stored */
-	)
+static unqlite_kv_engine * CollectionStoreEngine(unqlite_col *pCol)
 {
-	SyBlob *pWorker = &pCol->sWorker;
-	unqlite_kv_methods *pMethods;
 	unqlite_kv_engine *pEngine;
-	sxu32 nKeyLen;
-	int rc;	
 	/* Point to the underlying KV store */
 	pEngine = unqlitePagerGetKvEngine(pCol->pVm->pDb);
-	pMethods = pEngine->pIo->pMethods;
-	if( pCol->nTotRec >= SXI64_HIGH ){
-		/* Collection limit reached. No more records */
+	if( pEngine->pIo->pMethods->xReplace == 0 ){
 		unqliteGenErrorFormat(pCol->pVm->pDb,
-				"Collection '%z': Records limit reached",
+				"Cannot store record into collection '%z' due to a read-only Key/Value storage engine",
 				&pCol->sName
 			);
-		return UNQLITE_LIMIT;
+		return 0;
 	}
-	if( pMethods->xReplace == 0 ){
+	return pEngine;
+}
+/*
+ * Insert a record in the storage engine under the next unique ID.
+ * The new record ID and count are kept in memory and the collection
+ * header is only marked dirty: it is written once, by the next commit
+ * or when the VM is released (See unqliteVmFlushCollections()), instead
+ * of being replaced after every record.
+ */
+static int CollectionInsertRecord(
+	unqlite_col *pCol,          /* Target collection */
+	unqlite_kv_engine *pEngine, /* Storage engine (See CollectionStoreEngine()) */
+	jx9_value *pValue           /* JSON value to be stored */
+	)
+{
+	SyBlob *pWorker = &pCol->sWorker;
+	unqlite_kv_methods *pMethods = pEngine->pIo->pMethods;
+	sxu32 nKeyLen;
+	int rc;
+	if( pCol->nTotRec >= SXI64_HIGH ){
+		/* Collection limit reached. No more records */
 		unqliteGenErrorFormat(pCol->pVm->pDb,
-				"Cannot store record into collection '%z' due to a read-only Key/Value storage engine",
+				"Collection '%z': Records limit reached",
 				&pCol->sName
 			);
-		return UNQLITE_READ_ONLY;
+		return UNQLITE_LIMIT;
 	}
 	/* Reset the working buffer */
 	SyBlobReset(pWorker);
@@ -58951,8 +61931,9 @@ static int CollectionStore(
 		/* Increment the unique __id */
 		pCol->nLastid++;
 		pCol->nTotRec++;
-		/* Reflect the change */
-		rc = CollectionSetHeader(0,pCol,pCol->nLastid,pCol->nTotRec,0);
+		/* Reflect the change later */
+		pCol->iFlags |= UNQLITE_COL_HEADER_DIRTY;
+		rc = CollectionLiveSet(pCol,pCol->nLastid - 1,1);
 	}
 	if( rc != UNQLITE_OK ){
 		unqliteGenErrorFormat(pCol->pVm->pDb,
@@ -58963,6 +61944,58 @@ static int CollectionStore(
 	}
 	return UNQLITE_OK;
 }
+/*
+ * Perform a store operation on a given collection.
+ */
+static int CollectionStore(
+	unqlite_col *pCol, /* Target collection */
+	jx9_value *pValue  /* JSON value to be stored */
+	)
+{
+	unqlite_kv_engine *pEngine;
+	pEngine = CollectionStoreEngine(pCol);
+	if( pEngine == 0 ){
+		return UNQLITE_READ_ONLY;
+	}
+	return CollectionInsertRecord(pCol,pEngine,pValue);
+}
+/*
+ * Batch insertion state (See CollectionStoreBatch()).
+ */
+typedef struct col_batch col_batch;
+struct col_batch
+{
+	unqlite_col *pCol;          /* Target collection */
+	unqlite_kv_engine *pEngine; /* Storage engine */
+};
+/*
+ * Array walker callback (Refer to jx9_array_walk()) of a batch insertion.
+ */
+static int CollectionBatchWalker(jx9_value *pKey,jx9_value *pData,void *pUserData)
+{
+	col_batch *pBatch = (col_batch *)pUserData;
+	SXUNUSED(pKey); /* cc warning */
+	return CollectionInsertRecord(pBatch->pCol,pBatch->pEngine,pData);
+}
+/*
+ * Store every member of a JSON array in a given collection.
+ * The storage engine is resolved and checked once for the whole batch, every
+ * record is then encoded and inserted in a single walk of the array and the
+ * collection header is written once for the batch rather than once per record.
+ */
+static int CollectionStoreBatch(
+	unqlite_col *pCol, /* Target collection */
+	jx9_value *pArray  /* JSON array of records */
+	)
+{
+	col_batch sBatch;
+	sBatch.pCol = pCol;
+	sBatch.pEngine = CollectionStoreEngine(pCol);
+	if( sBatch.pEngine == 0 ){
+		return UNQLITE_READ_ONLY;
+	}
+	return jx9_array_walk(pArray,CollectionBatchWalker,&sBatch);
+}
 /*
  * Perform a update operation on a given collection.
  */
@@ -59074,8 +62107,8 @@ UNQLITE_PRIVATE int unqliteCollectionPut(unqlite_col *pCol,jx9_value *pValue,int
 {
 	int rc;
 	if( !jx9_value_is_json_object(pValue) && jx9_value_is_json_array(pValue) ){
-		/* Iterate over the array and store its members in the collection */
-		rc = jx9_array_walk(pValue,CollectionRecordArrayWalker,pCol);
+		/* Store the array members in the collection */
+		rc = CollectionStoreBatch(pCol,pValue);
 		SXUNUSED(iFlag); /* cc warning */
 	}else{
 		rc = CollectionStore(pCol,pValue);
@@ -59113,6 +62146,7 @@ UNQLITE_PRIVATE int unqliteCollectionDropRecord(
 	/* Finally, Remove the record from the cache */
 	unqliteCollectionCacheRemoveRecord(pCol,nId);
 	if( rc == UNQLITE_OK ){
+		CollectionLiveSet(pCol,nId,0);
 		pCol->nTotRec--;
 		if( wr_header ){
 			/* Relect in the collection header */
@@ -59171,11 +62205,20 @@ UNQLITE_PRIVATE int unqliteDropCollection(unqlite_col *pCol)
 		return rc;
 	}
 	/* Drop collection records */
-	for( nId = 0 ; nId < pCol->nLastid ; ++nId ){
+	for( nId = CollectionLiveNext(pCol,0) ; nId >= 0 ; nId = CollectionLiveNext(pCol,nId + 1) ){
 		unqliteCollectionDropRecord(pCol,nId,0,0);
 	}
+	/* Drop the live records bitmap: its chunks are now empty */
+	CollectionFlushLive(pCol);
+	CollectionLiveKey(pCol,-1);
+	unqlite_kv_cursor_reset(pCol->pCursor);
+	if( UNQLITE_OK == unqlite_kv_cursor_seek(pCol->pCursor,
+		SyBlobData(&pCol->sWorker),SyBlobLength(&pCol->sWorker),UNQLITE_CURSOR_MATCH_EXACT) ){
+		unqlite_kv_cursor_delete_entry(pCol->pCursor);
+	}
 	/* Cleanup */
 	CollectionCacheRelease(pCol);
+	CollectionLiveRelease(pCol);
 	SyBlobRelease(&pCol->sHeader);
 	SyBlobRelease(&pCol->sWorker);
 	SyMemBackendFree(&pVm->sAlloc,(void *)SyStringData(&pCol->sName));
@@ -59414,7 +62457,7 @@ static int unqliteBuiltin_db_fetch_next(jx9_context *pCtx,int argc,jx9_value **a
 			jx9_result_null(pCtx);
 			return JX9_OK;
 		}else{
-			rc = unqliteCollectionFetchNextRecord(pCol,pValue);
+			rc = unqliteCollectionFetchNextRecord(pCol,pValue,0,0);
 			if( rc == UNQLITE_OK ){
 				jx9_result_value(pCtx,pValue);
 				/* pValue will be automatically released as soon we return from this function */
@@ -59494,12 +62537,436 @@ static int unqliteBuiltin_db_fetch_by_id(jx9_context *pCtx,int argc,jx9_value **
 	return JX9_OK;
 }
 /*
- * array db_fetch_all(string $col_name,[callback filter_callback])
- * array db_get_all(string $col_name,[callback filter_callback])
+ * Append a term to a declarative filter. Return its index.
+ */
+static sxu32 FilterPushTerm(unqlite_col_filter *pFilter,int iOp,sxu32 iField)
+{
+	unqlite_filter_term sTerm;
+	SyZero(&sTerm,sizeof(unqlite_filter_term));
+	sTerm.iOp = iOp;
+	sTerm.nTerm = 1;
+	sTerm.iField = iField;
+	sTerm.iType = FJSON_NULL;
+	SySetPut(&pFilter->aTerm,(const void *)&sTerm);
+	return SySetUsed(&pFilter->aTerm) - 1;
+}
+/*
+ * Close a composite term once its sub-terms are compiled.
+ */
+static void FilterCloseTerm(unqlite_col_filter *pFilter,sxu32 iTerm)
+{
+	unqlite_filter_term *aTerm = (unqlite_filter_term *)SySetBasePtr(&pFilter->aTerm);
+	aTerm[iTerm].nTerm = SySetUsed(&pFilter->aTerm) - iTerm;
+}
+/*
+ * Return the index of a compared field, registering it if needed.
+ */
+static sxu32 FilterFieldIndex(unqlite_col_filter *pFilter,const char *zName,sxu32 nByte)
+{
+	SyString *aField = (SyString *)SySetBasePtr(&pFilter->aField);
+	SyString sField;
+	sxu32 n;
+	for( n = 0 ; n < SySetUsed(&pFilter->aField) ; ++n ){
+		if( aField[n].nByte == nByte && SyMemcmp(aField[n].zString,zName,nByte) == 0 ){
+			return n;
+		}
+	}
+	/* The filter value outlives the query, point to its keys */
+	SyStringInitFromBuf(&sField,zName,nByte);
+	SySetPut(&pFilter->aField,(const void *)&sField);
+	return SySetUsed(&pFilter->aField) - 1;
+}
+/*
+ * Check whether a filter key is the given name.
+ */
+static int FilterKeyIs(SyString *pKey,const char *zName)
+{
+	sxu32 nByte = SyStrlen(zName);
+	return pKey->nByte == nByte && SyMemcmp(pKey->zString,zName,nByte) == 0;
+}
+/*
+ * Append a comparison of the given field with a scalar operand.
+ */
+static int FilterPushCompare(unqlite_col_filter *pFilter,int iOp,sxu32 iField,jx9_value *pOperand)
+{
+	unqlite_filter_term *pTerm;
+	sxu32 iTerm;
+	int iType;
+	if( jx9_value_is_null(pOperand) ){
+		iType = FJSON_NULL;
+	}else if( jx9_value_is_bool(pOperand) ){
+		iType = jx9_value_to_bool(pOperand) ? FJSON_TRUE : FJSON_FALSE;
+	}else if( jx9_value_is_int(pOperand) ){
+		iType = FJSON_INT64;
+	}else if( jx9_value_is_float(pOperand) ){
+		iType = FJSON_REAL;
+	}else if( jx9_value_is_string(pOperand) ){
+		iType = FJSON_STRING;
+	}else{
+		/* Arrays and resources cannot be compared */
+		return UNQLITE_INVALID;
+	}
+	iTerm = FilterPushTerm(&(*pFilter),iOp,iField);
+	pTerm = (unqlite_filter_term *)SySetAt(&pFilter->aTerm,iTerm);
+	pTerm->iType = iType;
+	if( iType == FJSON_INT64 ){
+		pTerm->iVal = jx9_value_to_int64(pOperand);
+	}else if( iType == FJSON_REAL ){
+		pTerm->rVal = jx9_value_to_double(pOperand);
+	}else if( iType == FJSON_STRING ){
+		SyStringInitFromBuf(&pTerm->sVal,SyBlobData(&pOperand->sBlob),SyBlobLength(&pOperand->sBlob));
+	}
+	return UNQLITE_OK;
+}
+/*
+ * Compile the operators of a field condition (e.g. {'>': 10, '<=': 20, in: [1,2]}).
+ * The operators are ANDed.
+ */
+static int FilterCompileOperators(unqlite_col_filter *pFilter,sxu32 iField,jx9_value *pOps)
+{
+	static const struct {
+		const char *zOp;
+		int iOp;
+	} aOp[] = {
+		{ "==", UNQLITE_FILTER_EQ },
+		{ "!=", UNQLITE_FILTER_NE },
+		{ "<",  UNQLITE_FILTER_LT },
+		{ "<=", UNQLITE_FILTER_LE },
+		{ ">",  UNQLITE_FILTER_GT },
+		{ ">=", UNQLITE_FILTER_GE }
+	};
+	jx9_hashmap *pMap = (jx9_hashmap *)pOps->x.pOther;
+	jx9_hashmap_node *pNode,*pEntry;
+	jx9_value *pOperand;
+	SyString sOp;
+	sxu32 iTerm,iIn,n;
+	int rc = UNQLITE_OK;
+	iTerm = FilterPushTerm(&(*pFilter),UNQLITE_FILTER_AND,0);
+	jx9HashmapResetLoopCursor(pMap);
+	while( (pNode = jx9HashmapGetNextEntry(pMap)) != 0 ){
+		if( pNode->iType != HASHMAP_BLOB_NODE ){
+			return UNQLITE_INVALID;
+		}
+		SyStringInitFromBuf(&sOp,SyBlobData(&pNode->xKey.sKey),SyBlobLength(&pNode->xKey.sKey));
+		pOperand = jx9HashmapGetNodeValue(pNode);
+		if( FilterKeyIs(&sOp,"in") ){
+			/* Membership: ORed equalities */
+			jx9_hashmap *pList;
+			if( !jx9_value_is_json_array(pOperand) || jx9_value_is_json_object(pOperand) ){
+				return UNQLITE_INVALID;
+			}
+			pList = (jx9_hashmap *)pOperand->x.pOther;
+			iIn = FilterPushTerm(&(*pFilter),UNQLITE_FILTER_OR,0);
+			jx9HashmapResetLoopCursor(pList);
+			while( (pEntry = jx9HashmapGetNextEntry(pList)) != 0 ){
+				rc = FilterPushCompare(&(*pFilter),UNQLITE_FILTER_EQ,iField,jx9HashmapGetNodeValue(pEntry));
+				if( rc != UNQLITE_OK ){
+					return rc;
+				}
+			}
+			FilterCloseTerm(&(*pFilter),iIn);
+			continue;
+		}
+		for( n = 0 ; n < SX_ARRAYSIZE(aOp) ; ++n ){
+			if( FilterKeyIs(&sOp,aOp[n].zOp) ){
+				break;
+			}
+		}
+		if( n >= SX_ARRAYSIZE(aOp) ){
+			/* Unknown operator */
+			return UNQLITE_INVALID;
+		}
+		rc = FilterPushCompare(&(*pFilter),aOp[n].iOp,iField,pOperand);
+		if( rc != UNQLITE_OK ){
+			return rc;
+		}
+	}
+	FilterCloseTerm(&(*pFilter),iTerm);
+	return UNQLITE_OK;
+}
+/*
+ * Compile a declarative filter object. Its entries are ANDed:
+ *   field: value           Equality.
+ *   field: {op: value,...} Comparisons, op is one of ==, !=, <, <=, >, >= or in (list of values).
+ *   and: [filter,...]      All the sub-filters match.
+ *   or: [filter,...]       One of the sub-filters match.
+ */
+static int FilterCompile(unqlite_col_filter *pFilter,jx9_value *pSpec,int iNest)
+{
+	jx9_hashmap_node *pNode,*pEntry;
+	jx9_hashmap *pMap,*pList;
+	jx9_value *pValue,*pSub;
+	sxu32 iTerm,iComp,iField;
+	SyString sKey;
+	int iOp;
+	int rc;
+	if( iNest >= UNQLITE_FAST_JSON_NEST_LIMIT ){
+		/* Nesting limit reached */
+		return UNQLITE_LIMIT;
+	}
+	if( !jx9_value_is_json_array(pSpec) ){
+		return UNQLITE_INVALID;
+	}
+	pMap = (jx9_hashmap *)pSpec->x.pOther;
+	iTerm = FilterPushTerm(&(*pFilter),UNQLITE_FILTER_AND,0);
+	jx9HashmapResetLoopCursor(pMap);
+	while( (pNode = jx9HashmapGetNextEntry(pMap)) != 0 ){
+		if( pNode->iType != HASHMAP_BLOB_NODE ){
+			/* Field names are strings */
+			return UNQLITE_INVALID;
+		}
+		SyStringInitFromBuf(&sKey,SyBlobData(&pNode->xKey.sKey),SyBlobLength(&pNode->xKey.sKey));
+		pValue = jx9HashmapGetNodeValue(pNode);
+		iOp = 0;
+		if( FilterKeyIs(&sKey,"and") ){
+			iOp = UNQLITE_FILTER_AND;
+		}else if( FilterKeyIs(&sKey,"or") ){
+			iOp = UNQLITE_FILTER_OR;
+		}
+		if( iOp ){
+			/* Composition */
+			if( !jx9_value_is_json_array(pValue) || jx9_value_is_json_object(pValue) ){
+				return UNQLITE_INVALID;
+			}
+			pList = (jx9_hashmap *)pValue->x.pOther;
+			iComp = FilterPushTerm(&(*pFilter),iOp,0);
+			jx9HashmapResetLoopCursor(pList);
+			while( (pEntry = jx9HashmapGetNextEntry(pList)) != 0 ){
+				pSub = jx9HashmapGetNodeValue(pEntry);
+				rc = FilterCompile(&(*pFilter),pSub,iNest+1);
+				if( rc != UNQLITE_OK ){
+					return rc;
+				}
+			}
+			FilterCloseTerm(&(*pFilter),iComp);
+			continue;
+		}
+		iField = FilterFieldIndex(&(*pFilter),sKey.zString,sKey.nByte);
+		if( jx9_value_is_json_object(pValue) ){
+			rc = FilterCompileOperators(&(*pFilter),iField,pValue);
+		}else{
+			rc = FilterPushCompare(&(*pFilter),UNQLITE_FILTER_EQ,iField,pValue);
+		}
+		if( rc != UNQLITE_OK ){
+			return rc;
+		}
+	}
+	FilterCloseTerm(&(*pFilter),iTerm);
+	return UNQLITE_OK;
+}
+/*
+ * Release a declarative filter.
+ */
+static void FilterRelease(unqlite_col_filter *pFilter)
+{
+	if( pFilter->azValue ){
+		SyMemBackendFree(pFilter->pAlloc,(void *)pFilter->azValue);
+	}
+	SySetRelease(&pFilter->aTerm);
+	SySetRelease(&pFilter->aField);
+}
+/*
+ * Prepare a declarative filter for the given filter object.
+ */
+static int FilterInit(unqlite_col_filter *pFilter,SyMemBackend *pAlloc,jx9_value *pSpec)
+{
+	sxu32 nField;
+	int rc;
+	pFilter->pAlloc = pAlloc;
+	pFilter->azValue = 0;
+	SySetInit(&pFilter->aTerm,pAlloc,sizeof(unqlite_filter_term));
+	SySetInit(&pFilter->aField,pAlloc,sizeof(SyString));
+	rc = FilterCompile(&(*pFilter),pSpec,0);
+	nField = SySetUsed(&pFilter->aField);
+	if( rc == UNQLITE_OK && nField > 0 ){
+		pFilter->azValue = (const unsigned char **)SyMemBackendAlloc(pAlloc,nField * sizeof(unsigned char *));
+		if( pFilter->azValue == 0 ){
+			rc = UNQLITE_NOMEM;
+		}
+	}
+	if( rc != UNQLITE_OK ){
+		FilterRelease(&(*pFilter));
+	}
+	return rc;
+}
+/*
+ * Compare a binary JSON value (NULL for a missing field) with the operand of a term.
+ * Numbers compare by value whatever their representation, strings byte-wise.
+ * Return FALSE if the two values cannot be compared (different types, arrays...).
+ */
+static int FilterCompare(const unsigned char *zVal,unqlite_filter_term *pTerm,int *pCmp)
+{
+	int c = zVal ? zVal[0] : FJSON_NULL;
+	double rVal = 0; /* cc warning */
+	sxu64 iVal;
+	sxu32 nByte;
+	sxu16 iLen;
+	int rc;
+	switch(c){
+	case FJSON_NULL:
+	case FJSON_TRUE:
+	case FJSON_FALSE:
+		*pCmp = 0;
+		return c == pTerm->iType;
+	case FJSON_INT64:
+	case FJSON_REAL:
+		if( pTerm->iType != FJSON_INT64 && pTerm->iType != FJSON_REAL ){
+			return FALSE;
+		}
+		if( c == FJSON_INT64 ){
+			SyBigEndianUnpack64(&zVal[1],&iVal);
+			if( pTerm->iType == FJSON_INT64 ){
+				jx9_int64 iNum = (jx9_int64)iVal;
+				*pCmp = iNum < pTerm->iVal ? -1 : (iNum > pTerm->iVal ? 1 : 0);
+				return TRUE;
+			}
+			rVal = (double)(jx9_int64)iVal;
+		}else{
+			SyBigEndianUnpack16(&zVal[1],&iLen);
+			SyStrToReal((const char *)&zVal[3],(sxu32)iLen,&rVal,0);
+		}
+		if( pTerm->iType == FJSON_INT64 ){
+			*pCmp = rVal < (double)pTerm->iVal ? -1 : (rVal > (double)pTerm->iVal ? 1 : 0);
+		}else{
+			*pCmp = rVal < pTerm->rVal ? -1 : (rVal > pTerm->rVal ? 1 : 0);
+		}
+		return TRUE;
+	case FJSON_STRING:
+		if( pTerm->iType != FJSON_STRING ){
+			return FALSE;
+		}
+		SyBigEndianUnpack32(&zVal[1],&nByte);
+		rc = SyMemcmp(&zVal[5],pTerm->sVal.zString,SXMIN(nByte,pTerm->sVal.nByte));
+		if( rc == 0 ){
+			rc = nByte < pTerm->sVal.nByte ? -1 : (nByte > pTerm->sVal.nByte ? 1 : 0);
+		}
+		*pCmp = rc;
+		return TRUE;
+	default:
+		/* Arrays and documents */
+		return FALSE;
+	}
+}
+/*
+ * Evaluate the subtree rooted at the given term against the current record.
+ */
+static int FilterEval(unqlite_col_filter *pFilter,sxu32 iTerm)
+{
+	unqlite_filter_term *pTerm = (unqlite_filter_term *)SySetAt(&pFilter->aTerm,iTerm);
+	sxu32 iEnd,i;
+	int iCmp = 0;
+	int rc;
+	switch(pTerm->iOp){
+	case UNQLITE_FILTER_AND:
+	case UNQLITE_FILTER_OR:
+		iEnd = iTerm + pTerm->nTerm;
+		for( i = iTerm + 1 ; i < iEnd ; i += ((unqlite_filter_term *)SySetAt(&pFilter->aTerm,i))->nTerm ){
+			rc = FilterEval(&(*pFilter),i);
+			if( pTerm->iOp == UNQLITE_FILTER_AND ? !rc : rc ){
+				/* Short circuit */
+				return rc;
+			}
+		}
+		/* TRUE for an AND, FALSE for an OR */
+		return pTerm->iOp == UNQLITE_FILTER_AND;
+	default:
+		rc = FilterCompare(pFilter->azValue[pTerm->iField],pTerm,&iCmp);
+		switch(pTerm->iOp){
+		case UNQLITE_FILTER_EQ: return rc && iCmp == 0;
+		case UNQLITE_FILTER_NE: return !rc || iCmp != 0;
+		case UNQLITE_FILTER_LT: return rc && iCmp < 0;
+		case UNQLITE_FILTER_LE: return rc && iCmp <= 0;
+		case UNQLITE_FILTER_GT: return rc && iCmp > 0;
+		default:                return rc && iCmp >= 0;
+		}
+	}
+}
+/*
+ * Check whether a binary JSON record matches a declarative filter.
+ * Only the compared top level fields are located, nothing is decoded.
+ * A missing field compares as null. A corrupt record never matches.
+ */
+UNQLITE_PRIVATE int unqliteFilterMatch(unqlite_col_filter *pFilter,const unsigned char *zIn,sxu32 nByte)
+{
+	const unsigned char *zEnd = &zIn[nByte];
+	sxu32 nField = SySetUsed(&pFilter->aField);
+	SyString *aField = (SyString *)SySetBasePtr(&pFilter->aField);
+	const unsigned char *zKey;
+	sxu32 nFound,nKey,n;
+	if( nField > 0 ){
+		SyZero((void *)pFilter->azValue,nField * sizeof(unsigned char *));
+	}
+	if( nByte > 0 && zIn[0] == FJSON_DOC_START ){
+		zIn++; /* Jump the binary { */
+		nFound = 0;
+		while( nFound < nField ){
+			/* Jump leading binary commas */
+			while( zIn < zEnd && zIn[0] == FJSON_COMMA ){
+				zIn++;
+			}
+			if( zIn >= zEnd || zIn[0] == FJSON_DOC_END ){
+				break;
+			}
+			zKey = 0;
+			nKey = 0;
+			if( zIn[0] == FJSON_STRING && &zIn[5] <= zEnd ){
+				SyBigEndianUnpack32(&zIn[1],&nKey);
+				zKey = &zIn[5];
+			}
+			if( FastJsonSkip(zIn,zEnd,&zIn,1) != SXRET_OK || zIn >= zEnd || zIn[0] != FJSON_COLON ){
+				/* Corrupt record */
+				return FALSE;
+			}
+			zIn++; /* Jump the binary colon ':' */
+			if( zKey ){
+				for( n = 0 ; n < nField ; ++n ){
+					if( aField[n].nByte == nKey && SyMemcmp(aField[n].zString,zKey,nKey) == 0 ){
+						pFilter->azValue[n] = zIn;
+						nFound++;
+						break;
+					}
+				}
+			}
+			if( FastJsonSkip(zIn,zEnd,&zIn,1) != SXRET_OK ){
+				/* Corrupt record */
+				return FALSE;
+			}
+		}
+	}
+	return FilterEval(&(*pFilter),0);
+}
+/*
+ * Walker callback used by db_fetch_all() to collect the requested field names.
+ */
+static int CollectFieldName(jx9_value *pKey,jx9_value *pValue,void *pUserData)
+{
+	SySet *pFields = (SySet *)pUserData;
+	SyString sField;
+	SXUNUSED(pKey); /* cc warning */
+	if( jx9_value_is_string(pValue) ){
+		/* The array outlives the call, point to its strings */
+		SyStringInitFromBuf(&sField,SyBlobData(&pValue->sBlob),SyBlobLength(&pValue->sBlob));
+		if( !FastJsonFieldLookup(pFields,sField.zString,sField.nByte) ){
+			SySetPut(pFields,(const void *)&sField);
+		}
+	}
+	return JX9_OK;
+}
+/*
+ * array db_fetch_all(string $col_name,[callback filter_callback],[array $fields])
+ * array db_get_all(string $col_name,[callback filter_callback],[array $fields])
+ * array db_fetch_all(string $col_name,[object filter],[array $fields])
  *   Retrieve all records of a given collection and apply the given
  *   callback if available to filter records.
+ *   Instead of a callback, a declarative filter object may be given
+ *   (e.g. {temp: {'>': 30}, or: [{id: {in: [1,2]}}, {name: 'x'}]}, see FilterCompile()).
+ *   It is evaluated in C against the binary records, without invoking the VM,
+ *   and the records that do not match are never decoded.
  * Parameter
  *   col_name: Collection name
+ *   fields: Names of the top level fields to extract (e.g. ['name','age']).
+ *     The other fields are never decoded, the filter callback and the result
+ *     only see the requested fields plus __id. The filter may be null.
  * Return
  *    Contents of the collection (JSON array) on success. NULL on failure.
  */
@@ -59508,7 +62975,11 @@ static int unqliteBuiltin_db_fetch_all(jx9_context *pCtx,int argc,jx9_value **ar
 	unqlite_col *pCol;
 	const char *zName;
 	unqlite_vm *pVm;
-	SyString sName;
+	unqlite_col_filter sFilter;
+	unqlite_col_filter *pFilter;
+	SyString sName,sId;
+	SySet sFields;
+	SySet *pFields;
 	int nByte;
 	int rc;
 	/* Extract collection name */
@@ -59542,12 +63013,32 @@ static int unqliteBuiltin_db_fetch_all(jx9_context *pCtx,int argc,jx9_value **ar
 			jx9_result_null(pCtx);
 			return JX9_OK;
 		}
+		pFilter = 0;
 		if( argc > 1 && jx9_value_is_callable(argv[1]) ){
 			pCallback = argv[1];
+		}else if( argc > 1 && jx9_value_is_json_array(argv[1]) ){
+			/* Declarative filter */
+			rc = FilterInit(&sFilter,&pVm->sAlloc,argv[1]);
+			if( rc != UNQLITE_OK ){
+				jx9_context_throw_error(pCtx,JX9_CTX_ERR,"Invalid filter object");
+				jx9MemObjRelease(&sResult);
+				jx9_result_null(pCtx);
+				return JX9_OK;
+			}
+			pFilter = &sFilter;
+		}
+		pFields = 0;
+		if( argc > 2 && jx9_value_is_json_array(argv[2]) ){
+			/* Projection: decode the requested fields only */
+			SySetInit(&sFields,&pVm->sAlloc,sizeof(SyString));
+			SyStringInitFromBuf(&sId,"__id",sizeof("__id")-1);
+			SySetPut(&sFields,(const void *)&sId);
+			jx9_array_walk(argv[2],CollectFieldName,&sFields);
+			pFields = &sFields;
 		}
 		unqliteCollectionResetRecordCursor(pCol);
 		/* Fetch collection records one after one */
-		while( UNQLITE_OK == unqliteCollectionFetchNextRecord(pCol,pValue) ){
+		while( UNQLITE_OK == unqliteCollectionFetchNextRecord(pCol,pValue,pFields,pFilter) ){
 			if( pCallback ){
 				jx9_value *apArg[2];
 				/* Invoke the filter callback */
@@ -59569,6 +63060,12 @@ static int unqliteBuiltin_db_fetch_all(jx9_context *pCtx,int argc,jx9_value **ar
 			/* Release the value */
 			jx9_value_null(pValue);
 		}
+		if( pFields ){
+			SySetRelease(pFields);
+		}
+		if( pFilter ){
+			FilterRelease(pFilter);
+		}
 		jx9MemObjRelease(&sResult);
 		/* Finally, return our array */
 		jx9_result_value(pCtx,pArray);
@@ -59623,6 +63120,51 @@ static int unqliteBuiltin_db_last_record_id(jx9_context *pCtx,int argc,jx9_value
 	}
 	return JX9_OK;
 }
+/*
+ * int64 db_last_live_record_id(string $col_name)
+ *   Return the ID of the last record that was not dropped.
+ *   Unlike db_last_record_id(), this is the ID of a record db_fetch_by_id() returns.
+ * Parameter
+ *   col_name: Collection name
+ * Return
+ *    Record ID (64-bit integer) on success. FALSE if the collection is empty or on failure.
+ */
+static int unqliteBuiltin_db_last_live_record_id(jx9_context *pCtx,int argc,jx9_value **argv)
+{
+	unqlite_col *pCol;
+	const char *zName;
+	unqlite_vm *pVm;
+	SyString sName;
+	jx9_int64 nId;
+	int nByte;
+	/* Extract collection name */
+	if( argc < 1 ){
+		/* Missing arguments */
+		jx9_context_throw_error(pCtx,JX9_CTX_ERR,"Missing collection name");
+		/* Return false */
+		jx9_result_bool(pCtx,0);
+		return JX9_OK;
+	}
+	zName = jx9_value_to_string(argv[0],&nByte);
+	if( nByte < 1){
+		jx9_context_throw_error(pCtx,JX9_CTX_ERR,"Invalid collection name");
+		/* Return false */
+		jx9_result_bool(pCtx,0);
+		return JX9_OK;
+	}
+	SyStringInitFromBuf(&sName,zName,nByte);
+	pVm = (unqlite_vm *)jx9_context_user_data(pCtx);
+	/* Fetch the collection */
+	pCol = unqliteCollectionFetch(pVm,&sName,UNQLITE_VM_AUTO_LOAD);
+	nId = pCol ? unqliteCollectionLastLiveId(pCol) : -1;
+	if( nId >= 0 ){
+		jx9_result_int64(pCtx,nId);
+	}else{
+		/* No such collection or no live record, return FALSE */
+		jx9_result_bool(pCtx,0);
+	}
+	return JX9_OK;
+}
 /*
  * inr64 db_current_record_id(string $col_name)
  *   Return the current record ID.
@@ -60156,7 +63698,7 @@ static int unqliteBuiltin_db_commit(jx9_context *pCtx,int argc,jx9_value **argv)
 	/* Point to the underlying database handle  */
 	pDb = pVm->pDb;
 	/* Commit the transaction if any */
-	rc = unqlitePagerCommit(pDb->sDB.pPager);
+	rc = unqlitePagerGroupCommit(pDb->sDB.pPager);
 	/* Commit result */
 	jx9_result_bool(pCtx,rc == UNQLITE_OK );
 	return JX9_OK;
@@ -60186,51 +63728,62 @@ static int unqliteBuiltin_db_rollback(jx9_context *pCtx,int argc,jx9_value **arg
 	jx9_result_bool(pCtx,rc == UNQLITE_OK );
 	return JX9_OK;
 }
+/* Table of the UnQLite foreign functions defined above */
+static const jx9_builtin_func aUnqliteFunc[] = {
+	{ "db_version" , unqliteBuiltin_db_version },
+	{ "db_copyright", unqliteBuiltin_db_credits },
+	{ "db_credits" , unqliteBuiltin_db_credits },
+	{ "db_sig" ,     unqliteBuiltin_db_sig     },
+	{ "db_errlog",   unqliteBuiltin_db_errlog  },
+	{ "collection_exists", unqliteBuiltin_collection_exists },
+	{ "db_exists",         unqliteBuiltin_collection_exists }, 
+	{ "collection_create", unqliteBuiltin_collection_create },
+	{ "db_create",         unqliteBuiltin_collection_create },
+	{ "db_fetch",          unqliteBuiltin_db_fetch_next     },
+	{ "db_get",            unqliteBuiltin_db_fetch_next     },
+	{ "db_fetch_by_id",    unqliteBuiltin_db_fetch_by_id    },
+	{ "db_get_by_id",      unqliteBuiltin_db_fetch_by_id    },
+	{ "db_fetch_all",      unqliteBuiltin_db_fetch_all      },
+	{ "db_get_all",        unqliteBuiltin_db_fetch_all      },
+	{ "db_last_record_id", unqliteBuiltin_db_last_record_id },
+	{ "db_last_live_record_id", unqliteBuiltin_db_last_live_record_id },
+	{ "db_current_record_id", unqliteBuiltin_db_current_record_id },
+	{ "db_reset_record_cursor", unqliteBuiltin_db_reset_record_cursor },
+	{ "db_total_records",  unqliteBuiltin_db_total_records  },
+	{ "db_creation_date",  unqliteBuiltin_db_creation_date  },
+	{ "db_store",          unqliteBuiltin_db_store          },
+	{ "db_update_record",  unqliteBuiltin_db_update_record  },
+	{ "db_put",            unqliteBuiltin_db_store          },
+	{ "db_drop_collection", unqliteBuiltin_db_drop_col      },
+	{ "collection_delete", unqliteBuiltin_db_drop_col       },
+	{ "db_drop_record",    unqliteBuiltin_db_drop_record    },
+	{ "db_set_schema",     unqliteBuiltin_db_set_schema     },
+	{ "db_get_schema",     unqliteBuiltin_db_get_schema     },
+	{ "db_begin",          unqliteBuiltin_db_begin          },
+	{ "db_commit",         unqliteBuiltin_db_commit         },
+	{ "db_rollback",       unqliteBuiltin_db_rollback       }
+};
+static sxu16 aUnqliteFuncIdx[SX_ARRAYSIZE(aUnqliteFunc)];
+static const jx9_builtin_table sUnqliteFuncTable = {
+	aUnqliteFunc, SX_ARRAYSIZE(aUnqliteFunc), sizeof(jx9_builtin_func), JX9_BUILTIN_DATA_HOST, aUnqliteFuncIdx
+};
+/*
+ * Sort the table of the UnQLite foreign functions.
+ * This routine is called only once at library initialization [i.e: unqliteCoreInitialize()].
+ */
+UNQLITE_PRIVATE void unqliteInitJx9Functions(void)
+{
+	jx9BuiltinTableSort(&sUnqliteFuncTable);
+}
 /*
  * Register all the UnQLite foreign functions defined above.
+ * The table is shared by all the VMs, the functions get the calling
+ * UnQLite VM as their private data.
  */
 UNQLITE_PRIVATE int unqliteRegisterJx9Functions(unqlite_vm *pVm)
 {
-	static const jx9_builtin_func aBuiltin[] = {
-		{ "db_version" , unqliteBuiltin_db_version },
-		{ "db_copyright", unqliteBuiltin_db_credits },
-		{ "db_credits" , unqliteBuiltin_db_credits },
-		{ "db_sig" ,     unqliteBuiltin_db_sig     },
-		{ "db_errlog",   unqliteBuiltin_db_errlog  },
-		{ "collection_exists", unqliteBuiltin_collection_exists },
-		{ "db_exists",         unqliteBuiltin_collection_exists }, 
-		{ "collection_create", unqliteBuiltin_collection_create },
-		{ "db_create",         unqliteBuiltin_collection_create },
-		{ "db_fetch",          unqliteBuiltin_db_fetch_next     },
-		{ "db_get",            unqliteBuiltin_db_fetch_next     },
-		{ "db_fetch_by_id",    unqliteBuiltin_db_fetch_by_id    },
-		{ "db_get_by_id",      unqliteBuiltin_db_fetch_by_id    },
-		{ "db_fetch_all",      unqliteBuiltin_db_fetch_all      },
-		{ "db_get_all",        unqliteBuiltin_db_fetch_all      },
-		{ "db_last_record_id", unqliteBuiltin_db_last_record_id },
-		{ "db_current_record_id", unqliteBuiltin_db_current_record_id },
-		{ "db_reset_record_cursor", unqliteBuiltin_db_reset_record_cursor },
-		{ "db_total_records",  unqliteBuiltin_db_total_records  },
-		{ "db_creation_date",  unqliteBuiltin_db_creation_date  },
-		{ "db_store",          unqliteBuiltin_db_store          },
-        { "db_update_record",  unqliteBuiltin_db_update_record  },
-		{ "db_put",            unqliteBuiltin_db_store          },
-		{ "db_drop_collection", unqliteBuiltin_db_drop_col      },
-		{ "collection_delete", unqliteBuiltin_db_drop_col       },
-		{ "db_drop_record",    unqliteBuiltin_db_drop_record    },
-		{ "db_set_schema",     unqliteBuiltin_db_set_schema     },
-		{ "db_get_schema",     unqliteBuiltin_db_get_schema     },
-		{ "db_begin",          unqliteBuiltin_db_begin          },
-		{ "db_commit",         unqliteBuiltin_db_commit         },
-		{ "db_rollback",       unqliteBuiltin_db_rollback       },
-	};
-	int rc = UNQLITE_OK;
-	sxu32 n;
-	/* Register the unQLite functions defined above in the Jx9 call table */
-	for( n = 0 ; n < SX_ARRAYSIZE(aBuiltin) ; ++n ){
-		rc = jx9_create_function(pVm->pJx9Vm,aBuiltin[n].zName,aBuiltin[n].xFunc,pVm);
-	}
-	return rc;
+	jx9VmInstallBuiltinTable(pVm->pJx9Vm,&sUnqliteFuncTable,pVm);
+	return UNQLITE_OK;
 }
 /* END-OF-IMPLEMENTATION: unqlite@embedded@symisc 34-09-46 */
 /*
@@ -128,6 +128,9 @@ typedef struct unqlite unqlite;
  *  unqlite_lib_config() with a configuration verb set to UNQLITE_LIB_CONFIG_USER_MUTEX.
  *  Otherwise the library is not threadsafe.
  *  Note that you must link UnQLite with the POSIX threads library under UNIX systems (i.e: -lpthread).
+ *  When the mutex subsystem implement the xEnterShared() method (UNIX systems, GCC or Clang),
+ *  record lookups and cursor reads served from the page cache run concurrently, everything else
+ *  is serialized. The consumer callback of these interfaces must not modify the database then.
  *
  * Options To Omit/Enable Features
  *
@@ -287,6 +290,12 @@ struct SyMutexMethods
 	void  (*xEnter)(SyMutex *);	    /* [Required:] Enter mutex */
 	int (*xTryEnter)(SyMutex *);    /* [Optional:] Try to enter a mutex */
 	void  (*xLeave)(SyMutex *);	    /* [Required:] Leave a locked mutex */
+	/* Reader/writer mode of the database handle mutex, requested from xNew() with type 9.
+	 * xEnterShared() return 1 when the mutex was entered in shared mode (release with xLeaveShared())
+	 * or 0 when it was entered exclusively because the caller already owns it (release with xLeave()).
+	 */
+	int (*xEnterShared)(SyMutex *); /* [Optional:] Enter a mutex in shared (read-only) mode */
+	void  (*xLeaveShared)(SyMutex *); /* [Optional:] Leave a mutex entered in shared mode */
 };
 #if defined (_MSC_VER) || defined (__MINGW32__) ||  defined (__GNUC__) && defined (__declspec)
 #define SX_APIIMPORT	__declspec(dllimport)
@@ -393,6 +402,54 @@ typedef sxi64 unqlite_int64;
 #define UNQLITE_CONFIG_KV_ENGINE           4  /* ONE ARGUMENT: const char *zKvName */
 #define UNQLITE_CONFIG_DISABLE_AUTO_COMMIT 5  /* NO ARGUMENTS */
 #define UNQLITE_CONFIG_GET_KV_NAME         6  /* ONE ARGUMENT: const char **pzPtr */
+#define UNQLITE_CONFIG_GROUP_COMMIT        7  /* THREE ARGUMENTS: int nMaxCommit, int nWindowMs, unsigned int (*xTick)(void) */
+#define UNQLITE_CONFIG_READ_AHEAD          8  /* ONE ARGUMENT: int nMaxPage */
+#define UNQLITE_CONFIG_READ_AHEAD_STATS    9  /* THREE ARGUMENTS: unsigned int *pnRead, unsigned int *pnHit, unsigned int *pnWaste */
+#define UNQLITE_CONFIG_GROUP_COMMIT_FLUSH  10 /* ONE ARGUMENT: int bExpired */
+/*
+ * Group commit (UNQLITE_CONFIG_GROUP_COMMIT).
+ *
+ * When nMaxCommit is greater than one, unqlite_commit() acknowledges a transaction
+ * without touching the disk and keeps its changes in the page cache. The queued
+ * commits are flushed together through a single journal/sync cycle once nMaxCommit
+ * of them have been queued or, if xTick (a millisecond tick source) is not NULL and
+ * nWindowMs is greater than zero, once the first queued commit is at least nWindowMs
+ * old. Configuring the verb again flushes any queued commit; pass nMaxCommit = 0 to
+ * flush and disable group commit.
+ *
+ * The window is only checked by unqlite_commit(): on a quiet system, call
+ *
+ *     unqlite_config(pDb,UNQLITE_CONFIG_GROUP_COMMIT_FLUSH,1);
+ *
+ * from a periodic timer (or the idle loop) to flush the group once its window is over,
+ * or with 0 to flush it right away. The flush returns UNQLITE_BUSY without writing
+ * anything while a transaction has uncommitted changes: its commit flushes the group.
+ *
+ * Durability trade-off: up to nMaxCommit-1 acknowledged commits are lost on power
+ * failure (the database reverts to the last flushed group). Acknowledged commits are
+ * not lost on rollback: pages changed after an acknowledged commit are copied first,
+ * so a rollback (explicit, or by unqlite_close() with auto-commit disabled) only
+ * reverts the current transaction and then flushes the group. This costs one page
+ * of memory per page changed in the current transaction. If that flush fails (I/O
+ * error), the whole group is rolled back and the rollback returns the error.
+ */
+/*
+ * Read-ahead (UNQLITE_CONFIG_READ_AHEAD).
+ *
+ * When the pager detect that pages are read from disk in ascending order (cursor walks
+ * over buckets allocated one after the other for example), it reads the following pages
+ * in a single larger read and serves them from memory. The window starts at two pages,
+ * doubles each time it is fully used and is halved when most of it is wasted, up to
+ * nMaxPage pages (32 at most). A buffer of nMaxPage pages is allocated on first use.
+ * Read-ahead is disabled by default: enable it per database handle with
+ *
+ *     unqlite_config(pDb,UNQLITE_CONFIG_READ_AHEAD,8);
+ *
+ * or for every handle by building with -DUNQLITE_DEFAULT_READ_AHEAD=8. Pass 0 to
+ * disable it again.
+ * UNQLITE_CONFIG_READ_AHEAD_STATS reports the number of read-ahead I/Os issued, the
+ * number of prefetched pages that were used and the number discarded unused.
+ */
 /*
  * UnQLite/Jx9 Virtual Machine Configuration Commands.
  *
@@ -438,6 +495,27 @@ typedef sxi64 unqlite_int64;
  */
 #define UNQLITE_KV_CONFIG_HASH_FUNC  1 /* ONE ARGUMENT: unsigned int (*xHash)(const void *,unsigned int) */
 #define UNQLITE_KV_CONFIG_CMP_FUNC   2 /* ONE ARGUMENT: int (*xCmp)(const void *,const void *,unsigned int) */
+#define UNQLITE_KV_CONFIG_COMPRESS   3 /* ONE ARGUMENT: int bEnable */
+#define UNQLITE_KV_CONFIG_COMPRESS_STATS 4 /* TWO ARGUMENTS: unqlite_int64 *pnIn, unqlite_int64 *pnOut */
+#define UNQLITE_KV_CONFIG_BUCKET_STATS   5 /* TWO ARGUMENTS: unsigned int *aCount, int nCount */
+/*
+ * Overflow payload compression (UNQLITE_KV_CONFIG_COMPRESS).
+ *
+ * When enabled, record data that does not fit in its bucket page is compressed using
+ * a compact LZ codec before being written to the overflow pages. Data that does not
+ * shrink by at least one eighth is stored as is. Compressed records are flagged in
+ * their cell header so they can be read back whatever the setting of the reading handle.
+ * UNQLITE_KV_CONFIG_COMPRESS_STATS report the total amount of overflow data submitted
+ * for compression and the amount actually written to disk since the database was opened.
+ */
+/*
+ * Bucket occupancy (UNQLITE_KV_CONFIG_BUCKET_STATS).
+ *
+ * Fill aCount[i] with the number of buckets holding i records, the last entry counting
+ * the buckets holding nCount-1 records or more. The records of a bucket share its page
+ * (and slave pages once it is full), so this histogram shows how well the hash function
+ * (UNQLITE_KV_CONFIG_HASH_FUNC) spreads the keys of the database.
+ */
 /*
  * Global Library Configuration Commands.
  *
@@ -563,9 +641,18 @@ struct unqlite_file {
  * the file. The sector size is the minimum write that can be performed without
  * disturbing other bytes in the file.
  *
+ * The xFetch() and xUnfetch() methods are only present when iVersion is 2 or greater.
+ * xFetch() asks the VFS for a direct pointer to iAmt bytes of file content starting
+ * at offset iOfst. If the backing store is addressable (RAM disk, memory mapped file,
+ * execute-in-place flash...) the method set *pp to that memory and return UNQLITE_OK.
+ * Otherwise it must set *pp to NULL and still return UNQLITE_OK so that the caller
+ * fall back to xRead(). The memory is treated as read-only by the caller and must stay
+ * valid until the matching xUnfetch() call. References still outstanding when the
+ * file is closed are implicitly released by xClose().
+ *
  */
 struct unqlite_io_methods {
-  int iVersion;                 /* Structure version number (currently 1) */
+  int iVersion;                 /* Structure version number (currently 2) */
   int (*xClose)(unqlite_file*);
   int (*xRead)(unqlite_file*, void*, unqlite_int64 iAmt, unqlite_int64 iOfst);
   int (*xWrite)(unqlite_file*, const void*, unqlite_int64 iAmt, unqlite_int64 iOfst);
@@ -576,6 +663,10 @@ struct unqlite_io_methods {
   int (*xUnlock)(unqlite_file*, int);
   int (*xCheckReservedLock)(unqlite_file*, int *pResOut);
   int (*xSectorSize)(unqlite_file*);
+  /* Methods above are valid for version 1 */
+  int (*xFetch)(unqlite_file*, unqlite_int64 iOfst, int iAmt, void **pp);
+  int (*xUnfetch)(unqlite_file*, unqlite_int64 iOfst, void *p);
+  /* Methods above are valid for version 2 */
 };
 /*
  * CAPIREF: OS Interface Object
@@ -697,6 +788,7 @@ struct unqlite_kv_io
 	void (*xSetUnpin)(unqlite_kv_handle,void (*xPageUnpin)(void *)); 
 	void (*xSetReload)(unqlite_kv_handle,void (*xPageReload)(void *));
 	void (*xErr)(unqlite_kv_handle,const char *);
+	int (*xCacheOnly)(unqlite_kv_handle);
 };
 /*
  * Key/Value Storage Engine Cursor Object
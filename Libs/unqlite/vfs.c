@@ -12,6 +12,7 @@
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
+#include <assert.h>
 // System
 #include "stm32u575xx.h"
 #include "main.h"
@@ -19,6 +20,7 @@
 // Software
 #include "vfs.h"
 #include "vfsRaw.h"
+#include "vfsDev.h"
 
 
 /***************************************************************************************************
@@ -26,6 +28,12 @@
 ***************************************************************************************************/
 extern const unqlite_io_methods rawIoMethod;
 
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+/* Both kinds of files are opened by MicriumFS */
+#define VFS_FILE_SIZE	( sizeof(rawFile) > sizeof(devFile) ? sizeof(rawFile) : sizeof(devFile) )
+
 /***************************************************************************************************
 * Vars
 ***************************************************************************************************/
@@ -34,8 +42,34 @@ extern const unqlite_io_methods rawIoMethod;
 * Prototypes
 ***************************************************************************************************/
 
+/***************************************************************************************************
+* @brief         Open a file with deferred directory entry updates
+* @details       Files are opened cached: the directory entry is only written by rawSync() and
+*                on close instead of on every write (see FSFile_Sync()).
+*                They are also self-journaled: the pager journal already makes commits atomic, so the
+*                FAT journal does not log their directory entry updates, and a sync that overwrites
+*                pages in place writes no metadata at all (see FSFile_Open() Note #6).
+* @param[in]     Pathname of file to be opened (UTF-8)
+* @param[in]     fopen() style mode string
+* @return        File handle or NULL on failure
+***************************************************************************************************/
+static FS_FILE *rawFileOpen(const char *zName, const char *zMode)
+{
+	FS_FLAGS mode;
+	FS_ERR err;
+
+	mode = FSFile_ModeParse((CPU_CHAR *)zMode, strlen(zMode));
+	if (mode == FS_FILE_ACCESS_MODE_NONE)
+	{
+		return NULL;
+	}
+
+	return FSFile_Open((CPU_CHAR *)zName, mode | FS_FILE_ACCESS_MODE_CACHED | FS_FILE_ACCESS_MODE_SELF_JOURNAL, &err);
+}
+
 /***************************************************************************************************
 * @brief         Open a file
+* @details       Raw device names ("nor:1:") are handed over to the MicriumDev VFS.
 * @param[in,out] The VFS for which this is the xOpen method
 * @param[in]     Pathname of file to be opened (UTF-8)
 * @param[in,out] Write the unqlite_file handle here
@@ -87,6 +121,11 @@ static int rawOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsig
 		return UNQLITE_IOERR;
 	}
 
+	if (devIsPath(zName))
+	{
+		return devFileOpen(pVfs, zName, id, flags);
+	}
+
 	if (isReadWrite)
 	{
 		strcpy(openFlags, "r+");
@@ -111,7 +150,7 @@ static int rawOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsig
 
 	if(isCreate)
 	{
-		h = fs_fopen(zName, openFlags);
+		h = rawFileOpen(zName, openFlags);
 		VFS_DEBUG_MSG("OPEN name=%s, access=%s\n", zName, openFlags);
 		if (h == NULL)
 		{
@@ -121,7 +160,7 @@ static int rawOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsig
 		else
 		{
 			fs_fclose(h);
-			h = fs_fopen(zName, "r+");
+			h = rawFileOpen(zName, "r+");
 			VFS_DEBUG_MSG("OPEN name=%s, access=%s\n", zName, openFlags);
 			if (h == NULL)
 			{
@@ -133,7 +172,7 @@ static int rawOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsig
 	}
 	else
 	{
-		h = fs_fopen(zName, openFlags);
+		h = rawFileOpen(zName, openFlags);
 		VFS_DEBUG_MSG("OPEN name=%s, access=%s\n", zName, openFlags);
 		if (h == NULL)
 		{
@@ -149,6 +188,8 @@ static int rawOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsig
 	pFile->pVfs = pVfs;
 	pFile->h = h;
 	pFile->zPath = zName;
+	pFile->szChunk = RAWFILE_CHUNK_SIZE;
+	pFile->isRdonly = isReadonly;
 
 	return UNQLITE_OK;
 }
@@ -163,6 +204,11 @@ static int rawOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsig
 static int rawDelete(unqlite_vfs *pVfs,const char *zFilename, int syncDir)
 {
 	int rc;
+
+	if (devIsPath(zFilename))
+	{
+		return devFileDelete(zFilename, syncDir);
+	}
 	// Delete file
 	rc = fs_remove(zFilename);
 	if (rc == 0)
@@ -189,6 +235,11 @@ static int rawAccess(unqlite_vfs *pVfs, const char *zFilename, int flags, int *p
 	int rc;
 	struct fs_stat p_info;
 
+	if (devIsPath(zFilename))
+	{
+		return devFileExists(zFilename, pResOut);
+	}
+
 	rc = fs_stat(zFilename, &p_info);
 	*pResOut = (rc == 0) ? 1 : 0;
 
@@ -209,6 +260,12 @@ static int rawAccess(unqlite_vfs *pVfs, const char *zFilename, int flags, int *p
 ***************************************************************************************************/
 static int rawFullPathname(unqlite_vfs *pVfs, const char *zPath, int nPathOut, char *zPathOut)
 {
+	if (devIsPath(zPath))
+	{
+		/* Raw device names are absolute */
+		snprintf(zPathOut, nPathOut, "%s", zPath);
+		return UNQLITE_OK;
+	}
 	sprintf(zPathOut, "\\%s", zPath);
 	zPathOut[nPathOut-1] = '\0';
 
@@ -267,7 +324,7 @@ const unqlite_vfs * unqliteExportBuiltinVfs(void)
         {
             "MicriumFS",
             1,
-            sizeof(rawFile),
+            VFS_FILE_SIZE,
             MAXPATHNAME,
             rawOpen,
             rawDelete,
@@ -280,3 +337,81 @@ const unqlite_vfs * unqliteExportBuiltinVfs(void)
         };
     return &MicriumFS_VFS;
 }
+
+/***************************************************************************************************
+* @brief         Open the region of a raw device (MicriumDev xOpen method)
+* @param[in,out] The VFS for which this is the xOpen method
+* @param[in]     Device name (database) or journal name
+* @param[in,out] Write the unqlite_file handle here
+* @param[in]     Open mode flags
+* @return        UNQLITE_OK or some other error code on failure
+***************************************************************************************************/
+static int devOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsigned int flags)
+{
+	return devFileOpen(pVfs, zName, id, flags);
+}
+
+/***************************************************************************************************
+* @brief     Delete a raw device file (MicriumDev xDelete method)
+* @param     unqlite_vfs* Not used
+* @param[in] char* Device name (database) or journal name
+* @param[in] int Sync the device after the delete
+* @return    UNQLITE_OK or some other error code on failure
+***************************************************************************************************/
+static int devDelete(unqlite_vfs *pVfs, const char *zFilename, int syncDir)
+{
+	return devFileDelete(zFilename, syncDir);
+}
+
+/***************************************************************************************************
+* @brief      Test the existence of a raw device file (MicriumDev xAccess method)
+* @param      unqlite_vfs* Not used
+* @param[in]  char* Device name (database) or journal name
+* @param[in]  int Not used
+* @param[out] int* Result
+* @return     UNQLITE_OK
+***************************************************************************************************/
+static int devAccess(unqlite_vfs *pVfs, const char *zFilename, int flags, int *pResOut)
+{
+	return devFileExists(zFilename, pResOut);
+}
+
+/***************************************************************************************************
+* @brief         Raw device names are absolute (MicriumDev xFullPathname method)
+* @param[in,out] unqlite_vfs* Pointer to vfs object
+* @param[in]     char* Device name (database) or journal name
+* @param[in]     int Size of output buffer in bytes
+* @param[out]    char* Output buffer
+* @return        UNQLITE_OK
+***************************************************************************************************/
+static int devFullPathname(unqlite_vfs *pVfs, const char *zPath, int nPathOut, char *zPathOut)
+{
+	snprintf(zPathOut, nPathOut, "%s", zPath);
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief      VFS storing the database and its journal on a raw device, without any file system.
+* @details    MicriumFS already hands raw device names over to this VFS, so installing it with
+*             UNQLITE_LIB_CONFIG_VFS is only needed to forbid file system databases.
+* @return     MicriumDev VFS
+***************************************************************************************************/
+const unqlite_vfs * unqliteExportDevVfs(void)
+{
+    static unqlite_vfs MicriumDev_VFS =
+        {
+            "MicriumDev",
+            1,
+            sizeof(devFile),
+            MAXPATHNAME,
+            devOpen,
+            devDelete,
+            devAccess,
+            devFullPathname,
+            0,
+            rawSleep,
+            rawCurrentTime,
+            0,
+        };
+    return &MicriumDev_VFS;
+}
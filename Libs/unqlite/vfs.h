@@ -24,5 +24,6 @@
 * Prototypes
 ***************************************************************************************************/
 const unqlite_vfs * unqliteExportBuiltinVfs(void);
+const unqlite_vfs * unqliteExportDevVfs(void);
 /** @} */ // end of Vfs_RAW_h
 #endif
@@ -0,0 +1,560 @@
+/***************************************************************************************************
+ * @brief     VFS Dev for unQLite: database and journal stored on a raw uC/FS device.
+ * @details   Tab == 4 spaces (use Tab char instead of spaces).
+ *            One logical page write costs one device write: there is no FAT, directory entry or
+ *            FAT journal update underneath. The region headers are only written when the file
+ *            size changed, on sync and close; deleting a file invalidates its header.
+ * @date      10/2026
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+// Library
+#include <string.h>
+
+// Software
+#include "vfsDev.h"
+#include "vfsRaw.h"
+#include "ioTrace.h"
+
+/***************************************************************************************************
+* Externs
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+/* Read-modify-write and header buffer. The raw devices are accessed from a single task, like the
+ * rest of the VFS (locks are no-ops). */
+static CPU_INT32U devSecBuf[DEVFILE_SEC_SIZE_MAX / sizeof(CPU_INT32U)];
+
+/***************************************************************************************************
+* Prototypes
+***************************************************************************************************/
+
+const unqlite_io_methods devIoMethod =
+{
+	1,
+	devClose,
+	devRead,
+	devWrite,
+	devTruncate,
+	devSync,
+	devFileSize,
+	devLock,
+	devUnlock,
+	devCheckReservedLock,
+	devSectorSize,
+	0,
+	0
+};
+
+/***************************************************************************************************
+ * @brief Test whether a name designates a raw device region.
+ * @details The name is a device name ("nor:1:"), optionally followed by a suffix without any path
+ *          separator (the journal name). A file system path always has a separator after the
+ *          volume name.
+ * @param zName - Name to test.
+ * @return int - Length of the device name, 0 if it is not a raw device name.
+***************************************************************************************************/
+int devIsPath(const char *zName)
+{
+	const char *zEnd;
+	int nDev;
+
+	if (zName == NULL)
+	{
+		return 0;
+	}
+	zEnd = strrchr(zName, ':');
+	if (zEnd == NULL || strpbrk(zEnd, "\\/") != NULL)
+	{
+		return 0;
+	}
+	nDev = (int)(zEnd - zName) + 1;
+
+	return (nDev <= DEVFILE_NAME_MAX) ? nDev : 0;
+}
+
+/***************************************************************************************************
+ * @brief Locate the region of a name on its device.
+ * @param zName - Database name (device name) or journal name.
+ * @param pFile - Receives the device name, the region bounds and the sector size.
+ * @return int - UNQLITE_OK or UNQLITE_CANTOPEN if the device is missing or too small.
+***************************************************************************************************/
+static int devRegion(const char *zName, devFile *pFile)
+{
+	FS_DEV_INFO info;
+	FS_SEC_QTY nJrnl;
+	FS_ERR err;
+	int nDev;
+
+	nDev = devIsPath(zName);
+	if (nDev == 0)
+	{
+		return UNQLITE_CANTOPEN;
+	}
+	memcpy(pFile->zDev, zName, nDev);
+	pFile->zDev[nDev] = '\0';
+
+	FSDev_Query(pFile->zDev, &info, &err);
+	if (err != FS_ERR_NONE || info.SecSize > DEVFILE_SEC_SIZE_MAX)
+	{
+		VFS_DEBUG_MSG("DEV name=%s, err=%d\n", pFile->zDev, err);
+		return UNQLITE_CANTOPEN;
+	}
+
+	/* Database region first, journal region at the end of the device */
+	nJrnl = (info.Size * DEVFILE_JOURNAL_PCT) / 100;
+	if (nJrnl < 2 || info.Size - nJrnl < 2)
+	{
+		return UNQLITE_CANTOPEN;
+	}
+	pFile->szSec = info.SecSize;
+	if (zName[nDev] == '\0')
+	{
+		pFile->iHdrSec = 0;
+		pFile->nSec = info.Size - nJrnl - 1;
+	}
+	else
+	{
+		pFile->iHdrSec = info.Size - nJrnl;
+		pFile->nSec = nJrnl - 1;
+	}
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+ * @brief Read the header of a region.
+ * @param pFile - Region.
+ * @param pSize - Receives the file size.
+ * @return int - 1 if the header is valid (the file exists), 0 otherwise.
+***************************************************************************************************/
+static int devHdrRead(devFile *pFile, unqlite_int64 *pSize)
+{
+	CPU_INT08U *pHdr = (CPU_INT08U *)devSecBuf;
+	CPU_INT32U magic;
+	FS_ERR err;
+
+	FSDev_Rd(pFile->zDev, pHdr, pFile->iHdrSec, 1, &err);
+	if (err != FS_ERR_NONE)
+	{
+		return 0;
+	}
+	memcpy(&magic, &pHdr[0], sizeof(magic));
+	memcpy(pSize, &pHdr[8], sizeof(*pSize));
+	if (magic != DEVFILE_MAGIC || *pSize < 0 || *pSize > (unqlite_int64)pFile->nSec * pFile->szSec)
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+/***************************************************************************************************
+ * @brief Write the header of a region.
+ * @param pFile - Region.
+ * @param isValid - 0 to invalidate the header (delete the file).
+ * @return int - UNQLITE_OK or UNQLITE_IOERR.
+***************************************************************************************************/
+static int devHdrWrite(devFile *pFile, int isValid)
+{
+	CPU_INT08U *pHdr = (CPU_INT08U *)devSecBuf;
+	CPU_INT32U magic = DEVFILE_MAGIC;
+	uint32_t traceStart;
+	FS_ERR err;
+
+	memset(pHdr, 0, pFile->szSec);
+	if (isValid)
+	{
+		memcpy(&pHdr[0], &magic, sizeof(magic));
+		memcpy(&pHdr[8], &pFile->nSize, sizeof(pFile->nSize));
+	}
+
+	traceStart = IOTRACE_START();
+	FSDev_Wr(pFile->zDev, pHdr, pFile->iHdrSec, 1, &err);
+	IOTRACE_END(IOTRACE_LAYER_VFS, IOTRACE_OP_WR, 0, pFile->szSec, traceStart);
+	if (err != FS_ERR_NONE)
+	{
+		VFS_DEBUG_MSG("HDR dev=%s, sec=%lu, err=%d\n", pFile->zDev, (unsigned long)pFile->iHdrSec, err);
+		return UNQLITE_IOERR;
+	}
+	pFile->isHdrDirty = 0;
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+ * @brief Open the region of a raw device.
+ * @param pVfs - The VFS for which this is the xOpen method.
+ * @param zName - Device name (database) or journal name.
+ * @param id - Write the unqlite_file handle here.
+ * @param flags - Open mode flags.
+ * @return int - UNQLITE_OK or UNQLITE_CANTOPEN.
+***************************************************************************************************/
+int devFileOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsigned int flags)
+{
+	devFile *pFile = (devFile *)id;
+	int rc;
+
+	memset(pFile, 0, sizeof(devFile));
+	rc = devRegion(zName, pFile);
+	if (rc != UNQLITE_OK)
+	{
+		VFS_DEBUG_MSG("OPEN name=%s, CANTOPEN\n", zName);
+		return rc;
+	}
+
+	if (!devHdrRead(pFile, &pFile->nSize))
+	{
+		if ((flags & UNQLITE_OPEN_CREATE) == 0)
+		{
+			VFS_DEBUG_MSG("OPEN name=%s, CANTOPEN\n", zName);
+			return UNQLITE_CANTOPEN;
+		}
+		/* New empty file, the header is written on the first sync */
+		pFile->nSize = 0;
+		pFile->isHdrDirty = 1;
+	}
+
+	VFS_DEBUG_MSG("OPEN name=%s, dev=%s, sec=%lu, size=%lld\n", zName, pFile->zDev, (unsigned long)pFile->iHdrSec, pFile->nSize);
+
+	pFile->pMethod = &devIoMethod;
+	pFile->pVfs = pVfs;
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+ * @brief Delete a raw device file by invalidating its region header.
+ * @param zName - Device name (database) or journal name.
+ * @param syncDir - Sync the device after the header write.
+ * @return int - UNQLITE_OK or some other error code on failure.
+***************************************************************************************************/
+int devFileDelete(const char *zName, int syncDir)
+{
+	devFile sFile;
+	unqlite_int64 nSize;
+	FS_ERR err;
+	int rc;
+
+	memset(&sFile, 0, sizeof(sFile));
+	rc = devRegion(zName, &sFile);
+	if (rc != UNQLITE_OK)
+	{
+		return UNQLITE_IOERR;
+	}
+	if (!devHdrRead(&sFile, &nSize))
+	{
+		/* Nothing to delete */
+		return UNQLITE_OK;
+	}
+	rc = devHdrWrite(&sFile, 0);
+	if (rc == UNQLITE_OK && syncDir)
+	{
+		FSDev_Sync(sFile.zDev, &err);
+		rc = (err == FS_ERR_NONE) ? UNQLITE_OK : UNQLITE_IOERR;
+	}
+
+	return rc;
+}
+
+/***************************************************************************************************
+ * @brief Test the existence of a raw device file.
+ * @param zName - Device name (database) or journal name.
+ * @param pResOut - Result.
+ * @return int - UNQLITE_OK
+***************************************************************************************************/
+int devFileExists(const char *zName, int *pResOut)
+{
+	devFile sFile;
+	unqlite_int64 nSize;
+
+	memset(&sFile, 0, sizeof(sFile));
+	*pResOut = (devRegion(zName, &sFile) == UNQLITE_OK) ? devHdrRead(&sFile, &nSize) : 0;
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+ * @brief Close a File. The header is written if the file size changed.
+ *
+ * @param id - File to close.
+ * @return int - ERROR Code.
+***************************************************************************************************/
+int devClose(unqlite_file *id)
+{
+	devFile *pFile = (devFile *)id;
+
+	if (pFile && pFile->isHdrDirty)
+	{
+		return devHdrWrite(pFile, 1);
+	}
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+ * @brief Read data from a file into a buffer
+ * @details Whole sectors are read straight into the caller's buffer, partial ones through the
+ *          sector buffer.
+ * @param id  File to read from
+ * @param pBuf Write content into this buffer
+ * @param amt Number of bytes to read
+ * @param offset Begin reading at this offset
+ * @return int ERROR CODE.
+***************************************************************************************************/
+int devRead(unqlite_file *id, void *pBuf, unqlite_int64 amt, unqlite_int64 offset)
+{
+	devFile *pFile = (devFile*)id;
+	CPU_INT08U *zBuf = (CPU_INT08U *)pBuf;
+	unqlite_int64 iStart = offset;
+	unqlite_int64 nAvail;
+	uint32_t traceStart;
+	FS_SEC_NBR iSec;
+	FS_SEC_QTY nSec;
+	CPU_SIZE_T iOfs;
+	CPU_SIZE_T n;
+	FS_ERR err;
+
+	/* Unread parts of the buffer must be zero-filled */
+	nAvail = (offset < pFile->nSize) ? pFile->nSize - offset : 0;
+	if (nAvail < amt)
+	{
+		memset(&zBuf[nAvail], 0, amt - nAvail);
+	}
+
+	traceStart = IOTRACE_START();
+	while (nAvail > 0 && amt > 0)
+	{
+		iSec = pFile->iHdrSec + 1 + (FS_SEC_NBR)(offset / pFile->szSec);
+		iOfs = (CPU_SIZE_T)(offset % pFile->szSec);
+		if (iOfs == 0 && nAvail >= pFile->szSec && amt >= pFile->szSec)
+		{
+			nSec = (FS_SEC_QTY)((amt < nAvail ? amt : nAvail) / pFile->szSec);
+			n = nSec * pFile->szSec;
+			FSDev_Rd(pFile->zDev, zBuf, iSec, nSec, &err);
+		}
+		else
+		{
+			n = pFile->szSec - iOfs;
+			if (n > amt)
+			{
+				n = amt;
+			}
+			if (n > nAvail)
+			{
+				n = nAvail;
+			}
+			FSDev_Rd(pFile->zDev, devSecBuf, iSec, 1, &err);
+			memcpy(zBuf, &((CPU_INT08U *)devSecBuf)[iOfs], n);
+		}
+		if (err != FS_ERR_NONE)
+		{
+			VFS_DEBUG_MSG("READ dev=%s, sec=%lu, err=%d\n", pFile->zDev, (unsigned long)iSec, err);
+			return UNQLITE_IOERR;
+		}
+		zBuf += n;
+		offset += n;
+		amt -= n;
+		nAvail -= n;
+	}
+	IOTRACE_END(IOTRACE_LAYER_VFS, IOTRACE_OP_RD, (uint32_t)iStart, (uint32_t)(offset - iStart), traceStart);
+
+	return (amt > 0) ? UNQLITE_IOERR : UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief         Write data from a buffer into a file.
+* @details       Whole sectors are written straight from the caller's buffer. A partial sector is
+*                read first if it holds file data, so pager pages aligned on the sector size never
+*                cost a read.
+* @param[in,out] File to write into
+* @param[out]    The bytes to be written
+* @param[in]     Number of bytes to write
+* @param[in]     Offset into the file to begin writing at
+* @return        ERROR CODE
+***************************************************************************************************/
+int devWrite(unqlite_file *id, const void *pBuf, unqlite_int64 amt, unqlite_int64 offset)
+{
+	devFile *pFile = (devFile*)id;
+	const CPU_INT08U *zBuf = (const CPU_INT08U *)pBuf;
+	unqlite_int64 iStart = offset;
+	unqlite_int64 iEnd = offset + amt;
+	uint32_t traceStart;
+	FS_SEC_NBR iSec;
+	FS_SEC_QTY nSec;
+	CPU_SIZE_T iOfs;
+	CPU_SIZE_T n;
+	FS_ERR err;
+
+	if (iEnd > (unqlite_int64)pFile->nSec * pFile->szSec)
+	{
+		VFS_DEBUG_MSG("WRITE dev=%s, offset=%lld, rc=UNQLITE_FULL\n", pFile->zDev, offset);
+		return UNQLITE_FULL;
+	}
+
+	traceStart = IOTRACE_START();
+	while (amt > 0)
+	{
+		iSec = pFile->iHdrSec + 1 + (FS_SEC_NBR)(offset / pFile->szSec);
+		iOfs = (CPU_SIZE_T)(offset % pFile->szSec);
+		if (iOfs == 0 && amt >= pFile->szSec)
+		{
+			nSec = (FS_SEC_QTY)(amt / pFile->szSec);
+			n = nSec * pFile->szSec;
+			FSDev_Wr(pFile->zDev, (void *)zBuf, iSec, nSec, &err);
+		}
+		else
+		{
+			n = pFile->szSec - iOfs;
+			if (n > amt)
+			{
+				n = amt;
+			}
+			err = FS_ERR_NONE;
+			if (offset - iOfs < pFile->nSize)
+			{
+				FSDev_Rd(pFile->zDev, devSecBuf, iSec, 1, &err);
+			}
+			else
+			{
+				memset(devSecBuf, 0, pFile->szSec);
+			}
+			if (err == FS_ERR_NONE)
+			{
+				memcpy(&((CPU_INT08U *)devSecBuf)[iOfs], zBuf, n);
+				FSDev_Wr(pFile->zDev, devSecBuf, iSec, 1, &err);
+			}
+		}
+		if (err != FS_ERR_NONE)
+		{
+			VFS_DEBUG_MSG("WRITE dev=%s, sec=%lu, err=%d\n", pFile->zDev, (unsigned long)iSec, err);
+			return UNQLITE_IOERR;
+		}
+		zBuf += n;
+		offset += n;
+		amt -= n;
+	}
+	IOTRACE_END(IOTRACE_LAYER_VFS, IOTRACE_OP_WR, (uint32_t)iStart, (uint32_t)(iEnd - iStart), traceStart);
+
+	if (iEnd > pFile->nSize)
+	{
+		pFile->nSize = iEnd;
+		pFile->isHdrDirty = 1;
+	}
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief         Truncate an open file to a specified size. Only the header changes.
+* @param[in,out] File to truncate
+* @param[in]     number of bytes to truncate
+* @return        ERROR CODE
+***************************************************************************************************/
+int devTruncate(unqlite_file *id, unqlite_int64 nByte)
+{
+	devFile *pFile = (devFile*)id;
+
+	if (nByte > (unqlite_int64)pFile->nSec * pFile->szSec)
+	{
+		return UNQLITE_FULL;
+	}
+	if (nByte != pFile->nSize)
+	{
+		pFile->nSize = nByte;
+		pFile->isHdrDirty = 1;
+	}
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief         Make sure all writes to a file are committed to the device.
+* @details       The header is written first if the file size changed, then the device is synced.
+* @param[in,out] File to sync
+* @param[in]     int FileSystem flags
+* @return        ERROR CODE
+***************************************************************************************************/
+int devSync(unqlite_file *id, int flags)
+{
+	devFile *pFile = (devFile*)id;
+	uint32_t traceStart;
+	FS_ERR err;
+	int rc;
+
+	if (pFile->isHdrDirty)
+	{
+		rc = devHdrWrite(pFile, 1);
+		if (rc != UNQLITE_OK)
+		{
+			return rc;
+		}
+	}
+
+	traceStart = IOTRACE_START();
+	FSDev_Sync(pFile->zDev, &err);
+	IOTRACE_END(IOTRACE_LAYER_VFS, IOTRACE_OP_SYNC, 0, 0, traceStart);
+	if (err != FS_ERR_NONE)
+	{
+		VFS_DEBUG_MSG("SYNC dev=%s, rc=UNQLITE_IOERR\n", pFile->zDev);
+		return UNQLITE_IOERR;
+	}
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief         Determine the current size of a file in bytes
+* @param[in,out] File pointer to file struct.
+* @param[out]    pointer to return File Size
+* @return        ERROR CODE
+***************************************************************************************************/
+int devFileSize(unqlite_file *id, unqlite_int64 *pSize)
+{
+	*pSize = ((devFile*)id)->nSize;
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief  Locking function. This method are both no-ops.
+* @return UNQLITE_OK
+***************************************************************************************************/
+int devLock(unqlite_file *id, int eLock)
+{
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief  Unlocking function. This method are both no-ops.
+* @return UNQLITE_OK
+***************************************************************************************************/
+int devUnlock(unqlite_file *id, int eLock)
+{
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief         No other process can hold a reserved lock, so a hot journal is always rolled back.
+* @param[in,out] File Pointer
+* @param[out]    pResOut
+* @return        UNQLITE_OK
+***************************************************************************************************/
+int devCheckReservedLock(unqlite_file *id, int *pResOut)
+{
+	*pResOut = 0;
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief     Return the sector size of the device.
+* @param[in] File pointer
+* @return    int Sector Size
+***************************************************************************************************/
+int devSectorSize(unqlite_file *id)
+{
+	return (int)((devFile*)id)->szSec;
+}
@@ -0,0 +1,87 @@
+/***************************************************************************************************
+ * @brief     VFS Dev for unQLite: database and journal stored on a raw uC/FS device.
+ * @details   Tab == 4 spaces (use Tab char instead of spaces).
+ *            The device is split in two fixed regions, the database file followed by its journal,
+ *            accessed sector-wise through FSDev_Rd()/FSDev_Wr() without any file system. The first
+ *            sector of each region holds its header (magic and file size); the file data follows.
+ *            A database is named after its device (e.g. "nor:1:"); any other name on the device
+ *            ("nor:1:_unqlite_journal") is the journal region.
+ *            The device must be dedicated to the database: no volume may be opened on it.
+ * @date      10/2026
+ ***************************************************************************************************/
+#ifndef __VFS_DEV_H__
+#define __VFS_DEV_H__
+
+/*#*************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "fs_api.h"
+#include "fs_dev.h"
+#include "unqlite.h"
+/*#*************************************************************************************************
+* Defines
+***************************************************************************************************/
+/*
+ ** Share of the device, in percent, given to the journal region.
+ */
+#ifndef DEVFILE_JOURNAL_PCT
+#define DEVFILE_JOURNAL_PCT     ( 25 )
+#endif
+
+/*
+ ** Largest device sector size supported (size of the read-modify-write buffer).
+ */
+#ifndef DEVFILE_SEC_SIZE_MAX
+#define DEVFILE_SEC_SIZE_MAX    ( 4096 )
+#endif
+
+/*
+ ** Maximum length of a device name, including the terminating ':'.
+ */
+#define DEVFILE_NAME_MAX        ( 16 )
+
+/*
+ ** Region header magic ("UQDV").
+ */
+#define DEVFILE_MAGIC           ( 0x56445155u )
+
+/*#*************************************************************************************************
+* Types
+***************************************************************************************************/
+/*
+ ** The devFile structure is a subclass of unqlite_file for a region of a raw device.
+ */
+typedef struct devFile devFile;
+struct devFile
+{
+	const unqlite_io_methods *pMethod; /* Base class. Must be first */
+	unqlite_vfs *pVfs; /* The VFS that created this devFile */
+	CPU_CHAR zDev[DEVFILE_NAME_MAX + 1]; /* Device name */
+	FS_SEC_NBR iHdrSec; /* Header sector of the region */
+	FS_SEC_QTY nSec; /* Number of data sectors of the region */
+	FS_SEC_SIZE szSec; /* Device sector size */
+	unqlite_int64 nSize; /* File size */
+	int isHdrDirty; /* File size changed since the header was written */
+};
+
+/*#*************************************************************************************************
+* Prototypes
+***************************************************************************************************/
+int devIsPath(const char *zName);
+int devFileOpen(unqlite_vfs *pVfs, const char *zName, unqlite_file *id, unsigned int flags);
+int devFileDelete(const char *zName, int syncDir);
+int devFileExists(const char *zName, int *pResOut);
+
+int devClose(unqlite_file *id);
+int devRead(unqlite_file *id, void *pBuf, unqlite_int64 amt, unqlite_int64 offset);
+int devWrite(unqlite_file *id, const void *pBuf, unqlite_int64 amt, unqlite_int64 offset);
+int devTruncate(unqlite_file *id, unqlite_int64 nByte);
+int devSync(unqlite_file *id, int flags);
+int devFileSize(unqlite_file *id, unqlite_int64 *pSize);
+int devLock(unqlite_file *id, int eLock);
+int devUnlock(unqlite_file *id, int eLock);
+int devCheckReservedLock(unqlite_file *id, int *pResOut);
+int devSectorSize(unqlite_file *id);
+
+/** @} */ // end of Vfs_DEV_h
+#endif
@@ -17,6 +17,7 @@
 
 // Software
 #include "vfsRaw.h"
+#include "ioTrace.h"
 
 /***************************************************************************************************
 * Externs
@@ -32,7 +33,7 @@
 
 const unqlite_io_methods rawIoMethod =
 {
-    1,
+    2,
     rawClose,
     rawRead,
     rawWrite,
@@ -42,7 +43,9 @@ const unqlite_io_methods rawIoMethod =
     rawLock,
     rawUnlock,
     rawCheckReservedLock,
-    rawSectorSize
+    rawSectorSize,
+    rawFetch,
+    rawUnfetch
 };
 
 /***************************************************************************************************
@@ -81,6 +84,7 @@ int rawRead(unqlite_file *id, void *pBuf, unqlite_int64 amt, unqlite_int64 offse
 	int rc;
 	rawFile *pFile = (rawFile*)id;
 	fs_size_t itemsRead;
+	uint32_t traceStart;
 
 	VFS_DEBUG_START();
 
@@ -106,7 +110,9 @@ int rawRead(unqlite_file *id, void *pBuf, unqlite_int64 amt, unqlite_int64 offse
 		}
 	}
 
+	traceStart = IOTRACE_START();
 	itemsRead = fs_fread(pBuf, 1, amt, pFile->h);
+	IOTRACE_END(IOTRACE_LAYER_VFS, IOTRACE_OP_RD, (uint32_t)offset, (uint32_t)amt, traceStart);
 
 	if (itemsRead < (long int)amt)
 	{
@@ -133,6 +139,7 @@ int rawWrite(unqlite_file *id, const void *pBuf, unqlite_int64 amt, unqlite_int6
 	int rc;
 	rawFile *pFile = (rawFile*)id;
 	fs_size_t wrote = 0;
+	uint32_t traceStart;
 
 	VFS_DEBUG_START();
 	uint32_t fileSize = 0;
@@ -144,6 +151,26 @@ int rawWrite(unqlite_file *id, const void *pBuf, unqlite_int64 amt, unqlite_int6
 		VFS_DEBUG_MSG("\nSEEK over EOF fileSize=%lu, offset=%lld\n\n", fileSize, offset);
 	}
 
+	/* If the user has configured a chunk-size for this file and the write
+	 ** extends the file past the space already reserved, reserve up to the next
+	 ** chunk boundary so that following writes do not have to allocate. Each
+	 ** fs_fallocate() walks the cluster chain, so it is only called once per
+	 ** chunk. This is only a hint: the write below reports a full device on
+	 ** its own.
+	 */
+	if ((pFile->szChunk > 0) && (offset + amt > fileSize) && (offset + amt > pFile->nReserved))
+	{
+		unqlite_int64 nReserve = ((offset + amt + pFile->szChunk - 1) / pFile->szChunk) * pFile->szChunk;
+		if (fs_fallocate(pFile->h, (fs_off_t)nReserve) == 0)
+		{
+			pFile->nReserved = nReserve;
+		}
+		else
+		{
+			VFS_DEBUG_MSG("RESERVE file=%p, size=%lld failed\n", pFile->h, nReserve);
+		}
+	}
+
 	/* seek pos */
 	rc = fs_fseek(pFile->h, (long int)offset, SEEK_SET);
 	if (rc != 0)
@@ -155,7 +182,9 @@ int rawWrite(unqlite_file *id, const void *pBuf, unqlite_int64 amt, unqlite_int6
 	VFS_DEBUG_RESTART();
 
 	/* do write file */
+	traceStart = IOTRACE_START();
 	wrote = fs_fwrite(pBuf, 1, amt, pFile->h);
+	IOTRACE_END(IOTRACE_LAYER_VFS, IOTRACE_OP_WR, (uint32_t)offset, (uint32_t)amt, traceStart);
 	if (rc != 0)
 	{
 		VFS_DEBUG_FINALIZE("rc != 0 UNQLITE_IOERR\n", pFile->h);
@@ -184,16 +213,6 @@ int rawTruncate(unqlite_file *id, unqlite_int64 nByte)
 
 	VFS_DEBUG_MSG("TRUNCATE file=%p, size=%lld\n", pFile->h, nByte);
 
-	/* If the user has configured a chunk-size for this file, truncate the
-	 ** file so that it consists of an integer number of chunks (i.e. the
-	 ** actual file size after the operation may be larger than the requested
-	 ** size).
-	 */
-	if (pFile->szChunk > 0)
-	{
-		nByte = ((nByte + pFile->szChunk - 1) / pFile->szChunk) * pFile->szChunk;
-	}
-
 	rc = fs_fseek(pFile->h, (long int)nByte, SEEK_SET);
 	if (rc != 0)
 	{
@@ -206,25 +225,52 @@ int rawTruncate(unqlite_file *id, unqlite_int64 nByte)
 		return UNQLITE_IOERR;
 	}
 
+	/* If the user has configured a chunk-size for this file, keep the space
+	 ** up to the next chunk boundary reserved. The file size itself is left
+	 ** at nByte since the pager derives its page count from it.
+	 */
+	pFile->nReserved = nByte;
+	if (pFile->szChunk > 0)
+	{
+		unqlite_int64 nReserve = ((nByte + pFile->szChunk - 1) / pFile->szChunk) * pFile->szChunk;
+		if (fs_fallocate(pFile->h, (fs_off_t)nReserve) == 0)
+		{
+			pFile->nReserved = nReserve;
+		}
+	}
+
 	return UNQLITE_OK;
 }
 
 /***************************************************************************************************
 * @brief         Make sure all writes to a particular file are committed to disk.
+* @details       Only this file is flushed: its buffer, its deferred directory entry and then the
+*                device. The device sync is skipped when nothing was written since the previous
+*                one, so back to back syncs of one commit (journal, then database) cost a single
+*                device barrier. UNQLITE_SYNC_NORMAL and UNQLITE_SYNC_FULL are handled alike.
 * @param[in,out] File to sync
 * @param[in]     int FileSystem flags
 * @return        ERROR CODE
 ***************************************************************************************************/
 int rawSync(unqlite_file *id, int flags)
 {
-//	if( fs_cache_flush() )
-//	{
-//		return UNQLITE_IOERR;
-//	}
-//	if( fs_cache_assign() )
-//	{
-//		return UNQLITE_IOERR;
-//	}
+	rawFile *pFile = (rawFile*)id;
+	uint32_t traceStart;
+	int rc;
+
+	VFS_DEBUG_START();
+
+	traceStart = IOTRACE_START();
+	rc = fs_fsync(pFile->h);
+	IOTRACE_END(IOTRACE_LAYER_VFS, IOTRACE_OP_SYNC, 0, 0, traceStart);
+	if (rc != 0)
+	{
+		VFS_DEBUG_FINALIZE("SYNC file=%p, rc=UNQLITE_IOERR\n", pFile->h);
+		return UNQLITE_IOERR;
+	}
+
+	VFS_DEBUG_FINALIZE("SYNC file=%p, flags=%x\n", pFile->h, flags);
+
 	return UNQLITE_OK;
 }
 
@@ -293,3 +339,48 @@ int rawSectorSize(unqlite_file *id)
 {
 	return 4096;
 }
+
+/***************************************************************************************************
+* @brief         Get a direct pointer to file content.
+* @details       Only possible when the sectors holding the data are addressable by the CPU
+*                (RAM disk) and lie in contiguous clusters. Otherwise *pp is set to NULL and
+*                the pager falls back to rawRead().
+*                Read-write files are never mapped: a RAM disk snapshot may move the chunk
+*                holding the data on the next write and free it with the snapshot, leaving a
+*                page cached by the pager pointing to released memory.
+* @param[in,out] File pointer
+* @param[in]     Offset of the data in the file
+* @param[in]     Number of bytes
+* @param[out]    Pointer to the data, or NULL
+* @return        UNQLITE_OK
+***************************************************************************************************/
+int rawFetch(unqlite_file *id, unqlite_int64 iOfst, int iAmt, void **pp)
+{
+	rawFile *pFile = (rawFile*)id;
+	FS_ERR err;
+
+	if (!pFile->isRdonly)
+	{
+		*pp = NULL;
+		return UNQLITE_OK;
+	}
+
+	*pp = FSFile_Map(pFile->h, (FS_FILE_SIZE)iOfst, (CPU_SIZE_T)iAmt, &err);
+	if (err != FS_ERR_NONE)
+	{
+		VFS_DEBUG_MSG("FETCH file=%p, offset=%lld, err=%d\n", pFile->h, iOfst, err);
+		*pp = NULL;
+	}
+
+	return UNQLITE_OK;
+}
+
+/***************************************************************************************************
+* @brief         Release a pointer obtained with rawFetch(). The data is mapped in place, so
+*                this method is a no-op.
+* @return        UNQLITE_OK
+***************************************************************************************************/
+int rawUnfetch(unqlite_file *id, unqlite_int64 iOfst, void *p)
+{
+	return UNQLITE_OK;
+}
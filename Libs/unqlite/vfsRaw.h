@@ -28,11 +28,31 @@
 #define RAWFILE_PERSIST_WAL     0x04   /* Persistent WAL mode */
 #define RAWFILE_PSOW            0x10
 
+/*
+ ** Size of the chunks in which database files grow. Space for a whole chunk is
+ ** reserved with fs_fallocate() when a write passes the end of the reserved space,
+ ** so the file system allocates clusters once per chunk instead of once per page.
+ ** Set to 0 to disable.
+ */
+#ifndef RAWFILE_CHUNK_SIZE
+#define RAWFILE_CHUNK_SIZE      ( 32 * 1024 )
+#endif
+
+/*
+ ** With BTRACE_EN the debug messages are recorded unformatted by the deferred binary trace
+ ** (see binTrace.h) instead of being printed.
+ */
 #ifdef DEBUG_VFS_EN
+#ifdef BTRACE_EN
+	#include "binTrace.h"
+	#define VFS_DEBUG_PRINTF BTRACE_Log
+#else
+	#define VFS_DEBUG_PRINTF printf
+#endif
 	#define VFS_DEBUG_START() uint32_t _perfCounterTick = HAL_GetTick();
 	#define VFS_DEBUG_RESTART() _perfCounterTick = HAL_GetTick();
-	#define VFS_DEBUG_FINALIZE(STR, ...) if(STR) { printf(STR, ##__VA_ARGS__); } printf("%ld ms\n", HAL_GetTick()-_perfCounterTick)
-    #define VFS_DEBUG_MSG(STR, ...) printf(STR, ##__VA_ARGS__)
+	#define VFS_DEBUG_FINALIZE(STR, ...) if(STR) { VFS_DEBUG_PRINTF(STR, ##__VA_ARGS__); } VFS_DEBUG_PRINTF("%ld ms\n", HAL_GetTick()-_perfCounterTick)
+    #define VFS_DEBUG_MSG(STR, ...) VFS_DEBUG_PRINTF(STR, ##__VA_ARGS__)
 #else
 	#define VFS_DEBUG_START()
 	#define VFS_DEBUG_RESTART()
@@ -54,7 +74,9 @@ struct rawFile
 	unqlite_vfs *pVfs; /* The VFS that created this rawFile */
 	FS_FILE *h; /* Pointer to access the file */
 	const char *zPath; /* Name of the file */
-	int szChunk; /* Configured by FCNTL_CHUNK_SIZE */
+	int szChunk; /* Configured by RAWFILE_CHUNK_SIZE */
+	unqlite_int64 nReserved; /* End of the space reserved with fs_fallocate() */
+	int isRdonly; /* Opened read-only, file content may be served by reference */
 };
 
 /*#*************************************************************************************************
@@ -70,6 +92,8 @@ int rawLock(unqlite_file *id, int eLock);
 int rawUnlock(unqlite_file *id, int eLock);
 int rawCheckReservedLock(unqlite_file *id, int *pResOut);
 int rawSectorSize(unqlite_file *id);
+int rawFetch(unqlite_file *id, unqlite_int64 iOfst, int iAmt, void **pp);
+int rawUnfetch(unqlite_file *id, unqlite_int64 iOfst, void *p);
 
 /** @} */ // end of Vfs_RAW_h
 #endif
@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""Decode a deferred binary trace (Core/Src/binTrace.c) captured from RTT or a file.
+
+usage: btrace_decode.py firmware.elf trace.bin [--clock HZ]
+
+The format strings are read from the firmware ELF file at the address recorded
+in each record, then the arguments are unpacked with the same rules as
+BTRACE_Log(). With --clock (core clock in Hz) the timestamps are printed in
+microseconds instead of cycles.
+"""
+import argparse
+import struct
+import sys
+
+BTRACE_MARKER = 0xB7
+BTRACE_FLAG_TRUNCATED = 0x0001
+BTRACE_ID_LOST = 0
+BTRACE_HDR_SIZE = 3
+
+
+class Elf:
+    """Minimal ELF reader: maps addresses of loaded sections to file content."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+        is64 = self.data[4] == 2
+        end = '<' if self.data[5] == 1 else '>'
+        if is64:
+            shoff, = struct.unpack_from(end + 'Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(end + 'HH', self.data, 0x3A)
+            shdr = end + 'IIQQQQIIQQ'
+        else:
+            shoff, = struct.unpack_from(end + 'I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(end + 'HH', self.data, 0x2E)
+            shdr = end + 'IIIIIIIIII'
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(shdr, self.data, shoff + i * shentsize)[:6]
+            # SHF_ALLOC sections with content (not SHT_NOBITS)
+            if flags & 0x2 and sh_type != 8 and size:
+                self.sections.append((addr, size, offset))
+
+    def string(self, addr):
+        for base, size, offset in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                stop = self.data.index(b'\0', start)
+                return self.data[start:stop].decode('latin-1')
+        return None
+
+
+def parse_format(fmt):
+    """Split a printf format in literal text and conversions, like BTRACE_Log() scans it.
+
+    Each conversion is (flags, width, precision, length, conversion), width and
+    precision being '*' when they are passed as arguments."""
+    parts = []
+    i = 0
+    n = len(fmt)
+    while i < n:
+        j = fmt.find('%', i)
+        if j < 0:
+            parts.append(fmt[i:])
+            break
+        parts.append(fmt[i:j])
+        i = j + 1
+        if i < n and fmt[i] == '%':
+            parts.append('%')
+            i += 1
+            continue
+        start = i
+        while i < n and fmt[i] in '-+ #0':
+            i += 1
+        flags = fmt[start:i]
+        start = i
+        if i < n and fmt[i] == '*':
+            i += 1
+        while i < n and fmt[i].isdigit():
+            i += 1
+        width = fmt[start:i]
+        precision = None
+        if i < n and fmt[i] == '.':
+            i += 1
+            start = i
+            if i < n and fmt[i] == '*':
+                i += 1
+            while i < n and fmt[i].isdigit():
+                i += 1
+            precision = fmt[start:i]
+        start = i
+        if fmt.startswith(('hh', 'll'), i):
+            i += 2
+        elif i < n and fmt[i] in 'hljztL':
+            i += 1
+        length = fmt[start:i]
+        conv = fmt[i] if i < n else ''
+        i += 1
+        parts.append((flags, width, precision, length, conv))
+    return parts
+
+
+class Args:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, fmt, size):
+        if self.pos + size > len(self.data):
+            raise IndexError
+        value, = struct.unpack_from('<' + fmt, self.data, self.pos)
+        self.pos += size
+        return value
+
+    def string(self):
+        size = self.take('B', 1)
+        if self.pos + size > len(self.data):
+            raise IndexError
+        value = self.data[self.pos:self.pos + size].decode('latin-1')
+        self.pos += size
+        return value
+
+
+def render(fmt, data, truncated):
+    args = Args(data)
+    out = []
+    for part in parse_format(fmt):
+        if isinstance(part, str):
+            out.append(part)
+            continue
+        flags, width, precision, length, conv = part
+        try:
+            if width == '*':
+                width = str(args.take('i', 4))
+            if precision == '*':
+                precision = str(args.take('i', 4))
+            spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+            wide = length in ('ll', 'j')
+            if conv in 'di':
+                out.append((spec + 'd') % args.take('q' if wide else 'i', 8 if wide else 4))
+            elif conv in 'uxXo':
+                out.append((spec + ('d' if conv == 'u' else conv)) % args.take('Q' if wide else 'I', 8 if wide else 4))
+            elif conv == 'c':
+                out.append((spec + 'c') % chr(args.take('I', 4) & 0xFF))
+            elif conv == 'p':
+                out.append((spec + 's') % ('0x%08x' % args.take('I', 4)))
+            elif conv in 'eEfFgGaA':
+                out.append((spec + (conv if conv not in 'aA' else 'g')) % args.take('d', 8))
+            elif conv == 's':
+                out.append((spec + 's') % args.string())
+        except IndexError:
+            out.append('?' if truncated else '<missing>')
+    return ''.join(out)
+
+
+def records(stream):
+    """Yield (flags, id, timestamp, args) for each record, resynchronizing on the marker."""
+    pos = 0
+    while pos + 4 * BTRACE_HDR_SIZE <= len(stream):
+        hdr, = struct.unpack_from('<I', stream, pos)
+        words = (hdr >> 16) & 0xFF
+        if hdr >> 24 != BTRACE_MARKER or words < BTRACE_HDR_SIZE or pos + 4 * words > len(stream):
+            pos += 1
+            continue
+        fmt_id, ts = struct.unpack_from('<II', stream, pos + 4)
+        yield hdr & 0xFFFF, fmt_id, ts, stream[pos + 4 * BTRACE_HDR_SIZE:pos + 4 * words]
+        pos += 4 * words
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf', help='firmware ELF file holding the format strings')
+    parser.add_argument('trace', help='binary trace captured from the RTT up buffer')
+    parser.add_argument('--clock', type=float, help='core clock in Hz, to print timestamps in us')
+    opts = parser.parse_args()
+
+    elf = Elf(opts.elf)
+    with open(opts.trace, 'rb') as f:
+        stream = f.read()
+
+    for flags, fmt_id, ts, data in records(stream):
+        stamp = '%12.1f' % (ts * 1e6 / opts.clock) if opts.clock else '%10u' % ts
+        if fmt_id == BTRACE_ID_LOST:
+            text = '*** %u records lost ***' % struct.unpack_from('<I', data)[0]
+        else:
+            fmt = elf.string(fmt_id)
+            if fmt is None:
+                text = '<unknown format 0x%08x>' % fmt_id
+            else:
+                text = render(fmt, data, flags & BTRACE_FLAG_TRUNCATED)
+        sys.stdout.write('[%s] %s\n' % (stamp, text.rstrip('\r\n')))
+
+
+if __name__ == '__main__':
+    main()
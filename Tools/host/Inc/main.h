@@ -0,0 +1,24 @@
+/***************************************************************************************************
+* @file
+* @brief     Host replacement of the CubeMX main.h.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            Declares the few HAL services used by the storage stack (Libs/unqlite, dbBench), which
+*            host.c implements on top of the POSIX clock.
+* @date      10/2026
+**************************************************************************************************/
+#ifndef __MAIN_H
+#define __MAIN_H
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdint.h"
+
+/***************************************************************************************************
+* Prototypes
+***************************************************************************************************/
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void Error_Handler(void);
+
+#endif
@@ -0,0 +1,13 @@
+/***************************************************************************************************
+* @file
+* @brief     Host replacement of the STM32U575 device header.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            The storage stack includes it for the HAL types only, see main.h.
+* @date      10/2026
+**************************************************************************************************/
+#ifndef __STM32U575xx_H
+#define __STM32U575xx_H
+
+#include "main.h"
+
+#endif
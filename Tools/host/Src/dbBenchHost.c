@@ -0,0 +1,59 @@
+/***************************************************************************************************
+* @file
+* @brief     Host runner of the storage benchmark on the W25Q simulator.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: dbbench_host [records] [backing file]
+*            Mounts "nor:0:" on the simulator (low-level formats and formats it when the backing file
+*            is new, like App_FS_Init() does on target), runs DBBENCH_Run() on "bench.db" and prints
+*            the simulator totals.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// fputs, printf
+#include "stdlib.h"	// strtoul
+#include "lib_mem.h"
+#include "fs_app.h"
+#include "dbBench.h"
+#include "Dev/NOR/BSP/bsp_fs_dev_nor_sim.h"
+
+/***************************************************************************************************
+* @brief Sends a benchmark report line to stdout.
+***************************************************************************************************/
+static void dbBenchHost_Writer(const char *str, void *arg)
+{
+	(void)arg;
+	fputs(str, stdout);
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success, 1 if the file system could not be mounted or a workload failed.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	uint32_t records = (argc < 2) ? 500 : (uint32_t)strtoul(argv[1], 0, 10);
+	FS_DEV_NOR_SIM_STAT stat;
+	int rc;
+
+	if (argc > 2)
+	{
+		FSDev_NOR_SimFileSet(argv[2]);
+	}
+	Mem_Init();
+	if (App_FS_Init() != DEF_OK)
+	{
+		return 1;
+	}
+
+	rc = DBBENCH_Run("bench.db", records, dbBenchHost_Writer, 0);
+
+	FSDev_NOR_SimStatGet(&stat);
+	printf("S,sim,rd=%lu,pgm=%lu,eraseSec=%lu,eraseBlk=%lu,pgmOctets=%llu,busUs=%llu,busyUs=%llu,secEraseMax=%lu\n",
+		   (unsigned long)stat.RdCmdCtr, (unsigned long)stat.PgmCmdCtr, (unsigned long)stat.EraseSecCtr,
+		   (unsigned long)(stat.EraseBlk32KCtr + stat.EraseBlk64KCtr),
+		   (unsigned long long)stat.PgmOctetCtr, (unsigned long long)stat.BusTime_us,
+		   (unsigned long long)stat.BusyTime_us, (unsigned long)stat.SecEraseMax);
+	return (rc == 0) ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/***************************************************************************************************
+* @file
+* @brief     Host services replacing the HAL and the RTT debug output.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            The debug functions print to stdout (errors to stderr), the HAL tick and delay use the
+*            POSIX monotonic clock.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "main.h"
+#include "debug.h"
+#include "stdarg.h"	// variadic arguments.
+#include "stdio.h"	// vprintf
+#include "stdlib.h"	// abort
+#include "time.h"	// clock_gettime, nanosleep
+#include <stdbool.h>
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static bool enabled = true;
+
+/***************************************************************************************************
+* @brief Milliseconds since an arbitrary point, like the SysTick counter.
+***************************************************************************************************/
+uint32_t HAL_GetTick(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+/***************************************************************************************************
+* @brief Sleep for 'Delay' milliseconds.
+***************************************************************************************************/
+void HAL_Delay(uint32_t Delay)
+{
+	struct timespec ts;
+
+	ts.tv_sec = Delay / 1000u;
+	ts.tv_nsec = (long)(Delay % 1000u) * 1000000L;
+	nanosleep(&ts, 0);
+}
+/***************************************************************************************************
+* @brief Fatal error.
+***************************************************************************************************/
+void Error_Handler(void)
+{
+	fputs("Error_Handler\n", stderr);
+	abort();
+}
+/***************************************************************************************************
+* @brief Enable/disable the debug output.
+***************************************************************************************************/
+void DEBUG_Enable(void)
+{
+	enabled = true;
+}
+void DEBUG_Disable(void)
+{
+	enabled = false;
+}
+/***************************************************************************************************
+* @brief Print a line, with or without line feed.
+***************************************************************************************************/
+void DEBUG_Log(char * text)
+{
+	DEBUG_printf("%s", text);
+}
+void DEBUG_LogNoLF(char * text)
+{
+	DEBUG_printfNoLF("%s", text);
+}
+void DEBUG_LogNoPreNoLF(char * text)
+{
+	DEBUG_printfNoPreNoLF("%s", text);
+}
+/***************************************************************************************************
+* @brief Formatted output. The host has no prefix (the target prints the RTC time).
+***************************************************************************************************/
+void DEBUG_printf(const char* fmt, ...)
+{
+	va_list args;
+
+	if (!enabled)
+		return;
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+	putchar('\n');
+}
+void DEBUG_printfNoLF(const char* fmt, ...)
+{
+	va_list args;
+
+	if (!enabled)
+		return;
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+void DEBUG_printfNoPreNoLF(const char* fmt, ...)
+{
+	va_list args;
+
+	if (!enabled)
+		return;
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+void DEBUG_printfNoLogger(const char* fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+	putchar('\n');
+}
+/***************************************************************************************************
+* @brief Error output.
+***************************************************************************************************/
+void ERROR_Log(char * text)
+{
+	ERROR_printf("%s", text);
+}
+void ERROR_printf(const char* fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
@@ -0,0 +1,113 @@
+/***************************************************************************************************
+* @file
+* @brief     Regression test: deferred collection headers on close and rollback.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_close_no_commit <backing file>
+*            Collection headers are written at commit time (see unqliteVmFlushCollections()).
+*            Closing a handle with auto-commit disabled while a VM still holds dirty collections
+*            must neither write through the closed pager nor keep the rolled back counters, and a
+*            rollback must bring the counters of a live VM back to the committed ones.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "lib_mem.h"
+#include "fs_app.h"
+#include "unqlite.h"
+#include "Dev/NOR/BSP/bsp_fs_dev_nor_sim.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_DB							"close.db"
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+/* $n records are stored in collection 'c' (created if needed), $total is its record count. */
+static const char jx9Store[] =
+	"if( !db_exists('c') ){ db_create('c'); }"
+	"for($i = 0; $i < $n; $i++){ db_store('c', {v: $i}); }"
+	"$total = db_total_records('c');";
+
+/***************************************************************************************************
+* @brief Run the store script on a compiled VM.
+* @return Record count of the collection seen by the script, -1 on error.
+***************************************************************************************************/
+static long long test_Store(unqlite_vm *pVm, int n)
+{
+	unqlite_value *pVal;
+
+	unqlite_vm_reset(pVm);
+	pVal = unqlite_vm_new_scalar(pVm);
+	unqlite_value_int64(pVal, n);
+	unqlite_vm_config(pVm, UNQLITE_VM_CONFIG_CREATE_VAR, "n", pVal);
+	unqlite_vm_release_value(pVm, pVal);
+	if (unqlite_vm_exec(pVm) != UNQLITE_OK)
+	{
+		return -1;
+	}
+	pVal = unqlite_vm_extract_variable(pVm, "total");
+	return pVal ? (long long)unqlite_value_to_int64(pVal) : -1;
+}
+/***************************************************************************************************
+* @brief Open the test database and compile the store script.
+***************************************************************************************************/
+static int test_Open(unqlite **ppDb, unqlite_vm **ppVm)
+{
+	if (unqlite_open(ppDb, TEST_DB, UNQLITE_OPEN_CREATE) != UNQLITE_OK)
+	{
+		return UNQLITE_IOERR;
+	}
+	return unqlite_compile(*ppDb, jx9Store, sizeof(jx9Store) - 1, ppVm);
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	unqlite *pDb;
+	unqlite_vm *pVm;
+
+	if (argc > 1)
+	{
+		FSDev_NOR_SimFileSet(argv[1]);
+	}
+	Mem_Init();
+	TEST_CHECK(App_FS_Init() == DEF_OK);
+
+	/* Auto-commit: the VM is released by unqlite_close(), after its headers were committed. */
+	TEST_CHECK(test_Open(&pDb, &pVm) == UNQLITE_OK);
+	TEST_CHECK(test_Store(pVm, 10) == 10);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	/* Auto-commit disabled: the pending records and the dirty header are rolled back on close. */
+	TEST_CHECK(test_Open(&pDb, &pVm) == UNQLITE_OK);
+	TEST_CHECK(test_Store(pVm, 0) == 10);
+	TEST_CHECK(unqlite_config(pDb, UNQLITE_CONFIG_DISABLE_AUTO_COMMIT) == UNQLITE_OK);
+	TEST_CHECK(test_Store(pVm, 5) == 15);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	/* Only the committed records are left. A rollback reloads the counters of the live VM. */
+	TEST_CHECK(test_Open(&pDb, &pVm) == UNQLITE_OK);
+	TEST_CHECK(test_Store(pVm, 0) == 10);
+	TEST_CHECK(test_Store(pVm, 7) == 17);
+	TEST_CHECK(unqlite_rollback(pDb) == UNQLITE_OK);
+	TEST_CHECK(test_Store(pVm, 0) == 10);
+	TEST_CHECK(test_Store(pVm, 1) == 11);
+	TEST_CHECK(unqlite_vm_release(pVm) == UNQLITE_OK);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	TEST_CHECK(test_Open(&pDb, &pVm) == UNQLITE_OK);
+	TEST_CHECK(test_Store(pVm, 0) == 11);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,201 @@
+/***************************************************************************************************
+* @file
+* @brief     Regression test: group commit (UNQLITE_CONFIG_GROUP_COMMIT) rollback and flush.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_group_commit [database file]
+*            A rollback issued after acknowledged group commits must only revert the current
+*            transaction, also when it changed enough pages for a dirty commit to write some of them
+*            early, and the acknowledged commits must survive a reopen. The group is flushed by
+*            UNQLITE_CONFIG_GROUP_COMMIT_FLUSH (the open write transaction keeps the journal file
+*            until then), which is refused while the current transaction has uncommitted changes.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "string.h"	// memset
+#include "unistd.h"	// access, unlink
+#include "unqlite.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_GROUP						8
+#define TEST_WINDOW_MS					100
+#define TEST_BULK_CNT					2000u	// records of the large transaction (dirty commit)
+#define TEST_VALUE_SIZE					256u
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static const char *test_Path;
+static char test_Journal[256];
+static unsigned int test_Tick;
+
+/***************************************************************************************************
+* @brief Millisecond tick source of the group window.
+***************************************************************************************************/
+static unsigned int test_TickGet(void)
+{
+	return test_Tick;
+}
+/***************************************************************************************************
+* @brief Store a value derived from 'seed' under the key 'k<i>'.
+***************************************************************************************************/
+static int test_Put(unqlite *pDb, unsigned i, unsigned seed)
+{
+	char value[TEST_VALUE_SIZE];
+	char key[16];
+	int keyLen;
+
+	keyLen = snprintf(key, sizeof(key), "k%u", i);
+	memset(value, 'a' + (int)(seed % 26u), sizeof(value));
+	return unqlite_kv_store(pDb, key, keyLen, value, sizeof(value));
+}
+/***************************************************************************************************
+* @brief Check the value of key 'k<i>': seed 0 means no such record.
+***************************************************************************************************/
+static int test_Get(unqlite *pDb, unsigned i, unsigned seed)
+{
+	char value[TEST_VALUE_SIZE];
+	unqlite_int64 nBytes = sizeof(value);
+	char key[16];
+	int keyLen;
+	int rc;
+
+	keyLen = snprintf(key, sizeof(key), "k%u", i);
+	rc = unqlite_kv_fetch(pDb, key, keyLen, value, &nBytes);
+	if (seed == 0u)
+	{
+		return rc == UNQLITE_NOTFOUND ? 0 : 1;
+	}
+	return (rc == UNQLITE_OK && nBytes == sizeof(value) && value[0] == 'a' + (int)(seed % 26u)) ? 0 : 1;
+}
+/***************************************************************************************************
+* @brief Run a Jx9 script and return the integer value of its $res variable (-1 on error).
+***************************************************************************************************/
+static long test_Jx9(unqlite *pDb, const char *script)
+{
+	unqlite_value *pValue;
+	unqlite_vm *pVm;
+	long res = -1;
+
+	if (unqlite_compile(pDb, script, -1, &pVm) != UNQLITE_OK)
+	{
+		return -1;
+	}
+	if (unqlite_vm_exec(pVm) == UNQLITE_OK)
+	{
+		pValue = unqlite_vm_extract_variable(pVm, "res");
+		if (pValue)
+		{
+			res = (long)unqlite_value_to_int64(pValue);
+		}
+	}
+	unqlite_vm_release(pVm);
+	return res;
+}
+/***************************************************************************************************
+* @brief Open the database with group commit enabled.
+***************************************************************************************************/
+static int test_Open(unqlite **ppDb)
+{
+	TEST_CHECK(unqlite_open(ppDb, test_Path, UNQLITE_OPEN_CREATE) == UNQLITE_OK);
+	TEST_CHECK(unqlite_config(*ppDb, UNQLITE_CONFIG_GROUP_COMMIT, TEST_GROUP, TEST_WINDOW_MS, test_TickGet) == UNQLITE_OK);
+	return 0;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	unqlite *pDb;
+	unsigned i;
+
+	test_Path = (argc > 1) ? argv[1] : "group_commit.db";
+	snprintf(test_Journal, sizeof(test_Journal), "%s_unqlite_journal", test_Path);
+	unlink(test_Path);
+	unlink(test_Journal);
+
+	/* Rollback after two acknowledged commits: only the third transaction is reverted */
+	TEST_CHECK(test_Open(&pDb) == 0);
+	TEST_CHECK(test_Put(pDb, 1u, 1u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	TEST_CHECK(test_Put(pDb, 2u, 2u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	TEST_CHECK(access(test_Journal, F_OK) == 0);
+	TEST_CHECK(test_Put(pDb, 1u, 5u) == UNQLITE_OK);
+	TEST_CHECK(test_Put(pDb, 3u, 3u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_rollback(pDb) == UNQLITE_OK);
+	TEST_CHECK(test_Get(pDb, 1u, 1u) == 0);
+	TEST_CHECK(test_Get(pDb, 2u, 2u) == 0);
+	TEST_CHECK(test_Get(pDb, 3u, 0u) == 0);
+	/* The group was flushed by the rollback */
+	TEST_CHECK(access(test_Journal, F_OK) != 0);
+
+	/* Same with a transaction large enough to be partly written by a dirty commit */
+	TEST_CHECK(test_Put(pDb, 4u, 4u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	for (i = 0u; i < TEST_BULK_CNT; i++)
+	{
+		TEST_CHECK(test_Put(pDb, 100u + i, 7u) == UNQLITE_OK);
+	}
+	TEST_CHECK(test_Put(pDb, 2u, 9u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_rollback(pDb) == UNQLITE_OK);
+	TEST_CHECK(test_Get(pDb, 2u, 2u) == 0);
+	TEST_CHECK(test_Get(pDb, 4u, 4u) == 0);
+	TEST_CHECK(test_Get(pDb, 100u, 0u) == 0);
+	TEST_CHECK(test_Get(pDb, 100u + TEST_BULK_CNT - 1u, 0u) == 0);
+
+	/* Collection headers written by an acknowledged db_commit() survive the rollback */
+	TEST_CHECK(test_Jx9(pDb, "db_create('col'); db_store('col', {a: 1}); $res = db_commit();") == 1);
+	TEST_CHECK(test_Jx9(pDb, "db_store('col', {a: 2}); db_store('col', {a: 3}); $res = db_total_records('col');") == 3);
+	TEST_CHECK(unqlite_rollback(pDb) == UNQLITE_OK);
+	TEST_CHECK(test_Jx9(pDb, "$res = db_total_records('col');") == 1);
+
+	/* Flush hook: refused while changes are pending, else flushed once the window is over */
+	TEST_CHECK(test_Put(pDb, 5u, 5u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	TEST_CHECK(test_Put(pDb, 6u, 6u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_config(pDb, UNQLITE_CONFIG_GROUP_COMMIT_FLUSH, 0) == UNQLITE_BUSY);
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	TEST_CHECK(unqlite_config(pDb, UNQLITE_CONFIG_GROUP_COMMIT_FLUSH, 1) == UNQLITE_OK);
+	TEST_CHECK(access(test_Journal, F_OK) == 0);
+	test_Tick += TEST_WINDOW_MS;
+	TEST_CHECK(unqlite_config(pDb, UNQLITE_CONFIG_GROUP_COMMIT_FLUSH, 1) == UNQLITE_OK);
+	TEST_CHECK(access(test_Journal, F_OK) != 0);
+	TEST_CHECK(test_Put(pDb, 7u, 7u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	TEST_CHECK(unqlite_config(pDb, UNQLITE_CONFIG_GROUP_COMMIT_FLUSH, 0) == UNQLITE_OK);
+	TEST_CHECK(access(test_Journal, F_OK) != 0);
+
+	/* Closing without auto-commit reverts the open transaction, not the acknowledged ones */
+	TEST_CHECK(test_Put(pDb, 8u, 8u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	TEST_CHECK(test_Put(pDb, 9u, 9u) == UNQLITE_OK);
+	TEST_CHECK(unqlite_config(pDb, UNQLITE_CONFIG_DISABLE_AUTO_COMMIT) == UNQLITE_OK);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	TEST_CHECK(unqlite_open(&pDb, test_Path, UNQLITE_OPEN_READONLY) == UNQLITE_OK);
+	TEST_CHECK(test_Get(pDb, 1u, 1u) == 0);
+	TEST_CHECK(test_Get(pDb, 2u, 2u) == 0);
+	TEST_CHECK(test_Get(pDb, 3u, 0u) == 0);
+	TEST_CHECK(test_Get(pDb, 4u, 4u) == 0);
+	TEST_CHECK(test_Get(pDb, 100u, 0u) == 0);
+	for (i = 5u; i <= 8u; i++)
+	{
+		TEST_CHECK(test_Get(pDb, i, i) == 0);
+	}
+	TEST_CHECK(test_Get(pDb, 9u, 0u) == 0);
+	TEST_CHECK(test_Jx9(pDb, "$res = db_total_records('col');") == 1);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	unlink(test_Path);
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,150 @@
+/***************************************************************************************************
+* @file
+* @brief     Benchmark: bucket occupancy of the linear hash KV store with the DJB and xxHash32 hashes.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_hash_chain [database file]
+*            The same "sensor_%08d" keys are loaded in a database hashed with the legacy DJB function
+*            (the default of older databases) and in one hashed with the default xxHash32, then the
+*            bucket occupancy histogram of both is printed (UNQLITE_KV_CONFIG_BUCKET_STATS).
+*            Output: H,<hash>,<records per bucket>,<buckets>
+*                    C,<hash>,buckets=<n>,empty=<n>,max=<records>,mean=<records>,ms=<load time>
+*            Buckets are split as they fill up, so a poor hash ends up with both empty and crowded
+*            buckets: the default hash must leave no more empty buckets than DJB and a lower
+*            fullest/mean bucket ratio.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "string.h"	// memset
+#include "time.h"
+#include "unistd.h"	// unlink
+#include "unqlite.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_RECORD_CNT					4096u
+#define TEST_VALUE_SIZE					64u
+#define TEST_HISTO_CNT					64		// last entry: buckets of 63 records or more
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+typedef struct
+{
+	unsigned buckets;		// buckets of the database
+	unsigned empty;			// buckets without records
+	unsigned max;			// records of the fullest bucket
+	double mean;			// records per bucket
+	double ms;				// load time
+} TEST_RESULT;
+
+/***************************************************************************************************
+* @brief Legacy DJB hash of the lhash KV store (see lhash_bin_hash()).
+***************************************************************************************************/
+static unsigned int test_DjbHash(const void *pSrc, unsigned int nLen)
+{
+	const unsigned char *zIn = (const unsigned char *)pSrc;
+	unsigned int nH = 5381;
+
+	if (nLen > 2048)
+	{
+		nLen = 2048;
+	}
+	while (nLen-- > 0)
+	{
+		nH = nH * 33 + *zIn++;
+	}
+	return nH;
+}
+/***************************************************************************************************
+* @brief Load the keys in a fresh database hashed with 'xHash' (default hash if NULL) and print the
+*        bucket occupancy histogram.
+***************************************************************************************************/
+static int test_Load(const char *path, const char *name, unsigned int (*xHash)(const void *, unsigned int), TEST_RESULT *pRes)
+{
+	unsigned int histo[TEST_HISTO_CNT];
+	char value[TEST_VALUE_SIZE];
+	char key[32];
+	char journal[256];
+	struct timespec t0;
+	struct timespec t1;
+	unqlite_int64 nBytes;
+	unqlite *pDb;
+	unsigned records;
+	unsigned i;
+	int keyLen;
+
+	snprintf(journal, sizeof(journal), "%s_unqlite_journal", path);
+	unlink(path);
+	unlink(journal);
+	TEST_CHECK(unqlite_open(&pDb, path, UNQLITE_OPEN_CREATE) == UNQLITE_OK);
+	if (xHash)
+	{
+		TEST_CHECK(unqlite_kv_config(pDb, UNQLITE_KV_CONFIG_HASH_FUNC, xHash) == UNQLITE_OK);
+	}
+
+	memset(value, 'v', sizeof(value));
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0u; i < TEST_RECORD_CNT; i++)
+	{
+		keyLen = snprintf(key, sizeof(key), "sensor_%08u", i);
+		TEST_CHECK(unqlite_kv_store(pDb, key, keyLen, value, sizeof(value)) == UNQLITE_OK);
+	}
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	TEST_CHECK(unqlite_kv_config(pDb, UNQLITE_KV_CONFIG_BUCKET_STATS, histo, TEST_HISTO_CNT) == UNQLITE_OK);
+	memset(pRes, 0, sizeof(*pRes));
+	records = 0u;
+	for (i = 0u; i < TEST_HISTO_CNT; i++)
+	{
+		if (histo[i] != 0u)
+		{
+			printf("H,%s,%u%s,%u\n", name, i, (i == TEST_HISTO_CNT - 1) ? "+" : "", histo[i]);
+			pRes->buckets += histo[i];
+			pRes->max = i;
+			records += histo[i] * i;
+		}
+	}
+	TEST_CHECK(records == TEST_RECORD_CNT);
+	pRes->empty = histo[0];
+	pRes->mean = (double)records / (double)pRes->buckets;
+	pRes->ms = (double)(t1.tv_sec - t0.tv_sec) * 1e3 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e6;
+	printf("C,%s,buckets=%u,empty=%u,max=%u,mean=%.2f,ms=%.1f\n", name, pRes->buckets, pRes->empty,
+		   pRes->max, pRes->mean, pRes->ms);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	/* The hash function is recognized when the database is reopened (DJB databases fall back to it) */
+	TEST_CHECK(unqlite_open(&pDb, path, UNQLITE_OPEN_READONLY) == UNQLITE_OK);
+	keyLen = snprintf(key, sizeof(key), "sensor_%08u", TEST_RECORD_CNT / 2u);
+	nBytes = sizeof(value);
+	TEST_CHECK(unqlite_kv_fetch(pDb, key, keyLen, value, &nBytes) == UNQLITE_OK);
+	TEST_CHECK(nBytes == sizeof(value));
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+	unlink(path);
+	return 0;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	const char *path = (argc > 1) ? argv[1] : "hash_chain.db";
+	TEST_RESULT djb;
+	TEST_RESULT xx;
+
+	TEST_CHECK(test_Load(path, "djb", test_DjbHash, &djb) == 0);
+	TEST_CHECK(test_Load(path, "xxh32", 0, &xx) == 0);
+
+	TEST_CHECK(xx.empty <= djb.empty);
+	TEST_CHECK(xx.max / xx.mean < djb.max / djb.mean);
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,335 @@
+/***************************************************************************************************
+* @file
+* @brief     Scaling test: concurrent record lookups on the same UnQLite handle.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_kv_rd_scale <db file> [record processing time in us]
+*            The library is built with UNQLITE_ENABLE_THREADS on the host VFS: the handle mutex is
+*            a reader/writer lock, lookups served from the page cache hold it in shared mode.
+*            1, 2 and 4 threads fetch the records through unqlite_kv_fetch_callback(), the consumer
+*            spending a fixed time on each record: the throughput must scale with the threads.
+*            Cursor walks and lookups mixed with a writer must keep returning the stored records.
+*            Output: KV,<mode>,<threads>,<lookups/s>,<max lookups in flight>
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "stdlib.h"	// atoi
+#include "pthread.h"
+#include "time.h"
+#include "unistd.h"	// usleep
+#include "unqlite.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_REC_CNT					4096u
+#define TEST_VAL_SIZE					64u
+#define TEST_THREAD_MAX					4u
+#define TEST_LOOKUP_CNT					256u	// lookups per thread with latency
+#define TEST_FAST_LOOKUP_CNT			20000u	// lookups per thread without latency
+#define TEST_WRITE_CNT					512u	// records stored while reading
+#define TEST_LATENCY_US					200
+#define TEST_SCALE_MIN					1.5		// 4 threads vs 1
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+typedef struct
+{
+	unsigned id;			// thread index
+	unsigned lookupCnt;		// lookups to perform
+	unsigned latencyUs;		// record processing time
+	int err;				// 0 if every record was found with the expected value
+} TEST_READER;
+
+typedef struct
+{
+	unsigned key;			// record the value belongs to
+	unsigned pos;			// octets checked so far
+	int err;				// value mismatch
+} TEST_VALUE;
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static unqlite *test_Db;
+static unsigned test_LatencyUs = TEST_LATENCY_US;
+
+static pthread_mutex_t test_InFlightLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned test_InFlight;
+static unsigned test_InFlightMax;
+
+/***************************************************************************************************
+* @brief Test pattern: octet at offset 'pos' of the value of record 'key'.
+***************************************************************************************************/
+static unsigned char test_Pattern(unsigned key, unsigned pos)
+{
+	return (unsigned char)((key * 31u) + (pos * 7u) + (key >> 8));
+}
+/***************************************************************************************************
+* @brief Key of record 'key'.
+***************************************************************************************************/
+static int test_Key(char *buf, size_t size, unsigned key)
+{
+	return snprintf(buf, size, "key%05u", key);
+}
+/***************************************************************************************************
+* @brief Store records [first, first + cnt[.
+***************************************************************************************************/
+static int test_Store(unsigned first, unsigned cnt)
+{
+	unsigned char val[TEST_VAL_SIZE];
+	char key[16];
+	unsigned i;
+	unsigned pos;
+
+	for (i = first; i < first + cnt; i++)
+	{
+		for (pos = 0u; pos < TEST_VAL_SIZE; pos++)
+		{
+			val[pos] = test_Pattern(i, pos);
+		}
+		if (unqlite_kv_store(test_Db, key, test_Key(key, sizeof(key), i), val, TEST_VAL_SIZE) != UNQLITE_OK)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+/***************************************************************************************************
+* @brief Value consumer: check the pattern.
+***************************************************************************************************/
+static int test_Consumer(const void *pData, unsigned int len, void *pUserData)
+{
+	TEST_VALUE *pVal = (TEST_VALUE *)pUserData;
+	const unsigned char *p = (const unsigned char *)pData;
+	unsigned i;
+
+	for (i = 0u; i < len; i++, pVal->pos++)
+	{
+		pVal->err |= (p[i] != test_Pattern(pVal->key, pVal->pos));
+	}
+	return UNQLITE_OK;
+}
+/***************************************************************************************************
+* @brief Value consumer with latency; tracks the lookups in flight.
+***************************************************************************************************/
+static int test_SlowConsumer(const void *pData, unsigned int len, void *pUserData)
+{
+	pthread_mutex_lock(&test_InFlightLock);
+	if (++test_InFlight > test_InFlightMax)
+	{
+		test_InFlightMax = test_InFlight;
+	}
+	pthread_mutex_unlock(&test_InFlightLock);
+
+	usleep(test_LatencyUs);
+
+	pthread_mutex_lock(&test_InFlightLock);
+	test_InFlight--;
+	pthread_mutex_unlock(&test_InFlightLock);
+	return test_Consumer(pData, len, pUserData);
+}
+/***************************************************************************************************
+* @brief Fetch record 'key' and check its value.
+* @return 0 if found with the expected value.
+***************************************************************************************************/
+static int test_Fetch(unsigned key, int slow)
+{
+	TEST_VALUE val;
+	char buf[16];
+	int rc;
+
+	val.key = key;
+	val.pos = 0u;
+	val.err = 0;
+	rc = unqlite_kv_fetch_callback(test_Db, buf, test_Key(buf, sizeof(buf), key), slow ? test_SlowConsumer : test_Consumer, &val);
+	return (rc != UNQLITE_OK) || val.err || (val.pos != TEST_VAL_SIZE);
+}
+/***************************************************************************************************
+* @brief Reader thread: fetch records spread over the database.
+***************************************************************************************************/
+static void *test_Reader(void *pArg)
+{
+	TEST_READER *pRd = (TEST_READER *)pArg;
+	unsigned i;
+
+	pRd->err = 0;
+	for (i = 0u; (i < pRd->lookupCnt) && !pRd->err; i++)
+	{
+		pRd->err = test_Fetch((i * 7919u + pRd->id * 1009u) % TEST_REC_CNT, pRd->latencyUs != 0u);
+	}
+	return NULL;
+}
+/***************************************************************************************************
+* @brief Cursor thread: walk the whole database and check every record.
+***************************************************************************************************/
+static void *test_Walker(void *pArg)
+{
+	TEST_READER *pRd = (TEST_READER *)pArg;
+	unqlite_kv_cursor *pCur;
+	TEST_VALUE val;
+	char key[16];
+	int keyLen;
+	unsigned cnt = 0u;
+
+	pRd->err = 1;
+	if (unqlite_kv_cursor_init(test_Db, &pCur) != UNQLITE_OK)
+	{
+		return NULL;
+	}
+	for (unqlite_kv_cursor_first_entry(pCur); unqlite_kv_cursor_valid_entry(pCur); unqlite_kv_cursor_next_entry(pCur))
+	{
+		keyLen = (int)sizeof(key) - 1;
+		if (unqlite_kv_cursor_key(pCur, key, &keyLen) != UNQLITE_OK)
+		{
+			break;
+		}
+		key[keyLen] = '\0';
+		val.key = (unsigned)atoi(&key[3]);
+		val.pos = 0u;
+		val.err = 0;
+		if ((unqlite_kv_cursor_data_callback(pCur, test_Consumer, &val) != UNQLITE_OK) || val.err || (val.pos != TEST_VAL_SIZE))
+		{
+			break;
+		}
+		cnt++;
+	}
+	unqlite_kv_cursor_release(test_Db, pCur);
+	pRd->err = (cnt != pRd->lookupCnt);
+	return NULL;
+}
+/***************************************************************************************************
+* @brief Run 'threadCnt' threads.
+* @return Lookups per second, negative on error.
+***************************************************************************************************/
+static double test_Run(void *(*xThread)(void *), unsigned threadCnt, unsigned lookupCnt, unsigned latencyUs, unsigned *pInFlightMax)
+{
+	pthread_t thread[TEST_THREAD_MAX];
+	TEST_READER rd[TEST_THREAD_MAX];
+	struct timespec t0;
+	struct timespec t1;
+	double sec;
+	unsigned i;
+	int err = 0;
+
+	test_InFlightMax = 0u;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0u; i < threadCnt; i++)
+	{
+		rd[i].id = i;
+		rd[i].lookupCnt = lookupCnt;
+		rd[i].latencyUs = latencyUs;
+		pthread_create(&thread[i], NULL, xThread, &rd[i]);
+	}
+	for (i = 0u; i < threadCnt; i++)
+	{
+		pthread_join(thread[i], NULL);
+		err |= rd[i].err;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	if (pInFlightMax)
+	{
+		*pInFlightMax = test_InFlightMax;
+	}
+	sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+	return err ? -1.0 : (double)threadCnt * lookupCnt / sec;
+}
+/***************************************************************************************************
+* @brief Writer thread: store new records while the readers run.
+***************************************************************************************************/
+static void *test_Writer(void *pArg)
+{
+	int *pErr = (int *)pArg;
+	unsigned i;
+
+	*pErr = 0;
+	for (i = 0u; (i < TEST_WRITE_CNT) && !*pErr; i++)
+	{
+		*pErr = test_Store(TEST_REC_CNT + i, 1u);
+	}
+	if (!*pErr)
+	{
+		*pErr = (unqlite_commit(test_Db) != UNQLITE_OK);
+	}
+	return NULL;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	pthread_t writer;
+	double rate[3];
+	unsigned inFlight[3];
+	unsigned threadCnt;
+	unsigned run;
+	unsigned i;
+	int writeErr;
+
+	if (argc < 2)
+	{
+		printf("usage: %s <db file> [record processing time in us]\n", argv[0]);
+		return 1;
+	}
+	if (argc > 2)
+	{
+		test_LatencyUs = (unsigned)atoi(argv[2]);
+	}
+	TEST_CHECK(unqlite_open(&test_Db, argv[1], UNQLITE_OPEN_CREATE) == UNQLITE_OK);
+	TEST_CHECK(unqlite_lib_is_threadsafe());
+	TEST_CHECK(test_Store(0u, TEST_REC_CNT) == 0);
+	TEST_CHECK(unqlite_commit(test_Db) == UNQLITE_OK);
+	/* Warm the page cache: the first lookups miss and take the handle exclusively. */
+	for (i = 0u; i < TEST_REC_CNT; i++)
+	{
+		TEST_CHECK(test_Fetch(i, 0) == 0);
+	}
+
+	/* Lookups with a record processing time. */
+	for (run = 0u, threadCnt = 1u; threadCnt <= TEST_THREAD_MAX; run++, threadCnt *= 2u)
+	{
+		rate[run] = test_Run(test_Reader, threadCnt, TEST_LOOKUP_CNT, test_LatencyUs, &inFlight[run]);
+		printf("KV,fetch,%u,%.0f,%u\n", threadCnt, rate[run], inFlight[run]);
+		TEST_CHECK(rate[run] > 0.0);
+	}
+	/* The lookups of the 4 threads overlap and the throughput scales. */
+	TEST_CHECK(inFlight[2] > 1u);
+	TEST_CHECK(rate[2] >= TEST_SCALE_MIN * rate[0]);
+
+	/* Raw lookup rate, for information (bound by the host cores). */
+	for (threadCnt = 1u; threadCnt <= TEST_THREAD_MAX; threadCnt *= 2u)
+	{
+		rate[0] = test_Run(test_Reader, threadCnt, TEST_FAST_LOOKUP_CNT, 0u, NULL);
+		printf("KV,fetch_raw,%u,%.0f,-\n", threadCnt, rate[0]);
+		TEST_CHECK(rate[0] > 0.0);
+	}
+
+	/* Concurrent cursor walks see every record. */
+	rate[0] = test_Run(test_Walker, TEST_THREAD_MAX, TEST_REC_CNT, 0u, NULL);
+	printf("KV,cursor,%u,%.0f,-\n", TEST_THREAD_MAX, rate[0]);
+	TEST_CHECK(rate[0] > 0.0);
+
+	/* Lookups while a writer stores and commits new records. */
+	pthread_create(&writer, NULL, test_Writer, &writeErr);
+	rate[0] = test_Run(test_Reader, 2u, TEST_FAST_LOOKUP_CNT / 4u, 0u, NULL);
+	pthread_join(writer, NULL);
+	printf("KV,fetch_write,2,%.0f,-\n", rate[0]);
+	TEST_CHECK(writeErr == 0);
+	TEST_CHECK(rate[0] > 0.0);
+	for (i = 0u; i < TEST_REC_CNT + TEST_WRITE_CNT; i++)
+	{
+		TEST_CHECK(test_Fetch(i, 0) == 0);
+	}
+
+	TEST_CHECK(unqlite_close(test_Db) == UNQLITE_OK);
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,130 @@
+/***************************************************************************************************
+* @file
+* @brief     Regression test: first/last live record of a collection (db_last_live_record_id()).
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_live_id [database file]
+*            Records are dropped from the end of a collection spanning three chunks of the live
+*            records bitmap (4096 IDs each), and the last live ID is checked at every chunk and byte
+*            boundary, before and after the database is reopened (bitmap chunks read from disk).
+*            db_reset_record_cursor() positions the cursor on the first live record.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "unistd.h"	// unlink
+#include "unqlite.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_RECORD_CNT					9000
+#define TEST_NONE						-2		// $res is FALSE
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static const char *test_Path;
+
+/***************************************************************************************************
+* @brief Run a Jx9 script with $a and $b set, and return the integer value of its $res variable
+*        (TEST_NONE if FALSE, -1 on error).
+***************************************************************************************************/
+static long test_Jx9(unqlite *pDb, const char *script, long a, long b)
+{
+	unqlite_value *pValue;
+	unqlite_vm *pVm;
+	long res = -1;
+
+	if (unqlite_compile(pDb, script, -1, &pVm) != UNQLITE_OK)
+	{
+		return -1;
+	}
+	pValue = unqlite_vm_new_scalar(pVm);
+	unqlite_value_int64(pValue, a);
+	unqlite_vm_config(pVm, UNQLITE_VM_CONFIG_CREATE_VAR, "a", pValue);
+	unqlite_value_int64(pValue, b);
+	unqlite_vm_config(pVm, UNQLITE_VM_CONFIG_CREATE_VAR, "b", pValue);
+	unqlite_vm_release_value(pVm, pValue);
+	if (unqlite_vm_exec(pVm) == UNQLITE_OK)
+	{
+		pValue = unqlite_vm_extract_variable(pVm, "res");
+		if (pValue && unqlite_value_is_bool(pValue) && !unqlite_value_to_bool(pValue))
+		{
+			res = TEST_NONE;
+		}
+		else if (pValue)
+		{
+			res = (long)unqlite_value_to_int64(pValue);
+		}
+	}
+	unqlite_vm_release(pVm);
+	return res;
+}
+/***************************************************************************************************
+* @brief Drop the records [a, b) and return the last live ID.
+***************************************************************************************************/
+static long test_Drop(unqlite *pDb, long a, long b)
+{
+	return test_Jx9(pDb, "for($i = $a; $i < $b; $i++){ db_drop_record('col', $i); }"
+						 "$res = db_last_live_record_id('col');", a, b);
+}
+/***************************************************************************************************
+* @brief Reopen the database and return the last live ID.
+***************************************************************************************************/
+static long test_Reopen(unqlite **ppDb)
+{
+	if (unqlite_close(*ppDb) != UNQLITE_OK || unqlite_open(ppDb, test_Path, UNQLITE_OPEN_CREATE) != UNQLITE_OK)
+	{
+		return -1;
+	}
+	return test_Jx9(*ppDb, "$res = db_last_live_record_id('col');", 0, 0);
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	unqlite *pDb;
+	char journal[256];
+
+	test_Path = (argc > 1) ? argv[1] : "live_id.db";
+	snprintf(journal, sizeof(journal), "%s_unqlite_journal", test_Path);
+	unlink(test_Path);
+	unlink(journal);
+	TEST_CHECK(unqlite_open(&pDb, test_Path, UNQLITE_OPEN_CREATE) == UNQLITE_OK);
+
+	TEST_CHECK(test_Jx9(pDb, "$res = db_last_live_record_id('none');", 0, 0) == TEST_NONE);
+	TEST_CHECK(test_Jx9(pDb, "db_create('col'); $res = db_last_live_record_id('col');", 0, 0) == TEST_NONE);
+	TEST_CHECK(test_Jx9(pDb, "for($i = 0; $i < $a; $i++){ db_store('col', {i: $i}); }"
+							 "$res = db_last_live_record_id('col');", TEST_RECORD_CNT, 0) == TEST_RECORD_CNT - 1);
+	TEST_CHECK(test_Reopen(&pDb) == TEST_RECORD_CNT - 1);
+
+	/* Down to the first ID of the third chunk, then across the chunk and byte boundaries */
+	TEST_CHECK(test_Drop(pDb, 8193, TEST_RECORD_CNT) == 8192);
+	TEST_CHECK(test_Drop(pDb, 8192, 8193) == 8191);
+	TEST_CHECK(test_Drop(pDb, 8184, 8192) == 8183);
+	TEST_CHECK(test_Reopen(&pDb) == 8183);
+	TEST_CHECK(test_Drop(pDb, 4096, 8184) == 4095);
+	TEST_CHECK(test_Drop(pDb, 1, 4095) == 4095);
+	TEST_CHECK(test_Drop(pDb, 4095, 4096) == 0);
+	TEST_CHECK(test_Reopen(&pDb) == 0);
+	TEST_CHECK(test_Jx9(pDb, "db_reset_record_cursor('col'); $res = db_current_record_id('col');", 0, 0) == 0);
+	TEST_CHECK(test_Drop(pDb, 0, 1) == TEST_NONE);
+
+	/* A record stored after the gap is the last live one, and the first one */
+	TEST_CHECK(test_Jx9(pDb, "db_store('col', {i: 0}); $res = db_last_live_record_id('col');", 0, 0) == TEST_RECORD_CNT);
+	TEST_CHECK(test_Jx9(pDb, "db_reset_record_cursor('col'); $res = db_current_record_id('col');", 0, 0) == TEST_RECORD_CNT);
+	TEST_CHECK(test_Jx9(pDb, "$res = db_last_record_id('col');", 0, 0) == TEST_RECORD_CNT);
+	TEST_CHECK(test_Reopen(&pDb) == TEST_RECORD_CNT);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	unlink(test_Path);
+	printf("PASS\n");
+	return 0;
+}
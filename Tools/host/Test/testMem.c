@@ -0,0 +1,204 @@
+/***************************************************************************************************
+* @file
+* @brief     Microbenchmark of the uC/LIB Mem_Copy(), Mem_Set() & Mem_Cmp() functions.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_mem [MB per measurement]
+*            512 B (a sector) and 4 KB (a database page) buffers are processed with aligned and
+*            misaligned source/destination addresses, and the throughput is printed next to the one
+*            of the C library function. The same program is built twice: test_mem with lib_mem.c as
+*            compiled for the storage stack, test_mem_vec with lib_mem.c compiled for vectorization.
+*            The results are checked against the C library first, on every size and offset up to
+*            the unrolled block size.
+*            Output: M,<build>,<function>,<size>,<src offset>/<dest offset>,<MB/s>,libc=<MB/s>
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "stdlib.h"	// atoi
+#include "string.h"	// memcpy, memset, memcmp
+#include "time.h"
+#include "lib_mem.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#ifndef TEST_MEM_BUILD
+#define TEST_MEM_BUILD					"c"
+#endif
+
+#define TEST_BUF_SIZE					(4096u + 64u)
+#define TEST_CHK_SIZE_MAX				300u	// sizes checked against the C library
+#define TEST_CHK_OFF_MAX				16u		// offsets checked against the C library
+#define TEST_MB							64u		// data processed per measurement
+
+/* Keeps the compiler from dropping or merging the repeated calls */
+#define TEST_BARRIER()					__asm__ __volatile__("" ::: "memory")
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+typedef enum
+{
+	TEST_FN_COPY,
+	TEST_FN_SET,
+	TEST_FN_CMP
+} TEST_FN;
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static CPU_INT08U test_Src[TEST_BUF_SIZE] __attribute__((aligned(64)));
+static CPU_INT08U test_Dst[TEST_BUF_SIZE] __attribute__((aligned(64)));
+static CPU_INT08U test_Ref[TEST_BUF_SIZE] __attribute__((aligned(64)));
+static unsigned test_Mb = TEST_MB;
+static volatile unsigned test_Sink;
+
+/***************************************************************************************************
+* @brief Fill a buffer with a pattern that differs for every octet of a word.
+***************************************************************************************************/
+static void test_Fill(CPU_INT08U *p, CPU_SIZE_T size, unsigned seed)
+{
+	CPU_SIZE_T i;
+
+	for (i = 0u; i < size; i++)
+	{
+		p[i] = (CPU_INT08U)((i * 13u) + (i >> 8) + seed);
+	}
+}
+/***************************************************************************************************
+* @brief Check the three functions against the C library on every size and offset combination.
+***************************************************************************************************/
+static int test_Check(void)
+{
+	CPU_SIZE_T size;
+	unsigned src;
+	unsigned dst;
+
+	for (size = 0u; size <= TEST_CHK_SIZE_MAX; size++)
+	{
+		for (src = 0u; src < TEST_CHK_OFF_MAX; src++)
+		{
+			for (dst = 0u; dst < TEST_CHK_OFF_MAX; dst++)
+			{
+				test_Fill(test_Src, TEST_BUF_SIZE, (unsigned)size + src);
+				test_Fill(test_Dst, TEST_BUF_SIZE, 0x55u);
+				memcpy(test_Ref, test_Dst, TEST_BUF_SIZE);
+				Mem_Copy(&test_Dst[dst], &test_Src[src], size);
+				memcpy(&test_Ref[dst], &test_Src[src], size);
+				TEST_CHECK(memcmp(test_Dst, test_Ref, TEST_BUF_SIZE) == 0);
+
+				TEST_CHECK(Mem_Cmp(&test_Dst[dst], &test_Src[src], size) == DEF_YES);
+				if (size > 0u)
+				{
+					test_Dst[dst + (size * 7u + src) % size] ^= 0x10u;
+					TEST_CHECK(Mem_Cmp(&test_Dst[dst], &test_Src[src], size) == DEF_NO);
+				}
+			}
+			Mem_Set(&test_Dst[src], (CPU_INT08U)size, size);
+			memset(&test_Ref[src], (int)(CPU_INT08U)size, size);
+			TEST_CHECK(memcmp(&test_Dst[src], &test_Ref[src], size) == 0);
+		}
+	}
+	/* Overlapping copy to a lower address (see 'lib_mem.c  Mem_Copy()  Note #2b') */
+	for (src = 1u; src < TEST_CHK_OFF_MAX * 4u; src++)
+	{
+		test_Fill(test_Dst, TEST_BUF_SIZE, src);
+		memmove(test_Ref, &test_Dst[src], 4096u);
+		Mem_Copy(test_Dst, &test_Dst[src], 4096u);
+		TEST_CHECK(memcmp(test_Dst, test_Ref, 4096u) == 0);
+	}
+	return 0;
+}
+/***************************************************************************************************
+* @brief Time one function on one size and offset combination.
+* @param libc DEF_YES to time the C library function instead.
+* @return Throughput in MB/s.
+***************************************************************************************************/
+static double test_Run(TEST_FN fn, CPU_BOOLEAN libc, CPU_SIZE_T size, unsigned src, unsigned dst)
+{
+	CPU_INT08U *pSrc = &test_Src[src];
+	CPU_INT08U *pDst = &test_Dst[dst];
+	unsigned long loops = (unsigned long)test_Mb * 1024u * 1024u / size;
+	unsigned long i;
+	unsigned eq = 0u;
+	struct timespec t0;
+	struct timespec t1;
+	double sec;
+
+	memcpy(pDst, pSrc, size);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0u; i < loops; i++)
+	{
+		switch (fn)
+		{
+		case TEST_FN_COPY:
+			if (libc)
+				memcpy(pDst, pSrc, size);
+			else
+				Mem_Copy(pDst, pSrc, size);
+			break;
+		case TEST_FN_SET:
+			if (libc)
+				memset(pDst, (int)(i & 0xFFu), size);
+			else
+				Mem_Set(pDst, (CPU_INT08U)i, size);
+			break;
+		case TEST_FN_CMP:
+			if (libc)
+				eq += (memcmp(pDst, pSrc, size) == 0);
+			else
+				eq += (Mem_Cmp(pDst, pSrc, size) == DEF_YES);
+			break;
+		}
+		TEST_BARRIER();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	test_Sink = eq;
+
+	sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+	return (double)loops * (double)size / (1024.0 * 1024.0) / sec;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	static const char *name[] = { "copy", "set", "cmp" };
+	static const CPU_SIZE_T size[] = { 512u, 4096u };
+	/* Source/destination offsets: aligned, misaligned source, misaligned destination, both */
+	static const unsigned off[][2] = { { 0u, 0u }, { 1u, 0u }, { 0u, 3u }, { 1u, 3u } };
+	unsigned fn;
+	unsigned s;
+	unsigned o;
+
+	if (argc > 1)
+	{
+		test_Mb = (unsigned)atoi(argv[1]);
+	}
+	TEST_CHECK(test_Check() == 0);
+
+	test_Fill(test_Src, TEST_BUF_SIZE, 0u);
+	for (fn = TEST_FN_COPY; fn <= TEST_FN_CMP; fn++)
+	{
+		for (s = 0u; s < sizeof(size) / sizeof(size[0]); s++)
+		{
+			for (o = 0u; o < sizeof(off) / sizeof(off[0]); o++)
+			{
+				/* Mem_Set() has no source */
+				if ((fn == TEST_FN_SET) && (off[o][0] != 0u))
+					continue;
+				printf("M,%s,%s,%lu,%u/%u,%.0f,libc=%.0f\n", TEST_MEM_BUILD, name[fn], (unsigned long)size[s],
+					   off[o][0], off[o][1], test_Run((TEST_FN)fn, DEF_NO, size[s], off[o][0], off[o][1]),
+					   test_Run((TEST_FN)fn, DEF_YES, size[s], off[o][0], off[o][1]));
+			}
+		}
+	}
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,112 @@
+/***************************************************************************************************
+* @file
+* @brief     Regression test: Jx9 array walks reentering the walked array.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_packed_walk
+*            JSON arrays are packed lists whose entries are handed out through a view node. A walk
+*            (JSON encoding, array_map(), array_walk()) must keep its position when the array it
+*            walks is accessed in between, by a callback or by the walk itself (an array holding
+*            itself).
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "string.h"	// memcpy, strcmp, strcat
+#include "unqlite.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_OUT_SIZE					1024u
+#define TEST_NEST_MAX					32		// JSON encoder nesting limit
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static char test_Out[TEST_OUT_SIZE];
+static unsigned int test_OutLen;
+
+/***************************************************************************************************
+* @brief VM output consumer: append to test_Out.
+***************************************************************************************************/
+static int test_Consumer(const void *pOut, unsigned int nLen, void *pUserData)
+{
+	(void)pUserData;
+	if (test_OutLen + nLen >= sizeof(test_Out))
+	{
+		return UNQLITE_ABORT;
+	}
+	memcpy(&test_Out[test_OutLen], pOut, nLen);
+	test_OutLen += nLen;
+	test_Out[test_OutLen] = '\0';
+	return UNQLITE_OK;
+}
+/***************************************************************************************************
+* @brief Run a Jx9 script and compare its output with 'expected'.
+* @return 0 on success.
+***************************************************************************************************/
+static int test_Jx9(unqlite *pDb, const char *script, const char *expected)
+{
+	unqlite_vm *pVm;
+	int rc;
+
+	test_OutLen = 0u;
+	test_Out[0] = '\0';
+	TEST_CHECK(unqlite_compile(pDb, script, -1, &pVm) == UNQLITE_OK);
+	TEST_CHECK(unqlite_vm_config(pVm, UNQLITE_VM_CONFIG_OUTPUT, test_Consumer, 0) == UNQLITE_OK);
+	rc = unqlite_vm_exec(pVm);
+	unqlite_vm_release(pVm);
+	TEST_CHECK(rc == UNQLITE_OK);
+	if (strcmp(test_Out, expected) != 0)
+	{
+		printf("script:   %s\noutput:   %s\nexpected: %s\n", script, test_Out, expected);
+		return 1;
+	}
+	return 0;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(void)
+{
+	static char nested[TEST_OUT_SIZE];
+	unqlite *pDb;
+	int i;
+
+	TEST_CHECK(unqlite_open(&pDb, ":mem:", UNQLITE_OPEN_CREATE) == UNQLITE_OK);
+
+	/* An array holding itself: the encoder walks the same array at every level */
+	for (i = 0; i < TEST_NEST_MAX; i++)
+	{
+		strcat(nested, "[1,2,");
+	}
+	strcat(nested, "[]");
+	for (i = 0; i < TEST_NEST_MAX; i++)
+	{
+		strcat(nested, ",9]");
+	}
+	TEST_CHECK(test_Jx9(pDb, "$a = [1, 2]; $a[] = $a; $a[] = 9; print $a;", nested) == 0);
+
+	/* Callbacks reading the walked array */
+	TEST_CHECK(test_Jx9(pDb, "$a = [1, 2, 3, 4];"
+							 "$f = function($x){ uplink $a; $y = $a[0]; return $x * 10 + 1; };"
+							 "print array_map($f, $a);", "[11,21,31,41]") == 0);
+	TEST_CHECK(test_Jx9(pDb, "$a = [1, 2, 3, 4, 5];"
+							 "$g = function($v, $k){ uplink $a; $y = $a[3]; print \"$k=$v,\"; };"
+							 "array_walk($a, $g);", "0=1,1=2,2=3,3=4,4=5,") == 0);
+
+	/* A callback turning the walked array into a regular hashmap */
+	TEST_CHECK(test_Jx9(pDb, "$a = [1, 2, 3];"
+							 "$g = function($v, $k){ uplink $a; if( $k == 0 ){ $a['x'] = 7; } print \"$k=$v,\"; };"
+							 "array_walk($a, $g);", "0=1,1=2,2=3,x=7,") == 0);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,282 @@
+/***************************************************************************************************
+* @file
+* @brief     Scaling test: concurrent reads of different files on the same uC/FS volume.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_rd_scale [read latency in us]
+*            Two RAM disks are opened through a driver that adds a fixed latency to each sector
+*            read, like a flash or SD access. The first one lets reads share the volume lock
+*            (FS_DEV_IO_CTRL_RD_SHARED), the second one does not. 1, 2 and 4 threads then read
+*            their own file: the read throughput must scale with the threads on the first disk
+*            and the second one must keep the reads serialized.
+*            Output: RD,<dev>,<threads>,<MB/s>,<max reads in flight>
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "stdlib.h"	// atoi
+#include "pthread.h"
+#include "time.h"
+#include "unistd.h"	// usleep
+#include "lib_mem.h"
+#include "fs.h"
+#include "fs_dev.h"
+#include "fs_file.h"
+#include "fs_vol.h"
+#include "fs_dev_ramdisk.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_DEV_CNT					2u
+#define TEST_FILE_CNT					4u
+#define TEST_FILE_SIZE					(128u * 1024u)
+#define TEST_CHUNK_SIZE					(8u * 1024u)
+#define TEST_SEC_SIZE					512u
+#define TEST_DISK_SEC_CNT				(4u * 1024u * 1024u / TEST_SEC_SIZE)
+#define TEST_LATENCY_US					200
+#define TEST_SCALE_MIN					1.5		// 4 threads vs 1 on the shared disk
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+typedef struct
+{
+	const char *dev;		// volume name
+	unsigned file;			// file read by the thread
+	int err;				// 0 if the whole file was read back
+} TEST_READER;
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static CPU_INT32U test_Disk[TEST_DEV_CNT][TEST_DISK_SEC_CNT * TEST_SEC_SIZE / 4];
+static FS_DEV_API test_LatDrv;
+static unsigned test_LatencyUs = TEST_LATENCY_US;
+
+static pthread_mutex_t test_InFlightLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned test_InFlight;
+static unsigned test_InFlightMax;
+
+static FS_CFG test_FsCfg =
+{
+	TEST_DEV_CNT,					/* DevCnt           */
+	TEST_DEV_CNT,					/* VolCnt           */
+	TEST_FILE_CNT + 1u,				/* FileCnt          */
+	1u,								/* DirCnt           */
+	4u * TEST_DEV_CNT + TEST_FILE_CNT,	/* BufCnt           */
+	1u,								/* DevDrvCnt        */
+	TEST_SEC_SIZE					/* MaxSecSize       */
+};
+
+/***************************************************************************************************
+* @brief Driver name of the latency RAM disk.
+***************************************************************************************************/
+static const CPU_CHAR *test_LatNameGet(void)
+{
+	return "lat";
+}
+/***************************************************************************************************
+* @brief Read sectors of the RAM disk after the device latency; tracks the reads in flight.
+***************************************************************************************************/
+static void test_LatRd(FS_DEV *p_dev, void *p_dest, FS_SEC_NBR start, FS_SEC_QTY cnt, FS_ERR *p_err)
+{
+	pthread_mutex_lock(&test_InFlightLock);
+	if (++test_InFlight > test_InFlightMax)
+	{
+		test_InFlightMax = test_InFlight;
+	}
+	pthread_mutex_unlock(&test_InFlightLock);
+
+	usleep(test_LatencyUs);
+	FSDev_RAM.Rd(p_dev, p_dest, start, cnt, p_err);
+
+	pthread_mutex_lock(&test_InFlightLock);
+	test_InFlight--;
+	pthread_mutex_unlock(&test_InFlightLock);
+}
+/***************************************************************************************************
+* @brief I/O control of the RAM disk; unit 1 does not let reads share the volume lock.
+***************************************************************************************************/
+static void test_LatIO_Ctrl(FS_DEV *p_dev, CPU_INT08U opt, void *p_data, FS_ERR *p_err)
+{
+	if ((opt == FS_DEV_IO_CTRL_RD_SHARED) && (p_dev->UnitNbr != 0u))
+	{
+		*p_err = FS_ERR_DEV_INVALID_IO_CTRL;
+		return;
+	}
+	FSDev_RAM.IO_Ctrl(p_dev, opt, p_data, p_err);
+}
+/***************************************************************************************************
+* @brief Test pattern: octet at offset 'pos' of file 'file'.
+***************************************************************************************************/
+static CPU_INT08U test_Pattern(unsigned file, CPU_SIZE_T pos)
+{
+	return (CPU_INT08U)((pos >> 9) + (pos * 7u) + (file * 31u));
+}
+/***************************************************************************************************
+* @brief Open & format a latency RAM disk volume, then write the test files.
+***************************************************************************************************/
+static int test_VolCreate(unsigned unit)
+{
+	static CPU_INT08U buf[TEST_CHUNK_SIZE];
+	FS_DEV_RAM_CFG ramCfg;
+	FS_FILE *pFile;
+	FS_ERR err;
+	CPU_CHAR name[16];
+	CPU_CHAR path[32];
+	CPU_SIZE_T pos;
+	unsigned file;
+	unsigned i;
+
+	snprintf(name, sizeof(name), "lat:%u:", unit);
+	ramCfg.SecSize = TEST_SEC_SIZE;
+	ramCfg.Size = TEST_DISK_SEC_CNT;
+	ramCfg.DiskPtr = &test_Disk[unit][0];
+	FSDev_Open(name, &ramCfg, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+	FSVol_Open(name, name, 0u, &err);
+	TEST_CHECK((err == FS_ERR_NONE) || (err == FS_ERR_PARTITION_NOT_FOUND));
+	FSVol_Fmt(name, (void *)0, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+
+	for (file = 0u; file < TEST_FILE_CNT; file++)
+	{
+		snprintf(path, sizeof(path), "%s\\f%u.bin", name, file);
+		pFile = FSFile_Open(path, FS_FILE_ACCESS_MODE_WR | FS_FILE_ACCESS_MODE_CREATE | FS_FILE_ACCESS_MODE_TRUNCATE, &err);
+		TEST_CHECK(err == FS_ERR_NONE);
+		for (pos = 0u; pos < TEST_FILE_SIZE; pos += TEST_CHUNK_SIZE)
+		{
+			for (i = 0u; i < TEST_CHUNK_SIZE; i++)
+			{
+				buf[i] = test_Pattern(file, pos + i);
+			}
+			TEST_CHECK(FSFile_Wr(pFile, buf, TEST_CHUNK_SIZE, &err) == TEST_CHUNK_SIZE);
+		}
+		FSFile_Close(pFile, &err);
+		TEST_CHECK(err == FS_ERR_NONE);
+	}
+	return 0;
+}
+/***************************************************************************************************
+* @brief Reader thread: read its file back in chunks and check the content.
+***************************************************************************************************/
+static void *test_Reader(void *pArg)
+{
+	TEST_READER *pRd = (TEST_READER *)pArg;
+	CPU_INT08U buf[TEST_CHUNK_SIZE];
+	FS_FILE *pFile;
+	FS_ERR err;
+	CPU_CHAR path[32];
+	CPU_SIZE_T pos;
+	CPU_SIZE_T i;
+
+	pRd->err = 1;
+	snprintf(path, sizeof(path), "%s\\f%u.bin", pRd->dev, pRd->file);
+	pFile = FSFile_Open(path, FS_FILE_ACCESS_MODE_RD, &err);
+	if (err != FS_ERR_NONE)
+	{
+		return NULL;
+	}
+	for (pos = 0u; pos < TEST_FILE_SIZE; pos += TEST_CHUNK_SIZE)
+	{
+		if (FSFile_Rd(pFile, buf, TEST_CHUNK_SIZE, &err) != TEST_CHUNK_SIZE)
+		{
+			break;
+		}
+		for (i = 0u; (i < TEST_CHUNK_SIZE) && (buf[i] == test_Pattern(pRd->file, pos + i)); i++)
+		{
+		}
+		if (i != TEST_CHUNK_SIZE)
+		{
+			break;
+		}
+	}
+	FSFile_Close(pFile, &err);
+	pRd->err = (pos != TEST_FILE_SIZE) || (err != FS_ERR_NONE);
+	return NULL;
+}
+/***************************************************************************************************
+* @brief Read one file per thread on a volume.
+* @return Read throughput in MB/s, negative on error.
+***************************************************************************************************/
+static double test_ReadRun(const char *dev, unsigned threadCnt, unsigned *pInFlightMax)
+{
+	pthread_t thread[TEST_FILE_CNT];
+	TEST_READER rd[TEST_FILE_CNT];
+	struct timespec t0;
+	struct timespec t1;
+	double sec;
+	unsigned i;
+	int err = 0;
+
+	test_InFlightMax = 0u;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0u; i < threadCnt; i++)
+	{
+		rd[i].dev = dev;
+		rd[i].file = i;
+		pthread_create(&thread[i], NULL, test_Reader, &rd[i]);
+	}
+	for (i = 0u; i < threadCnt; i++)
+	{
+		pthread_join(thread[i], NULL);
+		err |= rd[i].err;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	*pInFlightMax = test_InFlightMax;
+	sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+	return err ? -1.0 : (double)threadCnt * TEST_FILE_SIZE / (1024.0 * 1024.0) / sec;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	static const char *dev[TEST_DEV_CNT] = { "lat:0:", "lat:1:" };
+	double mbps[TEST_DEV_CNT][3];
+	unsigned inFlight[TEST_DEV_CNT][3];
+	unsigned threadCnt;
+	unsigned unit;
+	unsigned run;
+	FS_ERR err;
+
+	if (argc > 1)
+	{
+		test_LatencyUs = (unsigned)atoi(argv[1]);
+	}
+	Mem_Init();
+	TEST_CHECK(FS_Init(&test_FsCfg) == FS_ERR_NONE);
+	test_LatDrv = FSDev_RAM;
+	test_LatDrv.NameGet = test_LatNameGet;
+	test_LatDrv.Rd = test_LatRd;
+	test_LatDrv.IO_Ctrl = test_LatIO_Ctrl;
+	FS_DevDrvAdd(&test_LatDrv, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+
+	for (unit = 0u; unit < TEST_DEV_CNT; unit++)
+	{
+		TEST_CHECK(test_VolCreate(unit) == 0);
+		for (run = 0u, threadCnt = 1u; threadCnt <= TEST_FILE_CNT; run++, threadCnt *= 2u)
+		{
+			mbps[unit][run] = test_ReadRun(dev[unit], threadCnt, &inFlight[unit][run]);
+			printf("RD,%s,%u,%.2f,%u\n", dev[unit], threadCnt, mbps[unit][run], inFlight[unit][run]);
+			TEST_CHECK(mbps[unit][run] > 0.0);
+		}
+	}
+
+	/* Shared disk: the reads of the 4 threads overlap and the throughput scales. */
+	TEST_CHECK(inFlight[0][2] > 1u);
+	TEST_CHECK(mbps[0][2] >= TEST_SCALE_MIN * mbps[0][0]);
+	/* Exclusive disk: the volume lock keeps serializing the reads. */
+	TEST_CHECK(inFlight[1][2] == 1u);
+
+	printf("PASS\n");
+	return 0;
+}
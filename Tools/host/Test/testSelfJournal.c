@@ -0,0 +1,119 @@
+/***************************************************************************************************
+* @file
+* @brief     Regression test: directory entry of a self-journaled file on sync.
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_self_journal <backing file> write|check
+*            FSFile_Sync() skips the directory entry of a self-journaled file whose size and first
+*            cluster did not change since the entry was written. "write" truncates such a file to
+*            zero, gives its clusters to another file and regrows it to its former size, syncs it and
+*            exits without closing anything (power cut). "check" mounts the volume again and reads
+*            the file back.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdio.h"	// printf
+#include "string.h"	// strcmp, memset, memcmp
+#include "lib_mem.h"
+#include "fs_app.h"
+#include "fs_file.h"
+#include "Dev/NOR/BSP/bsp_fs_dev_nor_sim.h"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_FILE						"sj.bin"
+#define TEST_OTHER						"sj_other.bin"
+#define TEST_SIZE						8192u
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static CPU_INT08U test_Buf[TEST_SIZE];
+static CPU_INT08U test_Rd[TEST_SIZE];
+
+/***************************************************************************************************
+* @brief Write TEST_SIZE octets of 'fill' at the current position.
+***************************************************************************************************/
+static int test_Wr(FS_FILE *p_file, CPU_INT08U fill)
+{
+	FS_ERR err;
+
+	memset(test_Buf, fill, sizeof(test_Buf));
+	TEST_CHECK(FSFile_Wr(p_file, test_Buf, sizeof(test_Buf), &err) == sizeof(test_Buf));
+	TEST_CHECK(err == FS_ERR_NONE);
+	return 0;
+}
+/***************************************************************************************************
+* @brief Truncate, reuse the clusters and regrow the file, then stop without closing.
+***************************************************************************************************/
+static int test_Write(void)
+{
+	FS_FILE *p_file;
+	FS_FILE *p_other;
+	FS_ERR err;
+
+	p_file = FSFile_Open(TEST_FILE, FS_FILE_ACCESS_MODE_WR | FS_FILE_ACCESS_MODE_CREATE | FS_FILE_ACCESS_MODE_TRUNCATE |
+								FS_FILE_ACCESS_MODE_CACHED | FS_FILE_ACCESS_MODE_SELF_JOURNAL, &err);
+	TEST_CHECK(p_file != 0);
+	TEST_CHECK(test_Wr(p_file, 'a') == 0);
+	FSFile_Sync(p_file, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+
+	FSFile_Truncate(p_file, 0u, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+	p_other = FSFile_Open(TEST_OTHER, FS_FILE_ACCESS_MODE_WR | FS_FILE_ACCESS_MODE_CREATE | FS_FILE_ACCESS_MODE_TRUNCATE, &err);
+	TEST_CHECK(p_other != 0);
+	TEST_CHECK(test_Wr(p_other, 'x') == 0);
+	FSFile_Close(p_other, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+
+	FSFile_PosSet(p_file, 0, FS_FILE_ORIGIN_START, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+	TEST_CHECK(test_Wr(p_file, 'b') == 0);
+	FSFile_Sync(p_file, &err);
+	TEST_CHECK(err == FS_ERR_NONE);
+	return 0;
+}
+/***************************************************************************************************
+* @brief Read the file back after the power cut.
+***************************************************************************************************/
+static int test_Check(void)
+{
+	FS_FILE *p_file;
+	FS_ERR err;
+
+	p_file = FSFile_Open(TEST_FILE, FS_FILE_ACCESS_MODE_RD, &err);
+	TEST_CHECK(p_file != 0);
+	TEST_CHECK(FSFile_Rd(p_file, test_Rd, sizeof(test_Rd), &err) == sizeof(test_Rd));
+	memset(test_Buf, 'b', sizeof(test_Buf));
+	TEST_CHECK(memcmp(test_Rd, test_Buf, sizeof(test_Buf)) == 0);
+	FSFile_Close(p_file, &err);
+	return 0;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	TEST_CHECK(argc > 2);
+	FSDev_NOR_SimFileSet(argv[1]);
+	Mem_Init();
+	TEST_CHECK(App_FS_Init() == DEF_OK);
+
+	if (strcmp(argv[2], "write") == 0)
+	{
+		TEST_CHECK(test_Write() == 0);
+	}
+	else
+	{
+		TEST_CHECK(test_Check() == 0);
+	}
+	printf("PASS\n");
+	return 0;
+}
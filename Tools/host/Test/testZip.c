@@ -0,0 +1,249 @@
+/***************************************************************************************************
+* @file
+* @brief     Round-trip test of the overflow payload codec (UNQLITE_KV_CONFIG_COMPRESS).
+* @details   Tab == 4 spaces (use Tab char instead of spaces).
+*            usage: test_zip [database file]
+*            The codec functions are static, so the amalgamation is built into this test.
+*            lhZipCompress() output is decompressed by lhZipDecompress() and compared with the input
+*            for payloads hitting the format limits (literal runs, reference lengths and distances),
+*            incompressible data must be rejected and truncated or mis-sized streams must be
+*            reported as corrupt. Then compressed records are stored, appended to, read back by a
+*            handle that does not compress, and the UNQLITE_KV_CONFIG_COMPRESS_STATS are checked.
+* @date      10/2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Includes
+***************************************************************************************************/
+#include "stdint.h"	// see the unqlite.c properties in CMakeLists.txt
+#include "stdio.h"	// printf
+#include "string.h"	// memcmp
+#include "unistd.h"	// unlink
+#include "unqlite.c"
+
+/***************************************************************************************************
+* Defines
+***************************************************************************************************/
+#define TEST_MAX_SIZE					70000u
+#define TEST_RECORD_CNT					64u
+#define TEST_RECORD_SIZE				8192u
+#define TEST_APPEND_SIZE				3000u
+
+#define TEST_CHECK(COND)				do { if (!(COND)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #COND); return 1; } } while (0)
+
+/***************************************************************************************************
+* Types
+***************************************************************************************************/
+typedef enum
+{
+	TEST_DATA_ZERO,			// one long run
+	TEST_DATA_TEXT,			// short repeated words
+	TEST_DATA_FAR,			// random marker repeated around the farthest reference distance
+	TEST_DATA_RANDOM,		// incompressible
+	TEST_DATA_CNT
+} TEST_DATA;
+
+/***************************************************************************************************
+* Vars
+***************************************************************************************************/
+static unsigned char test_In[TEST_MAX_SIZE];
+static unsigned char test_Zip[TEST_MAX_SIZE];
+static unsigned char test_Out[TEST_MAX_SIZE + 1];
+static sxu32 test_Hash[1 << L_HASH_ZIP_HASH_BITS];
+static unsigned int test_Rand = 0x2545F491u;
+
+/***************************************************************************************************
+* @brief Deterministic pseudo random generator (xorshift32).
+***************************************************************************************************/
+static unsigned int test_Next(void)
+{
+	test_Rand ^= test_Rand << 13;
+	test_Rand ^= test_Rand >> 17;
+	test_Rand ^= test_Rand << 5;
+	return test_Rand;
+}
+/***************************************************************************************************
+* @brief Fill 'size' octets of 'p' with the given kind of data.
+***************************************************************************************************/
+static void test_Fill(unsigned char *p, unsigned size, TEST_DATA kind, unsigned seed)
+{
+	static const char *word[] = { "sensor", "temp=", "21.5", ";", "humidity=", "48", "\n", "ok" };
+	unsigned period;
+	unsigned i;
+
+	switch (kind)
+	{
+	case TEST_DATA_ZERO:
+		memset(p, 0, size);
+		break;
+	case TEST_DATA_TEXT:
+		for (i = 0u; i < size; )
+		{
+			const char *w = word[(test_Next() + seed) % (sizeof(word) / sizeof(word[0]))];
+
+			while (*w && i < size)
+			{
+				p[i++] = (unsigned char)*w++;
+			}
+		}
+		break;
+	case TEST_DATA_FAR:
+		/* Period one below, at and above the farthest reference distance. The rest of the block
+		 * is zeroed so that the match finder still holds the marker one period later. */
+		period = L_HASH_ZIP_MAX_OFF - 1u + seed % 3u;
+		for (i = 0u; i < size; i++)
+		{
+			if (i >= period)
+				p[i] = p[i - period];
+			else
+				p[i] = (i < 64u) ? (unsigned char)test_Next() : 0u;
+		}
+		break;
+	default:
+		for (i = 0u; i < size; i++)
+		{
+			p[i] = (unsigned char)test_Next();
+		}
+		break;
+	}
+}
+/***************************************************************************************************
+* @brief Compress 'size' octets of test_In and check the round trip.
+* @return 0 on success.
+***************************************************************************************************/
+static int test_RoundTrip(unsigned size, TEST_DATA kind, unsigned seed)
+{
+	sxu32 nMax = size - (size >> 3);
+	sxu32 nZip;
+
+	test_Fill(test_In, size, kind, seed);
+	nZip = lhZipCompress(test_Hash, test_In, size, test_Zip, nMax);
+	if (kind == TEST_DATA_RANDOM)
+	{
+		/* Does not save an eighth */
+		TEST_CHECK(nZip == 0u);
+		return 0;
+	}
+	TEST_CHECK(nZip > 0u && nZip <= nMax);
+	memset(test_Out, 0xA5, size + 1u);
+	TEST_CHECK(lhZipDecompress(test_Zip, nZip, test_Out, size) == UNQLITE_OK);
+	TEST_CHECK(memcmp(test_In, test_Out, size) == 0);
+	TEST_CHECK(test_Out[size] == 0xA5);
+
+	/* Truncated stream, output one octet too short or too long */
+	TEST_CHECK(lhZipDecompress(test_Zip, nZip - 1u, test_Out, size) == UNQLITE_CORRUPT);
+	TEST_CHECK(lhZipDecompress(test_Zip, nZip, test_Out, size - 1u) == UNQLITE_CORRUPT);
+	TEST_CHECK(lhZipDecompress(test_Zip, nZip, test_Out, size + 1u) == UNQLITE_CORRUPT);
+	return 0;
+}
+/***************************************************************************************************
+* @brief Check the codec on every kind of data and on the sizes around its limits.
+***************************************************************************************************/
+static int test_Codec(void)
+{
+	static const unsigned size[] =
+	{
+		L_HASH_ZIP_MIN_DATA, L_HASH_ZIP_MIN_DATA + 1u, 100u, L_HASH_ZIP_MAX_REF - 1u, L_HASH_ZIP_MAX_REF,
+		L_HASH_ZIP_MAX_REF + 1u, 1000u, 4096u, L_HASH_ZIP_MAX_OFF + 100u, 3u * L_HASH_ZIP_MAX_OFF, TEST_MAX_SIZE
+	};
+	unsigned kind;
+	unsigned s;
+	unsigned seed;
+
+	for (kind = 0u; kind < TEST_DATA_CNT; kind++)
+	{
+		for (s = 0u; s < sizeof(size) / sizeof(size[0]); s++)
+		{
+			for (seed = 0u; seed < 3u; seed++)
+			{
+				if (kind == TEST_DATA_FAR && size[s] <= L_HASH_ZIP_MAX_OFF + 1u)
+					continue;
+				TEST_CHECK(test_RoundTrip(size[s], (TEST_DATA)kind, seed) == 0);
+			}
+		}
+	}
+	/* Output limit: literal runs and references must not be written past nOut */
+	test_Fill(test_In, 4096u, TEST_DATA_TEXT, 0u);
+	TEST_CHECK(lhZipCompress(test_Hash, test_In, 4096u, test_Zip, 4096u) > 0u);
+	for (s = 1u; s < 64u; s++)
+	{
+		memset(test_Zip, 0x5A, sizeof(test_Zip));
+		TEST_CHECK(lhZipCompress(test_Hash, test_In, 4096u, test_Zip, s) == 0u);
+		TEST_CHECK(test_Zip[s] == 0x5A);
+	}
+	return 0;
+}
+/***************************************************************************************************
+* @brief Fill the value of record 'i' (compressible for even records, not for odd ones).
+***************************************************************************************************/
+static void test_Value(unsigned char *p, unsigned size, unsigned i)
+{
+	test_Rand = 0x2545F491u + i;
+	test_Fill(p, size, (i & 1u) ? TEST_DATA_RANDOM : TEST_DATA_TEXT, i);
+}
+/***************************************************************************************************
+* @brief Store compressed records, append to them and read them back from a handle that does not
+*        compress.
+***************************************************************************************************/
+static int test_Kv(const char *path)
+{
+	unqlite_int64 nIn;
+	unqlite_int64 nOut;
+	unqlite_int64 nBytes;
+	unqlite *pDb;
+	char key[16];
+	char journal[256];
+	unsigned i;
+	int keyLen;
+
+	snprintf(journal, sizeof(journal), "%s_unqlite_journal", path);
+	unlink(path);
+	unlink(journal);
+	TEST_CHECK(unqlite_open(&pDb, path, UNQLITE_OPEN_CREATE) == UNQLITE_OK);
+	TEST_CHECK(unqlite_kv_config(pDb, UNQLITE_KV_CONFIG_COMPRESS, 1) == UNQLITE_OK);
+	for (i = 0u; i < TEST_RECORD_CNT; i++)
+	{
+		keyLen = snprintf(key, sizeof(key), "r%u", i);
+		test_Value(test_In, TEST_RECORD_SIZE, i);
+		TEST_CHECK(unqlite_kv_store(pDb, key, keyLen, test_In, TEST_RECORD_SIZE) == UNQLITE_OK);
+		if ((i % 4u) == 0u)
+		{
+			TEST_CHECK(unqlite_kv_append(pDb, key, keyLen, test_In, TEST_APPEND_SIZE) == UNQLITE_OK);
+		}
+	}
+	TEST_CHECK(unqlite_commit(pDb) == UNQLITE_OK);
+	TEST_CHECK(unqlite_kv_config(pDb, UNQLITE_KV_CONFIG_COMPRESS_STATS, &nIn, &nOut) == UNQLITE_OK);
+	printf("Z,in=%lld,out=%lld\n", (long long)nIn, (long long)nOut);
+	TEST_CHECK(nIn >= (unqlite_int64)TEST_RECORD_CNT * TEST_RECORD_SIZE);
+	/* Half of the records are incompressible and stored as is */
+	TEST_CHECK(nOut < nIn - nIn / 4);
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+
+	TEST_CHECK(unqlite_open(&pDb, path, UNQLITE_OPEN_READONLY) == UNQLITE_OK);
+	for (i = 0u; i < TEST_RECORD_CNT; i++)
+	{
+		unsigned size = TEST_RECORD_SIZE + (((i % 4u) == 0u) ? TEST_APPEND_SIZE : 0u);
+
+		keyLen = snprintf(key, sizeof(key), "r%u", i);
+		test_Value(test_In, TEST_RECORD_SIZE, i);
+		memcpy(&test_In[TEST_RECORD_SIZE], test_In, TEST_APPEND_SIZE);
+		nBytes = sizeof(test_Out);
+		TEST_CHECK(unqlite_kv_fetch(pDb, key, keyLen, test_Out, &nBytes) == UNQLITE_OK);
+		TEST_CHECK(nBytes == (unqlite_int64)size);
+		TEST_CHECK(memcmp(test_In, test_Out, size) == 0);
+	}
+	TEST_CHECK(unqlite_close(pDb) == UNQLITE_OK);
+	unlink(path);
+	return 0;
+}
+/***************************************************************************************************
+* @brief Entry point.
+* @return 0 on success.
+***************************************************************************************************/
+int main(int argc, char *argv[])
+{
+	TEST_CHECK(test_Codec() == 0);
+	TEST_CHECK(test_Kv((argc > 1) ? argv[1] : "zip.db") == 0);
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,159 @@
+/*
+*********************************************************************************************************
+*                                               uC/CPU
+*                                    CPU CONFIGURATION & PORT LAYER
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                            CPU PORT FILE
+*
+*                                                POSIX
+*
+* Filename : cpu_c.c
+* Version  : V1.32.01
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define    MICRIUM_SOURCE
+#define   _GNU_SOURCE
+#include  <pthread.h>
+#include  <sched.h>
+#include  <cpu.h>
+#include  <cpu_core.h>
+
+#ifdef __cplusplus
+extern  "C" {
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*
+* Note(s) : (1) Critical sections nest (e.g., a critical section entered from a function called within
+*               another one), hence the recursive mutex.
+*********************************************************************************************************
+*/
+
+static  pthread_mutex_t  CPU_CriticalMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;   /* See Note #1.         */
+
+
+/*
+*********************************************************************************************************
+*                                            CPU_SR_Save()
+*
+* Description : Enter a critical section.
+*
+* Argument(s) : none.
+*
+* Return(s)   : 0 (there is no status register to save).
+*
+* Note(s)     : (1) See 'cpu.h  CRITICAL SECTION CONFIGURATION  Note #1'.
+*********************************************************************************************************
+*/
+
+CPU_SR  CPU_SR_Save (void)
+{
+    (void)pthread_mutex_lock(&CPU_CriticalMutex);
+
+    return ((CPU_SR)0);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          CPU_SR_Restore()
+*
+* Description : Exit a critical section.
+*
+* Argument(s) : cpu_sr      Value returned by 'CPU_SR_Save()' (unused).
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  CPU_SR_Restore (CPU_SR  cpu_sr)
+{
+    (void)cpu_sr;
+    (void)pthread_mutex_unlock(&CPU_CriticalMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            CPU_IntDis()
+*                                            CPU_IntEn()
+*
+* Description : Disable/enable interrupts.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Mapped onto the critical section mutex.
+*********************************************************************************************************
+*/
+
+void  CPU_IntDis (void)
+{
+    (void)pthread_mutex_lock(&CPU_CriticalMutex);
+}
+
+
+void  CPU_IntEn (void)
+{
+    (void)pthread_mutex_unlock(&CPU_CriticalMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          CPU_WaitForInt()
+*                                        CPU_WaitForExcept()
+*
+* Description : Wait for an interrupt/exception : yield the processor.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  CPU_WaitForInt (void)
+{
+    (void)sched_yield();
+}
+
+
+void  CPU_WaitForExcept (void)
+{
+    (void)sched_yield();
+}
+
+
+#ifdef __cplusplus
+}
+#endif
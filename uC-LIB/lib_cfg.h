@@ -107,7 +107,9 @@
                                                                 /* Heap memory size (in bytes).                         */
                                                                 /* Configure the desired size of the heap memory. ...   */
                                                                 /* ... Set to 0 to disable heap allocation features.    */
+#ifndef  LIB_MEM_CFG_HEAP_SIZE                                  /* Host builds need more (64-bit ptrs).                 */
 #define  LIB_MEM_CFG_HEAP_SIZE          1024*32
+#endif
 
 
                                                                 /* Heap memory padding alignment (in bytes).            */
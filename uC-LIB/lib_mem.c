@@ -58,6 +58,10 @@
 *********************************************************************************************************
 */
 
+#define  MEM_UNROLL_NBR_WORDS                              4u   /* Nbr of CPU_ALIGN words per unrolled loop iteration.  */
+
+#define  MEM_UNROLL_NBR_OCTETS          (MEM_UNROLL_NBR_WORDS * sizeof(CPU_ALIGN))
+
 
 /*
 *********************************************************************************************************
@@ -285,6 +289,9 @@ void  Mem_Clr (void        *pmem,
 *                   Modulo arithmetic in ANSI-C REQUIREs operations performed on integer values.  Thus
 *                   address values MUST be cast to an appropriately-sized integer value PRIOR to any
 *                  'mem_align_mod' arithmetic operation.
+*
+*               (4) Aligned fill is unrolled by MEM_UNROLL_NBR_WORDS words per iteration to reduce loop
+*                   overhead & to let compilers merge the stores into multiple-store or vector instructions.
 *********************************************************************************************************
 */
 
@@ -331,6 +338,15 @@ void  Mem_Set (void        *pmem,
     }
 
     pmem_align = (CPU_ALIGN *)pmem_08;                          /* See Note #2.                                         */
+    while (size_rem >= MEM_UNROLL_NBR_OCTETS) {                 /* Fill mem buf with unrolled CPU_ALIGN words ...       */
+        pmem_align[0] = data_align;                             /* ... (see Note #4).                                   */
+        pmem_align[1] = data_align;
+        pmem_align[2] = data_align;
+        pmem_align[3] = data_align;
+        pmem_align   += MEM_UNROLL_NBR_WORDS;
+        size_rem     -= MEM_UNROLL_NBR_OCTETS;
+    }
+
     while (size_rem >= sizeof(CPU_ALIGN)) {                     /* While mem buf aligned on CPU_ALIGN word boundaries,  */
        *pmem_align++ = data_align;                              /* ... fill mem buf with    CPU_ALIGN-sized data.       */
         size_rem    -= sizeof(CPU_ALIGN);
@@ -381,6 +397,9 @@ void  Mem_Set (void        *pmem,
 *                       buffers as long as the source memory buffer is at a higher address value than the
 *                       destination memory buffer.
 *
+*                       Since the source words are always read ahead of the destination words written (see
+*                       Note #5), this also holds for the unrolled & shift-merged copies.
+*
 *               (3) For best CPU performance, optimized to copy data buffer using 'CPU_ALIGN'-sized data
 *                   words. Since many word-aligned processors REQUIRE that multi-octet words be accessed on
 *                   word-aligned addresses, 'CPU_ALIGN'-sized words MUST be accessed on 'CPU_ALIGN'd
@@ -392,6 +411,32 @@ void  Mem_Set (void        *pmem,
 *                   Modulo arithmetic in ANSI-C REQUIREs operations performed on integer values.  Thus
 *                   address values MUST be cast to an appropriately-sized integer value PRIOR to any
 *                  'mem_align_mod' arithmetic operation.
+*
+*               (5) (a) If both memory buffers have the same alignment offset, the aligned copy is unrolled
+*                       by MEM_UNROLL_NBR_WORDS words per iteration.  The copy loop is kept free of any
+*                       data dependency so that compilers MAY vectorize it on targets that support it.
+*
+*                   (b) Otherwise, the destination buffer is first aligned to a 'CPU_ALIGN' boundary & each
+*                       destination word is merged from two consecutive aligned source words, shifted by the
+*                       source alignment offset in the CPU's word-memory order :
+*
+*                                       LITTLE-ENDIAN                       BIG-ENDIAN
+*
+*                           dest = (src[n] >> lo) | (src[n+1] << hi)    (src[n] << lo) | (src[n+1] >> hi)
+*
+*                               where
+*                                       lo      Source alignment offset, in bits
+*                                       hi      'CPU_ALIGN' word size minus 'lo', in bits
+*
+*                       (1) The first source word is assembled from the source octets ONLY, so that no
+*                           octet before the source buffer is ever read.
+*
+*                       (2) A source word is only read while at least two destination words remain, so that
+*                           no octet after the source buffer is ever read.  The remaining octets are then
+*                           copied by octets from the current source octet position.
+*
+*                   (c) The copy implementation is selected by LIB_MEM_CFG_OPTIMIZE_ASM_EN; if enabled, the
+*                       CPU port's assembly Mem_Copy() is used instead.
 *********************************************************************************************************
 */
 
@@ -406,6 +451,10 @@ void  Mem_Copy (       void        *pdest,
     const  CPU_ALIGN    *pmem_align_src;
            CPU_INT08U   *pmem_08_dest;
     const  CPU_INT08U   *pmem_08_src;
+           CPU_ALIGN     mem_word_prev;
+           CPU_ALIGN     mem_word_next;
+           CPU_DATA      mem_shift_lo;
+           CPU_DATA      mem_shift_hi;
            CPU_DATA      i;
            CPU_DATA      mem_align_mod_dest;
            CPU_DATA      mem_align_mod_src;
@@ -440,20 +489,30 @@ void  Mem_Copy (       void        *pdest,
 
         mem_aligned        = (mem_align_mod_dest == mem_align_mod_src) ? DEF_YES : DEF_NO;
 
-        if (mem_aligned == DEF_YES) {                           /* If mem bufs' alignment offset equal, ...             */
-                                                                /* ... optimize copy for mem buf alignment.             */
-            if (mem_align_mod_dest != 0u) {                     /* If leading octets avail,                   ...       */
-                i = mem_align_mod_dest;
-                while ((size_rem   >  0) &&                     /* ... start mem buf copy with leading octets ...       */
-                       (i          <  sizeof(CPU_ALIGN ))) {    /* ... until next CPU_ALIGN word boundary.              */
-                   *pmem_08_dest++ = *pmem_08_src++;
-                    size_rem      -=  sizeof(CPU_INT08U);
-                    i++;
-                }
+        if (mem_align_mod_dest != 0u) {                         /* If leading octets avail,                   ...       */
+            i = mem_align_mod_dest;
+            while ((size_rem   >  0) &&                         /* ... start mem buf copy with leading octets ...       */
+                   (i          <  sizeof(CPU_ALIGN ))) {        /* ... until next dest CPU_ALIGN word boundary.         */
+               *pmem_08_dest++ = *pmem_08_src++;
+                size_rem      -=  sizeof(CPU_INT08U);
+                i++;
             }
+        }
 
+        if (mem_aligned == DEF_YES) {                           /* If mem bufs' alignment offset equal, ...             */
+                                                                /* ... optimize copy for mem buf alignment.             */
             pmem_align_dest = (      CPU_ALIGN *)pmem_08_dest;  /* See Note #3.                                         */
             pmem_align_src  = (const CPU_ALIGN *)pmem_08_src;
+            while (size_rem >= MEM_UNROLL_NBR_OCTETS) {         /* Copy unrolled CPU_ALIGN words (see Note #5a).        */
+                pmem_align_dest[0] = pmem_align_src[0];
+                pmem_align_dest[1] = pmem_align_src[1];
+                pmem_align_dest[2] = pmem_align_src[2];
+                pmem_align_dest[3] = pmem_align_src[3];
+                pmem_align_dest   += MEM_UNROLL_NBR_WORDS;
+                pmem_align_src    += MEM_UNROLL_NBR_WORDS;
+                size_rem          -= MEM_UNROLL_NBR_OCTETS;
+            }
+
             while (size_rem      >=  sizeof(CPU_ALIGN)) {       /* While mem bufs aligned on CPU_ALIGN word boundaries, */
                *pmem_align_dest++ = *pmem_align_src++;          /* ... copy psrc to pdest with CPU_ALIGN-sized words.   */
                 size_rem         -=  sizeof(CPU_ALIGN);
@@ -461,6 +520,36 @@ void  Mem_Copy (       void        *pdest,
 
             pmem_08_dest = (      CPU_INT08U *)pmem_align_dest;
             pmem_08_src  = (const CPU_INT08U *)pmem_align_src;
+
+        } else if (size_rem >= (2u * sizeof(CPU_ALIGN))) {      /* Else shift-merge src words (see Note #5b).           */
+            mem_align_mod_src = (CPU_INT08U)((CPU_ADDR)pmem_08_src % sizeof(CPU_ALIGN));
+            mem_shift_lo      =  mem_align_mod_src                        * DEF_OCTET_NBR_BITS;
+            mem_shift_hi      = (sizeof(CPU_ALIGN) - mem_align_mod_src)   * DEF_OCTET_NBR_BITS;
+
+            mem_word_prev     =  0u;                            /* Assemble first src word (see Note #5b1).             */
+            for (i = mem_align_mod_src; i < sizeof(CPU_ALIGN); i++) {
+#if (CPU_CFG_ENDIAN_TYPE == CPU_ENDIAN_TYPE_LITTLE)
+                mem_word_prev |= (CPU_ALIGN)pmem_08_src[i - mem_align_mod_src] << (i * DEF_OCTET_NBR_BITS);
+#else
+                mem_word_prev |= (CPU_ALIGN)pmem_08_src[i - mem_align_mod_src] << ((sizeof(CPU_ALIGN) - 1u - i) * DEF_OCTET_NBR_BITS);
+#endif
+            }
+
+            pmem_align_dest = (      CPU_ALIGN *)pmem_08_dest;
+            pmem_align_src  = (const CPU_ALIGN *)(pmem_08_src + (sizeof(CPU_ALIGN) - mem_align_mod_src));
+            while (size_rem >= (2u * sizeof(CPU_ALIGN))) {      /* See Note #5b2.                                       */
+                mem_word_next      = *pmem_align_src++;
+#if (CPU_CFG_ENDIAN_TYPE == CPU_ENDIAN_TYPE_LITTLE)
+               *pmem_align_dest++  = (mem_word_prev >> mem_shift_lo) | (mem_word_next << mem_shift_hi);
+#else
+               *pmem_align_dest++  = (mem_word_prev << mem_shift_lo) | (mem_word_next >> mem_shift_hi);
+#endif
+                mem_word_prev      =  mem_word_next;
+                pmem_08_src       +=  sizeof(CPU_ALIGN);
+                size_rem          -=  sizeof(CPU_ALIGN);
+            }
+
+            pmem_08_dest = (CPU_INT08U *)pmem_align_dest;
         }
     }
 
@@ -628,6 +717,9 @@ void  Mem_Move (       void        *pdest,
 *                   Modulo arithmetic in ANSI-C REQUIREs operations performed on integer values.  Thus
 *                   address values MUST be cast to an appropriately-sized integer value PRIOR to any
 *                  'mem_align_mod' arithmetic operation.
+*
+*               (5) Aligned compare is unrolled by MEM_UNROLL_NBR_WORDS words per iteration; the words are
+*                   XOR'd & OR'd together so that a single test covers the whole unrolled block.
 *********************************************************************************************************
 */
 
@@ -690,6 +782,19 @@ CPU_BOOLEAN  Mem_Cmp (const  void        *p1_mem,
             p1_mem_align = (CPU_ALIGN *)p1_mem_08;              /* See Note #3.                                         */
             p2_mem_align = (CPU_ALIGN *)p2_mem_08;
 
+            while ((mem_cmp  == DEF_YES) &&                     /* Cmp unrolled CPU_ALIGN words (see Note #5).          */
+                   (size_rem >= MEM_UNROLL_NBR_OCTETS)) {
+                p1_mem_align -= MEM_UNROLL_NBR_WORDS;
+                p2_mem_align -= MEM_UNROLL_NBR_WORDS;
+                if (((p1_mem_align[0] ^ p2_mem_align[0]) |
+                     (p1_mem_align[1] ^ p2_mem_align[1]) |
+                     (p1_mem_align[2] ^ p2_mem_align[2]) |
+                     (p1_mem_align[3] ^ p2_mem_align[3])) != 0u) {
+                     mem_cmp = DEF_NO;
+                }
+                size_rem -= MEM_UNROLL_NBR_OCTETS;
+            }
+
             while ((mem_cmp  == DEF_YES) &&                     /* Cmp mem bufs while identical & ...                   */
                    (size_rem >= sizeof(CPU_ALIGN))) {           /* ... mem bufs aligned on CPU_ALIGN word boundaries.   */
                 p1_mem_align--;
@@ -36,6 +36,8 @@
 
 #define  FS_DEV_NOR_BSP_MODULE
 
+                                                                /* Replaced by 'bsp_fs_dev_nor_sim.c' in host builds.   */
+#ifndef  FS_DEV_NOR_BSP_SIM_EN
 
 /*
 *********************************************************************************************************
@@ -400,3 +402,5 @@ static  void  FSDev_BSP_SPI_SetClkFreq (FS_QTY      unit_nbr,
     (void)freq;
     (void)unit_nbr;
 }
+
+#endif                                                          /* End of !FS_DEV_NOR_BSP_SIM_EN.                       */
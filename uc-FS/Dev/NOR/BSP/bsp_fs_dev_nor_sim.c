@@ -0,0 +1,855 @@
+/*
+*********************************************************************************************************
+*                                                uC/FS
+*                                      The Embedded File System
+*
+*                    Copyright 2008-2020 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                      FILE SYSTEM DEVICE DRIVER
+*                                          NOR FLASH DEVICES
+*                                BOARD SUPPORT PACKAGE (BSP) FUNCTIONS
+*
+*                                    FILE-BACKED W25Q SIMULATOR (SPI)
+*
+* Filename : bsp_fs_dev_nor_sim.c
+* Version  : V4.08.00
+*********************************************************************************************************
+* Note(s)  : (1) See 'bsp_fs_dev_nor_sim.h  Note #1'.
+*
+*            (2) The simulator decodes the command set used by the W25Q PHY driver :
+*
+*                    Fast Read (0Bh) & Read (03h), Page Program (02h), Sector/Block/Chip Erase (20h, 52h,
+*                    D8h, C7h), Write Enable/Disable (06h, 04h), Read/Write Status Register (05h, 01h) &
+*                    Read JEDEC ID (9Fh).
+*
+*                Program & erase behave like the real array : programming can only clear bits, a page
+*                program wraps within its 256-byte page & both are ignored unless the write enable
+*                latch is set.
+*
+*            (3) Operations complete immediately (BUSY is never set).  Their typical duration is added
+*                to the simulated busy time instead, & the bus transfer time is derived from the SPI
+*                clock frequency, so that the total simulated flash time can be compared between runs.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#define  FS_DEV_NOR_BSP_MODULE
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <Dev/NOR/BSP/bsp_fs_dev_nor_sim.h>
+#include  <stdio.h>
+#include  <string.h>
+
+#ifdef   FS_DEV_NOR_BSP_SIM_EN
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  FS_DEV_NOR_SIM_PAGE_SIZE                        256u
+#define  FS_DEV_NOR_SIM_SEC_SIZE                        4096u
+#define  FS_DEV_NOR_SIM_SEC_CNT                 (FS_DEV_NOR_SIM_DEV_SIZE / FS_DEV_NOR_SIM_SEC_SIZE)
+
+#define  FS_DEV_NOR_SIM_HDR_MAX                            8u   /* Max cmd, addr & param octets kept.                   */
+
+
+/*
+*********************************************************************************************************
+*                                           COMMAND DEFINES
+*********************************************************************************************************
+*/
+
+#define  FS_DEV_NOR_SIM_CMD_READ                        0x03u
+#define  FS_DEV_NOR_SIM_CMD_FAST_READ                   0x0Bu
+#define  FS_DEV_NOR_SIM_CMD_PAGE_PGM                    0x02u
+#define  FS_DEV_NOR_SIM_CMD_SECTOR_ERASE                0x20u
+#define  FS_DEV_NOR_SIM_CMD_BLK_ERASE_32K               0x52u
+#define  FS_DEV_NOR_SIM_CMD_BLK_ERASE_64K               0xD8u
+#define  FS_DEV_NOR_SIM_CMD_CHIP_ERASE                  0xC7u
+#define  FS_DEV_NOR_SIM_CMD_WRITE_EN                    0x06u
+#define  FS_DEV_NOR_SIM_CMD_WRITE_DIS                   0x04u
+#define  FS_DEV_NOR_SIM_CMD_STATUS_REG_READ             0x05u
+#define  FS_DEV_NOR_SIM_CMD_STATUS_REG_WRITE            0x01u
+#define  FS_DEV_NOR_SIM_CMD_RD_JEDEC_ID                 0x9Fu
+
+#define  FS_DEV_NOR_SIM_SR_WEL                    DEF_BIT_01
+#define  FS_DEV_NOR_SIM_SR_WR_MASK                DEF_BIT_FIELD(5u, 2u)   /* Protection bits kept by SR wr.     */
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  const  CPU_INT08U  FSDev_NOR_Sim_JEDEC_ID[3] = { 0xEFu, 0x40u, 0x18u };    /* Winbond W25Q128.              */
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  const  CPU_CHAR     *FSDev_NOR_Sim_FileName = FS_DEV_NOR_SIM_FILE_NAME;
+static         FILE         *FSDev_NOR_Sim_File;
+
+static         CPU_INT08U    FSDev_NOR_Sim_Hdr[FS_DEV_NOR_SIM_HDR_MAX];        /* Cmd & addr of cur transaction.  */
+static         CPU_SIZE_T    FSDev_NOR_Sim_HdrLen;                             /* Nbr of octets wr'n since CS en. */
+static         CPU_INT32U    FSDev_NOR_Sim_RdAddr;                             /* Next addr rd by a rd cmd.       */
+
+static         CPU_INT08U    FSDev_NOR_Sim_PgmBuf  [FS_DEV_NOR_SIM_PAGE_SIZE];
+static         CPU_BOOLEAN   FSDev_NOR_Sim_PgmValid[FS_DEV_NOR_SIM_PAGE_SIZE];
+
+static         CPU_INT08U    FSDev_NOR_Sim_SR;
+static         CPU_INT32U    FSDev_NOR_Sim_ClkFreq = FS_DEV_NOR_SIM_CLK_FREQ_DFLT;
+static         CPU_INT64U    FSDev_NOR_Sim_BusTime_ns;
+
+static         FS_DEV_NOR_SIM_STAT  FSDev_NOR_Sim_Stat;
+static         CPU_INT32U           FSDev_NOR_Sim_SecEraseCnt[FS_DEV_NOR_SIM_SEC_CNT];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+                                                                        /* --------------- SPI API FNCTS -------------- */
+static  CPU_BOOLEAN  FSDev_BSP_SPI_Open      (FS_QTY       unit_nbr);   /* Open (initialize) SPI.                       */
+
+static  void         FSDev_BSP_SPI_Close     (FS_QTY       unit_nbr);   /* Close (uninitialize) SPI.                    */
+
+static  void         FSDev_BSP_SPI_Lock      (FS_QTY       unit_nbr);   /* Acquire SPI lock.                            */
+
+static  void         FSDev_BSP_SPI_Unlock    (FS_QTY       unit_nbr);   /* Release SPI lock.                            */
+
+static  void         FSDev_BSP_SPI_Rd        (FS_QTY       unit_nbr,    /* Rd from SPI.                                 */
+                                              void        *p_dest,
+                                              CPU_SIZE_T   cnt);
+
+static  void         FSDev_BSP_SPI_Wr        (FS_QTY       unit_nbr,    /* Wr to SPI.                                   */
+                                              void        *p_src,
+                                              CPU_SIZE_T   cnt);
+
+static  void         FSDev_BSP_SPI_ChipSelEn (FS_QTY       unit_nbr);   /* En flash chip sel.                           */
+
+static  void         FSDev_BSP_SPI_ChipSelDis(FS_QTY       unit_nbr);   /* Dis flash chip sel.                          */
+
+static  void         FSDev_BSP_SPI_SetClkFreq(FS_QTY       unit_nbr,    /* Set SPI clk freq.                            */
+                                              CPU_INT32U   freq);
+
+                                                                        /* ---------------- SIM FNCTS ----------------- */
+static  CPU_INT32U   FSDev_NOR_Sim_Addr      (void);                    /* Get addr of cur transaction.                 */
+
+static  void         FSDev_NOR_Sim_Bus       (CPU_SIZE_T   cnt);        /* Account bus transfer.                        */
+
+static  void         FSDev_NOR_Sim_Pgm       (void);                    /* Exec page program.                           */
+
+static  void         FSDev_NOR_Sim_Erase     (CPU_INT32U   size,        /* Exec erase.                                  */
+                                              CPU_INT32U   dur_us);
+
+
+/*
+*********************************************************************************************************
+*                                         INTERFACE STRUCTURE
+*********************************************************************************************************
+*/
+
+const  FS_DEV_SPI_API  FSDev_NOR_BSP_SPI = {
+    FSDev_BSP_SPI_Open,
+    FSDev_BSP_SPI_Close,
+    FSDev_BSP_SPI_Lock,
+    FSDev_BSP_SPI_Unlock,
+    FSDev_BSP_SPI_Rd,
+    FSDev_BSP_SPI_Wr,
+    FSDev_BSP_SPI_ChipSelEn,
+    FSDev_BSP_SPI_ChipSelDis,
+    FSDev_BSP_SPI_SetClkFreq
+};
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                          GLOBAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                       FSDev_NOR_SimFileSet()
+*
+* Description : Set the host file backing the simulated flash.
+*
+* Argument(s) : p_name      Name of the file.  It is created & erased (filled with 0xFF) if it does not
+*                           exist.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) This function MUST be called before the device is opened.
+*********************************************************************************************************
+*/
+
+void  FSDev_NOR_SimFileSet (const  CPU_CHAR  *p_name)
+{
+    FSDev_NOR_Sim_FileName = p_name;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_NOR_SimStatGet()
+*
+* Description : Get the simulator statistics.
+*
+* Argument(s) : p_stat      Pointer to structure that will receive the statistics.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  FSDev_NOR_SimStatGet (FS_DEV_NOR_SIM_STAT  *p_stat)
+{
+   *p_stat            = FSDev_NOR_Sim_Stat;
+    p_stat->BusTime_us = FSDev_NOR_Sim_BusTime_ns / 1000u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_NOR_SimStatClr()
+*
+* Description : Clear the simulator statistics.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The per-sector erase counts are kept : 'SecEraseMax' reflects the wear of the whole
+*                   life of the backing file opened by this process.
+*********************************************************************************************************
+*/
+
+void  FSDev_NOR_SimStatClr (void)
+{
+    CPU_INT32U  erase_max;
+
+
+    erase_max = FSDev_NOR_Sim_Stat.SecEraseMax;
+    memset(&FSDev_NOR_Sim_Stat, 0, sizeof(FSDev_NOR_Sim_Stat));
+    FSDev_NOR_Sim_Stat.SecEraseMax = erase_max;
+    FSDev_NOR_Sim_BusTime_ns       = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                    FILE SYSTEM NOR SPI FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        FSDev_BSP_SPI_Open()
+*
+* Description : Open (initialize) SPI for serial flash.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+* Return(s)   : DEF_OK,   if interface was opened.
+*               DEF_FAIL, otherwise.
+*
+* Note(s)     : (1) The backing file is opened & created when needed.  A file shorter than the device is
+*                   extended with erased (0xFF) octets.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  FSDev_BSP_SPI_Open (FS_QTY  unit_nbr)
+{
+    CPU_INT08U  erased[FS_DEV_NOR_SIM_SEC_SIZE];
+    long        size;
+
+
+    (void)unit_nbr;
+
+    if (FSDev_NOR_Sim_File != (FILE *)0) {
+        return (DEF_OK);
+    }
+
+    FSDev_NOR_Sim_File = fopen(FSDev_NOR_Sim_FileName, "r+b");
+    if (FSDev_NOR_Sim_File == (FILE *)0) {
+        FSDev_NOR_Sim_File = fopen(FSDev_NOR_Sim_FileName, "w+b");
+        if (FSDev_NOR_Sim_File == (FILE *)0) {
+            return (DEF_FAIL);
+        }
+    }
+
+    (void)fseek(FSDev_NOR_Sim_File, 0L, SEEK_END);              /* Extend to dev size (see Note #1).                    */
+    size = ftell(FSDev_NOR_Sim_File);
+    memset(erased, 0xFF, sizeof(erased));
+    while ((size >= 0) && ((CPU_INT32U)size < FS_DEV_NOR_SIM_DEV_SIZE)) {
+        if (fwrite(erased, 1u, sizeof(erased), FSDev_NOR_Sim_File) != sizeof(erased)) {
+            fclose(FSDev_NOR_Sim_File);
+            FSDev_NOR_Sim_File = (FILE *)0;
+            return (DEF_FAIL);
+        }
+        size += (long)sizeof(erased);
+    }
+
+    FSDev_NOR_Sim_SR     = 0u;
+    FSDev_NOR_Sim_HdrLen = 0u;
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FSDev_BSP_SPI_Close()
+*
+* Description : Close (uninitialize) SPI for serial flash.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) This function will be called every time the device is closed.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_Close (FS_QTY  unit_nbr)
+{
+    (void)unit_nbr;
+
+    if (FSDev_NOR_Sim_File != (FILE *)0) {
+        fclose(FSDev_NOR_Sim_File);
+        FSDev_NOR_Sim_File = (FILE *)0;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FSDev_BSP_SPI_Lock()
+*
+* Description : Acquire SPI lock.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The simulated bus is not shared.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_Lock (FS_QTY  unit_nbr)
+{
+    (void)unit_nbr;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_BSP_SPI_Unlock()
+*
+* Description : Release SPI lock.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) See 'FSDev_BSP_SPI_Lock()  Note #1'.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_Unlock (FS_QTY  unit_nbr)
+{
+    (void)unit_nbr;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         FSDev_BSP_SPI_Rd()
+*
+* Description : Read from SPI.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+*               p_dest    Pointer to destination memory buffer.
+*
+*               cnt       Number of octets to read.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) A read cmd returns the array content from the addr sent in its header; consecutive
+*                   reads within the same transaction continue where the previous one stopped, wrapping
+*                   at the end of the device.
+*
+*               (2) The status register may be polled repeatedly within a single transaction.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_Rd (FS_QTY       unit_nbr,
+                                void        *p_dest,
+                                CPU_SIZE_T   cnt)
+{
+    CPU_INT08U  *p_dest_08;
+    CPU_SIZE_T   ix;
+    CPU_SIZE_T   len;
+    CPU_SIZE_T   hdr_len;
+
+
+    (void)unit_nbr;
+
+    p_dest_08 = (CPU_INT08U *)p_dest;
+    FSDev_NOR_Sim_Bus(cnt);
+
+    if (FSDev_NOR_Sim_HdrLen == 0u) {                           /* No cmd.                                              */
+        memset(p_dest_08, 0xFF, cnt);
+        return;
+    }
+
+    switch (FSDev_NOR_Sim_Hdr[0]) {
+        case FS_DEV_NOR_SIM_CMD_READ:
+        case FS_DEV_NOR_SIM_CMD_FAST_READ:                      /* See Note #1.                                         */
+             hdr_len = (FSDev_NOR_Sim_Hdr[0] == FS_DEV_NOR_SIM_CMD_FAST_READ) ? 5u : 4u;
+             if (FSDev_NOR_Sim_HdrLen < hdr_len) {
+                 memset(p_dest_08, 0xFF, cnt);
+                 return;
+             }
+             if (FSDev_NOR_Sim_HdrLen == hdr_len) {             /* First rd of the transaction.                         */
+                 FSDev_NOR_Sim_RdAddr = FSDev_NOR_Sim_Addr();
+                 FSDev_NOR_Sim_HdrLen++;                        /* Mark the header as consumed.                         */
+                 FSDev_NOR_Sim_Stat.RdCmdCtr++;
+             }
+             FSDev_NOR_Sim_Stat.RdOctetCtr += cnt;
+             while (cnt > 0u) {
+                 len = FS_DEV_NOR_SIM_DEV_SIZE - FSDev_NOR_Sim_RdAddr;
+                 if (len > cnt) {
+                     len = cnt;
+                 }
+                 (void)fseek(FSDev_NOR_Sim_File, (long)FSDev_NOR_Sim_RdAddr, SEEK_SET);
+                 if (fread(p_dest_08, 1u, len, FSDev_NOR_Sim_File) != len) {
+                     memset(p_dest_08, 0xFF, len);
+                 }
+                 p_dest_08            += len;
+                 cnt                  -= len;
+                 FSDev_NOR_Sim_RdAddr  = (FSDev_NOR_Sim_RdAddr + len) % FS_DEV_NOR_SIM_DEV_SIZE;
+             }
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_STATUS_REG_READ:                /* See Note #2.                                         */
+             memset(p_dest_08, FSDev_NOR_Sim_SR, cnt);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_RD_JEDEC_ID:
+             for (ix = 0u; ix < cnt; ix++) {
+                 p_dest_08[ix] = (ix < sizeof(FSDev_NOR_Sim_JEDEC_ID)) ? FSDev_NOR_Sim_JEDEC_ID[ix] : 0xFFu;
+             }
+             break;
+
+
+        default:
+             memset(p_dest_08, 0xFF, cnt);
+             break;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         FSDev_BSP_SPI_Wr()
+*
+* Description : Write to SPI.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+*               p_src     Pointer to source memory buffer.
+*
+*               cnt       Number of octets to write.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The first octets of a transaction (cmd, addr & params) are kept in the header.  For a
+*                   page program, the octets following the 4-octet header are latched in the page buffer
+*                   at their column, wrapping within the page; the program itself is executed when the
+*                   chip select is disabled.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_Wr (FS_QTY       unit_nbr,
+                                void        *p_src,
+                                CPU_SIZE_T   cnt)
+{
+    CPU_INT08U  *p_src_08;
+    CPU_SIZE_T   ix;
+    CPU_INT32U   col;
+
+
+    (void)unit_nbr;
+
+    p_src_08 = (CPU_INT08U *)p_src;
+    FSDev_NOR_Sim_Bus(cnt);
+
+    for (ix = 0u; ix < cnt; ix++) {
+        if ((FSDev_NOR_Sim_HdrLen >= 4u) &&
+            (FSDev_NOR_Sim_Hdr[0] == FS_DEV_NOR_SIM_CMD_PAGE_PGM)) {
+            col = (FSDev_NOR_Sim_Addr() + (CPU_INT32U)(FSDev_NOR_Sim_HdrLen - 4u)) % FS_DEV_NOR_SIM_PAGE_SIZE;
+            FSDev_NOR_Sim_PgmBuf[col]   = p_src_08[ix];
+            FSDev_NOR_Sim_PgmValid[col] = DEF_YES;
+        } else if (FSDev_NOR_Sim_HdrLen < FS_DEV_NOR_SIM_HDR_MAX) {
+            FSDev_NOR_Sim_Hdr[FSDev_NOR_Sim_HdrLen] = p_src_08[ix];
+        }
+        FSDev_NOR_Sim_HdrLen++;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                      FSDev_BSP_SPI_ChipSelEn()
+*
+* Description : Enable serial flash chip select.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) A new transaction starts.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_ChipSelEn (FS_QTY  unit_nbr)
+{
+    (void)unit_nbr;
+
+    FSDev_NOR_Sim_HdrLen = 0u;
+    memset(FSDev_NOR_Sim_PgmValid, DEF_NO, sizeof(FSDev_NOR_Sim_PgmValid));
+}
+
+
+/*
+*********************************************************************************************************
+*                                     FSDev_BSP_SPI_ChipSelDis()
+*
+* Description : Disable serial flash chip select.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Program, erase & write status register cmds are executed when the transaction ends,
+*                   provided the write enable latch was set; the latch is then cleared.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_ChipSelDis (FS_QTY  unit_nbr)
+{
+    CPU_BOOLEAN  wr_en;
+
+
+    (void)unit_nbr;
+
+    if (FSDev_NOR_Sim_HdrLen == 0u) {
+        return;
+    }
+
+    wr_en = DEF_BIT_IS_SET(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+
+    switch (FSDev_NOR_Sim_Hdr[0]) {
+        case FS_DEV_NOR_SIM_CMD_READ:
+        case FS_DEV_NOR_SIM_CMD_FAST_READ:
+        case FS_DEV_NOR_SIM_CMD_RD_JEDEC_ID:
+             break;                                             /* Accounted by FSDev_BSP_SPI_Rd().                     */
+
+
+        case FS_DEV_NOR_SIM_CMD_STATUS_REG_READ:
+             FSDev_NOR_Sim_Stat.StatusRdCtr++;
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_WRITE_EN:
+             FSDev_NOR_Sim_Stat.WrEnCtr++;
+             DEF_BIT_SET(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_WRITE_DIS:
+             FSDev_NOR_Sim_Stat.OtherCmdCtr++;
+             DEF_BIT_CLR(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_PAGE_PGM:                       /* See Note #1.                                         */
+             FSDev_NOR_Sim_Stat.PgmCmdCtr++;
+             if ((wr_en == DEF_YES) && (FSDev_NOR_Sim_HdrLen > 4u)) {
+                 FSDev_NOR_Sim_Pgm();
+             }
+             DEF_BIT_CLR(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_SECTOR_ERASE:
+             FSDev_NOR_Sim_Stat.EraseSecCtr++;
+             if ((wr_en == DEF_YES) && (FSDev_NOR_Sim_HdrLen >= 4u)) {
+                 FSDev_NOR_Sim_Erase(FS_DEV_NOR_SIM_SEC_SIZE, FS_DEV_NOR_SIM_SEC_ERASE_us);
+             }
+             DEF_BIT_CLR(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_BLK_ERASE_32K:
+             FSDev_NOR_Sim_Stat.EraseBlk32KCtr++;
+             if ((wr_en == DEF_YES) && (FSDev_NOR_Sim_HdrLen >= 4u)) {
+                 FSDev_NOR_Sim_Erase(32u * 1024u, FS_DEV_NOR_SIM_BLK_ERASE_32K_us);
+             }
+             DEF_BIT_CLR(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_BLK_ERASE_64K:
+             FSDev_NOR_Sim_Stat.EraseBlk64KCtr++;
+             if ((wr_en == DEF_YES) && (FSDev_NOR_Sim_HdrLen >= 4u)) {
+                 FSDev_NOR_Sim_Erase(64u * 1024u, FS_DEV_NOR_SIM_BLK_ERASE_64K_us);
+             }
+             DEF_BIT_CLR(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_CHIP_ERASE:
+             FSDev_NOR_Sim_Stat.EraseChipCtr++;
+             if (wr_en == DEF_YES) {
+                 FSDev_NOR_Sim_Hdr[1] = 0u;                     /* Erase from addr 0.                                   */
+                 FSDev_NOR_Sim_Hdr[2] = 0u;
+                 FSDev_NOR_Sim_Hdr[3] = 0u;
+                 FSDev_NOR_Sim_Erase(FS_DEV_NOR_SIM_DEV_SIZE, FS_DEV_NOR_SIM_CHIP_ERASE_us);
+             }
+             DEF_BIT_CLR(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        case FS_DEV_NOR_SIM_CMD_STATUS_REG_WRITE:
+             FSDev_NOR_Sim_Stat.OtherCmdCtr++;
+             if ((wr_en == DEF_YES) && (FSDev_NOR_Sim_HdrLen >= 2u)) {
+                 FSDev_NOR_Sim_SR = FSDev_NOR_Sim_Hdr[1] & FS_DEV_NOR_SIM_SR_WR_MASK;
+                 FSDev_NOR_Sim_Stat.BusyTime_us += FS_DEV_NOR_SIM_SR_WR_us;
+             }
+             DEF_BIT_CLR(FSDev_NOR_Sim_SR, FS_DEV_NOR_SIM_SR_WEL);
+             break;
+
+
+        default:
+             FSDev_NOR_Sim_Stat.OtherCmdCtr++;
+             break;
+    }
+
+    FSDev_NOR_Sim_HdrLen = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     FSDev_BSP_SPI_SetClkFreq()
+*
+* Description : Set SPI clock frequency.
+*
+* Argument(s) : unit_nbr  Unit number of NOR.
+*
+*               freq      Clock frequency, in Hz.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The frequency is only used to derive the simulated bus transfer time.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_BSP_SPI_SetClkFreq (FS_QTY      unit_nbr,
+                                        CPU_INT32U  freq)
+{
+    (void)unit_nbr;
+
+    if (freq > 0u) {
+        FSDev_NOR_Sim_ClkFreq = freq;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        FSDev_NOR_Sim_Addr()
+*
+* Description : Get the 24-bit address sent in the header of the current transaction.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Address, wrapped to the device size.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  FSDev_NOR_Sim_Addr (void)
+{
+    CPU_INT32U  addr;
+
+
+    addr = ((CPU_INT32U)FSDev_NOR_Sim_Hdr[1] << (2u * DEF_OCTET_NBR_BITS))
+         | ((CPU_INT32U)FSDev_NOR_Sim_Hdr[2] << (1u * DEF_OCTET_NBR_BITS))
+         | ((CPU_INT32U)FSDev_NOR_Sim_Hdr[3] << (0u * DEF_OCTET_NBR_BITS));
+
+    return (addr % FS_DEV_NOR_SIM_DEV_SIZE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         FSDev_NOR_Sim_Bus()
+*
+* Description : Account a transfer on the simulated bus.
+*
+* Argument(s) : cnt         Number of octets transferred.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_NOR_Sim_Bus (CPU_SIZE_T  cnt)
+{
+    FSDev_NOR_Sim_Stat.BusOctetCtr += cnt;
+    FSDev_NOR_Sim_BusTime_ns       += ((CPU_INT64U)cnt * DEF_OCTET_NBR_BITS * 1000000000u) / FSDev_NOR_Sim_ClkFreq;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         FSDev_NOR_Sim_Pgm()
+*
+* Description : Program the latched page buffer.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Programming can only clear bits : the new content is the AND of the array & the data.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_NOR_Sim_Pgm (void)
+{
+    CPU_INT08U  page[FS_DEV_NOR_SIM_PAGE_SIZE];
+    CPU_INT32U  page_addr;
+    CPU_INT32U  col;
+    CPU_INT32U  cnt;
+
+
+    page_addr = FSDev_NOR_Sim_Addr() - (FSDev_NOR_Sim_Addr() % FS_DEV_NOR_SIM_PAGE_SIZE);
+
+    (void)fseek(FSDev_NOR_Sim_File, (long)page_addr, SEEK_SET);
+    if (fread(page, 1u, sizeof(page), FSDev_NOR_Sim_File) != sizeof(page)) {
+        return;
+    }
+
+    cnt = 0u;
+    for (col = 0u; col < FS_DEV_NOR_SIM_PAGE_SIZE; col++) {
+        if (FSDev_NOR_Sim_PgmValid[col] == DEF_YES) {
+            page[col] &= FSDev_NOR_Sim_PgmBuf[col];             /* See Note #1.                                         */
+            cnt++;
+        }
+    }
+
+    (void)fseek(FSDev_NOR_Sim_File, (long)page_addr, SEEK_SET);
+    (void)fwrite(page, 1u, sizeof(page), FSDev_NOR_Sim_File);
+
+    FSDev_NOR_Sim_Stat.PgmOctetCtr += cnt;
+    FSDev_NOR_Sim_Stat.BusyTime_us += FS_DEV_NOR_SIM_PAGE_PGM_us;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FSDev_NOR_Sim_Erase()
+*
+* Description : Erase (fill with 0xFF) the aligned region containing the addr of the current transaction.
+*
+* Argument(s) : size        Size of the region, in octets (multiple of the sector size).
+*
+*               dur_us      Typical duration of the operation, in microseconds.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_NOR_Sim_Erase (CPU_INT32U  size,
+                                   CPU_INT32U  dur_us)
+{
+    CPU_INT08U  erased[FS_DEV_NOR_SIM_SEC_SIZE];
+    CPU_INT32U  addr;
+    CPU_INT32U  sec;
+
+
+    addr = FSDev_NOR_Sim_Addr() - (FSDev_NOR_Sim_Addr() % size);
+    memset(erased, 0xFF, sizeof(erased));
+
+    (void)fseek(FSDev_NOR_Sim_File, (long)addr, SEEK_SET);
+    for (sec = addr / FS_DEV_NOR_SIM_SEC_SIZE; sec < (addr + size) / FS_DEV_NOR_SIM_SEC_SIZE; sec++) {
+        (void)fwrite(erased, 1u, sizeof(erased), FSDev_NOR_Sim_File);
+
+        FSDev_NOR_Sim_SecEraseCnt[sec]++;
+        if (FSDev_NOR_Sim_SecEraseCnt[sec] > FSDev_NOR_Sim_Stat.SecEraseMax) {
+            FSDev_NOR_Sim_Stat.SecEraseMax = FSDev_NOR_Sim_SecEraseCnt[sec];
+        }
+    }
+
+    FSDev_NOR_Sim_Stat.EraseOctetCtr += size;
+    FSDev_NOR_Sim_Stat.BusyTime_us   += dur_us;
+}
+
+
+#endif                                                          /* End of FS_DEV_NOR_BSP_SIM_EN.                        */
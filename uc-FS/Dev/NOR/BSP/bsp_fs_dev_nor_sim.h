@@ -0,0 +1,131 @@
+/*
+*********************************************************************************************************
+*                                                uC/FS
+*                                      The Embedded File System
+*
+*                    Copyright 2008-2020 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                      FILE SYSTEM DEVICE DRIVER
+*                                          NOR FLASH DEVICES
+*                                BOARD SUPPORT PACKAGE (BSP) FUNCTIONS
+*
+*                                    FILE-BACKED W25Q SIMULATOR (SPI)
+*
+* Filename : bsp_fs_dev_nor_sim.h
+* Version  : V4.08.00
+*********************************************************************************************************
+* Note(s)  : (1) The simulator replaces 'bsp_fs_dev_nor.c' in host builds : define FS_DEV_NOR_BSP_SIM_EN
+*                to compile it (& to compile the hardware BSP out).  The W25Q PHY driver is used unchanged;
+*                every SPI transaction it issues is decoded & executed against a host file.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  FS_DEV_NOR_BSP_SIM_PRESENT
+#define  FS_DEV_NOR_BSP_SIM_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <Dev/NOR/fs_dev_nor.h>
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*********************************************************************************************************
+*/
+
+#ifndef  FS_DEV_NOR_SIM_FILE_NAME                               /* Default backing file.                                */
+#define  FS_DEV_NOR_SIM_FILE_NAME                   "nor_sim.bin"
+#endif
+
+#ifndef  FS_DEV_NOR_SIM_DEV_SIZE                                /* W25Q128 : 16 MB.                                     */
+#define  FS_DEV_NOR_SIM_DEV_SIZE                   (16u * 1024u * 1024u)
+#endif
+
+#ifndef  FS_DEV_NOR_SIM_CLK_FREQ_DFLT                           /* SPI clk used until SetClkFreq() is called.           */
+#define  FS_DEV_NOR_SIM_CLK_FREQ_DFLT               50000000u
+#endif
+
+                                                                /* ----------- TYPICAL TIMINGS (W25Q128JV) ------------ */
+#ifndef  FS_DEV_NOR_SIM_PAGE_PGM_us
+#define  FS_DEV_NOR_SIM_PAGE_PGM_us                      400u   /* tPP  : page program.                                 */
+#define  FS_DEV_NOR_SIM_SEC_ERASE_us                   45000u   /* tSE  : 4 KB sector erase.                            */
+#define  FS_DEV_NOR_SIM_BLK_ERASE_32K_us              120000u   /* tBE1 : 32 KB block erase.                            */
+#define  FS_DEV_NOR_SIM_BLK_ERASE_64K_us              150000u   /* tBE2 : 64 KB block erase.                            */
+#define  FS_DEV_NOR_SIM_CHIP_ERASE_us               40000000u   /* tCE  : chip erase.                                   */
+#define  FS_DEV_NOR_SIM_SR_WR_us                       10000u   /* tW   : write status register.                        */
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                             DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  fs_dev_nor_sim_stat {
+    CPU_INT32U  RdCmdCtr;                                       /* Nbr of read cmds.                                    */
+    CPU_INT32U  PgmCmdCtr;                                      /* Nbr of page program cmds.                            */
+    CPU_INT32U  EraseSecCtr;                                    /* Nbr of 4 KB sector erase cmds.                       */
+    CPU_INT32U  EraseBlk32KCtr;                                 /* Nbr of 32 KB block erase cmds.                       */
+    CPU_INT32U  EraseBlk64KCtr;                                 /* Nbr of 64 KB block erase cmds.                       */
+    CPU_INT32U  EraseChipCtr;                                   /* Nbr of chip erase cmds.                              */
+    CPU_INT32U  WrEnCtr;                                        /* Nbr of write enable cmds.                            */
+    CPU_INT32U  StatusRdCtr;                                    /* Nbr of status register read cmds.                    */
+    CPU_INT32U  OtherCmdCtr;                                    /* Nbr of other cmds.                                   */
+
+    CPU_INT64U  RdOctetCtr;                                     /* Octets read from the array.                          */
+    CPU_INT64U  PgmOctetCtr;                                    /* Octets programmed.                                   */
+    CPU_INT64U  EraseOctetCtr;                                  /* Octets erased.                                       */
+    CPU_INT64U  BusOctetCtr;                                    /* Octets clocked on the bus (both directions).         */
+
+    CPU_INT64U  BusTime_us;                                     /* Simulated bus transfer time.                         */
+    CPU_INT64U  BusyTime_us;                                    /* Simulated program & erase time.                      */
+
+    CPU_INT32U  SecEraseMax;                                    /* Highest erase cnt of any 4 KB sector.                */
+} FS_DEV_NOR_SIM_STAT;
+
+
+/*
+*********************************************************************************************************
+*                                         FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void  FSDev_NOR_SimFileSet(const  CPU_CHAR             *p_name);/* Set backing file (before dev open).                  */
+
+void  FSDev_NOR_SimStatGet(       FS_DEV_NOR_SIM_STAT  *p_stat);/* Get sim stats.                                       */
+
+void  FSDev_NOR_SimStatClr(void);                               /* Clr sim stats.                                       */
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif
@@ -1149,6 +1149,79 @@ void  FSDev_NOR_PhyEraseChip (CPU_CHAR  *name_dev,
 }
 
 
+/*
+*********************************************************************************************************
+*                                         FSDev_NOR_StatGet()
+*
+* Description : Get statistics counters of a NOR device.
+*
+* Argument(s) : name_dev    Device name (see Note #1).
+*
+*               p_stat      Pointer to structure that will receive the counters.
+*
+*               p_err       Pointer to variable that will receive return the error code from this function :
+*
+*                               FS_ERR_NONE               Statistics obtained successfully.
+*                               FS_ERR_NAME_NULL          Argument 'name_dev' passed a NULL pointer.
+*                               FS_ERR_NULL_PTR           Argument 'p_stat' passed a NULL pointer.
+*                               FS_ERR_DEV_INVALID        Argument 'name_dev' specifies an invalid device.
+*
+*                                                         --------- RETURNED BY FSDev_IO_Ctrl() ---------
+*                               FS_ERR_DEV_NOT_OPEN       Device is not open.
+*                               FS_ERR_DEV_NOT_PRESENT    Device is not present.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The device MUST be a NOR device (e.g., "nor:0:").
+*
+*               (2) Counters are cleared when the device is opened & are NOT reset by this function.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
+void  FSDev_NOR_StatGet (CPU_CHAR         *name_dev,
+                         FS_DEV_NOR_STAT  *p_stat,
+                         FS_ERR           *p_err)
+{
+    CPU_INT16S  cmp_val;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION(;);
+    }
+    if (name_dev == (CPU_CHAR *)0) {                            /* Validate name ptr.                                   */
+       *p_err = FS_ERR_NAME_NULL;
+        return;
+    }
+    if (p_stat == (FS_DEV_NOR_STAT *)0) {                       /* Validate stat ptr.                                   */
+       *p_err = FS_ERR_NULL_PTR;
+        return;
+    }
+#endif
+
+                                                                /* Validate name str (see Note #1).                     */
+    cmp_val = Str_Cmp_N(name_dev, (CPU_CHAR *)FSDev_NOR_Name, FS_DEV_NOR_NAME_LEN);
+    if (cmp_val != 0) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+    if (name_dev[FS_DEV_NOR_NAME_LEN] != FS_CHAR_DEV_SEP) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+
+                                                                /* --------------------- GET STATS -------------------- */
+    FSDev_IO_Ctrl(        name_dev,
+                          FS_DEV_IO_CTRL_NOR_STAT_GET,
+                  (void *)p_stat,
+                          p_err);
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *********************************************************************************************************
@@ -1692,6 +1765,7 @@ static  void  FSDev_NOR_Query (FS_DEV       *p_dev,
 *                   (k) FS_DEV_IO_CTRL_PHY_WR_PAGE       Write physical device page.   [*]
 *                   (l) FS_DEV_IO_CTRL_PHY_ERASE_BLK     Erase physical device block.  [**]
 *                   (;) FS_DEV_IO_CTRL_PHY_ERASE_CHIP    Erase physical device.        [**]
+*                   (m) FS_DEV_IO_CTRL_NOR_STAT_GET      Get statistics counters.      [**]
 *
 *                           [*] NOT SUPPORTED
 *                          [**] OCCUR VIA APPLICATION CALLS TO NOR DRIVER INTERFACE FUNCTIONS :
@@ -1706,6 +1780,8 @@ static  void  FSDev_NOR_Query (FS_DEV       *p_dev,
 *                                   FSDev_NOR_PhyWr()
 *                                   FSDev_NOR_PhyEraseBlk()
 *                                   FSDev_NOR_PhyEraseChip()
+*
+*                                   FSDev_NOR_StatGet()
 *********************************************************************************************************
 */
 
@@ -1716,6 +1792,9 @@ static  void  FSDev_NOR_IO_Ctrl (FS_DEV      *p_dev,
 {
     FS_DEV_NOR_IO_CTRL_DATA  *p_io_ctrl_data;
     FS_DEV_NOR_DATA          *p_nor_data;
+#if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
+    FS_DEV_NOR_STAT          *p_stat;
+#endif
 #if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
     FS_SEC_NBR                sec_nbr_logical;
     FS_SEC_NBR                sec_nbr_phy;
@@ -1864,6 +1943,21 @@ static  void  FSDev_NOR_IO_Ctrl (FS_DEV      *p_dev,
              break;
 #endif
 
+#if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
+        case FS_DEV_IO_CTRL_NOR_STAT_GET:                       /* ------------------- GET STAT CTRS ------------------ */
+             p_stat = (FS_DEV_NOR_STAT *)p_data;
+             p_stat->RdCtr         = p_nor_data->StatRdCtr;
+             p_stat->WrCtr         = p_nor_data->StatWrCtr;
+             p_stat->CopyCtr       = p_nor_data->StatCopyCtr;
+             p_stat->ReleaseCtr    = p_nor_data->StatReleaseCtr;
+             p_stat->RdOctetCtr    = p_nor_data->StatRdOctetCtr;
+             p_stat->WrOctetCtr    = p_nor_data->StatWrOctetCtr;
+             p_stat->EraseBlkCtr   = p_nor_data->StatEraseBlkCtr;
+             p_stat->InvalidBlkCtr = p_nor_data->StatInvalidBlkCtr;
+            *p_err = FS_ERR_NONE;
+             break;
+#endif
+
         case FS_DEV_IO_CTRL_PHY_RD_PAGE:                        /* --------------- UNSUPPORTED I/O CTRL --------------- */
         case FS_DEV_IO_CTRL_PHY_WR_PAGE:
         default:
@@ -2646,12 +2740,17 @@ static  void  FSDev_NOR_PhyRdHandler (FS_DEV_NOR_DATA  *p_nor_data,
                                       CPU_INT32U        cnt,
                                       FS_ERR           *p_err)
 {
+    CPU_INT32U  trace_start;
+
+
                                                                 /* ---------------------- RD DATA --------------------- */
+    trace_start = FS_TRACE_IO_START();
     p_nor_data->PhyPtr->Rd(p_nor_data->PhyDataPtr,
                            p_dest,
                            start,
                            cnt,
                            p_err);
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_NOR, FS_TRACE_IO_OP_RD, start, cnt, trace_start);
 
     if (*p_err != FS_ERR_NONE) {
         FS_CTR_ERR_INC(p_nor_data->ErrRdCtr);
@@ -2710,6 +2809,7 @@ static  void  FSDev_NOR_PhyWrHandler (FS_DEV_NOR_DATA  *p_nor_data,
                                       CPU_INT32U        cnt,
                                       FS_ERR           *p_err)
 {
+    CPU_INT32U   trace_start;
 #if (FS_DEV_NOR_CFG_WR_CHK_EN == DEF_ENABLED)
     CPU_INT08U   data_rd[2];
     CPU_INT08U   data_wr_01;
@@ -2749,11 +2849,13 @@ static  void  FSDev_NOR_PhyWrHandler (FS_DEV_NOR_DATA  *p_nor_data,
 
 
                                                                 /* ---------------------- WR DATA --------------------- */
+    trace_start = FS_TRACE_IO_START();
     p_nor_data->PhyPtr->Wr(p_nor_data->PhyDataPtr,
                            p_src,
                            start,
                            cnt,
                            p_err);
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_NOR, FS_TRACE_IO_OP_WR, start, cnt, trace_start);
 
     if (*p_err != FS_ERR_NONE) {
         FS_CTR_ERR_INC(p_nor_data->ErrWrCtr);
@@ -2830,6 +2932,7 @@ static  void  FSDev_NOR_PhyEraseBlkHandler (FS_DEV_NOR_DATA  *p_nor_data,
                                             CPU_INT32U        size,
                                             FS_ERR           *p_err)
 {
+    CPU_INT32U  trace_start;
 #if (FS_DEV_NOR_CFG_WR_CHK_EN == DEF_ENABLED)
     CPU_INT32U  addr;
     CPU_INT32U  cnt_rem;
@@ -2838,10 +2941,12 @@ static  void  FSDev_NOR_PhyEraseBlkHandler (FS_DEV_NOR_DATA  *p_nor_data,
 #endif
 
 
+    trace_start = FS_TRACE_IO_START();
     p_nor_data->PhyPtr->EraseBlk(p_nor_data->PhyDataPtr,
                                  start,
                                  size,
                                  p_err);
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_NOR, FS_TRACE_IO_OP_ERASE, start, size, trace_start);
 
     if (*p_err != FS_ERR_NONE) {
          FS_CTR_ERR_INC(p_nor_data->ErrEraseCtr);
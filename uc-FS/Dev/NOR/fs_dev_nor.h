@@ -307,6 +307,26 @@ typedef  struct  fs_dev_nor_io_ctrl_data {
 } FS_DEV_NOR_IO_CTRL_DATA;
 
 
+/*
+*********************************************************************************************************
+*                                        NOR STAT CTRS DATA TYPE
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
+typedef  struct  fs_dev_nor_stat {
+    FS_CTR                RdCtr;                                /* Secs rd.                                             */
+    FS_CTR                WrCtr;                                /* Secs wr.                                             */
+    FS_CTR                CopyCtr;                              /* Secs copied.                                         */
+    FS_CTR                ReleaseCtr;                           /* Secs released.                                       */
+    FS_CTR                RdOctetCtr;                           /* Octets rd.                                           */
+    FS_CTR                WrOctetCtr;                           /* Octets wr.                                           */
+    FS_CTR                EraseBlkCtr;                          /* Blks erased.                                         */
+    FS_CTR                InvalidBlkCtr;                        /* Blks invalidated.                                    */
+} FS_DEV_NOR_STAT;
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                          GLOBAL VARIABLES
@@ -391,6 +411,13 @@ void         FSDev_NOR_PhyEraseBlk          (CPU_CHAR              *name_dev,
 void         FSDev_NOR_PhyEraseChip         (CPU_CHAR              *name_dev,   /* Erase entire physical device.        */
                                              FS_ERR                *p_err);
 
+                                                                                /* ------------ STAT FNCTS ------------ */
+#if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
+void         FSDev_NOR_StatGet              (CPU_CHAR              *name_dev,   /* Get stat ctrs of device.             */
+                                             FS_DEV_NOR_STAT       *p_stat,
+                                             FS_ERR                *p_err);
+#endif
+
 /*
 *********************************************************************************************************
 *                                         FUNCTION PROTOTYPES
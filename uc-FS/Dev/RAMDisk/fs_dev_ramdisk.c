@@ -44,6 +44,7 @@
 
 #include  <lib_ascii.h>
 #include  <lib_mem.h>
+#include  <lib_str.h>
 #include  "../../Source/fs.h"
 #include  "fs_dev_ramdisk.h"
 
@@ -54,6 +55,15 @@
 *********************************************************************************************************
 */
 
+#define  FS_DEV_RAM_NAME_LEN                               3u
+
+#if ((FS_CFG_CTR_STAT_EN         == DEF_ENABLED) && \
+     (FS_DEV_RAM_CFG_STAT_SEC_EN == DEF_ENABLED))
+#define  FS_DEV_RAM_STAT_SEC_EN                 DEF_ENABLED
+#else
+#define  FS_DEV_RAM_STAT_SEC_EN                 DEF_DISABLED
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -61,6 +71,33 @@
 *********************************************************************************************************
 */
 
+/*
+*********************************************************************************************************
+*                                       RAM DISK CHUNK DATA TYPE
+*
+* Note(s) : (1) When snapshots are enabled, the disk is divided into chunks of
+*               FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT sectors.  The live disk & every snapshot hold a table
+*               of pointers to chunks; a chunk referenced by more than one table is shared & is copied
+*               before being written (copy-on-write).
+*
+*           (2) Base chunks hold data within the disk area supplied in the device configuration; they are
+*               never returned to the chunk free list.  Other chunks are allocated from the heap &, once no
+*               more referenced, returned to the chunk free list for reuse.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+typedef  struct  fs_dev_ram_chunk  FS_DEV_RAM_CHUNK;
+struct  fs_dev_ram_chunk {
+    CPU_INT08U            *DataPtr;                             /* Ptr to chunk data.                                   */
+    CPU_SIZE_T             Size;                                /* Size of chunk data (octets).                         */
+    FS_CTR                 RefCnt;                              /* Nbr of chunk tbls referencing chunk.                 */
+    CPU_BOOLEAN            Base;                                /* Chunk data in disk area (see Note #2).               */
+    FS_DEV_RAM_CHUNK      *NextPtr;                             /* Next chunk in free list.                             */
+};
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                       RAM DISK DATA DATA TYPE
@@ -69,19 +106,49 @@
 
 typedef  struct  fs_dev_ram_data  FS_DEV_RAM_DATA;
 struct  fs_dev_ram_data {
-    FS_QTY            UnitNbr;
-
-    FS_SEC_SIZE       SecSize;
-    FS_SEC_QTY        Size;
-    void             *DiskPtr;
+    FS_QTY                 UnitNbr;
+
+    FS_SEC_SIZE            SecSize;
+    FS_SEC_QTY             Size;
+    void                  *DiskPtr;
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    FS_SEC_QTY             ChunkCnt;                            /* Nbr of chunks.                                       */
+    FS_SEC_QTY             ChunkTblSize;                        /* Nbr of entries alloc'd in chunk tbls.                */
+    FS_DEV_RAM_CHUNK     **ChunkTbl;                            /* Live chunk tbl.                                      */
+    FS_DEV_RAM_CHUNK      *ChunkBaseTbl;                        /* Base chunks (see 'RAM DISK CHUNK DATA TYPE Note #2'). */
+    FS_DEV_RAM_SNAPSHOT   *SnapshotListPtr;                     /* List of snapshots taken of disk.                     */
+#endif
 
 #if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
-    FS_CTR            StatRdCtr;
-    FS_CTR            StatWrCtr;
+    FS_CTR                 StatRdCtr;
+    FS_CTR                 StatWrCtr;
 #endif
 
-    FS_DEV_RAM_DATA  *NextPtr;
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+    FS_SEC_QTY             StatSecTblSize;                      /* Nbr of entries alloc'd in sec stat tbls.             */
+    FS_CTR                *StatSecRdCtrTbl;                     /* Per-sec rd ctrs.                                     */
+    FS_CTR                *StatSecWrCtrTbl;                     /* Per-sec wr ctrs.                                     */
+#endif
+
+    FS_DEV_RAM_DATA       *NextPtr;
+};
+
+
+/*
+*********************************************************************************************************
+*                                     RAM DISK SNAPSHOT DATA TYPE
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+struct  fs_dev_ram_snapshot {
+    FS_DEV_RAM_DATA       *RAM_DataPtr;                         /* Ptr to RAM data of snapshot's disk.                  */
+    FS_SEC_QTY             ChunkTblSize;                        /* Nbr of entries alloc'd in chunk tbl.                 */
+    FS_DEV_RAM_CHUNK     **ChunkTbl;                            /* Snapshot chunk tbl.                                  */
+    FS_DEV_RAM_SNAPSHOT   *NextPtr;                             /* Next snapshot in disk's or free list.                */
 };
+#endif
 
 
 /*
@@ -106,7 +173,13 @@ static  const  CPU_CHAR  FSDev_RAM_Name[] = "ram";
 *********************************************************************************************************
 */
 
-static  FS_DEV_RAM_DATA  *FSDev_RAM_ListFreePtr;
+static  FS_DEV_RAM_DATA      *FSDev_RAM_ListFreePtr;
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  FS_DEV_RAM_CHUNK     *FSDev_RAM_ChunkListFreePtr;
+static  FS_DEV_RAM_SNAPSHOT  *FSDev_RAM_SnapshotListFreePtr;
+static  FS_DEV_RAM_SNAPSHOT  *FSDev_RAM_SnapshotListInvalidPtr;     /* Snapshots invalidated by dev close, not yet del'd.   */
+#endif
 
 
 /*
@@ -161,6 +234,46 @@ static  void              FSDev_RAM_DataFree(FS_DEV_RAM_DATA  *p_ram_data); /* F
 
 static  FS_DEV_RAM_DATA  *FSDev_RAM_DataGet (void);                         /* Allocate & initialize RAM data.          */
 
+static  void              FSDev_RAM_SecMapHandler(FS_DEV_RAM_DATA  *p_ram_data, /* Map secs.                              */
+                                                  FS_DEV_SEC_MAP   *p_sec_map,
+                                                  FS_ERR           *p_err);
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void              FSDev_RAM_ChunkInit    (FS_DEV_RAM_DATA       *p_ram_data,    /* Init chunk tbl.                */
+                                                  FS_ERR                *p_err);
+
+static  void              FSDev_RAM_ChunkFlush   (FS_DEV_RAM_DATA       *p_ram_data);   /* Flush chunks to disk area.     */
+
+static  void              FSDev_RAM_ChunkRelease (FS_DEV_RAM_CHUNK      *p_chunk);      /* Release chunk ref.             */
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  FS_DEV_RAM_CHUNK *FSDev_RAM_ChunkGet     (CPU_SIZE_T             size);         /* Alloc chunk.                   */
+
+static  FS_DEV_RAM_CHUNK *FSDev_RAM_ChunkWrGet   (FS_DEV_RAM_DATA       *p_ram_data,    /* Get chunk for wr.              */
+                                                  FS_SEC_QTY             chunk_ix,
+                                                  FS_ERR                *p_err);
+#endif
+
+static  void              FSDev_RAM_SnapshotTakeHandler   (FS_DEV_RAM_DATA       *p_ram_data,   /* Take snapshot.        */
+                                                           FS_DEV_RAM_SNAPSHOT  **pp_snapshot,
+                                                           FS_ERR                *p_err);
+
+static  void              FSDev_RAM_SnapshotRestoreHandler(FS_DEV_RAM_DATA       *p_ram_data,   /* Restore snapshot.     */
+                                                           FS_DEV_RAM_SNAPSHOT   *p_snapshot,
+                                                           FS_ERR                *p_err);
+
+static  void              FSDev_RAM_SnapshotDelHandler    (FS_DEV_RAM_DATA       *p_ram_data,   /* Del snapshot.         */
+                                                           FS_DEV_RAM_SNAPSHOT   *p_snapshot,
+                                                           FS_ERR                *p_err);
+
+static  void              FSDev_RAM_SnapshotRelease       (FS_DEV_RAM_SNAPSHOT   *p_snapshot);  /* Release snapshot refs.*/
+#endif
+
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+static  void              FSDev_RAM_StatSecInit  (FS_DEV_RAM_DATA       *p_ram_data,    /* Init sec stat tbls.            */
+                                                  FS_ERR                *p_err);
+#endif
+
 /*
 *********************************************************************************************************
 *                                         INTERFACE STRUCTURE
@@ -188,6 +301,406 @@ const  FS_DEV_API  FSDev_RAM = {
 */
 
 
+/*
+*********************************************************************************************************
+*                                      FSDev_RAM_SnapshotTake()
+*
+* Description : Take a snapshot of a RAM disk.
+*
+* Argument(s) : name_dev    Device name (see Note #1).
+*
+*               p_err       Pointer to variable that will receive return the error code from this function :
+*
+*                               FS_ERR_NONE                   Snapshot taken successfully.
+*                               FS_ERR_NAME_NULL              Argument 'name_dev' passed a NULL pointer.
+*                               FS_ERR_DEV_INVALID            Argument 'name_dev' specifies an invalid device.
+*
+*                                                             ------- RETURNED BY FSDev_IO_Ctrl() -------
+*                               FS_ERR_DEV_NOT_OPEN           Device is not open.
+*                               FS_ERR_DEV_NOT_PRESENT        Device is not present.
+*                               FS_ERR_MEM_ALLOC              Memory could not be allocated.
+*
+* Return(s)   : Pointer to snapshot, if NO errors.
+*
+*               Pointer to NULL,     otherwise.
+*
+* Note(s)     : (1) The device MUST be a RAM disk (e.g., "ram:0:").
+*
+*               (2) (a) Taking a snapshot does NOT copy any sector data; the snapshot shares every chunk of
+*                       the disk, incrementing its reference count.  A shared chunk is copied the first time
+*                       it is written (copy-on-write).  The cost of a snapshot is thus proportional to the
+*                       number of chunks, NOT to the size of the disk.
+*
+*                   (b) Only the sectors written to the device are captured.  Volumes on the device SHOULD be
+*                       synchronized (e.g., with FSVol_Sync()) before a snapshot is taken so that no dirty
+*                       cached sector is missing from the snapshot.
+*
+*               (3) A snapshot MUST be deleted with FSDev_RAM_SnapshotDel() once no longer needed.  Snapshots
+*                   still existing when the device is closed are invalidated & can no longer be used.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+FS_DEV_RAM_SNAPSHOT  *FSDev_RAM_SnapshotTake (CPU_CHAR  *name_dev,
+                                              FS_ERR    *p_err)
+{
+    FS_DEV_RAM_SNAPSHOT  *p_snapshot;
+    CPU_INT16S            cmp_val;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION((FS_DEV_RAM_SNAPSHOT *)0);
+    }
+    if (name_dev == (CPU_CHAR *)0) {                            /* Validate name ptr.                                   */
+       *p_err = FS_ERR_NAME_NULL;
+        return ((FS_DEV_RAM_SNAPSHOT *)0);
+    }
+#endif
+
+                                                                /* Validate name str (see Note #1).                     */
+    cmp_val = Str_Cmp_N(name_dev, (CPU_CHAR *)FSDev_RAM_Name, FS_DEV_RAM_NAME_LEN);
+    if (cmp_val != 0) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return ((FS_DEV_RAM_SNAPSHOT *)0);
+    }
+
+    if (name_dev[FS_DEV_RAM_NAME_LEN] != FS_CHAR_DEV_SEP) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return ((FS_DEV_RAM_SNAPSHOT *)0);
+    }
+
+
+                                                                /* ------------------- TAKE SNAPSHOT ------------------ */
+    p_snapshot = (FS_DEV_RAM_SNAPSHOT *)0;
+    FSDev_IO_Ctrl(         name_dev,
+                           FS_DEV_IO_CTRL_RAM_SNAPSHOT_TAKE,
+                  (void *)&p_snapshot,
+                           p_err);
+
+    return (p_snapshot);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                     FSDev_RAM_SnapshotRestore()
+*
+* Description : Restore a RAM disk from a snapshot.
+*
+* Argument(s) : name_dev    Device name (see Note #1).
+*
+*               p_snapshot  Pointer to snapshot taken of the device.
+*
+*               p_err       Pointer to variable that will receive return the error code from this function :
+*
+*                               FS_ERR_NONE                   Device restored successfully.
+*                               FS_ERR_NAME_NULL              Argument 'name_dev' passed a NULL pointer.
+*                               FS_ERR_NULL_PTR               Argument 'p_snapshot' passed a NULL pointer.
+*                               FS_ERR_DEV_INVALID            Argument 'name_dev' specifies an invalid device.
+*
+*                                                             ------- RETURNED BY FSDev_IO_Ctrl() -------
+*                               FS_ERR_DEV_NOT_OPEN           Device is not open.
+*                               FS_ERR_DEV_NOT_PRESENT        Device is not present.
+*                               FS_ERR_INVALID_ARG            Snapshot was not taken of this device.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The device MUST be a RAM disk (e.g., "ram:0:").
+*
+*               (2) The snapshot remains valid after the restore & may be restored again.
+*
+*               (3) Restoring replaces the content of the whole disk.  Volumes on the device SHOULD be closed
+*                   before the restore & re-opened after, so that no stale cached sector or volume
+*                   information is used.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+void  FSDev_RAM_SnapshotRestore (CPU_CHAR             *name_dev,
+                                 FS_DEV_RAM_SNAPSHOT  *p_snapshot,
+                                 FS_ERR               *p_err)
+{
+    CPU_INT16S  cmp_val;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION(;);
+    }
+    if (name_dev == (CPU_CHAR *)0) {                            /* Validate name ptr.                                   */
+       *p_err = FS_ERR_NAME_NULL;
+        return;
+    }
+    if (p_snapshot == (FS_DEV_RAM_SNAPSHOT *)0) {               /* Validate snapshot ptr.                               */
+       *p_err = FS_ERR_NULL_PTR;
+        return;
+    }
+#endif
+
+                                                                /* Validate name str (see Note #1).                     */
+    cmp_val = Str_Cmp_N(name_dev, (CPU_CHAR *)FSDev_RAM_Name, FS_DEV_RAM_NAME_LEN);
+    if (cmp_val != 0) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+    if (name_dev[FS_DEV_RAM_NAME_LEN] != FS_CHAR_DEV_SEP) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+
+                                                                /* ----------------- RESTORE SNAPSHOT ----------------- */
+    FSDev_IO_Ctrl(        name_dev,
+                          FS_DEV_IO_CTRL_RAM_SNAPSHOT_RESTORE,
+                  (void *)p_snapshot,
+                          p_err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_RAM_SnapshotDel()
+*
+* Description : Delete a RAM disk snapshot.
+*
+* Argument(s) : name_dev    Device name (see Note #1).
+*
+*               p_snapshot  Pointer to snapshot taken of the device.
+*
+*               p_err       Pointer to variable that will receive return the error code from this function :
+*
+*                               FS_ERR_NONE                   Snapshot deleted successfully.
+*                               FS_ERR_NAME_NULL              Argument 'name_dev' passed a NULL pointer.
+*                               FS_ERR_NULL_PTR               Argument 'p_snapshot' passed a NULL pointer.
+*                               FS_ERR_DEV_INVALID            Argument 'name_dev' specifies an invalid device.
+*
+*                                                             ------- RETURNED BY FSDev_IO_Ctrl() -------
+*                               FS_ERR_DEV_NOT_OPEN           Device is not open.
+*                               FS_ERR_DEV_NOT_PRESENT        Device is not present.
+*                               FS_ERR_INVALID_ARG            Snapshot was not taken of this device.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The device MUST be a RAM disk (e.g., "ram:0:").
+*
+*               (2) Chunks referenced only by the snapshot are returned to the chunk free list.
+*
+*               (3) A snapshot invalidated by the closing of its device (see 'FSDev_RAM_Close()  Note #3')
+*                   is freed without accessing the device, which may not be open anymore.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+void  FSDev_RAM_SnapshotDel (CPU_CHAR             *name_dev,
+                             FS_DEV_RAM_SNAPSHOT  *p_snapshot,
+                             FS_ERR               *p_err)
+{
+    CPU_INT16S             cmp_val;
+    FS_DEV_RAM_SNAPSHOT  **pp_snapshot;
+    CPU_SR_ALLOC();
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION(;);
+    }
+    if (name_dev == (CPU_CHAR *)0) {                            /* Validate name ptr.                                   */
+       *p_err = FS_ERR_NAME_NULL;
+        return;
+    }
+    if (p_snapshot == (FS_DEV_RAM_SNAPSHOT *)0) {               /* Validate snapshot ptr.                               */
+       *p_err = FS_ERR_NULL_PTR;
+        return;
+    }
+#endif
+
+                                                                /* Validate name str (see Note #1).                     */
+    cmp_val = Str_Cmp_N(name_dev, (CPU_CHAR *)FSDev_RAM_Name, FS_DEV_RAM_NAME_LEN);
+    if (cmp_val != 0) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+    if (name_dev[FS_DEV_RAM_NAME_LEN] != FS_CHAR_DEV_SEP) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+
+                                                                /* ------------- FREE INVALIDATED SNAPSHOT ------------ */
+    CPU_CRITICAL_ENTER();                                       /* See Note #3.                                         */
+    pp_snapshot = &FSDev_RAM_SnapshotListInvalidPtr;
+    while ((*pp_snapshot != (FS_DEV_RAM_SNAPSHOT *)0) &&
+           (*pp_snapshot != p_snapshot)) {
+        pp_snapshot = &(*pp_snapshot)->NextPtr;
+    }
+
+    if (*pp_snapshot != (FS_DEV_RAM_SNAPSHOT *)0) {
+       *pp_snapshot                   = p_snapshot->NextPtr;
+        p_snapshot->NextPtr           = FSDev_RAM_SnapshotListFreePtr;
+        FSDev_RAM_SnapshotListFreePtr = p_snapshot;
+        CPU_CRITICAL_EXIT();
+       *p_err = FS_ERR_NONE;
+        return;
+    }
+    CPU_CRITICAL_EXIT();
+
+
+                                                                /* ------------------ DEL SNAPSHOT -------------------- */
+    FSDev_IO_Ctrl(        name_dev,
+                          FS_DEV_IO_CTRL_RAM_SNAPSHOT_DEL,
+                  (void *)p_snapshot,
+                          p_err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_RAM_SecStatGet()
+*
+* Description : Get read & write counters of a RAM disk sector.
+*
+* Argument(s) : name_dev    Device name (see Note #1).
+*
+*               sec_nbr     Sector number.
+*
+*               p_stat      Pointer to structure that will receive sector statistics.
+*
+*               p_err       Pointer to variable that will receive return the error code from this function :
+*
+*                               FS_ERR_NONE                   Statistics obtained successfully.
+*                               FS_ERR_NAME_NULL              Argument 'name_dev' passed a NULL pointer.
+*                               FS_ERR_NULL_PTR               Argument 'p_stat' passed a NULL pointer.
+*                               FS_ERR_DEV_INVALID            Argument 'name_dev' specifies an invalid device.
+*
+*                                                             ------- RETURNED BY FSDev_IO_Ctrl() -------
+*                               FS_ERR_DEV_NOT_OPEN           Device is not open.
+*                               FS_ERR_DEV_NOT_PRESENT        Device is not present.
+*                               FS_ERR_DEV_INVALID_SEC_NBR    Sector number invalid.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The device MUST be a RAM disk (e.g., "ram:0:").
+*
+*               (2) Counters are incremented for each sector read from or written to the device, i.e. AFTER
+*                   the volume cache; they reflect the I/O pattern the medium would see.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+void  FSDev_RAM_SecStatGet (CPU_CHAR             *name_dev,
+                            FS_SEC_NBR            sec_nbr,
+                            FS_DEV_RAM_SEC_STAT  *p_stat,
+                            FS_ERR               *p_err)
+{
+    CPU_INT16S  cmp_val;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION(;);
+    }
+    if (name_dev == (CPU_CHAR *)0) {                            /* Validate name ptr.                                   */
+       *p_err = FS_ERR_NAME_NULL;
+        return;
+    }
+    if (p_stat == (FS_DEV_RAM_SEC_STAT *)0) {                   /* Validate stat ptr.                                   */
+       *p_err = FS_ERR_NULL_PTR;
+        return;
+    }
+#endif
+
+                                                                /* Validate name str (see Note #1).                     */
+    cmp_val = Str_Cmp_N(name_dev, (CPU_CHAR *)FSDev_RAM_Name, FS_DEV_RAM_NAME_LEN);
+    if (cmp_val != 0) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+    if (name_dev[FS_DEV_RAM_NAME_LEN] != FS_CHAR_DEV_SEP) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+
+                                                                /* ------------------- GET SEC STAT ------------------- */
+    p_stat->SecNbr = sec_nbr;
+    FSDev_IO_Ctrl(        name_dev,
+                          FS_DEV_IO_CTRL_RAM_SEC_STAT_GET,
+                  (void *)p_stat,
+                          p_err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_RAM_SecStatClr()
+*
+* Description : Clear read & write counters of all RAM disk sectors.
+*
+* Argument(s) : name_dev    Device name (see Note #1).
+*
+*               p_err       Pointer to variable that will receive return the error code from this function :
+*
+*                               FS_ERR_NONE                   Statistics cleared successfully.
+*                               FS_ERR_NAME_NULL              Argument 'name_dev' passed a NULL pointer.
+*                               FS_ERR_DEV_INVALID            Argument 'name_dev' specifies an invalid device.
+*
+*                                                             ------- RETURNED BY FSDev_IO_Ctrl() -------
+*                               FS_ERR_DEV_NOT_OPEN           Device is not open.
+*                               FS_ERR_DEV_NOT_PRESENT        Device is not present.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The device MUST be a RAM disk (e.g., "ram:0:").
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+void  FSDev_RAM_SecStatClr (CPU_CHAR  *name_dev,
+                            FS_ERR    *p_err)
+{
+    CPU_INT16S  cmp_val;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION(;);
+    }
+    if (name_dev == (CPU_CHAR *)0) {                            /* Validate name ptr.                                   */
+       *p_err = FS_ERR_NAME_NULL;
+        return;
+    }
+#endif
+
+                                                                /* Validate name str (see Note #1).                     */
+    cmp_val = Str_Cmp_N(name_dev, (CPU_CHAR *)FSDev_RAM_Name, FS_DEV_RAM_NAME_LEN);
+    if (cmp_val != 0) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+    if (name_dev[FS_DEV_RAM_NAME_LEN] != FS_CHAR_DEV_SEP) {
+       *p_err = FS_ERR_DEV_INVALID;
+        return;
+    }
+
+
+                                                                /* ------------------- CLR SEC STAT ------------------- */
+    FSDev_IO_Ctrl(        name_dev,
+                          FS_DEV_IO_CTRL_RAM_SEC_STAT_CLR,
+                  (void *)0,
+                          p_err);
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *********************************************************************************************************
@@ -241,8 +754,13 @@ static  const  CPU_CHAR  *FSDev_RAM_NameGet (void)
 
 static  void  FSDev_RAM_Init (FS_ERR  *p_err)
 {
-    FSDev_RAM_UnitCtr     =  0u;
-    FSDev_RAM_ListFreePtr = (FS_DEV_RAM_DATA *)0;
+    FSDev_RAM_UnitCtr             =  0u;
+    FSDev_RAM_ListFreePtr         = (FS_DEV_RAM_DATA     *)0;
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    FSDev_RAM_ChunkListFreePtr       = (FS_DEV_RAM_CHUNK    *)0;
+    FSDev_RAM_SnapshotListFreePtr    = (FS_DEV_RAM_SNAPSHOT *)0;
+    FSDev_RAM_SnapshotListInvalidPtr = (FS_DEV_RAM_SNAPSHOT *)0;
+#endif
 
    *p_err = FS_ERR_NONE;
 }
@@ -343,6 +861,23 @@ static  void  FSDev_RAM_Open (FS_DEV  *p_dev,
     p_ram_data->SecSize =  p_ram_cfg->SecSize;
     p_ram_data->Size    =  p_ram_cfg->Size;
     p_ram_data->DiskPtr =  p_ram_cfg->DiskPtr;
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    FSDev_RAM_ChunkInit(p_ram_data, p_err);                     /* Init chunk tbl.                                      */
+    if (*p_err != FS_ERR_NONE) {
+        FSDev_RAM_DataFree(p_ram_data);
+        return;
+    }
+#endif
+
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+    FSDev_RAM_StatSecInit(p_ram_data, p_err);                   /* Init sec stat tbls.                                  */
+    if (*p_err != FS_ERR_NONE) {
+        FSDev_RAM_DataFree(p_ram_data);
+        return;
+    }
+#endif
+
     p_dev->DataPtr      = (void *)p_ram_data;
 
     FS_TRACE_INFO(("RAM DISK FOUND: Name    : \"ram:%d:\"\r\n", p_ram_data->UnitNbr));
@@ -369,15 +904,43 @@ static  void  FSDev_RAM_Open (FS_DEV  *p_dev,
 *                   called when a device is open.
 *
 *               (2) This function will be called EVERY time the device is closed.
+*
+*               (3) Snapshots still existing are invalidated & the live chunks are flushed to the disk area,
+*                   so that the disk area holds the content of the disk once closed.  Invalidated snapshots
+*                   release their chunks & are kept on a list until freed by 'FSDev_RAM_SnapshotDel()'.
 *********************************************************************************************************
 */
 
 static  void  FSDev_RAM_Close (FS_DEV  *p_dev)
 {
-    FS_DEV_RAM_DATA  *p_ram_data;
+    FS_DEV_RAM_DATA      *p_ram_data;
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    FS_DEV_RAM_SNAPSHOT  *p_snapshot;
+    FS_DEV_RAM_SNAPSHOT  *p_snapshot_next;
+    CPU_SR_ALLOC();
+#endif
 
 
     p_ram_data = (FS_DEV_RAM_DATA *)p_dev->DataPtr;
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)                 /* Invalidate snapshots (see Note #3).                  */
+    p_snapshot = p_ram_data->SnapshotListPtr;
+    while (p_snapshot != (FS_DEV_RAM_SNAPSHOT *)0) {
+        FS_TRACE_DBG(("FSDev_RAM_Close(): Snapshot 0x%08X of RAM disk invalidated.\r\n", (CPU_ADDR)p_snapshot));
+        FSDev_RAM_SnapshotRelease(p_snapshot);
+        p_snapshot_next         =  p_snapshot->NextPtr;
+        p_snapshot->RAM_DataPtr = (FS_DEV_RAM_DATA *)0;
+        CPU_CRITICAL_ENTER();
+        p_snapshot->NextPtr              = FSDev_RAM_SnapshotListInvalidPtr;
+        FSDev_RAM_SnapshotListInvalidPtr = p_snapshot;
+        CPU_CRITICAL_EXIT();
+        p_snapshot              =  p_snapshot_next;
+    }
+    p_ram_data->SnapshotListPtr = (FS_DEV_RAM_SNAPSHOT *)0;
+
+    FSDev_RAM_ChunkFlush(p_ram_data);
+#endif
+
     FSDev_RAM_DataFree(p_ram_data);
 }
 
@@ -412,6 +975,9 @@ static  void  FSDev_RAM_Close (FS_DEV  *p_dev)
 *
 * Note(s)     : (1) Tracking whether a device is open is not necessary, because this should ONLY be
 *                   called when a device is open.
+*
+*               (2) With snapshots enabled, sectors are read from the chunks of the live chunk table, as
+*                   many sectors at once as lie within the same chunk.
 *********************************************************************************************************
 */
 
@@ -421,19 +987,52 @@ static  void  FSDev_RAM_Rd (FS_DEV      *p_dev,
                             FS_SEC_QTY   cnt,
                             FS_ERR      *p_err)
 {
-    FS_DEV_RAM_DATA  *p_ram_data;
-    FS_SEC_QTY        i;
-    CPU_SIZE_T        cnt_octets;
-    CPU_INT08U       *p_dest_08;
-    CPU_INT08U       *p_sec_08;
+    FS_DEV_RAM_DATA   *p_ram_data;
+    FS_SEC_QTY         i;
+    CPU_SIZE_T         cnt_octets;
+    CPU_INT08U        *p_dest_08;
+    CPU_INT08U        *p_sec_08;
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    FS_DEV_RAM_CHUNK  *p_chunk;
+    FS_SEC_NBR         sec_nbr;
+    FS_SEC_QTY         sec_cnt;
+    FS_SEC_QTY         sec_rem;
+    FS_SEC_QTY         chunk_ix;
+    FS_SEC_QTY         chunk_off;
+#endif
 
 
     p_ram_data = (FS_DEV_RAM_DATA *)p_dev->DataPtr;
 
     p_dest_08  = (CPU_INT08U *) p_dest;
-    p_sec_08   = (CPU_INT08U *)(p_ram_data->DiskPtr) + (start * p_ram_data->SecSize);
     cnt_octets = (CPU_SIZE_T  )(p_ram_data->SecSize);
 
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)                 /* Rd from chunks (see Note #2).                        */
+    (void)i;
+    (void)p_sec_08;
+
+    sec_nbr = start;
+    sec_rem = cnt;
+    while (sec_rem > 0u) {
+        chunk_ix  = sec_nbr / FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+        chunk_off = sec_nbr % FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+        sec_cnt   = FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT - chunk_off;
+        if (sec_cnt > sec_rem) {
+            sec_cnt = sec_rem;
+        }
+
+        p_chunk = p_ram_data->ChunkTbl[chunk_ix];
+        Mem_Copy(p_dest_08,
+                 p_chunk->DataPtr + (chunk_off * cnt_octets),
+                 sec_cnt * cnt_octets);
+
+        p_dest_08 += sec_cnt * cnt_octets;
+        sec_nbr   += sec_cnt;
+        sec_rem   -= sec_cnt;
+    }
+#else
+    p_sec_08   = (CPU_INT08U *)(p_ram_data->DiskPtr) + (start * p_ram_data->SecSize);
+
     for (i = 0u; i < cnt; i++) {
         Mem_Copy(p_dest_08,
                  p_sec_08,
@@ -442,9 +1041,16 @@ static  void  FSDev_RAM_Rd (FS_DEV      *p_dev,
         p_dest_08 += cnt_octets;
         p_sec_08  += cnt_octets;
     }
+#endif
 
     FS_CTR_STAT_ADD(p_ram_data->StatRdCtr, (FS_CTR)cnt);
 
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+    for (i = 0u; i < cnt; i++) {
+        FS_CTR_STAT_INC(p_ram_data->StatSecRdCtrTbl[start + i]);
+    }
+#endif
+
    *p_err = FS_ERR_NONE;
 }
 
@@ -474,11 +1080,16 @@ static  void  FSDev_RAM_Rd (FS_DEV      *p_dev,
 *                               FS_ERR_DEV_NOT_PRESENT         Device is not present.
 *                               FS_ERR_DEV_IO                  Device I/O error.
 *                               FS_ERR_DEV_TIMEOUT             Device timeout.
+*                               FS_ERR_MEM_ALLOC               Memory could not be allocated (see Note #2).
 *
 * Return(s)   : none.
 *
 * Note(s)     : (1) Tracking whether a device is open is not necessary, because this should ONLY be
 *                   called when a device is open.
+*
+*               (2) With snapshots enabled, a chunk shared with a snapshot is copied before being written.
+*                   If no memory is available for the copy, the write stops & the sectors of the chunk are
+*                   left unmodified.
 *********************************************************************************************************
 */
 
@@ -489,19 +1100,57 @@ static  void  FSDev_RAM_Wr (FS_DEV      *p_dev,
                             FS_SEC_QTY   cnt,
                             FS_ERR      *p_err)
 {
-    FS_DEV_RAM_DATA  *p_ram_data;
-    FS_SEC_QTY        i;
-    CPU_SIZE_T        cnt_octets;
-    CPU_INT08U       *p_sec_08;
-    CPU_INT08U       *p_src_08;
+    FS_DEV_RAM_DATA   *p_ram_data;
+    FS_SEC_QTY         i;
+    CPU_SIZE_T         cnt_octets;
+    CPU_INT08U        *p_sec_08;
+    CPU_INT08U        *p_src_08;
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    FS_DEV_RAM_CHUNK  *p_chunk;
+    FS_SEC_NBR         sec_nbr;
+    FS_SEC_QTY         sec_cnt;
+    FS_SEC_QTY         sec_rem;
+    FS_SEC_QTY         chunk_ix;
+    FS_SEC_QTY         chunk_off;
+#endif
 
 
     p_ram_data = (FS_DEV_RAM_DATA *)p_dev->DataPtr;
 
     p_src_08   = (CPU_INT08U *) p_src;
-    p_sec_08   = (CPU_INT08U *)(p_ram_data->DiskPtr) + (start * p_ram_data->SecSize);
     cnt_octets = (CPU_SIZE_T  )(p_ram_data->SecSize);
 
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)                 /* Wr to unshared chunks (see Note #2).                 */
+    (void)i;
+    (void)p_sec_08;
+
+    sec_nbr = start;
+    sec_rem = cnt;
+    while (sec_rem > 0u) {
+        chunk_ix  = sec_nbr / FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+        chunk_off = sec_nbr % FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+        sec_cnt   = FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT - chunk_off;
+        if (sec_cnt > sec_rem) {
+            sec_cnt = sec_rem;
+        }
+
+        p_chunk = FSDev_RAM_ChunkWrGet(p_ram_data, chunk_ix, p_err);
+        if (p_chunk == (FS_DEV_RAM_CHUNK *)0) {
+            FS_CTR_STAT_ADD(p_ram_data->StatWrCtr, (FS_CTR)(cnt - sec_rem));
+            return;
+        }
+
+        Mem_Copy(p_chunk->DataPtr + (chunk_off * cnt_octets),
+                 p_src_08,
+                 sec_cnt * cnt_octets);
+
+        p_src_08 += sec_cnt * cnt_octets;
+        sec_nbr  += sec_cnt;
+        sec_rem  -= sec_cnt;
+    }
+#else
+    p_sec_08   = (CPU_INT08U *)(p_ram_data->DiskPtr) + (start * p_ram_data->SecSize);
+
     for (i = 0u; i < cnt; i++) {
         Mem_Copy(p_sec_08,
                  p_src_08,
@@ -510,9 +1159,16 @@ static  void  FSDev_RAM_Wr (FS_DEV      *p_dev,
         p_src_08 += cnt_octets;
         p_sec_08 += cnt_octets;
     }
+#endif
 
     FS_CTR_STAT_ADD(p_ram_data->StatWrCtr, (FS_CTR)cnt);
 
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+    for (i = 0u; i < cnt; i++) {
+        FS_CTR_STAT_INC(p_ram_data->StatSecWrCtrTbl[start + i]);
+    }
+#endif
+
    *p_err = FS_ERR_NONE;
 }
 #endif
@@ -609,8 +1265,24 @@ static  void  FSDev_RAM_Query (FS_DEV       *p_dev,
 *                   (k) FS_DEV_IO_CTRL_PHY_WR_PAGE       Write physical device page.   [*]
 *                   (l) FS_DEV_IO_CTRL_PHY_ERASE_BLK     Erase physical device block.  [*]
 *                   (m) FS_DEV_IO_CTRL_PHY_ERASE_CHIP    Erase physical device.        [*]
+*                   (n) FS_DEV_IO_CTRL_SEC_MAP           Map sectors.
+*                   (o) FS_DEV_IO_CTRL_RD_SHARED         Query concurrent reads.       [****]
 *
-*                           [*] NOT SUPPORTED
+*                           [*]    NOT SUPPORTED
+*                           [****] Reads only copy sector data, so they may run concurrently.  The rd
+*                                  ctrs are then approximate.
+*
+*               (3) RAM-driver specific I/O control operations are :
+*
+*                   (a) FS_DEV_IO_CTRL_RAM_SNAPSHOT_TAKE      Take snapshot of disk.        [**]
+*                   (b) FS_DEV_IO_CTRL_RAM_SNAPSHOT_RESTORE   Restore disk from snapshot.   [**]
+*                   (c) FS_DEV_IO_CTRL_RAM_SNAPSHOT_DEL       Delete snapshot.              [**]
+*                   (d) FS_DEV_IO_CTRL_RAM_SEC_STAT_GET       Get sector rd/wr ctrs.        [***]
+*                   (e) FS_DEV_IO_CTRL_RAM_SEC_STAT_CLR       Clear sector rd/wr ctrs.      [***]
+*
+*                           [**]  SUPPORTED if FS_DEV_RAM_CFG_SNAPSHOT_EN is DEF_ENABLED.
+*                           [***] SUPPORTED if FS_DEV_RAM_CFG_STAT_SEC_EN & FS_CFG_CTR_STAT_EN are
+*                                 DEF_ENABLED.
 *********************************************************************************************************
 */
 
@@ -619,13 +1291,71 @@ static  void  FSDev_RAM_IO_Ctrl (FS_DEV      *p_dev,
                                  void        *p_data,
                                  FS_ERR      *p_err)
 {
-   (void)p_dev;                                                 /*lint --e{550} Suppress "Symbol not accessed".         */
-   (void)opt;
-   (void)p_data;
+    FS_DEV_RAM_DATA      *p_ram_data;
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+    FS_DEV_RAM_SEC_STAT  *p_stat;
+    FS_SEC_QTY            sec_ix;
+#endif
+
 
+    p_ram_data = (FS_DEV_RAM_DATA *)p_dev->DataPtr;
 
                                                                 /* ------------------ PERFORM I/O CTL ----------------- */
-   *p_err = FS_ERR_DEV_INVALID_IO_CTRL;
+    switch (opt) {
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+        case FS_DEV_IO_CTRL_RAM_SNAPSHOT_TAKE:                  /* -------------------- TAKE SNAPSHOT ----------------- */
+             FSDev_RAM_SnapshotTakeHandler(p_ram_data, (FS_DEV_RAM_SNAPSHOT **)p_data, p_err);
+             break;
+
+
+        case FS_DEV_IO_CTRL_RAM_SNAPSHOT_RESTORE:               /* ------------------ RESTORE SNAPSHOT ---------------- */
+             FSDev_RAM_SnapshotRestoreHandler(p_ram_data, (FS_DEV_RAM_SNAPSHOT *)p_data, p_err);
+             break;
+
+
+        case FS_DEV_IO_CTRL_RAM_SNAPSHOT_DEL:                   /* -------------------- DEL SNAPSHOT ------------------ */
+             FSDev_RAM_SnapshotDelHandler(p_ram_data, (FS_DEV_RAM_SNAPSHOT *)p_data, p_err);
+             break;
+#endif
+
+
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+        case FS_DEV_IO_CTRL_RAM_SEC_STAT_GET:                   /* -------------------- GET SEC STAT ------------------ */
+             p_stat = (FS_DEV_RAM_SEC_STAT *)p_data;
+             if (p_stat->SecNbr >= p_ram_data->Size) {
+                *p_err = FS_ERR_DEV_INVALID_SEC_NBR;
+                 return;
+             }
+             p_stat->RdCtr = p_ram_data->StatSecRdCtrTbl[p_stat->SecNbr];
+             p_stat->WrCtr = p_ram_data->StatSecWrCtrTbl[p_stat->SecNbr];
+            *p_err = FS_ERR_NONE;
+             break;
+
+
+        case FS_DEV_IO_CTRL_RAM_SEC_STAT_CLR:                   /* -------------------- CLR SEC STAT ------------------ */
+             for (sec_ix = 0u; sec_ix < p_ram_data->Size; sec_ix++) {
+                 p_ram_data->StatSecRdCtrTbl[sec_ix] = 0u;
+                 p_ram_data->StatSecWrCtrTbl[sec_ix] = 0u;
+             }
+            *p_err = FS_ERR_NONE;
+             break;
+#endif
+
+
+        case FS_DEV_IO_CTRL_SEC_MAP:                            /* ---------------------- MAP SECS -------------------- */
+             FSDev_RAM_SecMapHandler(p_ram_data, (FS_DEV_SEC_MAP *)p_data, p_err);
+             break;
+
+
+        case FS_DEV_IO_CTRL_RD_SHARED:                          /* ------------------ QUERY SHARED RD ----------------- */
+            *p_err = FS_ERR_NONE;
+             break;
+
+
+        default:                                                /* --------------- UNSUPPORTED I/O CTL ---------------- */
+            *p_err = FS_ERR_DEV_INVALID_IO_CTRL;
+             break;
+    }
 }
 
 
@@ -701,6 +1431,17 @@ static  FS_DEV_RAM_DATA  *FSDev_RAM_DataGet (void)
         }
         (void)alloc_err;
 
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)                 /* Tbls alloc'd on open & kept when data is recycled.   */
+        p_ram_data->ChunkTblSize    =  0u;
+        p_ram_data->ChunkTbl        = (FS_DEV_RAM_CHUNK **)0;
+        p_ram_data->ChunkBaseTbl    = (FS_DEV_RAM_CHUNK  *)0;
+#endif
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+        p_ram_data->StatSecTblSize  =  0u;
+        p_ram_data->StatSecRdCtrTbl = (FS_CTR *)0;
+        p_ram_data->StatSecWrCtrTbl = (FS_CTR *)0;
+#endif
+
         FSDev_RAM_UnitCtr++;
 
 
@@ -716,6 +1457,11 @@ static  FS_DEV_RAM_DATA  *FSDev_RAM_DataGet (void)
     p_ram_data->Size      =  0u;
     p_ram_data->DiskPtr   = (void *)0;
 
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    p_ram_data->ChunkCnt        =  0u;
+    p_ram_data->SnapshotListPtr = (FS_DEV_RAM_SNAPSHOT *)0;
+#endif
+
 #if (FS_CFG_CTR_STAT_EN   == DEF_ENABLED)
     p_ram_data->StatRdCtr =  0u;
     p_ram_data->StatWrCtr =  0u;
@@ -725,3 +1471,647 @@ static  FS_DEV_RAM_DATA  *FSDev_RAM_DataGet (void)
 
     return (p_ram_data);
 }
+
+
+/*
+*********************************************************************************************************
+*                                      FSDev_RAM_SecMapHandler()
+*
+* Description : Get a pointer to the data of RAM disk sectors.
+*
+* Argument(s) : p_ram_data  Pointer to a RAM data object.
+*               ----------  Argument validated by caller.
+*
+*               p_sec_map   Pointer to sector map (see 'fs_dev.h  DEVICE SECTOR MAP DATA TYPE').
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE                   Sectors mapped.
+*                               FS_ERR_DEV_INVALID_SEC_NBR    Sector start or count invalid.
+*                               FS_ERR_DEV_INVALID_OP         Sectors do not lie in the same chunk.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) With snapshots enabled, consecutive sectors are only contiguous in memory within a
+*                   chunk; a range spanning several chunks is not mapped.
+*********************************************************************************************************
+*/
+
+static  void  FSDev_RAM_SecMapHandler (FS_DEV_RAM_DATA  *p_ram_data,
+                                       FS_DEV_SEC_MAP   *p_sec_map,
+                                       FS_ERR           *p_err)
+{
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+    FS_DEV_RAM_CHUNK  *p_chunk;
+    FS_SEC_QTY         chunk_ix;
+    FS_SEC_QTY         chunk_off;
+#endif
+
+
+    if ((p_sec_map->Cnt                    == 0u) ||
+        (p_sec_map->Start + p_sec_map->Cnt >  p_ram_data->Size)) {
+        p_sec_map->DataPtr = (void *)0;
+       *p_err              =  FS_ERR_DEV_INVALID_SEC_NBR;
+        return;
+    }
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)                 /* Map from chunk (see Note #1).                        */
+    chunk_ix  = p_sec_map->Start / FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+    chunk_off = p_sec_map->Start % FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+    if (chunk_off + p_sec_map->Cnt > FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT) {
+        p_sec_map->DataPtr = (void *)0;
+       *p_err              =  FS_ERR_DEV_INVALID_OP;
+        return;
+    }
+
+    p_chunk            =  p_ram_data->ChunkTbl[chunk_ix];
+    p_sec_map->DataPtr = (void *)(p_chunk->DataPtr + (chunk_off * p_ram_data->SecSize));
+#else
+    p_sec_map->DataPtr = (void *)((CPU_INT08U *)(p_ram_data->DiskPtr) + (p_sec_map->Start * p_ram_data->SecSize));
+#endif
+
+   *p_err = FS_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FSDev_RAM_ChunkInit()
+*
+* Description : Initialize the chunk table of a RAM disk.
+*
+* Argument(s) : p_ram_data  Pointer to a RAM data object.
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE         Chunk table initialized.
+*                               FS_ERR_MEM_ALLOC    Memory could not be allocated.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Each entry of the chunk table initially references the base chunk holding the
+*                   corresponding sectors of the disk area.  The last chunk MAY hold fewer than
+*                   FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT sectors.
+*
+*               (2) The tables are kept when the RAM data object is freed & reused if large enough when
+*                   the object is allocated again.  Heap memory cannot be freed, so both tables are
+*                   allocated in a single block; a failed allocation never strands one of them.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void  FSDev_RAM_ChunkInit (FS_DEV_RAM_DATA  *p_ram_data,
+                                   FS_ERR           *p_err)
+{
+    LIB_ERR            alloc_err;
+    CPU_SIZE_T         octets_reqd;
+    CPU_SIZE_T         chunk_size;
+    FS_SEC_QTY         chunk_cnt;
+    FS_SEC_QTY         chunk_ix;
+    FS_DEV_RAM_CHUNK  *p_chunk;
+    CPU_INT08U        *p_disk_08;
+
+
+    chunk_cnt  = (p_ram_data->Size + (FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT - 1u)) / FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+    chunk_size = (CPU_SIZE_T)p_ram_data->SecSize * FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+
+    if (chunk_cnt > p_ram_data->ChunkTblSize) {                 /* Alloc tbls (see Note #2).                            */
+        p_chunk = (FS_DEV_RAM_CHUNK *)Mem_HeapAlloc( chunk_cnt * (sizeof(FS_DEV_RAM_CHUNK) + sizeof(FS_DEV_RAM_CHUNK *)),
+                                                     sizeof(CPU_ALIGN),
+                                                    &octets_reqd,
+                                                    &alloc_err);
+        if (p_chunk == (FS_DEV_RAM_CHUNK *)0) {                 /* Tbls already alloc'd (if any) are kept.              */
+            FS_TRACE_DBG(("FSDev_RAM_ChunkInit(): Could not alloc mem for chunk tbls: %d octets required.\r\n", octets_reqd));
+           *p_err = FS_ERR_MEM_ALLOC;
+            return;
+        }
+        (void)alloc_err;
+
+        p_ram_data->ChunkBaseTbl =  p_chunk;
+        p_ram_data->ChunkTbl     = (FS_DEV_RAM_CHUNK **)(p_chunk + chunk_cnt);
+        p_ram_data->ChunkTblSize =  chunk_cnt;
+    }
+
+                                                                /* Ref base chunks (see Note #1).                       */
+    p_disk_08 = (CPU_INT08U *)p_ram_data->DiskPtr;
+    for (chunk_ix = 0u; chunk_ix < chunk_cnt; chunk_ix++) {
+        p_chunk          = &p_ram_data->ChunkBaseTbl[chunk_ix];
+        p_chunk->DataPtr =  p_disk_08;
+        p_chunk->Size    =  chunk_size;
+        p_chunk->RefCnt  =  1u;
+        p_chunk->Base    =  DEF_YES;
+        p_chunk->NextPtr = (FS_DEV_RAM_CHUNK *)0;
+
+        p_ram_data->ChunkTbl[chunk_ix] = p_chunk;
+        p_disk_08       +=  chunk_size;
+    }
+
+    p_ram_data->ChunkCnt = chunk_cnt;
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        FSDev_RAM_ChunkFlush()
+*
+* Description : Flush the live chunks of a RAM disk to the disk area.
+*
+* Argument(s) : p_ram_data  Pointer to a RAM data object.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Every chunk of the live chunk table NOT being the base chunk of its index is copied to the
+*                   base chunk, then released.  No snapshot may reference the base chunks at that point.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void  FSDev_RAM_ChunkFlush (FS_DEV_RAM_DATA  *p_ram_data)
+{
+    FS_SEC_QTY         chunk_ix;
+    FS_SEC_QTY         sec_cnt;
+    FS_DEV_RAM_CHUNK  *p_chunk;
+    FS_DEV_RAM_CHUNK  *p_chunk_base;
+
+
+    for (chunk_ix = 0u; chunk_ix < p_ram_data->ChunkCnt; chunk_ix++) {
+        p_chunk      =  p_ram_data->ChunkTbl[chunk_ix];
+        p_chunk_base = &p_ram_data->ChunkBaseTbl[chunk_ix];
+        if (p_chunk != p_chunk_base) {
+            sec_cnt = p_ram_data->Size - (chunk_ix * FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT);
+            if (sec_cnt > FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT) {
+                sec_cnt = FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+            }
+
+            Mem_Copy(p_chunk_base->DataPtr,
+                     p_chunk->DataPtr,
+                     (CPU_SIZE_T)sec_cnt * p_ram_data->SecSize);
+
+            FSDev_RAM_ChunkRelease(p_chunk);
+            p_chunk_base->RefCnt           = 1u;
+            p_ram_data->ChunkTbl[chunk_ix] = p_chunk_base;
+        }
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_RAM_ChunkRelease()
+*
+* Description : Release a reference to a chunk.
+*
+* Argument(s) : p_chunk     Pointer to chunk.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) A chunk no longer referenced is returned to the chunk free list, unless it is a base chunk
+*                   (see 'RAM DISK CHUNK DATA TYPE  Note #2').
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void  FSDev_RAM_ChunkRelease (FS_DEV_RAM_CHUNK  *p_chunk)
+{
+    CPU_SR_ALLOC();
+
+
+    p_chunk->RefCnt--;
+    if ((p_chunk->RefCnt == 0u) &&                              /* Free unref'd chunk (see Note #1).                    */
+        (p_chunk->Base   == DEF_NO)) {
+        CPU_CRITICAL_ENTER();
+        p_chunk->NextPtr           = FSDev_RAM_ChunkListFreePtr;
+        FSDev_RAM_ChunkListFreePtr = p_chunk;
+        CPU_CRITICAL_EXIT();
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         FSDev_RAM_ChunkGet()
+*
+* Description : Allocate a chunk.
+*
+* Argument(s) : size        Size of chunk data, in octets.
+*
+* Return(s)   : Pointer to a chunk, if NO errors.
+*               Pointer to NULL,    otherwise.
+*
+* Note(s)     : (1) A chunk of the same size is taken from the chunk free list, if any; otherwise, the chunk &
+*                   its data are allocated from the heap as a single block.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+#if (FS_CFG_RD_ONLY_EN          == DEF_DISABLED)
+static  FS_DEV_RAM_CHUNK  *FSDev_RAM_ChunkGet (CPU_SIZE_T  size)
+{
+    LIB_ERR             alloc_err;
+    CPU_SIZE_T          octets_reqd;
+    FS_DEV_RAM_CHUNK   *p_chunk;
+    FS_DEV_RAM_CHUNK  **pp_chunk;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    pp_chunk = &FSDev_RAM_ChunkListFreePtr;                     /* Srch free list for chunk of same size.               */
+    while (*pp_chunk != (FS_DEV_RAM_CHUNK *)0) {
+        p_chunk = *pp_chunk;
+        if (p_chunk->Size == size) {
+           *pp_chunk = p_chunk->NextPtr;
+            CPU_CRITICAL_EXIT();
+            p_chunk->NextPtr = (FS_DEV_RAM_CHUNK *)0;
+            return (p_chunk);
+        }
+        pp_chunk = &p_chunk->NextPtr;
+    }
+
+    p_chunk = (FS_DEV_RAM_CHUNK *)Mem_HeapAlloc( sizeof(FS_DEV_RAM_CHUNK) + size,
+                                                 sizeof(CPU_ALIGN),
+                                                &octets_reqd,
+                                                &alloc_err);
+    CPU_CRITICAL_EXIT();
+    if (p_chunk == (FS_DEV_RAM_CHUNK *)0) {
+        FS_TRACE_DBG(("FSDev_RAM_ChunkGet(): Could not alloc mem for chunk: %d octets required.\r\n", octets_reqd));
+        return ((FS_DEV_RAM_CHUNK *)0);
+    }
+    (void)alloc_err;
+
+    p_chunk->DataPtr = (CPU_INT08U *)(p_chunk + 1);
+    p_chunk->Size    =  size;
+    p_chunk->RefCnt  =  0u;
+    p_chunk->Base    =  DEF_NO;
+    p_chunk->NextPtr = (FS_DEV_RAM_CHUNK *)0;
+
+    return (p_chunk);
+}
+#endif
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        FSDev_RAM_ChunkWrGet()
+*
+* Description : Get a live chunk that may be written.
+*
+* Argument(s) : p_ram_data  Pointer to a RAM data object.
+*               ----------  Argument validated by caller.
+*
+*               chunk_ix    Index of chunk.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE         Chunk returned.
+*                               FS_ERR_MEM_ALLOC    Memory could not be allocated.
+*
+* Return(s)   : Pointer to chunk, if NO errors.
+*               Pointer to NULL,  otherwise.
+*
+* Note(s)     : (1) A chunk referenced only by the live chunk table is returned as is.  A shared chunk is
+*                   copied; the copy replaces the shared chunk in the live chunk table.
+*
+*               (2) The base chunk of the same index is reused for the copy if no more referenced (e.g., after
+*                   a snapshot was restored); otherwise, a chunk is allocated.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+#if (FS_CFG_RD_ONLY_EN          == DEF_DISABLED)
+static  FS_DEV_RAM_CHUNK  *FSDev_RAM_ChunkWrGet (FS_DEV_RAM_DATA  *p_ram_data,
+                                                 FS_SEC_QTY        chunk_ix,
+                                                 FS_ERR           *p_err)
+{
+    FS_DEV_RAM_CHUNK  *p_chunk;
+    FS_DEV_RAM_CHUNK  *p_chunk_new;
+    FS_SEC_QTY         sec_cnt;
+
+
+    p_chunk = p_ram_data->ChunkTbl[chunk_ix];
+    if (p_chunk->RefCnt > 1u) {                                 /* If chunk shared (see Note #1) ...                    */
+        p_chunk_new = &p_ram_data->ChunkBaseTbl[chunk_ix];      /* ... get chunk for copy      (see Note #2).           */
+        if (p_chunk_new->RefCnt != 0u) {
+            p_chunk_new = FSDev_RAM_ChunkGet(p_chunk->Size);
+            if (p_chunk_new == (FS_DEV_RAM_CHUNK *)0) {
+               *p_err = FS_ERR_MEM_ALLOC;
+                return ((FS_DEV_RAM_CHUNK *)0);
+            }
+        }
+
+        sec_cnt = p_ram_data->Size - (chunk_ix * FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT);
+        if (sec_cnt > FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT) {
+            sec_cnt = FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT;
+        }
+
+        Mem_Copy(p_chunk_new->DataPtr,                          /* ... & copy chunk.                                    */
+                 p_chunk->DataPtr,
+                 (CPU_SIZE_T)sec_cnt * p_ram_data->SecSize);
+
+        p_chunk->RefCnt--;
+        p_chunk_new->RefCnt            = 1u;
+        p_ram_data->ChunkTbl[chunk_ix] = p_chunk_new;
+        p_chunk                        = p_chunk_new;
+    }
+
+   *p_err = FS_ERR_NONE;
+    return (p_chunk);
+}
+#endif
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                   FSDev_RAM_SnapshotTakeHandler()
+*
+* Description : Take a snapshot of a RAM disk.
+*
+* Argument(s) : p_ram_data      Pointer to a RAM data object.
+*               ----------      Argument validated by caller.
+*
+*               pp_snapshot     Pointer to variable that will receive the pointer to the snapshot.
+*               ----------      Argument validated by caller.
+*
+*               p_err           Pointer to variable that will receive the return error code from this function :
+*               ----------      Argument validated by caller.
+*
+*                                   FS_ERR_NONE         Snapshot taken.
+*                                   FS_ERR_MEM_ALLOC    Memory could not be allocated.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) A free snapshot whose chunk table is large enough is reused, if any.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void  FSDev_RAM_SnapshotTakeHandler (FS_DEV_RAM_DATA       *p_ram_data,
+                                             FS_DEV_RAM_SNAPSHOT  **pp_snapshot,
+                                             FS_ERR                *p_err)
+{
+    LIB_ERR                alloc_err;
+    CPU_SIZE_T             octets_reqd;
+    FS_SEC_QTY             chunk_ix;
+    FS_DEV_RAM_CHUNK      *p_chunk;
+    FS_DEV_RAM_SNAPSHOT   *p_snapshot;
+    FS_DEV_RAM_SNAPSHOT  **pp_snapshot_free;
+    CPU_SR_ALLOC();
+
+
+                                                                /* ------------------- ALLOC SNAPSHOT ----------------- */
+    p_snapshot = (FS_DEV_RAM_SNAPSHOT *)0;
+    CPU_CRITICAL_ENTER();
+    pp_snapshot_free = &FSDev_RAM_SnapshotListFreePtr;          /* Srch free list (see Note #1).                        */
+    while (*pp_snapshot_free != (FS_DEV_RAM_SNAPSHOT *)0) {
+        if ((*pp_snapshot_free)->ChunkTblSize >= p_ram_data->ChunkCnt) {
+            p_snapshot        = *pp_snapshot_free;
+           *pp_snapshot_free  =  p_snapshot->NextPtr;
+            break;
+        }
+        pp_snapshot_free = &(*pp_snapshot_free)->NextPtr;
+    }
+
+    if (p_snapshot == (FS_DEV_RAM_SNAPSHOT *)0) {
+        p_snapshot = (FS_DEV_RAM_SNAPSHOT *)Mem_HeapAlloc( sizeof(FS_DEV_RAM_SNAPSHOT) + (p_ram_data->ChunkCnt * sizeof(FS_DEV_RAM_CHUNK *)),
+                                                           sizeof(CPU_ALIGN),
+                                                          &octets_reqd,
+                                                          &alloc_err);
+        if (p_snapshot == (FS_DEV_RAM_SNAPSHOT *)0) {
+            CPU_CRITICAL_EXIT();
+            FS_TRACE_DBG(("FSDev_RAM_SnapshotTake(): Could not alloc mem for snapshot: %d octets required.\r\n", octets_reqd));
+           *p_err = FS_ERR_MEM_ALLOC;
+            return;
+        }
+        (void)alloc_err;
+
+        p_snapshot->ChunkTblSize =  p_ram_data->ChunkCnt;
+        p_snapshot->ChunkTbl     = (FS_DEV_RAM_CHUNK **)(p_snapshot + 1);
+    }
+    CPU_CRITICAL_EXIT();
+
+
+                                                                /* ------------------- SHARE CHUNKS ------------------- */
+    for (chunk_ix = 0u; chunk_ix < p_ram_data->ChunkCnt; chunk_ix++) {
+        p_chunk                        = p_ram_data->ChunkTbl[chunk_ix];
+        p_chunk->RefCnt++;
+        p_snapshot->ChunkTbl[chunk_ix] = p_chunk;
+    }
+
+    p_snapshot->RAM_DataPtr     = p_ram_data;
+    p_snapshot->NextPtr         = p_ram_data->SnapshotListPtr;
+    p_ram_data->SnapshotListPtr = p_snapshot;
+
+   *pp_snapshot = p_snapshot;
+   *p_err       = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                  FSDev_RAM_SnapshotRestoreHandler()
+*
+* Description : Restore a RAM disk from a snapshot.
+*
+* Argument(s) : p_ram_data  Pointer to a RAM data object.
+*               ----------  Argument validated by caller.
+*
+*               p_snapshot  Pointer to snapshot.
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE           Disk restored.
+*                               FS_ERR_INVALID_ARG    Snapshot was not taken of this disk.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The snapshot's chunk is referenced BEFORE the live chunk is released, so that a chunk
+*                   shared by both is never freed.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void  FSDev_RAM_SnapshotRestoreHandler (FS_DEV_RAM_DATA      *p_ram_data,
+                                                FS_DEV_RAM_SNAPSHOT  *p_snapshot,
+                                                FS_ERR               *p_err)
+{
+    FS_SEC_QTY         chunk_ix;
+    FS_DEV_RAM_CHUNK  *p_chunk;
+
+
+    if (p_snapshot->RAM_DataPtr != p_ram_data) {                /* Validate snapshot.                                   */
+       *p_err = FS_ERR_INVALID_ARG;
+        return;
+    }
+
+    for (chunk_ix = 0u; chunk_ix < p_ram_data->ChunkCnt; chunk_ix++) {
+        p_chunk = p_snapshot->ChunkTbl[chunk_ix];
+        p_chunk->RefCnt++;                                      /* See Note #1.                                         */
+        FSDev_RAM_ChunkRelease(p_ram_data->ChunkTbl[chunk_ix]);
+        p_ram_data->ChunkTbl[chunk_ix] = p_chunk;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                    FSDev_RAM_SnapshotDelHandler()
+*
+* Description : Delete a snapshot of a RAM disk.
+*
+* Argument(s) : p_ram_data  Pointer to a RAM data object.
+*               ----------  Argument validated by caller.
+*
+*               p_snapshot  Pointer to snapshot.
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE           Snapshot deleted.
+*                               FS_ERR_INVALID_ARG    Snapshot was not taken of this disk.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void  FSDev_RAM_SnapshotDelHandler (FS_DEV_RAM_DATA      *p_ram_data,
+                                            FS_DEV_RAM_SNAPSHOT  *p_snapshot,
+                                            FS_ERR               *p_err)
+{
+    FS_DEV_RAM_SNAPSHOT  **pp_snapshot;
+    CPU_SR_ALLOC();
+
+
+    pp_snapshot = &p_ram_data->SnapshotListPtr;                 /* Unlink snapshot from disk's list.                    */
+    while ((*pp_snapshot != (FS_DEV_RAM_SNAPSHOT *)0) &&
+           (*pp_snapshot != p_snapshot)) {
+        pp_snapshot = &(*pp_snapshot)->NextPtr;
+    }
+
+    if (*pp_snapshot == (FS_DEV_RAM_SNAPSHOT *)0) {             /* Validate snapshot.                                   */
+       *p_err = FS_ERR_INVALID_ARG;
+        return;
+    }
+   *pp_snapshot = p_snapshot->NextPtr;
+
+    FSDev_RAM_SnapshotRelease(p_snapshot);
+
+    p_snapshot->RAM_DataPtr = (FS_DEV_RAM_DATA *)0;             /* Free snapshot.                                       */
+    CPU_CRITICAL_ENTER();
+    p_snapshot->NextPtr           = FSDev_RAM_SnapshotListFreePtr;
+    FSDev_RAM_SnapshotListFreePtr = p_snapshot;
+    CPU_CRITICAL_EXIT();
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                     FSDev_RAM_SnapshotRelease()
+*
+* Description : Release the chunks referenced by a snapshot.
+*
+* Argument(s) : p_snapshot  Pointer to snapshot.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+static  void  FSDev_RAM_SnapshotRelease (FS_DEV_RAM_SNAPSHOT  *p_snapshot)
+{
+    FS_SEC_QTY  chunk_ix;
+
+
+    for (chunk_ix = 0u; chunk_ix < p_snapshot->RAM_DataPtr->ChunkCnt; chunk_ix++) {
+        FSDev_RAM_ChunkRelease(p_snapshot->ChunkTbl[chunk_ix]);
+        p_snapshot->ChunkTbl[chunk_ix] = (FS_DEV_RAM_CHUNK *)0;
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FSDev_RAM_StatSecInit()
+*
+* Description : Initialize the sector statistics tables of a RAM disk.
+*
+* Argument(s) : p_ram_data  Pointer to a RAM data object.
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE         Tables initialized.
+*                               FS_ERR_MEM_ALLOC    Memory could not be allocated.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) See 'FSDev_RAM_ChunkInit()  Note #2'.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_STAT_SEC_EN == DEF_ENABLED)
+static  void  FSDev_RAM_StatSecInit (FS_DEV_RAM_DATA  *p_ram_data,
+                                     FS_ERR           *p_err)
+{
+    LIB_ERR     alloc_err;
+    CPU_SIZE_T  octets_reqd;
+    FS_SEC_QTY  sec_ix;
+
+
+    if (p_ram_data->Size > p_ram_data->StatSecTblSize) {        /* Alloc tbls (see Note #1).                            */
+        p_ram_data->StatSecRdCtrTbl = (FS_CTR *)Mem_HeapAlloc( 2u * p_ram_data->Size * sizeof(FS_CTR),
+                                                               sizeof(CPU_ALIGN),
+                                                              &octets_reqd,
+                                                              &alloc_err);
+        if (p_ram_data->StatSecRdCtrTbl == (FS_CTR *)0) {
+            FS_TRACE_DBG(("FSDev_RAM_StatSecInit(): Could not alloc mem for sec stat tbls: %d octets required.\r\n", octets_reqd));
+            p_ram_data->StatSecTblSize = 0u;
+           *p_err = FS_ERR_MEM_ALLOC;
+            return;
+        }
+        (void)alloc_err;
+
+        p_ram_data->StatSecWrCtrTbl = p_ram_data->StatSecRdCtrTbl + p_ram_data->Size;
+        p_ram_data->StatSecTblSize  = p_ram_data->Size;
+    } else {
+        p_ram_data->StatSecWrCtrTbl = p_ram_data->StatSecRdCtrTbl + p_ram_data->StatSecTblSize;
+    }
+
+    for (sec_ix = 0u; sec_ix < p_ram_data->Size; sec_ix++) {
+        p_ram_data->StatSecRdCtrTbl[sec_ix] = 0u;
+        p_ram_data->StatSecWrCtrTbl[sec_ix] = 0u;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
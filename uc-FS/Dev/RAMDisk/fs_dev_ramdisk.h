@@ -58,6 +58,25 @@
 #include  "../../Source/fs_dev.h"
 
 
+/*
+*********************************************************************************************************
+*                                        DEFAULT CONFIGURATION
+*********************************************************************************************************
+*/
+
+#ifndef  FS_DEV_RAM_CFG_SNAPSHOT_EN
+#define  FS_DEV_RAM_CFG_SNAPSHOT_EN                 DEF_DISABLED
+#endif
+
+#ifndef  FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT
+#define  FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT               8u
+#endif
+
+#ifndef  FS_DEV_RAM_CFG_STAT_SEC_EN
+#define  FS_DEV_RAM_CFG_STAT_SEC_EN                 DEF_DISABLED
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                               DEFINES
@@ -84,6 +103,36 @@ typedef  struct  fs_dev_ram_cfg {
 } FS_DEV_RAM_CFG;
 
 
+/*
+*********************************************************************************************************
+*                                     RAM DISK SNAPSHOT DATA TYPE
+*
+* Note(s) : (1) A snapshot is an opaque, read-only image of the whole RAM disk, obtained with
+*               FSDev_RAM_SnapshotTake().  See 'fs_dev_ramdisk.c  FSDev_RAM_SnapshotTake()  Note #2'.
+*********************************************************************************************************
+*/
+
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+typedef  struct  fs_dev_ram_snapshot  FS_DEV_RAM_SNAPSHOT;
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                 RAM DISK SECTOR STATISTICS DATA TYPE
+*********************************************************************************************************
+*/
+
+#if ((FS_CFG_CTR_STAT_EN         == DEF_ENABLED) && \
+     (FS_DEV_RAM_CFG_STAT_SEC_EN == DEF_ENABLED))
+typedef  struct  fs_dev_ram_sec_stat {
+    FS_SEC_NBR    SecNbr;                                       /* Sec nbr.                                             */
+    FS_CTR        RdCtr;                                        /* Nbr of rds of sec.                                   */
+    FS_CTR        WrCtr;                                        /* Nbr of wrs of sec.                                   */
+} FS_DEV_RAM_SEC_STAT;
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                          GLOBAL VARIABLES
@@ -107,6 +156,30 @@ FS_DEV_RAM_EXT         FS_CTR      FSDev_RAM_UnitCtr;
 *********************************************************************************************************
 */
 
+#if (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+FS_DEV_RAM_SNAPSHOT  *FSDev_RAM_SnapshotTake   (CPU_CHAR             *name_dev,     /* Take snapshot of RAM disk.       */
+                                                FS_ERR               *p_err);
+
+void                  FSDev_RAM_SnapshotRestore(CPU_CHAR             *name_dev,     /* Restore RAM disk from snapshot.  */
+                                                FS_DEV_RAM_SNAPSHOT  *p_snapshot,
+                                                FS_ERR               *p_err);
+
+void                  FSDev_RAM_SnapshotDel    (CPU_CHAR             *name_dev,     /* Delete snapshot.                 */
+                                                FS_DEV_RAM_SNAPSHOT  *p_snapshot,
+                                                FS_ERR               *p_err);
+#endif
+
+#if ((FS_CFG_CTR_STAT_EN         == DEF_ENABLED) && \
+     (FS_DEV_RAM_CFG_STAT_SEC_EN == DEF_ENABLED))
+void                  FSDev_RAM_SecStatGet     (CPU_CHAR             *name_dev,     /* Get rd/wr ctrs of sec.           */
+                                                FS_SEC_NBR            sec_nbr,
+                                                FS_DEV_RAM_SEC_STAT  *p_stat,
+                                                FS_ERR               *p_err);
+
+void                  FSDev_RAM_SecStatClr     (CPU_CHAR             *name_dev,     /* Clr rd/wr ctrs of all secs.      */
+                                                FS_ERR               *p_err);
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -114,6 +187,37 @@ FS_DEV_RAM_EXT         FS_CTR      FSDev_RAM_UnitCtr;
 *********************************************************************************************************
 */
 
+#ifndef  FS_DEV_RAM_CFG_SNAPSHOT_EN
+#error  "FS_DEV_RAM_CFG_SNAPSHOT_EN            not #define'd in 'app_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED]           "
+#error  "                                [     ||  DEF_ENABLED ]           "
+
+#elif  ((FS_DEV_RAM_CFG_SNAPSHOT_EN != DEF_DISABLED) && \
+        (FS_DEV_RAM_CFG_SNAPSHOT_EN != DEF_ENABLED ))
+#error  "FS_DEV_RAM_CFG_SNAPSHOT_EN      illegally #define'd in 'app_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED]           "
+#error  "                                [     ||  DEF_ENABLED ]           "
+
+#elif   (FS_DEV_RAM_CFG_SNAPSHOT_EN == DEF_ENABLED)
+#if     (FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT < 1u)
+#error  "FS_DEV_RAM_CFG_SNAPSHOT_CHUNK_SEC_CNT illegally #define'd in 'app_cfg.h'"
+#error  "                                [MUST be  >= 1]                   "
+#endif
+#endif
+
+
+#ifndef  FS_DEV_RAM_CFG_STAT_SEC_EN
+#error  "FS_DEV_RAM_CFG_STAT_SEC_EN            not #define'd in 'app_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED]           "
+#error  "                                [     ||  DEF_ENABLED ]           "
+
+#elif  ((FS_DEV_RAM_CFG_STAT_SEC_EN != DEF_DISABLED) && \
+        (FS_DEV_RAM_CFG_STAT_SEC_EN != DEF_ENABLED ))
+#error  "FS_DEV_RAM_CFG_STAT_SEC_EN      illegally #define'd in 'app_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED]           "
+#error  "                                [     ||  DEF_ENABLED ]           "
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -107,6 +107,9 @@
 #define  FS_FAT_MAX_SIZE_FAT12                       4394304u   /*   4 Mbytes                                           */
 #define  FS_FAT_MAX_SIZE_FAT16                     536870912u   /* 512 Mbytes                                           */
 
+#define  FS_FAT_CLUS_BITMAP_WORD_NBR_BITS                 32u   /* Nbr of clus's per clus bitmap word.                  */
+#define  FS_FAT_CLUS_BITMAP_WORD_FULL             0xFFFFFFFFu   /* Clus bitmap word with no free clus.                  */
+
 
 /*
 *********************************************************************************************************
@@ -248,6 +251,10 @@ static  const  FS_FAT_TBL_ENTRY  FS_FAT_TblFAT32[7]   = {{     66600u,  0u},
 
 static  MEM_POOL  FS_FAT_DataPool;
 
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+static  MEM_POOL  FS_FAT_ClusBitmapPool;
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -305,6 +312,29 @@ static  void  FS_FAT_FileDataInit       (FS_FAT_FILE_DATA  *p_entry_data,   /* I
 
 static  void  FS_FAT_DataClr            (FS_FAT_DATA       *p_fat_data);    /* Clr FAT info struct.                         */
 
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  CPU_BOOLEAN  FS_FAT_ClusAllocAvoid      (FS_FAT_DATA      *p_fat_data,  /* Chk if clus must NOT be alloc'd.         */
+                                                 FS_FAT_CLUS_NBR   clus);
+#endif
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+static  void             FS_FAT_ClusBitmapOpen  (FS_VOL           *p_vol,       /* Build clus bitmap.                       */
+                                                 FS_ERR           *p_err);
+
+static  void             FS_FAT_ClusBitmapClose (FS_VOL           *p_vol);      /* Free clus bitmap.                        */
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  FS_FAT_CLUS_NBR  FS_FAT_ClusBitmapSrch  (FS_FAT_DATA      *p_fat_data,  /* Srch clus bitmap for free clus run.      */
+                                                 FS_FAT_CLUS_NBR   start_clus,
+                                                 FS_FAT_CLUS_NBR   end_clus,
+                                                 FS_FAT_CLUS_NBR   nbr_clus);
+
+static  void             FS_FAT_ClusBitmapHint  (FS_FAT_DATA      *p_fat_data,  /* Set next clus to start of free run.      */
+                                                 FS_FAT_CLUS_NBR   prev_clus,
+                                                 FS_FAT_CLUS_NBR   nbr_clus);
+#endif
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -693,6 +723,11 @@ void  FS_FAT_VolChk (CPU_CHAR  *name_vol,
 *
 * Note(s)     : (1) Uncompleted allocations are rewinded using reverse deletion. By doing so, we make sure
 *                   deletion can always be completed after a potential failure (even without journaling).
+*
+*               (2) If the volume has a cluster bitmap, the next cluster to allocate is first moved to the
+*                   start of a run of free clusters large enough for the whole allocation, so that the
+*                   clusters found by FS_FAT_ClusFreeFind() are contiguous.  An existing chain is preferably
+*                   extended right after its last cluster.
 *********************************************************************************************************
 */
 
@@ -724,6 +759,9 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusChainAlloc (FS_VOL           *p_vol,
 
                                                                 /* ----------------- FIND START CLUS ------------------ */
     if (start_clus == 0u) {                                     /* If new chain, find start clus.                       */
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+        FS_FAT_ClusBitmapHint(p_fat_data, 0u, nbr_clus);        /* Find run of free clus's (see Note #2).               */
+#endif
         start_clus = FS_FAT_ClusFreeFind(p_vol,
                                          p_buf,
                                          p_err);
@@ -772,6 +810,12 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusChainAlloc (FS_VOL           *p_vol,
 
     }                                                           /* Otherwise, clus is EOC or not alloc'd.               */
 
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    if (is_new_chain == DEF_NO) {                               /* Find run of free clus's (see Note #2).               */
+        FS_FAT_ClusBitmapHint(p_fat_data, start_clus, rem_clus);
+    }
+#endif
+
 
                                                                 /* ------------------- ENTER JOURNAL ------------------ */
 #ifdef  FS_FAT_JOURNAL_MODULE_PRESENT
@@ -825,6 +869,9 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusChainAlloc (FS_VOL           *p_vol,
         if (*p_err != FS_ERR_NONE) {
             return (0u);
         }
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+        FS_FAT_ClusBitmapSet(p_fat_data, cur_clus, DEF_YES);
+#endif
 
         cur_clus = next_clus;
         rem_clus--;
@@ -838,6 +885,9 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusChainAlloc (FS_VOL           *p_vol,
     if (*p_err != FS_ERR_NONE) {
         return (0u);
     }
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    FS_FAT_ClusBitmapSet(p_fat_data, cur_clus, DEF_YES);
+#endif
 
 
                                                                 /* ------------------- UPDATE & RTN ------------------- */
@@ -1007,6 +1057,11 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusChainDel (FS_VOL           *p_vol,
         if (*p_err != FS_ERR_NONE) {
             return (0u);
         }
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+        FS_FAT_ClusBitmapSet(p_fat_data,
+                             cur_clus,
+                            (new_fat_entry != p_fat_data->FAT_TypeAPI_Ptr->ClusFree) ? DEF_YES : DEF_NO);
+#endif
 
         cur_clus  = next_clus;                                  /* Update cur clus.                                     */
 
@@ -1144,6 +1199,11 @@ void  FS_FAT_ClusChainReverseDel (FS_VOL           *p_vol,
         if (*p_err != FS_ERR_NONE) {
             return;
         }
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+        FS_FAT_ClusBitmapSet(p_fat_data,
+                             cur_clus,
+                            (new_fat_entry != p_fat_data->FAT_TypeAPI_Ptr->ClusFree) ? DEF_YES : DEF_NO);
+#endif
 
     } while ( start_clus != cur_clus);                          /* Start over until start clus has been del'd.          */
 
@@ -1436,7 +1496,9 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusChainReverseFollow (FS_VOL           *p_vol,
 *
 * Note(s)     : (1) In order for journaling to behave as expected, FAT entry updates must be atomic.
 *                   To ensure this is the case when using FAT12, cross-boundary FAT entries must be
-*                   avoided.
+*                   avoided (see 'FS_FAT_ClusAllocAvoid()').
+*
+*               (2) If the volume has a cluster bitmap, the bitmap is searched instead of the FAT.
 *********************************************************************************************************
 */
 
@@ -1451,9 +1513,8 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusFreeFind (FS_VOL  *p_vol,
     FS_FAT_CLUS_NBR   clus_cnt_chkd;
     FS_FAT_CLUS_NBR   max_nbr_clus;
     CPU_BOOLEAN       clus_ignore;
-#if ((FS_FAT_CFG_FAT12_EN == DEF_ENABLED) && (FS_FAT_CFG_JOURNAL_EN == DEF_ENABLED))
-    FS_SEC_SIZE       fat_offset;
-    FS_SEC_SIZE       fat_sec_offset;
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    FS_FAT_CLUS_NBR   free_clus;
 #endif
 
 
@@ -1463,6 +1524,32 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusFreeFind (FS_VOL  *p_vol,
     clus_cnt_chkd  =  0u;
 
 
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    if (p_fat_data->ClusBitmapPtr != (CPU_INT32U *)0) {         /* --------------- FREE CLUS BITMAP SRCH -------------- */
+        if ((next_clus <  FS_FAT_MIN_CLUS_NBR) ||               /* See Note #2.                                         */
+            (next_clus >= p_fat_data->MaxClusNbr)) {
+            next_clus  = FS_FAT_MIN_CLUS_NBR;
+        }
+                                                                /* Srch from next clus to end of FAT ...                */
+        free_clus = FS_FAT_ClusBitmapSrch(p_fat_data, next_clus, p_fat_data->MaxClusNbr, 1u);
+        if (free_clus == 0u) {                                  /* ... & wrap to start of FAT.                          */
+            free_clus = FS_FAT_ClusBitmapSrch(p_fat_data, FS_FAT_MIN_CLUS_NBR, next_clus, 1u);
+        }
+
+        if (free_clus == 0u) {
+           *p_err = FS_ERR_DEV_FULL;
+            FS_TRACE_DBG(("FS_FAT_ClusFreeFind(): No free FAT clus could be found.\r\n"));
+            return (0u);
+        }
+
+        p_fat_data->NextClusNbr = free_clus + 1u;
+        FS_TRACE_LOG(("FS_FAT_ClusFreeFind(): New FAT clus alloc'd: %d.\r\n", free_clus));
+       *p_err = FS_ERR_NONE;
+        return (free_clus);
+    }
+#endif
+
+
                                                                 /* ----------------- FREE CLUS LOOKUP ----------------- */
     while (clus_cnt_chkd < max_nbr_clus) {
         if (next_clus >= p_fat_data->MaxClusNbr) {              /* Wrap clus nbr.                                       */
@@ -1482,18 +1569,8 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusFreeFind (FS_VOL  *p_vol,
 
                                                                 /* ----------------- FREE CLUS FOUND ------------------ */
         if (fat_entry == p_fat_data->FAT_TypeAPI_Ptr->ClusFree) {   /* Chk if free clus found.                          */
-            clus_ignore = DEF_NO;                                   /* Clus not ignore'd by dflt.                       */
-#if ((FS_FAT_CFG_FAT12_EN == DEF_ENABLED) && (FS_FAT_CFG_JOURNAL_EN == DEF_ENABLED))
-            if ((p_fat_data->FAT_Type     == 12u) &&                /* If FAT12 and journal started ...                 */
-                (DEF_BIT_IS_SET(p_fat_data->JournalState, FS_FAT_JOURNAL_STATE_START) == DEF_YES)) {
-                fat_offset     = (FS_SEC_SIZE)next_clus + ((FS_SEC_SIZE)next_clus / 2u);
-                fat_sec_offset =  fat_offset & (p_fat_data->SecSize - 1u);
-                if (fat_sec_offset == p_fat_data->SecSize - 1u) {  /* ... avoid sec boundary (see Note #1) ...          */
-                    FS_TRACE_LOG(("FS_FAT_ClusFreeFind(): Sec boundary clus avoided: %d.\r\n", next_clus));
-                    clus_ignore = DEF_YES;
-                }
-            }
-#endif
+            clus_ignore = FS_FAT_ClusAllocAvoid(p_fat_data,         /* Avoid sec boundary clus (see Note #1) ...        */
+                                                next_clus);
             if (clus_ignore == DEF_NO) {
                 p_fat_data->NextClusNbr = next_clus + 1u;       /* ... else store next clus ...                         */
                 FS_TRACE_LOG(("FS_FAT_ClusFreeFind(): New FAT clus alloc'd: %d.\r\n", next_clus));
@@ -1515,6 +1592,69 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusFreeFind (FS_VOL  *p_vol,
 #endif
 
 
+/*
+*********************************************************************************************************
+*                                       FS_FAT_ClusBitmapSet()
+*
+* Description : Update the state of a cluster in the cluster bitmap.
+*
+* Argument(s) : p_fat_data  Pointer to FAT info.
+*
+*               clus        Cluster whose FAT entry was written.
+*
+*               used        Indicates whether the cluster is in use :
+*
+*                               DEF_NO,  if the FAT entry was set to free.
+*                               DEF_YES, otherwise.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) MUST be called after every successful write of a FAT entry.  A volume without a
+*                   cluster bitmap is ignored.
+*
+*               (2) The summary bit of a bitmap word is set when none of the word's clusters is free, so
+*                   that searches may skip full words without reading them.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+void  FS_FAT_ClusBitmapSet (FS_FAT_DATA      *p_fat_data,
+                            FS_FAT_CLUS_NBR   clus,
+                            CPU_BOOLEAN       used)
+{
+    FS_FAT_CLUS_NBR   word_ix;
+    CPU_INT32U        bit;
+    CPU_INT32U        sum_bit;
+    CPU_INT32U       *p_word;
+    CPU_INT32U       *p_sum;
+
+
+    if (p_fat_data->ClusBitmapPtr == (CPU_INT32U *)0) {         /* See Note #1.                                         */
+        return;
+    }
+    if (clus >= p_fat_data->MaxClusNbr) {
+        return;
+    }
+
+    word_ix =  clus / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS;
+    bit     = (CPU_INT32U)DEF_BIT(clus    % FS_FAT_CLUS_BITMAP_WORD_NBR_BITS);
+    sum_bit = (CPU_INT32U)DEF_BIT(word_ix % FS_FAT_CLUS_BITMAP_WORD_NBR_BITS);
+    p_word  = &p_fat_data->ClusBitmapPtr[word_ix];
+    p_sum   = &p_fat_data->ClusBitmapSumPtr[word_ix / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS];
+
+    if (used == DEF_YES) {
+       *p_word |= bit;
+        if (*p_word == FS_FAT_CLUS_BITMAP_WORD_FULL) {          /* Mark word full in summary (see Note #2).             */
+           *p_sum |= sum_bit;
+        }
+    } else {
+       *p_word &= ~bit;
+       *p_sum  &= ~sum_bit;
+    }
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                       FS_FAT_ClusNextGet()
@@ -2137,6 +2277,35 @@ void  FS_FAT_ModuleInit (FS_QTY   vol_cnt,
     }
 #endif
 
+
+
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT                      /* ------------- INIT FAT12 MIRROR MODULE ------------- */
+    FS_FAT_FAT12_MirrorModuleInit(vol_cnt, p_err);
+
+    if (*p_err != FS_ERR_NONE) {
+        return;
+    }
+#endif
+
+
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT                       /* ------------- CREATE CLUS BITMAP POOL -------------- */
+    Mem_PoolCreate(&FS_FAT_ClusBitmapPool,
+                    DEF_NULL,
+                    0,
+                    vol_cnt,
+                    FS_FAT_CFG_CLUS_BITMAP_SIZE,
+                    sizeof(CPU_ALIGN),
+                   &octets_reqd,
+                   &pool_err);
+
+    if (pool_err != LIB_MEM_ERR_NONE) {
+       *p_err = FS_ERR_MEM_ALLOC;
+        FS_TRACE_INFO(("FS_FAT_ModuleInit(): Could not alloc mem for clus bitmaps: %d octets req'd.\r\n", octets_reqd));
+        return;
+    }
+#endif
+
    *p_err = FS_ERR_NONE;
 }
 
@@ -2171,6 +2340,14 @@ void  FS_FAT_VolClose (FS_VOL  *p_vol)
     }
 #endif
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+    FS_FAT_FAT12_MirrorClose(p_vol);                            /* Free FAT12 mirror.                                   */
+#endif
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    FS_FAT_ClusBitmapClose(p_vol);                              /* Free clus bitmap.                                    */
+#endif
+
 
 
                                                                 /* ------------------- FREE FAT DATA ------------------ */
@@ -3041,6 +3218,9 @@ void  FS_FAT_VolLabelSet (FS_VOL    *p_vol,
 * Return(s)   : none.
 *
 * Note(s)     : (1) The file system lock MUST be held to get the FAT data from the FAT data pool.
+*
+*               (2) The FAT12 mirror & the cluster bitmap MUST be set up before the journal is initialized,
+*                   so that FAT entries modified while replaying the journal are also updated in both.
 *********************************************************************************************************
 */
 
@@ -3128,10 +3308,47 @@ void  FS_FAT_VolOpen (FS_VOL  *p_vol,
                                                                 /* ------------------ ALLOC FAT DATA ------------------ */
     p_vol->DataPtr = (void *)p_fat_data;                        /* Save FAT data in vol.                                */
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+    FS_FAT_FAT12_MirrorOpen(p_vol, p_err);                      /* Load FAT12 mirror (see Note #2).                     */
+
+    if (*p_err != FS_ERR_NONE) {
+        FS_OS_Lock(&err_tmp);
+        Mem_PoolBlkFree(        &FS_FAT_DataPool,               /* ... & free FAT data.                                 */
+                        (void *) p_fat_data,
+                                &pool_err);
+        FS_OS_Unlock();
+        p_vol->DataPtr = (void *)0;
+        return;
+    }
+#endif
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    FS_FAT_ClusBitmapOpen(p_vol, p_err);                        /* Build clus bitmap (see Note #2).                     */
+
+    if (*p_err != FS_ERR_NONE) {
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+        FS_FAT_FAT12_MirrorClose(p_vol);
+#endif
+        FS_OS_Lock(&err_tmp);
+        Mem_PoolBlkFree(        &FS_FAT_DataPool,               /* ... & free FAT data.                                 */
+                        (void *) p_fat_data,
+                                &pool_err);
+        FS_OS_Unlock();
+        p_vol->DataPtr = (void *)0;
+        return;
+    }
+#endif
+
 #ifdef  FS_FAT_JOURNAL_MODULE_PRESENT
     FS_FAT_JournalInit(p_vol, p_err);                           /* Init journal info.                                   */
 
     if (*p_err != FS_ERR_NONE) {
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+        FS_FAT_FAT12_MirrorClose(p_vol);
+#endif
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+        FS_FAT_ClusBitmapClose(p_vol);
+#endif
         FS_OS_Lock(&err_tmp);
         Mem_PoolBlkFree(        &FS_FAT_DataPool,               /* ... & free FAT data.                                 */
                         (void *) p_fat_data,
@@ -3247,7 +3464,9 @@ void  FS_FAT_VolQuery (FS_VOL       *p_vol,
 *
 * Return(s)   : none.
 *
-* Note(s)     : none.
+* Note(s)     : (1) The entry of a self-journaled file is NOT logged to the journal : the update is a
+*                   single in-place sector write & the file's user recovers its own content (see
+*                  'FSFile_Open()  Note #6').
 *********************************************************************************************************
 */
 
@@ -3275,7 +3494,8 @@ void  FS_FAT_LowEntryUpdate (FS_VOL            *p_vol,
                                                                 /* ------------------- ENTER JOURNAL ------------------ */
 #ifdef  FS_FAT_JOURNAL_MODULE_PRESENT
    p_fat_data = (FS_FAT_DATA *)p_vol->DataPtr;
-   if (DEF_BIT_IS_SET(p_fat_data->JournalState, FS_FAT_JOURNAL_STATE_REPLAY) == DEF_NO) {
+   if ((DEF_BIT_IS_SET(p_fat_data->JournalState, FS_FAT_JOURNAL_STATE_REPLAY) == DEF_NO) &&
+       (DEF_BIT_IS_CLR(p_entry_data->Mode,       FS_FAT_MODE_SELF_JOURNAL)    == DEF_YES)) {   /* See Note #1.     */
        dir_end_pos.SecNbr = p_entry_data->DirEndSec;
        dir_end_pos.SecPos = p_entry_data->DirEndSecPos;
        FS_FAT_JournalEnterEntryUpdate(p_vol,
@@ -3327,6 +3547,9 @@ void  FS_FAT_LowEntryUpdate (FS_VOL            *p_vol,
     if (*p_err != FS_ERR_NONE) {
          return;
     }
+
+    p_entry_data->EntryFileSize  = p_entry_data->FileSize;
+    p_entry_data->EntryFirstClus = p_entry_data->FileFirstClus;
 }
 #endif
 
@@ -5696,6 +5919,400 @@ static  void  FS_FAT_ChkFile (FS_VOL            *p_vol,
 #endif
 
 
+/*
+*********************************************************************************************************
+*                                       FS_FAT_ClusAllocAvoid()
+*
+* Description : Check whether a free cluster must be skipped by the cluster allocator.
+*
+* Argument(s) : p_fat_data  Pointer to FAT info.
+*
+*               clus        Free cluster.
+*
+* Return(s)   : DEF_YES, if the cluster must NOT be allocated.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : (1) See 'FS_FAT_ClusFreeFind()  Note #1'.  While the journal is started, FAT12 clusters
+*                   whose FAT entry crosses a sector boundary are avoided.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  CPU_BOOLEAN  FS_FAT_ClusAllocAvoid (FS_FAT_DATA      *p_fat_data,
+                                            FS_FAT_CLUS_NBR   clus)
+{
+#if ((FS_FAT_CFG_FAT12_EN == DEF_ENABLED) && (FS_FAT_CFG_JOURNAL_EN == DEF_ENABLED))
+    FS_SEC_SIZE  fat_offset;
+    FS_SEC_SIZE  fat_sec_offset;
+
+
+    if ((p_fat_data->FAT_Type     == 12u) &&                    /* If FAT12 and journal started ...                     */
+        (DEF_BIT_IS_SET(p_fat_data->JournalState, FS_FAT_JOURNAL_STATE_START) == DEF_YES)) {
+        fat_offset     = (FS_SEC_SIZE)clus + ((FS_SEC_SIZE)clus / 2u);
+        fat_sec_offset =  fat_offset & (p_fat_data->SecSize - 1u);
+        if (fat_sec_offset == p_fat_data->SecSize - 1u) {       /* ... avoid sec boundary (see Note #1).                */
+            FS_TRACE_LOG(("FS_FAT_ClusAllocAvoid(): Sec boundary clus avoided: %d.\r\n", clus));
+            return (DEF_YES);
+        }
+    }
+#else
+    (void)p_fat_data;
+    (void)clus;
+#endif
+
+    return (DEF_NO);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FS_FAT_ClusBitmapOpen()
+*
+* Description : Allocate & build the cluster bitmap of a volume.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE              Bitmap built OR volume accessed without bitmap.
+*                               FS_ERR_BUF_NONE_AVAIL    No buffer available.
+*                               FS_ERR_DEV               Device access error.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) A volume whose bitmap (& summary) does not fit in FS_FAT_CFG_CLUS_BITMAP_SIZE octets, or
+*                   a volume opened when no bitmap is left in the pool, is accessed without bitmap.
+*
+*               (2) Clusters 0 & 1, as well as the bits past the last cluster, are marked in use so that
+*                   they are never found by a search.
+*
+*               (3) Since the whole FAT is read, the free & bad cluster counts returned by FS_FAT_Query()
+*                   are computed at the same time.
+*
+*               (4) The file system lock MUST be held to get the bitmap from the bitmap pool.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+static  void  FS_FAT_ClusBitmapOpen (FS_VOL  *p_vol,
+                                     FS_ERR  *p_err)
+{
+    FS_FAT_DATA      *p_fat_data;
+    FS_BUF           *p_buf;
+    CPU_INT32U       *p_bitmap;
+    CPU_INT32U       *p_sum;
+    FS_FAT_CLUS_NBR   word_cnt;
+    FS_FAT_CLUS_NBR   sum_cnt;
+    FS_FAT_CLUS_NBR   word_ix;
+    FS_FAT_CLUS_NBR   clus;
+    FS_FAT_CLUS_NBR   fat_entry;
+    FS_FAT_CLUS_NBR   bad_clus_cnt;
+    FS_FAT_CLUS_NBR   free_clus_cnt;
+    LIB_ERR           pool_err;
+
+
+    p_fat_data = (FS_FAT_DATA *)p_vol->DataPtr;
+    word_cnt   = (p_fat_data->MaxClusNbr + FS_FAT_CLUS_BITMAP_WORD_NBR_BITS - 1u) / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS;
+    sum_cnt    = (word_cnt               + FS_FAT_CLUS_BITMAP_WORD_NBR_BITS - 1u) / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS;
+
+    if ((word_cnt + sum_cnt) > (FS_FAT_CFG_CLUS_BITMAP_SIZE / sizeof(CPU_INT32U))) {
+        FS_TRACE_DBG(("FS_FAT_ClusBitmapOpen(): %d clus's too many for bitmap; bitmap NOT used.\r\n", p_fat_data->MaxClusNbr));
+       *p_err = FS_ERR_NONE;                                    /* See Note #1.                                         */
+        return;
+    }
+
+                                                                /* ------------------- ALLOC BITMAP ------------------- */
+    FS_OS_Lock(p_err);                                          /* Acquire FS lock (see Note #4).                       */
+    if (*p_err != FS_ERR_NONE) {
+        return;
+    }
+
+    p_bitmap = (CPU_INT32U *)Mem_PoolBlkGet(&FS_FAT_ClusBitmapPool,
+                                             FS_FAT_CFG_CLUS_BITMAP_SIZE,
+                                            &pool_err);
+    (void)pool_err;                                            /* Err ignored. Ret val chk'd instead.                  */
+    FS_OS_Unlock();
+
+    if (p_bitmap == (CPU_INT32U *)0) {                          /* No bitmap avail (see Note #1).                       */
+       *p_err = FS_ERR_NONE;
+        return;
+    }
+
+    p_sum = p_bitmap + word_cnt;
+    Mem_Clr((void *)p_bitmap, (word_cnt + sum_cnt) * sizeof(CPU_INT32U));
+
+    p_fat_data->ClusBitmapPtr     = p_bitmap;
+    p_fat_data->ClusBitmapSumPtr  = p_sum;
+    p_fat_data->ClusBitmapWordCnt = word_cnt;
+
+
+                                                                /* -------------------- BUILD BITMAP ------------------ */
+    p_buf = FSBuf_Get(p_vol);
+    if (p_buf == (FS_BUF *)0) {
+        FS_FAT_ClusBitmapClose(p_vol);
+       *p_err = FS_ERR_BUF_NONE_AVAIL;
+        return;
+    }
+
+    bad_clus_cnt  = 0u;
+    free_clus_cnt = 0u;
+    for (clus = 0u; clus < word_cnt * FS_FAT_CLUS_BITMAP_WORD_NBR_BITS; clus++) {
+        if ((clus <  FS_FAT_MIN_CLUS_NBR) ||                    /* Rsvd clus's are in use (see Note #2).                */
+            (clus >= p_fat_data->MaxClusNbr)) {
+            fat_entry = p_fat_data->FAT_TypeAPI_Ptr->ClusEOF;
+        } else {
+            fat_entry = p_fat_data->FAT_TypeAPI_Ptr->ClusValRd(p_vol,
+                                                               p_buf,
+                                                               clus,
+                                                               p_err);
+            if (*p_err != FS_ERR_NONE) {
+                FSBuf_Free(p_buf);
+                FS_FAT_ClusBitmapClose(p_vol);
+                return;
+            }
+
+            if (fat_entry == p_fat_data->FAT_TypeAPI_Ptr->ClusFree) {
+                free_clus_cnt++;
+            } else if (fat_entry == p_fat_data->FAT_TypeAPI_Ptr->ClusBad) {
+                bad_clus_cnt++;
+            } else {
+                ;
+            }
+        }
+
+        if (fat_entry != p_fat_data->FAT_TypeAPI_Ptr->ClusFree) {
+            p_bitmap[clus / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS] |= (CPU_INT32U)DEF_BIT(clus % FS_FAT_CLUS_BITMAP_WORD_NBR_BITS);
+        }
+    }
+
+    FSBuf_Free(p_buf);
+
+    for (word_ix = 0u; word_ix < sum_cnt * FS_FAT_CLUS_BITMAP_WORD_NBR_BITS; word_ix++) {
+        if ((word_ix >= word_cnt) ||                            /* Mark full & inexistent words in summary.             */
+            (p_bitmap[word_ix] == FS_FAT_CLUS_BITMAP_WORD_FULL)) {
+            p_sum[word_ix / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS] |= (CPU_INT32U)DEF_BIT(word_ix % FS_FAT_CLUS_BITMAP_WORD_NBR_BITS);
+        }
+    }
+
+    p_fat_data->QueryInfoValid   = DEF_YES;                     /* See Note #3.                                         */
+    p_fat_data->QueryBadClusCnt  = bad_clus_cnt;
+    p_fat_data->QueryFreeClusCnt = free_clus_cnt;
+
+    FS_TRACE_LOG(("FS_FAT_ClusBitmapOpen(): Bitmap built: %d free clus's.\r\n", free_clus_cnt));
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      FS_FAT_ClusBitmapClose()
+*
+* Description : Free the cluster bitmap of a volume.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The file system lock MUST be held to release the bitmap back to the bitmap pool.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+static  void  FS_FAT_ClusBitmapClose (FS_VOL  *p_vol)
+{
+    FS_FAT_DATA  *p_fat_data;
+    FS_ERR        err;
+    LIB_ERR       pool_err;
+
+
+    p_fat_data = (FS_FAT_DATA *)p_vol->DataPtr;
+    if (p_fat_data->ClusBitmapPtr == (CPU_INT32U *)0) {
+        return;
+    }
+
+    FS_OS_Lock(&err);                                           /* Acquire FS lock (see Note #1).                       */
+    if (err != FS_ERR_NONE) {
+        return;
+    }
+
+    Mem_PoolBlkFree(        &FS_FAT_ClusBitmapPool,             /* Free bitmap.                                         */
+                    (void *) p_fat_data->ClusBitmapPtr,
+                            &pool_err);
+    FS_OS_Unlock();
+
+    if (pool_err != LIB_MEM_ERR_NONE) {
+        CPU_SW_EXCEPTION(;);                                    /* Fatal err.                                           */
+    }
+
+    p_fat_data->ClusBitmapPtr     = (CPU_INT32U *)0;
+    p_fat_data->ClusBitmapSumPtr  = (CPU_INT32U *)0;
+    p_fat_data->ClusBitmapWordCnt =  0u;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FS_FAT_ClusBitmapSrch()
+*
+* Description : Search the cluster bitmap for a run of free clusters.
+*
+* Argument(s) : p_fat_data  Pointer to FAT info.
+*
+*               start_clus  First cluster to check.
+*
+*               end_clus    Cluster following the last cluster to check.
+*
+*               nbr_clus    Number of contiguous free clusters to find.
+*
+* Return(s)   : First cluster of the first run of 'nbr_clus' free clusters within [start_clus, end_clus),
+*               if any.
+*               0,  otherwise.
+*
+* Note(s)     : (1) Full bitmap words are skipped without examining their bits.  When all words covered by a
+*                   summary word are full, the whole group of words is skipped.
+*
+*               (2) Clusters that the allocator must avoid (see 'FS_FAT_ClusAllocAvoid()') break a run.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  FS_FAT_CLUS_NBR  FS_FAT_ClusBitmapSrch (FS_FAT_DATA      *p_fat_data,
+                                                FS_FAT_CLUS_NBR   start_clus,
+                                                FS_FAT_CLUS_NBR   end_clus,
+                                                FS_FAT_CLUS_NBR   nbr_clus)
+{
+    FS_FAT_CLUS_NBR   clus;
+    FS_FAT_CLUS_NBR   word_ix;
+    FS_FAT_CLUS_NBR   run_start;
+    FS_FAT_CLUS_NBR   run_len;
+    FS_FAT_CLUS_NBR   grp_nbr_clus;
+    CPU_INT32U        word;
+
+
+    grp_nbr_clus = FS_FAT_CLUS_BITMAP_WORD_NBR_BITS * FS_FAT_CLUS_BITMAP_WORD_NBR_BITS;
+    run_start    = 0u;
+    run_len      = 0u;
+    clus         = start_clus;
+
+    while (clus < end_clus) {
+        word_ix = clus / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS;
+
+        if ((clus % FS_FAT_CLUS_BITMAP_WORD_NBR_BITS) == 0u) {  /* ----------- SKIP FULL WORDS (see Note #1) ---------- */
+            if (((clus % grp_nbr_clus) == 0u) &&
+                (p_fat_data->ClusBitmapSumPtr[word_ix / FS_FAT_CLUS_BITMAP_WORD_NBR_BITS] == FS_FAT_CLUS_BITMAP_WORD_FULL)) {
+                run_len  = 0u;
+                clus    += grp_nbr_clus;
+                continue;
+            }
+
+            if (p_fat_data->ClusBitmapPtr[word_ix] == FS_FAT_CLUS_BITMAP_WORD_FULL) {
+                run_len  = 0u;
+                clus    += FS_FAT_CLUS_BITMAP_WORD_NBR_BITS;
+                continue;
+            }
+        }
+
+                                                                /* ------------------- CHK CLUS BIT ------------------- */
+        word = p_fat_data->ClusBitmapPtr[word_ix];
+        if ((DEF_BIT_IS_SET(word, (CPU_INT32U)DEF_BIT(clus % FS_FAT_CLUS_BITMAP_WORD_NBR_BITS)) == DEF_YES) ||
+            (FS_FAT_ClusAllocAvoid(p_fat_data, clus)            == DEF_YES)) {
+            run_len = 0u;                                       /* Clus in use or avoided (see Note #2).                */
+        } else {
+            if (run_len == 0u) {
+                run_start = clus;
+            }
+            run_len++;
+            if (run_len >= nbr_clus) {
+                return (run_start);
+            }
+        }
+
+        clus++;
+    }
+
+    return (0u);
+}
+#endif
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       FS_FAT_ClusBitmapHint()
+*
+* Description : Set the next cluster to allocate to the start of a run of free clusters.
+*
+* Argument(s) : p_fat_data  Pointer to FAT info.
+*
+*               prev_clus   Last cluster of the chain being extended, or 0 for a new chain.
+*
+*               nbr_clus    Number of clusters about to be allocated.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) See 'FS_FAT_ClusChainAlloc()  Note #2'.  The run is searched, in order :
+*
+*                   (a) Right after 'prev_clus', so that the chain remains contiguous.
+*                   (b) From the next cluster to the end of the FAT.
+*                   (c) From the start of the FAT.
+*
+*               (2) If no run is large enough, the next cluster is left unchanged & the chain is allocated
+*                   from scattered free clusters, as without bitmap.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  void  FS_FAT_ClusBitmapHint (FS_FAT_DATA      *p_fat_data,
+                                     FS_FAT_CLUS_NBR   prev_clus,
+                                     FS_FAT_CLUS_NBR   nbr_clus)
+{
+    FS_FAT_CLUS_NBR  run_start;
+    FS_FAT_CLUS_NBR  next_clus;
+
+
+    if ((p_fat_data->ClusBitmapPtr == (CPU_INT32U *)0) ||
+        (nbr_clus                  <= 1u)) {
+        return;
+    }
+
+    run_start = 0u;
+    if ((prev_clus != 0u) &&                                    /* See Note #1a.                                        */
+        (prev_clus <  p_fat_data->MaxClusNbr - 1u)) {
+        run_start = FS_FAT_ClusBitmapSrch(p_fat_data,
+                                          prev_clus + 1u,
+                                          DEF_MIN(prev_clus + 1u + nbr_clus, p_fat_data->MaxClusNbr),
+                                          nbr_clus);
+    }
+
+    next_clus = p_fat_data->NextClusNbr;
+    if ((next_clus <  FS_FAT_MIN_CLUS_NBR) ||
+        (next_clus >= p_fat_data->MaxClusNbr)) {
+        next_clus  = FS_FAT_MIN_CLUS_NBR;
+    }
+
+    if (run_start == 0u) {                                      /* See Note #1b.                                        */
+        run_start = FS_FAT_ClusBitmapSrch(p_fat_data, next_clus, p_fat_data->MaxClusNbr, nbr_clus);
+    }
+    if (run_start == 0u) {                                      /* See Note #1c.                                        */
+        run_start = FS_FAT_ClusBitmapSrch(p_fat_data, FS_FAT_MIN_CLUS_NBR, p_fat_data->MaxClusNbr, nbr_clus);
+    }
+
+    if (run_start != 0u) {                                      /* See Note #2.                                         */
+        p_fat_data->NextClusNbr = run_start;
+        FS_TRACE_LOG(("FS_FAT_ClusBitmapHint(): Run of %d free clus's found at %d.\r\n", nbr_clus, run_start));
+    }
+}
+#endif
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                         FS_FAT_GetSysCfg()
@@ -6061,6 +6678,8 @@ static  void  FS_FAT_FileDataClr (FS_FAT_FILE_DATA  *p_entry_data)
     p_entry_data->FilePos        = 0u;
     p_entry_data->FileSize       = 0u;
     p_entry_data->UpdateReqd     = DEF_NO;
+    p_entry_data->EntryFileSize  = 0u;
+    p_entry_data->EntryFirstClus = 0u;
     p_entry_data->Mode           = DEF_BIT_NONE;
 
     p_entry_data->DirFirstSec    = 0u;
@@ -6104,6 +6723,8 @@ static  void  FS_FAT_FileDataInit (FS_FAT_FILE_DATA *p_entry_data,
                                    CPU_INT08U       *p_dir_entry)
 {
     p_entry_data->FileSize   = MEM_VAL_GET_INT32U_LITTLE((void *)(p_dir_entry + FS_FAT_DIRENT_OFF_FILESIZE));
+    p_entry_data->EntryFileSize = p_entry_data->FileSize;
+    p_entry_data->EntryFirstClus = FS_FAT_DIRENT_CLUS_NBR_GET(p_dir_entry);
     p_entry_data->Attrib     = MEM_VAL_GET_INT08U_LITTLE((void *)(p_dir_entry + FS_FAT_DIRENT_OFF_ATTR));
     p_entry_data->DateCreate = MEM_VAL_GET_INT16U_LITTLE((void *)(p_dir_entry + FS_FAT_DIRENT_OFF_CRTDATE));
     p_entry_data->TimeCreate = MEM_VAL_GET_INT16U_LITTLE((void *)(p_dir_entry + FS_FAT_DIRENT_OFF_CRTTIME));
@@ -6161,6 +6782,17 @@ static  void  FS_FAT_DataClr (FS_FAT_DATA  *p_fat_data)
     p_fat_data->QueryBadClusCnt    =  0u;
     p_fat_data->QueryFreeClusCnt   =  0u;
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+    p_fat_data->FAT12_MirrorPtr    = (CPU_INT08U *)0;
+    p_fat_data->FAT12_MirrorSize   =  0u;
+#endif
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    p_fat_data->ClusBitmapPtr      = (CPU_INT32U *)0;
+    p_fat_data->ClusBitmapSumPtr   = (CPU_INT32U *)0;
+    p_fat_data->ClusBitmapWordCnt  =  0u;
+#endif
+
 #if (FS_CFG_CTR_STAT_EN            == DEF_ENABLED)
     p_fat_data->StatAllocClusCtr   =  0u;
     p_fat_data->StatFreeClusCtr    =  0u;
@@ -120,6 +120,7 @@
 #define  FS_FAT_MODE_APPEND                      FS_FILE_ACCESS_MODE_APPEND
 #define  FS_FAT_MODE_MUST_CREATE                 FS_FILE_ACCESS_MODE_EXCL
 #define  FS_FAT_MODE_CACHED                      FS_FILE_ACCESS_MODE_CACHED
+#define  FS_FAT_MODE_SELF_JOURNAL                FS_FILE_ACCESS_MODE_SELF_JOURNAL
 #define  FS_FAT_MODE_DEL                         DEF_BIT_07
 #define  FS_FAT_MODE_DIR                         DEF_BIT_08
 #define  FS_FAT_MODE_FILE                        DEF_BIT_09
@@ -325,6 +326,8 @@ struct  fs_fat_file_data {
     FS_FAT_FILE_SIZE          FilePos;                          /* Current file pos.                                    */
     FS_FAT_FILE_SIZE          FileSize;                         /* Nbr octets in file.                                  */
     CPU_BOOLEAN               UpdateReqd;                       /* Dir sec update req'd.                                */
+    FS_FAT_FILE_SIZE          EntryFileSize;                    /* File size last wr to dir entry.                      */
+    FS_FAT_CLUS_NBR           EntryFirstClus;                   /* First clus last wr to dir entry.                     */
     FS_FLAGS                  Mode;                             /* Access mode.                                         */
 
     FS_FAT_SEC_NBR            DirFirstSec;                      /* First sec nbr of file's parent dir.                  */
@@ -389,6 +392,17 @@ struct  fs_fat_data {
     FS_FAT_FILE_DATA         *JournalDataPtr;
 #endif
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+    CPU_INT08U               *FAT12_MirrorPtr;                  /* Ptr to RAM copy of 1st FAT (FAT12 only).             */
+    CPU_SIZE_T                FAT12_MirrorSize;                 /* Size of RAM copy of 1st FAT (in octets).             */
+#endif
+
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+    CPU_INT32U               *ClusBitmapPtr;                    /* Ptr to clus bitmap (1 bit per clus, set if NOT free).*/
+    CPU_INT32U               *ClusBitmapSumPtr;                 /* Ptr to bitmap summary (1 bit per full bitmap word).  */
+    FS_FAT_CLUS_NBR           ClusBitmapWordCnt;                /* Nbr of words in clus bitmap.                         */
+#endif
+
 #if (FS_CFG_CTR_STAT_EN == DEF_ENABLED)
     FS_CTR                    StatAllocClusCtr;                 /* Number of cluster allocations.                       */
     FS_CTR                    StatFreeClusCtr;                  /* Number of cluster frees.                             */
@@ -844,6 +858,12 @@ FS_FAT_CLUS_NBR  FS_FAT_ClusFreeFind           (FS_VOL            *p_vol,
                                                 FS_ERR            *p_err);
 #endif
 
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+void             FS_FAT_ClusBitmapSet          (FS_FAT_DATA       *p_fat_data,  /* Update clus state in clus bitmap.    */
+                                                FS_FAT_CLUS_NBR    clus,
+                                                CPU_BOOLEAN        used);
+#endif
+
 FS_FAT_CLUS_NBR  FS_FAT_ClusNextGet            (FS_VOL            *p_vol,       /* Get next cluster in chain.           */
                                                 FS_BUF            *p_buf,
                                                 FS_FAT_CLUS_NBR    start_clus,
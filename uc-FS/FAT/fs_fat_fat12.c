@@ -45,6 +45,7 @@
 #include  <lib_mem.h>
 #include  "../Source/fs.h"
 #include  "../Source/fs_buf.h"
+#include  "../Source/fs_dev.h"
 #include  "../Source/fs_sys.h"
 #include  "../Source/fs_vol.h"
 #include  "fs_fat_fat12.h"
@@ -102,6 +103,10 @@
 *********************************************************************************************************
 */
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+static  MEM_POOL  FS_FAT_FAT12_MirrorPool;                      /* Pool of FAT12 mirrors.                               */
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -129,6 +134,15 @@ static  FS_FAT_CLUS_NBR  FS_FAT_FAT12_ClusValRd       (FS_VOL           *p_vol,
                                                        FS_FAT_CLUS_NBR   clus,
                                                        FS_ERR           *p_err);
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  void             FS_FAT_FAT12_MirrorSecWr     (FS_VOL           *p_vol,     /* Wr mirror sec through buf.       */
+                                                       FS_BUF           *p_buf,
+                                                       FS_SEC_SIZE       fat_offset,
+                                                       FS_ERR           *p_err);
+#endif
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -155,6 +169,212 @@ const  FS_FAT_TYPE_API  FS_FAT_FAT12_API = {
 *********************************************************************************************************
 */
 
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                         FAT12 MIRROR FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                   FS_FAT_FAT12_MirrorModuleInit()
+*
+* Description : Initialize FAT12 mirror module.
+*
+* Argument(s) : vol_cnt     Number of volumes in use.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE         Module initialized.
+*                               FS_ERR_MEM_ALLOC    Memory could not be allocated.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+void  FS_FAT_FAT12_MirrorModuleInit (FS_QTY   vol_cnt,
+                                     FS_ERR  *p_err)
+{
+    CPU_SIZE_T  octets_reqd;
+    LIB_ERR     pool_err;
+
+
+    Mem_PoolCreate(&FS_FAT_FAT12_MirrorPool,
+                    DEF_NULL,
+                    0,
+                    vol_cnt,
+                    FS_FAT_CFG_FAT12_MIRROR_SIZE,
+                    sizeof(CPU_ALIGN),
+                   &octets_reqd,
+                   &pool_err);
+
+    if (pool_err != LIB_MEM_ERR_NONE) {
+       *p_err = FS_ERR_MEM_ALLOC;
+        FS_TRACE_INFO(("FS_FAT_FAT12_MirrorModuleInit(): Could not alloc mem for FAT12 mirrors: %d octets req'd.\r\n", octets_reqd));
+        return;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      FS_FAT_FAT12_MirrorOpen()
+*
+* Description : Load the first FAT of a volume into a RAM mirror.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE    Mirror loaded OR volume accessed without mirror.
+*                               FS_ERR_DEV     Device error.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Only the sectors holding the entries of clusters 0 to 'MaxClusNbr' are mirrored.  A FAT
+*                   that does not fit in FS_FAT_CFG_FAT12_MIRROR_SIZE octets, or a volume opened when no
+*                   mirror is left in the pool, is accessed through the volume buffer as usual.
+*
+*               (2) The file system lock MUST be held to get the mirror from the mirror pool.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+void  FS_FAT_FAT12_MirrorOpen (FS_VOL  *p_vol,
+                               FS_ERR  *p_err)
+{
+    FS_FAT_DATA     *p_fat_data;
+    CPU_INT08U      *p_mirror;
+    FS_FAT_SEC_NBR   sec_cnt;
+    CPU_SIZE_T       fat_size;
+    FS_ERR           err_tmp;
+    LIB_ERR          pool_err;
+
+
+    p_fat_data = (FS_FAT_DATA *)p_vol->DataPtr;
+
+    p_fat_data->FAT12_MirrorPtr  = (CPU_INT08U *)0;
+    p_fat_data->FAT12_MirrorSize =  0u;
+
+    if (p_fat_data->FAT_Type != FS_FAT_FAT_TYPE_FAT12) {
+       *p_err = FS_ERR_NONE;
+        return;
+    }
+                                                                /* Nbr of FAT secs used by clus entries (see Note #1).  */
+    fat_size = (CPU_SIZE_T)p_fat_data->MaxClusNbr + ((CPU_SIZE_T)p_fat_data->MaxClusNbr / 2u) + 2u;
+    sec_cnt  = (FS_FAT_SEC_NBR)FS_UTIL_DIV_PWR2(fat_size + p_fat_data->SecSize - 1u, p_fat_data->SecSizeLog2);
+    sec_cnt  =  DEF_MIN(sec_cnt, p_fat_data->FAT_Size);
+    fat_size = (CPU_SIZE_T)sec_cnt * p_fat_data->SecSize;
+
+    if (fat_size > FS_FAT_CFG_FAT12_MIRROR_SIZE) {              /* FAT too large for mirror.                            */
+        FS_TRACE_DBG(("FS_FAT_FAT12_MirrorOpen(): FAT size %d > mirror size %d; mirror NOT used.\r\n", fat_size, FS_FAT_CFG_FAT12_MIRROR_SIZE));
+       *p_err = FS_ERR_NONE;
+        return;
+    }
+
+                                                                /* ------------------- ALLOC MIRROR ------------------- */
+    FS_OS_Lock(p_err);                                          /* Acquire FS lock (see Note #2).                       */
+    if (*p_err != FS_ERR_NONE) {
+        return;
+    }
+
+    p_mirror = (CPU_INT08U *)Mem_PoolBlkGet(&FS_FAT_FAT12_MirrorPool,
+                                             FS_FAT_CFG_FAT12_MIRROR_SIZE,
+                                            &pool_err);
+    (void)pool_err;                                            /* Err ignored. Ret val chk'd instead.                  */
+    FS_OS_Unlock();
+
+    if (p_mirror == (CPU_INT08U *)0) {                          /* No mirror avail (see Note #1).                       */
+       *p_err = FS_ERR_NONE;
+        return;
+    }
+
+                                                                /* -------------------- RD 1ST FAT -------------------- */
+    FSVol_RdLockedEx(             p_vol,
+                     (void      *)p_mirror,
+                     (FS_SEC_NBR )p_fat_data->FAT1_Start,
+                     (FS_SEC_QTY )sec_cnt,
+                                  FS_VOL_SEC_TYPE_MGMT,
+                                  p_err);
+
+    if (*p_err != FS_ERR_NONE) {
+        FS_OS_Lock(&err_tmp);
+        Mem_PoolBlkFree(        &FS_FAT_FAT12_MirrorPool,
+                        (void *) p_mirror,
+                                &pool_err);
+        FS_OS_Unlock();
+        return;
+    }
+
+    p_fat_data->FAT12_MirrorPtr  = p_mirror;
+    p_fat_data->FAT12_MirrorSize = fat_size;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      FS_FAT_FAT12_MirrorClose()
+*
+* Description : Free the FAT mirror of a volume.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) FAT sectors are written through the volume buffer as the mirror is modified (see
+*                   'FS_FAT_FAT12_ClusValWr()  Note #1'); the mirror never holds the only copy of an entry &
+*                   may be freed without being written back.
+*
+*               (2) The file system lock MUST be held to release the mirror back to the mirror pool.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+void  FS_FAT_FAT12_MirrorClose (FS_VOL  *p_vol)
+{
+    FS_FAT_DATA  *p_fat_data;
+    FS_ERR        err;
+    LIB_ERR       pool_err;
+
+
+    p_fat_data = (FS_FAT_DATA *)p_vol->DataPtr;
+    if (p_fat_data->FAT12_MirrorPtr == (CPU_INT08U *)0) {
+        return;
+    }
+
+    FS_OS_Lock(&err);                                           /* Acquire FS lock (see Note #2).                       */
+    if (err != FS_ERR_NONE) {
+        return;
+    }
+
+    Mem_PoolBlkFree(        &FS_FAT_FAT12_MirrorPool,           /* Free mirror (see Note #1).                           */
+                    (void *) p_fat_data->FAT12_MirrorPtr,
+                            &pool_err);
+    FS_OS_Unlock();
+
+    if (pool_err != LIB_MEM_ERR_NONE) {
+        CPU_SW_EXCEPTION(;);                                    /* Fatal err.                                           */
+    }
+
+    p_fat_data->FAT12_MirrorPtr  = (CPU_INT08U *)0;
+    p_fat_data->FAT12_MirrorSize =  0u;
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *********************************************************************************************************
@@ -184,7 +404,10 @@ const  FS_FAT_TYPE_API  FS_FAT_FAT12_API = {
 *
 * Return(s)   : none.
 *
-* Note(s)     : none.
+* Note(s)     : (1) If the volume has a FAT12 mirror, the entry is modified in the mirror & the modified FAT
+*                   sector(s) are copied from the mirror into the buffer, which is then marked dirty.  Sectors
+*                   are thus written in the same order & at the same points as without the mirror (so that
+*                   journal replay remains valid), but are never read from the device first.
 *********************************************************************************************************
 */
 
@@ -210,6 +433,41 @@ static  void  FS_FAT_FAT12_ClusValWr (FS_VOL           *p_vol,
     fat_sec        =  fat_start_sec + (FS_FAT_SEC_NBR)FS_UTIL_DIV_PWR2(fat_offset, p_fat_data->SecSizeLog2);
     fat_sec_offset =  fat_offset & (p_fat_data->SecSize - 1u);
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+    if ((p_fat_data->FAT12_MirrorPtr !=  (CPU_INT08U *)0) &&    /* ------------------ WR (MIRRORED) ------------------- */
+        (p_fat_data->FAT12_MirrorSize > ((CPU_SIZE_T)fat_offset + 1u))) {
+        FSBuf_Set(p_buf,                                        /* Flush buf before mirror is modified (see Note #1).   */
+                  fat_sec,
+                  FS_VOL_SEC_TYPE_MGMT,
+                  DEF_NO,
+                  p_err);
+        if (*p_err != FS_ERR_NONE) {
+            return;
+        }
+
+        val_temp = MEM_VAL_GET_INT16U_LITTLE((void *)(p_fat_data->FAT12_MirrorPtr + fat_offset));
+        if (FS_UTIL_IS_ODD(clus) == DEF_YES) {
+            val_temp  = val_temp & 0x000Fu;
+            val     <<= DEF_NIBBLE_NBR_BITS;
+        } else {
+            val_temp  = val_temp & 0xF000u;
+        }
+        val_temp |= val;
+                                                                /* Wr clus val in mirror.                               */
+        MEM_VAL_SET_INT16U_LITTLE((void *)(p_fat_data->FAT12_MirrorPtr + fat_offset), val_temp);
+
+        FS_FAT_FAT12_MirrorSecWr(p_vol, p_buf, fat_offset, p_err);  /* Wr 1st FAT sec.                                  */
+        if (*p_err != FS_ERR_NONE) {
+            return;
+        }
+
+        if (fat_sec_offset == p_fat_data->SecSize - 1u) {       /* Wr 2nd FAT sec, if split.                            */
+            FS_FAT_FAT12_MirrorSecWr(p_vol, p_buf, fat_offset + 1u, p_err);
+        }
+        return;
+    }
+#endif
+
     if (fat_sec_offset == p_fat_data->SecSize - 1u) {           /* -------------------- WR (SPLIT) -------------------- */
         FSBuf_Set(p_buf,                                        /* Rd 1st FAT sec.                                      */
                   fat_sec,
@@ -307,7 +565,9 @@ static  void  FS_FAT_FAT12_ClusValWr (FS_VOL           *p_vol,
 *
 * Return(s)   : Cluster value.
 *
-* Note(s)     : none.
+* Note(s)     : (1) If the volume has a FAT12 mirror, the entry is read from the mirror & the buffer is left
+*                   untouched.  Entries split across two sectors need no special handling since the mirror is
+*                   contiguous.
 *********************************************************************************************************
 */
 
@@ -334,6 +594,21 @@ static  FS_FAT_CLUS_NBR  FS_FAT_FAT12_ClusValRd (FS_VOL           *p_vol,
     fat_sec        =  fat_start_sec + (FS_FAT_SEC_NBR)FS_UTIL_DIV_PWR2(fat_offset, p_fat_data->SecSizeLog2);
     fat_sec_offset =  fat_offset & (p_fat_data->SecSize - 1u);
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+    if ((p_fat_data->FAT12_MirrorPtr !=  (CPU_INT08U *)0) &&    /* ------------------ RD (MIRRORED) ------------------- */
+        (p_fat_data->FAT12_MirrorSize > ((CPU_SIZE_T)fat_offset + 1u))) {
+                                                                /* Rd clus val from mirror (see Note #1).               */
+        val_temp = MEM_VAL_GET_INT16U_LITTLE((void *)(p_fat_data->FAT12_MirrorPtr + fat_offset));
+        if (FS_UTIL_IS_ODD(clus) == DEF_YES) {
+            val = (val_temp & 0xFFF0u) >> DEF_NIBBLE_NBR_BITS;
+        } else {
+            val = (val_temp & 0x0FFFu);
+        }
+       *p_err = FS_ERR_NONE;
+        return (val);
+    }
+#endif
+
     if (fat_sec_offset == p_fat_data->SecSize - 1u) {           /* -------------------- RD (SPLIT) -------------------- */
         FSBuf_Set(p_buf,                                        /* Rd 1st FAT sec.                                      */
                   fat_sec,
@@ -389,6 +664,62 @@ static  FS_FAT_CLUS_NBR  FS_FAT_FAT12_ClusValRd (FS_VOL           *p_vol,
 }
 
 
+/*
+*********************************************************************************************************
+*                                      FS_FAT_FAT12_MirrorSecWr()
+*
+* Description : Copy a FAT sector from the mirror into the buffer & mark it dirty.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*
+*               p_buf       Pointer to temporary buffer.
+*
+*               fat_offset  Offset, in octets, of any entry octet within the FAT sector to write.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE    Sector written.
+*                               FS_ERR_DEV     Device error.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The sector is NOT read from the device : its contents are entirely replaced by the mirror.
+*********************************************************************************************************
+*/
+
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+static  void  FS_FAT_FAT12_MirrorSecWr (FS_VOL       *p_vol,
+                                        FS_BUF       *p_buf,
+                                        FS_SEC_SIZE   fat_offset,
+                                        FS_ERR       *p_err)
+{
+    FS_FAT_DATA     *p_fat_data;
+    FS_FAT_SEC_NBR   fat_sec_rel;
+
+
+    p_fat_data  = (FS_FAT_DATA *)p_vol->DataPtr;
+    fat_sec_rel = (FS_FAT_SEC_NBR)FS_UTIL_DIV_PWR2(fat_offset, p_fat_data->SecSizeLog2);
+
+    FSBuf_Set(p_buf,                                            /* Set buf to FAT sec without rd (see Note #1).         */
+              p_fat_data->FAT1_Start + fat_sec_rel,
+              FS_VOL_SEC_TYPE_MGMT,
+              DEF_NO,
+              p_err);
+    if (*p_err != FS_ERR_NONE) {
+        return;
+    }
+
+    Mem_Copy(p_buf->DataPtr,                                    /* Copy sec from mirror.                                */
+             p_fat_data->FAT12_MirrorPtr + ((CPU_SIZE_T)fat_sec_rel * p_fat_data->SecSize),
+             p_fat_data->SecSize);
+
+    FSBuf_MarkDirty(p_buf, p_err);                              /* Wr FAT sec.                                          */
+}
+#endif
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                             MODULE END
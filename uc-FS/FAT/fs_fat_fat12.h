@@ -105,6 +105,16 @@ extern  const  FS_FAT_TYPE_API  FS_FAT_FAT12_API;               /* FAT12 access
 *********************************************************************************************************
 */
 
+#ifdef  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+void  FS_FAT_FAT12_MirrorModuleInit(FS_QTY   vol_cnt,                       /* Init FAT12 mirror module.                */
+                                    FS_ERR  *p_err);
+
+void  FS_FAT_FAT12_MirrorOpen      (FS_VOL  *p_vol,                         /* Load FAT12 mirror of vol.                */
+                                    FS_ERR  *p_err);
+
+void  FS_FAT_FAT12_MirrorClose     (FS_VOL  *p_vol);                        /* Free FAT12 mirror of vol.                */
+#endif
+
 
 /*
 *********************************************************************************************************
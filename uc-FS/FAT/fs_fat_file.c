@@ -250,6 +250,134 @@ void  FS_FAT_FileClose  (FS_FILE  *p_file,
 }
 
 
+/*
+*********************************************************************************************************
+*                                          FS_FAT_FileMap()
+*
+* Description : Get a pointer to file data.
+*
+* Argument(s) : p_file      Pointer to a file.
+*               ------      Argument validated by caller.
+*
+*               pos         Offset of data in file.
+*
+*               size        Number of octets.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE                 File data mapped.
+*                               FS_ERR_BUF_NONE_AVAIL       No buffer available.
+*                               FS_ERR_DEV                  Device access error.
+*                               FS_ERR_DEV_INVALID_OP       File data is not addressable (see Note #1).
+*                               FS_ERR_ENTRY_CORRUPT        File system entry is corrupt.
+*                               FS_ERR_FILE_INVALID_POS     Data not within file.
+*
+* Return(s)   : Pointer to file data, if NO error(s).
+*               Pointer to NULL,      otherwise.
+*
+* Note(s)     : (1) File data can only be mapped if it lies in contiguous clusters & the volume sectors
+*                   holding it are addressable (see 'FSVol_MapLocked()').
+*
+*               (2) Neither the file position nor the file buffer is changed.  The data is read-only &
+*                   only valid until the file or its sectors are next written.
+*********************************************************************************************************
+*/
+
+void  *FS_FAT_FileMap (FS_FILE       *p_file,
+                       FS_FILE_SIZE   pos,
+                       CPU_SIZE_T     size,
+                       FS_ERR        *p_err)
+{
+    FS_FAT_CLUS_NBR    clus_cnt;
+    FS_FAT_CLUS_NBR    clus_ix;
+    FS_FAT_CLUS_NBR    clus_first;
+    FS_FAT_CLUS_NBR    clus_cur;
+    FS_FAT_CLUS_NBR    clus_next;
+    FS_FAT_SEC_NBR     sec_start;
+    FS_FAT_SEC_NBR     sec_cnt;
+    FS_FILE_SIZE       pos_sec;
+    CPU_INT08U        *p_data;
+    FS_BUF            *p_buf;
+    FS_FAT_DATA       *p_fat_data;
+    FS_FAT_FILE_DATA  *p_fat_file_data;
+
+
+    p_fat_file_data = (FS_FAT_FILE_DATA *)(p_file->DataPtr);
+    p_fat_data      = (FS_FAT_DATA      *)(p_file->VolPtr->DataPtr);
+
+                                                                /* ------------------ VALIDATE RANGE ------------------ */
+    if ((p_fat_file_data->FileFirstClus == 0u)                     ||
+        (size                           == 0u)                     ||
+        (pos                            >= p_fat_file_data->FileSize) ||
+        (size > (p_fat_file_data->FileSize - pos))) {
+       *p_err = FS_ERR_FILE_INVALID_POS;
+        return ((void *)0);
+    }
+
+    clus_ix  = (FS_FAT_CLUS_NBR)FS_UTIL_DIV_PWR2(pos,             p_fat_data->ClusSizeLog2_octet);
+    clus_cnt = (FS_FAT_CLUS_NBR)FS_UTIL_DIV_PWR2(pos + size - 1u, p_fat_data->ClusSizeLog2_octet) - clus_ix + 1u;
+
+
+                                                                /* ------------- FIND & CHK CLUS CONTIG --------------- */
+    p_buf = FSBuf_Get(p_file->VolPtr);
+    if (p_buf == (FS_BUF *)0) {
+       *p_err = FS_ERR_BUF_NONE_AVAIL;
+        return ((void *)0);
+    }
+
+    clus_first = FS_FAT_ClusChainFollow(p_file->VolPtr,         /* Find clus holding first octet.                       */
+                                        p_buf,
+                                        p_fat_file_data->FileFirstClus,
+                                        clus_ix,
+                                        DEF_NULL,
+                                        p_err);
+    clus_cur   = clus_first;
+    while ((*p_err == FS_ERR_NONE) && (clus_cnt > 1u)) {        /* Chk that following clus's are contiguous.            */
+        clus_next = FS_FAT_ClusNextGet(p_file->VolPtr,
+                                       p_buf,
+                                       clus_cur,
+                                       p_err);
+        if ((*p_err == FS_ERR_NONE) && (clus_next != clus_cur + 1u)) {
+            FSBuf_Free(p_buf);
+           *p_err = FS_ERR_DEV_INVALID_OP;                      /* See Note #1.                                         */
+            return ((void *)0);
+        }
+        clus_cur = clus_next;
+        clus_cnt--;
+    }
+    FSBuf_Free(p_buf);
+
+    if (*p_err != FS_ERR_NONE) {
+        if ((*p_err == FS_ERR_SYS_CLUS_CHAIN_END)       ||
+            (*p_err == FS_ERR_SYS_CLUS_CHAIN_END_EARLY) ||
+            (*p_err == FS_ERR_SYS_CLUS_INVALID)) {
+             *p_err =  FS_ERR_ENTRY_CORRUPT;
+        }
+        return ((void *)0);
+    }
+
+
+                                                                /* --------------------- MAP SECS --------------------- */
+    pos_sec   = pos & (p_fat_data->ClusSize_octet - 1u);        /* Offset in first clus.                                */
+    sec_start = FS_FAT_CLUS_TO_SEC(p_fat_data, clus_first) + (FS_FAT_SEC_NBR)FS_UTIL_DIV_PWR2(pos_sec, p_fat_data->SecSizeLog2);
+    pos_sec   = pos_sec & (p_fat_data->SecSize - 1u);           /* Offset in first sec.                                 */
+    sec_cnt   = (FS_FAT_SEC_NBR)FS_UTIL_DIV_PWR2(pos_sec + size - 1u, p_fat_data->SecSizeLog2) + 1u;
+
+    p_data = (CPU_INT08U *)FSVol_MapLocked(p_file->VolPtr,
+                                           sec_start,
+                                           sec_cnt,
+                                           p_err);
+    if (*p_err != FS_ERR_NONE) {
+        if (*p_err == FS_ERR_DEV_INVALID_IO_CTRL) {             /* Dev secs not addressable.                            */
+            *p_err =  FS_ERR_DEV_INVALID_OP;
+        }
+        return ((void *)0);
+    }
+
+    return ((void *)(p_data + pos_sec));
+}
+
+
 /*
 *********************************************************************************************************
 *                                          FS_FAT_FileOpen()
@@ -901,6 +1029,223 @@ CPU_SIZE_T  FS_FAT_FileRd (FS_FILE     *p_file,
 }
 
 
+/*
+*********************************************************************************************************
+*                                        FS_FAT_FileReserve()
+*
+* Description : Reserve clusters for a file.
+*
+* Argument(s) : p_file      Pointer to a file.
+*               ------      Argument validated by caller.
+*
+*               size        Size of file for which clusters should be reserved.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE              Clusters reserved successfully.
+*                               FS_ERR_BUF_NONE_AVAIL    No buffer available.
+*                               FS_ERR_DEV               Device access error.
+*                               FS_ERR_DEV_FULL          Device is full (no space could be allocated).
+*                               FS_ERR_ENTRY_CORRUPT     File system entry is corrupt.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The cluster chain of the file is extended so that it covers 'size' octets.  Neither
+*                   the file size nor the file position is changed & the reserved clusters are NOT
+*                   zero-filled; these are consumed by later writes, which follow the existing chain
+*                   before allocating new clusters (see 'FS_FAT_FileWr()').
+*
+*               (2) If no data cluster has been assigned to the file yet, no action is taken; the first
+*                   cluster will be allocated (& recorded in the directory entry) by the first write.
+*
+*               (3) Clusters allocated past the end of the file are released if the file is later
+*                   truncated.
+*
+*               (4) If journaling is enabled & journaling started, the allocation is logged (from
+*                   'FS_FAT_ClusChainAlloc()') to the journal.  Since this is a top level action, the
+*                   journal must be cleared once it is finished.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void  FS_FAT_FileReserve (FS_FILE       *p_file,
+                          FS_FILE_SIZE   size,
+                          FS_ERR        *p_err)
+{
+    FS_FAT_CLUS_NBR    clus_end;
+    FS_FAT_CLUS_NBR    clus_cnt;
+    FS_FAT_CLUS_NBR    clus_nbr;
+    FS_BUF            *p_buf;
+    FS_FAT_DATA       *p_fat_data;
+    FS_FAT_FILE_DATA  *p_fat_file_data;
+
+
+    p_fat_file_data = (FS_FAT_FILE_DATA *)(p_file->DataPtr);
+    p_fat_data      = (FS_FAT_DATA      *)(p_file->VolPtr->DataPtr);
+
+    if (p_fat_file_data->FileFirstClus == 0u) {                 /* If no data clus's assigned to file ...               */
+       *p_err = FS_ERR_NONE;                                    /* ... do nothing & rtn (see Note #2).                  */
+        return;
+    }
+
+    if (size <= p_fat_file_data->FileSize) {                    /* If size within file ...                              */
+       *p_err = FS_ERR_NONE;                                    /* ... nothing to reserve.                              */
+        return;
+    }
+
+                                                                /* Nbr of clus covering size.                           */
+    clus_nbr  = FS_UTIL_DIV_PWR2(size, p_fat_data->ClusSizeLog2_octet);
+    clus_nbr += ((size & (p_fat_data->ClusSize_octet - 1u)) != 0u) ? 1u : 0u;
+
+
+                                                                /* ------------------ FIND CHAIN END ------------------ */
+    p_buf = FSBuf_Get(p_file->VolPtr);
+    if (p_buf == (FS_BUF *)0) {
+       *p_err = FS_ERR_BUF_NONE_AVAIL;
+        return;
+    }
+
+    clus_end = FS_FAT_ClusChainEndFind(p_file->VolPtr,
+                                       p_buf,
+                                       p_fat_file_data->FileFirstClus,
+                                      &clus_cnt,
+                                       p_err);
+    if (*p_err != FS_ERR_NONE) {
+        if (*p_err == FS_ERR_SYS_CLUS_INVALID) {
+            *p_err = FS_ERR_ENTRY_CORRUPT;
+        }
+        FSBuf_Free(p_buf);
+        return;
+    }
+    clus_cnt++;                                                 /* Chain len is the nbr of clus followed + 1.           */
+
+    if (clus_nbr <= clus_cnt) {                                 /* If chain already covers size ...                     */
+        FSBuf_Free(p_buf);
+       *p_err = FS_ERR_NONE;                                    /* ... nothing to reserve.                              */
+        return;
+    }
+
+
+                                                                /* ------------------- EXTEND CHAIN ------------------- */
+   (void)FS_FAT_ClusChainAlloc(p_file->VolPtr,                  /* See Note #1.                                         */
+                               p_buf,
+                               clus_end,
+                               clus_nbr - clus_cnt,
+                               p_err);
+    if (*p_err != FS_ERR_NONE) {
+        FSBuf_Free(p_buf);
+        return;
+    }
+
+                                                                /* -------------------- CLR JOURNAL ------------------- */
+#ifdef FS_FAT_JOURNAL_MODULE_PRESENT
+    FS_FAT_JournalClrReset(p_file->VolPtr, p_buf, p_err);       /* See Note #4.                                         */
+    if (*p_err != FS_ERR_NONE) {
+        FSBuf_Free(p_buf);
+        return;
+    }
+#endif
+
+    FSBuf_Flush(p_buf, p_err);
+    FSBuf_Free(p_buf);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FS_FAT_FileSync()
+*
+* Description : Write file metadata to the volume.
+*
+* Argument(s) : p_file      Pointer to a file.
+*               ------      Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE              File metadata written successfully.
+*                               FS_ERR_BUF_NONE_AVAIL    No buffer available.
+*                               FS_ERR_DEV               Device access error.
+*                               FS_ERR_ENTRY_CORRUPT     File system entry is corrupt.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) If the file is cached, directory entry updates are deferred (see 'FS_FAT_FileWr()')
+*                   & only the deferred update is written.  Otherwise, the directory entry is already up
+*                   to date & no action is taken.
+*
+*                   (a) If the file is self-journaled, the entry is only written if the file size or first
+*                       cluster changed since the entry was last written (a file truncated to zero size &
+*                       regrown to its former size gets a new first cluster).  A write date/time update
+*                       alone is left to 'FS_FAT_FileClose()', so that overwrites within the file cost no
+*                       metadata write.
+*
+*               (2) If journaling is enabled & journaling started, logs will be written (from
+*                  'FS_FAT_LowEntryUpdate()') to the journal.  Since this is a top level action, the
+*                   journal must be cleared once it is finished.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void  FS_FAT_FileSync (FS_FILE  *p_file,
+                       FS_ERR   *p_err)
+{
+    FS_BUF            *p_buf;
+    FS_FAT_FILE_DATA  *p_fat_file_data;
+
+
+    p_fat_file_data = (FS_FAT_FILE_DATA *)p_file->DataPtr;
+
+    if ((DEF_BIT_IS_SET(p_fat_file_data->Mode, FS_FILE_ACCESS_MODE_CACHED | FS_FILE_ACCESS_MODE_WR) == DEF_NO) ||
+        (p_fat_file_data->UpdateReqd == DEF_NO)) {              /* If no update deferred ...                            */
+       *p_err = FS_ERR_NONE;                                    /* ... nothing to do (see Note #1).                     */
+        return;
+    }
+
+    if ((DEF_BIT_IS_SET(p_fat_file_data->Mode, FS_FAT_MODE_SELF_JOURNAL) == DEF_YES) &&
+        (p_fat_file_data->FileSize      == p_fat_file_data->EntryFileSize)  &&
+        (p_fat_file_data->FileFirstClus == p_fat_file_data->EntryFirstClus)) {
+       *p_err = FS_ERR_NONE;                                    /* Size & first clus unchanged: date/time updated ...   */
+        return;                                                 /* ... (see Note #1a).                                  */
+    }
+
+                                                                /* ----------------- UPDATE DIR ENTRY ----------------- */
+    p_buf = FSBuf_Get(p_file->VolPtr);
+    if (p_buf == (FS_BUF *)0) {
+       *p_err = FS_ERR_BUF_NONE_AVAIL;
+        return;
+    }
+
+    FS_FAT_LowEntryUpdate(p_file->VolPtr,
+                          p_buf,
+                          p_fat_file_data,
+                          DEF_YES,
+                          p_err);
+    if (*p_err != FS_ERR_NONE) {
+        FSBuf_Free(p_buf);
+        return;
+    }
+
+                                                                /* -------------------- CLR JOURNAL ------------------- */
+#ifdef FS_FAT_JOURNAL_MODULE_PRESENT
+    FS_FAT_JournalClrReset(p_file->VolPtr, p_buf, p_err);       /* See Note #2.                                         */
+    if (*p_err != FS_ERR_NONE) {
+        FSBuf_Free(p_buf);
+        return;
+    }
+#endif
+
+    FSBuf_Flush(p_buf, p_err);
+    FSBuf_Free(p_buf);
+    if (*p_err != FS_ERR_NONE) {
+        return;
+    }
+
+    p_fat_file_data->UpdateReqd = DEF_NO;
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                        FS_FAT_FileTruncate()
@@ -110,6 +110,11 @@ void          FS_FAT_FileModuleInit(FS_QTY          file_cnt,   /* Init FAT dir
 void          FS_FAT_FileClose     (FS_FILE        *p_file,     /* Close a file.                                        */
                                     FS_ERR         *p_err);
 
+void         *FS_FAT_FileMap       (FS_FILE        *p_file,     /* Get ptr to addressable file data.                    */
+                                    FS_FILE_SIZE    pos,
+                                    CPU_SIZE_T      size,
+                                    FS_ERR         *p_err);
+
 void          FS_FAT_FileOpen      (FS_FILE        *p_file,     /* Open a file.                                         */
                                     CPU_CHAR       *name_file,
                                     FS_ERR         *p_err);
@@ -127,6 +132,17 @@ CPU_SIZE_T    FS_FAT_FileRd        (FS_FILE        *p_file,     /* Read from a f
                                     CPU_SIZE_T      size,
                                     FS_ERR         *p_err);
 
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void          FS_FAT_FileReserve   (FS_FILE        *p_file,     /* Reserve clusters for a file.                         */
+                                    FS_FILE_SIZE    size,
+                                    FS_ERR         *p_err);
+#endif
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void          FS_FAT_FileSync      (FS_FILE        *p_file,     /* Write file metadata to the volume.                   */
+                                    FS_ERR         *p_err);
+#endif
+
 #if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
 void          FS_FAT_FileTruncate  (FS_FILE        *p_file,     /* Truncate a file.                                     */
                                     FS_FILE_SIZE    size,
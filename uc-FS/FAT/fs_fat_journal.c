@@ -882,6 +882,7 @@ void  FS_FAT_JournalClr (FS_VOL            *p_vol,
     FS_SEC_SIZE        cur_sec_pos;
     FS_FAT_FILE_SIZE   rem_size;
     FS_FAT_FILE_SIZE   wr_size;
+    CPU_INT32U         trace_start;
 
 
     p_fat_data     = (FS_FAT_DATA *)p_vol->DataPtr;
@@ -898,6 +899,7 @@ void  FS_FAT_JournalClr (FS_VOL            *p_vol,
     cur_sec     =  first_sec + FS_UTIL_DIV_PWR2(start_pos, p_fat_data->SecSizeLog2);
     cur_sec_pos = (start_pos & (p_fat_data->SecSize - 1u));
     rem_size    =  len;
+    trace_start =  FS_TRACE_IO_START();
 
 
                                                                 /* ------------------- CLR JOURNAL -------------------- */
@@ -937,6 +939,8 @@ void  FS_FAT_JournalClr (FS_VOL            *p_vol,
         }
     }
 
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_JOURNAL, FS_TRACE_IO_OP_WR, start_pos, len, trace_start);
+
     FS_TRACE_LOG(("FS_FAT_JournalClr(): %d octets cleared from position %d.\r\n", len, start_pos));
 }
 
@@ -2146,6 +2150,7 @@ static  void  FS_FAT_JournalWr (FS_VOL      *p_vol,
     CPU_SIZE_T         rem_size;
     FS_SEC_SIZE        cur_sec_pos;
     FS_FAT_SEC_NBR     cur_sec;
+    CPU_INT32U         trace_start;
 
 
     p_fat_data     = (FS_FAT_DATA *)p_vol->DataPtr;
@@ -2159,6 +2164,7 @@ static  void  FS_FAT_JournalWr (FS_VOL      *p_vol,
     }
 
 
+    trace_start = FS_TRACE_IO_START();
     rem_size    = len;
     cur_sec     = p_journal_data->FileCurSec;
     cur_sec_pos = p_journal_data->FileCurSecPos;
@@ -2203,6 +2209,8 @@ static  void  FS_FAT_JournalWr (FS_VOL      *p_vol,
 
     } while(rem_size > 0);
 
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_JOURNAL, FS_TRACE_IO_OP_WR, p_journal_data->FilePos, len, trace_start);
+
                                                                 /* -------------------- UPDATE POS -------------------- */
     p_journal_data->FilePos       = file_pos_end;
     p_journal_data->FileCurSec    = cur_sec;
@@ -2843,6 +2851,13 @@ static  void  FS_FAT_JournalReplayClusChainDel (FS_VOL  *p_vol,
        if (*p_err != FS_ERR_NONE) {
            return;
        }
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+       FS_FAT_ClusBitmapSet(p_fat_data, start_clus, DEF_YES);
+#endif
+       if ((fat_entry                  == p_fat_data->FAT_TypeAPI_Ptr->ClusFree) &&
+           (p_fat_data->QueryInfoValid == DEF_YES)) {           /* Update query info.                                   */
+           p_fat_data->QueryFreeClusCnt--;
+       }
    }
 
    if ((fat_entry != p_fat_data->FAT_TypeAPI_Ptr->ClusFree) &&  /* If start clus has not been mark'd as free ...        */
@@ -2855,6 +2870,12 @@ static  void  FS_FAT_JournalReplayClusChainDel (FS_VOL  *p_vol,
        if (*p_err != FS_ERR_NONE) {
            return;
        }
+#ifdef  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+       FS_FAT_ClusBitmapSet(p_fat_data, start_clus, DEF_NO);
+#endif
+       if (p_fat_data->QueryInfoValid == DEF_YES) {             /* Update query info.                                   */
+           p_fat_data->QueryFreeClusCnt++;
+       }
    }
 
    if (nbr_marker == 0u) {                                      /* If no markers were log'd ...                         */
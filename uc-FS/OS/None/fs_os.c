@@ -567,6 +567,54 @@ void  FS_OS_DevAccessUnlock (FS_ID  dev_id)
 }
 
 
+/*
+*********************************************************************************************************
+*                                        FS_OS_DevLockShared()
+*
+* Description : Acquire shared access to file system device.
+*
+* Argument(s) : dev_id      Index of the semaphore to acquire.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE       File system device access     acquired.
+*                               FS_ERR_OS_LOCK    File system device access NOT acquired.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Both the device access lock & the device lock are acquired, in that order, shared with
+*                   other holders of a shared lock & exclusive of 'FS_OS_DevAccessLock()' & 'FS_OS_DevLock()'.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevLockShared (FS_ID    dev_id,
+                           FS_ERR  *p_err)
+{
+   *p_err = FS_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       FS_OS_DevUnlockShared()
+*
+* Description : Release shared access to file system device.
+*
+* Argument(s) : dev_id      Index of the semaphore to release.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Releases the locks acquired by 'FS_OS_DevLockShared()'.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevUnlockShared (FS_ID  dev_id)
+{
+
+}
+
+
 /*
 *********************************************************************************************************
 *********************************************************************************************************
@@ -0,0 +1,1073 @@
+/*
+*********************************************************************************************************
+*                                                uC/FS
+*                                      The Embedded File System
+*
+*                    Copyright 2008-2020 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                 FILE SYSTEM OPERATING SYSTEM LAYER
+*
+*                                            POSIX threads
+*
+* Filename : fs_os.c
+* Version  : V4.08.00
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define    MICRIUM_SOURCE
+#define    FS_OS_MODULE
+#define   _GNU_SOURCE
+#include  <errno.h>
+#include  <time.h>
+#include  <cpu_core.h>
+#include  <cpu.h>
+#include  <lib_mem.h>
+#include  "fs_os.h"
+#include  "fs.h"
+#include  "fs_dev.h"
+#include  "fs_file.h"
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*
+* Note(s) : (1) The port maps every uC/FS lock onto its own POSIX object so that no single lock serializes
+*               the file system suite :
+*
+*               (a) FS lock          : one mutex, held only while the object pools (dev, vol, file, dir)
+*                                      are searched or modified.
+*
+*               (b) Dev access lock  : one read/write lock per device, acquired before (c) & held
+*                                      exclusively by 'FSDev_AccessLock()'.
+*
+*               (c) Dev lock         : one read/write lock per device.  Since a volume is bound to one
+*                                      device, this is also the volume lock taken by 'FSVol_Lock()'.
+*
+*               (d) File lock        : one recursive mutex per file, owned by the locking thread (see
+*                                      'FSFile_LockGet()  Note #1').
+*
+*               Operations on different devices/volumes therefore never contend.  On the same volume,
+*               (b) & (c) are taken exclusively by every operation that may modify the volume, its
+*               buffers or its cache (writes, syncs, cache eviction, ...) & shared by file reads (see
+*              'FSVol_LockShared()'), so that reads of different files run concurrently.
+*
+*           (2) Writers are preferred : a pending exclusive lock blocks new shared lockers, so a stream
+*               of reads cannot starve a write.  A thread must therefore NOT acquire (b) or (c) shared
+*               while already holding it.
+*
+*           (3) The same design applies to any RTOS : (a) needs a mutex with priority inheritance, (b) &
+*               (c) a read/write lock (or a mutex, at the cost of serializing reads), (d) a mutex that
+*               supports nesting by its owner.
+*********************************************************************************************************
+*/
+
+#define  FS_OS_NS_PER_MS                           1000000L
+#define  FS_OS_NS_PER_S                         1000000000L
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL CONSTANTS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                          LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  fs_os_dev_lock {
+    pthread_rwlock_t  Lock;                                     /* Dev lock (see 'FS_OS_DevLock()').                    */
+    pthread_rwlock_t  AccessLock;                               /* Dev access lock (see 'FS_OS_DevAccessLock()').       */
+} FS_OS_DEV_LOCK;
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  pthread_mutex_t   FS_OS_LockObj;                        /* FS lock.                                             */
+
+static  FS_OS_DEV_LOCK   *FS_OS_DevLockTbl;                     /* Dev locks, indexed by dev ID.                        */
+static  FS_QTY            FS_OS_DevLockCnt;
+
+#if (FS_CFG_FILE_LOCK_EN == DEF_ENABLED)
+static  pthread_mutex_t  *FS_OS_FileLockTbl;                    /* File locks, indexed by file ID.                      */
+static  FS_QTY            FS_OS_FileLockCnt;
+#endif
+
+#if (FS_CFG_WORKING_DIR_EN == DEF_ENABLED)
+static  pthread_key_t     FS_OS_WorkingDirKey;                  /* Per-thread working dir (see 'FS_OS_WorkingDirGet()').*/
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         FS_OS_TimeoutGet  (CPU_INT32U        timeout,  /* Convert relative timeout to abs time.                */
+                                        struct  timespec *p_ts);
+
+static  CPU_BOOLEAN  FS_OS_MutexCreate (pthread_mutex_t  *p_mutex,  /* Create mutex.                                        */
+                                        int               type);
+
+static  CPU_BOOLEAN  FS_OS_RwLockCreate(pthread_rwlock_t *p_lock);  /* Create rd/wr lock.                                   */
+
+
+/*
+*********************************************************************************************************
+*                                     LOCAL CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+
+
+/*
+*********************************************************************************************************
+*                                            FS_OS_Init()
+*
+* Description : Perform FS/OS initialization.
+*
+* Argument(s) : p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE                 FS/OS initialization successful.
+*                               FS_ERR_OS_INIT_LOCK         FS lock signal NOT successfully initialized.
+*                               FS_ERR_OS_INIT_LOCK_NAME    FS lock signal name NOT successfully initialized.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  FS_OS_Init (FS_ERR  *p_err)
+{
+    CPU_BOOLEAN  ok;
+
+
+    ok = FS_OS_MutexCreate(&FS_OS_LockObj, PTHREAD_MUTEX_NORMAL);
+    if (ok != DEF_OK) {
+       *p_err = FS_ERR_OS_INIT_LOCK;
+        return;
+    }
+
+#if (FS_CFG_WORKING_DIR_EN == DEF_ENABLED)
+    if (pthread_key_create(&FS_OS_WorkingDirKey, DEF_NULL) != 0) {
+        (void)pthread_mutex_destroy(&FS_OS_LockObj);
+       *p_err = FS_ERR_OS_INIT;
+        return;
+    }
+#endif
+
+   *p_err = FS_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                            FS_OS_Lock()
+*
+* Description : Acquire mutually exclusive access to file system suite.
+*
+* Argument(s) : p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE       File system access     acquired.
+*                               FS_ERR_OS_LOCK    File system access NOT acquired.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) File system access MUST be acquired--i.e. MUST wait for access; do NOT timeout.
+*
+*                   Failure to acquire file system access will prevent file system operation(s)
+*                   from functioning.
+*********************************************************************************************************
+*/
+
+void  FS_OS_Lock (FS_ERR  *p_err)
+{
+    if (pthread_mutex_lock(&FS_OS_LockObj) != 0) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           FS_OS_Unlock()
+*
+* Description : Release mutually exclusive access to file system suite.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) File system access MUST be released--i.e. MUST unlock access without failure.
+*
+*                   Failure to release file system access will prevent file system operation(s)
+*                   from functioning.
+*********************************************************************************************************
+*/
+
+void  FS_OS_Unlock (void)
+{
+    (void)pthread_mutex_unlock(&FS_OS_LockObj);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FS_OS_WorkingDirGet()
+*
+* Description : Get working directory assigned to active task.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Working directory of active task.
+*
+* Note(s)     : (1) A thread-specific key stores the pointer to the working directory.  If the key value
+*                   is NULL, the working directory has not been assigned.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_WORKING_DIR_EN == DEF_ENABLED)
+CPU_CHAR  *FS_OS_WorkingDirGet (void)
+{
+    CPU_CHAR  *p_working_dir;
+
+
+    p_working_dir = (CPU_CHAR *)pthread_getspecific(FS_OS_WorkingDirKey);
+    return (p_working_dir);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        FS_OS_WorkingDirSet()
+*
+* Description : Assign working directory to active task.
+*
+* Argument(s) : p_working_dir   Pointer to working directory.
+*               ----------      Argument validated by caller.
+*
+*               p_err           Pointer to variable that will receive the return error code from this function :
+*               ----------      Argument validated by caller.
+*
+*                                   FS_ERR_NONE       Working directory successfully set.
+*                                   FS_ERR_OS         Error setting working directory.
+*
+* Return(s)   : Working directory of active task.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_WORKING_DIR_EN == DEF_ENABLED)
+void  FS_OS_WorkingDirSet (CPU_CHAR  *p_working_dir,
+                           FS_ERR    *p_err)
+{
+    if (pthread_setspecific(FS_OS_WorkingDirKey, (void *)p_working_dir) != 0) {
+       *p_err = FS_ERR_OS;
+        return;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         FS_OS_SemCreate()
+*
+* Description : Create a semaphore.
+*
+* Argument(s) : p_sem       Pointer to semaphore.
+*               ----------  Argument validated by caller.
+*
+*               cnt         Initial value for the semaphore.
+*
+* Return(s)   : DEF_OK,   if semaphore created.
+*               DEF_FAIL, otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  FS_OS_SemCreate (FS_OS_SEM  *p_sem,
+                              CPU_INT16U  cnt)
+{
+    if (sem_init(p_sem, 0, (unsigned int)cnt) != 0) {
+        return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           FS_OS_SemDel()
+*
+* Description : Delete a semaphore.
+*
+* Argument(s) : p_sem       Pointer to semaphore.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : DEF_OK,   if semaphore deleted.
+*               DEF_FAIL, otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  FS_OS_SemDel (FS_OS_SEM  *p_sem)
+{
+    if (sem_destroy(p_sem) != 0) {
+        return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          FS_OS_SemPend()
+*
+* Description : Wait for a semaphore.
+*
+* Argument(s) : p_sem       Pointer to semaphore.
+*               ----------  Argument validated by caller.
+*
+*               timeout     If non-zero, timeout period (in milliseconds).
+*                           If zero,     wait forever.
+*
+* Return(s)   : DEF_OK,   if semaphore now owned by caller.
+*               DEF_FAIL, otherwise.
+*
+* Note(s)     : (1) Waits interrupted by a signal are restarted.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  FS_OS_SemPend (FS_OS_SEM  *p_sem,
+                            CPU_INT32U  timeout)
+{
+    struct  timespec  ts;
+    int               rtn;
+
+
+    if (timeout == 0u) {
+        do {
+            rtn = sem_wait(p_sem);
+        } while ((rtn != 0) && (errno == EINTR));
+    } else {
+        FS_OS_TimeoutGet(timeout, &ts);
+        do {
+            rtn = sem_timedwait(p_sem, &ts);
+        } while ((rtn != 0) && (errno == EINTR));
+    }
+
+    if (rtn != 0) {
+        return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          FS_OS_SemPost()
+*
+* Description : Signal a semaphore.
+*
+* Argument(s) : p_sem       Pointer to semaphore.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : DEF_OK,   if semaphore signaled.
+*               DEF_FAIL, otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  FS_OS_SemPost (FS_OS_SEM  *p_sem)
+{
+    if (sem_post(p_sem) != 0) {
+        return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          FS_OS_Dly_ms()
+*
+* Description : Delay for specified time, in milliseconds.
+*
+* Argument(s) : ms      Time delay value, in milliseconds.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  FS_OS_Dly_ms (CPU_INT16U  ms)
+{
+    struct  timespec  ts;
+
+
+    ts.tv_sec  = (time_t)(ms / 1000u);
+    ts.tv_nsec = (long)(ms % 1000u) * FS_OS_NS_PER_MS;
+    while (nanosleep(&ts, &ts) != 0) {                          /* Resume sleep if interrupted by a signal.             */
+        if (errno != EINTR) {
+            break;
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                               DEVICE
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                           FS_OS_DevInit()
+*
+* Description : Perform FS/OS device initialization.
+*
+* Argument(s) : dev_cnt     Number of device locks to allocate.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE                 FS/OS device initialization successful.
+*                               FS_ERR_OS_INIT_LOCK         FS device lock signal NOT successfully initialized.
+*                               FS_ERR_OS_INIT_LOCK_NAME    FS device lock signal name NOT successfully initialized.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevInit (FS_QTY   dev_cnt,
+                     FS_ERR  *p_err)
+{
+    FS_OS_DEV_LOCK  *p_lock;
+    FS_QTY           ix;
+    CPU_SIZE_T       octets_reqd;
+    CPU_BOOLEAN      ok;
+    LIB_ERR          alloc_err;
+
+
+    p_lock = (FS_OS_DEV_LOCK *)Mem_HeapAlloc( sizeof(FS_OS_DEV_LOCK) * (CPU_SIZE_T)dev_cnt,
+                                              sizeof(CPU_ALIGN),
+                                             &octets_reqd,
+                                             &alloc_err);
+    if (p_lock == (FS_OS_DEV_LOCK *)0) {
+        FS_TRACE_DBG(("FS_OS_DevInit(): Could not alloc mem for dev locks: %d octets req'd.\r\n", octets_reqd));
+       *p_err = FS_ERR_OS_INIT_LOCK;
+        return;
+    }
+
+    for (ix = 0u; ix < dev_cnt; ix++) {
+        ok = FS_OS_RwLockCreate(&p_lock[ix].Lock);
+        if (ok == DEF_OK) {
+            ok = FS_OS_RwLockCreate(&p_lock[ix].AccessLock);
+        }
+        if (ok != DEF_OK) {
+           *p_err = FS_ERR_OS_INIT_LOCK;
+            return;
+        }
+    }
+
+    FS_OS_DevLockTbl = p_lock;
+    FS_OS_DevLockCnt = dev_cnt;
+
+   *p_err = FS_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           FS_OS_DevLock()
+*
+* Description : Acquire mutually exclusive access to file system device.
+*
+* Argument(s) : dev_id      Index of the semaphore to acquire.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE       File system device access     acquired.
+*                               FS_ERR_OS_LOCK    File system device access NOT acquired.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Device access MUST be acquired--i.e. MUST wait for access; do NOT timeout.
+*
+*                   Failure to acquire device access will prevent device operation(s) from functioning.
+*
+*               (2) When both the device and access locks are required the access lock MUST be
+*                   acquired first.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevLock (FS_ID    dev_id,
+                     FS_ERR  *p_err)
+{
+    if ((FS_QTY)dev_id >= FS_OS_DevLockCnt) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+    if (pthread_rwlock_wrlock(&FS_OS_DevLockTbl[dev_id].Lock) != 0) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                          FS_OS_DevUnlock()
+*
+* Description : Release mutually exclusive access to file system device.
+*
+* Argument(s) : dev_id      Index of the semaphore to release.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Device access MUST be released--i.e. MUST unlock access without failure.
+*
+*                   Failure to release device access will prevent device operation(s) from functioning.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevUnlock (FS_ID  dev_id)
+{
+    if ((FS_QTY)dev_id >= FS_OS_DevLockCnt) {
+        return;
+    }
+
+    (void)pthread_rwlock_unlock(&FS_OS_DevLockTbl[dev_id].Lock);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FS_OS_DevAccessLock()
+*
+* Description : Acquire global device access lock and block high level uC/FS operations on that device.
+*
+* Argument(s) : dev_id      Index of the semaphore to acquire.
+*
+*               timeout     Timeout value in milliseconds.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE             File system device access     acquired.
+*                               FS_ERR_OS_LOCK          File system device access NOT acquired.
+*                               FS_ERR_OS_LOCK_TIMEOUT  File system device access timed out.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Device access MUST be acquired--i.e. MUST wait for access; do NOT timeout.
+*
+*               (2) When both the device and access locks are required the access lock MUST be
+*                   acquired first.
+*
+*               (3) The device access lock can be acquired by external applications by calling
+*                   FSDev_AccessLock() to access the device layer exclusively.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevAccessLock (FS_ID       dev_id,
+                           CPU_INT32U  timeout,
+                           FS_ERR     *p_err)
+{
+    struct  timespec  ts;
+    int               rtn;
+
+
+    if ((FS_QTY)dev_id >= FS_OS_DevLockCnt) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+    if (timeout == 0u) {
+        rtn = pthread_rwlock_wrlock(&FS_OS_DevLockTbl[dev_id].AccessLock);
+    } else {
+        FS_OS_TimeoutGet(timeout, &ts);
+        rtn = pthread_rwlock_timedwrlock(&FS_OS_DevLockTbl[dev_id].AccessLock, &ts);
+    }
+
+    switch (rtn) {
+        case 0:
+            *p_err = FS_ERR_NONE;
+             break;
+
+        case ETIMEDOUT:
+            *p_err = FS_ERR_OS_LOCK_TIMEOUT;
+             break;
+
+        default:
+            *p_err = FS_ERR_OS_LOCK;
+             break;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       FS_OS_DevAccessUnlock()
+*
+* Description : Release mutually exclusive access to file system device.
+*
+* Argument(s) : dev_id      Index of the semaphore to release.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Device access MUST be released--i.e. MUST unlock access without failure.
+*
+*                   Failure to release device access will prevent device operation(s) from functioning.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevAccessUnlock (FS_ID  dev_id)
+{
+    if ((FS_QTY)dev_id >= FS_OS_DevLockCnt) {
+        return;
+    }
+
+    (void)pthread_rwlock_unlock(&FS_OS_DevLockTbl[dev_id].AccessLock);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FS_OS_DevLockShared()
+*
+* Description : Acquire shared access to file system device.
+*
+* Argument(s) : dev_id      Index of the semaphore to acquire.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE       File system device access     acquired.
+*                               FS_ERR_OS_LOCK    File system device access NOT acquired.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Both the device access lock & the device lock are acquired, in that order, shared with
+*                   other holders of a shared lock & exclusive of 'FS_OS_DevAccessLock()' & 'FS_OS_DevLock()'.
+*
+*               (2) See 'FS_OS_DevLock()  Note #1' & 'LOCAL DEFINES  Note #2'.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevLockShared (FS_ID    dev_id,
+                           FS_ERR  *p_err)
+{
+    if ((FS_QTY)dev_id >= FS_OS_DevLockCnt) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+    if (pthread_rwlock_rdlock(&FS_OS_DevLockTbl[dev_id].AccessLock) != 0) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+    if (pthread_rwlock_rdlock(&FS_OS_DevLockTbl[dev_id].Lock) != 0) {
+        (void)pthread_rwlock_unlock(&FS_OS_DevLockTbl[dev_id].AccessLock);
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       FS_OS_DevUnlockShared()
+*
+* Description : Release shared access to file system device.
+*
+* Argument(s) : dev_id      Index of the semaphore to release.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Releases the locks acquired by 'FS_OS_DevLockShared()'.
+*********************************************************************************************************
+*/
+
+void  FS_OS_DevUnlockShared (FS_ID  dev_id)
+{
+    if ((FS_QTY)dev_id >= FS_OS_DevLockCnt) {
+        return;
+    }
+
+    (void)pthread_rwlock_unlock(&FS_OS_DevLockTbl[dev_id].Lock);
+    (void)pthread_rwlock_unlock(&FS_OS_DevLockTbl[dev_id].AccessLock);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                                FILE
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          FS_OS_FileInit()
+*
+* Description : Perform FS/OS file initialization.
+*
+* Argument(s) : file_cnt    Number of file locks to allocate.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE                 FS/OS initialization successful.
+*                               FS_ERR_OS_INIT_LOCK         FS file lock signal NOT successfully initialized.
+*                               FS_ERR_OS_INIT_LOCK_NAME    FS file lock signal name NOT successfully initialized.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) File locks are recursive so that matching 'FSFile_LockGet()'/'FSFile_LockSet()' calls
+*                   can be nested by the owning thread (see 'FSFile_LockGet()  Note #1e').
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_FILE_LOCK_EN == DEF_ENABLED)
+void  FS_OS_FileInit (FS_QTY   file_cnt,
+                      FS_ERR  *p_err)
+{
+    pthread_mutex_t  *p_lock;
+    FS_QTY            ix;
+    CPU_SIZE_T        octets_reqd;
+    CPU_BOOLEAN       ok;
+    LIB_ERR           alloc_err;
+
+
+    p_lock = (pthread_mutex_t *)Mem_HeapAlloc( sizeof(pthread_mutex_t) * (CPU_SIZE_T)file_cnt,
+                                               sizeof(CPU_ALIGN),
+                                              &octets_reqd,
+                                              &alloc_err);
+    if (p_lock == (pthread_mutex_t *)0) {
+        FS_TRACE_DBG(("FS_OS_FileInit(): Could not alloc mem for file locks: %d octets req'd.\r\n", octets_reqd));
+       *p_err = FS_ERR_OS_INIT_LOCK;
+        return;
+    }
+
+    for (ix = 0u; ix < file_cnt; ix++) {
+        ok = FS_OS_MutexCreate(&p_lock[ix], PTHREAD_MUTEX_RECURSIVE);
+        if (ok != DEF_OK) {
+           *p_err = FS_ERR_OS_INIT_LOCK;
+            return;
+        }
+    }
+
+    FS_OS_FileLockTbl = p_lock;
+    FS_OS_FileLockCnt = file_cnt;
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         FS_OS_FileAccept()
+*
+* Description : Acquire mutually exclusive access to file system file (without waiting).
+*
+* Argument(s) : file_id     Index of the semaphore to acquire.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE       File system file access     acquired.
+*                               FS_ERR_OS_LOCK    File system file access NOT acquired.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) File access should be acquired WITHOUT waiting, if available.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_FILE_LOCK_EN == DEF_ENABLED)
+void  FS_OS_FileAccept (FS_ID    file_id,
+                        FS_ERR  *p_err)
+{
+    if ((FS_QTY)file_id >= FS_OS_FileLockCnt) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+    if (pthread_mutex_trylock(&FS_OS_FileLockTbl[file_id]) != 0) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FS_OS_FileLock()
+*
+* Description : Acquire mutually exclusive access to file system file.
+*
+* Argument(s) : file_id     Index of the semaphore to acquire.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE       File system file access     acquired.
+*                               FS_ERR_OS_LOCK    File system file access NOT acquired.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) File access MUST be acquired--i.e. MUST wait for access; do NOT timeout.
+*
+*                   Failure to acquire file access will prevent file operation(s) from functioning.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_FILE_LOCK_EN == DEF_ENABLED)
+void  FS_OS_FileLock (FS_ID    file_id,
+                      FS_ERR  *p_err)
+{
+    if ((FS_QTY)file_id >= FS_OS_FileLockCnt) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+    if (pthread_mutex_lock(&FS_OS_FileLockTbl[file_id]) != 0) {
+       *p_err = FS_ERR_OS_LOCK;
+        return;
+    }
+
+   *p_err = FS_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         FS_OS_FileUnlock()
+*
+* Description : Release mutually exclusive access to file system file.
+*
+* Argument(s) : file_id     Index of the semaphore to release.
+*
+* Return(s)   : DEF_YES, if file lock     released.
+*               DEF_NO,  if file lock NOT released.
+*
+* Note(s)     : (1) File access MUST be released--i.e. MUST unlock access without failure.
+*
+*                   Failure to release file access will prevent file operation(s) from functioning.
+*
+*               (2) Releasing a lock held by another thread fails with EPERM & is reported as DEF_NO
+*                   (see 'FSFile_LockSet()  Note #2').
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_FILE_LOCK_EN == DEF_ENABLED)
+CPU_BOOLEAN  FS_OS_FileUnlock (FS_ID  file_id)
+{
+    if ((FS_QTY)file_id >= FS_OS_FileLockCnt) {
+        return (DEF_NO);
+    }
+
+    if (pthread_mutex_unlock(&FS_OS_FileLockTbl[file_id]) != 0) {
+        return (DEF_NO);
+    }
+
+    return (DEF_YES);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         FS_OS_TimeoutGet()
+*
+* Description : Convert a relative timeout to the absolute time expected by the POSIX timed waits.
+*
+* Argument(s) : timeout     Timeout period (in milliseconds).
+*
+*               p_ts        Pointer to variable that will receive the absolute expiry time.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  FS_OS_TimeoutGet (CPU_INT32U        timeout,
+                                struct  timespec *p_ts)
+{
+    (void)clock_gettime(CLOCK_REALTIME, p_ts);
+
+    p_ts->tv_sec  += (time_t)(timeout / 1000u);
+    p_ts->tv_nsec += (long)(timeout % 1000u) * FS_OS_NS_PER_MS;
+    if (p_ts->tv_nsec >= FS_OS_NS_PER_S) {
+        p_ts->tv_sec  += 1;
+        p_ts->tv_nsec -= FS_OS_NS_PER_S;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         FS_OS_MutexCreate()
+*
+* Description : Create a mutex of the given type.
+*
+* Argument(s) : p_mutex     Pointer to mutex.
+*               ----------  Argument validated by caller.
+*
+*               type        Mutex type (PTHREAD_MUTEX_NORMAL or PTHREAD_MUTEX_RECURSIVE).
+*
+* Return(s)   : DEF_OK,   if mutex created.
+*               DEF_FAIL, otherwise.
+*
+* Note(s)     : (1) Priority inheritance is requested where supported so that a low priority thread
+*                   holding a volume lock cannot starve a higher priority one.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  FS_OS_MutexCreate (pthread_mutex_t  *p_mutex,
+                                        int               type)
+{
+    pthread_mutexattr_t  attr;
+    int                  rtn;
+
+
+    if (pthread_mutexattr_init(&attr) != 0) {
+        return (DEF_FAIL);
+    }
+
+    (void)pthread_mutexattr_settype(&attr, type);
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && (_POSIX_THREAD_PRIO_INHERIT > 0)
+    (void)pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+#endif
+
+    rtn = pthread_mutex_init(p_mutex, &attr);
+    (void)pthread_mutexattr_destroy(&attr);
+
+    if (rtn != 0) {
+        return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FS_OS_RwLockCreate()
+*
+* Description : Create a read/write lock.
+*
+* Argument(s) : p_lock      Pointer to read/write lock.
+*               ----------  Argument validated by caller.
+*
+* Return(s)   : DEF_OK,   if read/write lock created.
+*               DEF_FAIL, otherwise.
+*
+* Note(s)     : (1) See 'LOCAL DEFINES  Note #2'.  The default glibc policy prefers readers, which would
+*                   let concurrent reads starve a write.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  FS_OS_RwLockCreate (pthread_rwlock_t  *p_lock)
+{
+    pthread_rwlockattr_t  attr;
+    int                   rtn;
+
+
+    if (pthread_rwlockattr_init(&attr) != 0) {
+        return (DEF_FAIL);
+    }
+
+#if defined(__GLIBC__)                                          /* See Note #1.                                         */
+    (void)pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+
+    rtn = pthread_rwlock_init(p_lock, &attr);
+    (void)pthread_rwlockattr_destroy(&attr);
+
+    if (rtn != 0) {
+        return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
@@ -0,0 +1,118 @@
+/*
+*********************************************************************************************************
+*                                                uC/FS
+*                                      The Embedded File System
+*
+*                    Copyright 2008-2020 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                 FILE SYSTEM OPERATING SYSTEM LAYER
+*
+*                                            POSIX threads
+*
+* Filename : fs_os.h
+* Version  : V4.08.00
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          INCLUDE GUARD
+*********************************************************************************************************
+*/
+
+#ifndef  FS_OS_H
+#define  FS_OS_H
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <pthread.h>
+#include  <semaphore.h>
+
+
+/*
+*********************************************************************************************************
+*                                               EXTERNS
+*********************************************************************************************************
+*/
+
+#ifdef   FS_OS_MODULE
+#define  FS_OS_EXT
+#else
+#define  FS_OS_EXT  extern
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*********************************************************************************************************
+*/
+
+#ifndef  FS_OS_PRESENT
+#define  FS_OS_PRESENT
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                             DATA TYPES
+*********************************************************************************************************
+*/
+
+
+typedef  sem_t  FS_OS_SEM;
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                         FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  FS_OS_SemCreate(FS_OS_SEM  *p_sem,
+                             CPU_INT16U  cnt);
+
+CPU_BOOLEAN  FS_OS_SemDel   (FS_OS_SEM  *p_sem);
+
+CPU_BOOLEAN  FS_OS_SemPend  (FS_OS_SEM  *p_sem,
+                             CPU_INT32U  timeout);
+
+CPU_BOOLEAN  FS_OS_SemPost  (FS_OS_SEM  *p_sem);
+
+/*
+*********************************************************************************************************
+*                                        CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          MODULE END
+*********************************************************************************************************
+*/
+
+#endif
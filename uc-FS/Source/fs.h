@@ -319,6 +319,42 @@ void         FS_WorkingDirObjFree (CPU_CHAR      *path_buf);        /* Free work
 #endif
 
 
+/*
+*********************************************************************************************************
+*                                             I/O TRACING
+*
+* Note(s) : (1) FS_TRACE_IO_START() & FS_TRACE_IO_END() MAY be #define'd in 'fs_cfg.h' to time I/O operations
+*               at the FAT journal, device & NOR physical layers :
+*
+*               (a) FS_TRACE_IO_START() returns a 32-bit timestamp marking the start of the operation.
+*
+*               (b) FS_TRACE_IO_END(layer, op, addr, size, start) records the operation; 'layer' is one of
+*                   FS_TRACE_IO_LAYER_xxx, 'op' one of FS_TRACE_IO_OP_xxx, 'addr' the sector or octet
+*                   address, 'size' the number of octets & 'start' the value returned by FS_TRACE_IO_START().
+*
+*           (2) When NOT defined, both hooks compile to nothing.
+*********************************************************************************************************
+*/
+
+#define  FS_TRACE_IO_LAYER_JOURNAL                         2u   /* FAT journal.                                         */
+#define  FS_TRACE_IO_LAYER_DEV                             3u   /* Dev secs.                                            */
+#define  FS_TRACE_IO_LAYER_NOR                             4u   /* NOR phy.                                             */
+
+#define  FS_TRACE_IO_OP_RD                                 0u
+#define  FS_TRACE_IO_OP_WR                                 1u
+#define  FS_TRACE_IO_OP_SYNC                               2u
+#define  FS_TRACE_IO_OP_ERASE                              3u
+
+#if ((defined(FS_TRACE_IO_START)) && \
+     (defined(FS_TRACE_IO_END)))
+    #define  FS_TRACE_IO_EN                                DEF_ENABLED
+#else
+    #define  FS_TRACE_IO_EN                                DEF_DISABLED
+    #define  FS_TRACE_IO_START()                           0u
+    #define  FS_TRACE_IO_END(layer, op, addr, size, start) (void)(start)
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                         FUNCTION PROTOTYPES
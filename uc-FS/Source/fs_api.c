@@ -697,6 +697,53 @@ void  fs_clearerr (FS_FILE *p_file)
 }
 
 
+/*
+*********************************************************************************************************
+*                                           fs_fallocate()
+*
+* Description : Reserve space for a file.
+*
+* Argument(s) : p_file      Pointer to a file.
+*
+*               size        Size of file for which space should be reserved.
+*
+* Return(s)   :  0, if the function succeeds.
+*               -1, otherwise.
+*
+* Note(s)     : (1) Space is allocated on the volume so that writes up to 'size' octets do not need to
+*                   allocate space.  Unlike 'posix_fallocate()', the size of the file is NOT changed &
+*                   the reserved space is NOT zero-filled.
+*
+*               (2) The file MUST be opened in write or read/write mode.
+*
+*               (3) See 'FSFile_Reserve()  Note(s)'.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+int  fs_fallocate (FS_FILE   *p_file,
+                   fs_off_t   size)
+{
+    FS_ERR  err;
+    int     rtn;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_file == (FS_FILE *)0) {                               /* Validate pointer to file                             */
+        return ((int)-1);
+    }
+#endif
+
+    FSFile_Reserve(               p_file,
+                   (FS_FILE_SIZE) size,
+                                 &err);
+
+    rtn = (err == FS_ERR_NONE) ? (0) : (-1);
+    return (rtn);
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                             fs_fclose()
@@ -1029,6 +1076,9 @@ void  fs_flockfile (FS_FILE  *p_file)
 *               (2) IEEE Std 1003.1, 2004 Edition, Section 'fopen() : RETURN VALUE' states that "[u]pon
 *                   successful completion 'fopen()' shall return a pointer to the object controlling the
 *                   stream.  Otherwise a null pointer shall be returned'.
+*
+*               (3) As an extension, a trailing 'J' (e.g., "r+J") opens the file self-journaled (see
+*                   'FSFile_Open()  Note #6').
 *********************************************************************************************************
 */
 
@@ -1376,6 +1426,47 @@ int  fs_fstat (FS_FILE          *p_file,
 }
 
 
+/*
+*********************************************************************************************************
+*                                             fs_fsync()
+*
+* Description : Write file data & metadata to the device.
+*
+* Argument(s) : p_file      Pointer to a file.
+*
+* Return(s)   :  0, if the function succeeds.
+*               -1, otherwise.
+*
+* Note(s)     : (1) IEEE Std 1003.1, 2004 Edition, Section 'fsync() : DESCRIPTION' states that "[t]he
+*                   'fsync()' function shall request that all data for the open file descriptor named by
+*                   'fildes' is to be transferred to the storage device associated with the file".
+*
+*                   (a) In this implementation, 'fsync()' takes a file pointer rather than a file
+*                       descriptor; any buffered data is first written to the file.
+*
+*               (2) See 'FSFile_Sync()  Note(s)'.
+*********************************************************************************************************
+*/
+
+int  fs_fsync (FS_FILE  *p_file)
+{
+    FS_ERR  err;
+    int     rtn;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_file == (FS_FILE *)0) {                               /* Validate pointer to file                             */
+        return ((int)-1);
+    }
+#endif
+
+    FSFile_Sync(p_file, &err);
+
+    rtn = (err == FS_ERR_NONE) ? (0) : (-1);
+    return (rtn);
+}
+
+
 /*
 *********************************************************************************************************
 *                                             fs_ftell()
@@ -417,6 +417,11 @@ int             fs_stat        (const  char                *name_full,      /* G
                                                                             /* ------------ FILE FUNCTIONS ------------ */
 void            fs_clearerr    (       FS_FILE             *p_file);        /* Clear EOF & error indicators on a file.  */
 
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+int             fs_fallocate   (       FS_FILE             *p_file,         /* Reserve space for a file.                */
+                                       fs_off_t             size);
+#endif
+
 int             fs_fclose      (       FS_FILE             *p_file);        /* Close & free a file.                     */
 
 int             fs_feof        (       FS_FILE             *p_file);        /* Test EOF indicator on a file.            */
@@ -452,6 +457,8 @@ int             fs_fsetpos     (       FS_FILE             *p_file,         /* S
 int             fs_fstat       (       FS_FILE             *p_file,         /* Get information about a file.            */
                                        struct  fs_stat     *p_info);
 
+int             fs_fsync       (       FS_FILE             *p_file);        /* Write file data & metadata to the device.*/
+
 
 long  int       fs_ftell       (       FS_FILE             *p_file);        /* Get file position indicator.             */
 
@@ -213,6 +213,19 @@
 #define  FS_FAT_JOURNAL_MODULE_PRESENT
 #endif
 #endif
+
+#ifdef   FS_FAT_CFG_FAT12_MIRROR_EN
+#if    ((FS_FAT_CFG_FAT12_MIRROR_EN == DEF_ENABLED) && \
+        (FS_FAT_CFG_FAT12_EN        == DEF_ENABLED))
+#define  FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+#endif
+#endif
+
+#ifdef   FS_FAT_CFG_CLUS_BITMAP_EN
+#if     (FS_FAT_CFG_CLUS_BITMAP_EN  == DEF_ENABLED)
+#define  FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+#endif
+#endif
 #endif
 
 
@@ -542,6 +555,51 @@
 #error  "                                       [MUST be  DEF_DISABLED]                         "
 #endif
 
+
+                                                                /* ------------- FS_FAT_CFG_FAT12_MIRROR_EN ----------- */
+#ifdef   FS_FAT_CFG_FAT12_MIRROR_EN
+#if    ((FS_FAT_CFG_FAT12_MIRROR_EN != DEF_DISABLED) && \
+        (FS_FAT_CFG_FAT12_MIRROR_EN != DEF_ENABLED ))
+#error  "FS_FAT_CFG_FAT12_MIRROR_EN             illegally #define'd in 'fs_cfg.h'               "
+#error  "                                       [MUST be  DEF_DISABLED]                         "
+#error  "                                       [     ||  DEF_ENABLED ]                         "
+#endif
+#endif
+
+#ifdef   FS_FAT_FAT12_MIRROR_MODULE_PRESENT
+#ifndef  FS_FAT_CFG_FAT12_MIRROR_SIZE
+#error  "FS_FAT_CFG_FAT12_MIRROR_SIZE                 not #define'd in 'fs_cfg.h'               "
+#error  "                                       [MUST be  >= 512]                               "
+
+#elif   (FS_FAT_CFG_FAT12_MIRROR_SIZE < 512u)
+#error  "FS_FAT_CFG_FAT12_MIRROR_SIZE           illegally #define'd in 'fs_cfg.h'               "
+#error  "                                       [MUST be  >= 512]                               "
+#endif
+#endif
+
+
+                                                                /* ------------- FS_FAT_CFG_CLUS_BITMAP_EN ------------ */
+#ifdef   FS_FAT_CFG_CLUS_BITMAP_EN
+#if    ((FS_FAT_CFG_CLUS_BITMAP_EN != DEF_DISABLED) && \
+        (FS_FAT_CFG_CLUS_BITMAP_EN != DEF_ENABLED ))
+#error  "FS_FAT_CFG_CLUS_BITMAP_EN              illegally #define'd in 'fs_cfg.h'               "
+#error  "                                       [MUST be  DEF_DISABLED]                         "
+#error  "                                       [     ||  DEF_ENABLED ]                         "
+#endif
+#endif
+
+#ifdef   FS_FAT_CLUS_BITMAP_MODULE_PRESENT
+#ifndef  FS_FAT_CFG_CLUS_BITMAP_SIZE
+#error  "FS_FAT_CFG_CLUS_BITMAP_SIZE                  not #define'd in 'fs_cfg.h'               "
+#error  "                                       [MUST be  >= 8 && multiple of 4]                "
+
+#elif  ((FS_FAT_CFG_CLUS_BITMAP_SIZE < 8u) || \
+       ((FS_FAT_CFG_CLUS_BITMAP_SIZE % 4u) != 0u))
+#error  "FS_FAT_CFG_CLUS_BITMAP_SIZE            illegally #define'd in 'fs_cfg.h'               "
+#error  "                                       [MUST be  >= 8 && multiple of 4]                "
+#endif
+#endif
+
 #endif
 /*
 *********************************************************************************************************
@@ -668,6 +668,9 @@ void  FSDev_IO_Ctrl (CPU_CHAR    *name_dev,
 *                   (e) If FS_ERR_DEV_UNKNOWN is returned, then the device driver is in an indeterminate
 *                       state.  The system MAY need to be restarted & the device driver should be
 *                       examined for errors.  The device has NOT been added to the file system.
+*
+*               (3) A driver whose 'Rd()' is reentrant answers FS_DEV_IO_CTRL_RD_SHARED without error.  File
+*                   reads on its volumes then share the device lock (see 'FSVol_LockShared()').
 *********************************************************************************************************
 */
 
@@ -786,6 +789,9 @@ void  FSDev_Open (CPU_CHAR  *name_dev,
                  break;
              }
              p_dev->Fixed = dev_info.Fixed;
+                                                                /* Chk if rd's may share dev lock (see Note #3).        */
+             p_dev_drv->IO_Ctrl(p_dev, FS_DEV_IO_CTRL_RD_SHARED, (void *)0, &query_err);
+             p_dev->RdShared = (query_err == FS_ERR_NONE) ? DEF_YES : DEF_NO;
 
                                                                 /* Validate size & sec size.                            */
              if (FS_DEV_IS_VALID_SIZE(dev_info.Size) == DEF_YES) {
@@ -2300,6 +2306,73 @@ void  FSDev_Unlock (FS_DEV  *p_dev)
 }
 
 
+/*
+*********************************************************************************************************
+*                                          FSDev_MapLocked()
+*
+* Description : Get a pointer to the data of device sector(s).
+*
+* Argument(s) : p_dev       Pointer to device.
+*               ----------  Argument validated by caller.
+*
+*               start       Start sector.
+*
+*               cnt         Number of sectors.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE                    Device sector(s) mapped.
+*                               FS_ERR_DEV_INVALID_SEC_NBR     Sector start or count invalid.
+*
+*                                                              ----- RETURNED BY DEV DRV's IO_Ctrl() ----
+*                               FS_ERR_DEV_INVALID_IO_CTRL     Device sectors are not addressable.
+*                               FS_ERR_DEV_INVALID_OP          Sector(s) cannot be mapped contiguously.
+*
+* Return(s)   : Pointer to sector data, if NO error(s).
+*               Pointer to NULL,        otherwise.
+*
+* Note(s)     : (1) The function caller MUST have acquired a reference to the device & hold the device lock.
+*
+*               (2) See 'fs_dev.h  DEVICE SECTOR MAP DATA TYPE  Note #1'.  No device I/O is performed, so
+*                   the device state is never changed.
+*********************************************************************************************************
+*/
+
+void  *FSDev_MapLocked (FS_DEV      *p_dev,
+                        FS_SEC_NBR   start,
+                        FS_SEC_QTY   cnt,
+                        FS_ERR      *p_err)
+{
+    FS_DEV_SEC_MAP  sec_map;
+
+
+                                                                /* ------------------ VALIDATE ARGS ------------------- */
+    if ((cnt          == 0u) ||
+        (start        >  p_dev->Size) ||
+        (start + cnt  >  p_dev->Size)) {
+       *p_err = FS_ERR_DEV_INVALID_SEC_NBR;
+        return ((void *)0);
+    }
+
+
+
+                                                                /* ---------------------- MAP DEV --------------------- */
+    sec_map.Start   =  start;
+    sec_map.Cnt     =  cnt;
+    sec_map.DataPtr = (void *)0;
+    p_dev->DevDrvPtr->IO_Ctrl(p_dev,
+                              FS_DEV_IO_CTRL_SEC_MAP,
+                             &sec_map,
+                              p_err);
+    if (*p_err != FS_ERR_NONE) {
+        return ((void *)0);
+    }
+
+    return (sec_map.DataPtr);
+}
+
+
 /*
 *********************************************************************************************************
 *                                         FSDev_QueryLocked()
@@ -2391,6 +2464,7 @@ void  FSDev_RdLocked (FS_DEV      *p_dev,
                       FS_ERR      *p_err)
 {
     FS_SEC_QTY  size;
+    CPU_INT32U  trace_start;
 
 
 
@@ -2415,11 +2489,13 @@ void  FSDev_RdLocked (FS_DEV      *p_dev,
 
 
                                                                 /* ---------------------- RD DEV ---------------------- */
+    trace_start = FS_TRACE_IO_START();
     p_dev->DevDrvPtr->Rd(p_dev,
                          p_dest,
                          start,
                          cnt,
                          p_err);
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_DEV, FS_TRACE_IO_OP_RD, start, cnt * p_dev->SecSize, trace_start);
 
 
 
@@ -2720,6 +2796,12 @@ void  FSDev_ReleaseLocked (FS_DEV      *p_dev,
 *
 * Note(s)     : (1) The function caller MUST have acquired a reference to the device & hold the device lock.
 *
+*               (2) If the device has not been written since the last successful sync, there is no pending
+*                   operation & the device driver is not called.  Consecutive syncs (e.g., of several files
+*                   on the same device) thus result in a single device sync.
+*
+*               (3) A device driver which does not implement FS_DEV_IO_CTRL_SYNC completes every write
+*                   before returning & has nothing to sync.
 *********************************************************************************************************
 */
 
@@ -2727,10 +2809,27 @@ void  FSDev_ReleaseLocked (FS_DEV      *p_dev,
 void  FSDev_SyncLocked (FS_DEV  *p_dev,
                         FS_ERR  *p_err)
 {
+    CPU_INT32U  trace_start;
+
+
+    if (p_dev->SyncReqd == DEF_NO) {                            /* If dev not wr'n since last sync ...                  */
+       *p_err = FS_ERR_NONE;                                    /* ... nothing to sync (see Note #2).                   */
+        return;
+    }
+
+    trace_start = FS_TRACE_IO_START();
     p_dev->DevDrvPtr->IO_Ctrl(p_dev,
                               FS_DEV_IO_CTRL_SYNC,
                               DEF_NULL,
                               p_err);
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_DEV, FS_TRACE_IO_OP_SYNC, 0u, 0u, trace_start);
+    if (*p_err == FS_ERR_DEV_INVALID_IO_CTRL) {                 /* See Note #3.                                         */
+       *p_err = FS_ERR_NONE;
+    }
+
+    if (*p_err == FS_ERR_NONE) {
+        p_dev->SyncReqd = DEF_NO;
+    }
 }
 #endif
 
@@ -2779,6 +2878,7 @@ void  FSDev_WrLocked (FS_DEV      *p_dev,
                       FS_ERR      *p_err)
 {
     FS_SEC_QTY    size;
+    CPU_INT32U    trace_start;
 #if (FS_CFG_DBG_WR_VERIFY_EN == DEF_ENABLED)
     FS_BUF       *p_buf;
     FS_SEC_NBR    sec;
@@ -2810,11 +2910,14 @@ void  FSDev_WrLocked (FS_DEV      *p_dev,
 
 
                                                                 /* ---------------------- WR DEV ---------------------- */
+    trace_start = FS_TRACE_IO_START();
     p_dev->DevDrvPtr->Wr(p_dev,
                          p_src,
                          start,
                          cnt,
                          p_err);
+    FS_TRACE_IO_END(FS_TRACE_IO_LAYER_DEV, FS_TRACE_IO_OP_WR, start, cnt * p_dev->SecSize, trace_start);
+    p_dev->SyncReqd = DEF_YES;                                  /* Dev must be sync'd (see 'FSDev_SyncLocked()').       */
 
 
 
@@ -3074,6 +3177,8 @@ static  void  FSDev_ObjClr (FS_DEV  *p_dev)
     p_dev->Size         =  0u;
     p_dev->SecSize      =  0u;
     p_dev->Fixed        =  DEF_NO;
+    p_dev->SyncReqd     =  DEF_NO;
+    p_dev->RdShared     =  DEF_NO;
 
     p_dev->VolCnt       =  0u;
     p_dev->DevDrvPtr    = (FS_DEV_API *)0;
@@ -104,6 +104,8 @@
 #define  FS_DEV_IO_CTRL_WR_SEC                            15u   /* Write physical dev sector.                           */
 #define  FS_DEV_IO_CTRL_SYNC                              16u   /* Sync dev.                                            */
 #define  FS_DEV_IO_CTRL_CHIP_ERASE                        17u   /* Erase all data on phy dev.                           */
+#define  FS_DEV_IO_CTRL_SEC_MAP                           18u   /* Get ptr to addressable dev secs.                     */
+#define  FS_DEV_IO_CTRL_RD_SHARED                         19u   /* Query whether dev rd's may run concurrently.         */
 
                                                                 /* ------------ SD-DRIVER SPECIFIC OPTIONS ------------ */
 #define  FS_DEV_IO_CTRL_SD_QUERY                          64u   /* Get info about SD/MMC card.                          */
@@ -114,6 +116,16 @@
 #define  FS_DEV_IO_CTRL_NAND_PARAM_PG_RD                  80u   /* Read parameter-page from ONFI device.                */
 #define  FS_DEV_IO_CTRL_NAND_DUMP                         81u   /* Dump raw NAND dev.                                   */
 
+                                                                /* ------------ NOR-DRIVER SPECIFIC OPTIONS ----------- */
+#define  FS_DEV_IO_CTRL_NOR_STAT_GET                      88u   /* Get stat ctrs of NOR dev.                            */
+
+                                                                /* ------------ RAM-DRIVER SPECIFIC OPTIONS ----------- */
+#define  FS_DEV_IO_CTRL_RAM_SNAPSHOT_TAKE                 96u   /* Take snapshot of RAM disk.                           */
+#define  FS_DEV_IO_CTRL_RAM_SNAPSHOT_RESTORE              97u   /* Restore RAM disk from snapshot.                      */
+#define  FS_DEV_IO_CTRL_RAM_SNAPSHOT_DEL                  98u   /* Del RAM disk snapshot.                               */
+#define  FS_DEV_IO_CTRL_RAM_SEC_STAT_GET                  99u   /* Get rd/wr ctrs of RAM disk sec.                      */
+#define  FS_DEV_IO_CTRL_RAM_SEC_STAT_CLR                 100u   /* Clr rd/wr ctrs of RAM disk secs.                     */
+
 /*
 *********************************************************************************************************
 *                                             DATA TYPES
@@ -137,6 +149,8 @@ struct  fs_dev {
     FS_SEC_QTY     Size;                                        /* Size of dev (in secs).                               */
     FS_SEC_SIZE    SecSize;                                     /* Size of dev sec.                                     */
     CPU_BOOLEAN    Fixed;                                       /* Indicates whether device is fixed or removable.      */
+    CPU_BOOLEAN    SyncReqd;                                    /* Indicates whether dev was wr'n since last sync.      */
+    CPU_BOOLEAN    RdShared;                                    /* Indicates whether rd's may share the dev lock.       */
 
     FS_QTY         VolCnt;                                      /* Nbr of open vols on this dev.                        */
 
@@ -164,6 +178,24 @@ typedef  struct  fs_dev_info {
 } FS_DEV_INFO;
 
 
+/*
+*********************************************************************************************************
+*                                      DEVICE SECTOR MAP DATA TYPE
+*
+* Note(s) : (1) Argument of FS_DEV_IO_CTRL_SEC_MAP.  A device whose sectors are directly addressable by the
+*               CPU (e.g., RAM disk, execute-in-place flash) returns a pointer to the data of sectors 'Start'
+*               to 'Start + Cnt - 1', laid out contiguously.  The memory is read-only for the caller & is
+*               only valid until the sectors are next written, released or the device is closed.
+*********************************************************************************************************
+*/
+
+typedef  struct  fs_dev_sec_map {
+    FS_SEC_NBR    Start;                                        /* Start sec.                                           */
+    FS_SEC_QTY    Cnt;                                          /* Nbr of secs.                                         */
+    void         *DataPtr;                                      /* Ptr to sec data (set by dev drv).                    */
+} FS_DEV_SEC_MAP;
+
+
 /*
 *********************************************************************************************************
 *                                     DEVICE DRIVER API DATA TYPE
@@ -379,6 +411,11 @@ void               FSDev_VolRemove       (FS_DEV              *p_dev,       /* R
 
 
                                                                             /* ------------- LOCKED ACCESS ------------ */
+void              *FSDev_MapLocked       (FS_DEV              *p_dev,       /* Get ptr to addressable device sector(s). */
+                                          FS_SEC_NBR           start,
+                                          FS_SEC_QTY           cnt,
+                                          FS_ERR              *p_err);
+
 void               FSDev_QueryLocked     (FS_DEV              *p_dev,       /* Get information about a device.          */
                                           FS_DEV_INFO         *p_info,
                                           FS_ERR              *p_err);
@@ -438,6 +475,11 @@ void               FS_OS_DevLock         (FS_ID                dev_id,      /* A
 
 void               FS_OS_DevUnlock       (FS_ID                dev_id);     /* Release access to file system device.              */
 
+void               FS_OS_DevLockShared   (FS_ID                dev_id,      /* Acquire shared access to file system device.       */
+                                          FS_ERR              *p_err);
+
+void               FS_OS_DevUnlockShared (FS_ID                dev_id);     /* Release shared access to file system device.       */
+
 void               FS_OS_Dly_ms          (CPU_INT16U           ms);         /* Delay for specified time, in ms.                   */
 
 
@@ -125,15 +125,26 @@ static  CPU_SIZE_T   FSFile_BufWr             (FS_FILE       *p_file,       /* W
 static  FS_FILE      *FSFile_AcquireLockChk   (FS_FILE       *p_file,       /* Acquire file reference & lock.           */
                                                FS_ERR        *p_err);
 
+static  FS_FILE      *FSFile_AcquireLockSharedChk(FS_FILE    *p_file,       /* Acquire file reference & lock for rd.    */
+                                               FS_ERR        *p_err);
+
+static  FS_FILE      *FSFile_AcquireLockChkHandler(FS_FILE   *p_file,       /* Acquire file reference & lock.           */
+                                               CPU_BOOLEAN    shared,
+                                               FS_ERR        *p_err);
+
 static  FS_FILE      *FSFile_Acquire          (FS_FILE       *p_file);      /* Acquire file reference.                  */
 
 static  void          FSFile_ReleaseUnlock    (FS_FILE       *p_file);      /* Release file reference & lock.           */
 
+static  void          FSFile_ReleaseUnlockShared(FS_FILE     *p_file);      /* Release file reference & lock for rd.    */
+
 static  void          FSFile_Release          (FS_FILE       *p_file);      /* Release file reference.                  */
 
-static  CPU_BOOLEAN   FSFile_Lock             (FS_FILE       *p_file);      /* Acquire file lock.                       */
+static  CPU_BOOLEAN   FSFile_Lock             (FS_FILE       *p_file,       /* Acquire file lock.                       */
+                                               CPU_BOOLEAN    shared);
 
-static  void          FSFile_Unlock           (FS_FILE       *p_file);      /* Release file lock.                       */
+static  void          FSFile_Unlock           (FS_FILE       *p_file,       /* Release file lock.                       */
+                                               CPU_BOOLEAN    shared);
 
 
                                                                             /* ----------- FILE LOCK CONTROL ---------- */
@@ -1026,6 +1037,121 @@ void  FSFile_LockSet (FS_FILE  *p_file,
 #endif
 
 
+/*
+*********************************************************************************************************
+*                                            FSFile_Map()
+*
+* Description : Get a pointer to file data.
+*
+* Argument(s) : p_file      Pointer to a file.
+*
+*               pos         Offset of data in file.
+*
+*               size        Number of octets.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE                 File data mapped.
+*                               FS_ERR_NULL_PTR             Argument 'p_file' passed a NULL pointer.
+*                               FS_ERR_FILE_ERR             File has error (see Note #4).
+*                               FS_ERR_FILE_INVALID_OP      Invalid operation on file.
+*
+*                                                           ------ RETURNED BY FSFile_AcquireLockChk() ------
+*                               FS_ERR_DEV_CHNGD            Device has changed.
+*                               FS_ERR_FILE_NOT_OPEN        File NOT open.
+*
+*                                                           --------- RETURNED BY FSFile_BufEmpty() ---------
+*                                                           ---------- RETURNED BY FSSys_FileMap() ----------
+*                               FS_ERR_BUF_NONE_AVAIL       No buffer available.
+*                               FS_ERR_DEV                  Device access error.
+*                               FS_ERR_DEV_INVALID_OP       File data is not addressable (see Note #2).
+*                               FS_ERR_ENTRY_CORRUPT        File system entry is corrupt.
+*                               FS_ERR_FILE_INVALID_POS     Data not within file.
+*
+* Return(s)   : Pointer to file data, if NO error(s).
+*               Pointer to NULL,      otherwise.
+*
+* Note(s)     : (1) The file MUST be opened in read or read/write mode.
+*
+*               (2) File data can only be mapped if the device sectors holding it are directly addressable
+*                   (e.g., RAM disk) & if the volume is not cached.  FS_ERR_DEV_INVALID_OP is returned
+*                   otherwise & the file remains usable; the data should then be read with 'FSFile_Rd()'.
+*
+*               (3) The file position is NOT changed.  The data is read-only & only valid until the file
+*                   or the device is next written or the file is closed.
+*
+*               (4) If an error occurred in the previous file access, the error indicator must be
+*                   cleared (with 'FSFile_ClrErr()') before another access will be allowed.
+*********************************************************************************************************
+*/
+
+void  *FSFile_Map (FS_FILE       *p_file,
+                   FS_FILE_SIZE   pos,
+                   CPU_SIZE_T     size,
+                   FS_ERR        *p_err)
+{
+    void  *p_data;
+
+
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION((void *)0);
+    }
+    if (p_file == (FS_FILE *)0) {                               /* Validate file ptr.                                   */
+       *p_err = FS_ERR_NULL_PTR;
+        return ((void *)0);
+    }
+#endif
+
+                                                                /* ----------------- ACQUIRE FILE LOCK ---------------- */
+    (void)FSFile_AcquireLockChk(p_file, p_err);
+    if (*p_err != FS_ERR_NONE) {
+         return ((void *)0);
+    }
+                                                                /* Chk file mode (see Note #1).                         */
+    if (DEF_BIT_IS_CLR(p_file->AccessMode, FS_FILE_ACCESS_MODE_RD) == DEF_YES) {
+        FSFile_ReleaseUnlock(p_file);
+       *p_err = FS_ERR_FILE_INVALID_OP;
+        return ((void *)0);
+    }
+
+    if (p_file->FlagErr == DEF_YES) {                           /* Chk for file err (see Note #4).                      */
+        FSFile_ReleaseUnlock(p_file);
+       *p_err = FS_ERR_FILE_ERR;
+        return ((void *)0);
+    }
+
+
+
+                                                                /* ---------------- HANDLE FILE BUFFER ---------------- */
+#if (FS_CFG_FILE_BUF_EN == DEF_ENABLED)
+    if (p_file->BufStatus == FS_FILE_BUF_STATUS_NONEMPTY_WR) {  /* Wr buffered data before mapping.                     */
+        FSFile_BufEmpty(p_file, p_err);
+        if (*p_err != FS_ERR_NONE) {
+            p_file->FlagErr = DEF_YES;
+            p_file->FlagEOF = DEF_NO;
+            FSFile_ReleaseUnlock(p_file);
+            return ((void *)0);
+        }
+    }
+#endif
+
+
+
+                                                                /* --------------------- MAP DATA --------------------- */
+    p_data = FSSys_FileMap(p_file,                              /* Errs do not set file err (see Note #2).              */
+                           pos,
+                           size,
+                           p_err);
+
+
+
+                                                                /* ----------------- RELEASE FILE LOCK ---------------- */
+    FSFile_ReleaseUnlock(p_file);
+    return (p_data);
+}
+
+
 /*
 *********************************************************************************************************
 *                                            FSFile_Open()
@@ -1044,6 +1170,8 @@ void  FSFile_LockSet (FS_FILE  *p_file,
 *                               FS_FILE_ACCESS_MODE_EXCL        File will be opened if & only if it does
 *                                                                   not already exist.
 *                               FS_FILE_ACCESS_MODE_CACHED      File data will be cached.
+*                               FS_FILE_ACCESS_MODE_SELF_JOURNAL  File atomicity ensured by the caller
+*                                                                   (see Note #6).
 *
 *               p_err       Pointer to variable that will receive the return error code from this function :
 *
@@ -1111,6 +1239,14 @@ void  FSFile_LockSet (FS_FILE  *p_file,
 *                   pointers, or neither 'p_vol' nor 'name_file' will receive valid pointers.
 *
 *               (5) See 'fs_fopen()  Note(s)'.
+*
+*               (6) A self-journaled file is one whose user (e.g., a database with its own rollback
+*                   journal) already guarantees the atomicity of its updates.  Its directory entry
+*                   updates are deferred like those of a cached file, are NOT logged to the FAT journal
+*                   & a sync only writes the entry if the file size changed; the write date/time is
+*                   updated on close.  Cluster chain allocation & deletion are still journaled, so the
+*                   FAT stays consistent; overwrites within allocated clusters (see 'fs_fallocate()')
+*                   need no journaling at all.
 *********************************************************************************************************
 */
 
@@ -1192,7 +1328,7 @@ FS_FILE  *FSFile_Open (CPU_CHAR  *name_full,
                                                                 /* See Note #2a4.                                       */
     if ((mode & (FS_FILE_ACCESS_MODE_RD       | FS_FILE_ACCESS_MODE_WR     | FS_FILE_ACCESS_MODE_APPEND |
                  FS_FILE_ACCESS_MODE_TRUNCATE | FS_FILE_ACCESS_MODE_CREATE | FS_FILE_ACCESS_MODE_EXCL   |
-                 FS_FILE_ACCESS_MODE_CACHED                                                             )) != mode) {
+                 FS_FILE_ACCESS_MODE_CACHED   | FS_FILE_ACCESS_MODE_SELF_JOURNAL                        )) != mode) {
        *p_err = FS_ERR_FILE_INVALID_ACCESS_MODE;
         return ((FS_FILE *)0);
     }
@@ -1375,7 +1511,7 @@ FS_FILE  *FSFile_Open (CPU_CHAR  *name_full,
 
 
                                                                 /* ----------------- RELEASE FILE LOCK ---------------- */
-    FSFile_Unlock(p_file);                                      /* Keep init ref.                                       */
+    FSFile_Unlock(p_file, DEF_NO);                              /* Keep init ref.                                       */
 
     return (p_file);
 }
@@ -1856,6 +1992,9 @@ void  FSFile_Query (FS_FILE        *p_file,
 *
 *               (5) If an error occurred in the previous file access, the error indicator must be
 *                   cleared (with 'FSFile_ClrErr()') before another access will be allowed.
+*
+*               (6) Reads of different files on the same volume may run concurrently (see 'FSFile_Lock()
+*                   Note #1').
 *********************************************************************************************************
 */
 
@@ -1883,32 +2022,32 @@ CPU_SIZE_T  FSFile_Rd (FS_FILE     *p_file,
 
 
                                                                 /* ----------------- ACQUIRE FILE LOCK ---------------- */
-    (void)FSFile_AcquireLockChk(p_file, p_err);
+    (void)FSFile_AcquireLockSharedChk(p_file, p_err);           /* See Note #6.                                         */
     if (*p_err != FS_ERR_NONE) {
         return (0u);
     }
 
                                                                 /* Chk file mode (see Note #3).                         */
     if (DEF_BIT_IS_CLR(p_file->AccessMode, FS_FILE_ACCESS_MODE_RD) == DEF_YES) {
-        FSFile_ReleaseUnlock(p_file);
+        FSFile_ReleaseUnlockShared(p_file);
        *p_err = FS_ERR_FILE_INVALID_OP;
         return (0u);
     }
 
     if (p_file->IO_State == FS_FILE_IO_STATE_WR) {              /* Chk state (see Note #2).                             */
-        FSFile_ReleaseUnlock(p_file);
+        FSFile_ReleaseUnlockShared(p_file);
        *p_err = FS_ERR_FILE_INVALID_OP_SEQ;
         return (0u);
     }
 
     if (p_file->FlagErr == DEF_YES) {                           /* Chk for file err (see Note #5).                      */
-        FSFile_ReleaseUnlock(p_file);
+        FSFile_ReleaseUnlockShared(p_file);
        *p_err = FS_ERR_FILE_ERR;
         return (0u);
     }
 
     if (size == 0u) {                                           /* Rtn 0 bytes rd (see Note #1).                        */
-        FSFile_ReleaseUnlock(p_file);
+        FSFile_ReleaseUnlockShared(p_file);
        *p_err = FS_ERR_NONE;
         return (0u);
     }
@@ -1919,7 +2058,7 @@ CPU_SIZE_T  FSFile_Rd (FS_FILE     *p_file,
 #if (FS_CFG_FILE_BUF_EN == DEF_ENABLED)
 #if (FS_CFG_RD_ONLY_EN  == DEF_DISABLED)
     if (p_file->BufStatus == FS_FILE_BUF_STATUS_NONEMPTY_WR) {  /* Chk buf status (see Note #2a).                       */
-        FSFile_ReleaseUnlock(p_file);
+        FSFile_ReleaseUnlockShared(p_file);
        *p_err = FS_ERR_FILE_INVALID_OP_SEQ;
         return (0u);
     }
@@ -1935,7 +2074,7 @@ CPU_SIZE_T  FSFile_Rd (FS_FILE     *p_file,
             p_file->IO_State = FS_FILE_IO_STATE_RD;
         }
 
-        FSFile_ReleaseUnlock(p_file);
+        FSFile_ReleaseUnlockShared(p_file);
         return (size_rd);
     }
 
@@ -1981,11 +2120,265 @@ CPU_SIZE_T  FSFile_Rd (FS_FILE     *p_file,
 
 
                                                                 /* ----------------- RELEASE FILE LOCK ---------------- */
-    FSFile_ReleaseUnlock(p_file);
+    FSFile_ReleaseUnlockShared(p_file);
     return (size_rd);
 }
 
 
+/*
+*********************************************************************************************************
+*                                          FSFile_Reserve()
+*
+* Description : Reserve space for a file.
+*
+* Argument(s) : p_file      Pointer to a file.
+*
+*               size        Size of file for which space should be reserved.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE             Space reserved successfully.
+*                               FS_ERR_NULL_PTR         Argument 'p_file' passed a NULL pointer.
+*                               FS_ERR_FILE_ERR         File has error (see Note #4).
+*                               FS_ERR_FILE_INVALID_OP  Invalid operation on file.
+*
+*                                                       ------ RETURNED BY FSFile_AcquireLockChk() ------
+*                               FS_ERR_DEV_CHNGD        Device has changed.
+*                               FS_ERR_FILE_NOT_OPEN    File NOT open.
+*
+*                                                       --------- RETURNED BY FSFile_BufEmpty() ---------
+*                                                       -------- RETURNED BY FSSys_FileReserve() --------
+*                               FS_ERR_BUF_NONE_AVAIL   No buffer available.
+*                               FS_ERR_DEV              Device access error.
+*                               FS_ERR_DEV_FULL         Device is full (no space could be allocated).
+*                               FS_ERR_ENTRY_CORRUPT    File system entry is corrupt.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The file MUST be opened in write or read/write mode.
+*
+*               (2) If 'FSFile_Reserve()' succeeds, writes up to 'size' octets will NOT need to allocate
+*                   space on the volume.  The size of the file & the file position are NOT changed & the
+*                   reserved space is NOT zero-filled.
+*
+*               (3) If the device is full, no space is reserved & the file remains usable; any other
+*                   error sets the file error indicator.
+*
+*               (4) If an error occurred in the previous file access, the error indicator must be
+*                   cleared (with 'FSFile_ClrErr()') before another access will be allowed.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void  FSFile_Reserve (FS_FILE       *p_file,
+                      FS_FILE_SIZE   size,
+                      FS_ERR        *p_err)
+{
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION(;);
+    }
+    if (p_file == (FS_FILE *)0) {                               /* Validate file ptr.                                   */
+       *p_err = FS_ERR_NULL_PTR;
+        return;
+    }
+#endif
+
+                                                                /* ----------------- ACQUIRE FILE LOCK ---------------- */
+    (void)FSFile_AcquireLockChk(p_file, p_err);
+    if (*p_err != FS_ERR_NONE) {
+         return;
+    }
+                                                                /* Chk file mode (see Note #1).                         */
+    if (DEF_BIT_IS_CLR(p_file->AccessMode, FS_FILE_ACCESS_MODE_WR) == DEF_YES) {
+        FSFile_ReleaseUnlock(p_file);
+       *p_err = FS_ERR_FILE_INVALID_OP;
+        return;
+    }
+
+    if (p_file->FlagErr == DEF_YES) {                           /* Chk for file err (see Note #4).                      */
+        FSFile_ReleaseUnlock(p_file);
+       *p_err = FS_ERR_FILE_ERR;
+        return;
+    }
+
+
+
+                                                                /* ---------------- HANDLE FILE BUFFER ---------------- */
+#if (FS_CFG_FILE_BUF_EN == DEF_ENABLED)
+    if ((p_file->BufStatus == FS_FILE_BUF_STATUS_NONEMPTY_RD) ||/* Flush buf before reserving space.                    */
+        (p_file->BufStatus == FS_FILE_BUF_STATUS_NONEMPTY_WR)) {
+        FSFile_BufEmpty(p_file, p_err);
+        if (*p_err != FS_ERR_NONE) {
+            p_file->FlagErr = DEF_YES;
+            p_file->FlagEOF = DEF_NO;
+            FSFile_ReleaseUnlock(p_file);
+            return;
+        }
+    }
+#endif
+
+
+
+                                                                /* ------------------- RESERVE SPACE ------------------ */
+    if (size > p_file->Size) {
+        FSSys_FileReserve(p_file,
+                          size,
+                          p_err);
+        if ((*p_err != FS_ERR_NONE) &&
+            (*p_err != FS_ERR_DEV_FULL)) {                      /* See Note #3.                                         */
+            p_file->FlagEOF = DEF_NO;
+            p_file->FlagErr = DEF_YES;
+        }
+    } else {
+       *p_err = FS_ERR_NONE;
+    }
+
+
+
+                                                                /* ----------------- RELEASE FILE LOCK ---------------- */
+    FSFile_ReleaseUnlock(p_file);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            FSFile_Sync()
+*
+* Description : Write file data & metadata to the device.
+*
+* Argument(s) : p_file      Pointer to a file.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE             File synchronized successfully.
+*                               FS_ERR_NULL_PTR         Argument 'p_file' passed a NULL pointer.
+*                               FS_ERR_FILE_ERR         File has error (see Note #4).
+*
+*                                                       ------ RETURNED BY FSFile_AcquireLockChk() ------
+*                               FS_ERR_DEV_CHNGD        Device has changed.
+*                               FS_ERR_FILE_NOT_OPEN    File NOT open.
+*
+*                                                       --------- RETURNED BY FSFile_BufEmpty() ---------
+*                                                       --------- RETURNED BY FSSys_FileSync() ----------
+*                               FS_ERR_BUF_NONE_AVAIL   No buffer available.
+*                               FS_ERR_DEV              Device access error.
+*                               FS_ERR_DEV_FULL         Device is full (no space could be allocated).
+*                               FS_ERR_ENTRY_CORRUPT    File system entry is corrupt.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The file is synchronized in the following order :
+*
+*                   (a) The file buffer is emptied, writing any buffered data to the file.
+*
+*                   (b) Deferred metadata updates (e.g., the directory entry of a cached file) are
+*                       written to the volume.
+*
+*                   (c) The volume cache, if any, is flushed.  Since the cache can only be flushed as a
+*                       whole, sectors of other files on the volume may also be written.
+*
+*                   (d) The device is synchronized.  Devices which have not been written since the last
+*                       sync are skipped (see 'FSDev_SyncLocked()  Note #2'), so that consecutive syncs
+*                       cost a single device sync.
+*
+*                   When this function returns, all data written to the file before the call is stored
+*                   on the device.
+*
+*               (2) Other open files on the volume are NOT synchronized; their buffers & deferred
+*                   metadata updates remain pending.
+*
+*               (3) If the file is opened in read-only mode, only the file buffer is emptied.
+*
+*               (4) If an error occurred in the previous file access, the error indicator must be
+*                   cleared (with 'FSFile_ClrErr()') before another access will be allowed.
+*********************************************************************************************************
+*/
+
+void  FSFile_Sync (FS_FILE  *p_file,
+                   FS_ERR   *p_err)
+{
+#if (FS_CFG_ERR_ARG_CHK_EXT_EN == DEF_ENABLED)                  /* ------------------- VALIDATE ARGS ------------------ */
+    if (p_err == (FS_ERR *)0) {                                 /* Validate error ptr.                                  */
+        CPU_SW_EXCEPTION(;);
+    }
+    if (p_file == (FS_FILE *)0) {                               /* Validate file ptr.                                   */
+       *p_err = FS_ERR_NULL_PTR;
+        return;
+    }
+#endif
+
+                                                                /* ----------------- ACQUIRE FILE LOCK ---------------- */
+    (void)FSFile_AcquireLockChk(p_file, p_err);
+    if (*p_err != FS_ERR_NONE) {
+         return;
+    }
+
+    if (p_file->FlagErr == DEF_YES) {                           /* Chk for file err (see Note #4).                      */
+        FSFile_ReleaseUnlock(p_file);
+       *p_err = FS_ERR_FILE_ERR;
+        return;
+    }
+
+
+
+                                                                /* ---------------- EMPTY FILE BUFFER ----------------- */
+#if (FS_CFG_FILE_BUF_EN == DEF_ENABLED)
+    if ((p_file->BufStatus == FS_FILE_BUF_STATUS_NONEMPTY_RD) ||/* See Note #1a.                                        */
+        (p_file->BufStatus == FS_FILE_BUF_STATUS_NONEMPTY_WR)) {
+        FSFile_BufEmpty(p_file, p_err);
+        if (*p_err != FS_ERR_NONE) {
+            p_file->FlagErr = DEF_YES;
+            FSFile_ReleaseUnlock(p_file);
+            return;
+        }
+    }
+#endif
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+    if (DEF_BIT_IS_CLR(p_file->AccessMode, FS_FILE_ACCESS_MODE_WR) == DEF_YES) {
+        FSFile_ReleaseUnlock(p_file);                           /* See Note #3.                                         */
+       *p_err = FS_ERR_NONE;
+        return;
+    }
+
+
+
+                                                                /* ------------------ UPDATE METADATA ----------------- */
+    FSSys_FileSync(p_file, p_err);                              /* See Note #1b.                                        */
+
+
+
+                                                                /* -------------------- FLUSH CACHE ------------------- */
+#ifdef FS_CACHE_MODULE_PRESENT
+    if ((*p_err                        == FS_ERR_NONE) &&       /* See Note #1c.                                        */
+        (p_file->VolPtr->CacheAPI_Ptr != (FS_VOL_CACHE_API *)0)) {
+        p_file->VolPtr->CacheAPI_Ptr->Flush(p_file->VolPtr, p_err);
+    }
+#endif
+
+
+
+                                                                /* --------------------- SYNC DEV --------------------- */
+    if (*p_err == FS_ERR_NONE) {
+        FSDev_SyncLocked(p_file->VolPtr->DevPtr, p_err);        /* See Note #1d.                                        */
+    }
+
+    if (*p_err != FS_ERR_NONE) {
+        p_file->FlagErr = DEF_YES;
+    }
+#else
+   *p_err = FS_ERR_NONE;
+#endif
+
+
+
+                                                                /* ----------------- RELEASE FILE LOCK ---------------- */
+    FSFile_ReleaseUnlock(p_file);
+}
+
+
 /*
 *********************************************************************************************************
 *                                          FSFile_Truncate()
@@ -2606,6 +2999,9 @@ void  FSFile_ModuleInit (FS_QTY   file_cnt,
 *               0, otherwise.
 *
 * Note(s)     : (1) See 'FSFile_Open()  Note #2' for a description of mode string interpretation.
+*
+*               (2) A trailing 'J' (e.g., "r+J") opens the file self-journaled & cached (see 'FSFile_Open()
+*                   Note #6').  It is not part of the standard 'fopen()' modes.
 *********************************************************************************************************
 */
 FS_FLAGS  FSFile_ModeParse (CPU_CHAR    *str_mode,
@@ -2659,6 +3055,11 @@ FS_FLAGS  FSFile_ModeParse (CPU_CHAR    *str_mode,
             }
             b_present = DEF_YES;
 
+        } else if ((*str_mode == (CPU_CHAR)ASCII_CHAR_LATIN_UPPER_J) &&
+                   (str_len   == 1u)) {                         /* Self-journaled, last char only (see Note #2).        */
+
+            mode |= FS_FILE_ACCESS_MODE_SELF_JOURNAL | FS_FILE_ACCESS_MODE_CACHED;
+
         } else {
 
             mode  = FS_FILE_ACCESS_MODE_NONE;                   /* Invalid mode.                                        */
@@ -3063,6 +3464,75 @@ static  CPU_SIZE_T  FSFile_BufWr (FS_FILE     *p_file,
 
 static  FS_FILE  *FSFile_AcquireLockChk (FS_FILE      *p_file,
                                          FS_ERR       *p_err)
+{
+    p_file = FSFile_AcquireLockChkHandler(p_file, DEF_NO, p_err);
+
+    return (p_file);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    FSFile_AcquireLockSharedChk()
+*
+* Description : Acquire file reference & lock for a read.
+*
+* Argument(s) : p_file      Pointer to file.
+*               ----------  Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE             File reference & lock acquired.
+*                               FS_ERR_DEV_CHNGD        Device has changed.
+*                               FS_ERR_FILE_NOT_OPEN    File NOT open.
+*
+* Return(s)   : Pointer to a file, if found.
+*               Pointer to NULL,   otherwise.
+*
+* Note(s)     : (1) The lock MUST be released with 'FSFile_ReleaseUnlockShared()'.  See also 'FSFile_Lock()
+*                   Note #1'.
+*********************************************************************************************************
+*/
+
+static  FS_FILE  *FSFile_AcquireLockSharedChk (FS_FILE      *p_file,
+                                               FS_ERR       *p_err)
+{
+    p_file = FSFile_AcquireLockChkHandler(p_file, DEF_YES, p_err);
+
+    return (p_file);
+}
+
+
+/*
+*********************************************************************************************************
+*                                   FSFile_AcquireLockChkHandler()
+*
+* Description : Acquire file reference & lock.
+*
+* Argument(s) : p_file      Pointer to file.
+*               ----------  Argument validated by caller.
+*
+*               shared      Indicates whether the volume lock may be shared with other readers (see
+*                           'FSFile_Lock()  Note #1').
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               ----------  Argument validated by caller.
+*
+*                               FS_ERR_NONE             File reference & lock acquired.
+*                               FS_ERR_DEV_CHNGD        Device has changed.
+*                               FS_ERR_FILE_NOT_OPEN    File NOT open.
+*
+* Return(s)   : Pointer to a file, if found.
+*               Pointer to NULL,   otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  FS_FILE  *FSFile_AcquireLockChkHandler (FS_FILE      *p_file,
+                                                CPU_BOOLEAN   shared,
+                                                FS_ERR       *p_err)
 {
     CPU_BOOLEAN  lock_success;
 
@@ -3075,7 +3545,7 @@ static  FS_FILE  *FSFile_AcquireLockChk (FS_FILE      *p_file,
         return ((FS_FILE *)0);
     }
 
-    lock_success = FSFile_Lock(p_file);
+    lock_success = FSFile_Lock(p_file, shared);
     if (lock_success != DEF_YES) {
        *p_err = FS_ERR_OS_LOCK;
         return ((FS_FILE *)0);
@@ -3094,7 +3564,8 @@ static  FS_FILE  *FSFile_AcquireLockChk (FS_FILE      *p_file,
         case FS_FILE_STATE_OPENING:
         default:
             *p_err = FS_ERR_FILE_NOT_OPEN;
-             FSFile_ReleaseUnlock(p_file);
+             FSFile_Unlock(p_file, shared);
+             FSFile_Release(p_file);
              return ((FS_FILE *)0);
     }
 }
@@ -3162,7 +3633,29 @@ static  FS_FILE  *FSFile_Acquire (FS_FILE  *p_file)
 
 static  void  FSFile_ReleaseUnlock (FS_FILE  *p_file)
 {
-    FSFile_Unlock(p_file);
+    FSFile_Unlock(p_file, DEF_NO);
+    FSFile_Release(p_file);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    FSFile_ReleaseUnlockShared()
+*
+* Description : Release file reference & lock acquired by 'FSFile_AcquireLockSharedChk()'.
+*
+* Argument(s) : p_file      Pointer to file.
+*               ------      Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  FSFile_ReleaseUnlockShared (FS_FILE  *p_file)
+{
+    FSFile_Unlock(p_file, DEF_YES);
     FSFile_Release(p_file);
 }
 
@@ -3232,13 +3725,18 @@ static  void  FSFile_Release (FS_FILE  *p_file)
 * Argument(s) : p_file      Pointer to file.
 *               ----------  Argument validated by caller.
 *
+*               shared      Indicates whether the volume lock may be shared with other readers (see Note #1).
+*
 * Return(s)   : none.
 *
-* Note(s)     : none.
+* Note(s)     : (1) A shared volume lock no longer serializes the accesses to the file state (position,
+*                   buffer, FAT layer data, ...).  It is therefore only used if the file lock, which does,
+*                   is enabled; otherwise the volume lock is always acquired exclusively.
 *********************************************************************************************************
 */
 
-static  CPU_BOOLEAN  FSFile_Lock (FS_FILE  *p_file)
+static  CPU_BOOLEAN  FSFile_Lock (FS_FILE      *p_file,
+                                  CPU_BOOLEAN   shared)
 {
     CPU_BOOLEAN  locked;
 
@@ -3249,9 +3747,21 @@ static  CPU_BOOLEAN  FSFile_Lock (FS_FILE  *p_file)
     if (locked == DEF_NO) {
         return (DEF_NO);
     }
-#endif
+                                                                /* ----------------- ACQUIRE VOL LOCK ----------------- */
+    if (shared == DEF_YES) {                                    /* See Note #1.                                         */
+        locked = FSVol_LockShared(p_file->VolPtr);
+    } else {
+        locked = FSVol_Lock(p_file->VolPtr);
+    }
+
+    if (locked == DEF_NO) {
+        (void)FSFile_LockSetHandler(p_file);
+    }
+#else
+    (void)shared;
                                                                 /* ----------------- ACQUIRE VOL LOCK ----------------- */
     locked = FSVol_Lock(p_file->VolPtr);
+#endif
 
     return (locked);
 }
@@ -3266,19 +3776,29 @@ static  CPU_BOOLEAN  FSFile_Lock (FS_FILE  *p_file)
 * Argument(s) : p_file      Pointer to file.
 *               ------      Argument validated by caller.
 *
+*               shared      Value passed to 'FSFile_Lock()'.
+*
 * Return(s)   : none.
 *
 * Note(s)     : none.
 *********************************************************************************************************
 */
 
-static  void  FSFile_Unlock (FS_FILE  *p_file)
+static  void  FSFile_Unlock (FS_FILE      *p_file,
+                             CPU_BOOLEAN   shared)
 {
                                                                 /* ----------------- RELEASE VOL LOCK ----------------- */
-    FSVol_Unlock(p_file->VolPtr);
-
 #if (FS_CFG_FILE_LOCK_EN == DEF_ENABLED)
+    if (shared == DEF_YES) {
+        FSVol_UnlockShared(p_file->VolPtr);
+    } else {
+        FSVol_Unlock(p_file->VolPtr);
+    }
+
     (void)FSFile_LockSetHandler(p_file);
+#else
+    (void)shared;
+    FSVol_Unlock(p_file->VolPtr);
 #endif
 }
 
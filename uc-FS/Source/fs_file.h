@@ -119,6 +119,7 @@
 #define  FS_FILE_ACCESS_MODE_APPEND              DEF_BIT_04     /* Append to file.                                      */
 #define  FS_FILE_ACCESS_MODE_EXCL                DEF_BIT_05     /* File must be created.                                */
 #define  FS_FILE_ACCESS_MODE_CACHED              DEF_BIT_06     /* Defer file metadata updates until close operation.   */
+#define  FS_FILE_ACCESS_MODE_SELF_JOURNAL        DEF_BIT_10     /* Atomicity ensured by user: dir entry not journaled.  */
 #define  FS_FILE_ACCESS_MODE_RDWR               (FS_FILE_ACCESS_MODE_RD | FS_FILE_ACCESS_MODE_WR)
 
 /*
@@ -252,6 +253,11 @@ void           FSFile_LockSet      (FS_FILE         *p_file,    /* Release task
                                     FS_ERR          *p_err);
 #endif
 
+void          *FSFile_Map          (FS_FILE         *p_file,    /* Get ptr to addressable file data.                    */
+                                    FS_FILE_SIZE     pos,
+                                    CPU_SIZE_T       size,
+                                    FS_ERR          *p_err);
+
 FS_FILE       *FSFile_Open         (CPU_CHAR        *name_full, /* Open a file.                                         */
                                     FS_FLAGS         mode,
                                     FS_ERR          *p_err);
@@ -273,6 +279,17 @@ CPU_SIZE_T     FSFile_Rd           (FS_FILE         *p_file,    /* Read from a f
                                     CPU_SIZE_T       size,
                                     FS_ERR          *p_err);
 
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void           FSFile_Reserve      (FS_FILE         *p_file,    /* Reserve space for a file.                            */
+                                    FS_FILE_SIZE     size,
+                                    FS_ERR          *p_err);
+#endif
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void           FSFile_Sync         (FS_FILE         *p_file,    /* Write file data & metadata to the device.            */
+                                    FS_ERR          *p_err);
+#endif
+
 #if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
 void           FSFile_Truncate     (FS_FILE         *p_file,    /* Truncate a file.                                     */
                                     FS_FILE_SIZE     size,
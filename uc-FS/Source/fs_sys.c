@@ -405,6 +405,51 @@ void  FSSys_FileClose  (FS_FILE  *p_file,
 }
 
 
+/*
+*********************************************************************************************************
+*                                           FSSys_FileMap()
+*
+* Description : Get a pointer to file data.
+*
+* Argument(s) : p_file      Pointer to a file.
+*               ------      Argument validated by caller.
+*
+*               pos         Offset of data in file.
+*
+*               size        Number of octets.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE                 File data mapped.
+*                               FS_ERR_BUF_NONE_AVAIL       No buffer available.
+*                               FS_ERR_DEV                  Device access error.
+*                               FS_ERR_DEV_INVALID_OP       File data is not addressable.
+*                               FS_ERR_ENTRY_CORRUPT        File system entry is corrupt.
+*                               FS_ERR_FILE_INVALID_POS     Data not within file.
+*
+* Return(s)   : Pointer to file data, if NO error(s).
+*               Pointer to NULL,      otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  *FSSys_FileMap (FS_FILE       *p_file,
+                      FS_FILE_SIZE   pos,
+                      CPU_SIZE_T     size,
+                      FS_ERR        *p_err)
+{
+#ifdef FS_FAT_MODULE_PRESENT
+    void  *p_data;
+
+    p_data = FS_FAT_FileMap(p_file, pos, size, p_err);
+    return (p_data);
+#else
+#error  "NO SYS DRIVER PRESENT"                                 /* See 'fs_sys.c  Notes #1'.                            */
+#endif
+}
+
+
 /*
 *********************************************************************************************************
 *                                          FSSys_FileOpen()
@@ -568,6 +613,80 @@ CPU_SIZE_T  FSSys_FileRd (FS_FILE     *p_file,
 }
 
 
+/*
+*********************************************************************************************************
+*                                        FSSys_FileReserve()
+*
+* Description : Reserve space for a file.
+*
+* Argument(s) : p_file      Pointer to a file.
+*               ------      Argument validated by caller.
+*
+*               size        Size of file for which space should be reserved.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE              Space reserved successfully.
+*                               FS_ERR_BUF_NONE_AVAIL    No buffer available.
+*                               FS_ERR_DEV               Device access error.
+*                               FS_ERR_DEV_FULL          Device is full (no space could be allocated).
+*                               FS_ERR_ENTRY_CORRUPT     File system entry is corrupt.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void  FSSys_FileReserve (FS_FILE       *p_file,
+                         FS_FILE_SIZE   size,
+                         FS_ERR        *p_err)
+{
+#ifdef FS_FAT_MODULE_PRESENT
+    FS_FAT_FileReserve(p_file, size, p_err);
+#else
+#error  "NO SYS DRIVER PRESENT"                                 /* See 'fs_sys.c  Notes #1'.                            */
+#endif
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FSSys_FileSync()
+*
+* Description : Write file metadata to the volume.
+*
+* Argument(s) : p_file      Pointer to a file.
+*               ------      Argument validated by caller.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*
+*                               FS_ERR_NONE              File metadata written successfully.
+*                               FS_ERR_BUF_NONE_AVAIL    No buffer available.
+*                               FS_ERR_DEV               Device access error.
+*                               FS_ERR_ENTRY_CORRUPT     File system entry is corrupt.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void  FSSys_FileSync (FS_FILE  *p_file,
+                      FS_ERR   *p_err)
+{
+#ifdef FS_FAT_MODULE_PRESENT
+    FS_FAT_FileSync(p_file, p_err);
+#else
+#error  "NO SYS DRIVER PRESENT"                                 /* See 'fs_sys.c  Notes #1'.                            */
+#endif
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                        FSSys_FileTruncate()
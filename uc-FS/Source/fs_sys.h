@@ -156,6 +156,11 @@ void        FSSys_VolQuery      (FS_VOL         *p_vol,         /* Get info abou
 void        FSSys_FileClose     (FS_FILE        *p_file,        /* Close a file.                                        */
                                  FS_ERR         *p_err);
 
+void       *FSSys_FileMap       (FS_FILE        *p_file,        /* Get ptr to addressable file data.                    */
+                                 FS_FILE_SIZE    pos,
+                                 CPU_SIZE_T      size,
+                                 FS_ERR         *p_err);
+
 void        FSSys_FileOpen      (FS_FILE        *p_file,        /* Open a file.                                         */
                                  CPU_CHAR       *name_file,
                                  FS_ERR         *p_err);
@@ -173,6 +178,17 @@ CPU_SIZE_T  FSSys_FileRd        (FS_FILE        *p_file,        /* Read from a f
                                  CPU_SIZE_T      size,
                                  FS_ERR         *p_err);
 
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void        FSSys_FileReserve   (FS_FILE        *p_file,        /* Reserve space for a file.                            */
+                                 FS_FILE_SIZE    size,
+                                 FS_ERR         *p_err);
+#endif
+
+#if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
+void        FSSys_FileSync      (FS_FILE        *p_file,        /* Write file metadata to the volume.                   */
+                                 FS_ERR         *p_err);
+#endif
+
 #if (FS_CFG_RD_ONLY_EN == DEF_DISABLED)
 void        FSSys_FileTruncate  (FS_FILE        *p_file,        /* Truncate a file.                                     */
                                  FS_FILE_SIZE    size,
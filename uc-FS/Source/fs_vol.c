@@ -117,6 +117,9 @@ static  FS_VOL  *FSVol_ObjGet    (void);                        /* Allocate a vo
 static  void     FSVol_OpenLocked(FS_VOL            *p_vol,     /* Open volume.                                     */
                                   FS_ERR            *p_err);
 
+                                                                /* ------------------- LOCKING -------------------- */
+static  CPU_BOOLEAN  FSVol_IsRdShared(FS_VOL        *p_vol);    /* Chk if rd's may share the vol lock.              */
+
 /*
 *********************************************************************************************************
 *                                     LOCAL CONFIGURATION ERRORS
@@ -2253,6 +2256,76 @@ void  FSVol_Unlock (FS_VOL  *p_vol)
 }
 
 
+/*
+*********************************************************************************************************
+*                                         FSVol_LockShared()
+*
+* Description : Acquire volume lock for a read, shared with other readers if possible.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               -----       Argument validated by caller.
+*
+* Return(s)   : DEF_YES, if volume lock     acquired.
+*               DEF_NO,  if volume lock NOT acquired.
+*
+* Note(s)     : (1) The lock is shared only if the device driver's 'Rd()' is reentrant (see 'FSDev_Open()
+*                   Note #3') & no cache is assigned to the volume, since a cached read may evict & write
+*                   back cache entries.  Otherwise, the volume lock is acquired exclusively.
+*
+*               (2) The caller MUST NOT modify the volume, nor any object shared between the files of the
+*                   volume, while holding a shared lock.  Per-file state MUST be protected by the caller
+*                   (see 'FSFile_Lock()  Note #1').
+*
+*               (3) The volume & device statistics counters are NOT updated atomically; these may miss
+*                   concurrent reads.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  FSVol_LockShared (FS_VOL  *p_vol)
+{
+    FS_ERR  err;
+
+
+    if (FSVol_IsRdShared(p_vol) == DEF_NO) {                    /* See Note #1.                                         */
+        return (FSVol_Lock(p_vol));
+    }
+
+    FS_OS_DevLockShared(p_vol->DevPtr->ID, &err);
+    if (err != FS_ERR_NONE) {
+        return (DEF_NO);
+    }
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FSVol_UnlockShared()
+*
+* Description : Release volume lock acquired by 'FSVol_LockShared()'.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               -----       Argument validated by caller.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The lock mode cannot have changed since 'FSVol_LockShared()' : the cache assignment
+*                   & the device open require the exclusive lock.
+*********************************************************************************************************
+*/
+
+void  FSVol_UnlockShared (FS_VOL  *p_vol)
+{
+    if (FSVol_IsRdShared(p_vol) == DEF_NO) {                    /* See Note #1.                                         */
+        FSVol_Unlock(p_vol);
+        return;
+    }
+
+    FS_OS_DevUnlockShared(p_vol->DevPtr->ID);
+}
+
+
 /*
 *********************************************************************************************************
 *                                         FSVol_OpenLocked()
@@ -2377,6 +2450,81 @@ static  void  FSVol_OpenLocked (FS_VOL  *p_vol,
 }
 
 
+/*
+*********************************************************************************************************
+*                                          FSVol_MapLocked()
+*
+* Description : Get a pointer to the data of volume sector(s).
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               -----       Argument validated by caller.
+*
+*               start       Start sector.
+*
+*               cnt         Number of sectors.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function :
+*               -----       Argument validated by caller.
+*
+*                               FS_ERR_NONE                   Volume sector(s) mapped.
+*                               FS_ERR_DEV_CHNGD              Device has changed.
+*                               FS_ERR_DEV_INVALID_OP         Volume sector(s) cannot be mapped (see Note #2).
+*                               FS_ERR_VOL_INVALID_SEC_NBR    Sector start or count invalid.
+*
+*                                                             ------ RETURNED BY FSDev_MapLocked() ------
+*                               FS_ERR_DEV_INVALID_IO_CTRL    Device sectors are not addressable.
+*                               FS_ERR_DEV_INVALID_SEC_NBR    Sector start or count invalid.
+*
+* Return(s)   : Pointer to sector data, if NO error(s).
+*               Pointer to NULL,        otherwise.
+*
+* Note(s)     : (1) The function caller MUST have acquired a reference to the volume & hold the device lock.
+*
+*               (2) A volume cache may hold sector data more recent than the device's; sectors of a
+*                   cached volume are never mapped.
+*********************************************************************************************************
+*/
+
+void  *FSVol_MapLocked (FS_VOL      *p_vol,
+                        FS_SEC_NBR   start,
+                        FS_SEC_QTY   cnt,
+                        FS_ERR      *p_err)
+{
+    void  *p_data;
+
+
+                                                                /* ------------------ VALIDATE ARGS ------------------- */
+    if (start + cnt > p_vol->PartitionSize) {                   /* Validate start & cnt.                                */
+       *p_err = FS_ERR_VOL_INVALID_SEC_NBR;
+        return ((void *)0);
+    }
+
+                                                                /* -------------- CHECK VOLUME VALIDITY --------------- */
+    if (p_vol->RefreshCnt != p_vol->DevPtr->RefreshCnt) {       /* Volume is invalid following a device change.         */
+       *p_err = FS_ERR_DEV_CHNGD;
+        return ((void *)0);
+    }
+
+#ifdef FS_CACHE_MODULE_PRESENT
+    if (p_vol->CacheAPI_Ptr != (FS_VOL_CACHE_API *)0) {         /* See Note #2.                                         */
+       *p_err = FS_ERR_DEV_INVALID_OP;
+        return ((void *)0);
+    }
+#endif
+
+
+
+                                                                /* ---------------------- MAP DEV --------------------- */
+    start  += p_vol->PartitionStart;
+    p_data  = FSDev_MapLocked(p_vol->DevPtr,
+                              start,
+                              cnt,
+                              p_err);
+
+    return (p_data);
+}
+
+
 /*
 *********************************************************************************************************
 *                                          FSVol_RdLocked()
@@ -3017,6 +3165,34 @@ void  FSVol_FileRemove (FS_VOL   *p_vol,
 *********************************************************************************************************
 */
 
+/*
+*********************************************************************************************************
+*                                         FSVol_IsRdShared()
+*
+* Description : Check whether reads may share the volume lock.
+*
+* Argument(s) : p_vol       Pointer to volume.
+*               -----       Argument validated by caller.
+*
+* Return(s)   : DEF_YES, if reads may share the volume lock.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : (1) See 'FSVol_LockShared()  Note #1'.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  FSVol_IsRdShared (FS_VOL  *p_vol)
+{
+#ifdef FS_CACHE_MODULE_PRESENT
+    if (p_vol->CacheAPI_Ptr != (FS_VOL_CACHE_API *)0) {
+        return (DEF_NO);
+    }
+#endif
+
+    return (p_vol->DevPtr->RdShared);
+}
+
+
 /*
 *********************************************************************************************************
 *                                           FSVol_ObjClr()
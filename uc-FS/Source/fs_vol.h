@@ -308,6 +308,10 @@ CPU_BOOLEAN   FSVol_Lock           (FS_VOL            *p_vol);      /* Acquire v
 
 void          FSVol_Unlock         (FS_VOL            *p_vol);      /* Release volume lock.                             */
 
+CPU_BOOLEAN   FSVol_LockShared     (FS_VOL            *p_vol);      /* Acquire volume lock, shared for rd's.            */
+
+void          FSVol_UnlockShared   (FS_VOL            *p_vol);      /* Release volume lock, shared for rd's.            */
+
 
                                                                     /* ----------------- REGISTRATION ----------------- */
 #ifdef FS_DIR_MODULE_PRESENT
@@ -326,6 +330,11 @@ void          FSVol_FileRemove     (FS_VOL            *p_vol,        /* Remove f
 
 
                                                                     /* ----------------- LOCKED ACCESS ---------------- */
+void         *FSVol_MapLocked      (FS_VOL            *p_vol,       /* Get ptr to addressable volume sector(s).         */
+                                    FS_SEC_NBR         start,
+                                    FS_SEC_QTY         cnt,
+                                    FS_ERR            *p_err);
+
 void          FSVol_RdLocked       (FS_VOL            *p_vol,       /* Read data from volume sector(s).                 */
                                     void              *p_dest,
                                     FS_SEC_NBR         start,